@@ -0,0 +1,155 @@
+#include "BufferPool.h"
+
+#include <Logging.h>
+
+#include <cstdlib>
+
+BufferPool BufferPool::instance;
+
+bool BufferPool::begin() {
+  if (region) {
+    return true;
+  }
+
+  mutex = xSemaphoreCreateMutex();
+  region = static_cast<uint8_t*>(malloc(REGION_SIZE));
+  if (!mutex || !region) {
+    LOG_E(BUF, "Failed to reserve %zu byte region, leases will use the heap", REGION_SIZE);
+    free(region);
+    region = nullptr;
+    return false;
+  }
+
+  LOG_I(BUF, "Reserved %u slabs of %zu bytes", SLAB_COUNT, SLAB_SIZE);
+  return true;
+}
+
+int BufferPool::findFreeRun(const uint8_t count) const {
+  const uint64_t runMask = (uint64_t{1} << count) - 1;
+  for (uint8_t first = 0; first + count <= SLAB_COUNT; first++) {
+    if (!(usedSlabs & (runMask << first))) {
+      return first;
+    }
+  }
+  return -1;
+}
+
+uint8_t* BufferPool::lease(const size_t size, const char* owner) {
+  if (!region) {
+    return static_cast<uint8_t*>(malloc(size));
+  }
+
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  uint8_t* buffer = leaseLocked(size, owner, true);
+  xSemaphoreGive(mutex);
+  return buffer;
+}
+
+uint8_t* BufferPool::tryLease(const size_t size, const char* owner) {
+  if (!region) {
+    return nullptr;
+  }
+
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  uint8_t* buffer = leaseLocked(size, owner, false);
+  xSemaphoreGive(mutex);
+  return buffer;
+}
+
+uint8_t* BufferPool::leaseLocked(const size_t size, const char* owner, const bool heapFallback) {
+  const size_t slabCount = (size + SLAB_SIZE - 1) / SLAB_SIZE;
+  Lease* slot = nullptr;
+  for (auto& l : leases) {
+    if (!l.buffer) {
+      slot = &l;
+      break;
+    }
+  }
+
+  const int first = slot && slabCount > 0 && slabCount <= SLAB_COUNT ? findFreeRun(slabCount) : -1;
+  uint8_t* buffer;
+  if (first >= 0) {
+    buffer = region + first * SLAB_SIZE;
+    usedSlabs |= ((uint64_t{1} << slabCount) - 1) << first;
+    stats.slabsInUse += slabCount;
+    if (stats.slabsInUse > stats.peakSlabsInUse) {
+      stats.peakSlabsInUse = stats.slabsInUse;
+    }
+  } else if (!heapFallback) {
+    return nullptr;
+  } else {
+    buffer = static_cast<uint8_t*>(malloc(size));
+    stats.heapFallbacks++;
+    LOG_W(BUF, "No slabs for %s (%zu bytes), using the heap", owner, size);
+    dumpLocked();
+  }
+
+  if (buffer && slot) {
+    *slot = {buffer, owner, size, static_cast<uint8_t>(first >= 0 ? first : 0),
+             static_cast<uint8_t>(first >= 0 ? slabCount : 0)};
+  }
+  stats.leases++;
+  return buffer;
+}
+
+void BufferPool::release(uint8_t* buffer) {
+  if (!buffer) {
+    return;
+  }
+  if (!region) {
+    free(buffer);
+    return;
+  }
+
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  bool found = false;
+  for (auto& l : leases) {
+    if (l.buffer != buffer) {
+      continue;
+    }
+    if (l.slabCount > 0) {
+      usedSlabs &= ~(((uint64_t{1} << l.slabCount) - 1) << l.firstSlab);
+      stats.slabsInUse -= l.slabCount;
+    } else {
+      free(buffer);
+    }
+    l = {};
+    found = true;
+    break;
+  }
+
+  if (!found) {
+    if (buffer >= region && buffer < region + REGION_SIZE) {
+      LOG_E(BUF, "!! Release of a slab that isn't leased - this is likely a bug");
+    } else {
+      // Heap fallback taken while every lease slot was in use
+      free(buffer);
+    }
+  }
+  xSemaphoreGive(mutex);
+}
+
+void BufferPool::dumpLocked() const {
+  LOG_I(BUF, "%u/%u slabs in use (peak %u), %zu leases, %zu heap fallbacks", stats.slabsInUse, SLAB_COUNT,
+        stats.peakSlabsInUse, stats.leases, stats.heapFallbacks);
+  for (const auto& l : leases) {
+    if (!l.buffer) {
+      continue;
+    }
+    if (l.slabCount > 0) {
+      LOG_I(BUF, "  %s: %zu bytes in slabs %u-%u", l.owner, l.size, l.firstSlab, l.firstSlab + l.slabCount - 1);
+    } else {
+      LOG_I(BUF, "  %s: %zu bytes from the heap", l.owner, l.size);
+    }
+  }
+}
+
+void BufferPool::dump() const {
+  if (!region) {
+    LOG_I(BUF, "Not reserved, all leases use the heap");
+    return;
+  }
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  dumpLocked();
+  xSemaphoreGive(mutex);
+}
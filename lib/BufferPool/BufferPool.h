@@ -0,0 +1,84 @@
+#pragma once
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * BufferPool.h
+ *
+ * Home for the large, short-lived buffers (BW backup, inflate state, PNG scanlines, JPEG rows, the XTC writer's
+ * frame). Allocating and freeing those on demand slowly fragments the heap until the largest free block is too small
+ * for them. Instead begin() reserves one frame sized region early in setup(), carved into fixed slabs. lease() hands
+ * out a run of consecutive slabs and records the owner, release() returns them.
+ *
+ * The region holds one full frame, or the leases that are taken together: the inflate decompressor (11 slabs) and
+ * dictionary (33 slabs) leave 4 slabs for the scanlines of the PNG being inflated, enough for about 570 px of RGB.
+ * Slabs are small so those fit without rounding waste. Buffers kept for as long as a screen is shown don't belong
+ * here, they would push every transient user onto the heap.
+ *
+ * The XTC page cache is the one longer user: its two 20-slab slots stay leased while an XTC book is open, taken
+ * through tryLease() so only from slabs that are free. The 8 slabs left over take the transient leases of a reading
+ * session up to one BW backup chunk, a JPEG MCU row of 500 px or PNG scanlines; a larger one made while the book is
+ * open goes to the heap. The slots go back when the book is closed.
+ *
+ * When the slabs are taken, or a request is larger than the region, lease() falls back to malloc and counts it, dump()
+ * shows who was holding what.
+ */
+class BufferPool {
+ public:
+  static constexpr size_t SLAB_SIZE = 1000;
+  static constexpr uint8_t SLAB_COUNT = 48;
+  static constexpr size_t REGION_SIZE = SLAB_SIZE * SLAB_COUNT;  // One 800x480 1-bit frame
+  static constexpr uint8_t MAX_LEASES = 12;
+
+  struct Stats {
+    uint8_t slabsInUse;
+    uint8_t peakSlabsInUse;
+    size_t leases;
+    size_t heapFallbacks;
+  };
+
+ private:
+  struct Lease {
+    uint8_t* buffer;
+    const char* owner;
+    size_t size;
+    uint8_t firstSlab;
+    uint8_t slabCount;  // 0 when the buffer came from the heap
+  };
+
+  static BufferPool instance;
+
+  uint8_t* region = nullptr;
+  uint64_t usedSlabs = 0;  // Bit per slab
+  Lease leases[MAX_LEASES] = {};
+  Stats stats = {};
+  SemaphoreHandle_t mutex = nullptr;  // Leases come from the main loop and activity render tasks
+
+  int findFreeRun(uint8_t count) const;
+  uint8_t* leaseLocked(size_t size, const char* owner, bool heapFallback);
+  void dumpLocked() const;
+
+ public:
+  static BufferPool& getInstance() { return instance; }
+
+  // Reserves the region, call before anything else allocates. Without it every lease comes from the heap.
+  bool begin();
+  // Whether begin() took the region, tryLease() has nothing to hand out without it
+  bool isReserved() const { return region != nullptr; }
+
+  // owner must outlive the lease, use a string literal. Returns nullptr only if the heap fallback fails too.
+  uint8_t* lease(size_t size, const char* owner);
+  // Slabs or nothing: nullptr when no run of free slabs is large enough, for users that can do without the buffer
+  uint8_t* tryLease(size_t size, const char* owner);
+  // Accepts nullptr, and buffers that came from the heap fallback
+  void release(uint8_t* buffer);
+
+  Stats getStats() const { return stats; }
+  // Logs every current lease and the totals
+  void dump() const;
+};
+
+#define BUFFER_POOL BufferPool::getInstance()
@@ -372,6 +372,27 @@ std::string Epub::getCoverBmpPath(bool cropped) const {
   return cachePath + "/" + coverFileName + ".bmp";
 }
 
+bool Epub::extractCoverImage(const std::string& imagePath) const {
+  const auto coverImageHref = bookMetadataCache->coreMetadata.coverItemHref;
+  if (coverImageHref.empty()) {
+    Serial.printf("[%lu] [EBP] No known cover image\n", millis());
+    return false;
+  }
+
+  if (!JpegToBmpConverter::isSupportedImage(coverImageHref.c_str())) {
+    Serial.printf("[%lu] [EBP] Cover image is not a JPG or PNG, skipping\n", millis());
+    return false;
+  }
+
+  FsFile coverImage;
+  if (!SdMan.openFileForWrite("EBP", imagePath, coverImage)) {
+    return false;
+  }
+  readItemContentsToStream(coverImageHref, coverImage, 1024);
+  coverImage.close();
+  return true;
+}
+
 bool Epub::generateCoverBmp(bool cropped) const {
   // Already generated, return true
   if (SdMan.exists(getCoverBmpPath(cropped).c_str())) {
@@ -383,53 +404,45 @@ bool Epub::generateCoverBmp(bool cropped) const {
     return false;
   }
 
-  const auto coverImageHref = bookMetadataCache->coreMetadata.coverItemHref;
-  if (coverImageHref.empty()) {
-    Serial.printf("[%lu] [EBP] No known cover image\n", millis());
+  Serial.printf("[%lu] [EBP] Generating BMP from cover image (%s mode)\n", millis(), cropped ? "cropped" : "fit");
+  const auto coverImageTempPath = getCachePath() + "/.cover.img";
+
+  FsFile coverImage;
+  if (!extractCoverImage(coverImageTempPath) || !SdMan.openFileForRead("EBP", coverImageTempPath, coverImage)) {
     return false;
   }
 
-  if (coverImageHref.substr(coverImageHref.length() - 4) == ".jpg" ||
-      coverImageHref.substr(coverImageHref.length() - 5) == ".jpeg") {
-    Serial.printf("[%lu] [EBP] Generating BMP from JPG cover image (%s mode)\n", millis(), cropped ? "cropped" : "fit");
-    const auto coverJpgTempPath = getCachePath() + "/.cover.jpg";
-
-    FsFile coverJpg;
-    if (!SdMan.openFileForWrite("EBP", coverJpgTempPath, coverJpg)) {
-      return false;
-    }
-    readItemContentsToStream(coverImageHref, coverJpg, 1024);
-    coverJpg.close();
-
-    if (!SdMan.openFileForRead("EBP", coverJpgTempPath, coverJpg)) {
-      return false;
-    }
-
-    FsFile coverBmp;
-    if (!SdMan.openFileForWrite("EBP", getCoverBmpPath(cropped), coverBmp)) {
-      coverJpg.close();
-      return false;
-    }
-    const bool success = JpegToBmpConverter::jpegFileToBmpStream(coverJpg, coverBmp, cropped);
-    coverJpg.close();
-    coverBmp.close();
-    SdMan.remove(coverJpgTempPath.c_str());
-
-    if (!success) {
-      Serial.printf("[%lu] [EBP] Failed to generate BMP from JPG cover image\n", millis());
-      SdMan.remove(getCoverBmpPath(cropped).c_str());
-    }
-    Serial.printf("[%lu] [EBP] Generated BMP from JPG cover image, success: %s\n", millis(), success ? "yes" : "no");
-    return success;
-  } else {
-    Serial.printf("[%lu] [EBP] Cover image is not a JPG, skipping\n", millis());
+  FsFile coverBmp;
+  if (!SdMan.openFileForWrite("EBP", getCoverBmpPath(cropped), coverBmp)) {
+    coverImage.close();
+    return false;
   }
+  const bool success = JpegToBmpConverter::jpegFileToBmpStream(coverImage, coverBmp, cropped);
+  coverImage.close();
+  coverBmp.close();
+  SdMan.remove(coverImageTempPath.c_str());
 
-  return false;
+  if (!success) {
+    Serial.printf("[%lu] [EBP] Failed to generate BMP from cover image\n", millis());
+    SdMan.remove(getCoverBmpPath(cropped).c_str());
+  }
+  Serial.printf("[%lu] [EBP] Generated BMP from cover image, success: %s\n", millis(), success ? "yes" : "no");
+  return success;
 }
 
+namespace {
+// Continue Reading card (half of screen: 240x400), 1-bit for fast home screen rendering (no gray passes needed)
+constexpr int THUMB_TARGET_WIDTH = 240;
+constexpr int THUMB_TARGET_HEIGHT = 400;
+// A cell of a three column cover grid
+constexpr int GRID_THUMB_WIDTH = 120;
+constexpr int GRID_THUMB_HEIGHT = 180;
+}  // namespace
+
 std::string Epub::getThumbBmpPath() const { return cachePath + "/thumb.bmp"; }
 
+std::string Epub::getGridThumbBmpPath() const { return cachePath + "/grid.bmp"; }
+
 bool Epub::generateThumbBmp() const {
   // Already generated, return true
   if (SdMan.exists(getThumbBmpPath().c_str())) {
@@ -441,55 +454,119 @@ bool Epub::generateThumbBmp() const {
     return false;
   }
 
-  const auto coverImageHref = bookMetadataCache->coreMetadata.coverItemHref;
-  if (coverImageHref.empty()) {
-    Serial.printf("[%lu] [EBP] No known cover image for thumbnail\n", millis());
+  Serial.printf("[%lu] [EBP] Generating thumb BMP from cover image\n", millis());
+  const auto coverImageTempPath = getCachePath() + "/.cover.img";
+
+  FsFile coverImage;
+  if (!extractCoverImage(coverImageTempPath) || !SdMan.openFileForRead("EBP", coverImageTempPath, coverImage)) {
     return false;
   }
 
-  if (coverImageHref.substr(coverImageHref.length() - 4) == ".jpg" ||
-      coverImageHref.substr(coverImageHref.length() - 5) == ".jpeg") {
-    Serial.printf("[%lu] [EBP] Generating thumb BMP from JPG cover image\n", millis());
-    const auto coverJpgTempPath = getCachePath() + "/.cover.jpg";
+  FsFile thumbBmp;
+  if (!SdMan.openFileForWrite("EBP", getThumbBmpPath(), thumbBmp)) {
+    coverImage.close();
+    return false;
+  }
+  const bool success = JpegToBmpConverter::jpegFileTo1BitBmpStreamWithSize(coverImage, thumbBmp, THUMB_TARGET_WIDTH,
+                                                                           THUMB_TARGET_HEIGHT);
+  coverImage.close();
+  thumbBmp.close();
+  SdMan.remove(coverImageTempPath.c_str());
 
-    FsFile coverJpg;
-    if (!SdMan.openFileForWrite("EBP", coverJpgTempPath, coverJpg)) {
-      return false;
-    }
-    readItemContentsToStream(coverImageHref, coverJpg, 1024);
-    coverJpg.close();
+  if (!success) {
+    Serial.printf("[%lu] [EBP] Failed to generate thumb BMP from cover image\n", millis());
+    SdMan.remove(getThumbBmpPath().c_str());
+  }
+  Serial.printf("[%lu] [EBP] Generated thumb BMP from cover image, success: %s\n", millis(),
+                success ? "yes" : "no");
+  return success;
+}
 
-    if (!SdMan.openFileForRead("EBP", coverJpgTempPath, coverJpg)) {
-      return false;
+Epub::CoverImagesJob::~CoverImagesJob() {
+  if (coverImage) {
+    finish(false);
+  }
+}
+
+JpegToBmpConverter::Job::Status Epub::CoverImagesJob::begin() {
+  using Status = JpegToBmpConverter::Job::Status;
+  if (!epub.bookMetadataCache || !epub.bookMetadataCache->isLoaded()) {
+    Serial.printf("[%lu] [EBP] Cannot generate cover images, cache not loaded\n", millis());
+    return Status::Failed;
+  }
+
+  const JpegToBmpConverter::Target sizes[MAX_IMAGES] = {
+      {nullptr, JpegToBmpConverter::COVER_MAX_WIDTH, JpegToBmpConverter::COVER_MAX_HEIGHT,
+       JpegToBmpConverter::Output::Bmp2Bit, false},
+      {nullptr, JpegToBmpConverter::COVER_MAX_WIDTH, JpegToBmpConverter::COVER_MAX_HEIGHT,
+       JpegToBmpConverter::Output::Bmp2Bit, true},
+      {nullptr, THUMB_TARGET_WIDTH, THUMB_TARGET_HEIGHT, JpegToBmpConverter::Output::Bmp1Bit, true},
+      // The library grid shows many of these at once, small enough that ordered dithering looks no worse
+      {nullptr, GRID_THUMB_WIDTH, GRID_THUMB_HEIGHT, JpegToBmpConverter::Output::Bmp1Bit, true,
+       JpegToBmpConverter::Dither::Ordered},
+  };
+  const std::string paths[MAX_IMAGES] = {epub.getCoverBmpPath(false), epub.getCoverBmpPath(true),
+                                         epub.getThumbBmpPath(), epub.getGridThumbBmpPath()};
+
+  JpegToBmpConverter::Target targets[MAX_IMAGES];
+  imageCount = 0;
+  for (uint8_t i = 0; i < MAX_IMAGES; i++) {
+    if (!SdMan.exists(paths[i].c_str())) {
+      imagePaths[imageCount] = paths[i];
+      targets[imageCount++] = sizes[i];
     }
+  }
+  if (imageCount == 0) {
+    return Status::Done;
+  }
 
-    FsFile thumbBmp;
-    if (!SdMan.openFileForWrite("EBP", getThumbBmpPath(), thumbBmp)) {
-      coverJpg.close();
-      return false;
+  coverImagePath = epub.getCachePath() + "/.cover.img";
+  if (!epub.extractCoverImage(coverImagePath) || !SdMan.openFileForRead("EBP", coverImagePath, coverImage)) {
+    return Status::Failed;
+  }
+  for (uint8_t i = 0; i < imageCount; i++) {
+    if (!SdMan.openFileForWrite("EBP", imagePaths[i], images[i])) {
+      imageCount = i;
+      finish(false);
+      return Status::Failed;
     }
-    // Use smaller target size for Continue Reading card (half of screen: 240x400)
-    // Generate 1-bit BMP for fast home screen rendering (no gray passes needed)
-    constexpr int THUMB_TARGET_WIDTH = 240;
-    constexpr int THUMB_TARGET_HEIGHT = 400;
-    const bool success = JpegToBmpConverter::jpegFileTo1BitBmpStreamWithSize(coverJpg, thumbBmp, THUMB_TARGET_WIDTH,
-                                                                             THUMB_TARGET_HEIGHT);
-    coverJpg.close();
-    thumbBmp.close();
-    SdMan.remove(coverJpgTempPath.c_str());
+    targets[i].out = &images[i];
+  }
 
+  Serial.printf("[%lu] [EBP] Generating %u cover images from cover image\n", millis(),
+                static_cast<unsigned>(imageCount));
+  job.reset(new JpegToBmpConverter::Job(coverImage, targets, imageCount));
+  if (!job->begin()) {
+    finish(false);
+    return Status::Failed;
+  }
+  return Status::Running;
+}
+
+JpegToBmpConverter::Job::Status Epub::CoverImagesJob::step() {
+  using Status = JpegToBmpConverter::Job::Status;
+  if (!job) {
+    return Status::Failed;
+  }
+  const Status status = job->step();
+  if (status != Status::Running) {
+    finish(status == Status::Done);
+  }
+  return status;
+}
+
+void Epub::CoverImagesJob::finish(const bool success) {
+  job.reset();
+  coverImage.close();
+  SdMan.remove(coverImagePath.c_str());
+  for (uint8_t i = 0; i < imageCount; i++) {
+    images[i].close();
     if (!success) {
-      Serial.printf("[%lu] [EBP] Failed to generate thumb BMP from JPG cover image\n", millis());
-      SdMan.remove(getThumbBmpPath().c_str());
+      SdMan.remove(imagePaths[i].c_str());
     }
-    Serial.printf("[%lu] [EBP] Generated thumb BMP from JPG cover image, success: %s\n", millis(),
-                  success ? "yes" : "no");
-    return success;
-  } else {
-    Serial.printf("[%lu] [EBP] Cover image is not a JPG, skipping thumbnail\n", millis());
   }
-
-  return false;
+  Serial.printf("[%lu] [EBP] Generated cover images, success: %s\n", millis(), success ? "yes" : "no");
+  imageCount = 0;
 }
 
 uint8_t* Epub::readItemContentsToBytes(const std::string& itemHref, size_t* size, const bool trailingNullByte) const {
@@ -1,6 +1,8 @@
 #pragma once
 
+#include <JpegToBmpConverter.h>
 #include <Print.h>
+#include <SdFat.h>
 
 #include <memory>
 #include <string>
@@ -29,6 +31,8 @@ class Epub {
   bool parseContentOpf(BookMetadataCache::BookMetadata& bookMetadata);
   bool parseTocNcxFile() const;
   bool parseTocNavFile() const;
+  // Copies the JPEG or PNG cover image out of the book, false when there is none
+  bool extractCoverImage(const std::string& imagePath) const;
 
  public:
   explicit Epub(std::string filepath, const std::string& cacheDir) : filepath(std::move(filepath)) {
@@ -49,6 +53,38 @@ class Epub {
   bool generateCoverBmp(bool cropped = false) const;
   std::string getThumbBmpPath() const;
   bool generateThumbBmp() const;
+  // Small 1-bit thumbnail for a grid of covers
+  std::string getGridThumbBmpPath() const;
+
+  /**
+   * Writes the missing cover images (both sleep covers, the home thumbnail and the grid thumbnail) from a single
+   * decode of the cover image, one row of MCUs per step() so it can run a slice at a time. Images that already exist
+   * are left alone. The epub must be loaded and outlive the job.
+   */
+  class CoverImagesJob {
+   public:
+    explicit CoverImagesJob(const Epub& epub) : epub(epub) {}
+    ~CoverImagesJob();
+    CoverImagesJob(const CoverImagesJob&) = delete;
+    CoverImagesJob& operator=(const CoverImagesJob&) = delete;
+
+    // Done when every image already exists, Failed when the book has no JPEG or PNG cover
+    JpegToBmpConverter::Job::Status begin();
+    JpegToBmpConverter::Job::Status step();
+
+   private:
+    static constexpr uint8_t MAX_IMAGES = 4;
+
+    const Epub& epub;
+    std::string coverImagePath;
+    FsFile coverImage;
+    FsFile images[MAX_IMAGES];
+    std::string imagePaths[MAX_IMAGES];
+    uint8_t imageCount = 0;
+    std::unique_ptr<JpegToBmpConverter::Job> job;
+
+    void finish(bool success);
+  };
   uint8_t* readItemContentsToBytes(const std::string& itemHref, size_t* size = nullptr,
                                    bool trailingNullByte = false) const;
   bool readItemContentsToStream(const std::string& itemHref, Print& out, size_t chunkSize) const;
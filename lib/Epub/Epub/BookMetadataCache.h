@@ -1,8 +1,10 @@
 #pragma once
 
+#include <BufferedFs.h>
 #include <SDCardManager.h>
 
 #include <algorithm>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -44,7 +46,7 @@ class BookMetadataCache {
 
  private:
   std::string cachePath;
-  size_t lutOffset;
+  uint32_t lutOffset;
   uint16_t spineCount;
   uint16_t tocCount;
   bool loaded;
@@ -54,6 +56,13 @@ class BookMetadataCache {
   // Temp file handles during build
   FsFile spineFile;
   FsFile tocFile;
+  // Buffered views of the files above while they're in use, declared after them so they're flushed before the close
+  std::unique_ptr<BufferedFsReader> bookReader;
+  std::unique_ptr<BufferedFsWriter> bookWriter;
+  std::unique_ptr<BufferedFsReader> spineReader;
+  std::unique_ptr<BufferedFsWriter> spineWriter;
+  std::unique_ptr<BufferedFsReader> tocReader;
+  std::unique_ptr<BufferedFsWriter> tocWriter;
 
   // Index for fast href→spineIndex lookup (used only for large EPUBs)
   struct SpineHrefIndexEntry {
@@ -76,10 +85,10 @@ class BookMetadataCache {
     return hash;
   }
 
-  uint32_t writeSpineEntry(FsFile& file, const SpineEntry& entry) const;
-  uint32_t writeTocEntry(FsFile& file, const TocEntry& entry) const;
-  SpineEntry readSpineEntry(FsFile& file) const;
-  TocEntry readTocEntry(FsFile& file) const;
+  uint32_t writeSpineEntry(BufferedFsWriter& writer, const SpineEntry& entry) const;
+  uint32_t writeTocEntry(BufferedFsWriter& writer, const TocEntry& entry) const;
+  SpineEntry readSpineEntry(BufferedFsReader& reader) const;
+  TocEntry readTocEntry(BufferedFsReader& reader) const;
 
  public:
   BookMetadata coreMetadata;
@@ -0,0 +1,88 @@
+#include "ChapterArena.h"
+
+#include <cstdlib>
+#include <new>
+
+ChapterArena::~ChapterArena() {
+  for (uint8_t i = 0; i < chunkCount; i++) {
+    free(chunks[i].data);
+  }
+}
+
+bool ChapterArena::nextChunk() {
+  // Reuse a chunk whose allocations have all been freed
+  for (uint8_t i = 0; i < chunkCount; i++) {
+    if (i != current && chunks[i].live == 0) {
+      chunks[i].used = 0;
+      current = static_cast<int8_t>(i);
+      return true;
+    }
+  }
+
+  if (chunkCount == MAX_CHUNKS) {
+    return false;
+  }
+  const auto data = static_cast<uint8_t*>(malloc(CHUNK_SIZE));
+  if (!data) {
+    return false;
+  }
+  chunks[chunkCount] = {data, 0, 0};
+  current = static_cast<int8_t>(chunkCount++);
+  stats.chunks = chunkCount;
+  return true;
+}
+
+void* ChapterArena::heapAllocate(const size_t size) {
+  stats.heapFallbacks++;
+  return ::operator new(size);
+}
+
+void* ChapterArena::allocate(size_t size) {
+  size = (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+  if (size > CHUNK_SIZE) {
+    return heapAllocate(size);
+  }
+  if ((current < 0 || chunks[current].used + size > CHUNK_SIZE) && !nextChunk()) {
+    return heapAllocate(size);
+  }
+
+  Chunk& chunk = chunks[current];
+  void* p = chunk.data + chunk.used;
+  chunk.used += size;
+  chunk.live++;
+  stats.allocations++;
+  stats.liveBytes += size;
+  if (stats.liveBytes > stats.peakLiveBytes) {
+    stats.peakLiveBytes = stats.liveBytes;
+  }
+  return p;
+}
+
+void ChapterArena::deallocate(void* p) {
+  const auto bytes = static_cast<uint8_t*>(p);
+  for (uint8_t i = 0; i < chunkCount; i++) {
+    Chunk& chunk = chunks[i];
+    if (bytes < chunk.data || bytes >= chunk.data + CHUNK_SIZE) {
+      continue;
+    }
+    // Sizes aren't tracked per allocation, the chunk's whole fill comes off once it is empty
+    if (--chunk.live == 0) {
+      stats.liveBytes -= chunk.used;
+      if (i == current) {
+        chunk.used = 0;
+      }
+    }
+    return;
+  }
+  ::operator delete(p);
+}
+
+bool ChapterArena::isNearCap() const {
+  uint8_t available = MAX_CHUNKS - chunkCount;
+  for (uint8_t i = 0; i < chunkCount; i++) {
+    if (i != current && chunks[i].live == 0) {
+      available++;
+    }
+  }
+  return available < FLUSH_HEADROOM_CHUNKS;
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <string>
+
+/**
+ * ChapterArena.h
+ *
+ * Bump allocator for everything built while a chapter is paginated: the words and styles in ParsedText, the lines
+ * they are spliced into, the TextBlocks and PageLines. Those are thousands of small allocations per chapter that all
+ * die within a page or two, so going to the heap for each of them is mostly overhead.
+ *
+ * Memory comes in fixed chunks. Allocations bump a pointer in the current chunk, frees only count down the chunk's
+ * live allocations and a chunk is reused once that reaches zero. Since pages complete in the order their words were
+ * parsed, chunks empty out in roughly the order they were filled and the arena stays close to the live size.
+ *
+ * The arena never holds more than MAX_CHUNKS. isNearCap() tells the parser to flush pages before that happens, past
+ * the cap allocations go to the heap and are counted in the stats.
+ */
+class ChapterArena {
+ public:
+  static constexpr size_t CHUNK_SIZE = 2048;
+  static constexpr uint8_t MAX_CHUNKS = 32;
+  // Pointer alignment covers strings, list nodes and shared_ptr control blocks
+  static constexpr size_t ALIGNMENT = alignof(void*);
+
+  struct Stats {
+    uint8_t chunks;    // Chunks ever allocated, the high water mark since they are only added when none is free
+    size_t liveBytes;  // Filled bytes of chunks that still hold a live allocation
+    size_t peakLiveBytes;
+    size_t allocations;
+    size_t heapFallbacks;
+  };
+
+ private:
+  struct Chunk {
+    uint8_t* data;
+    uint16_t used;
+    uint16_t live;  // Allocations not yet freed
+  };
+
+  Chunk chunks[MAX_CHUNKS] = {};
+  uint8_t chunkCount = 0;
+  int8_t current = -1;
+  Stats stats = {};
+
+  bool nextChunk();
+  void* heapAllocate(size_t size);
+
+ public:
+  // The parser checks this and flushes pages while a few chunks are still left
+  static constexpr uint8_t FLUSH_HEADROOM_CHUNKS = 2;
+
+  ChapterArena() = default;
+  ~ChapterArena();
+  ChapterArena(const ChapterArena&) = delete;
+  ChapterArena& operator=(const ChapterArena&) = delete;
+
+  void* allocate(size_t size);
+  // Accepts heap fallbacks too, anything outside the chunks is handed to operator delete
+  void deallocate(void* p);
+
+  bool isNearCap() const;
+  const Stats& getStats() const { return stats; }
+};
+
+// Standard allocator over a ChapterArena. Without an arena it uses the heap, so the same container types work for
+// pages built by the parser and pages loaded back from the section file.
+template <typename T>
+class ArenaAllocator {
+  static_assert(alignof(T) <= ChapterArena::ALIGNMENT, "Type needs more alignment than the arena provides");
+
+ public:
+  using value_type = T;
+
+  ChapterArena* arena;
+
+  ArenaAllocator() noexcept : arena(nullptr) {}
+  explicit ArenaAllocator(ChapterArena* arena) noexcept : arena(arena) {}
+  template <typename U>
+  ArenaAllocator(const ArenaAllocator<U>& other) noexcept : arena(other.arena) {}
+
+  T* allocate(const size_t n) {
+    const size_t size = n * sizeof(T);
+    return static_cast<T*>(arena ? arena->allocate(size) : ::operator new(size));
+  }
+
+  void deallocate(T* p, size_t) noexcept {
+    if (arena) {
+      arena->deallocate(p);
+    } else {
+      ::operator delete(p);
+    }
+  }
+
+  template <typename U>
+  bool operator==(const ArenaAllocator<U>& other) const noexcept {
+    return arena == other.arena;
+  }
+  template <typename U>
+  bool operator!=(const ArenaAllocator<U>& other) const noexcept {
+    return arena != other.arena;
+  }
+};
+
+using ArenaString = std::basic_string<char, std::char_traits<char>, ArenaAllocator<char>>;
+template <typename T>
+using ArenaList = std::list<T, ArenaAllocator<T>>;
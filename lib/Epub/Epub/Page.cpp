@@ -1,44 +1,110 @@
 #include "Page.h"
 
-#include <HardwareSerial.h>
+#include <GfxRenderer.h>
+#include <JpegToBmpConverter.h>
+#include <Logging.h>
+#include <Perf.h>
+#include <SDCardManager.h>
 #include <Serialization.h>
 
+#include <algorithm>
+
 void PageLine::render(GfxRenderer& renderer, const int fontId, const int xOffset, const int yOffset) {
   block->render(renderer, fontId, xPos + xOffset, yPos + yOffset);
 }
 
-bool PageLine::serialize(FsFile& file) {
-  serialization::writePod(file, xPos);
-  serialization::writePod(file, yPos);
+bool PageLine::serialize(BufferedFsWriter& writer) {
+  serialization::writePod(writer, xPos);
+  serialization::writePod(writer, yPos);
 
   // serialize TextBlock pointed to by PageLine
-  return block->serialize(file);
+  return block->serialize(writer);
 }
 
-std::unique_ptr<PageLine> PageLine::deserialize(FsFile& file) {
+std::unique_ptr<PageLine> PageLine::deserialize(BufferedFsReader& reader) {
   int16_t xPos;
   int16_t yPos;
-  serialization::readPod(file, xPos);
-  serialization::readPod(file, yPos);
+  serialization::readPod(reader, xPos);
+  serialization::readPod(reader, yPos);
 
-  auto tb = TextBlock::deserialize(file);
+  auto tb = TextBlock::deserialize(reader);
+  if (!tb) {
+    return nullptr;
+  }
   return std::unique_ptr<PageLine>(new PageLine(std::move(tb), xPos, yPos));
 }
 
+void PageImage::render(GfxRenderer& renderer, const int fontId, const int xOffset, const int yOffset) {
+  FsFile file;
+  if (!SdMan.openFileForRead("PGE", sectionPath, file)) {
+    return;
+  }
+  const int rowBytes = JpegToBmpConverter::planarRowBytes(width);
+  const int planeBytes = rowBytes / 2;
+  std::vector<uint8_t> row(rowBytes);
+  file.seek(blobOffset);
+  BufferedFsReader reader(file);
+  for (int y = 0; y < height; y++) {
+    if (reader.read(row.data(), rowBytes) != static_cast<size_t>(rowBytes)) {
+      LOG_E(PGE, "Failed to read image row %d", y);
+      break;
+    }
+    renderer.drawPlanarRow(row.data(), row.data() + planeBytes, xPos + xOffset, yPos + yOffset + y, width);
+  }
+  file.close();
+}
+
+bool PageImage::serialize(BufferedFsWriter& writer) {
+  serialization::writePod(writer, xPos);
+  serialization::writePod(writer, yPos);
+  serialization::writePod(writer, width);
+  serialization::writePod(writer, height);
+  serialization::writePod(writer, blobOffset);
+  return true;
+}
+
+std::unique_ptr<PageImage> PageImage::deserialize(BufferedFsReader& reader, const std::string& sectionPath) {
+  int16_t xPos;
+  int16_t yPos;
+  uint16_t width;
+  uint16_t height;
+  uint32_t blobOffset;
+  serialization::readPod(reader, xPos);
+  serialization::readPod(reader, yPos);
+  serialization::readPod(reader, width);
+  serialization::readPod(reader, height);
+  serialization::readPod(reader, blobOffset);
+  return std::unique_ptr<PageImage>(new PageImage(width, height, blobOffset, sectionPath, xPos, yPos));
+}
+
 void Page::render(GfxRenderer& renderer, const int fontId, const int xOffset, const int yOffset) const {
+  PERF_SCOPE(RASTER);
   for (auto& element : elements) {
     element->render(renderer, fontId, xOffset, yOffset);
   }
 }
 
-bool Page::serialize(FsFile& file) const {
+void Page::renderImages(GfxRenderer& renderer, const int xOffset, const int yOffset) const {
+  for (auto& element : elements) {
+    if (element->getTag() == TAG_PageImage) {
+      element->render(renderer, 0, xOffset, yOffset);
+    }
+  }
+}
+
+bool Page::hasImages() const {
+  return std::any_of(elements.begin(), elements.end(), [](const std::shared_ptr<PageElement>& element) {
+    return element->getTag() == TAG_PageImage;
+  });
+}
+
+bool Page::serialize(BufferedFsWriter& writer) const {
   const uint16_t count = elements.size();
-  serialization::writePod(file, count);
+  serialization::writePod(writer, count);
 
   for (const auto& el : elements) {
-    // Only PageLine exists currently
-    serialization::writePod(file, static_cast<uint8_t>(TAG_PageLine));
-    if (!el->serialize(file)) {
+    serialization::writePod(writer, static_cast<uint8_t>(el->getTag()));
+    if (!el->serialize(writer)) {
       return false;
     }
   }
@@ -46,21 +112,26 @@ bool Page::serialize(FsFile& file) const {
   return true;
 }
 
-std::unique_ptr<Page> Page::deserialize(FsFile& file) {
+std::unique_ptr<Page> Page::deserialize(BufferedFsReader& reader, const std::string& sectionPath) {
   auto page = std::unique_ptr<Page>(new Page());
 
   uint16_t count;
-  serialization::readPod(file, count);
+  serialization::readPod(reader, count);
 
   for (uint16_t i = 0; i < count; i++) {
     uint8_t tag;
-    serialization::readPod(file, tag);
+    serialization::readPod(reader, tag);
 
     if (tag == TAG_PageLine) {
-      auto pl = PageLine::deserialize(file);
+      auto pl = PageLine::deserialize(reader);
+      if (!pl) {
+        return nullptr;
+      }
       page->elements.push_back(std::move(pl));
+    } else if (tag == TAG_PageImage) {
+      page->elements.push_back(PageImage::deserialize(reader, sectionPath));
     } else {
-      Serial.printf("[%lu] [PGE] Deserialization failed: Unknown tag %u\n", millis(), tag);
+      LOG_E(PGE, "Deserialization failed: Unknown tag %u", tag);
       return nullptr;
     }
   }
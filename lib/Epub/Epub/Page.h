@@ -1,6 +1,7 @@
 #pragma once
-#include <SdFat.h>
+#include <BufferedFs.h>
 
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -8,6 +9,7 @@
 
 enum PageElementTag : uint8_t {
   TAG_PageLine = 1,
+  TAG_PageImage = 2,
 };
 
 // represents something that has been added to a page
@@ -17,8 +19,9 @@ class PageElement {
   int16_t yPos;
   explicit PageElement(const int16_t xPos, const int16_t yPos) : xPos(xPos), yPos(yPos) {}
   virtual ~PageElement() = default;
+  virtual PageElementTag getTag() const = 0;
   virtual void render(GfxRenderer& renderer, int fontId, int xOffset, int yOffset) = 0;
-  virtual bool serialize(FsFile& file) = 0;
+  virtual bool serialize(BufferedFsWriter& writer) = 0;
 };
 
 // a line from a block element
@@ -28,9 +31,33 @@ class PageLine final : public PageElement {
  public:
   PageLine(std::shared_ptr<TextBlock> block, const int16_t xPos, const int16_t yPos)
       : PageElement(xPos, yPos), block(std::move(block)) {}
+  PageElementTag getTag() const override { return TAG_PageLine; }
   void render(GfxRenderer& renderer, int fontId, int xOffset, int yOffset) override;
-  bool serialize(FsFile& file) override;
-  static std::unique_ptr<PageLine> deserialize(FsFile& file);
+  bool serialize(BufferedFsWriter& writer) override;
+  static std::unique_ptr<PageLine> deserialize(BufferedFsReader& reader);
+};
+
+// an image, scaled and dithered when the section was laid out. The pixels are a planar blob (see
+// JpegToBmpConverter::Output::Planar2Bit) in the section file, streamed from the card a few rows at a time.
+class PageImage final : public PageElement {
+  uint16_t width;
+  uint16_t height;
+  uint32_t blobOffset;
+  std::string sectionPath;
+
+ public:
+  PageImage(const uint16_t width, const uint16_t height, const uint32_t blobOffset, std::string sectionPath,
+            const int16_t xPos, const int16_t yPos)
+      : PageElement(xPos, yPos),
+        width(width),
+        height(height),
+        blobOffset(blobOffset),
+        sectionPath(std::move(sectionPath)) {}
+  uint16_t getHeight() const { return height; }
+  PageElementTag getTag() const override { return TAG_PageImage; }
+  void render(GfxRenderer& renderer, int fontId, int xOffset, int yOffset) override;
+  bool serialize(BufferedFsWriter& writer) override;
+  static std::unique_ptr<PageImage> deserialize(BufferedFsReader& reader, const std::string& sectionPath);
 };
 
 class Page {
@@ -38,6 +65,10 @@ class Page {
   // the list of block index and line numbers on this page
   std::vector<std::shared_ptr<PageElement>> elements;
   void render(GfxRenderer& renderer, int fontId, int xOffset, int yOffset) const;
-  bool serialize(FsFile& file) const;
-  static std::unique_ptr<Page> deserialize(FsFile& file);
+  // Only the images, for the grayscale passes when text anti-aliasing is off
+  void renderImages(GfxRenderer& renderer, int xOffset, int yOffset) const;
+  bool hasImages() const;
+  bool serialize(BufferedFsWriter& writer) const;
+  // sectionPath is the file holding the pixels of the page's images
+  static std::unique_ptr<Page> deserialize(BufferedFsReader& reader, const std::string& sectionPath);
 };
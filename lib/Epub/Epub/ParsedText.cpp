@@ -1,6 +1,7 @@
 #include "ParsedText.h"
 
 #include <GfxRenderer.h>
+#include <Perf.h>
 
 #include <algorithm>
 #include <cmath>
@@ -19,25 +20,25 @@ namespace {
 constexpr char SOFT_HYPHEN_UTF8[] = "\xC2\xAD";
 constexpr size_t SOFT_HYPHEN_BYTES = 2;
 
-bool containsSoftHyphen(const std::string& word) { return word.find(SOFT_HYPHEN_UTF8) != std::string::npos; }
+bool containsSoftHyphen(const ArenaString& word) { return word.find(SOFT_HYPHEN_UTF8) != ArenaString::npos; }
 
 // Removes every soft hyphen in-place so rendered glyphs match measured widths.
-void stripSoftHyphensInPlace(std::string& word) {
+void stripSoftHyphensInPlace(ArenaString& word) {
   size_t pos = 0;
-  while ((pos = word.find(SOFT_HYPHEN_UTF8, pos)) != std::string::npos) {
+  while ((pos = word.find(SOFT_HYPHEN_UTF8, pos)) != ArenaString::npos) {
     word.erase(pos, SOFT_HYPHEN_BYTES);
   }
 }
 
 // Returns the rendered width for a word while ignoring soft hyphen glyphs and optionally appending a visible hyphen.
-uint16_t measureWordWidth(const GfxRenderer& renderer, const int fontId, const std::string& word,
+uint16_t measureWordWidth(const GfxRenderer& renderer, const int fontId, const ArenaString& word,
                           const EpdFontFamily::Style style, const bool appendHyphen = false) {
   const bool hasSoftHyphen = containsSoftHyphen(word);
   if (!hasSoftHyphen && !appendHyphen) {
     return renderer.getTextWidth(fontId, word.c_str(), style);
   }
 
-  std::string sanitized = word;
+  ArenaString sanitized = word;
   if (hasSoftHyphen) {
     stripSoftHyphensInPlace(sanitized);
   }
@@ -49,10 +50,10 @@ uint16_t measureWordWidth(const GfxRenderer& renderer, const int fontId, const s
 
 }  // namespace
 
-void ParsedText::addWord(std::string word, const EpdFontFamily::Style fontStyle) {
-  if (word.empty()) return;
+void ParsedText::addWord(const char* word, const EpdFontFamily::Style fontStyle) {
+  if (!*word) return;
 
-  words.push_back(std::move(word));
+  words.emplace_back(word, ArenaAllocator<char>(arena));
   wordStyles.push_back(fontStyle);
 }
 
@@ -63,6 +64,7 @@ void ParsedText::layoutAndExtractLines(const GfxRenderer& renderer, const int fo
   if (words.empty()) {
     return;
   }
+  PERF_SCOPE(LINE_BREAK);
 
   // Apply fixed transforms before any per-line layout work.
   applyParagraphIndent();
@@ -271,11 +273,12 @@ bool ParsedText::hyphenateWordAtIndex(const size_t wordIndex, const int availabl
   std::advance(wordIt, wordIndex);
   std::advance(styleIt, wordIndex);
 
-  const std::string& word = *wordIt;
+  const ArenaString& word = *wordIt;
   const auto style = *styleIt;
 
   // Collect candidate breakpoints (byte offsets and hyphen requirements).
-  auto breakInfos = Hyphenator::breakOffsets(word, allowFallbackBreaks);
+  // Only words that overflow a line get here, a heap copy for the hyphenator is fine
+  auto breakInfos = Hyphenator::breakOffsets(std::string(word.data(), word.size()), allowFallbackBreaks);
   if (breakInfos.empty()) {
     return false;
   }
@@ -308,7 +311,7 @@ bool ParsedText::hyphenateWordAtIndex(const size_t wordIndex, const int availabl
   }
 
   // Split the word at the selected breakpoint and append a hyphen if required.
-  std::string remainder = word.substr(chosenOffset);
+  ArenaString remainder = word.substr(chosenOffset);
   wordIt->resize(chosenOffset);
   if (chosenNeedsHyphen) {
     wordIt->push_back('-');
@@ -359,7 +362,7 @@ void ParsedText::extractLine(const size_t breakIndex, const int pageWidth, const
   }
 
   // Pre-calculate X positions for words
-  std::list<uint16_t> lineXPos;
+  ArenaList<uint16_t> lineXPos{ArenaAllocator<uint16_t>(arena)};
   for (size_t i = lastBreakAt; i < lineBreak; i++) {
     const uint16_t currentWordWidth = wordWidths[i];
     lineXPos.push_back(xpos);
@@ -373,9 +376,9 @@ void ParsedText::extractLine(const size_t breakIndex, const int pageWidth, const
   std::advance(wordStyleEndIt, lineWordCount);
 
   // *** CRITICAL STEP: CONSUME DATA USING SPLICE ***
-  std::list<std::string> lineWords;
+  ArenaList<ArenaString> lineWords{ArenaAllocator<ArenaString>(arena)};
   lineWords.splice(lineWords.begin(), words, words.begin(), wordEndIt);
-  std::list<EpdFontFamily::Style> lineWordStyles;
+  ArenaList<EpdFontFamily::Style> lineWordStyles{ArenaAllocator<EpdFontFamily::Style>(arena)};
   lineWordStyles.splice(lineWordStyles.begin(), wordStyles, wordStyles.begin(), wordStyleEndIt);
 
   for (auto& word : lineWords) {
@@ -384,5 +387,6 @@ void ParsedText::extractLine(const size_t breakIndex, const int pageWidth, const
     }
   }
 
-  processLine(std::make_shared<TextBlock>(std::move(lineWords), std::move(lineXPos), std::move(lineWordStyles), style));
+  processLine(std::allocate_shared<TextBlock>(ArenaAllocator<TextBlock>(arena), std::move(lineWords),
+                                              std::move(lineXPos), std::move(lineWordStyles), style));
 }
\ No newline at end of file
@@ -1,41 +1,113 @@
 #include "Section.h"
 
+#include <FsHelpers.h>
+#include <JpegToBmpConverter.h>
+#include <Logging.h>
+#include <Perf.h>
 #include <SDCardManager.h>
 #include <Serialization.h>
 
+#include <algorithm>
+
+#include "ChapterArena.h"
 #include "Page.h"
 #include "hyphenation/Hyphenator.h"
 #include "parsers/ChapterHtmlSlimParser.h"
 
 namespace {
-constexpr uint8_t SECTION_FILE_VERSION = 10;
+constexpr uint8_t SECTION_FILE_VERSION = 13;
 constexpr uint32_t HEADER_SIZE = sizeof(uint8_t) + sizeof(int) + sizeof(float) + sizeof(bool) + sizeof(uint8_t) +
                                  sizeof(uint16_t) + sizeof(uint16_t) + sizeof(uint16_t) + sizeof(bool) +
                                  sizeof(uint32_t);
+
+// Lets the image converter write pixels straight into the section file
+class SectionWriterPrint final : public Print {
+  BufferedFsWriter& writer;
+
+ public:
+  explicit SectionWriterPrint(BufferedFsWriter& writer) : writer(writer) {}
+  size_t write(const uint8_t c) override { return writer.write(&c, 1); }
+  size_t write(const uint8_t* buffer, const size_t size) override { return writer.write(buffer, size); }
+};
 }  // namespace
 
-uint32_t Section::onPageComplete(std::unique_ptr<Page> page) {
+std::shared_ptr<PageImage> Section::layOutImage(BufferedFsWriter& writer, const std::string& src,
+                                                const uint16_t viewportWidth, const uint16_t viewportHeight) {
+  // src is relative to the chapter, item paths are relative to the root of the book
+  const auto& chapterHref = epub->getSpineItem(spineIndex).href;
+  const size_t slash = chapterHref.find_last_of('/');
+  const std::string chapterDir = slash == std::string::npos ? "" : chapterHref.substr(0, slash + 1);
+  const std::string itemPath = FsHelpers::normalisePath(chapterDir + src.substr(0, src.find('#')));
+  if (!JpegToBmpConverter::isSupportedImage(itemPath.c_str())) {
+    LOG_I(SCT, "Image %s is not a JPEG or PNG, showing its alt text", itemPath.c_str());
+    return nullptr;
+  }
+
+  const auto tmpImagePath = epub->getCachePath() + "/.tmp_image.img";
+  FsFile image;
+  if (!SdMan.openFileForWrite("SCT", tmpImagePath, image)) {
+    return nullptr;
+  }
+  const bool extracted = epub->readItemContentsToStream(itemPath, image, 1024);
+  image.close();
+  if (!extracted || !SdMan.openFileForRead("SCT", tmpImagePath, image)) {
+    LOG_W(SCT, "Failed to read image %s, showing its alt text", itemPath.c_str());
+    SdMan.remove(tmpImagePath.c_str());
+    return nullptr;
+  }
+
+  // Decoded a few rows at a time straight into the section file, the same memory as a cover conversion
+  SectionWriterPrint out(writer);
+  const JpegToBmpConverter::Target target = {&out, viewportWidth, viewportHeight,
+                                             JpegToBmpConverter::Output::Planar2Bit, false};
+  const uint32_t blobOffset = writer.position();
+  JpegToBmpConverter::Job job(image, &target, 1);
+  auto status = JpegToBmpConverter::Job::Status::Failed;
+  int width = 0, height = 0;
+  if (job.begin()) {
+    job.getOutputSize(0, width, height);
+    do {
+      status = job.step();
+    } while (status == JpegToBmpConverter::Job::Status::Running);
+  }
+  image.close();
+  SdMan.remove(tmpImagePath.c_str());
+
+  // A partly written blob is left behind, nothing points at it
+  if (status != JpegToBmpConverter::Job::Status::Done ||
+      writer.position() - blobOffset != static_cast<uint32_t>(JpegToBmpConverter::planarRowBytes(width) * height)) {
+    LOG_W(SCT, "Failed to convert image %s, showing its alt text", itemPath.c_str());
+    return nullptr;
+  }
+  LOG_D(SCT, "Laid out image %s at %dx%d", itemPath.c_str(), width, height);
+  const auto xPos = static_cast<int16_t>((viewportWidth - width) / 2);
+  return std::make_shared<PageImage>(width, height, blobOffset, filePath, xPos, 0);
+}
+
+uint32_t Section::onPageComplete(BufferedFsWriter& writer, std::unique_ptr<Page> page) {
   if (!file) {
-    Serial.printf("[%lu] [SCT] File not open for writing page %d\n", millis(), pageCount);
+    LOG_E(SCT, "File not open for writing page %d", pageCount);
     return 0;
   }
 
-  const uint32_t position = file.position();
-  if (!page->serialize(file)) {
-    Serial.printf("[%lu] [SCT] Failed to serialize page %d\n", millis(), pageCount);
+  const uint32_t position = writer.position();
+  if (!page->serialize(writer)) {
+    LOG_E(SCT, "Failed to serialize page %d", pageCount);
     return 0;
   }
-  Serial.printf("[%lu] [SCT] Page %d processed\n", millis(), pageCount);
+  LOG_D(SCT, "Page %d processed", pageCount);
+  PERF_COUNT(PAGES_LAID_OUT, 1);
 
   pageCount++;
   return position;
 }
 
-void Section::writeSectionFileHeader(const int fontId, const float lineCompression, const bool extraParagraphSpacing,
-                                     const uint8_t paragraphAlignment, const uint16_t viewportWidth,
-                                     const uint16_t viewportHeight, const bool hyphenationEnabled) {
+void Section::writeSectionFileHeader(BufferedFsWriter& writer, const int fontId, const float lineCompression,
+                                     const bool extraParagraphSpacing, const uint8_t paragraphAlignment,
+                                     const uint16_t viewportWidth, const uint16_t viewportHeight,
+                                     const bool hyphenationEnabled) {
   if (!file) {
-    Serial.printf("[%lu] [SCT] File not open for writing header\n", millis());
+    LOG_E(SCT, "File not open for writing header");
     return;
   }
   static_assert(HEADER_SIZE == sizeof(SECTION_FILE_VERSION) + sizeof(fontId) + sizeof(lineCompression) +
@@ -43,16 +115,16 @@ void Section::writeSectionFileHeader(const int fontId, const float lineCompressi
                                    sizeof(viewportHeight) + sizeof(pageCount) + sizeof(hyphenationEnabled) +
                                    sizeof(uint32_t),
                 "Header size mismatch");
-  serialization::writePod(file, SECTION_FILE_VERSION);
-  serialization::writePod(file, fontId);
-  serialization::writePod(file, lineCompression);
-  serialization::writePod(file, extraParagraphSpacing);
-  serialization::writePod(file, paragraphAlignment);
-  serialization::writePod(file, viewportWidth);
-  serialization::writePod(file, viewportHeight);
-  serialization::writePod(file, hyphenationEnabled);
-  serialization::writePod(file, pageCount);  // Placeholder for page count (will be initially 0 when written)
-  serialization::writePod(file, static_cast<uint32_t>(0));  // Placeholder for LUT offset
+  serialization::writePod(writer, SECTION_FILE_VERSION);
+  serialization::writePod(writer, fontId);
+  serialization::writePod(writer, lineCompression);
+  serialization::writePod(writer, extraParagraphSpacing);
+  serialization::writePod(writer, paragraphAlignment);
+  serialization::writePod(writer, viewportWidth);
+  serialization::writePod(writer, viewportHeight);
+  serialization::writePod(writer, hyphenationEnabled);
+  serialization::writePod(writer, pageCount);  // Placeholder for page count (will be initially 0 when written)
+  serialization::writePod(writer, static_cast<uint32_t>(0));  // Placeholder for LUT offset
 }
 
 bool Section::loadSectionFile(const int fontId, const float lineCompression, const bool extraParagraphSpacing,
@@ -61,14 +133,15 @@ bool Section::loadSectionFile(const int fontId, const float lineCompression, con
   if (!SdMan.openFileForRead("SCT", filePath, file)) {
     return false;
   }
+  BufferedFsReader reader(file);
 
   // Match parameters
   {
     uint8_t version;
-    serialization::readPod(file, version);
+    serialization::readPod(reader, version);
     if (version != SECTION_FILE_VERSION) {
       file.close();
-      Serial.printf("[%lu] [SCT] Deserialization failed: Unknown version %u\n", millis(), version);
+      LOG_E(SCT, "Deserialization failed: Unknown version %u", version);
       clearCache();
       return false;
     }
@@ -79,44 +152,44 @@ bool Section::loadSectionFile(const int fontId, const float lineCompression, con
     bool fileExtraParagraphSpacing;
     uint8_t fileParagraphAlignment;
     bool fileHyphenationEnabled;
-    serialization::readPod(file, fileFontId);
-    serialization::readPod(file, fileLineCompression);
-    serialization::readPod(file, fileExtraParagraphSpacing);
-    serialization::readPod(file, fileParagraphAlignment);
-    serialization::readPod(file, fileViewportWidth);
-    serialization::readPod(file, fileViewportHeight);
-    serialization::readPod(file, fileHyphenationEnabled);
+    serialization::readPod(reader, fileFontId);
+    serialization::readPod(reader, fileLineCompression);
+    serialization::readPod(reader, fileExtraParagraphSpacing);
+    serialization::readPod(reader, fileParagraphAlignment);
+    serialization::readPod(reader, fileViewportWidth);
+    serialization::readPod(reader, fileViewportHeight);
+    serialization::readPod(reader, fileHyphenationEnabled);
 
     if (fontId != fileFontId || lineCompression != fileLineCompression ||
         extraParagraphSpacing != fileExtraParagraphSpacing || paragraphAlignment != fileParagraphAlignment ||
         viewportWidth != fileViewportWidth || viewportHeight != fileViewportHeight ||
         hyphenationEnabled != fileHyphenationEnabled) {
       file.close();
-      Serial.printf("[%lu] [SCT] Deserialization failed: Parameters do not match\n", millis());
+      LOG_W(SCT, "Deserialization failed: Parameters do not match");
       clearCache();
       return false;
     }
   }
 
-  serialization::readPod(file, pageCount);
+  serialization::readPod(reader, pageCount);
   file.close();
-  Serial.printf("[%lu] [SCT] Deserialization succeeded: %d pages\n", millis(), pageCount);
+  LOG_I(SCT, "Deserialization succeeded: %d pages", pageCount);
   return true;
 }
 
 // Your updated class method (assuming you are using the 'SD' object, which is a wrapper for a specific filesystem)
 bool Section::clearCache() const {
   if (!SdMan.exists(filePath.c_str())) {
-    Serial.printf("[%lu] [SCT] Cache does not exist, no action needed\n", millis());
+    LOG_I(SCT, "Cache does not exist, no action needed");
     return true;
   }
 
   if (!SdMan.remove(filePath.c_str())) {
-    Serial.printf("[%lu] [SCT] Failed to clear cache\n", millis());
+    LOG_E(SCT, "Failed to clear cache");
     return false;
   }
 
-  Serial.printf("[%lu] [SCT] Cache cleared successfully\n", millis());
+  LOG_I(SCT, "Cache cleared successfully");
   return true;
 }
 
@@ -124,7 +197,8 @@ bool Section::createSectionFile(const int fontId, const float lineCompression, c
                                 const uint8_t paragraphAlignment, const uint16_t viewportWidth,
                                 const uint16_t viewportHeight, const bool hyphenationEnabled,
                                 const std::function<void()>& progressSetupFn,
-                                const std::function<void(int)>& progressFn) {
+                                const std::function<void(int)>& progressFn,
+                                const std::function<bool()>& abortFn) {
   constexpr uint32_t MIN_SIZE_FOR_PROGRESS = 50 * 1024;  // 50KB
   const auto localPath = epub->getSpineItem(spineIndex).href;
   const auto tmpHtmlPath = epub->getCachePath() + "/.tmp_" + std::to_string(spineIndex) + ".html";
@@ -140,7 +214,7 @@ bool Section::createSectionFile(const int fontId, const float lineCompression, c
   uint32_t fileSize = 0;
   for (int attempt = 0; attempt < 3 && !success; attempt++) {
     if (attempt > 0) {
-      Serial.printf("[%lu] [SCT] Retrying stream (attempt %d)...\n", millis(), attempt + 1);
+      LOG_W(SCT, "Retrying stream (attempt %d)...", attempt + 1);
       delay(50);  // Brief delay before retry
     }
 
@@ -160,16 +234,16 @@ bool Section::createSectionFile(const int fontId, const float lineCompression, c
     // If streaming failed, remove the incomplete file immediately
     if (!success && SdMan.exists(tmpHtmlPath.c_str())) {
       SdMan.remove(tmpHtmlPath.c_str());
-      Serial.printf("[%lu] [SCT] Removed incomplete temp file after failed attempt\n", millis());
+      LOG_W(SCT, "Removed incomplete temp file after failed attempt");
     }
   }
 
   if (!success) {
-    Serial.printf("[%lu] [SCT] Failed to stream item contents to temp file after retries\n", millis());
+    LOG_E(SCT, "Failed to stream item contents to temp file after retries");
     return false;
   }
 
-  Serial.printf("[%lu] [SCT] Streamed temp HTML to %s (%d bytes)\n", millis(), tmpHtmlPath.c_str(), fileSize);
+  LOG_I(SCT, "Streamed temp HTML to %s (%d bytes)", tmpHtmlPath.c_str(), fileSize);
 
   // Only show progress bar for larger chapters where rendering overhead is worth it
   if (progressSetupFn && fileSize >= MIN_SIZE_FOR_PROGRESS) {
@@ -179,48 +253,68 @@ bool Section::createSectionFile(const int fontId, const float lineCompression, c
   if (!SdMan.openFileForWrite("SCT", filePath, file)) {
     return false;
   }
-  writeSectionFileHeader(fontId, lineCompression, extraParagraphSpacing, paragraphAlignment, viewportWidth,
+  BufferedFsWriter writer(file);
+  writeSectionFileHeader(writer, fontId, lineCompression, extraParagraphSpacing, paragraphAlignment, viewportWidth,
                          viewportHeight, hyphenationEnabled);
   std::vector<uint32_t> lut = {};
 
+  // Declared before the parser so it outlives every page the parser builds
+  ChapterArena arena;
+  bool aborted = false;
   ChapterHtmlSlimParser visitor(
       tmpHtmlPath, renderer, fontId, lineCompression, extraParagraphSpacing, paragraphAlignment, viewportWidth,
       viewportHeight, hyphenationEnabled,
-      [this, &lut](std::unique_ptr<Page> page) { lut.emplace_back(this->onPageComplete(std::move(page))); },
-      progressFn);
+      [this, &writer, &lut](std::unique_ptr<Page> page) {
+        lut.emplace_back(this->onPageComplete(writer, std::move(page)));
+      },
+      progressFn, &arena,
+      [this, &writer, viewportWidth, viewportHeight](const std::string& src) {
+        return layOutImage(writer, src, viewportWidth, viewportHeight);
+      },
+      [&abortFn, &aborted] { return aborted = abortFn && abortFn(); });
   Hyphenator::setPreferredLanguage(epub->getLanguage());
   success = visitor.parseAndBuildPages();
 
+  const auto& arenaStats = arena.getStats();
+  LOG_I(SCT, "Arena high water %zu bytes in %u chunks, peak live %zu bytes, %zu allocations, %zu heap fallbacks",
+        arenaStats.chunks * ChapterArena::CHUNK_SIZE, arenaStats.chunks, arenaStats.peakLiveBytes,
+        arenaStats.allocations, arenaStats.heapFallbacks);
+
   SdMan.remove(tmpHtmlPath.c_str());
   if (!success) {
-    Serial.printf("[%lu] [SCT] Failed to parse XML and build pages\n", millis());
+    if (aborted) {
+      LOG_I(SCT, "Stopped building pages, the section file is dropped");
+    } else {
+      LOG_E(SCT, "Failed to parse XML and build pages");
+    }
+    writer.flush();
     file.close();
     SdMan.remove(filePath.c_str());
     return false;
   }
 
-  const uint32_t lutOffset = file.position();
-  bool hasFailedLutRecords = false;
-  // Write LUT
-  for (const uint32_t& pos : lut) {
-    if (pos == 0) {
-      hasFailedLutRecords = true;
-      break;
-    }
-    serialization::writePod(file, pos);
-  }
-
-  if (hasFailedLutRecords) {
-    Serial.printf("[%lu] [SCT] Failed to write LUT due to invalid page positions\n", millis());
+  if (std::find(lut.begin(), lut.end(), 0) != lut.end()) {
+    LOG_E(SCT, "Failed to write LUT due to invalid page positions");
+    writer.flush();
     file.close();
     SdMan.remove(filePath.c_str());
     return false;
   }
 
+  // Write LUT
+  const uint32_t lutOffset = writer.position();
+  serialization::writePodArray(writer, lut.data(), lut.size());
+
   // Go back and write LUT offset
-  file.seek(HEADER_SIZE - sizeof(uint32_t) - sizeof(pageCount));
-  serialization::writePod(file, pageCount);
-  serialization::writePod(file, lutOffset);
+  writer.seek(HEADER_SIZE - sizeof(uint32_t) - sizeof(pageCount));
+  serialization::writePod(writer, pageCount);
+  serialization::writePod(writer, lutOffset);
+  if (!writer.flush()) {
+    LOG_E(SCT, "Failed to write section file");
+    file.close();
+    SdMan.remove(filePath.c_str());
+    return false;
+  }
   file.close();
   return true;
 }
@@ -230,15 +324,17 @@ std::unique_ptr<Page> Section::loadPageFromSectionFile() {
     return nullptr;
   }
 
-  file.seek(HEADER_SIZE - sizeof(uint32_t));
+  BufferedFsReader reader(file);
+  reader.seek(HEADER_SIZE - sizeof(uint32_t));
   uint32_t lutOffset;
-  serialization::readPod(file, lutOffset);
-  file.seek(lutOffset + sizeof(uint32_t) * currentPage);
+  serialization::readPod(reader, lutOffset);
+  reader.seek(lutOffset + sizeof(uint32_t) * currentPage);
   uint32_t pagePos;
-  serialization::readPod(file, pagePos);
-  file.seek(pagePos);
+  serialization::readPod(reader, pagePos);
+  reader.seek(pagePos);
 
-  auto page = Page::deserialize(file);
+  PERF_SCOPE(SD_READ);
+  auto page = Page::deserialize(reader, filePath);
   file.close();
   return page;
 }
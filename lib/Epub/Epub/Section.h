@@ -1,10 +1,13 @@
 #pragma once
+#include <BufferedFs.h>
+
 #include <functional>
 #include <memory>
 
 #include "Epub.h"
 
 class Page;
+class PageImage;
 class GfxRenderer;
 
 class Section {
@@ -14,9 +17,13 @@ class Section {
   std::string filePath;
   FsFile file;
 
-  void writeSectionFileHeader(int fontId, float lineCompression, bool extraParagraphSpacing, uint8_t paragraphAlignment,
-                              uint16_t viewportWidth, uint16_t viewportHeight, bool hyphenationEnabled);
-  uint32_t onPageComplete(std::unique_ptr<Page> page);
+  void writeSectionFileHeader(BufferedFsWriter& writer, int fontId, float lineCompression, bool extraParagraphSpacing,
+                              uint8_t paragraphAlignment, uint16_t viewportWidth, uint16_t viewportHeight,
+                              bool hyphenationEnabled);
+  uint32_t onPageComplete(BufferedFsWriter& writer, std::unique_ptr<Page> page);
+  // Scales and dithers an image of the chapter into the section file, nullptr when it can't be shown
+  std::shared_ptr<PageImage> layOutImage(BufferedFsWriter& writer, const std::string& src, uint16_t viewportWidth,
+                                         uint16_t viewportHeight);
 
  public:
   uint16_t pageCount = 0;
@@ -31,9 +38,11 @@ class Section {
   bool loadSectionFile(int fontId, float lineCompression, bool extraParagraphSpacing, uint8_t paragraphAlignment,
                        uint16_t viewportWidth, uint16_t viewportHeight, bool hyphenationEnabled);
   bool clearCache() const;
+  // abortFn is asked between buffers of the chapter, returning true stops the layout and drops the section file
   bool createSectionFile(int fontId, float lineCompression, bool extraParagraphSpacing, uint8_t paragraphAlignment,
                          uint16_t viewportWidth, uint16_t viewportHeight, bool hyphenationEnabled,
                          const std::function<void()>& progressSetupFn = nullptr,
-                         const std::function<void(int)>& progressFn = nullptr);
+                         const std::function<void(int)>& progressFn = nullptr,
+                         const std::function<bool()>& abortFn = nullptr);
   std::unique_ptr<Page> loadPageFromSectionFile();
 };
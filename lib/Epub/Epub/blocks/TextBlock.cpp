@@ -3,6 +3,11 @@
 #include <GfxRenderer.h>
 #include <Serialization.h>
 
+namespace {
+// Words come from a single text node, anything longer than this is a corrupt cache file
+constexpr uint32_t MAX_WORD_LENGTH = 4096;
+}  // namespace
+
 void TextBlock::render(const GfxRenderer& renderer, const int fontId, const int x, const int y) const {
   // Validate iterator bounds before rendering
   if (words.size() != wordXpos.size() || words.size() != wordStyles.size()) {
@@ -24,34 +29,37 @@ void TextBlock::render(const GfxRenderer& renderer, const int fontId, const int
   }
 }
 
-bool TextBlock::serialize(FsFile& file) const {
+bool TextBlock::serialize(BufferedFsWriter& writer) const {
   if (words.size() != wordXpos.size() || words.size() != wordStyles.size()) {
     Serial.printf("[%lu] [TXB] Serialization failed: size mismatch (words=%u, xpos=%u, styles=%u)\n", millis(),
                   words.size(), wordXpos.size(), wordStyles.size());
     return false;
   }
 
-  // Word data
-  serialization::writePod(file, static_cast<uint16_t>(words.size()));
-  for (const auto& w : words) serialization::writeString(file, w);
-  for (auto x : wordXpos) serialization::writePod(file, x);
-  for (auto s : wordStyles) serialization::writePod(file, s);
+  // Word data, lengths as varints since nearly every word fits in one byte
+  serialization::writePod(writer, static_cast<uint16_t>(words.size()));
+  for (const auto& w : words) {
+    serialization::writeVarint(writer, w.size());
+    writer.write(reinterpret_cast<const uint8_t*>(w.data()), w.size());
+  }
+  for (auto x : wordXpos) serialization::writePod(writer, x);
+  for (auto s : wordStyles) serialization::writePod(writer, s);
 
   // Block style
-  serialization::writePod(file, style);
+  serialization::writePod(writer, style);
 
   return true;
 }
 
-std::unique_ptr<TextBlock> TextBlock::deserialize(FsFile& file) {
+std::unique_ptr<TextBlock> TextBlock::deserialize(BufferedFsReader& reader) {
   uint16_t wc;
-  std::list<std::string> words;
-  std::list<uint16_t> wordXpos;
-  std::list<EpdFontFamily::Style> wordStyles;
+  ArenaList<ArenaString> words;
+  ArenaList<uint16_t> wordXpos;
+  ArenaList<EpdFontFamily::Style> wordStyles;
   Style style;
 
   // Word count
-  serialization::readPod(file, wc);
+  serialization::readPod(reader, wc);
 
   // Sanity check: prevent allocation of unreasonably large lists (max 10000 words per block)
   if (wc > 10000) {
@@ -63,12 +71,20 @@ std::unique_ptr<TextBlock> TextBlock::deserialize(FsFile& file) {
   words.resize(wc);
   wordXpos.resize(wc);
   wordStyles.resize(wc);
-  for (auto& w : words) serialization::readString(file, w);
-  for (auto& x : wordXpos) serialization::readPod(file, x);
-  for (auto& s : wordStyles) serialization::readPod(file, s);
+  for (auto& w : words) {
+    uint32_t length;
+    if (!serialization::readVarint(reader, length) || length > MAX_WORD_LENGTH) {
+      Serial.printf("[%lu] [TXB] Deserialization failed: bad word length\n", millis());
+      return nullptr;
+    }
+    w.resize(length);
+    reader.read(reinterpret_cast<uint8_t*>(&w[0]), length);
+  }
+  for (auto& x : wordXpos) serialization::readPod(reader, x);
+  for (auto& s : wordStyles) serialization::readPod(reader, s);
 
   // Block style
-  serialization::readPod(file, style);
+  serialization::readPod(reader, style);
 
   return std::unique_ptr<TextBlock>(new TextBlock(std::move(words), std::move(wordXpos), std::move(wordStyles), style));
 }
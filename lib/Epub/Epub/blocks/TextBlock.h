@@ -1,11 +1,10 @@
 #pragma once
+#include <BufferedFs.h>
 #include <EpdFontFamily.h>
-#include <SdFat.h>
 
-#include <list>
 #include <memory>
-#include <string>
 
+#include "../ChapterArena.h"
 #include "Block.h"
 
 // Represents a line of text on a page
@@ -19,14 +18,14 @@ class TextBlock final : public Block {
   };
 
  private:
-  std::list<std::string> words;
-  std::list<uint16_t> wordXpos;
-  std::list<EpdFontFamily::Style> wordStyles;
+  ArenaList<ArenaString> words;
+  ArenaList<uint16_t> wordXpos;
+  ArenaList<EpdFontFamily::Style> wordStyles;
   Style style;
 
  public:
-  explicit TextBlock(std::list<std::string> words, std::list<uint16_t> word_xpos,
-                     std::list<EpdFontFamily::Style> word_styles, const Style style)
+  explicit TextBlock(ArenaList<ArenaString> words, ArenaList<uint16_t> word_xpos,
+                     ArenaList<EpdFontFamily::Style> word_styles, const Style style)
       : words(std::move(words)), wordXpos(std::move(word_xpos)), wordStyles(std::move(word_styles)), style(style) {}
   ~TextBlock() override = default;
   void setStyle(const Style style) { this->style = style; }
@@ -36,6 +35,6 @@ class TextBlock final : public Block {
   // given a renderer works out where to break the words into lines
   void render(const GfxRenderer& renderer, int fontId, int x, int y) const;
   BlockType getType() override { return TEXT_BLOCK; }
-  bool serialize(FsFile& file) const;
-  static std::unique_ptr<TextBlock> deserialize(FsFile& file);
+  bool serialize(BufferedFsWriter& writer) const;
+  static std::unique_ptr<TextBlock> deserialize(BufferedFsReader& reader);
 };
@@ -1,7 +1,8 @@
 #include "ChapterHtmlSlimParser.h"
 
 #include <GfxRenderer.h>
-#include <HardwareSerial.h>
+#include <Logging.h>
+#include <Perf.h>
 #include <SDCardManager.h>
 #include <expat.h>
 
@@ -68,7 +69,7 @@ void ChapterHtmlSlimParser::startNewTextBlock(const TextBlock::Style style) {
 
     makePages();
   }
-  currentTextBlock.reset(new ParsedText(style, extraParagraphSpacing, hyphenationEnabled));
+  currentTextBlock.reset(new ParsedText(style, extraParagraphSpacing, hyphenationEnabled, arena));
 }
 
 void XMLCALL ChapterHtmlSlimParser::startElement(void* userData, const XML_Char* name, const XML_Char** atts) {
@@ -96,22 +97,39 @@ void XMLCALL ChapterHtmlSlimParser::startElement(void* userData, const XML_Char*
   }
 
   if (matches(name, IMAGE_TAGS, NUM_IMAGE_TAGS)) {
-    // TODO: Start processing image tags
     std::string alt = "[Image]";
+    const char* src = nullptr;
     if (atts != nullptr) {
       for (int i = 0; atts[i]; i += 2) {
         if (strcmp(atts[i], "alt") == 0) {
           if (strlen(atts[i + 1]) > 0) {
             alt = "[Image: " + std::string(atts[i + 1]) + "]";
           }
-          break;
+        } else if (strcmp(atts[i], "src") == 0) {
+          src = atts[i + 1];
         }
       }
     }
 
-    Serial.printf("[%lu] [EHP] Image alt: %s\n", millis(), alt.c_str());
+    LOG_D(EHP, "Image alt: %s", alt.c_str());
 
+    // Words before the image belong above it
+    if (self->partWordBufferIndex > 0) {
+      self->flushPartWordBuffer();
+    }
     self->startNewTextBlock(TextBlock::CENTER_ALIGN);
+
+    if (src && self->imageFn) {
+      auto image = self->imageFn(src);
+      if (image) {
+        self->addImageToPage(std::move(image));
+        self->skipUntilDepth = self->depth;
+        self->depth += 1;
+        return;
+      }
+    }
+
+    // Not shown, the alt text stands in for it
     self->italicUntilDepth = min(self->italicUntilDepth, self->depth);
     // Advance depth before processing character data (like you would for a element with text)
     self->depth += 1;
@@ -229,11 +247,19 @@ void XMLCALL ChapterHtmlSlimParser::characterData(void* userData, const XML_Char
   // memory.
   // Spotted when reading Intermezzo, there are some really long text blocks in there.
   if (self->currentTextBlock->size() > 750) {
-    Serial.printf("[%lu] [EHP] Text block too long, splitting into multiple pages\n", millis());
+    LOG_D(EHP, "Text block too long, splitting into multiple pages");
     self->currentTextBlock->layoutAndExtractLines(
         self->renderer, self->fontId, self->viewportWidth,
         [self](const std::shared_ptr<TextBlock>& textBlock) { self->addLineToPage(textBlock); }, false);
   }
+
+  if (self->arena) {
+    if (!self->arena->isNearCap()) {
+      self->arenaFlushed = false;
+    } else if (!self->arenaFlushed) {
+      self->flushForArena();
+    }
+  }
 }
 
 void XMLCALL ChapterHtmlSlimParser::endElement(void* userData, const XML_Char* name) {
@@ -279,7 +305,7 @@ bool ChapterHtmlSlimParser::parseAndBuildPages() {
   int done;
 
   if (!parser) {
-    Serial.printf("[%lu] [EHP] Couldn't allocate memory for parser\n", millis());
+    LOG_E(EHP, "Couldn't allocate memory for parser");
     return false;
   }
 
@@ -299,9 +325,19 @@ bool ChapterHtmlSlimParser::parseAndBuildPages() {
   XML_SetCharacterDataHandler(parser, characterData);
 
   do {
+    if (abortFn && abortFn()) {
+      LOG_I(EHP, "Stopped after %zu of %zu bytes", bytesRead, totalSize);
+      XML_StopParser(parser, XML_FALSE);                // Stop any pending processing
+      XML_SetElementHandler(parser, nullptr, nullptr);  // Clear callbacks
+      XML_SetCharacterDataHandler(parser, nullptr);
+      XML_ParserFree(parser);
+      file.close();
+      return false;
+    }
+
     void* const buf = XML_GetBuffer(parser, 1024);
     if (!buf) {
-      Serial.printf("[%lu] [EHP] Couldn't allocate memory for buffer\n", millis());
+      LOG_E(EHP, "Couldn't allocate memory for buffer");
       XML_StopParser(parser, XML_FALSE);                // Stop any pending processing
       XML_SetElementHandler(parser, nullptr, nullptr);  // Clear callbacks
       XML_SetCharacterDataHandler(parser, nullptr);
@@ -310,10 +346,15 @@ bool ChapterHtmlSlimParser::parseAndBuildPages() {
       return false;
     }
 
-    const size_t len = file.read(buf, 1024);
+    size_t len;
+    {
+      PERF_SCOPE(SD_READ);
+      len = file.read(buf, 1024);
+    }
+    PERF_COUNT(SD_BYTES_READ, len);
 
     if (len == 0 && file.available() > 0) {
-      Serial.printf("[%lu] [EHP] File read error\n", millis());
+      LOG_E(EHP, "File read error");
       XML_StopParser(parser, XML_FALSE);                // Stop any pending processing
       XML_SetElementHandler(parser, nullptr, nullptr);  // Clear callbacks
       XML_SetCharacterDataHandler(parser, nullptr);
@@ -335,9 +376,14 @@ bool ChapterHtmlSlimParser::parseAndBuildPages() {
 
     done = file.available() == 0;
 
-    if (XML_ParseBuffer(parser, static_cast<int>(len), done) == XML_STATUS_ERROR) {
-      Serial.printf("[%lu] [EHP] Parse error at line %lu:\n%s\n", millis(), XML_GetCurrentLineNumber(parser),
-                    XML_ErrorString(XML_GetErrorCode(parser)));
+    XML_Status status;
+    {
+      PERF_SCOPE(XML_PARSE);
+      status = XML_ParseBuffer(parser, static_cast<int>(len), done);
+    }
+    if (status == XML_STATUS_ERROR) {
+      LOG_E(EHP, "Parse error at line %lu:\n%s", XML_GetCurrentLineNumber(parser),
+            XML_ErrorString(XML_GetErrorCode(parser)));
       XML_StopParser(parser, XML_FALSE);                // Stop any pending processing
       XML_SetElementHandler(parser, nullptr, nullptr);  // Clear callbacks
       XML_SetCharacterDataHandler(parser, nullptr);
@@ -373,13 +419,30 @@ void ChapterHtmlSlimParser::addLineToPage(std::shared_ptr<TextBlock> line) {
     currentPageNextY = 0;
   }
 
-  currentPage->elements.push_back(std::make_shared<PageLine>(line, 0, currentPageNextY));
+  currentPage->elements.push_back(
+      std::allocate_shared<PageLine>(ArenaAllocator<PageLine>(arena), line, 0, currentPageNextY));
   currentPageNextY += lineHeight;
 }
 
+void ChapterHtmlSlimParser::addImageToPage(std::shared_ptr<PageImage> image) {
+  if (!currentPage) {
+    currentPage.reset(new Page());
+    currentPageNextY = 0;
+  }
+  if (currentPageNextY + image->getHeight() > viewportHeight && !currentPage->elements.empty()) {
+    completePageFn(std::move(currentPage));
+    currentPage.reset(new Page());
+    currentPageNextY = 0;
+  }
+
+  image->yPos = currentPageNextY;
+  currentPageNextY += image->getHeight() + renderer.getLineHeight(fontId) * lineCompression / 2;
+  currentPage->elements.push_back(std::move(image));
+}
+
 void ChapterHtmlSlimParser::makePages() {
   if (!currentTextBlock) {
-    Serial.printf("[%lu] [EHP] !! No text block to make pages for !!\n", millis());
+    LOG_E(EHP, "!! No text block to make pages for !!");
     return;
   }
 
@@ -397,3 +460,23 @@ void ChapterHtmlSlimParser::makePages() {
     currentPageNextY += lineHeight / 2;
   }
 }
+
+// The arena is about to run out: move buffered words onto pages and end the current page, even if it isn't full,
+// so their chunks can be reused. Only pathological paragraphs get here, a short page beats running out of heap.
+void ChapterHtmlSlimParser::flushForArena() {
+  LOG_W(EHP, "Chapter arena near its cap, flushing pages early");
+  arenaFlushed = true;
+  if (!currentPage) {
+    currentPage.reset(new Page());
+    currentPageNextY = 0;
+  }
+  currentTextBlock->layoutAndExtractLines(
+      renderer, fontId, viewportWidth,
+      [this](const std::shared_ptr<TextBlock>& textBlock) { addLineToPage(textBlock); }, false);
+
+  if (currentPage && !currentPage->elements.empty()) {
+    completePageFn(std::move(currentPage));
+    currentPage.reset(new Page());
+    currentPageNextY = 0;
+  }
+}
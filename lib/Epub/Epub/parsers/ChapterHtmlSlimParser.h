@@ -6,10 +6,12 @@
 #include <functional>
 #include <memory>
 
+#include "../ChapterArena.h"
 #include "../ParsedText.h"
 #include "../blocks/TextBlock.h"
 
 class Page;
+class PageImage;
 class GfxRenderer;
 
 #define MAX_WORD_SIZE 200
@@ -19,6 +21,10 @@ class ChapterHtmlSlimParser {
   GfxRenderer& renderer;
   std::function<void(std::unique_ptr<Page>)> completePageFn;
   std::function<void(int)> progressFn;  // Progress callback (0-100)
+  // Lays out the image at src (as written in the chapter), nullptr when it can't be shown
+  std::function<std::shared_ptr<PageImage>(const std::string& src)> imageFn;
+  // Asked before every buffer of the chapter, parsing stops and fails when it returns true
+  std::function<bool()> abortFn;
   int depth = 0;
   int skipUntilDepth = INT_MAX;
   int boldUntilDepth = INT_MAX;
@@ -37,10 +43,14 @@ class ChapterHtmlSlimParser {
   uint16_t viewportWidth;
   uint16_t viewportHeight;
   bool hyphenationEnabled;
+  ChapterArena* arena;
+  bool arenaFlushed = false;
 
   void startNewTextBlock(TextBlock::Style style);
   void flushPartWordBuffer();
   void makePages();
+  void flushForArena();
+  void addImageToPage(std::shared_ptr<PageImage> image);
   // XML callbacks
   static void XMLCALL startElement(void* userData, const XML_Char* name, const XML_Char** atts);
   static void XMLCALL characterData(void* userData, const XML_Char* s, int len);
@@ -52,9 +62,15 @@ class ChapterHtmlSlimParser {
                                  const uint8_t paragraphAlignment, const uint16_t viewportWidth,
                                  const uint16_t viewportHeight, const bool hyphenationEnabled,
                                  const std::function<void(std::unique_ptr<Page>)>& completePageFn,
-                                 const std::function<void(int)>& progressFn = nullptr)
+                                 const std::function<void(int)>& progressFn = nullptr, ChapterArena* arena = nullptr,
+                                 const std::function<std::shared_ptr<PageImage>(const std::string&)>& imageFn = nullptr,
+                                 const std::function<bool()>& abortFn = nullptr)
       : filepath(filepath),
         renderer(renderer),
+        completePageFn(completePageFn),
+        progressFn(progressFn),
+        imageFn(imageFn),
+        abortFn(abortFn),
         fontId(fontId),
         lineCompression(lineCompression),
         extraParagraphSpacing(extraParagraphSpacing),
@@ -62,8 +78,7 @@ class ChapterHtmlSlimParser {
         viewportWidth(viewportWidth),
         viewportHeight(viewportHeight),
         hyphenationEnabled(hyphenationEnabled),
-        completePageFn(completePageFn),
-        progressFn(progressFn) {}
+        arena(arena) {}
   ~ChapterHtmlSlimParser() = default;
   bool parseAndBuildPages();
   void addLineToPage(std::shared_ptr<TextBlock> line);
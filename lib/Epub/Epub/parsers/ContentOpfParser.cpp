@@ -32,6 +32,8 @@ ContentOpfParser::~ContentOpfParser() {
     XML_ParserFree(parser);
     parser = nullptr;
   }
+  itemWriter.reset();
+  itemReader.reset();
   if (tempItemStore) {
     tempItemStore.close();
   }
@@ -121,7 +123,9 @@ void XMLCALL ContentOpfParser::startElement(void* userData, const XML_Char* name
       Serial.printf(
           "[%lu] [COF] Couldn't open temp items file for writing. This is probably going to be a fatal error.\n",
           millis());
+      return;
     }
+    self->itemWriter.reset(new BufferedFsWriter(self->tempItemStore));
     return;
   }
 
@@ -131,6 +135,8 @@ void XMLCALL ContentOpfParser::startElement(void* userData, const XML_Char* name
       Serial.printf(
           "[%lu] [COF] Couldn't open temp items file for reading. This is probably going to be a fatal error.\n",
           millis());
+    } else {
+      self->itemReader.reset(new BufferedFsReader(self->tempItemStore));
     }
 
     // Sort item index for binary search if we have enough items
@@ -193,17 +199,17 @@ void XMLCALL ContentOpfParser::startElement(void* userData, const XML_Char* name
     }
 
     // Record index entry for fast lookup later
-    if (self->tempItemStore) {
+    if (self->itemWriter) {
       ItemIndexEntry entry;
       entry.idHash = fnvHash(itemId);
       entry.idLen = static_cast<uint16_t>(itemId.size());
-      entry.fileOffset = static_cast<uint32_t>(self->tempItemStore.position());
+      entry.fileOffset = self->itemWriter->position();
       self->itemIndex.push_back(entry);
-    }
 
-    // Write items down to SD card
-    serialization::writeString(self->tempItemStore, itemId);
-    serialization::writeString(self->tempItemStore, href);
+      // Write items down to SD card
+      serialization::writeString(*self->itemWriter, itemId);
+      serialization::writeString(*self->itemWriter, href);
+    }
 
     if (itemId == self->coverItemId) {
       self->coverItemHref = href;
@@ -231,7 +237,7 @@ void XMLCALL ContentOpfParser::startElement(void* userData, const XML_Char* name
 
   // NOTE: This relies on spine appearing after item manifest (which is pretty safe as it's part of the EPUB spec)
   // Only run the spine parsing if there's a cache to add it to
-  if (self->cache) {
+  if (self->cache && self->itemReader) {
     if (self->state == IN_SPINE && (strcmp(name, "itemref") == 0 || strcmp(name, "opf:itemref") == 0)) {
       for (int i = 0; atts[i]; i += 2) {
         if (strcmp(atts[i], "idref") == 0) {
@@ -252,11 +258,11 @@ void XMLCALL ContentOpfParser::startElement(void* userData, const XML_Char* name
 
             // Check for match (may need to check a few due to hash collisions)
             while (it != self->itemIndex.end() && it->idHash == targetHash) {
-              self->tempItemStore.seek(it->fileOffset);
+              self->itemReader->seek(it->fileOffset);
               std::string itemId;
-              serialization::readString(self->tempItemStore, itemId);
+              serialization::readString(*self->itemReader, itemId);
               if (itemId == idref) {
-                serialization::readString(self->tempItemStore, href);
+                serialization::readString(*self->itemReader, href);
                 found = true;
                 break;
               }
@@ -266,11 +272,12 @@ void XMLCALL ContentOpfParser::startElement(void* userData, const XML_Char* name
             // Slow path: linear scan (for small manifests, keeps original behavior)
             // TODO: This lookup is slow as need to scan through all items each time.
             //       It can take up to 200ms per item when getting to 1500 items.
-            self->tempItemStore.seek(0);
+            self->itemReader->seek(0);
+            const uint32_t itemStoreSize = self->tempItemStore.size();
             std::string itemId;
-            while (self->tempItemStore.available()) {
-              serialization::readString(self->tempItemStore, itemId);
-              serialization::readString(self->tempItemStore, href);
+            while (self->itemReader->position() < itemStoreSize) {
+              serialization::readString(*self->itemReader, itemId);
+              serialization::readString(*self->itemReader, href);
               if (itemId == idref) {
                 found = true;
                 break;
@@ -336,6 +343,7 @@ void XMLCALL ContentOpfParser::endElement(void* userData, const XML_Char* name)
 
   if (self->state == IN_SPINE && (strcmp(name, "spine") == 0 || strcmp(name, "opf:spine") == 0)) {
     self->state = IN_PACKAGE;
+    self->itemReader.reset();
     self->tempItemStore.close();
     return;
   }
@@ -348,6 +356,7 @@ void XMLCALL ContentOpfParser::endElement(void* userData, const XML_Char* name)
 
   if (self->state == IN_MANIFEST && (strcmp(name, "manifest") == 0 || strcmp(name, "opf:manifest") == 0)) {
     self->state = IN_PACKAGE;
+    self->itemWriter.reset();
     self->tempItemStore.close();
     return;
   }
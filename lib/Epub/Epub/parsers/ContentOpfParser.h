@@ -1,7 +1,9 @@
 #pragma once
+#include <BufferedFs.h>
 #include <Print.h>
 
 #include <algorithm>
+#include <memory>
 #include <vector>
 
 #include "Epub.h"
@@ -29,6 +31,8 @@ class ContentOpfParser final : public Print {
   ParserState state = START;
   BookMetadataCache* cache;
   FsFile tempItemStore;
+  std::unique_ptr<BufferedFsWriter> itemWriter;  // While in the manifest
+  std::unique_ptr<BufferedFsReader> itemReader;  // While in the spine
   std::string coverItemId;
 
   // Index for fast idref→href lookup (used only for large EPUBs)
@@ -13,7 +13,7 @@ std::string FsHelpers::normalisePath(const std::string& path) {
           if (!components.empty()) {
             components.pop_back();
           }
-        } else {
+        } else if (component != ".") {
           components.push_back(component);
         }
         component.clear();
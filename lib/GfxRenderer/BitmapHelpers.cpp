@@ -1,5 +1,6 @@
 #include "BitmapHelpers.h"
 
+#include <array>
 #include <cstdint>
 
 // Brightness/Contrast adjustments:
@@ -11,7 +12,7 @@ constexpr bool USE_NOISE_DITHERING = false;  // Hash-based noise dithering
 
 // Integer approximation of gamma correction (brightens midtones)
 // Uses a simple curve: out = 255 * sqrt(in/255) ≈ sqrt(in * 255)
-static inline int applyGamma(int gray) {
+static constexpr int applyGamma(int gray) {
   if (!GAMMA_CORRECTION) return gray;
   // Fast integer square root approximation for gamma ~0.5 (brightening)
   // This brightens dark/mid tones while preserving highlights
@@ -27,7 +28,7 @@ static inline int applyGamma(int gray) {
 
 // Apply contrast adjustment around midpoint (128)
 // factor > 1.0 increases contrast, < 1.0 decreases
-static inline int applyContrast(int gray) {
+static constexpr int applyContrast(int gray) {
   // Integer-based contrast: (gray - 128) * factor + 128
   // Using fixed-point: factor 1.15 ≈ 115/100
   constexpr int factorNum = static_cast<int>(CONTRAST_FACTOR * 100);
@@ -37,7 +38,7 @@ static inline int applyContrast(int gray) {
   return adjusted;
 }
 // Combined brightness/contrast/gamma adjustment
-int adjustPixel(int gray) {
+static constexpr int adjustGray(int gray) {
   if (!USE_BRIGHTNESS) return gray;
 
   // Order: contrast first, then brightness, then gamma
@@ -49,6 +50,47 @@ int adjustPixel(int gray) {
 
   return gray;
 }
+
+constexpr std::array<uint8_t, 256> ADJUSTED_GRAY = [] {
+  std::array<uint8_t, 256> table = {};
+  for (int gray = 0; gray < 256; gray++) {
+    table[gray] = static_cast<uint8_t>(adjustGray(gray));
+  }
+  return table;
+}();
+
+// 2-bit levels and the gray each one shows as, fine-tuned to the X4 eink display (the original thresholds were 43,
+// 128 and 213 for 0, 85, 170 and 255)
+static constexpr DitherStep quantizeDithered(const int gray) {
+  if (gray < 30) {
+    return {static_cast<int8_t>(gray - 15), 0};
+  } else if (gray < 50) {
+    return {static_cast<int8_t>(gray - 30), 1};
+  } else if (gray < 140) {
+    return {static_cast<int8_t>(gray - 80), 2};
+  } else {
+    return {static_cast<int8_t>(gray - 210), 3};
+  }
+}
+
+static constexpr int clampGray(const int gray) { return gray < 0 ? 0 : gray > 255 ? 255 : gray; }
+
+// Atkinson only passes on 1/8 of the error to each neighbor
+template <typename Quantize>
+static constexpr std::array<DitherStep, DITHER_STEP_COUNT> atkinsonSteps(const Quantize quantizeGray) {
+  std::array<DitherStep, DITHER_STEP_COUNT> table = {};
+  for (int i = 0; i < DITHER_STEP_COUNT; i++) {
+    const DitherStep step = quantizeGray(clampGray(i - DITHER_STEP_OFFSET));
+    table[i] = {static_cast<int8_t>(step.error >> 3), step.level};
+  }
+  return table;
+}
+
+constexpr std::array<DitherStep, DITHER_STEP_COUNT> ATKINSON_STEPS = atkinsonSteps(quantizeDithered);
+constexpr std::array<DitherStep, DITHER_STEP_COUNT> ATKINSON_1BIT_STEPS = atkinsonSteps([](const int gray) {
+  return gray < 128 ? DitherStep{static_cast<int8_t>(gray), 0} : DitherStep{static_cast<int8_t>(gray - 255), 1};
+});
+
 // Simple quantization without dithering - divide into 4 levels
 // The thresholds are fine-tuned to the X4 display
 uint8_t quantizeSimple(int gray) {
@@ -104,3 +146,10 @@ uint8_t quantize1bit(int gray, int x, int y) {
   const int adjustedThreshold = 128 + ((threshold - 128) / 2);  // Range: 64-192
   return (gray >= adjustedThreshold) ? 1 : 0;
 }
+
+// Standard 8x8 Bayer matrix (each of 0-63 once) as 4 * value + 2
+constexpr uint8_t BAYER_THRESHOLDS[8][8] = {
+    {2, 130, 34, 162, 10, 138, 42, 170},  {194, 66, 226, 98, 202, 74, 234, 106}, {50, 178, 18, 146, 58, 186, 26, 154},
+    {242, 114, 210, 82, 250, 122, 218, 90}, {14, 142, 46, 174, 6, 134, 38, 166}, {206, 78, 238, 110, 198, 70, 230, 102},
+    {62, 190, 30, 158, 54, 182, 22, 150}, {254, 126, 222, 94, 246, 118, 214, 86},
+};
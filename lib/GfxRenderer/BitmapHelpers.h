@@ -1,91 +1,136 @@
 #pragma once
 
+#include <array>
+#include <cstdint>
 #include <cstring>
 
+// One entry of a quantization table: the output level for an input gray and the error it leaves behind
+struct DitherStep {
+  int8_t error;
+  uint8_t level;
+};
+
+// The Atkinson tables are indexed by the gray plus the error it has picked up, which stays within +-128 (six shares
+// of at most 16), so the clamp to 0..255 is part of the table
+constexpr int DITHER_STEP_OFFSET = 128;
+constexpr int DITHER_STEP_COUNT = 512;
+extern const std::array<DitherStep, DITHER_STEP_COUNT> ATKINSON_STEPS;       // 2-bit, error already divided by 8
+extern const std::array<DitherStep, DITHER_STEP_COUNT> ATKINSON_1BIT_STEPS;  // 1-bit, error already divided by 8
+extern const std::array<uint8_t, 256> ADJUSTED_GRAY;                         // adjustPixel() for every gray
+extern const uint8_t BAYER_THRESHOLDS[8][8];                                 // 8x8 Bayer matrix scaled to 2-254
+
 // Helper functions
 uint8_t quantize(int gray, int x, int y);
 uint8_t quantizeSimple(int gray);
 uint8_t quantize1bit(int gray, int x, int y);
-int adjustPixel(int gray);
-
-// 1-bit Atkinson dithering - better quality than noise dithering for thumbnails
-// Error distribution pattern (same as 2-bit but quantizes to 2 levels):
-//     X  1/8 1/8
-// 1/8 1/8 1/8
-//     1/8
-class Atkinson1BitDitherer {
+inline int adjustPixel(const int gray) { return ADJUSTED_GRAY[gray]; }
+
+// Ordered (8x8 Bayer) dithering, a fixed threshold per pixel with no error to carry. Coarser than Atkinson but much
+// cheaper, meant for small thumbnails. Between the four evenly spaced levels like quantizeNoise(): gray * 3 is level
+// * 255 plus a remainder, which rounds up when it reaches the threshold.
+inline uint8_t quantizeOrdered(const int gray, const int x, const int y) {
+  return static_cast<uint8_t>((gray * 3 + 255 - BAYER_THRESHOLDS[y & 7][x & 7]) / 255);
+}
+
+// 1-bit ordered dithering, adjusts the gray itself like quantize1bit()
+inline uint8_t quantize1bitOrdered(const int gray, const int x, const int y) {
+  return adjustPixel(gray) >= BAYER_THRESHOLDS[y & 7][x & 7] ? 1 : 0;
+}
+
+// Error rows shared by the Atkinson ditherers. The error of a pixel goes to the next two pixels of its row, which the
+// ditherer carries itself, and to three pixels of the next row and one of the row after. The current row's errors
+// are only stored (as the row after next, which gets exactly those) and nextRow() adds their three-wide sums to the
+// next row four pixels per 32-bit word. The shares are at most 16 and a pixel takes at most six, so the errors fit
+// in int8_t lanes.
+class AtkinsonErrorRows {
  public:
-  explicit Atkinson1BitDitherer(int width) : width(width) {
-    errorRow0 = new int16_t[width + 4]();  // Current row
-    errorRow1 = new int16_t[width + 4]();  // Next row
-    errorRow2 = new int16_t[width + 4]();  // Row after next
+  explicit AtkinsonErrorRows(int width) : words((width + 4 + 3) / 4) {
+    rows[0] = new uint32_t[words]();  // Current row
+    rows[1] = new uint32_t[words]();  // Next row
+    rows[2] = new uint32_t[words]();  // Row after next, the current row's errors
   }
 
-  ~Atkinson1BitDitherer() {
-    delete[] errorRow0;
-    delete[] errorRow1;
-    delete[] errorRow2;
+  ~AtkinsonErrorRows() {
+    delete[] rows[0];
+    delete[] rows[1];
+    delete[] rows[2];
   }
 
-  // EXPLICITLY DELETE THE COPY CONSTRUCTOR
-  Atkinson1BitDitherer(const Atkinson1BitDitherer& other) = delete;
-
-  // EXPLICITLY DELETE THE COPY ASSIGNMENT OPERATOR
-  Atkinson1BitDitherer& operator=(const Atkinson1BitDitherer& other) = delete;
+  AtkinsonErrorRows(const AtkinsonErrorRows& other) = delete;
+  AtkinsonErrorRows& operator=(const AtkinsonErrorRows& other) = delete;
+
+  // Pixels go in left to right from x = 0, the gray must be within 0..255
+  uint8_t processPixel(const std::array<DitherStep, DITHER_STEP_COUNT>& steps, const int gray, const int x) {
+    const int8_t* current = reinterpret_cast<const int8_t*>(rows[0]);
+    const DitherStep step = steps[gray + current[x + 2] + errorLeft1 + errorLeft2 + DITHER_STEP_OFFSET];
+    reinterpret_cast<int8_t*>(rows[2])[x + 2] = step.error;
+    errorLeft2 = errorLeft1;
+    errorLeft1 = step.error;
+    return step.level;
+  }
 
-  uint8_t processPixel(int gray, int x) {
-    // Apply brightness/contrast/gamma adjustments
-    gray = adjustPixel(gray);
+  void nextRow() {
+    const uint32_t* errors = rows[2];
+    uint32_t* next = rows[1];
+    uint32_t previous = 0;
+    uint32_t word = errors[0];
+    for (int i = 0; i < words; i++) {
+      const uint32_t following = i + 1 < words ? errors[i + 1] : 0;
+      const uint32_t left = word << 8 | previous >> 24;  // Each lane gets the error of the pixel to its left
+      const uint32_t right = word >> 8 | following << 24;
+      next[i] = addLanes(next[i], addLanes(addLanes(left, word), right));
+      previous = word;
+      word = following;
+    }
 
-    // Add accumulated error
-    int adjusted = gray + errorRow0[x + 2];
-    if (adjusted < 0) adjusted = 0;
-    if (adjusted > 255) adjusted = 255;
+    uint32_t* temp = rows[0];
+    rows[0] = rows[1];
+    rows[1] = rows[2];
+    rows[2] = temp;
+    memset(rows[2], 0, words * sizeof(uint32_t));
+    errorLeft1 = 0;
+    errorLeft2 = 0;
+  }
 
-    // Quantize to 2 levels (1-bit): 0 = black, 1 = white
-    uint8_t quantized;
-    int quantizedValue;
-    if (adjusted < 128) {
-      quantized = 0;
-      quantizedValue = 0;
-    } else {
-      quantized = 1;
-      quantizedValue = 255;
+  void reset() {
+    for (uint32_t* row : rows) {
+      memset(row, 0, words * sizeof(uint32_t));
     }
+    errorLeft1 = 0;
+    errorLeft2 = 0;
+  }
 
-    // Calculate error (only distribute 6/8 = 75%)
-    int error = (adjusted - quantizedValue) >> 3;  // error/8
+ private:
+  // Adds four int8_t lanes at once, wrapping in each lane instead of carrying into the next
+  static uint32_t addLanes(const uint32_t a, const uint32_t b) {
+    return ((a & 0x7F7F7F7Fu) + (b & 0x7F7F7F7Fu)) ^ ((a ^ b) & 0x80808080u);
+  }
 
-    // Distribute 1/8 to each of 6 neighbors
-    errorRow0[x + 3] += error;  // Right
-    errorRow0[x + 4] += error;  // Right+1
-    errorRow1[x + 1] += error;  // Bottom-left
-    errorRow1[x + 2] += error;  // Bottom
-    errorRow1[x + 3] += error;  // Bottom-right
-    errorRow2[x + 2] += error;  // Two rows down
+  int words;
+  // int8_t errors with a two pixel margin on the left, kept as words so nextRow() can work on four at a time
+  uint32_t* rows[3];
+  int errorLeft1 = 0;  // Errors of the previous two pixels of this row
+  int errorLeft2 = 0;
+};
 
-    return quantized;
-  }
+// 1-bit Atkinson dithering - better quality than noise dithering for thumbnails
+// Error distribution pattern (same as 2-bit but quantizes to 2 levels):
+//     X  1/8 1/8
+// 1/8 1/8 1/8
+//     1/8
+class Atkinson1BitDitherer {
+ public:
+  explicit Atkinson1BitDitherer(int width) : errors(width) {}
 
-  void nextRow() {
-    int16_t* temp = errorRow0;
-    errorRow0 = errorRow1;
-    errorRow1 = errorRow2;
-    errorRow2 = temp;
-    memset(errorRow2, 0, (width + 4) * sizeof(int16_t));
-  }
+  // Pixels go in left to right from x = 0, brightness/contrast/gamma adjustments are applied here
+  uint8_t processPixel(int gray, int x) { return errors.processPixel(ATKINSON_1BIT_STEPS, adjustPixel(gray), x); }
 
-  void reset() {
-    memset(errorRow0, 0, (width + 4) * sizeof(int16_t));
-    memset(errorRow1, 0, (width + 4) * sizeof(int16_t));
-    memset(errorRow2, 0, (width + 4) * sizeof(int16_t));
-  }
+  void nextRow() { errors.nextRow(); }
+
+  void reset() { errors.reset(); }
 
  private:
-  int width;
-  int16_t* errorRow0;
-  int16_t* errorRow1;
-  int16_t* errorRow2;
+  AtkinsonErrorRows errors;
 };
 
 // Atkinson dithering - distributes only 6/8 (75%) of error for cleaner results
@@ -96,95 +141,17 @@ class Atkinson1BitDitherer {
 // Less error buildup = fewer artifacts than Floyd-Steinberg
 class AtkinsonDitherer {
  public:
-  explicit AtkinsonDitherer(int width) : width(width) {
-    errorRow0 = new int16_t[width + 4]();  // Current row
-    errorRow1 = new int16_t[width + 4]();  // Next row
-    errorRow2 = new int16_t[width + 4]();  // Row after next
-  }
-
-  ~AtkinsonDitherer() {
-    delete[] errorRow0;
-    delete[] errorRow1;
-    delete[] errorRow2;
-  }
-  // **1. EXPLICITLY DELETE THE COPY CONSTRUCTOR**
-  AtkinsonDitherer(const AtkinsonDitherer& other) = delete;
-
-  // **2. EXPLICITLY DELETE THE COPY ASSIGNMENT OPERATOR**
-  AtkinsonDitherer& operator=(const AtkinsonDitherer& other) = delete;
-
-  uint8_t processPixel(int gray, int x) {
-    // Add accumulated error
-    int adjusted = gray + errorRow0[x + 2];
-    if (adjusted < 0) adjusted = 0;
-    if (adjusted > 255) adjusted = 255;
-
-    // Quantize to 4 levels
-    uint8_t quantized;
-    int quantizedValue;
-    if (false) {  // original thresholds
-      if (adjusted < 43) {
-        quantized = 0;
-        quantizedValue = 0;
-      } else if (adjusted < 128) {
-        quantized = 1;
-        quantizedValue = 85;
-      } else if (adjusted < 213) {
-        quantized = 2;
-        quantizedValue = 170;
-      } else {
-        quantized = 3;
-        quantizedValue = 255;
-      }
-    } else {  // fine-tuned to X4 eink display
-      if (adjusted < 30) {
-        quantized = 0;
-        quantizedValue = 15;
-      } else if (adjusted < 50) {
-        quantized = 1;
-        quantizedValue = 30;
-      } else if (adjusted < 140) {
-        quantized = 2;
-        quantizedValue = 80;
-      } else {
-        quantized = 3;
-        quantizedValue = 210;
-      }
-    }
+  explicit AtkinsonDitherer(int width) : errors(width) {}
 
-    // Calculate error (only distribute 6/8 = 75%)
-    int error = (adjusted - quantizedValue) >> 3;  // error/8
+  // Pixels go in left to right from x = 0
+  uint8_t processPixel(int gray, int x) { return errors.processPixel(ATKINSON_STEPS, gray, x); }
 
-    // Distribute 1/8 to each of 6 neighbors
-    errorRow0[x + 3] += error;  // Right
-    errorRow0[x + 4] += error;  // Right+1
-    errorRow1[x + 1] += error;  // Bottom-left
-    errorRow1[x + 2] += error;  // Bottom
-    errorRow1[x + 3] += error;  // Bottom-right
-    errorRow2[x + 2] += error;  // Two rows down
+  void nextRow() { errors.nextRow(); }
 
-    return quantized;
-  }
-
-  void nextRow() {
-    int16_t* temp = errorRow0;
-    errorRow0 = errorRow1;
-    errorRow1 = errorRow2;
-    errorRow2 = temp;
-    memset(errorRow2, 0, (width + 4) * sizeof(int16_t));
-  }
-
-  void reset() {
-    memset(errorRow0, 0, (width + 4) * sizeof(int16_t));
-    memset(errorRow1, 0, (width + 4) * sizeof(int16_t));
-    memset(errorRow2, 0, (width + 4) * sizeof(int16_t));
-  }
+  void reset() { errors.reset(); }
 
  private:
-  int width;
-  int16_t* errorRow0;
-  int16_t* errorRow1;
-  int16_t* errorRow2;
+  AtkinsonErrorRows errors;
 };
 
 // Floyd-Steinberg error diffusion dithering with serpentine scanning
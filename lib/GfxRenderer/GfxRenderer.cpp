@@ -1,8 +1,35 @@
 #include "GfxRenderer.h"
 
+#include <BufferPool.h>
+#include <Logging.h>
 #include <Utf8.h>
 
-void GfxRenderer::insertFont(const int fontId, EpdFontFamily font) { fontMap.insert({fontId, font}); }
+void GfxRenderer::insertFont(const int fontId, EpdFontFamily font) {
+  const auto [slot, added] = fontMap.try_emplace(fontId, nullptr, font);
+  if (added) {
+    slot->second.family = &slot->second.inserted;
+  }
+}
+
+void GfxRenderer::registerFont(const int fontId, const EpdFontFamily& (*loader)()) {
+  fontMap.try_emplace(fontId, loader, EpdFontFamily(nullptr));
+}
+
+const EpdFontFamily* GfxRenderer::getFont(const int fontId) const {
+  const auto slot = fontMap.find(fontId);
+  if (slot == fontMap.end()) {
+    LOG_RATE_LIMITED(LOG_LEVEL_ERROR, GFX, 1000, "Font %d not found", fontId);
+    return nullptr;
+  }
+
+  const EpdFontFamily* family = slot->second.family.load(std::memory_order_acquire);
+  if (!family) {
+    family = &slot->second.loader();
+    slot->second.family.store(family, std::memory_order_release);
+    LOG_D(GFX, "Font %d loaded", fontId);
+  }
+  return family;
+}
 
 void GfxRenderer::rotateCoordinates(const int x, const int y, int* rotatedX, int* rotatedY) const {
   switch (orientation) {
@@ -40,7 +67,7 @@ void GfxRenderer::drawPixel(const int x, const int y, const bool state) const {
 
   // Early return if no framebuffer is set
   if (!frameBuffer) {
-    Serial.printf("[%lu] [GFX] !! No framebuffer\n", millis());
+    LOG_E(GFX, "!! No framebuffer");
     return;
   }
 
@@ -50,7 +77,7 @@ void GfxRenderer::drawPixel(const int x, const int y, const bool state) const {
 
   // Bounds checking against physical panel dimensions
   if (rotatedX < 0 || rotatedX >= HalDisplay::DISPLAY_WIDTH || rotatedY < 0 || rotatedY >= HalDisplay::DISPLAY_HEIGHT) {
-    Serial.printf("[%lu] [GFX] !! Outside range (%d, %d) -> (%d, %d)\n", millis(), x, y, rotatedX, rotatedY);
+    LOG_RATE_LIMITED(LOG_LEVEL_DEBUG, GFX, 1000, "!! Outside range (%d, %d) -> (%d, %d)", x, y, rotatedX, rotatedY);
     return;
   }
 
@@ -66,13 +93,13 @@ void GfxRenderer::drawPixel(const int x, const int y, const bool state) const {
 }
 
 int GfxRenderer::getTextWidth(const int fontId, const char* text, const EpdFontFamily::Style style) const {
-  if (fontMap.count(fontId) == 0) {
-    Serial.printf("[%lu] [GFX] Font %d not found\n", millis(), fontId);
+  const EpdFontFamily* font = getFont(fontId);
+  if (!font) {
     return 0;
   }
 
   int w = 0, h = 0;
-  fontMap.at(fontId).getTextDimensions(text, &w, &h, style);
+  font->getTextDimensions(text, &w, &h, style);
   return w;
 }
 
@@ -92,20 +119,19 @@ void GfxRenderer::drawText(const int fontId, const int x, const int y, const cha
     return;
   }
 
-  if (fontMap.count(fontId) == 0) {
-    Serial.printf("[%lu] [GFX] Font %d not found\n", millis(), fontId);
+  const EpdFontFamily* font = getFont(fontId);
+  if (!font) {
     return;
   }
-  const auto font = fontMap.at(fontId);
 
   // no printable characters
-  if (!font.hasPrintableChars(text, style)) {
+  if (!font->hasPrintableChars(text, style)) {
     return;
   }
 
   uint32_t cp;
   while ((cp = utf8NextCodepoint(reinterpret_cast<const uint8_t**>(&text)))) {
-    renderChar(font, cp, &xpos, &yPos, black, style);
+    renderChar(*font, cp, &xpos, &yPos, black, style);
   }
 }
 
@@ -126,7 +152,7 @@ void GfxRenderer::drawLine(int x1, int y1, int x2, int y2, const bool state) con
     }
   } else {
     // TODO: Implement
-    Serial.printf("[%lu] [GFX] Line drawing not supported\n", millis());
+    LOG_W(GFX, "Line drawing not supported");
   }
 }
 
@@ -178,8 +204,8 @@ void GfxRenderer::drawBitmap(const Bitmap& bitmap, const int x, const int y, con
   bool isScaled = false;
   int cropPixX = std::floor(bitmap.getWidth() * cropX / 2.0f);
   int cropPixY = std::floor(bitmap.getHeight() * cropY / 2.0f);
-  Serial.printf("[%lu] [GFX] Cropping %dx%d by %dx%d pix, is %s\n", millis(), bitmap.getWidth(), bitmap.getHeight(),
-                cropPixX, cropPixY, bitmap.isTopDown() ? "top-down" : "bottom-up");
+  LOG_D(GFX, "Cropping %dx%d by %dx%d pix, is %s", bitmap.getWidth(), bitmap.getHeight(), cropPixX, cropPixY,
+        bitmap.isTopDown() ? "top-down" : "bottom-up");
 
   if (maxWidth > 0 && (1.0f - cropX) * bitmap.getWidth() > maxWidth) {
     scale = static_cast<float>(maxWidth) / static_cast<float>((1.0f - cropX) * bitmap.getWidth());
@@ -189,21 +215,26 @@ void GfxRenderer::drawBitmap(const Bitmap& bitmap, const int x, const int y, con
     scale = std::min(scale, static_cast<float>(maxHeight) / static_cast<float>((1.0f - cropY) * bitmap.getHeight()));
     isScaled = true;
   }
-  Serial.printf("[%lu] [GFX] Scaling by %f - %s\n", millis(), scale, isScaled ? "scaled" : "not scaled");
+  LOG_D(GFX, "Scaling by %f - %s", scale, isScaled ? "scaled" : "not scaled");
 
   // Calculate output row size (2 bits per pixel, packed into bytes)
   // IMPORTANT: Use int, not uint8_t, to avoid overflow for images > 1020 pixels wide
   const int outputRowSize = (bitmap.getWidth() + 3) / 4;
   auto* outputRow = static_cast<uint8_t*>(malloc(outputRowSize));
   auto* rowBytes = static_cast<uint8_t*>(malloc(bitmap.getRowBytes()));
+  auto* columns = static_cast<BitmapColumn*>(malloc(bitmap.getWidth() * sizeof(BitmapColumn)));
 
-  if (!outputRow || !rowBytes) {
-    Serial.printf("[%lu] [GFX] !! Failed to allocate BMP row buffers\n", millis());
+  if (!outputRow || !rowBytes || !columns) {
+    LOG_E(GFX, "!! Failed to allocate BMP row buffers");
     free(outputRow);
     free(rowBytes);
+    free(columns);
     return;
   }
 
+  int firstColumn, endColumn;
+  mapBitmapColumns(columns, x, cropPixX, bitmap.getWidth() - cropPixX, scale, isScaled, &firstColumn, &endColumn);
+
   for (int bmpY = 0; bmpY < (bitmap.getHeight() - cropPixY); bmpY++) {
     // The BMP's (0, 0) is the bottom-left corner (if the height is positive, top-left if negative).
     // Screen's (0, 0) is the top-left corner.
@@ -217,9 +248,10 @@ void GfxRenderer::drawBitmap(const Bitmap& bitmap, const int x, const int y, con
     }
 
     if (bitmap.readNextRow(outputRow, rowBytes) != BmpReaderError::Ok) {
-      Serial.printf("[%lu] [GFX] Failed to read row %d from bitmap\n", millis(), bmpY);
+      LOG_E(GFX, "Failed to read row %d from bitmap", bmpY);
       free(outputRow);
       free(rowBytes);
+      free(columns);
       return;
     }
 
@@ -232,33 +264,12 @@ void GfxRenderer::drawBitmap(const Bitmap& bitmap, const int x, const int y, con
       continue;
     }
 
-    for (int bmpX = cropPixX; bmpX < bitmap.getWidth() - cropPixX; bmpX++) {
-      int screenX = bmpX - cropPixX;
-      if (isScaled) {
-        screenX = std::floor(screenX * scale);
-      }
-      screenX += x;  // the offset should not be scaled
-      if (screenX >= getScreenWidth()) {
-        break;
-      }
-      if (screenX < 0) {
-        continue;
-      }
-
-      const uint8_t val = outputRow[bmpX / 4] >> (6 - ((bmpX * 2) % 8)) & 0x3;
-
-      if (renderMode == BW && val < 3) {
-        drawPixel(screenX, screenY);
-      } else if (renderMode == GRAYSCALE_MSB && (val == 1 || val == 2)) {
-        drawPixel(screenX, screenY, false);
-      } else if (renderMode == GRAYSCALE_LSB && val == 1) {
-        drawPixel(screenX, screenY, false);
-      }
-    }
+    drawBitmapRow(outputRow, columns, firstColumn, endColumn, screenY, false);
   }
 
   free(outputRow);
   free(rowBytes);
+  free(columns);
 }
 
 void GfxRenderer::drawBitmap1Bit(const Bitmap& bitmap, const int x, const int y, const int maxWidth,
@@ -278,20 +289,26 @@ void GfxRenderer::drawBitmap1Bit(const Bitmap& bitmap, const int x, const int y,
   const int outputRowSize = (bitmap.getWidth() + 3) / 4;
   auto* outputRow = static_cast<uint8_t*>(malloc(outputRowSize));
   auto* rowBytes = static_cast<uint8_t*>(malloc(bitmap.getRowBytes()));
+  auto* columns = static_cast<BitmapColumn*>(malloc(bitmap.getWidth() * sizeof(BitmapColumn)));
 
-  if (!outputRow || !rowBytes) {
-    Serial.printf("[%lu] [GFX] !! Failed to allocate 1-bit BMP row buffers\n", millis());
+  if (!outputRow || !rowBytes || !columns) {
+    LOG_E(GFX, "!! Failed to allocate 1-bit BMP row buffers");
     free(outputRow);
     free(rowBytes);
+    free(columns);
     return;
   }
 
+  int firstColumn, endColumn;
+  mapBitmapColumns(columns, x, 0, bitmap.getWidth(), scale, isScaled, &firstColumn, &endColumn);
+
   for (int bmpY = 0; bmpY < bitmap.getHeight(); bmpY++) {
     // Read rows sequentially using readNextRow
     if (bitmap.readNextRow(outputRow, rowBytes) != BmpReaderError::Ok) {
-      Serial.printf("[%lu] [GFX] Failed to read row %d from 1-bit bitmap\n", millis(), bmpY);
+      LOG_E(GFX, "Failed to read row %d from 1-bit bitmap", bmpY);
       free(outputRow);
       free(rowBytes);
+      free(columns);
       return;
     }
 
@@ -305,29 +322,140 @@ void GfxRenderer::drawBitmap1Bit(const Bitmap& bitmap, const int x, const int y,
       continue;
     }
 
-    for (int bmpX = 0; bmpX < bitmap.getWidth(); bmpX++) {
-      int screenX = x + (isScaled ? static_cast<int>(std::floor(bmpX * scale)) : bmpX);
-      if (screenX >= getScreenWidth()) {
+    // For 1-bit source: 0 or 1 -> map to black (0,1,2) or white (3), white pixels leave the background
+    drawBitmapRow(outputRow, columns, firstColumn, endColumn, screenY, true);
+  }
+
+  free(outputRow);
+  free(rowBytes);
+  free(columns);
+}
+
+void GfxRenderer::mapBitmapColumns(BitmapColumn* columns, const int x, const int firstBmpX, const int endBmpX,
+                                   const float scale, const bool isScaled, int* outFirst, int* outEnd) const {
+  *outFirst = endBmpX;
+  *outEnd = endBmpX;
+  const int screenWidth = getScreenWidth();
+  for (int bmpX = firstBmpX; bmpX < endBmpX; bmpX++) {
+    // Same rounding as drawing pixel by pixel, so a scaled image still lands on exactly the same pixels
+    int screenX = bmpX - firstBmpX;
+    if (isScaled) {
+      screenX = static_cast<int>(std::floor(screenX * scale));
+    }
+    screenX += x;  // the offset should not be scaled
+    if (screenX >= screenWidth) {
+      *outEnd = bmpX;
+      break;
+    }
+    if (screenX < 0) {
+      continue;
+    }
+    if (*outFirst == endBmpX) {
+      *outFirst = bmpX;
+    }
+
+    BitmapColumn& column = columns[bmpX];
+    switch (orientation) {
+      case Portrait:
+        column.offset = (HalDisplay::DISPLAY_HEIGHT - 1 - screenX) * HalDisplay::DISPLAY_WIDTH_BYTES;
+        column.mask = 0;
+        break;
+      case LandscapeClockwise: {
+        const int panelX = HalDisplay::DISPLAY_WIDTH - 1 - screenX;
+        column.offset = panelX / 8;
+        column.mask = 0x80 >> (panelX % 8);
         break;
       }
-      if (screenX < 0) {
-        continue;
-      }
+      case PortraitInverted:
+        column.offset = screenX * HalDisplay::DISPLAY_WIDTH_BYTES;
+        column.mask = 0;
+        break;
+      case LandscapeCounterClockwise:
+        column.offset = screenX / 8;
+        column.mask = 0x80 >> (screenX % 8);
+        break;
+    }
+  }
+}
+
+void GfxRenderer::drawBitmapRow(const uint8_t* row, const BitmapColumn* columns, const int first, const int end,
+                                const int screenY, const bool oneBit) const {
+  uint8_t* frameBuffer = display.getFrameBuffer();
+  if (!frameBuffer || first >= end) {
+    return;
+  }
+
+  // The row's part of the position, see rotateCoordinates()
+  int rowOffset = 0;
+  uint8_t rowMask = 0;
+  switch (orientation) {
+    case Portrait:
+      rowOffset = screenY / 8;
+      rowMask = 0x80 >> (screenY % 8);
+      break;
+    case LandscapeClockwise:
+      rowOffset = (HalDisplay::DISPLAY_HEIGHT - 1 - screenY) * HalDisplay::DISPLAY_WIDTH_BYTES;
+      break;
+    case PortraitInverted: {
+      const int panelX = HalDisplay::DISPLAY_WIDTH - 1 - screenY;
+      rowOffset = panelX / 8;
+      rowMask = 0x80 >> (panelX % 8);
+      break;
+    }
+    case LandscapeCounterClockwise:
+      rowOffset = screenY * HalDisplay::DISPLAY_WIDTH_BYTES;
+      break;
+  }
 
-      // Get 2-bit value (result of readNextRow quantization)
-      const uint8_t val = outputRow[bmpX / 4] >> (6 - ((bmpX * 2) % 8)) & 0x3;
+  // One bit per 2-bit value the pass draws: anything but white goes black in BW, the grays go to the planes
+  uint8_t drawnValues;
+  bool black = true;
+  if (oneBit || renderMode == BW) {
+    drawnValues = 0b0111;
+  } else if (renderMode == GRAYSCALE_MSB) {
+    drawnValues = 0b0110;
+    black = false;
+  } else {
+    drawnValues = 0b0010;
+    black = false;
+  }
 
-      // For 1-bit source: 0 or 1 -> map to black (0,1,2) or white (3)
-      // val < 3 means black pixel (draw it)
-      if (val < 3) {
-        drawPixel(screenX, screenY, true);
+  const auto blit = [&](auto apply) {
+    for (int bmpX = first; bmpX < end; bmpX++) {
+      // No pass draws white, skip four of them at a time
+      if (bmpX % 4 == 0 && row[bmpX / 4] == 0xFF) {
+        bmpX += 3;
+        continue;
+      }
+      const uint8_t val = row[bmpX / 4] >> (6 - (bmpX % 4) * 2) & 0x3;
+      if (drawnValues >> val & 1) {
+        const BitmapColumn& column = columns[bmpX];
+        apply(frameBuffer[rowOffset + column.offset], column.mask | rowMask);
       }
-      // White pixels (val == 3) are not drawn (leave background)
     }
+  };
+  if (black) {
+    blit([](uint8_t& byte, const uint8_t mask) { byte &= ~mask; });
+  } else {
+    blit([](uint8_t& byte, const uint8_t mask) { byte |= mask; });
   }
+}
 
-  free(outputRow);
-  free(rowBytes);
+void GfxRenderer::drawPlanarRow(const uint8_t* highPlane, const uint8_t* lowPlane, const int x, const int y,
+                                const int width) const {
+  for (int i = 0; i < width; i++) {
+    const uint8_t mask = 0x80 >> (i % 8);
+    const bool high = highPlane[i / 8] & mask;
+    const bool low = lowPlane[i / 8] & mask;
+    // Same mapping as the 2-bit BMPs in drawBitmap: anything but white is black in BW, the grays go to the planes
+    if (renderMode == BW && !(high && low)) {
+      drawPixel(x + i, y);
+    } else if (renderMode == GRAYSCALE_MSB && high != low) {
+      drawPixel(x + i, y, false);
+    } else if (renderMode == GRAYSCALE_LSB && !high && low) {
+      drawPixel(x + i, y, false);
+    }
+  }
 }
 
 void GfxRenderer::fillPolygon(const int* xPoints, const int* yPoints, int numPoints, bool state) const {
@@ -347,7 +475,7 @@ void GfxRenderer::fillPolygon(const int* xPoints, const int* yPoints, int numPoi
   // Allocate node buffer for scanline algorithm
   auto* nodeX = static_cast<int*>(malloc(numPoints * sizeof(int)));
   if (!nodeX) {
-    Serial.printf("[%lu] [GFX] !! Failed to allocate polygon node buffer\n", millis());
+    LOG_E(GFX, "!! Failed to allocate polygon node buffer");
     return;
   }
 
@@ -403,7 +531,7 @@ void GfxRenderer::clearScreen(const uint8_t color) const { display.clearScreen(c
 void GfxRenderer::invertScreen() const {
   uint8_t* buffer = display.getFrameBuffer();
   if (!buffer) {
-    Serial.printf("[%lu] [GFX] !! No framebuffer in invertScreen\n", millis());
+    LOG_E(GFX, "!! No framebuffer in invertScreen");
     return;
   }
   for (int i = 0; i < HalDisplay::BUFFER_SIZE; i++) {
@@ -454,30 +582,30 @@ int GfxRenderer::getScreenHeight() const {
 }
 
 int GfxRenderer::getSpaceWidth(const int fontId) const {
-  if (fontMap.count(fontId) == 0) {
-    Serial.printf("[%lu] [GFX] Font %d not found\n", millis(), fontId);
+  const EpdFontFamily* font = getFont(fontId);
+  if (!font) {
     return 0;
   }
 
-  return fontMap.at(fontId).getGlyph(' ', EpdFontFamily::REGULAR)->advanceX;
+  return font->getGlyph(' ', EpdFontFamily::REGULAR)->advanceX;
 }
 
 int GfxRenderer::getFontAscenderSize(const int fontId) const {
-  if (fontMap.count(fontId) == 0) {
-    Serial.printf("[%lu] [GFX] Font %d not found\n", millis(), fontId);
+  const EpdFontFamily* font = getFont(fontId);
+  if (!font) {
     return 0;
   }
 
-  return fontMap.at(fontId).getData(EpdFontFamily::REGULAR)->ascender;
+  return font->getData(EpdFontFamily::REGULAR)->ascender;
 }
 
 int GfxRenderer::getLineHeight(const int fontId) const {
-  if (fontMap.count(fontId) == 0) {
-    Serial.printf("[%lu] [GFX] Font %d not found\n", millis(), fontId);
+  const EpdFontFamily* font = getFont(fontId);
+  if (!font) {
     return 0;
   }
 
-  return fontMap.at(fontId).getData(EpdFontFamily::REGULAR)->advanceY;
+  return font->getData(EpdFontFamily::REGULAR)->advanceY;
 }
 
 void GfxRenderer::drawButtonHints(const int fontId, const char* btn1, const char* btn2, const char* btn3,
@@ -560,11 +688,11 @@ void GfxRenderer::drawSideButtonHints(const int fontId, const char* topBtn, cons
 }
 
 int GfxRenderer::getTextHeight(const int fontId) const {
-  if (fontMap.count(fontId) == 0) {
-    Serial.printf("[%lu] [GFX] Font %d not found\n", millis(), fontId);
+  const EpdFontFamily* font = getFont(fontId);
+  if (!font) {
     return 0;
   }
-  return fontMap.at(fontId).getData(EpdFontFamily::REGULAR)->ascender;
+  return font->getData(EpdFontFamily::REGULAR)->ascender;
 }
 
 void GfxRenderer::drawTextRotated90CW(const int fontId, const int x, const int y, const char* text, const bool black,
@@ -574,14 +702,13 @@ void GfxRenderer::drawTextRotated90CW(const int fontId, const int x, const int y
     return;
   }
 
-  if (fontMap.count(fontId) == 0) {
-    Serial.printf("[%lu] [GFX] Font %d not found\n", millis(), fontId);
+  const EpdFontFamily* font = getFont(fontId);
+  if (!font) {
     return;
   }
-  const auto font = fontMap.at(fontId);
 
   // No printable characters
-  if (!font.hasPrintableChars(text, style)) {
+  if (!font->hasPrintableChars(text, style)) {
     return;
   }
 
@@ -593,22 +720,22 @@ void GfxRenderer::drawTextRotated90CW(const int fontId, const int x, const int y
 
   uint32_t cp;
   while ((cp = utf8NextCodepoint(reinterpret_cast<const uint8_t**>(&text)))) {
-    const EpdGlyph* glyph = font.getGlyph(cp, style);
+    const EpdGlyph* glyph = font->getGlyph(cp, style);
     if (!glyph) {
-      glyph = font.getGlyph(REPLACEMENT_GLYPH, style);
+      glyph = font->getGlyph(REPLACEMENT_GLYPH, style);
     }
     if (!glyph) {
       continue;
     }
 
-    const int is2Bit = font.getData(style)->is2Bit;
+    const int is2Bit = font->getData(style)->is2Bit;
     const uint32_t offset = glyph->dataOffset;
     const uint8_t width = glyph->width;
     const uint8_t height = glyph->height;
     const int left = glyph->left;
     const int top = glyph->top;
 
-    const uint8_t* bitmap = &font.getData(style)->bitmap[offset];
+    const uint8_t* bitmap = &font->getData(style)->bitmap[offset];
 
     if (bitmap != nullptr) {
       for (int glyphY = 0; glyphY < height; glyphY++) {
@@ -618,7 +745,7 @@ void GfxRenderer::drawTextRotated90CW(const int fontId, const int x, const int y
           // 90° clockwise rotation transformation:
           // screenX = x + (ascender - top + glyphY)
           // screenY = yPos - (left + glyphX)
-          const int screenX = x + (font.getData(style)->ascender - top + glyphY);
+          const int screenX = x + (font->getData(style)->ascender - top + glyphY);
           const int screenY = yPos - left - glyphX;
 
           if (is2Bit) {
@@ -666,7 +793,7 @@ void GfxRenderer::displayGrayBuffer() const { display.displayGrayBuffer(); }
 void GfxRenderer::freeBwBufferChunks() {
   for (auto& bwBufferChunk : bwBufferChunks) {
     if (bwBufferChunk) {
-      free(bwBufferChunk);
+      BUFFER_POOL.release(bwBufferChunk);
       bwBufferChunk = nullptr;
     }
   }
@@ -675,13 +802,13 @@ void GfxRenderer::freeBwBufferChunks() {
 /**
  * This should be called before grayscale buffers are populated.
  * A `restoreBwBuffer` call should always follow the grayscale render if this method was called.
- * Uses chunked allocation to avoid needing 48KB of contiguous memory.
+ * Chunks are leased from the buffer pool, they stay chunked so the heap fallback never needs 48KB of contiguous memory.
  * Returns true if buffer was stored successfully, false if allocation failed.
  */
 bool GfxRenderer::storeBwBuffer() {
   const uint8_t* frameBuffer = display.getFrameBuffer();
   if (!frameBuffer) {
-    Serial.printf("[%lu] [GFX] !! No framebuffer in storeBwBuffer\n", millis());
+    LOG_E(GFX, "!! No framebuffer in storeBwBuffer");
     return false;
   }
 
@@ -689,18 +816,16 @@ bool GfxRenderer::storeBwBuffer() {
   for (size_t i = 0; i < BW_BUFFER_NUM_CHUNKS; i++) {
     // Check if any chunks are already allocated
     if (bwBufferChunks[i]) {
-      Serial.printf("[%lu] [GFX] !! BW buffer chunk %zu already stored - this is likely a bug, freeing chunk\n",
-                    millis(), i);
-      free(bwBufferChunks[i]);
+      LOG_E(GFX, "!! BW buffer chunk %zu already stored - this is likely a bug, freeing chunk", i);
+      BUFFER_POOL.release(bwBufferChunks[i]);
       bwBufferChunks[i] = nullptr;
     }
 
     const size_t offset = i * BW_BUFFER_CHUNK_SIZE;
-    bwBufferChunks[i] = static_cast<uint8_t*>(malloc(BW_BUFFER_CHUNK_SIZE));
+    bwBufferChunks[i] = BUFFER_POOL.lease(BW_BUFFER_CHUNK_SIZE, "bwBuffer");
 
     if (!bwBufferChunks[i]) {
-      Serial.printf("[%lu] [GFX] !! Failed to allocate BW buffer chunk %zu (%zu bytes)\n", millis(), i,
-                    BW_BUFFER_CHUNK_SIZE);
+      LOG_E(GFX, "!! Failed to allocate BW buffer chunk %zu (%zu bytes)", i, BW_BUFFER_CHUNK_SIZE);
       // Free previously allocated chunks
       freeBwBufferChunks();
       return false;
@@ -709,8 +834,7 @@ bool GfxRenderer::storeBwBuffer() {
     memcpy(bwBufferChunks[i], frameBuffer + offset, BW_BUFFER_CHUNK_SIZE);
   }
 
-  Serial.printf("[%lu] [GFX] Stored BW buffer in %zu chunks (%zu bytes each)\n", millis(), BW_BUFFER_NUM_CHUNKS,
-                BW_BUFFER_CHUNK_SIZE);
+  LOG_D(GFX, "Stored BW buffer in %zu chunks (%zu bytes each)", BW_BUFFER_NUM_CHUNKS, BW_BUFFER_CHUNK_SIZE);
   return true;
 }
 
@@ -736,7 +860,7 @@ void GfxRenderer::restoreBwBuffer() {
 
   uint8_t* frameBuffer = display.getFrameBuffer();
   if (!frameBuffer) {
-    Serial.printf("[%lu] [GFX] !! No framebuffer in restoreBwBuffer\n", millis());
+    LOG_E(GFX, "!! No framebuffer in restoreBwBuffer");
     freeBwBufferChunks();
     return;
   }
@@ -744,7 +868,7 @@ void GfxRenderer::restoreBwBuffer() {
   for (size_t i = 0; i < BW_BUFFER_NUM_CHUNKS; i++) {
     // Check if chunk is missing
     if (!bwBufferChunks[i]) {
-      Serial.printf("[%lu] [GFX] !! BW buffer chunks not stored - this is likely a bug\n", millis());
+      LOG_E(GFX, "!! BW buffer chunks not stored - this is likely a bug");
       freeBwBufferChunks();
       return;
     }
@@ -756,7 +880,7 @@ void GfxRenderer::restoreBwBuffer() {
   display.cleanupGrayscaleBuffers(frameBuffer);
 
   freeBwBufferChunks();
-  Serial.printf("[%lu] [GFX] Restored and freed BW buffer chunks\n", millis());
+  LOG_D(GFX, "Restored and freed BW buffer chunks");
 }
 
 /**
@@ -779,7 +903,7 @@ void GfxRenderer::renderChar(const EpdFontFamily& fontFamily, const uint32_t cp,
 
   // no glyph?
   if (!glyph) {
-    Serial.printf("[%lu] [GFX] No glyph for codepoint %d\n", millis(), cp);
+    LOG_RATE_LIMITED(LOG_LEVEL_WARN, GFX, 1000, "No glyph for codepoint %d", cp);
     return;
   }
 
@@ -861,3 +985,25 @@ void GfxRenderer::getOrientedViewableTRBL(int* outTop, int* outRight, int* outBo
       break;
   }
 }
+
+bool GfxRenderer::getPanelRect(const int x, const int y, const int width, const int height, int* outByteX, int* outY,
+                               int* outWidthBytes, int* outHeight) const {
+  if (width <= 0 || height <= 0) {
+    return false;
+  }
+  int x1 = 0, y1 = 0, x2 = 0, y2 = 0;
+  rotateCoordinates(x, y, &x1, &y1);
+  rotateCoordinates(x + width - 1, y + height - 1, &x2, &y2);
+  const int left = std::max(std::min(x1, x2), 0);
+  const int right = std::min(std::max(x1, x2), HalDisplay::DISPLAY_WIDTH - 1);
+  const int top = std::max(std::min(y1, y2), 0);
+  const int bottom = std::min(std::max(y1, y2), HalDisplay::DISPLAY_HEIGHT - 1);
+  if (left > right || top > bottom) {
+    return false;
+  }
+  *outByteX = left / 8;
+  *outY = top;
+  *outWidthBytes = right / 8 - left / 8 + 1;
+  *outHeight = bottom - top + 1;
+  return true;
+}
@@ -3,6 +3,7 @@
 #include <EpdFontFamily.h>
 #include <HalDisplay.h>
 
+#include <atomic>
 #include <map>
 
 #include "Bitmap.h"
@@ -29,11 +30,36 @@ class GfxRenderer {
   RenderMode renderMode;
   Orientation orientation;
   uint8_t* bwBufferChunks[BW_BUFFER_NUM_CHUNKS] = {nullptr};
-  std::map<int, EpdFontFamily> fontMap;
+  // A font id is registered with a loader, the family is built on the first lookup of the id. Registration happens
+  // during setup, so the map itself is only read afterwards and tasks can race on a lookup without a lock, both get
+  // the same family since loaders return statics.
+  struct FontSlot {
+    const EpdFontFamily& (*loader)();
+    EpdFontFamily inserted;  // Family handed to insertFont(), unused with a loader
+    mutable std::atomic<const EpdFontFamily*> family;
+
+    FontSlot(const EpdFontFamily& (*loader)(), const EpdFontFamily& inserted)
+        : loader(loader), inserted(inserted), family(nullptr) {}
+  };
+  std::map<int, FontSlot> fontMap;
   void renderChar(const EpdFontFamily& fontFamily, uint32_t cp, int* x, const int* y, bool pixelState,
                   EpdFontFamily::Style style) const;
   void freeBwBufferChunks();
   void rotateCoordinates(int x, int y, int* rotatedX, int* rotatedY) const;
+  // Frame buffer position of a bitmap column, the current row adds its own part. Depending on the orientation either
+  // the column or the row picks the bit, the other one leaves mask at 0.
+  struct BitmapColumn {
+    uint16_t offset;
+    uint8_t mask;
+  };
+  // Maps the bitmap columns from firstBmpX up to endBmpX to the screen once per image, clipping them to the screen
+  // width. Sets the range of columns that land on screen.
+  void mapBitmapColumns(BitmapColumn* columns, int x, int firstBmpX, int endBmpX, float scale, bool isScaled,
+                        int* outFirst, int* outEnd) const;
+  // Draws one row of 2-bit values (3 = white) through the column map. 1-bit bitmaps draw black for anything but white
+  // whatever the render mode.
+  void drawBitmapRow(const uint8_t* row, const BitmapColumn* columns, int first, int end, int screenY,
+                     bool oneBit) const;
 
  public:
   explicit GfxRenderer(HalDisplay& halDisplay) : display(halDisplay), renderMode(BW), orientation(Portrait) {}
@@ -46,6 +72,9 @@ class GfxRenderer {
 
   // Setup
   void insertFont(int fontId, EpdFontFamily font);
+  // The loader runs the first time fontId is drawn or measured and must return a family that lives as long as the
+  // renderer
+  void registerFont(int fontId, const EpdFontFamily& (*loader)());
 
   // Orientation control (affects logical width/height and coordinate transforms)
   void setOrientation(const Orientation o) { orientation = o; }
@@ -69,9 +98,13 @@ class GfxRenderer {
   void drawBitmap(const Bitmap& bitmap, int x, int y, int maxWidth, int maxHeight, float cropX = 0,
                   float cropY = 0) const;
   void drawBitmap1Bit(const Bitmap& bitmap, int x, int y, int maxWidth, int maxHeight) const;
+  // One row of a 2-bit image kept as two bit planes (3 = white), drawn for the current render mode
+  void drawPlanarRow(const uint8_t* highPlane, const uint8_t* lowPlane, int x, int y, int width) const;
   void fillPolygon(const int* xPoints, const int* yPoints, int numPoints, bool state = true) const;
 
   // Text
+  // nullptr for an id that was never registered, loads the family on its first lookup
+  const EpdFontFamily* getFont(int fontId) const;
   int getTextWidth(int fontId, const char* text, EpdFontFamily::Style style = EpdFontFamily::REGULAR) const;
   void drawCenteredText(int fontId, int y, const char* text, bool black = true,
                         EpdFontFamily::Style style = EpdFontFamily::REGULAR) const;
@@ -108,4 +141,8 @@ class GfxRenderer {
   static size_t getBufferSize();
   void grayscaleRevert() const;
   void getOrientedViewableTRBL(int* outTop, int* outRight, int* outBottom, int* outLeft) const;
+  // Frame buffer area a logical rectangle lands on: panel rows and whole bytes of a row, clipped to the panel. False
+  // when nothing of it is on the panel.
+  bool getPanelRect(int x, int y, int width, int height, int* outByteX, int* outY, int* outWidthBytes,
+                    int* outHeight) const;
 };
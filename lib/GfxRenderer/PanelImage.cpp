@@ -0,0 +1,202 @@
+#include "PanelImage.h"
+
+#include <BufferedFs.h>
+#include <Logging.h>
+#include <PackBits.h>
+#include <SDCardManager.h>
+
+#include <cstring>
+
+#include "GfxRenderer.h"
+
+namespace {
+constexpr char MAGIC[4] = {'P', 'I', 'M', 'G'};
+constexpr uint8_t VERSION = 2;
+// makeKey() hashes the start of the source (the BMP headers and palette) and evenly spaced samples of the rest
+constexpr size_t KEY_HEAD_BYTES = 1024;
+constexpr int KEY_SAMPLES = 32;
+constexpr size_t KEY_SAMPLE_BYTES = 64;
+
+uint32_t fnvHash32(const void* data, const size_t length, uint32_t hash = 2166136261u) {
+  const auto* bytes = static_cast<const uint8_t*>(data);
+  for (size_t i = 0; i < length; i++) {
+    hash ^= bytes[i];
+    hash *= 16777619u;
+  }
+  return hash;
+}
+}  // namespace
+
+uint32_t PanelImage::makeKey(FsFile& source, const std::initializer_list<int32_t> layout) {
+  // The contents, not the modification time: cards written without a clock all carry the same date
+  const uint32_t size = source.fileSize();
+  const uint32_t position = source.curPosition();
+  uint32_t hash = fnvHash32(&size, sizeof(size));
+  uint8_t buffer[KEY_SAMPLE_BYTES];
+  for (size_t offset = 0; offset < KEY_HEAD_BYTES && offset < size; offset += sizeof(buffer)) {
+    if (!source.seek(offset)) {
+      break;
+    }
+    const int read = source.read(buffer, sizeof(buffer));
+    if (read <= 0) {
+      break;
+    }
+    hash = fnvHash32(buffer, read, hash);
+  }
+  if (size > KEY_HEAD_BYTES) {
+    const uint32_t span = size - KEY_HEAD_BYTES;
+    for (int i = 1; i <= KEY_SAMPLES; i++) {
+      // The last sample ends at the end of the file
+      const uint32_t end = KEY_HEAD_BYTES + static_cast<uint32_t>(static_cast<uint64_t>(span) * i / KEY_SAMPLES);
+      const uint32_t start = end > KEY_HEAD_BYTES + sizeof(buffer) ? end - sizeof(buffer) : KEY_HEAD_BYTES;
+      if (end == start) {
+        continue;
+      }
+      if (!source.seek(start)) {
+        break;
+      }
+      const int read = source.read(buffer, end - start);
+      if (read <= 0) {
+        break;
+      }
+      hash = fnvHash32(buffer, read, hash);
+    }
+  }
+  source.seek(position);
+
+  for (const int32_t value : layout) {
+    hash = fnvHash32(&value, sizeof(value), hash);
+  }
+  return hash;
+}
+
+std::string PanelImage::pathFor(const std::string& bmpPath) {
+  const size_t dot = bmpPath.find_last_of('.');
+  const size_t slash = bmpPath.find_last_of('/');
+  const bool hasExtension = dot != std::string::npos && (slash == std::string::npos || dot > slash);
+  return (hasExtension ? bmpPath.substr(0, dot) : bmpPath) + ".fb";
+}
+
+bool PanelImage::open(const std::string& path, const uint32_t key) {
+  close();
+  if (!SdMan.exists(path.c_str()) || !SdMan.openFileForRead("GFX", path, file)) {
+    return false;
+  }
+
+  if (file.read(reinterpret_cast<uint8_t*>(&header), sizeof(header)) != sizeof(header) ||
+      memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION) {
+    LOG_W(GFX, "Not a panel image: %s", path.c_str());
+    close();
+    return false;
+  }
+  if (header.key != key) {
+    LOG_I(GFX, "Stale panel image: %s", path.c_str());
+    close();
+    return false;
+  }
+  if (header.planeCount == 0 || header.planeCount > MAX_PLANES || header.widthBytes == 0 || header.height == 0 ||
+      header.byteX + header.widthBytes > HalDisplay::DISPLAY_WIDTH_BYTES ||
+      header.y + header.height > HalDisplay::DISPLAY_HEIGHT) {
+    LOG_W(GFX, "Bad panel image layout: %s", path.c_str());
+    close();
+    return false;
+  }
+  return true;
+}
+
+bool PanelImage::drawPlane(const GfxRenderer& renderer, const int plane) {
+  uint8_t* frameBuffer = renderer.getFrameBuffer();
+  if (!file || writing || !frameBuffer || plane < 0 || plane >= header.planeCount ||
+      !file.seek(header.planeOffsets[plane])) {
+    return false;
+  }
+
+  BufferedFsReader in(file);
+  for (int row = 0; row < header.height; row++) {
+    uint8_t* dst = frameBuffer + (header.y + row) * HalDisplay::DISPLAY_WIDTH_BYTES + header.byteX;
+    if (!packbits::unpack(in, dst, header.widthBytes)) {
+      LOG_E(GFX, "Panel image plane %d ends at row %d", plane, row);
+      return false;
+    }
+  }
+  return true;
+}
+
+bool PanelImage::begin(const std::string& path, const uint32_t key, const GfxRenderer& renderer, const int x,
+                       const int y, const int width, const int height) {
+  close();
+  int byteX, panelY, widthBytes, panelHeight;
+  if (!renderer.getPanelRect(x, y, width, height, &byteX, &panelY, &widthBytes, &panelHeight) ||
+      !SdMan.openFileForWrite("GFX", path, file)) {
+    return false;
+  }
+
+  this->path = path;
+  header = {};
+  header.key = key;
+  header.byteX = byteX;
+  header.y = panelY;
+  header.widthBytes = widthBytes;
+  header.height = panelHeight;
+  writing = true;
+  failed = false;
+
+  // Placeholder until finish(), the magic stays zero
+  const Header empty = {};
+  if (file.write(reinterpret_cast<const uint8_t*>(&empty), sizeof(empty)) != sizeof(empty)) {
+    failed = true;
+  }
+  return !failed;
+}
+
+bool PanelImage::addPlane(const GfxRenderer& renderer) {
+  const uint8_t* frameBuffer = renderer.getFrameBuffer();
+  if (!writing || failed || !frameBuffer || header.planeCount >= MAX_PLANES) {
+    failed = true;
+    return false;
+  }
+
+  header.planeOffsets[header.planeCount] = file.position();
+  BufferedFsWriter out(file);
+  // Packed a row at a time, runs never cross rows
+  for (int row = 0; row < header.height; row++) {
+    packbits::pack(out, frameBuffer + (header.y + row) * HalDisplay::DISPLAY_WIDTH_BYTES + header.byteX,
+                   header.widthBytes);
+  }
+  if (!out.flush()) {
+    failed = true;
+    return false;
+  }
+  header.planeCount++;
+  return true;
+}
+
+bool PanelImage::finish() {
+  if (!writing) {
+    return false;
+  }
+  if (!failed && header.planeCount > 0) {
+    memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    if (file.seek(0) && file.write(reinterpret_cast<const uint8_t*>(&header), sizeof(header)) == sizeof(header)) {
+      LOG_I(GFX, "Wrote panel image %s: %d plane(s), %lu bytes", path.c_str(), header.planeCount,
+            static_cast<unsigned long>(file.fileSize()));
+      writing = false;
+    }
+  }
+  const bool written = !writing;
+  close();
+  return written;
+}
+
+void PanelImage::close() {
+  if (file) {
+    file.close();
+  }
+  if (writing) {
+    // Never leave a partial file behind
+    writing = false;
+    SdMan.remove(path.c_str());
+    LOG_W(GFX, "Discarded panel image %s", path.c_str());
+  }
+}
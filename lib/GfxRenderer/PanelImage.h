@@ -0,0 +1,73 @@
+#pragma once
+
+#include <SdFat.h>
+
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+
+class GfxRenderer;
+
+/**
+ * PanelImage.h
+ *
+ * An image stored the way the frame buffer holds it: the bytes of a rectangle of panel rows, already rotated, scaled
+ * and dithered, one plane per render pass (BW, then the LSB and MSB passes of a grayscale image). Each row is PackBits
+ * compressed. Showing one is a sequential read into the frame buffer, with no BMP parsing and no per-pixel work.
+ *
+ * A panel image is made by drawing its source once the usual way and capturing the frame buffer after each pass. The
+ * key ties it to that source and layout (see makeKey()), a file with any other key is stale and gets made again.
+ *
+ * The header is only written by finish(), so a file cut short never has a valid header.
+ */
+class PanelImage {
+ public:
+  static constexpr uint8_t MAX_PLANES = 3;
+
+  // Hash of the source file's size, headers and sampled pixel data and the values that decide how it is drawn. Leaves
+  // the source where it was
+  static uint32_t makeKey(FsFile& source, std::initializer_list<int32_t> layout);
+  // Where the panel image of a cached BMP is kept: next to it, .fb instead of .bmp
+  static std::string pathFor(const std::string& bmpPath);
+
+  PanelImage() = default;
+  ~PanelImage() { close(); }
+  PanelImage(const PanelImage&) = delete;
+  PanelImage& operator=(const PanelImage&) = delete;
+
+  // False when the file is missing, damaged or has another key
+  bool open(const std::string& path, uint32_t key);
+  int getPlaneCount() const { return header.planeCount; }
+  // Copies a plane over its rectangle of the frame buffer, the rest of the buffer is left alone
+  bool drawPlane(const GfxRenderer& renderer, int plane);
+
+  // Starts a file covering the logical rectangle in the renderer's current orientation
+  bool begin(const std::string& path, uint32_t key, const GfxRenderer& renderer, int x, int y, int width, int height);
+  // Captures the rectangle of the frame buffer as the next plane
+  bool addPlane(const GfxRenderer& renderer);
+  // Writes the header, or removes the file if anything went wrong
+  bool finish();
+
+  void close();
+
+ private:
+  struct Header {
+    char magic[4];
+    uint8_t version;
+    uint8_t planeCount;
+    uint8_t reserved[2];
+    uint32_t key;
+    uint16_t byteX;  // First byte of each row in the frame buffer
+    uint16_t y;
+    uint16_t widthBytes;
+    uint16_t height;
+    uint32_t planeOffsets[MAX_PLANES];
+  };
+  static_assert(sizeof(Header) == 32, "Panel image header must stay packed");
+
+  FsFile file;
+  std::string path;
+  Header header = {};
+  bool writing = false;
+  bool failed = false;
+};
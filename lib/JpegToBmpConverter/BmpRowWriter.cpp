@@ -0,0 +1,371 @@
+#include "BmpRowWriter.h"
+
+#include <HardwareSerial.h>
+
+#include <cstdlib>
+#include <cstring>
+
+#include "BitmapHelpers.h"
+
+// ============================================================================
+// IMAGE PROCESSING OPTIONS - Toggle these to test different configurations
+// ============================================================================
+constexpr bool USE_8BIT_OUTPUT = false;  // true: 8-bit grayscale (no quantization), false: 2-bit (4 levels)
+// Dithering method selection (only one should be true, or all false for simple quantization):
+constexpr bool USE_ATKINSON = true;          // Atkinson dithering (cleaner than F-S, less error diffusion)
+constexpr bool USE_FLOYD_STEINBERG = false;  // Floyd-Steinberg error diffusion (can cause "worm" artifacts)
+constexpr bool USE_NOISE_DITHERING = false;  // Hash-based noise dithering (good for downsampling)
+// Pre-resize to target display size (CRITICAL: avoids dithering artifacts from post-downsampling)
+constexpr bool USE_PRESCALE = true;  // true: scale image to target size before dithering
+// ============================================================================
+
+namespace {
+inline void write16(Print& out, const uint16_t value) {
+  out.write(value & 0xFF);
+  out.write((value >> 8) & 0xFF);
+}
+
+inline void write32(Print& out, const uint32_t value) {
+  out.write(value & 0xFF);
+  out.write((value >> 8) & 0xFF);
+  out.write((value >> 16) & 0xFF);
+  out.write((value >> 24) & 0xFF);
+}
+
+inline void write32Signed(Print& out, const int32_t value) {
+  out.write(value & 0xFF);
+  out.write((value >> 8) & 0xFF);
+  out.write((value >> 16) & 0xFF);
+  out.write((value >> 24) & 0xFF);
+}
+
+// Helper function: Write BMP header with 8-bit grayscale (256 levels)
+void writeBmpHeader8bit(Print& bmpOut, const int width, const int height) {
+  // Calculate row padding (each row must be multiple of 4 bytes)
+  const int bytesPerRow = (width + 3) / 4 * 4;  // 8 bits per pixel, padded
+  const int imageSize = bytesPerRow * height;
+  const uint32_t paletteSize = 256 * 4;  // 256 colors * 4 bytes (BGRA)
+  const uint32_t fileSize = 14 + 40 + paletteSize + imageSize;
+
+  // BMP File Header (14 bytes)
+  bmpOut.write('B');
+  bmpOut.write('M');
+  write32(bmpOut, fileSize);
+  write32(bmpOut, 0);                      // Reserved
+  write32(bmpOut, 14 + 40 + paletteSize);  // Offset to pixel data
+
+  // DIB Header (BITMAPINFOHEADER - 40 bytes)
+  write32(bmpOut, 40);
+  write32Signed(bmpOut, width);
+  write32Signed(bmpOut, -height);  // Negative height = top-down bitmap
+  write16(bmpOut, 1);              // Color planes
+  write16(bmpOut, 8);              // Bits per pixel (8 bits)
+  write32(bmpOut, 0);              // BI_RGB (no compression)
+  write32(bmpOut, imageSize);
+  write32(bmpOut, 2835);  // xPixelsPerMeter (72 DPI)
+  write32(bmpOut, 2835);  // yPixelsPerMeter (72 DPI)
+  write32(bmpOut, 256);   // colorsUsed
+  write32(bmpOut, 256);   // colorsImportant
+
+  // Color Palette (256 grayscale entries x 4 bytes = 1024 bytes)
+  for (int i = 0; i < 256; i++) {
+    bmpOut.write(static_cast<uint8_t>(i));  // Blue
+    bmpOut.write(static_cast<uint8_t>(i));  // Green
+    bmpOut.write(static_cast<uint8_t>(i));  // Red
+    bmpOut.write(static_cast<uint8_t>(0));  // Reserved
+  }
+}
+
+// Helper function: Write BMP header with 1-bit color depth (black and white)
+void writeBmpHeader1bit(Print& bmpOut, const int width, const int height) {
+  // Calculate row padding (each row must be multiple of 4 bytes)
+  const int bytesPerRow = (width + 31) / 32 * 4;  // 1 bit per pixel, round up to 4-byte boundary
+  const int imageSize = bytesPerRow * height;
+  const uint32_t fileSize = 62 + imageSize;  // 14 (file header) + 40 (DIB header) + 8 (palette) + image
+
+  // BMP File Header (14 bytes)
+  bmpOut.write('B');
+  bmpOut.write('M');
+  write32(bmpOut, fileSize);  // File size
+  write32(bmpOut, 0);         // Reserved
+  write32(bmpOut, 62);        // Offset to pixel data (14 + 40 + 8)
+
+  // DIB Header (BITMAPINFOHEADER - 40 bytes)
+  write32(bmpOut, 40);
+  write32Signed(bmpOut, width);
+  write32Signed(bmpOut, -height);  // Negative height = top-down bitmap
+  write16(bmpOut, 1);              // Color planes
+  write16(bmpOut, 1);              // Bits per pixel (1 bit)
+  write32(bmpOut, 0);              // BI_RGB (no compression)
+  write32(bmpOut, imageSize);
+  write32(bmpOut, 2835);  // xPixelsPerMeter (72 DPI)
+  write32(bmpOut, 2835);  // yPixelsPerMeter (72 DPI)
+  write32(bmpOut, 2);     // colorsUsed
+  write32(bmpOut, 2);     // colorsImportant
+
+  // Color Palette (2 colors x 4 bytes = 8 bytes)
+  // Format: Blue, Green, Red, Reserved (BGRA)
+  // Note: In 1-bit BMP, palette index 0 = black, 1 = white
+  uint8_t palette[8] = {
+      0x00, 0x00, 0x00, 0x00,  // Color 0: Black
+      0xFF, 0xFF, 0xFF, 0x00   // Color 1: White
+  };
+  for (const uint8_t i : palette) {
+    bmpOut.write(i);
+  }
+}
+
+// Helper function: Write BMP header with 2-bit color depth
+void writeBmpHeader2bit(Print& bmpOut, const int width, const int height) {
+  // Calculate row padding (each row must be multiple of 4 bytes)
+  const int bytesPerRow = (width * 2 + 31) / 32 * 4;  // 2 bits per pixel, round up
+  const int imageSize = bytesPerRow * height;
+  const uint32_t fileSize = 70 + imageSize;  // 14 (file header) + 40 (DIB header) + 16 (palette) + image
+
+  // BMP File Header (14 bytes)
+  bmpOut.write('B');
+  bmpOut.write('M');
+  write32(bmpOut, fileSize);  // File size
+  write32(bmpOut, 0);         // Reserved
+  write32(bmpOut, 70);        // Offset to pixel data
+
+  // DIB Header (BITMAPINFOHEADER - 40 bytes)
+  write32(bmpOut, 40);
+  write32Signed(bmpOut, width);
+  write32Signed(bmpOut, -height);  // Negative height = top-down bitmap
+  write16(bmpOut, 1);              // Color planes
+  write16(bmpOut, 2);              // Bits per pixel (2 bits)
+  write32(bmpOut, 0);              // BI_RGB (no compression)
+  write32(bmpOut, imageSize);
+  write32(bmpOut, 2835);  // xPixelsPerMeter (72 DPI)
+  write32(bmpOut, 2835);  // yPixelsPerMeter (72 DPI)
+  write32(bmpOut, 4);     // colorsUsed
+  write32(bmpOut, 4);     // colorsImportant
+
+  // Color Palette (4 colors x 4 bytes = 16 bytes)
+  // Format: Blue, Green, Red, Reserved (BGRA)
+  uint8_t palette[16] = {
+      0x00, 0x00, 0x00, 0x00,  // Color 0: Black
+      0x55, 0x55, 0x55, 0x00,  // Color 1: Dark gray (85)
+      0xAA, 0xAA, 0xAA, 0x00,  // Color 2: Light gray (170)
+      0xFF, 0xFF, 0xFF, 0x00   // Color 3: White
+  };
+  for (const uint8_t i : palette) {
+    bmpOut.write(i);
+  }
+}
+}  // namespace
+
+BmpRowWriter::BmpRowWriter(const JpegToBmpConverter::Target& target, const int srcWidth, const int srcHeight)
+    : bmpOut(*target.out),
+      oneBit(target.output == JpegToBmpConverter::Output::Bmp1Bit),
+      planar(target.output == JpegToBmpConverter::Output::Planar2Bit),
+      ordered(target.dither == JpegToBmpConverter::Dither::Ordered),
+      srcWidth(srcWidth),
+      srcHeight(srcHeight),
+      outWidth(srcWidth),
+      outHeight(srcHeight) {
+  const int targetWidth = target.maxWidth;
+  const int targetHeight = target.maxHeight;
+  Serial.printf("[%lu] [JPG] Converting image to %s (target: %dx%d)\n", millis(),
+                oneBit ? "1-bit BMP" : planar ? "2-bit planar" : "2-bit BMP", targetWidth, targetHeight);
+
+  // Calculate output dimensions (pre-scale to fit display exactly)
+  if (targetWidth > 0 && targetHeight > 0 && (srcWidth > targetWidth || srcHeight > targetHeight)) {
+    // Calculate scale to fit within target dimensions while maintaining aspect ratio
+    const float scaleToFitWidth = static_cast<float>(targetWidth) / srcWidth;
+    const float scaleToFitHeight = static_cast<float>(targetHeight) / srcHeight;
+    // We scale to the smaller dimension, so we can potentially crop later.
+    float scale = 1.0;
+    if (target.crop) {  // if we will crop, scale to the smaller dimension
+      scale = (scaleToFitWidth > scaleToFitHeight) ? scaleToFitWidth : scaleToFitHeight;
+    } else {  // else, scale to the larger dimension to fit
+      scale = (scaleToFitWidth < scaleToFitHeight) ? scaleToFitWidth : scaleToFitHeight;
+    }
+
+    outWidth = static_cast<int>(srcWidth * scale);
+    outHeight = static_cast<int>(srcHeight * scale);
+
+    // Ensure at least 1 pixel
+    if (outWidth < 1) outWidth = 1;
+    if (outHeight < 1) outHeight = 1;
+
+    needsScaling = true;
+
+    Serial.printf("[%lu] [JPG] Pre-scaling %dx%d -> %dx%d (fit to %dx%d)\n", millis(), srcWidth, srcHeight, outWidth,
+                  outHeight, targetWidth, targetHeight);
+  }
+}
+
+void BmpRowWriter::setSourceSize(const int width, const int height) {
+  srcWidth = width;
+  srcHeight = height;
+  needsScaling = srcWidth != outWidth || srcHeight != outHeight;
+}
+
+BmpRowWriter::~BmpRowWriter() {
+  delete[] rowAccum;
+  delete[] rowCount;
+  delete atkinsonDitherer;
+  delete fsDitherer;
+  delete atkinson1BitDitherer;
+  free(rowBuffer);
+}
+
+template <typename GrayAt>
+void BmpRowWriter::writeRow(const GrayAt& grayAt, const int y) {
+  memset(rowBuffer, 0, bytesPerRow);
+
+  if (USE_8BIT_OUTPUT && !oneBit && !planar) {
+    for (int x = 0; x < outWidth; x++) {
+      rowBuffer[x] = adjustPixel(grayAt(x));
+    }
+  } else if (oneBit) {
+    // 1-bit output with Atkinson dithering for better quality
+    for (int x = 0; x < outWidth; x++) {
+      const uint8_t gray = grayAt(x);
+      uint8_t bit;
+      if (atkinson1BitDitherer) {
+        bit = atkinson1BitDitherer->processPixel(gray, x);
+      } else if (ordered) {
+        bit = quantize1bitOrdered(gray, x, y);
+      } else {
+        bit = quantize1bit(gray, x, y);
+      }
+      // Pack 1-bit value: MSB first, 8 pixels per byte
+      const int byteIndex = x / 8;
+      const int bitOffset = 7 - (x % 8);
+      rowBuffer[byteIndex] |= (bit << bitOffset);
+    }
+    if (atkinson1BitDitherer) atkinson1BitDitherer->nextRow();
+  } else {
+    // 2-bit output
+    for (int x = 0; x < outWidth; x++) {
+      const uint8_t gray = adjustPixel(grayAt(x));
+      uint8_t twoBit;
+      if (atkinsonDitherer) {
+        twoBit = atkinsonDitherer->processPixel(gray, x);
+      } else if (fsDitherer) {
+        twoBit = fsDitherer->processPixel(gray, x);
+      } else if (ordered) {
+        twoBit = quantizeOrdered(gray, x, y);
+      } else {
+        twoBit = quantize(gray, x, y);
+      }
+      if (planar) {
+        const int bitOffset = 7 - (x % 8);
+        rowBuffer[x / 8] |= (twoBit >> 1) << bitOffset;
+        rowBuffer[bytesPerRow / 2 + x / 8] |= (twoBit & 1) << bitOffset;
+      } else {
+        const int byteIndex = (x * 2) / 8;
+        const int bitOffset = 6 - ((x * 2) % 8);
+        rowBuffer[byteIndex] |= (twoBit << bitOffset);
+      }
+    }
+    if (atkinsonDitherer)
+      atkinsonDitherer->nextRow();
+    else if (fsDitherer)
+      fsDitherer->nextRow();
+  }
+  bmpOut.write(rowBuffer, bytesPerRow);
+}
+
+bool BmpRowWriter::begin() {
+  // Write BMP header with output dimensions
+  if (planar) {
+    bytesPerRow = JpegToBmpConverter::planarRowBytes(outWidth);
+  } else if (USE_8BIT_OUTPUT && !oneBit) {
+    writeBmpHeader8bit(bmpOut, outWidth, outHeight);
+    bytesPerRow = (outWidth + 3) / 4 * 4;
+  } else if (oneBit) {
+    writeBmpHeader1bit(bmpOut, outWidth, outHeight);
+    bytesPerRow = (outWidth + 31) / 32 * 4;  // 1 bit per pixel
+  } else {
+    writeBmpHeader2bit(bmpOut, outWidth, outHeight);
+    bytesPerRow = (outWidth * 2 + 31) / 32 * 4;
+  }
+
+  // Allocate row buffer
+  rowBuffer = static_cast<uint8_t*>(malloc(bytesPerRow));
+  if (!rowBuffer) {
+    Serial.printf("[%lu] [JPG] Failed to allocate row buffer\n", millis());
+    return false;
+  }
+
+  // Create ditherer if enabled, ordered dithering needs no state
+  // Use OUTPUT dimensions for dithering (after prescaling)
+  if (oneBit && !ordered) {
+    // For 1-bit output, use Atkinson dithering for better quality
+    atkinson1BitDitherer = new Atkinson1BitDitherer(outWidth);
+  } else if (!oneBit && !ordered && (!USE_8BIT_OUTPUT || planar)) {
+    if (USE_ATKINSON) {
+      atkinsonDitherer = new AtkinsonDitherer(outWidth);
+    } else if (USE_FLOYD_STEINBERG) {
+      fsDitherer = new FloydSteinbergDitherer(outWidth);
+    }
+  }
+
+  if (needsScaling) {
+    // Calculate fixed-point scale factors (source pixels per output pixel)
+    // scaleX_fp = (srcWidth << 16) / outWidth
+    scaleX_fp = (static_cast<uint32_t>(srcWidth) << 16) / outWidth;
+    scaleY_fp = (static_cast<uint32_t>(srcHeight) << 16) / outHeight;
+    rowAccum = new uint32_t[outWidth]();
+    rowCount = new uint16_t[outWidth]();
+    nextOutY_srcStart = scaleY_fp;  // First boundary is at scaleY_fp (source Y for outY=1)
+  }
+  return true;
+}
+
+void BmpRowWriter::addSourceRow(const uint8_t* srcRow, const int y) {
+  if (!needsScaling) {
+    // No scaling - direct output (1:1 mapping)
+    writeRow([srcRow](const int x) { return srcRow[x]; }, y);
+    return;
+  }
+
+  // Fixed-point area averaging for exact fit scaling
+  // For each output pixel X, accumulate source pixels that map to it
+  // srcX range for outX: [outX * scaleX_fp >> 16, (outX+1) * scaleX_fp >> 16)
+  for (int outX = 0; outX < outWidth; outX++) {
+    // Calculate source X range for this output pixel
+    const int srcXStart = (static_cast<uint32_t>(outX) * scaleX_fp) >> 16;
+    const int srcXEnd = (static_cast<uint32_t>(outX + 1) * scaleX_fp) >> 16;
+
+    // Accumulate all source pixels in this range
+    int sum = 0;
+    int count = 0;
+    for (int srcX = srcXStart; srcX < srcXEnd && srcX < srcWidth; srcX++) {
+      sum += srcRow[srcX];
+      count++;
+    }
+
+    // Handle edge case: if no pixels in range, use nearest
+    if (count == 0 && srcXStart < srcWidth) {
+      sum = srcRow[srcXStart];
+      count = 1;
+    }
+
+    rowAccum[outX] += sum;
+    rowCount[outX] += count;
+  }
+
+  // Check if we've crossed into the next output row
+  // Current source Y in fixed point: y << 16
+  const uint32_t srcY_fp = static_cast<uint32_t>(y + 1) << 16;
+
+  // Output row when source Y crosses the boundary
+  if (srcY_fp >= nextOutY_srcStart && currentOutY < outHeight) {
+    writeRow(
+        [this](const int x) { return static_cast<uint8_t>((rowCount[x] > 0) ? (rowAccum[x] / rowCount[x]) : 0); },
+        currentOutY);
+    currentOutY++;
+
+    // Reset accumulators for next output row
+    memset(rowAccum, 0, outWidth * sizeof(uint32_t));
+    memset(rowCount, 0, outWidth * sizeof(uint16_t));
+
+    // Update boundary for next output row
+    nextOutY_srcStart = static_cast<uint32_t>(currentOutY + 1) * scaleY_fp;
+  }
+}
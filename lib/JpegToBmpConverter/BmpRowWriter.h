@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+
+#include "JpegToBmpConverter.h"
+
+class AtkinsonDitherer;
+class FloydSteinbergDitherer;
+class Atkinson1BitDitherer;
+
+/**
+ * Scales, dithers and packs the grayscale source rows of one target into BMP or planar rows. Shared by the JPEG and
+ * PNG decoders so both produce the same output for the same pixels: the image is area-averaged down to the target
+ * size first and only then dithered.
+ */
+class BmpRowWriter {
+  Print& bmpOut;
+  const bool oneBit;
+  const bool planar;
+  const bool ordered;
+  int srcWidth;
+  int srcHeight;
+  int outWidth;
+  int outHeight;
+  int bytesPerRow = 0;
+  uint8_t* rowBuffer = nullptr;
+
+  // Use fixed-point scaling (16.16) for sub-pixel accuracy
+  uint32_t scaleX_fp = 65536;  // 1.0 in 16.16 fixed point
+  uint32_t scaleY_fp = 65536;
+  bool needsScaling = false;
+
+  // For scaling: accumulate source rows into scaled output rows
+  // We need to track which source Y maps to which output Y
+  // Using fixed-point: srcY_fp = outY * scaleY_fp (gives source Y in 16.16 format)
+  uint32_t* rowAccum = nullptr;    // Accumulator for each output X (32-bit for larger sums)
+  uint16_t* rowCount = nullptr;    // Count of source pixels accumulated per output X
+  int currentOutY = 0;             // Current output row being accumulated
+  uint32_t nextOutY_srcStart = 0;  // Source Y where next output row starts (16.16 fixed point)
+
+  AtkinsonDitherer* atkinsonDitherer = nullptr;
+  FloydSteinbergDitherer* fsDitherer = nullptr;
+  Atkinson1BitDitherer* atkinson1BitDitherer = nullptr;
+
+  // Dithers and writes one output row, grayAt(x) gives the gray of output pixel x
+  template <typename GrayAt>
+  void writeRow(const GrayAt& grayAt, int y);
+
+ public:
+  BmpRowWriter(const JpegToBmpConverter::Target& target, int srcWidth, int srcHeight);
+  ~BmpRowWriter();
+
+  BmpRowWriter(const BmpRowWriter&) = delete;
+  BmpRowWriter& operator=(const BmpRowWriter&) = delete;
+
+  int getWidth() const { return outWidth; }
+  int getHeight() const { return outHeight; }
+
+  // The output size stays the one picked from the image size, the rows come in at this size instead. For a decoder
+  // that scales down on its own, call before begin(), neither may be smaller than the output size.
+  void setSourceSize(int width, int height);
+
+  // Writes the BMP header and allocates the row state, false when out of memory
+  bool begin();
+  // Source rows go in top to bottom, y is the source row number
+  void addSourceRow(const uint8_t* srcRow, int y);
+};
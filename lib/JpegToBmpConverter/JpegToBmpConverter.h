@@ -1,10 +1,70 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
 class FsFile;
 class Print;
 class ZipFile;
 
 class JpegToBmpConverter {
+ public:
+  enum class Output : uint8_t {
+    Bmp2Bit,
+    Bmp1Bit,
+    // No header, each row is the high bit plane then the low bit plane of the 2-bit values (3 = white), MSB first and
+    // padded to a byte. The size is read from the job.
+    Planar2Bit,
+  };
+
+  enum class Dither : uint8_t {
+    ErrorDiffusion,  // Atkinson, best quality
+    Ordered,         // 8x8 Bayer, several times cheaper, for small thumbnails
+  };
+
+  // One image written by a Job
+  struct Target {
+    Print* out;
+    int maxWidth;  // 0 keeps the source size
+    int maxHeight;
+    Output output;
+    bool crop;  // Scale to cover maxWidth x maxHeight instead of fitting inside it
+    Dither dither = Dither::ErrorDiffusion;
+  };
+
+  /**
+   * Decodes a JPEG or PNG once and writes an image per target, each scaled and dithered on its own. step() decodes one
+   * row of MCUs (or a few PNG rows) so the work can be spread over several loop() calls. picojpeg keeps its state in
+   * globals, so only one job (or conversion) can run at a time. PNGs are recognized by their signature, so every
+   * conversion below takes either.
+   *
+   * JPEGs are decoded at the smallest of 1/8, 1/4, 1/2 and full size that is still at least as large as every target's
+   * output, picojpeg scales the blocks down in the DCT domain for far less work than decoding every pixel.
+   */
+  class Job {
+   public:
+    enum class Status { Running, Done, Failed };
+
+    Job(FsFile& imageFile, const Target* targets, size_t targetCount);
+    ~Job();
+    Job(const Job&) = delete;
+    Job& operator=(const Job&) = delete;
+
+    // Decodes JPEGs at full size whatever the targets, to compare the scaled decode against. Call before begin().
+    void disableScaledDecode();
+    // Reads the image header and writes the BMP headers, false when the image can't be converted
+    bool begin();
+    Status step();
+    // Size of a target's image after scaling, valid once begin() succeeded
+    void getOutputSize(size_t target, int& width, int& height) const;
+
+   private:
+    struct Decoder;
+    std::unique_ptr<Decoder> decoder;
+  };
+
+ private:
   static unsigned char jpegReadCallback(unsigned char* pBuf, unsigned char buf_size,
                                         unsigned char* pBytes_actually_read, void* pCallback_data);
   static bool jpegFileToBmpStreamInternal(class FsFile& jpegFile, Print& bmpOut, int targetWidth, int targetHeight,
@@ -16,4 +76,13 @@ class JpegToBmpConverter {
   static bool jpegFileToBmpStreamWithSize(FsFile& jpegFile, Print& bmpOut, int targetMaxWidth, int targetMaxHeight);
   // Convert to 1-bit BMP (black and white only, no grays) for fast home screen rendering
   static bool jpegFileTo1BitBmpStreamWithSize(FsFile& jpegFile, Print& bmpOut, int targetMaxWidth, int targetMaxHeight);
+  static int planarRowBytes(const int width) { return (width + 7) / 8 * 2; }
+  // Whether the file name has an extension the converter handles: .jpg, .jpeg or .png in any case
+  static bool isSupportedImage(const char* path);
+  // Largest source image either decoder accepts
+  static constexpr int MAX_IMAGE_WIDTH = 2048;
+  static constexpr int MAX_IMAGE_HEIGHT = 3072;
+  // Default size of jpegFileToBmpStream(), the portrait screen
+  static constexpr int COVER_MAX_WIDTH = 480;
+  static constexpr int COVER_MAX_HEIGHT = 800;
 };
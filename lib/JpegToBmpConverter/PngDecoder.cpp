@@ -0,0 +1,351 @@
+#include "PngDecoder.h"
+
+#include <BufferPool.h>
+#include <HardwareSerial.h>
+#include <SdFat.h>
+
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+constexpr uint8_t SIGNATURE[PngDecoder::SIGNATURE_SIZE] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+
+constexpr uint32_t chunkType(const char* name) {
+  return static_cast<uint32_t>(name[0]) << 24 | static_cast<uint32_t>(name[1]) << 16 |
+         static_cast<uint32_t>(name[2]) << 8 | static_cast<uint32_t>(name[3]);
+}
+
+constexpr uint32_t IHDR = chunkType("IHDR");
+constexpr uint32_t PLTE = chunkType("PLTE");
+constexpr uint32_t TRNS = chunkType("tRNS");
+constexpr uint32_t IDAT = chunkType("IDAT");
+constexpr uint32_t IEND = chunkType("IEND");
+constexpr size_t CRC_SIZE = 4;
+
+uint32_t readBE32(const uint8_t* bytes) {
+  return static_cast<uint32_t>(bytes[0]) << 24 | static_cast<uint32_t>(bytes[1]) << 16 |
+         static_cast<uint32_t>(bytes[2]) << 8 | bytes[3];
+}
+
+// Same weights as the JPEG decoder
+uint8_t rgbToGray(const uint8_t r, const uint8_t g, const uint8_t b) { return (r * 25 + g * 50 + b * 25) / 100; }
+
+// Composites on white
+uint8_t blend(const uint8_t gray, const uint8_t alpha) { return (gray * alpha + 255 * (255 - alpha)) / 255; }
+
+uint8_t paeth(const uint8_t a, const uint8_t b, const uint8_t c) {
+  const int p = a + b - c;
+  const int pa = abs(p - a);
+  const int pb = abs(p - b);
+  const int pc = abs(p - c);
+  if (pa <= pb && pa <= pc) return a;
+  if (pb <= pc) return b;
+  return c;
+}
+}  // namespace
+
+bool PngDecoder::isSignature(const uint8_t* bytes) { return memcmp(bytes, SIGNATURE, SIGNATURE_SIZE) == 0; }
+
+PngDecoder::~PngDecoder() {
+  if (lines) {
+    BUFFER_POOL.release(lines);
+  }
+}
+
+bool PngDecoder::readChunkHeader(uint32_t& length, uint32_t& type) {
+  uint8_t header[8];
+  if (file.read(header, sizeof(header)) != sizeof(header)) {
+    return false;
+  }
+  length = readBE32(header);
+  type = readBE32(header + 4);
+  return true;
+}
+
+bool PngDecoder::begin(const int maxWidth, const int maxHeight) {
+  uint8_t signature[SIGNATURE_SIZE];
+  if (file.read(signature, SIGNATURE_SIZE) != SIGNATURE_SIZE || !isSignature(signature)) {
+    Serial.printf("[%lu] [PNG] Not a PNG file\n", millis());
+    return false;
+  }
+
+  bool hasHeader = false;
+  bool hasPalette = false;
+  uint32_t length;
+  uint32_t type;
+  while (true) {
+    if (!readChunkHeader(length, type)) {
+      Serial.printf("[%lu] [PNG] Unexpected end of file before the image data\n", millis());
+      return false;
+    }
+
+    if (type == IHDR) {
+      uint8_t ihdr[13];
+      if (length != sizeof(ihdr) || file.read(ihdr, sizeof(ihdr)) != sizeof(ihdr)) {
+        return false;
+      }
+      const uint32_t w = readBE32(ihdr);
+      const uint32_t h = readBE32(ihdr + 4);
+      const uint8_t bitDepth = ihdr[8];
+      const uint8_t interlace = ihdr[12];
+      colorType = static_cast<ColorType>(ihdr[9]);
+      Serial.printf("[%lu] [PNG] PNG dimensions: %ux%u, bit depth: %u, color type: %u\n", millis(), w, h, bitDepth,
+                    colorType);
+
+      if (bitDepth != 8 || interlace != 0) {
+        Serial.printf("[%lu] [PNG] Only 8-bit, non-interlaced images are supported\n", millis());
+        return false;
+      }
+      switch (colorType) {
+        case GRAY:
+        case PALETTE:
+          bytesPerPixel = 1;
+          break;
+        case GRAY_ALPHA:
+          bytesPerPixel = 2;
+          break;
+        case RGB:
+          bytesPerPixel = 3;
+          break;
+        case RGBA:
+          bytesPerPixel = 4;
+          break;
+        default:
+          Serial.printf("[%lu] [PNG] Unknown color type %u\n", millis(), colorType);
+          return false;
+      }
+      if (w == 0 || h == 0 || w > static_cast<uint32_t>(maxWidth) || h > static_cast<uint32_t>(maxHeight)) {
+        Serial.printf("[%lu] [PNG] Image too large (%ux%u), max supported: %dx%d\n", millis(), w, h, maxWidth,
+                      maxHeight);
+        return false;
+      }
+      width = static_cast<int>(w);
+      height = static_cast<int>(h);
+      stride = static_cast<size_t>(width) * bytesPerPixel;
+      hasHeader = true;
+    } else if (!hasHeader) {
+      Serial.printf("[%lu] [PNG] Missing IHDR chunk\n", millis());
+      return false;
+    } else if (type == PLTE && colorType == PALETTE) {
+      uint8_t rgb[3];
+      const uint32_t entries = length / 3;
+      if (entries > 256) {
+        return false;
+      }
+      for (uint32_t i = 0; i < entries; i++) {
+        if (file.read(rgb, 3) != 3) {
+          return false;
+        }
+        paletteGray[i] = rgbToGray(rgb[0], rgb[1], rgb[2]);
+      }
+      if (!file.seekCur(length - entries * 3)) {
+        return false;
+      }
+      hasPalette = true;
+    } else if (type == TRNS && colorType == PALETTE) {
+      // One alpha per palette entry, entries past the end are opaque
+      for (uint32_t i = 0; i < length && i < 256; i++) {
+        const int alpha = file.read();
+        if (alpha < 0) {
+          return false;
+        }
+        paletteGray[i] = blend(paletteGray[i], alpha);
+      }
+      if (length > 256 && !file.seekCur(length - 256)) {
+        return false;
+      }
+    } else if (type == TRNS && (colorType == GRAY || colorType == RGB)) {
+      // One 16-bit sample per channel
+      uint8_t color[6];
+      const uint32_t expected = colorType == GRAY ? 2 : 6;
+      if (length != expected || file.read(color, expected) != static_cast<int>(expected)) {
+        return false;
+      }
+      for (uint32_t i = 0; i < expected / 2; i++) {
+        transparentColor[i] = static_cast<uint16_t>(color[i * 2] << 8 | color[i * 2 + 1]);
+      }
+      hasTransparentColor = true;
+    } else if (type == IDAT) {
+      idatRemaining = length;
+      break;
+    } else if (type == IEND) {
+      Serial.printf("[%lu] [PNG] No image data\n", millis());
+      return false;
+    } else if (!file.seekCur(length)) {
+      return false;
+    }
+
+    if (!file.seekCur(CRC_SIZE)) {
+      return false;
+    }
+  }
+
+  if (colorType == PALETTE && !hasPalette) {
+    Serial.printf("[%lu] [PNG] Missing PLTE chunk\n", millis());
+    return false;
+  }
+
+  if (!inflater.begin(true)) {
+    return false;
+  }
+
+  const size_t lineSize = 1 + stride;
+  lines = BUFFER_POOL.lease(lineSize * 2 + width, "pngLines");
+  if (!lines) {
+    Serial.printf("[%lu] [PNG] Failed to allocate scanlines (%zu bytes)\n", millis(), lineSize * 2 + width);
+    return false;
+  }
+  current = lines;
+  previous = lines + lineSize;
+  grayRow = lines + lineSize * 2;
+  // The row above the first one is all zeros for the filters
+  memset(previous, 0, lineSize);
+  return true;
+}
+
+bool PngDecoder::readInput() {
+  // IDAT data may be split across several chunks, they have to follow each other
+  while (idatRemaining == 0) {
+    uint32_t length;
+    uint32_t type;
+    if (!file.seekCur(CRC_SIZE) || !readChunkHeader(length, type) || type != IDAT) {
+      return false;
+    }
+    idatRemaining = length;
+  }
+
+  const size_t toRead = idatRemaining < sizeof(input) ? idatRemaining : sizeof(input);
+  const int bytesRead = file.read(input, toRead);
+  if (bytesRead <= 0) {
+    return false;
+  }
+  idatRemaining -= bytesRead;
+  inputFilled = bytesRead;
+  inputCursor = 0;
+  return true;
+}
+
+bool PngDecoder::fillScanline() {
+  const size_t lineSize = 1 + stride;
+  size_t filled = 0;
+  while (filled < lineSize) {
+    if (pendingBytes > 0) {
+      const size_t toCopy = pendingBytes < lineSize - filled ? pendingBytes : lineSize - filled;
+      memcpy(current + filled, pending, toCopy);
+      filled += toCopy;
+      pending += toCopy;
+      pendingBytes -= toCopy;
+      continue;
+    }
+    if (streamDone) {
+      Serial.printf("[%lu] [PNG] Image data ended at row %d of %d\n", millis(), row, height);
+      return false;
+    }
+
+    if (inputCursor >= inputFilled && !inputEnded && !readInput()) {
+      inputEnded = true;
+      inputFilled = inputCursor = 0;
+    }
+    size_t inBytes = inputFilled - inputCursor;
+    const InflateStream::Status status =
+        inflater.inflate(input + inputCursor, inBytes, !inputEnded, pending, pendingBytes);
+    inputCursor += inBytes;
+    if (status == InflateStream::Status::Failed) {
+      return false;
+    }
+    streamDone = status == InflateStream::Status::Done;
+  }
+  return true;
+}
+
+void PngDecoder::unfilter() {
+  uint8_t* line = current + 1;
+  const uint8_t* above = previous + 1;
+  const size_t bpp = bytesPerPixel;
+
+  switch (current[0]) {
+    case 0:  // None
+      break;
+    case 1:  // Sub
+      for (size_t i = bpp; i < stride; i++) {
+        line[i] += line[i - bpp];
+      }
+      break;
+    case 2:  // Up
+      for (size_t i = 0; i < stride; i++) {
+        line[i] += above[i];
+      }
+      break;
+    case 3:  // Average
+      for (size_t i = 0; i < bpp; i++) {
+        line[i] += above[i] >> 1;
+      }
+      for (size_t i = bpp; i < stride; i++) {
+        line[i] += (line[i - bpp] + above[i]) >> 1;
+      }
+      break;
+    case 4:  // Paeth
+      for (size_t i = 0; i < bpp; i++) {
+        line[i] += above[i];
+      }
+      for (size_t i = bpp; i < stride; i++) {
+        line[i] += paeth(line[i - bpp], above[i], above[i - bpp]);
+      }
+      break;
+    default:
+      // Unknown filter, leave the bytes as they are rather than give up on the whole image
+      break;
+  }
+}
+
+void PngDecoder::toGray() {
+  const uint8_t* line = current + 1;
+  switch (colorType) {
+    case GRAY:
+      for (int x = 0; x < width; x++) {
+        grayRow[x] = hasTransparentColor && line[x] == transparentColor[0] ? 255 : line[x];
+      }
+      break;
+    case PALETTE:
+      for (int x = 0; x < width; x++) {
+        grayRow[x] = paletteGray[line[x]];
+      }
+      break;
+    case GRAY_ALPHA:
+      for (int x = 0; x < width; x++) {
+        grayRow[x] = blend(line[x * 2], line[x * 2 + 1]);
+      }
+      break;
+    case RGB:
+      for (int x = 0; x < width; x++) {
+        const uint8_t* pixel = line + x * 3;
+        const bool transparent = hasTransparentColor && pixel[0] == transparentColor[0] &&
+                                 pixel[1] == transparentColor[1] && pixel[2] == transparentColor[2];
+        grayRow[x] = transparent ? 255 : rgbToGray(pixel[0], pixel[1], pixel[2]);
+      }
+      break;
+    case RGBA:
+      for (int x = 0; x < width; x++) {
+        const uint8_t* pixel = line + x * 4;
+        grayRow[x] = blend(rgbToGray(pixel[0], pixel[1], pixel[2]), pixel[3]);
+      }
+      break;
+  }
+}
+
+const uint8_t* PngDecoder::nextRow() {
+  if (!lines || row >= height) {
+    return nullptr;
+  }
+  if (!fillScanline()) {
+    return nullptr;
+  }
+  unfilter();
+  toGray();
+
+  uint8_t* done = current;
+  current = previous;
+  previous = done;
+  row++;
+  return grayRow;
+}
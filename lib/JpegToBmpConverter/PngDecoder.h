@@ -0,0 +1,77 @@
+#pragma once
+
+#include <InflateStream.h>
+
+#include <cstddef>
+#include <cstdint>
+
+class FsFile;
+
+/**
+ * Streaming PNG decoder handing out one grayscale row at a time. Palette, gray, gray + alpha, RGB and RGBA images with
+ * 8 bits per channel are supported, transparency is composited on white. Interlaced images are not.
+ *
+ * Memory stays bounded by the image width: the IDAT data goes through an InflateStream and only the current and the
+ * previous scanline (needed to undo the filters) plus one gray row are kept, so a 2000x3000 RGBA image needs about
+ * 18 KB next to the inflate window.
+ */
+class PngDecoder {
+ public:
+  static constexpr size_t SIGNATURE_SIZE = 8;
+  static bool isSignature(const uint8_t* bytes);
+
+  explicit PngDecoder(FsFile& file) : file(file) {}
+  ~PngDecoder();
+  PngDecoder(const PngDecoder&) = delete;
+  PngDecoder& operator=(const PngDecoder&) = delete;
+
+  // Reads the chunks up to the image data, false when the file isn't a PNG this decoder can handle
+  bool begin(int maxWidth, int maxHeight);
+  int getWidth() const { return width; }
+  int getHeight() const { return height; }
+
+  // Decodes the next row, nullptr past the last row or when the data is broken. Valid until the next call.
+  const uint8_t* nextRow();
+
+ private:
+  enum ColorType : uint8_t { GRAY = 0, RGB = 2, PALETTE = 3, GRAY_ALPHA = 4, RGBA = 6 };
+
+  FsFile& file;
+  InflateStream inflater;
+  int width = 0;
+  int height = 0;
+  int row = 0;
+  ColorType colorType = GRAY;
+  uint8_t bytesPerPixel = 1;
+  size_t stride = 0;  // Bytes per scanline without the filter byte
+
+  // Palette entries as gray, composited with their tRNS alpha
+  uint8_t paletteGray[256] = {};
+  // tRNS of gray and RGB images: pixels of this color are transparent
+  bool hasTransparentColor = false;
+  uint16_t transparentColor[3] = {};
+
+  // Two scanlines of 1 + stride bytes (filter type, then pixels), and the gray output row
+  uint8_t* lines = nullptr;
+  uint8_t* current = nullptr;
+  uint8_t* previous = nullptr;
+  uint8_t* grayRow = nullptr;
+
+  // Compressed bytes of the IDAT chunk being read
+  uint8_t input[512];
+  size_t inputFilled = 0;
+  size_t inputCursor = 0;
+  uint32_t idatRemaining = 0;
+  bool inputEnded = false;
+
+  // Inflated bytes not yet copied into a scanline, a slice of the inflate window
+  const uint8_t* pending = nullptr;
+  size_t pendingBytes = 0;
+  bool streamDone = false;
+
+  bool readChunkHeader(uint32_t& length, uint32_t& type);
+  bool readInput();
+  bool fillScanline();
+  void unfilter();
+  void toGray();
+};
@@ -1,5 +1,6 @@
 #pragma once
 #include <cstdint>
+#include <mutex>
 #include <string>
 
 // Document matching method for KOReader sync
@@ -20,6 +21,8 @@ class KOReaderCredentialStore {
   std::string password;
   std::string serverUrl;                                            // Custom sync server URL (empty = default)
   DocumentMatchMethod matchMethod = DocumentMatchMethod::FILENAME;  // Default to filename for compatibility
+  // The loop and the render task both reach getInstance(), only one of them reads the file
+  std::once_flag loadOnce;
 
   // Private constructor for singleton
   KOReaderCredentialStore() = default;
@@ -32,8 +35,11 @@ class KOReaderCredentialStore {
   KOReaderCredentialStore(const KOReaderCredentialStore&) = delete;
   KOReaderCredentialStore& operator=(const KOReaderCredentialStore&) = delete;
 
-  // Get singleton instance
-  static KOReaderCredentialStore& getInstance() { return instance; }
+  // Get singleton instance, the credentials are read from the SD card on first use so booting doesn't wait for them
+  static KOReaderCredentialStore& getInstance() {
+    std::call_once(instance.loadOnce, [] { instance.loadFromFile(); });
+    return instance;
+  }
 
   // Save/load from SD card
   bool saveToFile() const;
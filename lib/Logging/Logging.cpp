@@ -0,0 +1,200 @@
+#include "Logging.h"
+
+#include <Arduino.h>
+
+#include <cstdarg>
+#include <cstdio>
+
+#if LOG_RING_SIZE > 0
+#include <SDCardManager.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+#include <cstring>
+#endif
+
+namespace logging {
+
+namespace {
+constexpr size_t MAX_MESSAGE_LENGTH = 192;
+
+#if LOG_RING_SIZE > 0
+constexpr char LOG_FILE[] = "/.crosspoint/log";
+constexpr char LOG_FILE_MAGIC[4] = {'C', 'P', 'L', 'G'};
+constexpr uint8_t LOG_FILE_VERSION = 1;
+// Start over once the log grows past this, it is meant for the last few sessions only
+constexpr uint32_t LOG_FILE_MAX_SIZE = 256 * 1024;
+
+// Record layout in the ring and in the log file: millis, level, module (3 chars, space padded), length, message
+struct __attribute__((packed)) RecordHeader {
+  uint32_t ms;
+  uint8_t level;
+  char module[3];
+  uint8_t length;
+};
+static_assert(LOG_RING_SIZE > sizeof(RecordHeader) + 255, "LOG_RING_SIZE too small for a single record");
+
+uint8_t ring[LOG_RING_SIZE];
+size_t ringHead = 0;  // Next byte to write
+size_t ringTail = 0;  // Oldest record
+size_t ringUsed = 0;
+uint32_t droppedRecords = 0;
+SemaphoreHandle_t ringMutex = nullptr;
+
+void ringCopyIn(const void* data, const size_t size) {
+  const auto* bytes = static_cast<const uint8_t*>(data);
+  const size_t first = size < LOG_RING_SIZE - ringHead ? size : LOG_RING_SIZE - ringHead;
+  memcpy(ring + ringHead, bytes, first);
+  memcpy(ring, bytes + first, size - first);
+  ringHead = (ringHead + size) % LOG_RING_SIZE;
+  ringUsed += size;
+}
+
+void ringDropOldest() {
+  RecordHeader header;
+  auto* bytes = reinterpret_cast<uint8_t*>(&header);
+  for (size_t i = 0; i < sizeof(header); i++) {
+    bytes[i] = ring[(ringTail + i) % LOG_RING_SIZE];
+  }
+  const size_t recordSize = sizeof(header) + header.length;
+  ringTail = (ringTail + recordSize) % LOG_RING_SIZE;
+  ringUsed -= recordSize;
+  droppedRecords++;
+}
+
+void ringAppend(const uint8_t level, const char* module, const char* message, const size_t length) {
+  if (!ringMutex) {
+    return;
+  }
+
+  RecordHeader header = {static_cast<uint32_t>(millis()), level, {' ', ' ', ' '}, static_cast<uint8_t>(length)};
+  for (size_t i = 0; i < sizeof(header.module) && module[i]; i++) {
+    header.module[i] = module[i];
+  }
+
+  xSemaphoreTake(ringMutex, portMAX_DELAY);
+  const size_t recordSize = sizeof(header) + header.length;
+  while (LOG_RING_SIZE - ringUsed < recordSize) {
+    ringDropOldest();
+  }
+  ringCopyIn(&header, sizeof(header));
+  ringCopyIn(message, header.length);
+  xSemaphoreGive(ringMutex);
+}
+#endif
+
+void emit(const uint8_t level, const char* module, const char* format, va_list args, const uint32_t suppressed) {
+  char message[MAX_MESSAGE_LENGTH];
+  int length = vsnprintf(message, sizeof(message), format, args);
+  if (length < 0) {
+    return;
+  }
+  if (static_cast<size_t>(length) >= sizeof(message)) {
+    length = sizeof(message) - 1;
+  }
+  if (suppressed > 0) {
+    const int extra = snprintf(message + length, sizeof(message) - length, " (%u similar suppressed)", suppressed);
+    if (extra > 0) {
+      length = length + extra < static_cast<int>(sizeof(message)) ? length + extra : sizeof(message) - 1;
+    }
+  }
+
+  Serial.printf("[%lu] [%s] %s\n", millis(), module, message);
+#if LOG_RING_SIZE > 0
+  ringAppend(level, module, message, static_cast<size_t>(length));
+#else
+  (void)level;
+#endif
+}
+}  // namespace
+
+void write(const uint8_t level, const char* module, const char* format, ...) {
+  va_list args;
+  va_start(args, format);
+  emit(level, module, format, args, 0);
+  va_end(args);
+}
+
+void writeRateLimited(RateLimit& limit, const unsigned long intervalMs, const uint8_t level, const char* module,
+                      const char* format, ...) {
+  const unsigned long now = millis();
+  if (limit.started && now - limit.lastMs < intervalMs) {
+    limit.suppressed++;
+    return;
+  }
+
+  const uint32_t suppressed = limit.suppressed;
+  limit.started = true;
+  limit.lastMs = now;
+  limit.suppressed = 0;
+
+  va_list args;
+  va_start(args, format);
+  emit(level, module, format, args, suppressed);
+  va_end(args);
+}
+
+void begin() {
+#if LOG_RING_SIZE > 0
+  if (!ringMutex) {
+    ringMutex = xSemaphoreCreateMutex();
+  }
+#endif
+}
+
+void flush() {
+#if LOG_RING_SIZE > 0
+  if (!ringMutex) {
+    return;
+  }
+
+  xSemaphoreTake(ringMutex, portMAX_DELAY);
+  if (ringUsed == 0) {
+    xSemaphoreGive(ringMutex);
+    return;
+  }
+
+  FsFile file = SdMan.open(LOG_FILE, O_RDWR | O_CREAT | O_APPEND);
+  if (file && file.size() > LOG_FILE_MAX_SIZE) {
+    file.close();
+    SdMan.remove(LOG_FILE);
+    file = SdMan.open(LOG_FILE, O_RDWR | O_CREAT | O_APPEND);
+  }
+  if (!file) {
+    // Keep the records, the next flush may have better luck
+    xSemaphoreGive(ringMutex);
+    return;
+  }
+
+  if (file.size() == 0) {
+    file.write(reinterpret_cast<const uint8_t*>(LOG_FILE_MAGIC), sizeof(LOG_FILE_MAGIC));
+    file.write(&LOG_FILE_VERSION, sizeof(LOG_FILE_VERSION));
+  }
+
+  if (droppedRecords > 0) {
+    char message[48];
+    const int length = snprintf(message, sizeof(message), "%u records dropped, ring full", droppedRecords);
+    const RecordHeader header = {static_cast<uint32_t>(millis()), LOG_LEVEL_WARN, {'L', 'O', 'G'},
+                                 static_cast<uint8_t>(length)};
+    file.write(reinterpret_cast<const uint8_t*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const uint8_t*>(message), length);
+    droppedRecords = 0;
+  }
+
+  // One write for each contiguous part of the ring
+  if (ringTail < ringHead) {
+    file.write(ring + ringTail, ringUsed);
+  } else {
+    file.write(ring + ringTail, LOG_RING_SIZE - ringTail);
+    file.write(ring, ringHead);
+  }
+  file.close();
+
+  ringHead = 0;
+  ringTail = 0;
+  ringUsed = 0;
+  xSemaphoreGive(ringMutex);
+#endif
+}
+
+}  // namespace logging
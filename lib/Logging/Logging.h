@@ -0,0 +1,108 @@
+#pragma once
+#include <cstdint>
+
+/**
+ * Logging.h
+ *
+ * Leveled logging with the usual "[millis] [MOD] message" format. Levels are resolved at compile time per module:
+ * LOG_D(SCT, "Page %d processed", n) compiles to nothing unless LOG_LEVEL_SCT is LOG_LEVEL_DEBUG, so the arguments
+ * are not even evaluated. LOG_LEVEL sets the default, a module can be overridden with e.g. -DLOG_LEVEL_GFX=4.
+ *
+ * LOG_RATE_LIMITED lets one message per interval through from a call site and reports how many were dropped.
+ *
+ * With LOG_RING_SIZE set, messages are also kept in a RAM ring of binary records. logging::flush() appends them to
+ * /.crosspoint/log in one write, see scripts/decode_log.py. Call it where no other task is using the SD card.
+ */
+
+#define LOG_LEVEL_NONE 0
+#define LOG_LEVEL_ERROR 1
+#define LOG_LEVEL_WARN 2
+#define LOG_LEVEL_INFO 3
+#define LOG_LEVEL_DEBUG 4
+
+#ifndef LOG_LEVEL
+#define LOG_LEVEL LOG_LEVEL_INFO
+#endif
+
+#ifndef LOG_RING_SIZE
+#define LOG_RING_SIZE 0
+#endif
+
+// Modules using the LOG_ macros, each defaults to LOG_LEVEL
+#ifndef LOG_LEVEL_BAK
+#define LOG_LEVEL_BAK LOG_LEVEL
+#endif
+#ifndef LOG_LEVEL_BOT
+#define LOG_LEVEL_BOT LOG_LEVEL
+#endif
+#ifndef LOG_LEVEL_BUF
+#define LOG_LEVEL_BUF LOG_LEVEL
+#endif
+#ifndef LOG_LEVEL_EHP
+#define LOG_LEVEL_EHP LOG_LEVEL
+#endif
+#ifndef LOG_LEVEL_ERS
+#define LOG_LEVEL_ERS LOG_LEVEL
+#endif
+#ifndef LOG_LEVEL_GFX
+#define LOG_LEVEL_GFX LOG_LEVEL
+#endif
+#ifndef LOG_LEVEL_LOG
+#define LOG_LEVEL_LOG LOG_LEVEL
+#endif
+#ifndef LOG_LEVEL_PGE
+#define LOG_LEVEL_PGE LOG_LEVEL
+#endif
+#ifndef LOG_LEVEL_RND
+#define LOG_LEVEL_RND LOG_LEVEL
+#endif
+#ifndef LOG_LEVEL_RSM
+#define LOG_LEVEL_RSM LOG_LEVEL
+#endif
+#ifndef LOG_LEVEL_SCT
+#define LOG_LEVEL_SCT LOG_LEVEL
+#endif
+#ifndef LOG_LEVEL_ZIP
+#define LOG_LEVEL_ZIP LOG_LEVEL
+#endif
+
+namespace logging {
+
+struct RateLimit {
+  unsigned long lastMs;
+  uint32_t suppressed;
+  bool started;
+};
+
+void write(uint8_t level, const char* module, const char* format, ...) __attribute__((format(printf, 3, 4)));
+void writeRateLimited(RateLimit& limit, unsigned long intervalMs, uint8_t level, const char* module,
+                      const char* format, ...) __attribute__((format(printf, 5, 6)));
+
+// Creates the ring's mutex, call first in setup() before any other task exists. Records logged before it only go to
+// the serial port. No-op without LOG_RING_SIZE.
+void begin();
+
+// Appends buffered records to /.crosspoint/log, no-op without LOG_RING_SIZE
+void flush();
+
+}  // namespace logging
+
+#define LOG_AT(level, module, ...)                        \
+  do {                                                    \
+    if constexpr (LOG_LEVEL_##module >= (level)) {        \
+      logging::write((level), #module, __VA_ARGS__);      \
+    }                                                     \
+  } while (0)
+
+#define LOG_E(module, ...) LOG_AT(LOG_LEVEL_ERROR, module, __VA_ARGS__)
+#define LOG_W(module, ...) LOG_AT(LOG_LEVEL_WARN, module, __VA_ARGS__)
+#define LOG_I(module, ...) LOG_AT(LOG_LEVEL_INFO, module, __VA_ARGS__)
+#define LOG_D(module, ...) LOG_AT(LOG_LEVEL_DEBUG, module, __VA_ARGS__)
+
+#define LOG_RATE_LIMITED(level, module, intervalMs, ...)                                     \
+  do {                                                                                       \
+    if constexpr (LOG_LEVEL_##module >= (level)) {                                           \
+      static logging::RateLimit logRateLimit = {};                                           \
+      logging::writeRateLimited(logRateLimit, (intervalMs), (level), #module, __VA_ARGS__);  \
+    }                                                                                        \
+  } while (0)
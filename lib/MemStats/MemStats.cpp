@@ -0,0 +1,168 @@
+#include "MemStats.h"
+
+#include <Arduino.h>
+#include <SDCardManager.h>
+
+#include <cstring>
+
+namespace memstats {
+
+namespace {
+constexpr char STATS_FILE[] = "/.crosspoint/memstats.bin";
+constexpr char STATS_FILE_MAGIC[4] = {'C', 'P', 'M', 'S'};
+constexpr uint8_t STATS_FILE_VERSION = 1;
+constexpr uint16_t FILE_SLOTS = 128;
+constexpr uint8_t RING_SAMPLES = 16;
+constexpr uint8_t MAX_TASKS = 24;
+
+// File layout: header, then FILE_SLOTS samples written round robin starting at `next`
+struct __attribute__((packed)) FileHeader {
+  char magic[4];
+  uint8_t version;
+  uint16_t slots;
+  uint16_t next;
+  uint16_t filled;
+};
+
+Sample ring[RING_SAMPLES];
+uint8_t ringHead = 0;  // Next slot to write
+uint8_t pending = 0;   // Samples not yet in the file, the newest ones before ringHead
+
+TaskStats tasks[MAX_TASKS];
+size_t tasksUsed = 0;
+
+// ESP-IDF reports stack high water marks in bytes
+uint16_t stackFree(TaskHandle_t handle) {
+  const UBaseType_t bytes = uxTaskGetStackHighWaterMark(handle);
+  return bytes < NO_STACK ? static_cast<uint16_t>(bytes) : NO_STACK - 1;
+}
+
+void updateTask(const char* name, const uint16_t bytes) {
+  TaskStats* entry = nullptr;
+  for (size_t i = 0; i < tasksUsed; i++) {
+    if (strncmp(tasks[i].name, name, NAME_LENGTH - 1) == 0) {
+      entry = &tasks[i];
+      break;
+    }
+  }
+  if (!entry) {
+    if (tasksUsed == MAX_TASKS) {
+      return;
+    }
+    entry = &tasks[tasksUsed++];
+    strncpy(entry->name, name, NAME_LENGTH - 1);
+    entry->name[NAME_LENGTH - 1] = '\0';
+    entry->minStackFree = bytes;
+  }
+  if (bytes < entry->minStackFree) {
+    entry->minStackFree = bytes;
+  }
+  entry->samples++;
+}
+
+bool readHeader(FsFile& file, FileHeader& header) {
+  file.seek(0);
+  return file.read(&header, sizeof(header)) == static_cast<int>(sizeof(header)) &&
+         memcmp(header.magic, STATS_FILE_MAGIC, sizeof(header.magic)) == 0 && header.version == STATS_FILE_VERSION &&
+         header.slots == FILE_SLOTS && header.next < FILE_SLOTS && header.filled <= FILE_SLOTS;
+}
+}  // namespace
+
+void record(const Event event, const char* activity, TaskHandle_t task) {
+  Sample& sample = ring[ringHead];
+  sample.ms = millis();
+  sample.freeHeap = ESP.getFreeHeap();
+  sample.largestFreeBlock = ESP.getMaxAllocHeap();
+  sample.minFreeHeap = ESP.getMinFreeHeap();
+  sample.stackFree = task ? stackFree(task) : NO_STACK;
+  sample.event = event;
+  strncpy(sample.activity, activity, NAME_LENGTH - 1);
+  sample.activity[NAME_LENGTH - 1] = '\0';
+
+  ringHead = (ringHead + 1) % RING_SAMPLES;
+  if (pending < RING_SAMPLES) {
+    pending++;
+  }
+
+  if (task) {
+    updateTask(pcTaskGetName(task), sample.stackFree);
+  }
+  updateTask("loop", stackFree(xTaskGetCurrentTaskHandle()));
+}
+
+void flush() {
+  if (pending == 0) {
+    return;
+  }
+
+  FsFile file = SdMan.open(STATS_FILE, O_RDWR | O_CREAT);
+  if (!file) {
+    // Keep the samples, the next flush may have better luck
+    return;
+  }
+
+  FileHeader header;
+  if (!readHeader(file, header)) {
+    memcpy(header.magic, STATS_FILE_MAGIC, sizeof(header.magic));
+    header.version = STATS_FILE_VERSION;
+    header.slots = FILE_SLOTS;
+    header.next = 0;
+    header.filled = 0;
+    // Written up front, samples are only ever written at or before the end of the file
+    file.seek(0);
+    file.write(reinterpret_cast<const uint8_t*>(&header), sizeof(header));
+  }
+
+  for (uint8_t i = 0; i < pending; i++) {
+    const Sample& sample = ring[(ringHead + RING_SAMPLES - pending + i) % RING_SAMPLES];
+    file.seek(sizeof(header) + header.next * sizeof(Sample));
+    file.write(reinterpret_cast<const uint8_t*>(&sample), sizeof(sample));
+    header.next = (header.next + 1) % FILE_SLOTS;
+    if (header.filled < FILE_SLOTS) {
+      header.filled++;
+    }
+  }
+  file.seek(0);
+  file.write(reinterpret_cast<const uint8_t*>(&header), sizeof(header));
+  file.close();
+  pending = 0;
+}
+
+bool forEachStoredSample(const std::function<void(const Sample&)>& fn) {
+  flush();
+
+  FsFile file = SdMan.open(STATS_FILE, O_RDONLY);
+  if (!file) {
+    return false;
+  }
+  FileHeader header;
+  if (!readHeader(file, header)) {
+    file.close();
+    return false;
+  }
+
+  const uint16_t first = header.filled < FILE_SLOTS ? 0 : header.next;
+  for (uint16_t i = 0; i < header.filled; i++) {
+    Sample sample;
+    file.seek(sizeof(header) + ((first + i) % FILE_SLOTS) * sizeof(Sample));
+    if (file.read(&sample, sizeof(sample)) != static_cast<int>(sizeof(sample))) {
+      break;
+    }
+    sample.activity[NAME_LENGTH - 1] = '\0';
+    fn(sample);
+  }
+  file.close();
+  return true;
+}
+
+size_t taskCount() { return tasksUsed; }
+
+const TaskStats& task(const size_t index) { return tasks[index]; }
+
+const char* eventName(const uint8_t event) {
+  static const char* names[] = {"enter", "exit", "periodic"};
+  static_assert(sizeof(names) / sizeof(names[0]) == EVENT_COUNT, "Event names out of sync");
+  return event < EVENT_COUNT ? names[event] : "unknown";
+}
+
+}  // namespace memstats
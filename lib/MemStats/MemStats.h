@@ -0,0 +1,62 @@
+#pragma once
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+/**
+ * MemStats.h
+ *
+ * Heap and stack headroom samples, taken when an activity is entered or exited and every SAMPLE_INTERVAL_MS while
+ * one is running. Each sample has the free heap, the largest free block, the all time minimum and the stack high
+ * water mark of the task drawing the activity. The lowest stack headroom seen per task is kept separately by task
+ * name, the loop task is tracked as "loop".
+ *
+ * Samples go to a small RAM ring, flush() moves them into a fixed-size ring file on the SD card so the history
+ * survives a crash or reboot. The web server serves both at /api/memory.
+ *
+ * All calls come from the loop task (activity hooks, the main loop, web server handlers), so there is no locking.
+ */
+namespace memstats {
+
+enum Event : uint8_t { ACTIVITY_ENTER = 0, ACTIVITY_EXIT = 1, PERIODIC = 2, EVENT_COUNT };
+
+constexpr unsigned long SAMPLE_INTERVAL_MS = 30000;
+// Unknown stack headroom, e.g. before the render task is started
+constexpr uint16_t NO_STACK = 0xFFFF;
+constexpr size_t NAME_LENGTH = 29;
+
+struct __attribute__((packed)) Sample {
+  uint32_t ms;
+  uint32_t freeHeap;
+  uint32_t largestFreeBlock;
+  uint32_t minFreeHeap;
+  uint16_t stackFree;  // Bytes never used on the task's stack
+  uint8_t event;
+  char activity[NAME_LENGTH];
+};
+static_assert(sizeof(Sample) == 48, "Sample size is part of the file format");
+
+struct TaskStats {
+  char name[NAME_LENGTH];
+  uint32_t minStackFree;
+  uint32_t samples;
+};
+
+// task draws the activity's frames, nullptr when there is none
+void record(Event event, const char* activity, TaskHandle_t task);
+
+// Writes pending samples to the ring file, only call while no other task is using the SD card
+void flush();
+
+// Flushes, then calls fn for every sample in the ring file, oldest first
+bool forEachStoredSample(const std::function<void(const Sample&)>& fn);
+
+size_t taskCount();
+const TaskStats& task(size_t index);
+
+const char* eventName(uint8_t event);
+
+}  // namespace memstats
@@ -0,0 +1,61 @@
+#include "PackBits.h"
+
+#include <algorithm>
+
+namespace packbits {
+
+size_t pack(const uint8_t* data, const size_t size, uint8_t* out) {
+  size_t written = 0;
+  encode(data, size, [out, &written](const uint8_t* bytes, const size_t count) {
+    memcpy(out + written, bytes, count);
+    written += count;
+  });
+  return written;
+}
+
+size_t Decoder::decode(const uint8_t*& in, const uint8_t* const inEnd, uint8_t* out, const size_t outSize) {
+  size_t written = 0;
+  while (written < outSize) {
+    if (repeatValuePending) {
+      if (in == inEnd) {
+        break;
+      }
+      repeatValue = *in++;
+      repeatValuePending = false;
+    }
+
+    if (repeatLeft > 0) {
+      const size_t count = std::min<size_t>(repeatLeft, outSize - written);
+      memset(out + written, repeatValue, count);
+      written += count;
+      repeatLeft -= count;
+      continue;
+    }
+
+    if (literalLeft > 0) {
+      const size_t count = std::min<size_t>({literalLeft, outSize - written, static_cast<size_t>(inEnd - in)});
+      if (count == 0) {
+        break;
+      }
+      memcpy(out + written, in, count);
+      in += count;
+      written += count;
+      literalLeft -= count;
+      continue;
+    }
+
+    if (in == inEnd) {
+      break;
+    }
+    const uint8_t control = *in++;
+    if (control < 128) {
+      literalLeft = control + 1;
+    } else if (control > 128) {
+      repeatLeft = 257 - control;
+      repeatValuePending = true;
+    }
+  }
+  return written;
+}
+
+}  // namespace packbits
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+/**
+ * PackBits.h
+ *
+ * The run-length coding used for frame buffers and XTC pages: a control byte n below 128 is followed by n + 1 literal
+ * bytes, one above 128 by a single byte repeated 257 - n times, 128 is ignored. The white margins and line gaps of a
+ * page shrink to 2 bytes per 128, and decoding is a memset or memcpy per packet.
+ *
+ * encode() is the one encoder, pack() runs it into a buffer and the callers writing to a file pass their writer.
+ * unpack() reads packets from anything with read(uint8_t*, size_t), Decoder expands a stream that arrives in chunks.
+ */
+namespace packbits {
+
+// Runs and literals are at most this long
+constexpr size_t MAX_PACKET = 128;
+
+// Most encode() emits for size bytes, reached by data without a run of 3: a control byte per 128 literals
+constexpr size_t bound(const size_t size) { return size + (size + MAX_PACKET - 1) / MAX_PACKET; }
+
+// Codes data as a sequence of emit(const uint8_t* bytes, size_t count) calls
+template <typename Emit>
+void encode(const uint8_t* data, const size_t size, Emit&& emit) {
+  size_t i = 0;
+  while (i < size) {
+    size_t run = 1;
+    while (i + run < size && run < MAX_PACKET && data[i + run] == data[i]) {
+      run++;
+    }
+    // Pairs stay in the literals, a literal byte between two of them would cost more than they save
+    if (run >= 3) {
+      const uint8_t packet[2] = {static_cast<uint8_t>(257 - run), data[i]};
+      emit(packet, sizeof(packet));
+      i += run;
+      continue;
+    }
+
+    // Literals up to where the next run of 3 starts
+    const size_t start = i;
+    while (i < size && i - start < MAX_PACKET && !(i + 2 < size && data[i] == data[i + 1] && data[i] == data[i + 2])) {
+      i++;
+    }
+    const auto control = static_cast<uint8_t>(i - start - 1);
+    emit(&control, 1);
+    emit(data + start, i - start);
+  }
+}
+
+// Codes data into out, which must hold bound(size) bytes, and returns the bytes written
+size_t pack(const uint8_t* data, size_t size, uint8_t* out);
+
+// Codes data into writer, anything with write(const uint8_t*, size_t)
+template <typename Writer>
+void pack(Writer& writer, const uint8_t* data, const size_t size) {
+  encode(data, size, [&writer](const uint8_t* bytes, const size_t count) { writer.write(bytes, count); });
+}
+
+// Fills out with exactly size bytes read from reader, anything with read(uint8_t*, size_t). False when the input
+// ends early or a packet runs past size.
+template <typename Reader>
+bool unpack(Reader& reader, uint8_t* out, const size_t size) {
+  size_t filled = 0;
+  while (filled < size) {
+    uint8_t control;
+    if (reader.read(&control, 1) != 1) {
+      return false;
+    }
+    if (control < 128) {
+      const size_t count = control + 1;
+      if (filled + count > size || reader.read(out + filled, count) != count) {
+        return false;
+      }
+      filled += count;
+    } else if (control > 128) {
+      const size_t count = 257 - control;
+      uint8_t value;
+      if (filled + count > size || reader.read(&value, 1) != 1) {
+        return false;
+      }
+      memset(out + filled, value, count);
+      filled += count;
+    }
+  }
+  return true;
+}
+
+// Expands a packed stream fed in pieces, for input read in chunks whose packets don't line up with the chunk ends
+class Decoder {
+ public:
+  // Expands from in up to inEnd into out until either runs out, advancing in. Returns the bytes written, packets can
+  // be split across calls.
+  size_t decode(const uint8_t*& in, const uint8_t* inEnd, uint8_t* out, size_t outSize);
+
+ private:
+  uint16_t literalLeft = 0;
+  uint16_t repeatLeft = 0;
+  uint8_t repeatValue = 0;
+  bool repeatValuePending = false;  // The control byte came at the end of the last input
+};
+
+}  // namespace packbits
@@ -0,0 +1,77 @@
+#include "BootTimeline.h"
+
+#include <Arduino.h>
+#include <Logging.h>
+
+namespace boottimeline {
+
+namespace {
+// Kept in RTC slow memory across deep sleep, cleared on power on
+RTC_DATA_ATTR Timeline timelines[2];  // Current, previous
+RTC_DATA_ATTR uint32_t bootCount;
+
+constexpr const char* PHASE_NAMES[PHASE_COUNT] = {"gpio", "serialPort", "bufferPool", "renderTask", "sdCard",
+                                                  "settings", "powerButton", "display", "resume", "fonts",
+                                                  "bootScreen", "appState", "firstActivity", "firstFrame"};
+
+void print() {
+  const Timeline& timeline = timelines[0];
+  LOG_I(BOT, "Boot %lu (%s), first frame %lu us after setup", static_cast<unsigned long>(timeline.boot),
+        timeline.fromSleep ? "wakeup" : "power on",
+        static_cast<unsigned long>(timeline.phaseEndUs[FIRST_FRAME] - timeline.setupUs));
+  for (uint8_t i = 0; i < PHASE_COUNT; i++) {
+    const auto phase = static_cast<Phase>(i);
+    if (timeline.phaseEndUs[phase] != 0) {
+      LOG_I(BOT, "  %-14s %8lu us, done at %8lu us", PHASE_NAMES[phase],
+            static_cast<unsigned long>(phaseUs(timeline, phase)),
+            static_cast<unsigned long>(timeline.phaseEndUs[phase] - timeline.setupUs));
+    }
+  }
+}
+}  // namespace
+
+void begin(const uint32_t setupUs, const bool fromSleep) {
+  timelines[1] = timelines[0];
+  timelines[0] = {};
+  timelines[0].boot = ++bootCount;
+  timelines[0].fromSleep = fromSleep;
+  timelines[0].setupUs = setupUs;
+  mark(HAL_GPIO);
+}
+
+void mark(const Phase phase) {
+  Timeline& timeline = timelines[0];
+  if (phase >= PHASE_COUNT || timeline.boot == 0 || timeline.phaseEndUs[phase] != 0) {
+    return;
+  }
+  // 0 means the phase didn't run
+  const uint32_t now = micros();
+  timeline.phaseEndUs[phase] = now != 0 ? now : 1;
+
+  if (phase == FIRST_FRAME) {
+    print();
+  }
+}
+
+const Timeline& current() { return timelines[0]; }
+
+const Timeline& previous() { return timelines[1]; }
+
+uint32_t phaseUs(const Timeline& timeline, const Phase phase) {
+  if (phase >= PHASE_COUNT || timeline.phaseEndUs[phase] == 0) {
+    return 0;
+  }
+  // Measured from the end of the last phase that ran before it
+  uint32_t startUs = timeline.setupUs;
+  for (uint8_t i = phase; i > 0; i--) {
+    if (timeline.phaseEndUs[i - 1] != 0) {
+      startUs = timeline.phaseEndUs[i - 1];
+      break;
+    }
+  }
+  return timeline.phaseEndUs[phase] - startUs;
+}
+
+const char* phaseName(const Phase phase) { return phase < PHASE_COUNT ? PHASE_NAMES[phase] : "unknown"; }
+
+}  // namespace boottimeline
@@ -0,0 +1,54 @@
+#pragma once
+#include <cstdint>
+
+/**
+ * BootTimeline.h
+ *
+ * Microsecond stamps for the phases of setup(), from the first line of setup() to the first frame the render task
+ * draws. mark(phase) stamps the end of a phase, phases that didn't run on this boot (e.g. the power button check on a
+ * cold boot) stay 0. The timeline is printed once when the first frame is done.
+ *
+ * Unlike the perf histograms this is always built: it costs a few stamps per boot. The current and the previous
+ * timeline live in RTC memory, so they survive deep sleep and the web server can report both at /api/perf.
+ */
+namespace boottimeline {
+
+enum Phase : uint8_t {
+  HAL_GPIO = 0,
+  SERIAL_PORT = 1,  // Waiting for USB serial, only with USB connected
+  BUFFERS = 2,
+  RENDER_TASK = 3,
+  SD_CARD = 4,
+  SETTINGS_FILE = 5,
+  POWER_BUTTON = 6,  // Press duration check, only when woken by the power button
+  DISPLAY = 7,
+  RESUME = 8,        // Resume snapshot shown, only when woken from a book
+  FONTS = 9,
+  BOOT_SCREEN = 10,  // Splash drawn and refreshed, skipped after a resume
+  STATE_FILE = 11,
+  FIRST_ACTIVITY = 12,
+  FIRST_FRAME = 13,  // The render task finished the first activity's first frame
+  PHASE_COUNT
+};
+
+struct Timeline {
+  uint32_t boot;     // Boots since power on, starting at 1
+  bool fromSleep;    // Woken by the power button rather than powered on or reset
+  uint32_t setupUs;  // micros() when setup() started
+  uint32_t phaseEndUs[PHASE_COUNT];
+};
+
+// Call first thing in setup(), after gpio.begin() so the wakeup reason is known. Stamps the HAL_GPIO phase.
+void begin(uint32_t setupUs, bool fromSleep);
+// Stamps the end of phase, only the first mark of a phase counts. Safe from the render task.
+void mark(Phase phase);
+
+const Timeline& current();
+// Timeline of the boot before this one, boot is 0 when there was none since power on
+const Timeline& previous();
+// Time the phase took, 0 when it didn't run
+uint32_t phaseUs(const Timeline& timeline, Phase phase);
+
+const char* phaseName(Phase phase);
+
+}  // namespace boottimeline
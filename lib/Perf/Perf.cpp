@@ -0,0 +1,80 @@
+#include "Perf.h"
+
+#if CROSSPOINT_PERF
+#include <cstring>
+
+namespace perf {
+
+namespace {
+// Written from both the main loop and activity render tasks. Increments aren't atomic, an occasional lost sample is
+// fine for diagnostics and keeps the hot path free of locks.
+Histogram histograms[METRIC_COUNT];
+uint64_t counters[COUNTER_COUNT];
+
+constexpr const char* METRIC_NAMES[METRIC_COUNT] = {"sdRead", "inflate", "xmlParse", "lineBreak",
+                                                    "raster", "refresh", "pageTurn", "frame"};
+constexpr const char* COUNTER_NAMES[COUNTER_COUNT] = {"sdBytesRead", "inflatedBytes", "pagesLaidOut"};
+
+uint8_t bucketFor(uint32_t us) {
+  uint8_t bucket = 0;
+  while (us > 1 && bucket < HISTOGRAM_BUCKETS - 1) {
+    us >>= 1;
+    bucket++;
+  }
+  return bucket;
+}
+}  // namespace
+
+void record(const Metric metric, const uint32_t us) {
+  if (metric >= METRIC_COUNT) {
+    return;
+  }
+  auto& h = histograms[metric];
+  h.count++;
+  h.totalUs += us;
+  if (us > h.maxUs) {
+    h.maxUs = us;
+  }
+  h.buckets[bucketFor(us)]++;
+}
+
+void count(const Counter counter, const uint32_t n) {
+  if (counter < COUNTER_COUNT) {
+    counters[counter] += n;
+  }
+}
+
+void reset() {
+  memset(histograms, 0, sizeof(histograms));
+  memset(counters, 0, sizeof(counters));
+}
+
+const Histogram& histogram(const Metric metric) { return histograms[metric < METRIC_COUNT ? metric : 0]; }
+
+uint64_t counterValue(const Counter counter) { return counter < COUNTER_COUNT ? counters[counter] : 0; }
+
+uint32_t percentileUs(const Metric metric, const uint8_t percentile) {
+  const auto& h = histogram(metric);
+  if (h.count == 0) {
+    return 0;
+  }
+
+  // Rank of the sample we're after, rounded up so p100 is the last sample
+  const uint64_t rank = (static_cast<uint64_t>(h.count) * percentile + 99) / 100;
+  uint64_t seen = 0;
+  for (uint8_t i = 0; i < HISTOGRAM_BUCKETS; i++) {
+    seen += h.buckets[i];
+    if (seen >= rank && seen > 0) {
+      const uint32_t upperBound = (2u << i) - 1;
+      return upperBound < h.maxUs ? upperBound : h.maxUs;
+    }
+  }
+  return h.maxUs;
+}
+
+const char* metricName(const Metric metric) { return metric < METRIC_COUNT ? METRIC_NAMES[metric] : "unknown"; }
+
+const char* counterName(const Counter counter) { return counter < COUNTER_COUNT ? COUNTER_NAMES[counter] : "unknown"; }
+
+}  // namespace perf
+#endif
@@ -0,0 +1,77 @@
+#pragma once
+#include <Arduino.h>
+
+#include <cstdint>
+
+/**
+ * Perf.h
+ *
+ * Timing for the reading hot paths. PERF_SCOPE(metric) times the enclosing block into a fixed-size histogram,
+ * PERF_RECORD(metric, us) adds a duration measured elsewhere and PERF_COUNT(counter, n) bumps a counter. Everything
+ * lives in static RAM (under 1KB) and survives activity changes, the web server reports it at /api/perf.
+ *
+ * Only built when CROSSPOINT_PERF is set (dev builds), otherwise the macros expand to nothing and neither the
+ * histograms nor the code recording them are compiled in.
+ */
+#if CROSSPOINT_PERF
+namespace perf {
+
+enum Metric : uint8_t {
+  SD_READ = 0,     // Bulk reads from the SD card on the page path (zip chunks, chapter html, section pages)
+  INFLATE = 1,     // tinfl_decompress calls
+  XML_PARSE = 2,   // XML_ParseBuffer calls, includes layout triggered from the element callbacks
+  LINE_BREAK = 3,  // ParsedText::layoutAndExtractLines
+  RASTER = 4,      // Page::render into the frame buffer
+  REFRESH = 5,     // Panel refreshes, BW and grayscale
+  PAGE_TURN = 6,   // Button press to the new page being shown
+  FRAME = 7,       // Frame request to the render task having drawn it
+  METRIC_COUNT
+};
+
+enum Counter : uint8_t { SD_BYTES_READ = 0, INFLATED_BYTES = 1, PAGES_LAID_OUT = 2, COUNTER_COUNT };
+
+// Bucket i holds durations in [2^i, 2^(i+1)) us, the last bucket everything from ~8s up
+constexpr uint8_t HISTOGRAM_BUCKETS = 24;
+
+struct Histogram {
+  uint32_t count;
+  uint32_t maxUs;
+  uint64_t totalUs;
+  uint32_t buckets[HISTOGRAM_BUCKETS];
+};
+
+void record(Metric metric, uint32_t us);
+void count(Counter counter, uint32_t n);
+void reset();
+
+const Histogram& histogram(Metric metric);
+uint64_t counterValue(Counter counter);
+// Upper bound of the bucket holding the given percentile, clamped to the slowest sample
+uint32_t percentileUs(Metric metric, uint8_t percentile);
+
+const char* metricName(Metric metric);
+const char* counterName(Counter counter);
+
+class ScopedTimer {
+  const Metric metric;
+  const unsigned long startUs;
+
+ public:
+  explicit ScopedTimer(const Metric metric) : metric(metric), startUs(micros()) {}
+  ~ScopedTimer() { record(metric, micros() - startUs); }
+  ScopedTimer(const ScopedTimer&) = delete;
+  ScopedTimer& operator=(const ScopedTimer&) = delete;
+};
+
+}  // namespace perf
+
+#define PERF_CONCAT_INNER(a, b) a##b
+#define PERF_CONCAT(a, b) PERF_CONCAT_INNER(a, b)
+#define PERF_SCOPE(metric) const perf::ScopedTimer PERF_CONCAT(perfScope, __LINE__)(perf::metric)
+#define PERF_RECORD(metric, us) perf::record(perf::metric, us)
+#define PERF_COUNT(counter, n) perf::count(perf::counter, n)
+#else
+#define PERF_SCOPE(metric)
+#define PERF_RECORD(metric, us)
+#define PERF_COUNT(counter, n)
+#endif
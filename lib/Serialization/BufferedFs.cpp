@@ -0,0 +1,116 @@
+#include "BufferedFs.h"
+
+#include <cstring>
+
+BufferedFsReader::BufferedFsReader(FsFile& file)
+    : file(file), windowStart(file.position()), filePosition(file.position()) {}
+
+bool BufferedFsReader::fill(const uint32_t position) {
+  const uint32_t alignedStart = position - position % BUFFER_SIZE;
+  if (filePosition != alignedStart) {
+    if (!file.seek(alignedStart)) {
+      return false;
+    }
+    filePosition = alignedStart;
+  }
+
+  const int bytesRead = file.read(buffer, BUFFER_SIZE);
+  windowStart = alignedStart;
+  windowLength = bytesRead > 0 ? bytesRead : 0;
+  cursor = position - alignedStart;
+  filePosition += windowLength;
+  return cursor < windowLength;
+}
+
+size_t BufferedFsReader::read(uint8_t* dst, size_t size) {
+  size_t total = 0;
+  while (size > 0) {
+    if (cursor >= windowLength) {
+      const uint32_t readPosition = position();
+      if (size >= BUFFER_SIZE) {
+        // Nothing to gain from the window, read straight into the destination
+        if (filePosition != readPosition && !file.seek(readPosition)) {
+          break;
+        }
+        const int bytesRead = file.read(dst, size);
+        const uint32_t count = bytesRead > 0 ? bytesRead : 0;
+        filePosition = readPosition + count;
+        windowStart = filePosition;
+        windowLength = 0;
+        cursor = 0;
+        return total + count;
+      }
+      if (!fill(readPosition)) {
+        break;
+      }
+    }
+
+    const size_t chunk = size < windowLength - cursor ? size : windowLength - cursor;
+    memcpy(dst, buffer + cursor, chunk);
+    cursor += chunk;
+    dst += chunk;
+    size -= chunk;
+    total += chunk;
+  }
+  return total;
+}
+
+bool BufferedFsReader::seek(const uint32_t position) {
+  if (position >= windowStart && position <= windowStart + windowLength) {
+    cursor = position - windowStart;
+    return true;
+  }
+  windowStart = position;
+  windowLength = 0;
+  cursor = 0;
+  return true;
+}
+
+BufferedFsWriter::BufferedFsWriter(FsFile& file) : file(file), bufferStart(file.position()) {}
+
+size_t BufferedFsWriter::write(const uint8_t* src, size_t size) {
+  const size_t total = size;
+  if (used == 0 && size >= BUFFER_SIZE) {
+    // Write everything up to the last sector boundary directly, only the tail goes through the buffer
+    const size_t direct = size - (bufferStart + size) % BUFFER_SIZE;
+    if (file.write(src, direct) != direct) {
+      failed = true;
+    }
+    bufferStart += direct;
+    src += direct;
+    size -= direct;
+  }
+
+  while (size > 0) {
+    const size_t chunk = size < capacity() - used ? size : capacity() - used;
+    memcpy(buffer + used, src, chunk);
+    used += chunk;
+    src += chunk;
+    size -= chunk;
+    if (used == capacity()) {
+      flush();
+    }
+  }
+  return total;
+}
+
+bool BufferedFsWriter::flush() {
+  if (used > 0) {
+    if (file.write(buffer, used) != used) {
+      failed = true;
+    }
+    bufferStart += used;
+    used = 0;
+  }
+  return !failed;
+}
+
+bool BufferedFsWriter::seek(const uint32_t position) {
+  flush();
+  if (!file.seek(position)) {
+    failed = true;
+    return false;
+  }
+  bufferStart = position;
+  return true;
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include <SdFat.h>
+
+#include <cstdint>
+
+/**
+ * BufferedFs.h
+ *
+ * Sector sized read and write windows over an FsFile. The cache formats are made of 1-4 byte fields, going to SdFat
+ * for each of them costs a call, a cache lookup and a position update every time. These copy from or into a 512 byte
+ * window instead and only touch the file when the window is exhausted or full.
+ *
+ * Windows are aligned to sector boundaries in the file, so after the first one SdFat can move whole sectors straight
+ * between the card and the window without going through its own cache.
+ *
+ * Both keep their own idea of the position: don't use the underlying file directly while one is active, a writer has
+ * to be flushed first.
+ */
+
+class BufferedFsReader {
+ public:
+  static constexpr uint32_t BUFFER_SIZE = 512;
+
+ private:
+  FsFile& file;
+  uint8_t buffer[BUFFER_SIZE];
+  uint32_t windowStart;  // File offset of buffer[0]
+  uint32_t windowLength = 0;
+  uint32_t cursor = 0;  // Read position inside the window
+  uint32_t filePosition;
+
+  bool fill(uint32_t position);
+
+ public:
+  // Starts reading at the file's current position
+  explicit BufferedFsReader(FsFile& file);
+  BufferedFsReader(const BufferedFsReader&) = delete;
+  BufferedFsReader& operator=(const BufferedFsReader&) = delete;
+
+  // Returns the number of bytes read, less than size only at the end of the file or on error
+  size_t read(uint8_t* dst, size_t size);
+  // Seeks within the window are free, anything else is picked up by the next read
+  bool seek(uint32_t position);
+  uint32_t position() const { return windowStart + cursor; }
+};
+
+class BufferedFsWriter {
+ public:
+  static constexpr uint32_t BUFFER_SIZE = 512;
+
+ private:
+  FsFile& file;
+  uint8_t buffer[BUFFER_SIZE];
+  uint32_t bufferStart;  // File offset buffer[0] will be written to
+  uint32_t used = 0;
+  bool failed = false;
+
+  // Space up to the next sector boundary, a full buffer except right after opening or seeking
+  uint32_t capacity() const { return BUFFER_SIZE - bufferStart % BUFFER_SIZE; }
+
+ public:
+  // Starts writing at the file's current position
+  explicit BufferedFsWriter(FsFile& file);
+  ~BufferedFsWriter() { flush(); }
+  BufferedFsWriter(const BufferedFsWriter&) = delete;
+  BufferedFsWriter& operator=(const BufferedFsWriter&) = delete;
+
+  size_t write(const uint8_t* src, size_t size);
+  // Writes out buffered data, false if any write since construction came up short
+  bool flush();
+  bool seek(uint32_t position);
+  uint32_t position() const { return bufferStart + used; }
+  bool hasFailed() const { return failed; }
+};
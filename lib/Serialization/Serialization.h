@@ -3,6 +3,8 @@
 
 #include <iostream>
 
+#include "BufferedFs.h"
+
 namespace serialization {
 template <typename T>
 static void writePod(std::ostream& os, const T& value) {
@@ -24,6 +26,54 @@ static void readPod(FsFile& file, T& value) {
   file.read(reinterpret_cast<uint8_t*>(&value), sizeof(T));
 }
 
+template <typename T>
+static void writePod(BufferedFsWriter& writer, const T& value) {
+  writer.write(reinterpret_cast<const uint8_t*>(&value), sizeof(T));
+}
+
+template <typename T>
+static void readPod(BufferedFsReader& reader, T& value) {
+  reader.read(reinterpret_cast<uint8_t*>(&value), sizeof(T));
+}
+
+// Contiguous runs of PODs in one copy, count is not stored
+template <typename T>
+static void writePodArray(BufferedFsWriter& writer, const T* values, const size_t count) {
+  writer.write(reinterpret_cast<const uint8_t*>(values), sizeof(T) * count);
+}
+
+template <typename T>
+static bool readPodArray(BufferedFsReader& reader, T* values, const size_t count) {
+  return reader.read(reinterpret_cast<uint8_t*>(values), sizeof(T) * count) == sizeof(T) * count;
+}
+
+// LEB128: 7 bits per byte, low bits first. Lengths and offsets below 128 take a single byte.
+static void writeVarint(BufferedFsWriter& writer, uint32_t value) {
+  uint8_t bytes[5];
+  size_t length = 0;
+  while (value >= 0x80) {
+    bytes[length++] = static_cast<uint8_t>(value) | 0x80;
+    value >>= 7;
+  }
+  bytes[length++] = static_cast<uint8_t>(value);
+  writer.write(bytes, length);
+}
+
+static bool readVarint(BufferedFsReader& reader, uint32_t& value) {
+  value = 0;
+  for (uint8_t shift = 0; shift < 35; shift += 7) {
+    uint8_t byte;
+    if (reader.read(&byte, 1) != 1) {
+      return false;
+    }
+    value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+    if (!(byte & 0x80)) {
+      return true;
+    }
+  }
+  return false;
+}
+
 static void writeString(std::ostream& os, const std::string& s) {
   const uint32_t len = s.size();
   writePod(os, len);
@@ -36,6 +86,12 @@ static void writeString(FsFile& file, const std::string& s) {
   file.write(reinterpret_cast<const uint8_t*>(s.data()), len);
 }
 
+static void writeString(BufferedFsWriter& writer, const std::string& s) {
+  const uint32_t len = s.size();
+  writePod(writer, len);
+  writer.write(reinterpret_cast<const uint8_t*>(s.data()), len);
+}
+
 static void readString(std::istream& is, std::string& s) {
   uint32_t len;
   readPod(is, len);
@@ -49,4 +105,10 @@ static void readString(FsFile& file, std::string& s) {
   s.resize(len);
   file.read(&s[0], len);
 }
+static void readString(BufferedFsReader& reader, std::string& s) {
+  uint32_t len = 0;
+  readPod(reader, len);
+  s.resize(len);
+  reader.read(reinterpret_cast<uint8_t*>(&s[0]), len);
+}
 }  // namespace serialization
@@ -113,9 +113,6 @@ bool Txt::generateCoverBmp() const {
 
   // Get file extension
   const size_t len = coverImagePath.length();
-  const bool isJpg =
-      (len >= 4 && (coverImagePath.substr(len - 4) == ".jpg" || coverImagePath.substr(len - 4) == ".JPG")) ||
-      (len >= 5 && (coverImagePath.substr(len - 5) == ".jpeg" || coverImagePath.substr(len - 5) == ".JPEG"));
   const bool isBmp = len >= 4 && (coverImagePath.substr(len - 4) == ".bmp" || coverImagePath.substr(len - 4) == ".BMP");
 
   if (isBmp) {
@@ -140,32 +137,31 @@ bool Txt::generateCoverBmp() const {
     return true;
   }
 
-  if (isJpg) {
-    // Convert JPG/JPEG to BMP (same approach as Epub)
-    Serial.printf("[%lu] [TXT] Generating BMP from JPG cover image\n", millis());
-    FsFile coverJpg, coverBmp;
-    if (!SdMan.openFileForRead("TXT", coverImagePath, coverJpg)) {
+  if (JpegToBmpConverter::isSupportedImage(coverImagePath.c_str())) {
+    // Convert JPG/JPEG/PNG to BMP (same approach as Epub)
+    Serial.printf("[%lu] [TXT] Generating BMP from cover image\n", millis());
+    FsFile coverImage, coverBmp;
+    if (!SdMan.openFileForRead("TXT", coverImagePath, coverImage)) {
       return false;
     }
     if (!SdMan.openFileForWrite("TXT", getCoverBmpPath(), coverBmp)) {
-      coverJpg.close();
+      coverImage.close();
       return false;
     }
-    const bool success = JpegToBmpConverter::jpegFileToBmpStream(coverJpg, coverBmp);
-    coverJpg.close();
+    const bool success = JpegToBmpConverter::jpegFileToBmpStream(coverImage, coverBmp);
+    coverImage.close();
     coverBmp.close();
 
     if (!success) {
-      Serial.printf("[%lu] [TXT] Failed to generate BMP from JPG cover image\n", millis());
+      Serial.printf("[%lu] [TXT] Failed to generate BMP from cover image\n", millis());
       SdMan.remove(getCoverBmpPath().c_str());
     } else {
-      Serial.printf("[%lu] [TXT] Generated BMP from JPG cover image\n", millis());
+      Serial.printf("[%lu] [TXT] Generated BMP from cover image\n", millis());
     }
     return success;
   }
 
-  // PNG files are not supported (would need a PNG decoder)
-  Serial.printf("[%lu] [TXT] Cover image format not supported (only BMP/JPG/JPEG)\n", millis());
+  Serial.printf("[%lu] [TXT] Cover image format not supported (only BMP/JPG/JPEG/PNG)\n", millis());
   return false;
 }
 
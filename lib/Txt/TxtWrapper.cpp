@@ -0,0 +1,101 @@
+#include "TxtWrapper.h"
+
+#include <Utf8.h>
+
+#include <algorithm>
+#include <cstring>
+
+size_t TxtWrapper::breakLine(const uint8_t* text, const size_t start, const size_t end) const {
+  // Bounds of the glyphs so far as EpdFont::getTextBounds() grows them, so the width never shrinks
+  int cursorX = 0;
+  int minX = 0;
+  int maxX = 0;
+  // A NUL ends the C string getTextWidth() would be given, nothing after it adds to the width
+  bool terminated = font == nullptr;
+  size_t lastSpace = 0;     // Last space past the first character with everything before it fitting
+  size_t lastBoundary = 0;  // Last character start past the first character with everything before it fitting
+
+  size_t pos = start;
+  while (pos < end) {
+    if (pos > start) {
+      if (maxX - minX > maxWidth) {
+        break;
+      }
+      if (text[pos] == ' ') {
+        lastSpace = pos;
+      }
+      if ((text[pos] & 0xC0) != 0x80) {
+        lastBoundary = pos;
+      }
+    }
+
+    if (text[pos] == '\0') {
+      terminated = true;
+    }
+    if (terminated) {
+      pos++;
+      continue;
+    }
+
+    uint32_t cp;
+    if (pos + utf8CodepointLen(text[pos]) <= end) {
+      const unsigned char* next = text + pos;
+      cp = utf8NextCodepoint(&next);
+      pos = next - text;
+    } else {
+      // Sequence cut short by the end of the line
+      cp = REPLACEMENT_GLYPH;
+      pos = end;
+    }
+
+    const EpdGlyph* glyph = font->getGlyph(cp);
+    if (!glyph) {
+      glyph = font->getGlyph(REPLACEMENT_GLYPH);
+    }
+    if (!glyph) {
+      continue;
+    }
+    minX = std::min(minX, cursorX + glyph->left);
+    maxX = std::max(maxX, cursorX + glyph->left + glyph->width);
+    cursorX += glyph->advanceX;
+  }
+
+  if (pos == end && maxX - minX <= maxWidth) {
+    return end;
+  }
+  if (lastSpace > 0) {
+    return lastSpace;
+  }
+  return lastBoundary > 0 ? lastBoundary : start + 1;
+}
+
+size_t TxtWrapper::layoutPage(const uint8_t* text, const size_t size, const bool endOfFile,
+                              std::vector<TxtLine>& lines) const {
+  lines.clear();
+  size_t pos = 0;
+
+  while (pos < size && static_cast<int>(lines.size()) < maxLines) {
+    const auto* newline = static_cast<const uint8_t*>(memchr(text + pos, '\n', size - pos));
+    if (!newline && !endOfFile && !lines.empty()) {
+      // The rest of this line is only in the next chunk, it starts the next page
+      break;
+    }
+    const size_t lineEnd = newline ? newline - text : size;
+    const size_t contentEnd = lineEnd > pos && text[lineEnd - 1] == '\r' ? lineEnd - 1 : lineEnd;
+
+    size_t start = pos;
+    while (start < contentEnd && static_cast<int>(lines.size()) < maxLines) {
+      const size_t breakPos = breakLine(text, start, contentEnd);
+      lines.push_back({static_cast<uint16_t>(start), static_cast<uint16_t>(breakPos - start)});
+      start = breakPos < contentEnd && text[breakPos] == ' ' ? breakPos + 1 : breakPos;
+    }
+
+    if (start < contentEnd) {
+      // Page is full in the middle of the line, the next one carries on from here
+      return start;
+    }
+    pos = std::min(lineEnd + 1, size);
+  }
+
+  return pos;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <EpdFontFamily.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// One line of a page, a byte range of the chunk the page was laid out from
+struct TxtLine {
+  uint16_t offset;
+  uint16_t length;
+};
+
+/**
+ * Word wrap for plain text pages. Each line is measured in a single pass: codepoints are decoded once and the glyph
+ * bounds grow one glyph at a time, giving for every prefix the width getTextWidth() would report for it. The last
+ * space that still fits is remembered and the line is broken there as soon as the width runs over, so only the word
+ * that didn't fit is measured again as the start of the next line.
+ *
+ * Lines break at the last space that fits and drop it. A first word wider than the line is cut after its last
+ * character that fits, or after its first byte when not even that does. Empty source lines take no room on the page.
+ */
+class TxtWrapper {
+  const EpdFontFamily* font;
+  int maxWidth;
+  int maxLines;
+
+  // End of the line starting at start that fits, end itself when all of it does
+  size_t breakLine(const uint8_t* text, size_t start, size_t end) const;
+
+ public:
+  // Without a font nothing has a width, like getTextWidth() for an unknown font id
+  TxtWrapper(const EpdFontFamily* font, const int maxWidth, const int maxLines)
+      : font(font), maxWidth(maxWidth), maxLines(maxLines) {}
+
+  // Fills lines from the start of text until the page is full. A source line running past the end of the chunk is
+  // only started on an empty page, unless the chunk ends the file. Returns the bytes the page takes up, the next page
+  // starts after them.
+  size_t layoutPage(const uint8_t* text, size_t size, bool endOfFile, std::vector<TxtLine>& lines) const;
+};
@@ -4,4 +4,6 @@
 
 #define REPLACEMENT_GLYPH 0xFFFD
 
+// Bytes in the sequence the lead byte c starts, 1 for a byte that can't start one
+int utf8CodepointLen(unsigned char c);
 uint32_t utf8NextCodepoint(const unsigned char** string);
@@ -102,12 +102,18 @@ bool Xtc::hasChapters() const {
   return parser->hasChapters();
 }
 
-const std::vector<xtc::ChapterInfo>& Xtc::getChapters() const {
-  static const std::vector<xtc::ChapterInfo> kEmpty;
+uint16_t Xtc::getChapterCount() const {
   if (!loaded || !parser) {
-    return kEmpty;
+    return 0;
+  }
+  return parser->getChapterCount();
+}
+
+bool Xtc::getChapter(const uint16_t index, xtc::ChapterInfo& chapter) const {
+  if (!loaded || !parser) {
+    return false;
   }
-  return parser->getChapters();
+  return parser->getChapter(index, chapter);
 }
 
 std::string Xtc::getCoverBmpPath() const { return cachePath + "/cover.bmp"; }
@@ -303,9 +309,22 @@ bool Xtc::generateCoverBmp() const {
 
 std::string Xtc::getThumbBmpPath() const { return cachePath + "/thumb.bmp"; }
 
+std::string Xtc::getGridThumbBmpPath() const { return cachePath + "/grid.bmp"; }
+
 bool Xtc::generateThumbBmp() const {
+  // Fit within the 240x400 Continue Reading card
+  return generateScaledThumbBmp(getThumbBmpPath(), 240, 400);
+}
+
+bool Xtc::generateGridThumbBmp() const {
+  // Fit within a cell of a three column cover grid
+  return generateScaledThumbBmp(getGridThumbBmpPath(), 120, 180);
+}
+
+bool Xtc::generateScaledThumbBmp(const std::string& thumbPath, const int targetWidth,
+                                 const int targetHeight) const {
   // Already generated
-  if (SdMan.exists(getThumbBmpPath().c_str())) {
+  if (SdMan.exists(thumbPath.c_str())) {
     return true;
   }
 
@@ -332,13 +351,9 @@ bool Xtc::generateThumbBmp() const {
   // Get bit depth
   const uint8_t bitDepth = parser->getBitDepth();
 
-  // Calculate target dimensions for thumbnail (fit within 240x400 Continue Reading card)
-  constexpr int THUMB_TARGET_WIDTH = 240;
-  constexpr int THUMB_TARGET_HEIGHT = 400;
-
   // Calculate scale factor
-  float scaleX = static_cast<float>(THUMB_TARGET_WIDTH) / pageInfo.width;
-  float scaleY = static_cast<float>(THUMB_TARGET_HEIGHT) / pageInfo.height;
+  float scaleX = static_cast<float>(targetWidth) / pageInfo.width;
+  float scaleY = static_cast<float>(targetHeight) / pageInfo.height;
   float scale = (scaleX < scaleY) ? scaleX : scaleY;
 
   // Only scale down, never up
@@ -348,7 +363,7 @@ bool Xtc::generateThumbBmp() const {
     if (generateCoverBmp()) {
       FsFile src, dst;
       if (SdMan.openFileForRead("XTC", getCoverBmpPath(), src)) {
-        if (SdMan.openFileForWrite("XTC", getThumbBmpPath(), dst)) {
+        if (SdMan.openFileForWrite("XTC", thumbPath, dst)) {
           uint8_t buffer[512];
           while (src.available()) {
             size_t bytesRead = src.read(buffer, sizeof(buffer));
@@ -359,7 +374,7 @@ bool Xtc::generateThumbBmp() const {
         src.close();
       }
       Serial.printf("[%lu] [XTC] Copied cover to thumb (no scaling needed)\n", millis());
-      return SdMan.exists(getThumbBmpPath().c_str());
+      return SdMan.exists(thumbPath.c_str());
     }
     return false;
   }
@@ -393,7 +408,7 @@ bool Xtc::generateThumbBmp() const {
 
   // Create thumbnail BMP file - use 1-bit format for fast home screen rendering (no gray passes)
   FsFile thumbBmp;
-  if (!SdMan.openFileForWrite("XTC", getThumbBmpPath(), thumbBmp)) {
+  if (!SdMan.openFileForWrite("XTC", thumbPath, thumbBmp)) {
     Serial.printf("[%lu] [XTC] Failed to create thumb BMP file\n", millis());
     free(pageBuffer);
     return false;
@@ -558,7 +573,7 @@ bool Xtc::generateThumbBmp() const {
   free(pageBuffer);
 
   Serial.printf("[%lu] [XTC] Generated thumb BMP (%dx%d): %s\n", millis(), thumbWidth, thumbHeight,
-                getThumbBmpPath().c_str());
+                thumbPath.c_str());
   return true;
 }
 
@@ -606,6 +621,20 @@ xtc::XtcError Xtc::loadPageStreaming(uint32_t pageIndex,
   return const_cast<xtc::XtcParser*>(parser.get())->loadPageStreaming(pageIndex, callback, chunkSize);
 }
 
+bool Xtc::enablePageCache() const {
+  if (!loaded || !parser) {
+    return false;
+  }
+  return parser->enablePageCache();
+}
+
+bool Xtc::prefetchPage(const uint32_t pageIndex) const {
+  if (!loaded || !parser) {
+    return false;
+  }
+  return parser->prefetchPage(pageIndex);
+}
+
 uint8_t Xtc::calculateProgress(uint32_t currentPage) const {
   if (!loaded || !parser || parser->getPageCount() == 0) {
     return 0;
@@ -26,6 +26,9 @@ class Xtc {
   std::unique_ptr<xtc::XtcParser> parser;
   bool loaded;
 
+  // Area averaged, 1-bit thumbnail of the first page fitting targetWidth x targetHeight
+  bool generateScaledThumbBmp(const std::string& thumbPath, int targetWidth, int targetHeight) const;
+
  public:
   explicit Xtc(std::string filepath, const std::string& cacheDir) : filepath(std::move(filepath)), loaded(false) {
     // Create cache key based on filepath (same as Epub)
@@ -58,7 +61,9 @@ class Xtc {
   std::string getTitle() const;
   std::string getAuthor() const;
   bool hasChapters() const;
-  const std::vector<xtc::ChapterInfo>& getChapters() const;
+  uint16_t getChapterCount() const;
+  // Chapters are read from the file as they are asked for, false when out of range or unreadable
+  bool getChapter(uint16_t index, xtc::ChapterInfo& chapter) const;
 
   // Cover image support (for sleep screen)
   std::string getCoverBmpPath() const;
@@ -66,6 +71,9 @@ class Xtc {
   // Thumbnail support (for Continue Reading card)
   std::string getThumbBmpPath() const;
   bool generateThumbBmp() const;
+  // Small thumbnail for a grid of covers
+  std::string getGridThumbBmpPath() const;
+  bool generateGridThumbBmp() const;
 
   // Page access
   uint32_t getPageCount() const;
@@ -93,6 +101,19 @@ class Xtc {
                                   std::function<void(const uint8_t* data, size_t size, size_t offset)> callback,
                                   size_t chunkSize = 1024) const;
 
+  /**
+   * Keep the page last loaded and one read ahead in memory (see XtcParser::enablePageCache)
+   * @return false without a reserved buffer pool, pages are then read from the card every time
+   */
+  bool enablePageCache() const;
+
+  /**
+   * Read a page into the page cache before it is needed
+   * @param pageIndex Page index
+   * @return true if the page is now cached
+   */
+  bool prefetchPage(uint32_t pageIndex) const;
+
   // Progress calculation
   uint8_t calculateProgress(uint32_t currentPage) const;
 
@@ -0,0 +1,161 @@
+/**
+ * XtcPageBlitter.cpp
+ *
+ * Copies XTG/XTH page data into the frame buffer
+ * XTC ebook support for CrossPoint Reader
+ */
+
+#include "XtcPageBlitter.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace xtc {
+
+uint64_t transpose8x8(uint64_t x) {
+  uint64_t t = (x ^ (x >> 7)) & 0x00AA00AA00AA00AAULL;
+  x ^= t ^ (t << 7);
+  t = (x ^ (x >> 14)) & 0x0000CCCC0000CCCCULL;
+  x ^= t ^ (t << 14);
+  t = (x ^ (x >> 28)) & 0x00000000F0F0F0F0ULL;
+  x ^= t ^ (t << 28);
+  return x;
+}
+
+namespace {
+// XTH pixel value = (plane 1 bit << 1) | plane 2 bit, 0 white, 1 dark grey, 2 light grey, 3 black. Returns, for the
+// second plane of a Bw pass, non-zero if any pixel is a grey (the planes differ).
+uint8_t applyPlane(uint8_t* dst, const uint8_t* src, const size_t count, const bool secondPlane,
+                   const PageBlitter::Target target) {
+  using Target = PageBlitter::Target;
+  if (!secondPlane) {
+    if (target == Target::GrayscaleMsb) {
+      memcpy(dst, src, count);
+    } else {
+      for (size_t i = 0; i < count; i++) {
+        dst[i] = ~src[i];
+      }
+    }
+    return 0;
+  }
+
+  uint8_t grays = 0;
+  switch (target) {
+    case Target::Bw:  // Black unless both bits are clear
+      for (size_t i = 0; i < count; i++) {
+        grays |= ~dst[i] ^ src[i];
+        dst[i] &= ~src[i];
+      }
+      break;
+    case Target::GrayscaleLsb:  // White for 01 only
+      for (size_t i = 0; i < count; i++) {
+        dst[i] &= src[i];
+      }
+      break;
+    case Target::GrayscaleMsb:  // White for 01 and 10
+      for (size_t i = 0; i < count; i++) {
+        dst[i] ^= src[i];
+      }
+      break;
+  }
+  return grays;
+}
+}  // namespace
+
+bool PageBlitter::canBlit(const uint16_t width, const uint16_t height, const uint8_t bitDepth) {
+  if (width == 0 || height == 0 || width > DISPLAY_WIDTH || height > DISPLAY_HEIGHT) {
+    return false;
+  }
+  return bitDepth == 1 || (bitDepth == 2 && height % 8 == 0);
+}
+
+PageBlitter::PageBlitter(uint8_t* frameBuffer, const uint16_t width, const uint16_t height, const uint8_t bitDepth,
+                         const Target target)
+    : frameBuffer(frameBuffer),
+      width(width),
+      height(height),
+      bitDepth(bitDepth),
+      target(target),
+      rowBytes(bitDepth == 2 ? (height + 7) / 8 : (width + 7) / 8),
+      planeSize((static_cast<size_t>(width) * height + 7) / 8) {}
+
+void PageBlitter::addChunk(const uint8_t* data, const size_t size, const size_t offset) {
+  if (!frameBuffer || !canBlit(width, height, bitDepth)) {
+    return;
+  }
+  if (bitDepth == 2) {
+    addPlanes(data, size, offset);
+  } else {
+    addRows(data, size, offset);
+  }
+}
+
+void PageBlitter::finish() {
+  if (frameBuffer && bitDepth == 1 && canBlit(width, height, bitDepth) && height % 8 != 0) {
+    flushRows(height & ~7, height % 8);
+  }
+}
+
+void PageBlitter::addRows(const uint8_t* data, size_t size, size_t offset) {
+  while (size > 0) {
+    const size_t row = offset / rowBytes;
+    const size_t column = offset % rowBytes;
+    if (row >= height) {
+      return;
+    }
+    const size_t count = std::min(size, rowBytes - column);
+    memcpy(rows[row % 8] + column, data, count);
+    if (column + count == rowBytes && row % 8 == 7) {
+      flushRows(row - 7, 8);
+    }
+    data += count;
+    offset += count;
+    size -= count;
+  }
+}
+
+void PageBlitter::flushRows(const uint16_t firstRow, const uint16_t rowCount) {
+  // The 8 rows fill one byte of each panel row, bits past the page's last row keep what the frame buffer holds
+  const uint8_t keep = rowCount >= 8 ? 0 : 0xFF >> rowCount;
+  uint8_t* column = frameBuffer + (FRAME_ROWS - 1) * FRAME_ROW_BYTES + firstRow / 8;
+
+  for (uint16_t byteX = 0; byteX < rowBytes; byteX++) {
+    uint64_t block = 0;
+    for (int r = 0; r < 8; r++) {
+      block = block << 8 | rows[r][byteX];
+    }
+    block = transpose8x8(block);
+
+    const int pixels = std::min(8, width - byteX * 8);
+    uint8_t* dst = column - byteX * 8 * FRAME_ROW_BYTES;
+    for (int i = 0; i < pixels; i++, dst -= FRAME_ROW_BYTES) {
+      const auto value = static_cast<uint8_t>(block >> (56 - 8 * i));
+      *dst = (value & ~keep) | (*dst & keep);
+    }
+  }
+}
+
+void PageBlitter::addPlanes(const uint8_t* data, size_t size, size_t offset) {
+  // Columns run right to left, so column c of a plane is panel row c + FRAME_ROWS - width. With a full-height page
+  // consecutive columns are consecutive panel rows and a chunk is one span.
+  const bool contiguous = rowBytes == FRAME_ROW_BYTES;
+  uint8_t* const pageStart = frameBuffer + (FRAME_ROWS - width) * FRAME_ROW_BYTES;
+
+  while (size > 0) {
+    if (offset >= 2 * planeSize) {
+      return;
+    }
+    const bool secondPlane = offset >= planeSize;
+    const size_t planeOffset = secondPlane ? offset - planeSize : offset;
+    const size_t columnIndex = planeOffset / rowBytes;
+    const size_t byteY = planeOffset % rowBytes;
+    const size_t count = std::min(size, contiguous ? planeSize - planeOffset : rowBytes - byteY);
+
+    grayBits |= applyPlane(pageStart + columnIndex * FRAME_ROW_BYTES + byteY, data, count, secondPlane, target);
+    data += count;
+    offset += count;
+    size -= count;
+  }
+}
+
+}  // namespace xtc
@@ -0,0 +1,72 @@
+/**
+ * XtcPageBlitter.h
+ *
+ * Copies XTG/XTH page data into the frame buffer
+ * XTC ebook support for CrossPoint Reader
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "XtcTypes.h"
+
+namespace xtc {
+
+// Byte i of the result, counting from the top, holds bit 7 - i of every input byte, the first input byte in bit 7.
+// Rows of 8 pixels go in, columns of 8 pixels come out, and the other way round: it is its own inverse.
+uint64_t transpose8x8(uint64_t x);
+
+/**
+ * Writes a page into a portrait frame buffer chunk by chunk, as XtcParser::loadPageStreaming() reads it, so the page
+ * never has to be held in memory. Page pixel (x, y) is panel pixel (y, 479 - x): an XTG row becomes a panel column
+ * (8 rows at a time through an 8x8 bit transpose) and an XTH plane column is already a panel row.
+ *
+ * An XTH page needs both of its planes for every buffer it is turned into, the target picks which one:
+ * - Bw: black wherever the pixel is not white
+ * - GrayscaleLsb: white where the pixel is dark grey, the input of copyGrayscaleLsbBuffers()
+ * - GrayscaleMsb: white where the pixel is dark or light grey, the input of copyGrayscaleMsbBuffers()
+ * XTG pages only have the Bw target.
+ *
+ * Only the page's own pixels are written, clear the frame buffer first when the page is smaller than the panel.
+ */
+class PageBlitter {
+ public:
+  enum class Target : uint8_t { Bw, GrayscaleLsb, GrayscaleMsb };
+
+  // Frame buffer layout: DISPLAY_WIDTH panel rows of DISPLAY_HEIGHT / 8 bytes, MSB first, set bits white
+  static constexpr uint16_t FRAME_ROWS = DISPLAY_WIDTH;
+  static constexpr uint16_t FRAME_ROW_BYTES = DISPLAY_HEIGHT / 8;
+
+  // False for pages larger than the panel and for XTH pages whose height is not a multiple of 8
+  static bool canBlit(uint16_t width, uint16_t height, uint8_t bitDepth);
+
+  PageBlitter(uint8_t* frameBuffer, uint16_t width, uint16_t height, uint8_t bitDepth, Target target = Target::Bw);
+
+  // Chunks must come in order, bytes past the end of the page are ignored
+  void addChunk(const uint8_t* data, size_t size, size_t offset);
+  // Writes the last rows of an XTG page whose height is not a multiple of 8
+  void finish();
+  // Whether an XTH page had any grey pixel, known after the Bw target's pass. Always false for XTG pages.
+  bool hasGrays() const { return grayBits != 0; }
+
+ private:
+  static constexpr uint16_t MAX_ROW_BYTES = DISPLAY_WIDTH / 8;
+
+  void addRows(const uint8_t* data, size_t size, size_t offset);
+  void flushRows(uint16_t firstRow, uint16_t rowCount);
+  void addPlanes(const uint8_t* data, size_t size, size_t offset);
+
+  uint8_t* frameBuffer;
+  uint16_t width;
+  uint16_t height;
+  uint8_t bitDepth;
+  Target target;
+  uint16_t rowBytes;  // XTG bytes per row, XTH bytes per column
+  size_t planeSize;   // XTH only
+  uint8_t grayBits = 0;
+  uint8_t rows[8][MAX_ROW_BYTES] = {};  // XTG rows waiting for their group of 8 to be complete
+};
+
+}  // namespace xtc
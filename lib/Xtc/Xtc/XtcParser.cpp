@@ -7,21 +7,74 @@
 
 #include "XtcParser.h"
 
+#include <BufferPool.h>
 #include <FsHelpers.h>
 #include <HardwareSerial.h>
+#include <PackBits.h>
 #include <SDCardManager.h>
 
+#include <algorithm>
 #include <cstring>
 
 namespace xtc {
 
+namespace {
+constexpr size_t CHAPTER_RECORD_SIZE = 96;
+
+enum class ChapterRecord { Chapter, Skipped, End };
+
+// Record layout: name (80 bytes, NUL padded), then 1-based start and end pages at 0x50 and 0x52. An empty record ends
+// the list, records outside the book are skipped. The name is only decoded when asked for.
+ChapterRecord decodeChapterRecord(const uint8_t* record, const uint16_t pageCount, uint16_t* startPage,
+                                  uint16_t* endPage, std::string* name) {
+  const size_t nameLen = strnlen(reinterpret_cast<const char*>(record), 80);
+  memcpy(startPage, record + 0x50, sizeof(*startPage));
+  memcpy(endPage, record + 0x52, sizeof(*endPage));
+
+  if (nameLen == 0 && *startPage == 0 && *endPage == 0) {
+    return ChapterRecord::End;
+  }
+
+  if (*startPage > 0) {
+    (*startPage)--;
+  }
+  if (*endPage > 0) {
+    (*endPage)--;
+  }
+
+  if (*startPage >= pageCount) {
+    return ChapterRecord::Skipped;
+  }
+
+  if (*endPage >= pageCount) {
+    *endPage = pageCount - 1;
+  }
+
+  if (*startPage > *endPage) {
+    return ChapterRecord::Skipped;
+  }
+
+  if (name) {
+    name->assign(reinterpret_cast<const char*>(record), nameLen);
+  }
+  return ChapterRecord::Chapter;
+}
+}  // namespace
+
 XtcParser::XtcParser()
     : m_isOpen(false),
       m_defaultWidth(DISPLAY_WIDTH),
       m_defaultHeight(DISPLAY_HEIGHT),
       m_bitDepth(1),
-      m_hasChapters(false),
-      m_lastError(XtcError::OK) {
+      m_lastError(XtcError::OK),
+      m_pageWindowStart(0),
+      m_pageWindowCount(0),
+      m_chapterWindowStart(0),
+      m_chapterWindowCount(0),
+      m_chapterOffset(0),
+      m_chapterRecordCount(0),
+      m_chaptersCounted(false),
+      m_chapterCount(0) {
   memset(&m_header, 0, sizeof(m_header));
 }
 
@@ -90,10 +143,15 @@ void XtcParser::close() {
     m_file.close();
     m_isOpen = false;
   }
-  m_pageTable.clear();
-  m_chapters.clear();
+  disablePageCache();
+  m_pageWindowCount = 0;
+  m_chapterWindowCount = 0;
+  m_chapterOffset = 0;
+  m_chapterRecordCount = 0;
+  m_chaptersCounted = false;
+  m_chapterCount = 0;
+  m_chapterRecords.clear();
   m_title.clear();
-  m_hasChapters = false;
   memset(&m_header, 0, sizeof(m_header));
 }
 
@@ -171,70 +229,66 @@ XtcError XtcParser::readPageTable() {
     return XtcError::CORRUPTED_HEADER;
   }
 
-  // Seek to page table
-  if (!m_file.seek(m_header.pageTableOffset)) {
-    Serial.printf("[%lu] [XTC] Failed to seek to page table at %llu\n", millis(), m_header.pageTableOffset);
+  // The entries stay on the card and are read through the window, here only the table's extent is checked and the
+  // first window read for the default page size
+  const uint64_t tableSize = static_cast<uint64_t>(m_header.pageCount) * sizeof(PageTableEntry);
+  if (m_header.pageTableOffset + tableSize > m_file.size()) {
+    Serial.printf("[%lu] [XTC] Page table at %llu runs past the end of the file\n", millis(), m_header.pageTableOffset);
     return XtcError::READ_ERROR;
   }
 
-  m_pageTable.resize(m_header.pageCount);
-
-  // Read page table entries
-  for (uint16_t i = 0; i < m_header.pageCount; i++) {
-    PageTableEntry entry;
-    size_t bytesRead = m_file.read(reinterpret_cast<uint8_t*>(&entry), sizeof(PageTableEntry));
-    if (bytesRead != sizeof(PageTableEntry)) {
-      Serial.printf("[%lu] [XTC] Failed to read page table entry %u\n", millis(), i);
-      return XtcError::READ_ERROR;
-    }
-
-    m_pageTable[i].offset = static_cast<uint32_t>(entry.dataOffset);
-    m_pageTable[i].size = entry.dataSize;
-    m_pageTable[i].width = entry.width;
-    m_pageTable[i].height = entry.height;
-    m_pageTable[i].bitDepth = m_bitDepth;
-
-    // Update default dimensions from first page
-    if (i == 0) {
-      m_defaultWidth = entry.width;
-      m_defaultHeight = entry.height;
-    }
+  m_pageWindowCount = 0;
+  if (!fillPageWindow(0)) {
+    Serial.printf("[%lu] [XTC] Failed to read page table at %llu\n", millis(), m_header.pageTableOffset);
+    return XtcError::READ_ERROR;
   }
+  m_defaultWidth = m_pageWindow[0].width;
+  m_defaultHeight = m_pageWindow[0].height;
 
-  Serial.printf("[%lu] [XTC] Read %u page table entries\n", millis(), m_header.pageCount);
+  Serial.printf("[%lu] [XTC] Page table: %u entries\n", millis(), m_header.pageCount);
   return XtcError::OK;
 }
 
-XtcError XtcParser::readChapters() {
-  m_hasChapters = false;
-  m_chapters.clear();
-
-  uint8_t hasChaptersFlag = 0;
-  if (!m_file.seek(0x0B)) {
-    return XtcError::READ_ERROR;
-  }
-  if (m_file.read(&hasChaptersFlag, sizeof(hasChaptersFlag)) != sizeof(hasChaptersFlag)) {
-    return XtcError::READ_ERROR;
+bool XtcParser::fillPageWindow(const uint32_t pageIndex) {
+  // A quarter of the window stays behind the page so turning back does not read the table again straight away
+  uint32_t start = pageIndex > PAGE_WINDOW_SIZE / 4 ? pageIndex - PAGE_WINDOW_SIZE / 4 : 0;
+  if (start + PAGE_WINDOW_SIZE > m_header.pageCount) {
+    start = m_header.pageCount > PAGE_WINDOW_SIZE ? m_header.pageCount - PAGE_WINDOW_SIZE : 0;
   }
+  const uint16_t count = std::min<uint32_t>(PAGE_WINDOW_SIZE, m_header.pageCount - start);
 
-  if (hasChaptersFlag != 1) {
-    return XtcError::OK;
+  m_pageWindowCount = 0;
+  const size_t bytes = count * sizeof(PageTableEntry);
+  if (!m_file.seek(m_header.pageTableOffset + static_cast<uint64_t>(start) * sizeof(PageTableEntry)) ||
+      m_file.read(reinterpret_cast<uint8_t*>(m_pageWindow), bytes) != static_cast<int>(bytes)) {
+    return false;
   }
+  m_pageWindowStart = start;
+  m_pageWindowCount = count;
+  return true;
+}
 
-  uint64_t chapterOffset = 0;
-  if (!m_file.seek(0x30)) {
-    return XtcError::READ_ERROR;
-  }
-  if (m_file.read(reinterpret_cast<uint8_t*>(&chapterOffset), sizeof(chapterOffset)) != sizeof(chapterOffset)) {
-    return XtcError::READ_ERROR;
+XtcError XtcParser::readChapters() {
+  m_chapterOffset = 0;
+  m_chapterRecordCount = 0;
+  m_chaptersCounted = false;
+  m_chapterCount = 0;
+  m_chapterWindowCount = 0;
+  m_chapterRecords.clear();
+
+  if (m_header.hasChapters != 1) {
+    return XtcError::OK;
   }
 
+  // Read as 64 bits together with the padding that follows it
+  const uint64_t chapterOffset = m_header.chapterOffset | static_cast<uint64_t>(m_header.padding) << 32;
   if (chapterOffset == 0) {
     return XtcError::OK;
   }
 
   const uint64_t fileSize = m_file.size();
-  if (chapterOffset < sizeof(XtcHeader) || chapterOffset >= fileSize || chapterOffset + 96 > fileSize) {
+  if (chapterOffset < sizeof(XtcHeader) || chapterOffset >= fileSize ||
+      chapterOffset + CHAPTER_RECORD_SIZE > fileSize) {
     return XtcError::OK;
   }
 
@@ -251,101 +305,131 @@ XtcError XtcParser::readChapters() {
     return XtcError::OK;
   }
 
-  constexpr size_t chapterSize = 96;
-  const uint64_t available = maxOffset - chapterOffset;
-  const size_t chapterCount = static_cast<size_t>(available / chapterSize);
-  if (chapterCount == 0) {
-    return XtcError::OK;
-  }
+  // Nothing is read yet, see countChapters()
+  m_chapterOffset = chapterOffset;
+  m_chapterRecordCount = static_cast<uint16_t>(std::min<uint64_t>((maxOffset - chapterOffset) / CHAPTER_RECORD_SIZE,
+                                                                   UINT16_MAX));
+  return XtcError::OK;
+}
 
-  if (!m_file.seek(chapterOffset)) {
-    return XtcError::READ_ERROR;
+void XtcParser::countChapters() {
+  m_chaptersCounted = true;
+  m_chapterCount = 0;
+  m_chapterRecords.clear();
+  if (m_chapterRecordCount == 0 || !m_file.seek(m_chapterOffset)) {
+    return;
   }
 
-  std::vector<uint8_t> chapterBuf(chapterSize);
-  for (size_t i = 0; i < chapterCount; i++) {
-    if (m_file.read(chapterBuf.data(), chapterSize) != chapterSize) {
-      return XtcError::READ_ERROR;
-    }
-
-    char nameBuf[81];
-    memcpy(nameBuf, chapterBuf.data(), 80);
-    nameBuf[80] = '\0';
-    const size_t nameLen = strnlen(nameBuf, 80);
-    std::string name(nameBuf, nameLen);
-
-    uint16_t startPage = 0;
-    uint16_t endPage = 0;
-    memcpy(&startPage, chapterBuf.data() + 0x50, sizeof(startPage));
-    memcpy(&endPage, chapterBuf.data() + 0x52, sizeof(endPage));
-
-    if (name.empty() && startPage == 0 && endPage == 0) {
+  std::vector<uint16_t> records;
+  bool skipped = false;
+  uint8_t record[CHAPTER_RECORD_SIZE];
+  for (uint16_t i = 0; i < m_chapterRecordCount; i++) {
+    if (m_file.read(record, CHAPTER_RECORD_SIZE) != CHAPTER_RECORD_SIZE) {
+      Serial.printf("[%lu] [XTC] Failed to read chapter record %u\n", millis(), i);
       break;
     }
-
-    if (startPage > 0) {
-      startPage--;
-    }
-    if (endPage > 0) {
-      endPage--;
+    uint16_t startPage, endPage;
+    const ChapterRecord type = decodeChapterRecord(record, m_header.pageCount, &startPage, &endPage, nullptr);
+    if (type == ChapterRecord::End) {
+      break;
     }
-
-    if (startPage >= m_header.pageCount) {
+    if (type == ChapterRecord::Skipped) {
+      skipped = true;
       continue;
     }
+    records.push_back(i);
+  }
 
-    if (endPage >= m_header.pageCount) {
-      endPage = m_header.pageCount - 1;
-    }
+  m_chapterCount = records.size();
+  if (skipped) {
+    m_chapterRecords = std::move(records);
+  }
+  Serial.printf("[%lu] [XTC] Chapters: %u\n", millis(), m_chapterCount);
+}
 
-    if (startPage > endPage) {
-      continue;
+bool XtcParser::fillChapterWindow(const uint16_t index) {
+  uint16_t start = index > CHAPTER_WINDOW_SIZE / 4 ? index - CHAPTER_WINDOW_SIZE / 4 : 0;
+  if (start + CHAPTER_WINDOW_SIZE > m_chapterCount) {
+    start = m_chapterCount > CHAPTER_WINDOW_SIZE ? m_chapterCount - CHAPTER_WINDOW_SIZE : 0;
+  }
+  const uint16_t count = std::min<uint16_t>(CHAPTER_WINDOW_SIZE, m_chapterCount - start);
+
+  m_chapterWindowCount = 0;
+  uint8_t record[CHAPTER_RECORD_SIZE];
+  int nextRecord = -1;
+  for (uint16_t i = 0; i < count; i++) {
+    const uint16_t recordIndex = m_chapterRecords.empty() ? start + i : m_chapterRecords[start + i];
+    if (recordIndex != nextRecord && !m_file.seek(m_chapterOffset + recordIndex * CHAPTER_RECORD_SIZE)) {
+      return false;
+    }
+    if (m_file.read(record, CHAPTER_RECORD_SIZE) != CHAPTER_RECORD_SIZE) {
+      return false;
     }
+    nextRecord = recordIndex + 1;
 
-    ChapterInfo chapter{std::move(name), startPage, endPage};
-    m_chapters.push_back(std::move(chapter));
+    ChapterInfo& chapter = m_chapterWindow[i];
+    if (decodeChapterRecord(record, m_header.pageCount, &chapter.startPage, &chapter.endPage, &chapter.name) !=
+        ChapterRecord::Chapter) {
+      return false;
+    }
   }
+  m_chapterWindowStart = start;
+  m_chapterWindowCount = count;
+  return true;
+}
 
-  m_hasChapters = !m_chapters.empty();
-  Serial.printf("[%lu] [XTC] Chapters: %u\n", millis(), static_cast<unsigned int>(m_chapters.size()));
-  return XtcError::OK;
+uint16_t XtcParser::getChapterCount() {
+  if (!m_chaptersCounted) {
+    countChapters();
+  }
+  return m_chapterCount;
 }
 
-bool XtcParser::getPageInfo(uint32_t pageIndex, PageInfo& info) const {
-  if (pageIndex >= m_pageTable.size()) {
+bool XtcParser::getChapter(const uint16_t index, ChapterInfo& chapter) {
+  if (index >= getChapterCount()) {
     return false;
   }
-  info = m_pageTable[pageIndex];
+  if ((index < m_chapterWindowStart || index >= m_chapterWindowStart + m_chapterWindowCount) &&
+      !fillChapterWindow(index)) {
+    Serial.printf("[%lu] [XTC] Failed to read chapter %u\n", millis(), index);
+    return false;
+  }
+  chapter = m_chapterWindow[index - m_chapterWindowStart];
   return true;
 }
 
-size_t XtcParser::loadPage(uint32_t pageIndex, uint8_t* buffer, size_t bufferSize) {
-  if (!m_isOpen) {
-    m_lastError = XtcError::FILE_NOT_FOUND;
-    return 0;
-  }
-
+bool XtcParser::getPageInfo(const uint32_t pageIndex, PageInfo& info) {
   if (pageIndex >= m_header.pageCount) {
-    m_lastError = XtcError::PAGE_OUT_OF_RANGE;
-    return 0;
+    return false;
+  }
+  if ((pageIndex < m_pageWindowStart || pageIndex >= m_pageWindowStart + m_pageWindowCount) &&
+      !fillPageWindow(pageIndex)) {
+    Serial.printf("[%lu] [XTC] Failed to read page table entry %lu\n", millis(), pageIndex);
+    return false;
   }
 
-  const PageInfo& page = m_pageTable[pageIndex];
+  const PageTableEntry& entry = m_pageWindow[pageIndex - m_pageWindowStart];
+  info.offset = static_cast<uint32_t>(entry.dataOffset);
+  info.size = entry.dataSize;
+  info.width = entry.width;
+  info.height = entry.height;
+  info.bitDepth = m_bitDepth;
+  info.padding = 0;
+  return true;
+}
 
+XtcError XtcParser::readPageHeader(const uint32_t pageIndex, XtgPageHeader& pageHeader) {
   // Seek to page data
-  if (!m_file.seek(page.offset)) {
-    Serial.printf("[%lu] [XTC] Failed to seek to page %u at offset %lu\n", millis(), pageIndex, page.offset);
-    m_lastError = XtcError::READ_ERROR;
-    return 0;
+  PageInfo page;
+  if (!getPageInfo(pageIndex, page) || !m_file.seek(page.offset)) {
+    Serial.printf("[%lu] [XTC] Failed to seek to page %u\n", millis(), pageIndex);
+    return XtcError::READ_ERROR;
   }
 
   // Read page header (XTG for 1-bit, XTH for 2-bit - same structure)
-  XtgPageHeader pageHeader;
-  size_t headerRead = m_file.read(reinterpret_cast<uint8_t*>(&pageHeader), sizeof(XtgPageHeader));
-  if (headerRead != sizeof(XtgPageHeader)) {
+  if (m_file.read(reinterpret_cast<uint8_t*>(&pageHeader), sizeof(XtgPageHeader)) != sizeof(XtgPageHeader)) {
     Serial.printf("[%lu] [XTC] Failed to read page header for page %u\n", millis(), pageIndex);
-    m_lastError = XtcError::READ_ERROR;
-    return 0;
+    return XtcError::READ_ERROR;
   }
 
   // Verify page magic (XTG for 1-bit, XTH for 2-bit)
@@ -353,22 +437,112 @@ size_t XtcParser::loadPage(uint32_t pageIndex, uint8_t* buffer, size_t bufferSiz
   if (pageHeader.magic != expectedMagic) {
     Serial.printf("[%lu] [XTC] Invalid page magic for page %u: 0x%08X (expected 0x%08X)\n", millis(), pageIndex,
                   pageHeader.magic, expectedMagic);
-    m_lastError = XtcError::INVALID_MAGIC;
-    return 0;
+    return XtcError::INVALID_MAGIC;
+  }
+
+  if (pageHeader.compression != XTG_COMPRESSION_NONE && pageHeader.compression != XTG_COMPRESSION_PACKBITS) {
+    Serial.printf("[%lu] [XTC] Unsupported compression %u on page %u\n", millis(), pageHeader.compression, pageIndex);
+    return XtcError::DECOMPRESSION_ERROR;
   }
+  return XtcError::OK;
+}
 
-  // Calculate bitmap size based on bit depth
+size_t XtcParser::getBitmapSize(const XtgPageHeader& pageHeader) const {
   // XTG (1-bit): Row-major, ((width+7)/8) * height bytes
-  // XTH (2-bit): Two bit planes, column-major, ((width * height + 7) / 8) * 2 bytes
-  size_t bitmapSize;
+  // XTH (2-bit): Two bit planes, each containing (width * height) bits rounded up to bytes
   if (m_bitDepth == 2) {
-    // XTH: two bit planes, each containing (width * height) bits rounded up to bytes
-    bitmapSize = ((static_cast<size_t>(pageHeader.width) * pageHeader.height + 7) / 8) * 2;
-  } else {
-    bitmapSize = ((pageHeader.width + 7) / 8) * pageHeader.height;
+    return ((static_cast<size_t>(pageHeader.width) * pageHeader.height + 7) / 8) * 2;
+  }
+  return ((pageHeader.width + 7) / 8) * pageHeader.height;
+}
+
+size_t XtcParser::getStoredSize(const XtgPageHeader& pageHeader) const {
+  return pageHeader.compression == XTG_COMPRESSION_NONE ? getBitmapSize(pageHeader) : pageHeader.dataSize;
+}
+
+XtcError XtcParser::emitBitmap(const XtgPageHeader& pageHeader, const uint8_t* stored,
+                               const std::function<void(const uint8_t* data, size_t size, size_t offset)>& callback,
+                               const size_t chunkSize) {
+  const size_t bitmapSize = getBitmapSize(pageHeader);
+
+  if (pageHeader.compression == XTG_COMPRESSION_NONE) {
+    if (stored) {
+      for (size_t offset = 0; offset < bitmapSize; offset += chunkSize) {
+        callback(stored + offset, std::min(chunkSize, bitmapSize - offset), offset);
+      }
+      return XtcError::OK;
+    }
+
+    // Read in chunks
+    std::vector<uint8_t> chunk(chunkSize);
+    size_t totalRead = 0;
+    while (totalRead < bitmapSize) {
+      const size_t toRead = std::min(chunkSize, bitmapSize - totalRead);
+      const int bytesRead = m_file.read(chunk.data(), toRead);
+      if (bytesRead <= 0) {
+        return XtcError::READ_ERROR;
+      }
+      callback(chunk.data(), bytesRead, totalRead);
+      totalRead += bytesRead;
+    }
+    return XtcError::OK;
+  }
+
+  // PackBits: expanded a chunk at a time, from memory or from the card
+  std::vector<uint8_t> output(chunkSize);
+  std::vector<uint8_t> input(stored ? 0 : chunkSize);
+  const uint8_t* in = stored;
+  const uint8_t* inEnd = stored ? stored + pageHeader.dataSize : nullptr;
+  size_t storedLeft = stored ? 0 : pageHeader.dataSize;
+  packbits::Decoder decoder;
+  size_t produced = 0;
+  size_t filled = 0;
+  while (produced < bitmapSize) {
+    if (in == inEnd) {
+      if (storedLeft == 0) {
+        Serial.printf("[%lu] [XTC] Compressed page data ends at %u of %u bytes\n", millis(), produced + filled,
+                      bitmapSize);
+        return XtcError::DECOMPRESSION_ERROR;
+      }
+      const int bytesRead = m_file.read(input.data(), std::min(chunkSize, storedLeft));
+      if (bytesRead <= 0) {
+        return XtcError::READ_ERROR;
+      }
+      in = input.data();
+      inEnd = in + bytesRead;
+      storedLeft -= bytesRead;
+    }
+
+    const size_t wanted = std::min(chunkSize, bitmapSize - produced);
+    filled += decoder.decode(in, inEnd, output.data() + filled, wanted - filled);
+    if (filled == wanted) {
+      callback(output.data(), filled, produced);
+      produced += filled;
+      filled = 0;
+    }
+  }
+  return XtcError::OK;
+}
+
+size_t XtcParser::loadPage(uint32_t pageIndex, uint8_t* buffer, size_t bufferSize) {
+  if (!m_isOpen) {
+    m_lastError = XtcError::FILE_NOT_FOUND;
+    return 0;
+  }
+
+  if (pageIndex >= m_header.pageCount) {
+    m_lastError = XtcError::PAGE_OUT_OF_RANGE;
+    return 0;
+  }
+
+  XtgPageHeader pageHeader;
+  m_lastError = readPageHeader(pageIndex, pageHeader);
+  if (m_lastError != XtcError::OK) {
+    return 0;
   }
 
   // Check buffer size
+  const size_t bitmapSize = getBitmapSize(pageHeader);
   if (bufferSize < bitmapSize) {
     Serial.printf("[%lu] [XTC] Buffer too small: need %u, have %u\n", millis(), bitmapSize, bufferSize);
     m_lastError = XtcError::MEMORY_ERROR;
@@ -376,15 +550,25 @@ size_t XtcParser::loadPage(uint32_t pageIndex, uint8_t* buffer, size_t bufferSiz
   }
 
   // Read bitmap data
-  size_t bytesRead = m_file.read(buffer, bitmapSize);
-  if (bytesRead != bitmapSize) {
-    Serial.printf("[%lu] [XTC] Page read error: expected %u, got %u\n", millis(), bitmapSize, bytesRead);
-    m_lastError = XtcError::READ_ERROR;
-    return 0;
+  if (pageHeader.compression == XTG_COMPRESSION_NONE) {
+    const size_t bytesRead = m_file.read(buffer, bitmapSize);
+    if (bytesRead != bitmapSize) {
+      Serial.printf("[%lu] [XTC] Page read error: expected %u, got %u\n", millis(), bitmapSize, bytesRead);
+      m_lastError = XtcError::READ_ERROR;
+      return 0;
+    }
+  } else {
+    m_lastError = emitBitmap(
+        pageHeader, nullptr,
+        [buffer](const uint8_t* data, const size_t size, const size_t offset) { memcpy(buffer + offset, data, size); },
+        1024);
+    if (m_lastError != XtcError::OK) {
+      return 0;
+    }
   }
 
   m_lastError = XtcError::OK;
-  return bytesRead;
+  return bitmapSize;
 }
 
 XtcError XtcParser::loadPageStreaming(uint32_t pageIndex,
@@ -398,48 +582,97 @@ XtcError XtcParser::loadPageStreaming(uint32_t pageIndex,
     return XtcError::PAGE_OUT_OF_RANGE;
   }
 
-  const PageInfo& page = m_pageTable[pageIndex];
-
-  // Seek to page data
-  if (!m_file.seek(page.offset)) {
-    return XtcError::READ_ERROR;
+  // A page that fits the cache is read into it whole and expanded from there, every later pass over it (and a page
+  // read ahead) costs no card access
+  XtcError error = XtcError::OK;
+  if (const CachedPage* cached = cachePage(pageIndex, true, error)) {
+    return emitBitmap(cached->header, cached->data, callback, chunkSize);
+  }
+  if (error != XtcError::OK) {
+    return error;
   }
 
-  // Read and skip page header (XTG for 1-bit, XTH for 2-bit)
   XtgPageHeader pageHeader;
-  size_t headerRead = m_file.read(reinterpret_cast<uint8_t*>(&pageHeader), sizeof(XtgPageHeader));
-  const uint32_t expectedMagic = (m_bitDepth == 2) ? XTH_MAGIC : XTG_MAGIC;
-  if (headerRead != sizeof(XtgPageHeader) || pageHeader.magic != expectedMagic) {
-    return XtcError::READ_ERROR;
+  error = readPageHeader(pageIndex, pageHeader);
+  if (error != XtcError::OK) {
+    return error;
   }
+  return emitBitmap(pageHeader, nullptr, callback, chunkSize);
+}
 
-  // Calculate bitmap size based on bit depth
-  // XTG (1-bit): Row-major, ((width+7)/8) * height bytes
-  // XTH (2-bit): Two bit planes, ((width * height + 7) / 8) * 2 bytes
-  size_t bitmapSize;
-  if (m_bitDepth == 2) {
-    bitmapSize = ((static_cast<size_t>(pageHeader.width) * pageHeader.height + 7) / 8) * 2;
-  } else {
-    bitmapSize = ((pageHeader.width + 7) / 8) * pageHeader.height;
+bool XtcParser::enablePageCache() {
+  if (!BUFFER_POOL.isReserved()) {
+    return false;
   }
+  if (!m_pageCacheEnabled) {
+    m_pageCacheEnabled = true;
+    m_pageCacheRecent = 0;
+  }
+  return true;
+}
 
-  // Read in chunks
-  std::vector<uint8_t> chunk(chunkSize);
-  size_t totalRead = 0;
+void XtcParser::disablePageCache() {
+  for (CachedPage& slot : m_pageCache) {
+    BUFFER_POOL.release(slot.data);
+    slot.data = nullptr;
+    slot.valid = false;
+  }
+  m_pageCacheEnabled = false;
+}
 
-  while (totalRead < bitmapSize) {
-    size_t toRead = std::min(chunkSize, bitmapSize - totalRead);
-    size_t bytesRead = m_file.read(chunk.data(), toRead);
+bool XtcParser::prefetchPage(const uint32_t pageIndex) {
+  if (!m_isOpen || pageIndex >= m_header.pageCount) {
+    return false;
+  }
+  XtcError error = XtcError::OK;
+  return cachePage(pageIndex, false, error) != nullptr;
+}
+
+const XtcParser::CachedPage* XtcParser::cachePage(const uint32_t pageIndex, const bool use, XtcError& error) {
+  if (!m_pageCacheEnabled) {
+    return nullptr;
+  }
 
-    if (bytesRead == 0) {
-      return XtcError::READ_ERROR;
+  for (uint8_t i = 0; i < PAGE_CACHE_SLOTS; i++) {
+    if (m_pageCache[i].valid && m_pageCache[i].pageIndex == pageIndex) {
+      if (use) {
+        m_pageCacheRecent = i;
+      }
+      return &m_pageCache[i];
     }
+  }
 
-    callback(chunk.data(), bytesRead, totalRead);
-    totalRead += bytesRead;
+  XtgPageHeader pageHeader;
+  error = readPageHeader(pageIndex, pageHeader);
+  const size_t storedSize = getStoredSize(pageHeader);
+  if (error != XtcError::OK || storedSize > PAGE_CACHE_SLOT_SIZE) {
+    return nullptr;
+  }
+
+  // The page last shown stays, the other slot takes the new one
+  const uint8_t slotIndex = (m_pageCacheRecent + 1) % PAGE_CACHE_SLOTS;
+  CachedPage& slot = m_pageCache[slotIndex];
+  slot.valid = false;
+  if (!slot.data) {
+    // Leased on first use and kept until the cache is disabled, the page is streamed while the slabs are taken
+    slot.data = BUFFER_POOL.tryLease(PAGE_CACHE_SLOT_SIZE, "xtcPageCache");
+    if (!slot.data) {
+      return nullptr;
+    }
+  }
+  slot.header = pageHeader;
+  if (m_file.read(slot.data, storedSize) != static_cast<int>(storedSize)) {
+    Serial.printf("[%lu] [XTC] Failed to read page %u into the cache\n", millis(), pageIndex);
+    error = XtcError::READ_ERROR;
+    return nullptr;
   }
 
-  return XtcError::OK;
+  slot.pageIndex = pageIndex;
+  slot.valid = true;
+  if (use) {
+    m_pageCacheRecent = slotIndex;
+  }
+  return &slot;
 }
 
 bool XtcParser::isValidXtcFile(const char* filepath) {
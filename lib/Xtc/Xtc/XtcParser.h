@@ -41,8 +41,8 @@ class XtcParser {
   uint16_t getHeight() const { return m_defaultHeight; }
   uint8_t getBitDepth() const { return m_bitDepth; }  // 1 = XTC/XTG, 2 = XTCH/XTH
 
-  // Page information
-  bool getPageInfo(uint32_t pageIndex, PageInfo& info) const;
+  // Page information, read from the page table through a small window of entries around the page
+  bool getPageInfo(uint32_t pageIndex, PageInfo& info);
 
   /**
    * Load page bitmap (raw 1-bit data, skipping XTG header)
@@ -67,12 +67,26 @@ class XtcParser {
                              std::function<void(const uint8_t* data, size_t size, size_t offset)> callback,
                              size_t chunkSize = 1024);
 
+  /**
+   * Page cache: two slots holding the stored (usually compressed) data of the page last loaded and one more, so the
+   * passes of an XTH page read the card once and prefetchPage() can read the next page ahead of time. A slot takes
+   * free buffer pool slabs through tryLease() when a page first goes into it, never the heap, and pages are streamed
+   * from the card as before when the slabs are taken or the page is too large for a slot. Off until enabled, fails
+   * without a reserved buffer pool, close() releases it.
+   */
+  bool enablePageCache();
+  void disablePageCache();
+  // Reads a page into the cache, false if it is too large, unreadable or the cache is off
+  bool prefetchPage(uint32_t pageIndex);
+
   // Get title/author from metadata
   std::string getTitle() const { return m_title; }
   std::string getAuthor() const { return m_author; }
 
-  bool hasChapters() const { return m_hasChapters; }
-  const std::vector<ChapterInfo>& getChapters() const { return m_chapters; }
+  // Chapters are read on first use (the records are only counted once) and then through a window like the pages
+  bool hasChapters() { return getChapterCount() > 0; }
+  uint16_t getChapterCount();
+  bool getChapter(uint16_t index, ChapterInfo& chapter);
 
   // Validation
   static bool isValidXtcFile(const char* filepath);
@@ -84,22 +98,63 @@ class XtcParser {
   FsFile m_file;
   bool m_isOpen;
   XtcHeader m_header;
-  std::vector<PageInfo> m_pageTable;
-  std::vector<ChapterInfo> m_chapters;
   std::string m_title;
   std::string m_author;
   uint16_t m_defaultWidth;
   uint16_t m_defaultHeight;
   uint8_t m_bitDepth;  // 1 = XTC/XTG (1-bit), 2 = XTCH/XTH (2-bit)
-  bool m_hasChapters;
   XtcError m_lastError;
 
+  // Page table entries around the last page asked for, a 10,000 page file would need 160KB for all of them
+  static constexpr uint16_t PAGE_WINDOW_SIZE = 32;
+  PageTableEntry m_pageWindow[PAGE_WINDOW_SIZE];
+  uint32_t m_pageWindowStart;
+  uint16_t m_pageWindowCount;
+
+  // Chapter records (96 bytes each) fitting between m_chapterOffset and the next section, the list can end earlier
+  static constexpr uint16_t CHAPTER_WINDOW_SIZE = 32;
+  ChapterInfo m_chapterWindow[CHAPTER_WINDOW_SIZE];
+  uint16_t m_chapterWindowStart;
+  uint16_t m_chapterWindowCount;
+  uint64_t m_chapterOffset;
+  uint16_t m_chapterRecordCount;
+  bool m_chaptersCounted;
+  uint16_t m_chapterCount;
+  std::vector<uint16_t> m_chapterRecords;  // Record of each chapter, only kept when some records are skipped
+
+  static constexpr uint8_t PAGE_CACHE_SLOTS = 2;
+  // Both slots take 40 of the buffer pool's 48 slabs, see BufferPool.h. Compressed 1-bit text pages fit, 2-bit ones
+  // (around 22KB) are mostly streamed.
+  static constexpr size_t PAGE_CACHE_SLOT_SIZE = 20000;
+  struct CachedPage {
+    uint8_t* data = nullptr;
+    XtgPageHeader header = {};
+    uint32_t pageIndex = 0;
+    bool valid = false;
+  };
+  CachedPage m_pageCache[PAGE_CACHE_SLOTS];
+  bool m_pageCacheEnabled = false;
+  uint8_t m_pageCacheRecent = 0;  // Slot of the page last loaded, kept when another page is read into the cache
+
   // Internal helper functions
   XtcError readHeader();
   XtcError readPageTable();
   XtcError readTitle();
   XtcError readAuthor();
   XtcError readChapters();
+  bool fillPageWindow(uint32_t pageIndex);
+  void countChapters();
+  bool fillChapterWindow(uint16_t index);
+  // Leaves the file at the page's bitmap data
+  XtcError readPageHeader(uint32_t pageIndex, XtgPageHeader& pageHeader);
+  size_t getBitmapSize(const XtgPageHeader& pageHeader) const;
+  size_t getStoredSize(const XtgPageHeader& pageHeader) const;
+  // Hands the expanded bitmap to callback a chunk at a time, from stored data in memory or, without it, the file
+  XtcError emitBitmap(const XtgPageHeader& pageHeader, const uint8_t* stored,
+                      const std::function<void(const uint8_t* data, size_t size, size_t offset)>& callback,
+                      size_t chunkSize);
+  // The cached page, read into the cache first if it fits. use marks it as the page last loaded.
+  const CachedPage* cachePage(uint32_t pageIndex, bool use, XtcError& error);
 };
 
 }  // namespace xtc
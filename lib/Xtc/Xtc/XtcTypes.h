@@ -12,7 +12,10 @@
 
 #pragma once
 
+#include <strings.h>
+
 #include <cstdint>
+#include <cstring>
 #include <string>
 
 namespace xtc {
@@ -70,8 +73,8 @@ struct XtgPageHeader {
   uint16_t width;       // 0x04: Image width (pixels)
   uint16_t height;      // 0x06: Image height (pixels)
   uint8_t colorMode;    // 0x08: Color mode (0=monochrome)
-  uint8_t compression;  // 0x09: Compression (0=uncompressed)
-  uint32_t dataSize;    // 0x0A: Image data size (bytes)
+  uint8_t compression;  // 0x09: Compression (0=uncompressed, 1=PackBits, one stream for the whole bitmap)
+  uint32_t dataSize;    // 0x0A: Image data size (bytes, as stored)
   uint64_t md5;         // 0x0E: MD5 checksum (first 8 bytes, optional)
   // Followed by bitmap data at offset 0x16 (22)
   //
@@ -86,6 +89,10 @@ struct XtgPageHeader {
 };
 #pragma pack(pop)
 
+// XtgPageHeader::compression
+constexpr uint8_t XTG_COMPRESSION_NONE = 0;
+constexpr uint8_t XTG_COMPRESSION_PACKBITS = 1;
+
 // Page information (internal use, optimized for memory)
 struct PageInfo {
   uint32_t offset;   // File offset to page data (max 4GB file size)
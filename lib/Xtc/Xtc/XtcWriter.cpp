@@ -0,0 +1,240 @@
+/**
+ * XtcWriter.cpp
+ *
+ * Writes XTC/XTCH books page by page
+ * XTC ebook support for CrossPoint Reader
+ */
+
+#include "XtcWriter.h"
+
+#include <BufferPool.h>
+#include <HardwareSerial.h>
+#include <SDCardManager.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace xtc {
+
+namespace {
+constexpr size_t CHAPTER_RECORD_SIZE = 96;
+constexpr uint32_t TITLE_OFFSET = 0x38;
+constexpr size_t TITLE_SIZE = 128;
+constexpr uint32_t AUTHOR_OFFSET = 0xB8;
+constexpr size_t AUTHOR_SIZE = 64;
+
+void writeString(BufferedFsWriter& writer, const std::string& value, const size_t fieldSize) {
+  uint8_t field[TITLE_SIZE] = {};
+  memcpy(field, value.data(), std::min(value.size(), fieldSize - 1));
+  writer.write(field, fieldSize);
+}
+}  // namespace
+
+bool XtcWriter::open(const std::string& path, const uint8_t bitDepth, const Progress* from) {
+  close();
+  this->bitDepth = bitDepth;
+  pageTablePath = path + ".pages";
+
+  if (!from) {
+    if (!SdMan.openFileForWrite("XTW", path, book) || !SdMan.openFileForWrite("XTW", pageTablePath, pageTable)) {
+      close();
+      return false;
+    }
+    // Zeros until finish(), the parser refuses a book without a magic or pages
+    const uint8_t header[DATA_OFFSET] = {};
+    if (book.write(header, sizeof(header)) != sizeof(header)) {
+      close();
+      return false;
+    }
+    dataEnd = DATA_OFFSET;
+    pageCount = 0;
+    return true;
+  }
+
+  // Whatever came after the last page that was reported done is dropped, the page in progress is written again
+  const uint32_t tableSize = from->pageCount * sizeof(PageTableEntry);
+  book = SdMan.open(path.c_str(), O_RDWR);
+  pageTable = SdMan.open(pageTablePath.c_str(), O_RDWR);
+  if (!book || !pageTable || from->dataEnd < DATA_OFFSET || book.size() < from->dataEnd ||
+      pageTable.size() < tableSize || !book.truncate(from->dataEnd) || !pageTable.truncate(tableSize) ||
+      !book.seek(from->dataEnd) || !pageTable.seek(tableSize)) {
+    Serial.printf("[%lu] [XTW] Can't continue %s at page %u\n", millis(), path.c_str(), from->pageCount);
+    close();
+    return false;
+  }
+  dataEnd = from->dataEnd;
+  pageCount = from->pageCount;
+  return true;
+}
+
+bool XtcWriter::addPage(uint8_t* frameBuffer, const DrawFn& draw) {
+  if (!book || pageCount == UINT16_MAX) {
+    return false;
+  }
+
+  XtgPageHeader pageHeader = {};
+  pageHeader.magic = bitDepth == 2 ? XTH_MAGIC : XTG_MAGIC;
+  pageHeader.width = DISPLAY_WIDTH;
+  pageHeader.height = DISPLAY_HEIGHT;
+  pageHeader.compression = XTG_COMPRESSION_PACKBITS;
+
+  // The header goes in first with no size and is written again once the compressed size is known
+  BufferedFsWriter writer(book);
+  writer.write(reinterpret_cast<const uint8_t*>(&pageHeader), sizeof(pageHeader));
+  bool written;
+  if (bitDepth == 2) {
+    written = writeXth(writer, frameBuffer, draw);
+  } else {
+    draw(PageBlitter::Target::Bw);
+    written = writeXtg(writer, frameBuffer);
+  }
+  const uint32_t pageEnd = writer.position();
+  pageHeader.dataSize = pageEnd - dataEnd - sizeof(pageHeader);
+  writer.seek(dataEnd);
+  writer.write(reinterpret_cast<const uint8_t*>(&pageHeader), sizeof(pageHeader));
+  writer.seek(pageEnd);
+  if (!writer.flush() || !written) {
+    Serial.printf("[%lu] [XTW] Failed to write page %u\n", millis(), pageCount);
+    return false;
+  }
+
+  PageTableEntry entry = {};
+  entry.dataOffset = dataEnd;
+  entry.dataSize = pageEnd - dataEnd;
+  entry.width = DISPLAY_WIDTH;
+  entry.height = DISPLAY_HEIGHT;
+  // Synced so the card holds everything getProgress() reports, even if the device loses power next
+  if (pageTable.write(reinterpret_cast<const uint8_t*>(&entry), sizeof(entry)) != sizeof(entry) || !book.sync() ||
+      !pageTable.sync()) {
+    Serial.printf("[%lu] [XTW] Failed to write page table entry %u\n", millis(), pageCount);
+    return false;
+  }
+  dataEnd = pageEnd;
+  pageCount++;
+  return true;
+}
+
+bool XtcWriter::writePacked(BufferedFsWriter& writer, const uint8_t* data, const size_t size) {
+  const size_t packedSize = packbits::pack(data, size, packed);
+  return writer.write(packed, packedSize) == packedSize;
+}
+
+bool XtcWriter::writeXtg(BufferedFsWriter& writer, const uint8_t* frameBuffer) {
+  // Panel byte column g holds page rows 8g to 8g + 7, page row bytes run up the panel from its last row
+  constexpr uint16_t rowBytes = DISPLAY_WIDTH / 8;
+  static_assert(CHUNK_SIZE == 8 * rowBytes, "A chunk is one group of 8 XTG rows");
+  for (uint16_t group = 0; group < PageBlitter::FRAME_ROW_BYTES; group++) {
+    for (uint16_t byteX = 0; byteX < rowBytes; byteX++) {
+      const uint8_t* column =
+          frameBuffer + (PageBlitter::FRAME_ROWS - 1 - byteX * 8) * PageBlitter::FRAME_ROW_BYTES + group;
+      uint64_t block = 0;
+      for (int i = 0; i < 8; i++) {
+        block = block << 8 | column[-i * PageBlitter::FRAME_ROW_BYTES];
+      }
+      block = transpose8x8(block);
+      for (int r = 0; r < 8; r++) {
+        chunk[r * rowBytes + byteX] = static_cast<uint8_t>(block >> (56 - 8 * r));
+      }
+    }
+    if (!writePacked(writer, chunk, CHUNK_SIZE)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool XtcWriter::writeXth(BufferedFsWriter& writer, uint8_t* frameBuffer, const DrawFn& draw) {
+  // Plane byte i is frame buffer byte i for a full screen page. Inverting PageBlitter's targets: plane 1 is set where
+  // the pixel is neither white in Bw nor dark grey in GrayscaleLsb, plane 2 is plane 1 xor GrayscaleMsb.
+  uint8_t* plane1 = BUFFER_POOL.lease(FRAME_SIZE, "xtcWriter");
+  if (!plane1) {
+    return false;
+  }
+
+  draw(PageBlitter::Target::Bw);
+  memcpy(plane1, frameBuffer, FRAME_SIZE);
+
+  bool written = true;
+  draw(PageBlitter::Target::GrayscaleLsb);
+  for (uint32_t offset = 0; offset < FRAME_SIZE && written; offset += CHUNK_SIZE) {
+    for (size_t i = 0; i < CHUNK_SIZE; i++) {
+      plane1[offset + i] = ~plane1[offset + i] & ~frameBuffer[offset + i];
+    }
+    written = writePacked(writer, plane1 + offset, CHUNK_SIZE);
+  }
+
+  draw(PageBlitter::Target::GrayscaleMsb);
+  for (uint32_t offset = 0; offset < FRAME_SIZE && written; offset += CHUNK_SIZE) {
+    for (size_t i = 0; i < CHUNK_SIZE; i++) {
+      chunk[i] = plane1[offset + i] ^ frameBuffer[offset + i];
+    }
+    written = writePacked(writer, chunk, CHUNK_SIZE);
+  }
+
+  BUFFER_POOL.release(plane1);
+  return written;
+}
+
+bool XtcWriter::finish(const std::string& title, const std::string& author, const std::vector<ChapterInfo>& chapters) {
+  if (!book || pageCount == 0) {
+    return false;
+  }
+
+  XtcHeader header = {};
+  header.magic = bitDepth == 2 ? XTCH_MAGIC : XTC_MAGIC;
+  header.versionMajor = 1;
+  header.pageCount = pageCount;
+  header.hasMetadata = 1;
+  header.hasChapters = chapters.empty() ? 0 : 1;
+  header.metadataOffset = TITLE_OFFSET;
+  header.pageTableOffset = dataEnd;
+  header.dataOffset = DATA_OFFSET;
+  const uint64_t chapterOffset = dataEnd + static_cast<uint64_t>(pageCount) * sizeof(PageTableEntry);
+  header.chapterOffset = chapters.empty() ? 0 : static_cast<uint32_t>(chapterOffset);
+  header.padding = chapters.empty() ? 0 : static_cast<uint32_t>(chapterOffset >> 32);
+
+  BufferedFsWriter writer(book);
+  // The page table, copied over from its own file
+  bool copied = pageTable.seek(0);
+  for (uint32_t left = pageCount * sizeof(PageTableEntry); left > 0 && copied;) {
+    const int bytesRead = pageTable.read(chunk, std::min<uint32_t>(left, CHUNK_SIZE));
+    copied = bytesRead > 0 && writer.write(chunk, bytesRead) == static_cast<size_t>(bytesRead);
+    left -= bytesRead > 0 ? bytesRead : 0;
+  }
+
+  for (const ChapterInfo& chapter : chapters) {
+    uint8_t record[CHAPTER_RECORD_SIZE] = {};
+    memcpy(record, chapter.name.data(), std::min<size_t>(chapter.name.size(), 79));
+    const uint16_t startPage = chapter.startPage + 1;
+    const uint16_t endPage = chapter.endPage + 1;
+    memcpy(record + 0x50, &startPage, sizeof(startPage));
+    memcpy(record + 0x52, &endPage, sizeof(endPage));
+    writer.write(record, sizeof(record));
+  }
+
+  writer.seek(0);
+  writer.write(reinterpret_cast<const uint8_t*>(&header), sizeof(header));
+  writer.seek(TITLE_OFFSET);
+  writeString(writer, title, TITLE_SIZE);
+  writer.seek(AUTHOR_OFFSET);
+  writeString(writer, author, AUTHOR_SIZE);
+  if (!writer.flush() || !copied) {
+    Serial.printf("[%lu] [XTW] Failed to finish the book\n", millis());
+    return false;
+  }
+
+  close();
+  SdMan.remove(pageTablePath.c_str());
+  return true;
+}
+
+void XtcWriter::close() {
+  if (book) {
+    book.close();
+  }
+  if (pageTable) {
+    pageTable.close();
+  }
+}
+
+}  // namespace xtc
@@ -0,0 +1,79 @@
+/**
+ * XtcWriter.h
+ *
+ * Writes XTC/XTCH books page by page
+ * XTC ebook support for CrossPoint Reader
+ */
+
+#pragma once
+
+#include <BufferedFs.h>
+#include <PackBits.h>
+#include <SdFat.h>
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "XtcPageBlitter.h"
+#include "XtcTypes.h"
+
+namespace xtc {
+
+/**
+ * Builds a book out of frame buffers, PageBlitter run backwards. Every page is a full screen XTG (XTC) or XTH (XTCH)
+ * page, PackBits compressed a few rows at a time as it is written, so no page is ever held in memory. An XTH page is
+ * made of the three frame buffers the reader builds from it, drawn one after the other: the first is kept in a buffer
+ * pool lease until the second has been combined with it.
+ *
+ * Pages follow a reserved header, their page table entries go to a file next to the book. finish() appends the table
+ * and the chapters and writes the header last, so a book that was never finished does not open. getProgress() is all
+ * it takes to carry on with an unfinished book later, e.g. after the device slept.
+ */
+class XtcWriter {
+ public:
+  struct Progress {
+    uint32_t dataEnd;  // End of the last complete page
+    uint16_t pageCount;
+  };
+
+  // Leaves in frameBuffer what the reader builds from the page for target
+  using DrawFn = std::function<void(PageBlitter::Target target)>;
+
+  XtcWriter() = default;
+  ~XtcWriter() { close(); }
+  XtcWriter(const XtcWriter&) = delete;
+  XtcWriter& operator=(const XtcWriter&) = delete;
+
+  // Starts a new book at path, or with from carries on with one written up to there, dropping anything after it
+  bool open(const std::string& path, uint8_t bitDepth, const Progress* from = nullptr);
+  // Draws and writes one page: the Bw target for XTC, then GrayscaleLsb and GrayscaleMsb as well for XTCH
+  bool addPage(uint8_t* frameBuffer, const DrawFn& draw);
+  // Appends the page table and chapters (page numbers from 0) and writes the header, the book is complete after this
+  bool finish(const std::string& title, const std::string& author, const std::vector<ChapterInfo>& chapters);
+  // Closes the files, an unfinished book can be continued with getProgress()
+  void close();
+
+  Progress getProgress() const { return {dataEnd, pageCount}; }
+
+ private:
+  // Title and author follow the header, pages start at the next sector boundary
+  static constexpr uint32_t DATA_OFFSET = 0x100;
+  static constexpr size_t CHUNK_SIZE = 480;  // 8 XTG rows, 4.8 XTH plane columns
+  static constexpr uint32_t FRAME_SIZE = PageBlitter::FRAME_ROWS * PageBlitter::FRAME_ROW_BYTES;
+
+  bool writePacked(BufferedFsWriter& writer, const uint8_t* data, size_t size);
+  bool writeXtg(BufferedFsWriter& writer, const uint8_t* frameBuffer);
+  bool writeXth(BufferedFsWriter& writer, uint8_t* frameBuffer, const DrawFn& draw);
+
+  FsFile book;
+  FsFile pageTable;
+  std::string pageTablePath;
+  uint8_t bitDepth = 1;
+  uint32_t dataEnd = 0;
+  uint16_t pageCount = 0;
+  uint8_t chunk[CHUNK_SIZE] = {};
+  uint8_t packed[packbits::bound(CHUNK_SIZE)] = {};
+};
+
+}  // namespace xtc
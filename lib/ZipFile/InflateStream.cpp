@@ -0,0 +1,60 @@
+#include "InflateStream.h"
+
+#include <BufferPool.h>
+#include <Logging.h>
+#include <Perf.h>
+#include <miniz.h>
+
+#include <cstring>
+
+InflateStream::~InflateStream() {
+  if (inflator) {
+    BUFFER_POOL.release(reinterpret_cast<uint8_t*>(inflator));
+  }
+  if (window) {
+    BUFFER_POOL.release(window);
+  }
+}
+
+bool InflateStream::begin(const bool zlibHeader) {
+  inflator = reinterpret_cast<tinfl_decompressor*>(BUFFER_POOL.lease(sizeof(tinfl_decompressor), "inflator"));
+  if (!inflator) {
+    LOG_E(ZIP, "Failed to allocate memory for inflator");
+    return false;
+  }
+  memset(inflator, 0, sizeof(tinfl_decompressor));
+  tinfl_init(inflator);
+
+  window = BUFFER_POOL.lease(TINFL_LZ_DICT_SIZE, "inflateDict");
+  if (!window) {
+    LOG_E(ZIP, "Failed to allocate memory for dictionary");
+    return false;
+  }
+  memset(window, 0, TINFL_LZ_DICT_SIZE);
+  windowCursor = 0;
+  flags = zlibHeader ? TINFL_FLAG_PARSE_ZLIB_HEADER : 0;
+  return true;
+}
+
+InflateStream::Status InflateStream::inflate(const uint8_t* in, size_t& inBytes, const bool moreInput,
+                                             const uint8_t*& out, size_t& outBytes) {
+  // Space remaining in the window before it wraps
+  outBytes = TINFL_LZ_DICT_SIZE - windowCursor;
+
+  tinfl_status status;
+  {
+    PERF_SCOPE(INFLATE);
+    status = tinfl_decompress(inflator, in, &inBytes, window, window + windowCursor, &outBytes,
+                              flags | (moreInput ? TINFL_FLAG_HAS_MORE_INPUT : 0));
+  }
+  PERF_COUNT(INFLATED_BYTES, outBytes);
+
+  out = window + windowCursor;
+  windowCursor = (windowCursor + outBytes) & (TINFL_LZ_DICT_SIZE - 1);
+
+  if (status < 0) {
+    LOG_E(ZIP, "tinfl_decompress() failed with status %d", status);
+    return Status::Failed;
+  }
+  return status == TINFL_STATUS_DONE ? Status::Done : Status::Ok;
+}
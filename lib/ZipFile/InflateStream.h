@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+struct tinfl_decompressor_tag;
+
+/**
+ * Streaming inflate over a TINFL_LZ_DICT_SIZE circular window, for data too large to inflate in one go. Compressed
+ * bytes go in a chunk at a time, the bytes each call produced are handed back as a slice of the window and stay valid
+ * until the next call. Used for zip entries and PNG image data.
+ */
+class InflateStream {
+ public:
+  enum class Status { Ok, Done, Failed };
+
+  InflateStream() = default;
+  ~InflateStream();
+  InflateStream(const InflateStream&) = delete;
+  InflateStream& operator=(const InflateStream&) = delete;
+
+  // Leases the decompressor and the window, false when out of memory. zlibHeader parses and checks the zlib wrapper
+  // around the deflate data (PNG), a zip entry is raw deflate.
+  bool begin(bool zlibHeader = false);
+
+  // Inflates from in, inBytes is set to the bytes consumed. moreInput is false once in holds the last of the data.
+  // out and outBytes are set to what was produced, which may be nothing while tinfl waits for input.
+  Status inflate(const uint8_t* in, size_t& inBytes, bool moreInput, const uint8_t*& out, size_t& outBytes);
+
+ private:
+  tinfl_decompressor_tag* inflator = nullptr;
+  uint8_t* window = nullptr;
+  size_t windowCursor = 0;
+  uint32_t flags = 0;
+};
@@ -1,16 +1,21 @@
 #include "ZipFile.h"
 
-#include <HardwareSerial.h>
+#include <BufferPool.h>
+#include <Logging.h>
+#include <Perf.h>
 #include <SDCardManager.h>
 #include <miniz.h>
 
 #include <algorithm>
 
+#include "InflateStream.h"
+
 bool inflateOneShot(const uint8_t* inputBuf, const size_t deflatedSize, uint8_t* outputBuf, const size_t inflatedSize) {
   // Setup inflator
-  const auto inflator = static_cast<tinfl_decompressor*>(malloc(sizeof(tinfl_decompressor)));
+  const auto inflator =
+      reinterpret_cast<tinfl_decompressor*>(BUFFER_POOL.lease(sizeof(tinfl_decompressor), "inflator"));
   if (!inflator) {
-    Serial.printf("[%lu] [ZIP] Failed to allocate memory for inflator\n", millis());
+    LOG_E(ZIP, "Failed to allocate memory for inflator");
     return false;
   }
   memset(inflator, 0, sizeof(tinfl_decompressor));
@@ -18,12 +23,17 @@ bool inflateOneShot(const uint8_t* inputBuf, const size_t deflatedSize, uint8_t*
 
   size_t inBytes = deflatedSize;
   size_t outBytes = inflatedSize;
-  const tinfl_status status = tinfl_decompress(inflator, inputBuf, &inBytes, nullptr, outputBuf, &outBytes,
-                                               TINFL_FLAG_USING_NON_WRAPPING_OUTPUT_BUF);
-  free(inflator);
+  tinfl_status status;
+  {
+    PERF_SCOPE(INFLATE);
+    status = tinfl_decompress(inflator, inputBuf, &inBytes, nullptr, outputBuf, &outBytes,
+                              TINFL_FLAG_USING_NON_WRAPPING_OUTPUT_BUF);
+  }
+  PERF_COUNT(INFLATED_BYTES, outBytes);
+  BUFFER_POOL.release(reinterpret_cast<uint8_t*>(inflator));
 
   if (status != TINFL_STATUS_DONE) {
-    Serial.printf("[%lu] [ZIP] tinfl_decompress() failed with status %d\n", millis(), status);
+    LOG_E(ZIP, "tinfl_decompress() failed with status %d", status);
     return false;
   }
 
@@ -195,13 +205,13 @@ long ZipFile::getDataOffset(const FileStatSlim& fileStat) {
   }
 
   if (read != localHeaderSize) {
-    Serial.printf("[%lu] [ZIP] Something went wrong reading the local header\n", millis());
+    LOG_E(ZIP, "Something went wrong reading the local header");
     return -1;
   }
 
   if (pLocalHeader[0] + (pLocalHeader[1] << 8) + (pLocalHeader[2] << 16) + (pLocalHeader[3] << 24) !=
       0x04034b50 /* MZ_ZIP_LOCAL_DIR_HEADER_SIG */) {
-    Serial.printf("[%lu] [ZIP] Not a valid zip file header\n", millis());
+    LOG_E(ZIP, "Not a valid zip file header");
     return -1;
   }
 
@@ -222,7 +232,7 @@ bool ZipFile::loadZipDetails() {
 
   const size_t fileSize = file.size();
   if (fileSize < 22) {
-    Serial.printf("[%lu] [ZIP] File too small to be a valid zip\n", millis());
+    LOG_E(ZIP, "File too small to be a valid zip");
     if (!wasOpen) {
       close();
     }
@@ -234,7 +244,7 @@ bool ZipFile::loadZipDetails() {
   const int scanRange = fileSize > 1024 ? 1024 : fileSize;
   const auto buffer = static_cast<uint8_t*>(malloc(scanRange));
   if (!buffer) {
-    Serial.printf("[%lu] [ZIP] Failed to allocate memory for EOCD scan buffer\n", millis());
+    LOG_E(ZIP, "Failed to allocate memory for EOCD scan buffer");
     if (!wasOpen) {
       close();
     }
@@ -255,7 +265,7 @@ bool ZipFile::loadZipDetails() {
   }
 
   if (foundOffset == -1) {
-    Serial.printf("[%lu] [ZIP] EOCD signature not found in zip file\n", millis());
+    LOG_E(ZIP, "EOCD signature not found in zip file");
     free(buffer);
     if (!wasOpen) {
       close();
@@ -407,7 +417,7 @@ uint8_t* ZipFile::readFileToMemory(const char* filename, size_t* size, const boo
   const auto dataSize = trailingNullByte ? inflatedDataSize + 1 : inflatedDataSize;
   const auto data = static_cast<uint8_t*>(malloc(dataSize));
   if (data == nullptr) {
-    Serial.printf("[%lu] [ZIP] Failed to allocate memory for output buffer (%zu bytes)\n", millis(), dataSize);
+    LOG_E(ZIP, "Failed to allocate memory for output buffer (%zu bytes)", dataSize);
     if (!wasOpen) {
       close();
     }
@@ -422,7 +432,7 @@ uint8_t* ZipFile::readFileToMemory(const char* filename, size_t* size, const boo
     }
 
     if (dataRead != inflatedDataSize) {
-      Serial.printf("[%lu] [ZIP] Failed to read data\n", millis());
+      LOG_E(ZIP, "Failed to read data");
       free(data);
       return nullptr;
     }
@@ -432,7 +442,7 @@ uint8_t* ZipFile::readFileToMemory(const char* filename, size_t* size, const boo
     // Read out deflated content from file
     const auto deflatedData = static_cast<uint8_t*>(malloc(deflatedDataSize));
     if (deflatedData == nullptr) {
-      Serial.printf("[%lu] [ZIP] Failed to allocate memory for decompression buffer\n", millis());
+      LOG_E(ZIP, "Failed to allocate memory for decompression buffer");
       if (!wasOpen) {
         close();
       }
@@ -445,7 +455,7 @@ uint8_t* ZipFile::readFileToMemory(const char* filename, size_t* size, const boo
     }
 
     if (dataRead != deflatedDataSize) {
-      Serial.printf("[%lu] [ZIP] Failed to read data, expected %d got %d\n", millis(), deflatedDataSize, dataRead);
+      LOG_E(ZIP, "Failed to read data, expected %d got %d", deflatedDataSize, dataRead);
       free(deflatedData);
       free(data);
       return nullptr;
@@ -455,14 +465,14 @@ uint8_t* ZipFile::readFileToMemory(const char* filename, size_t* size, const boo
     free(deflatedData);
 
     if (!success) {
-      Serial.printf("[%lu] [ZIP] Failed to inflate file\n", millis());
+      LOG_E(ZIP, "Failed to inflate file");
       free(data);
       return nullptr;
     }
 
     // Continue out of block with data set
   } else {
-    Serial.printf("[%lu] [ZIP] Unsupported compression method\n", millis());
+    LOG_E(ZIP, "Unsupported compression method");
     if (!wasOpen) {
       close();
     }
@@ -498,7 +508,7 @@ bool ZipFile::readFileToStream(const char* filename, Print& out, const size_t ch
     // no deflation, just read content
     const auto buffer = static_cast<uint8_t*>(malloc(chunkSize));
     if (!buffer) {
-      Serial.printf("[%lu] [ZIP] Failed to allocate memory for buffer\n", millis());
+      LOG_E(ZIP, "Failed to allocate memory for buffer");
       if (!wasOpen) {
         close();
       }
@@ -509,7 +519,7 @@ bool ZipFile::readFileToStream(const char* filename, Print& out, const size_t ch
     while (remaining > 0) {
       const size_t dataRead = file.read(buffer, remaining < chunkSize ? remaining : chunkSize);
       if (dataRead == 0) {
-        Serial.printf("[%lu] [ZIP] Could not read more bytes\n", millis());
+        LOG_E(ZIP, "Could not read more bytes");
         free(buffer);
         if (!wasOpen) {
           close();
@@ -529,46 +539,27 @@ bool ZipFile::readFileToStream(const char* filename, Print& out, const size_t ch
   }
 
   if (fileStat.method == MZ_DEFLATED) {
-    // Setup inflator
-    const auto inflator = static_cast<tinfl_decompressor*>(malloc(sizeof(tinfl_decompressor)));
-    if (!inflator) {
-      Serial.printf("[%lu] [ZIP] Failed to allocate memory for inflator\n", millis());
+    InflateStream inflater;
+    if (!inflater.begin()) {
       if (!wasOpen) {
         close();
       }
       return false;
     }
-    memset(inflator, 0, sizeof(tinfl_decompressor));
-    tinfl_init(inflator);
 
     // Setup file read buffer
     const auto fileReadBuffer = static_cast<uint8_t*>(malloc(chunkSize));
     if (!fileReadBuffer) {
-      Serial.printf("[%lu] [ZIP] Failed to allocate memory for zip file read buffer\n", millis());
-      free(inflator);
-      if (!wasOpen) {
-        close();
-      }
-      return false;
-    }
-
-    const auto outputBuffer = static_cast<uint8_t*>(malloc(TINFL_LZ_DICT_SIZE));
-    if (!outputBuffer) {
-      Serial.printf("[%lu] [ZIP] Failed to allocate memory for dictionary\n", millis());
-      free(inflator);
-      free(fileReadBuffer);
+      LOG_E(ZIP, "Failed to allocate memory for zip file read buffer");
       if (!wasOpen) {
         close();
       }
       return false;
     }
-    memset(outputBuffer, 0, TINFL_LZ_DICT_SIZE);
 
     size_t fileRemainingBytes = deflatedDataSize;
-    size_t processedOutputBytes = 0;
     size_t fileReadBufferFilledBytes = 0;
     size_t fileReadBufferCursor = 0;
-    size_t outputCursor = 0;  // Current offset in the circular dictionary
 
     while (true) {
       // Load more compressed bytes when needed
@@ -578,8 +569,12 @@ bool ZipFile::readFileToStream(const char* filename, Print& out, const size_t ch
           break;  // EOF
         }
 
-        fileReadBufferFilledBytes =
-            file.read(fileReadBuffer, fileRemainingBytes < chunkSize ? fileRemainingBytes : chunkSize);
+        {
+          PERF_SCOPE(SD_READ);
+          fileReadBufferFilledBytes =
+              file.read(fileReadBuffer, fileRemainingBytes < chunkSize ? fileRemainingBytes : chunkSize);
+        }
+        PERF_COUNT(SD_BYTES_READ, fileReadBufferFilledBytes);
         fileRemainingBytes -= fileReadBufferFilledBytes;
         fileReadBufferCursor = 0;
 
@@ -591,65 +586,48 @@ bool ZipFile::readFileToStream(const char* filename, Print& out, const size_t ch
 
       // Available bytes in fileReadBuffer to process
       size_t inBytes = fileReadBufferFilledBytes - fileReadBufferCursor;
-      // Space remaining in outputBuffer
-      size_t outBytes = TINFL_LZ_DICT_SIZE - outputCursor;
-
-      const tinfl_status status = tinfl_decompress(inflator, fileReadBuffer + fileReadBufferCursor, &inBytes,
-                                                   outputBuffer, outputBuffer + outputCursor, &outBytes,
-                                                   fileRemainingBytes > 0 ? TINFL_FLAG_HAS_MORE_INPUT : 0);
+      const uint8_t* output;
+      size_t outBytes;
+      const auto status = inflater.inflate(fileReadBuffer + fileReadBufferCursor, inBytes, fileRemainingBytes > 0,
+                                           output, outBytes);
 
       // Update input position
       fileReadBufferCursor += inBytes;
 
       // Write output chunk
-      if (outBytes > 0) {
-        processedOutputBytes += outBytes;
-        if (out.write(outputBuffer + outputCursor, outBytes) != outBytes) {
-          Serial.printf("[%lu] [ZIP] Failed to write all output bytes to stream\n", millis());
-          if (!wasOpen) {
-            close();
-          }
-          free(outputBuffer);
-          free(fileReadBuffer);
-          free(inflator);
-          return false;
+      if (outBytes > 0 && out.write(output, outBytes) != outBytes) {
+        LOG_E(ZIP, "Failed to write all output bytes to stream");
+        if (!wasOpen) {
+          close();
         }
-        // Update output position in buffer (with wraparound)
-        outputCursor = (outputCursor + outBytes) & (TINFL_LZ_DICT_SIZE - 1);
+        free(fileReadBuffer);
+        return false;
       }
 
-      if (status < 0) {
-        Serial.printf("[%lu] [ZIP] tinfl_decompress() failed with status %d\n", millis(), status);
+      if (status == InflateStream::Status::Failed) {
         if (!wasOpen) {
           close();
         }
-        free(outputBuffer);
         free(fileReadBuffer);
-        free(inflator);
         return false;
       }
 
-      if (status == TINFL_STATUS_DONE) {
-        Serial.printf("[%lu] [ZIP] Decompressed %d bytes into %d bytes\n", millis(), deflatedDataSize,
-                      inflatedDataSize);
+      if (status == InflateStream::Status::Done) {
+        LOG_D(ZIP, "Decompressed %d bytes into %d bytes", deflatedDataSize, inflatedDataSize);
         if (!wasOpen) {
           close();
         }
-        free(inflator);
         free(fileReadBuffer);
-        free(outputBuffer);
         return true;
       }
     }
 
     // If we get here, EOF reached without TINFL_STATUS_DONE
-    Serial.printf("[%lu] [ZIP] Unexpected EOF\n", millis());
+    LOG_E(ZIP, "Unexpected EOF");
     if (!wasOpen) {
       close();
     }
-    free(outputBuffer);
     free(fileReadBuffer);
-    free(inflator);
     return false;
   }
 
@@ -657,6 +635,6 @@ bool ZipFile::readFileToStream(const char* filename, Print& out, const size_t ch
     close();
   }
 
-  Serial.printf("[%lu] [ZIP] Unsupported compression method\n", millis());
+  LOG_E(ZIP, "Unsupported compression method");
   return false;
 }
@@ -1,7 +1,15 @@
 #include <HalGPIO.h>
+
+#if CROSSPOINT_EMULATED == 0
 #include <SPI.h>
 #include <esp_sleep.h>
+#else
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#endif
 
+#if CROSSPOINT_EMULATED == 0
 void HalGPIO::begin() {
   inputMgr.begin();
   SPI.begin(EPD_SCLK, SPI_MISO, EPD_MOSI, EPD_CS);
@@ -53,3 +61,144 @@ bool HalGPIO::isWakeupByPowerButton() const {
     return (wakeupCause == ESP_SLEEP_WAKEUP_UNDEFINED) && (resetReason == ESP_RST_POWERON);
   }
 }
+#else
+namespace {
+// Default press length for "tap" and gap after every release so consecutive taps register as separate presses
+constexpr unsigned long DEFAULT_TAP_MS = 100;
+constexpr unsigned long RELEASE_GAP_MS = 150;
+
+int buttonIndexFromName(const char* name) {
+  static const char* const names[] = {"BACK", "CONFIRM", "LEFT", "RIGHT", "UP", "DOWN", "POWER"};
+  for (int i = 0; i < static_cast<int>(sizeof(names) / sizeof(names[0])); i++) {
+    if (strcasecmp(name, names[i]) == 0) {
+      return i;
+    }
+  }
+  return -1;
+}
+}  // namespace
+
+// Script format, one command per line, '#' starts a comment:
+//   wait <ms>                advance the timeline
+//   tap <BUTTON> [ms]        press, hold for ms (default 100) and release
+//   press <BUTTON>           press and keep holding
+//   release <BUTTON>         release a held button
+// Buttons: BACK, CONFIRM, LEFT, RIGHT, UP, DOWN, POWER
+bool HalGPIO::loadInputScript(const std::string& path) {
+  FILE* script = fopen(path.c_str(), "r");
+  if (!script) {
+    Serial.printf("[%lu] [GPIO] Failed to open input script: %s\n", millis(), path.c_str());
+    return false;
+  }
+
+  unsigned long cursor = 0;
+  uint8_t mask = 0;
+  char line[128];
+  int lineNumber = 0;
+  while (fgets(line, sizeof(line), script)) {
+    lineNumber++;
+    if (char* comment = strchr(line, '#')) {
+      *comment = '\0';
+    }
+
+    char command[16] = {};
+    char argument[16] = {};
+    unsigned long value = 0;
+    const int fields = sscanf(line, "%15s %15s %lu", command, argument, &value);
+    if (fields <= 0) {
+      continue;
+    }
+
+    if (strcasecmp(command, "wait") == 0) {
+      cursor += strtoul(argument, nullptr, 10);
+      continue;
+    }
+
+    const int button = buttonIndexFromName(argument);
+    if (button < 0) {
+      Serial.printf("[%lu] [GPIO] Input script line %d: unknown button '%s'\n", millis(), lineNumber, argument);
+      continue;
+    }
+
+    const uint8_t bit = 1 << button;
+    if (strcasecmp(command, "tap") == 0) {
+      inputEvents.push_back({cursor, static_cast<uint8_t>(mask | bit)});
+      cursor += fields == 3 ? value : DEFAULT_TAP_MS;
+      inputEvents.push_back({cursor, mask});
+      cursor += RELEASE_GAP_MS;
+    } else if (strcasecmp(command, "press") == 0) {
+      mask |= bit;
+      inputEvents.push_back({cursor, mask});
+    } else if (strcasecmp(command, "release") == 0) {
+      mask &= ~bit;
+      inputEvents.push_back({cursor, mask});
+      cursor += RELEASE_GAP_MS;
+    } else {
+      Serial.printf("[%lu] [GPIO] Input script line %d: unknown command '%s'\n", millis(), lineNumber, command);
+    }
+  }
+  fclose(script);
+
+  scriptEndMs = cursor;
+  Serial.printf("[%lu] [GPIO] Loaded %zu input events spanning %lu ms\n", millis(), inputEvents.size(), scriptEndMs);
+  return true;
+}
+
+void HalGPIO::begin() {
+  scriptStartMs = millis();
+  const char* scriptPath = getenv("CROSSPOINT_INPUT_SCRIPT");
+  if (scriptPath && scriptPath[0] != '\0') {
+    loadInputScript(scriptPath);
+  }
+}
+
+void HalGPIO::update() {
+  uint8_t newState = currentState;
+  // Apply at most one event per update so every press and release is observed by the activity loop
+  if (nextEvent < inputEvents.size() && millis() - scriptStartMs >= inputEvents[nextEvent].atMs) {
+    newState = inputEvents[nextEvent++].buttonMask;
+  }
+
+  pressedEvents = newState & ~currentState;
+  releasedEvents = currentState & ~newState;
+  if (pressedEvents && currentState == 0) {
+    pressStartMs = millis();
+  }
+  if (releasedEvents && newState == 0) {
+    lastHeldMs = millis() - pressStartMs;
+  }
+  currentState = newState;
+}
+
+bool HalGPIO::isPressed(uint8_t buttonIndex) const { return currentState & (1 << buttonIndex); }
+
+bool HalGPIO::wasPressed(uint8_t buttonIndex) const { return pressedEvents & (1 << buttonIndex); }
+
+bool HalGPIO::wasAnyPressed() const { return pressedEvents != 0; }
+
+bool HalGPIO::wasReleased(uint8_t buttonIndex) const { return releasedEvents & (1 << buttonIndex); }
+
+bool HalGPIO::wasAnyReleased() const { return releasedEvents != 0; }
+
+unsigned long HalGPIO::getHeldTime() const { return currentState ? millis() - pressStartMs : lastHeldMs; }
+
+void HalGPIO::startDeepSleep() {
+  // Deep sleep ends execution on the device, waking up runs setup() again from scratch
+  Serial.printf("[%lu] [GPIO] Deep sleep requested, stopping emulator\n", millis());
+  fflush(stdout);
+  _Exit(0);
+}
+
+int HalGPIO::getBatteryPercentage() const {
+  static const BatteryMonitor battery = BatteryMonitor(BAT_GPIO0);
+  return battery.readPercentage();
+}
+
+bool HalGPIO::isUsbConnected() const { return true; }
+
+bool HalGPIO::isWakeupByPowerButton() const { return false; }
+
+bool HalGPIO::isInputScriptFinished() const {
+  return nextEvent >= inputEvents.size() && millis() - scriptStartMs >= scriptEndMs;
+}
+#endif
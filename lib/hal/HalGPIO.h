@@ -2,7 +2,12 @@
 
 #include <Arduino.h>
 #include <BatteryMonitor.h>
+#if CROSSPOINT_EMULATED == 0
 #include <InputManager.h>
+#else
+#include <string>
+#include <vector>
+#endif
 
 // Display SPI pins (custom pins for XteinkX4, not hardware SPI defaults)
 #define EPD_SCLK 8   // SPI Clock
@@ -21,6 +26,23 @@
 class HalGPIO {
 #if CROSSPOINT_EMULATED == 0
   InputManager inputMgr;
+#else
+  // Scripted input: button state changes at fixed times since begin(), loaded from $CROSSPOINT_INPUT_SCRIPT
+  struct InputEvent {
+    unsigned long atMs;
+    uint8_t buttonMask;
+  };
+  std::vector<InputEvent> inputEvents;
+  size_t nextEvent = 0;
+  unsigned long scriptStartMs = 0;
+  unsigned long scriptEndMs = 0;
+  uint8_t currentState = 0;
+  uint8_t pressedEvents = 0;
+  uint8_t releasedEvents = 0;
+  unsigned long pressStartMs = 0;
+  unsigned long lastHeldMs = 0;
+
+  bool loadInputScript(const std::string& path);
 #endif
 
  public:
@@ -50,6 +72,11 @@ class HalGPIO {
   // Check if wakeup was caused by power button press
   bool isWakeupByPowerButton() const;
 
+#if CROSSPOINT_EMULATED == 1
+  // True once every scripted input event has been replayed and its trailing wait has elapsed
+  bool isInputScriptFinished() const;
+#endif
+
   // Button indices
   static constexpr uint8_t BTN_BACK = 0;
   static constexpr uint8_t BTN_CONFIRM = 1;
@@ -223,6 +223,7 @@ static pjpeg_need_bytes_callback_t g_pNeedBytesCallback;
 static void* g_pCallback_data;
 static uint8 gCallbackStatus;
 static uint8 gReduce;
+static uint8 gReducedBlockSize;  // Pixels per block side for PJPG_REDUCE_QUARTER and PJPG_REDUCE_HALF
 //------------------------------------------------------------------------------
 static void fillInBuf(void) {
   unsigned char status;
@@ -1907,6 +1908,209 @@ static void transformBlockReduce(uint8 mcuBlock) {
   }
 }
 //------------------------------------------------------------------------------
+// Reduced size IDCT weights, [u][x]: the N-point IDCT of the first N coefficients of a row or column, divided by the
+// Winograd scale factors the dequantized coefficients carry. Each frequency is also damped by the average of its
+// cosine over the 8/N pixels an output pixel covers, so the result is the mean of those pixels less the dropped
+// frequencies. 4.12 fixed point, the 1/8 normalisation of the 2D IDCT is split between the row and the column pass.
+static const int16 gReducedIdct4[4][4] = {
+    {362, 362, 362, 362}, {334, 139, -139, -334}, {256, -256, -256, 256}, {139, -334, 334, -139}};
+static const int16 gReducedIdct2[2][2] = {{362, 362}, {237, -237}};
+
+// IDCT of the top left NxN coefficients into NxN pixels, written over them in gCoeffBuf
+static void idctReduced(void) {
+  const uint8 n = gReducedBlockSize;
+  const int16* pWeights = (n == 4) ? &gReducedIdct4[0][0] : &gReducedIdct2[0][0];
+  long rows[4][4];
+  uint8 u, v, x, y;
+
+  // Rows, 12.4 fixed point
+  for (v = 0; v < n; v++) {
+    for (x = 0; x < n; x++) {
+      long sum = 0;
+      for (u = 0; u < n; u++) sum += (long)gCoeffBuf[v * 8 + u] * pWeights[u * n + x];
+      rows[v][x] = (sum + 128L) >> 8;
+    }
+  }
+
+  // Columns
+  for (y = 0; y < n; y++) {
+    for (x = 0; x < n; x++) {
+      long sum = 0;
+      for (v = 0; v < n; v++) sum += rows[v][x] * pWeights[v * n + y];
+      gCoeffBuf[y * 8 + x] = clamp((int16)((sum + 32768L) >> 16) + 128);
+    }
+  }
+}
+/*----------------------------------------------------------------------------*/
+// Convert Y to RGB, NxN pixels
+static void copyYReduced(uint8 dstOfs) {
+  const uint8 n = gReducedBlockSize;
+  uint8 x, y;
+
+  for (y = 0; y < n; y++) {
+    for (x = 0; x < n; x++) {
+      uint8 c = (uint8)gCoeffBuf[y * 8 + x];
+      uint8 ofs = dstOfs + y * 8 + x;
+
+      gMCUBufR[ofs] = c;
+      gMCUBufG[ofs] = c;
+      gMCUBufB[ofs] = c;
+    }
+  }
+}
+/*----------------------------------------------------------------------------*/
+// Cb convert to RGB and accumulate, NxN pixels of the Y block at dstOfs. The Y block starts at (srcX, srcY) in the Cb
+// block, hShift and vShift are 1 in the directions Cb is subsampled in.
+static void convertCbReduced(uint8 dstOfs, uint8 srcX, uint8 srcY, uint8 hShift, uint8 vShift) {
+  const uint8 n = gReducedBlockSize;
+  uint8 x, y;
+
+  for (y = 0; y < n; y++) {
+    for (x = 0; x < n; x++) {
+      uint8 cb = (uint8)gCoeffBuf[((srcY + y) >> vShift) * 8 + ((srcX + x) >> hShift)];
+      uint8 ofs = dstOfs + y * 8 + x;
+      int16 cbG, cbB;
+
+      cbG = ((cb * 88U) >> 8U) - 44U;
+      gMCUBufG[ofs] = subAndClamp(gMCUBufG[ofs], cbG);
+
+      cbB = (cb + ((cb * 198U) >> 8U)) - 227U;
+      gMCUBufB[ofs] = addAndClamp(gMCUBufB[ofs], cbB);
+    }
+  }
+}
+/*----------------------------------------------------------------------------*/
+// Cr convert to RGB and accumulate, same arguments as convertCbReduced()
+static void convertCrReduced(uint8 dstOfs, uint8 srcX, uint8 srcY, uint8 hShift, uint8 vShift) {
+  const uint8 n = gReducedBlockSize;
+  uint8 x, y;
+
+  for (y = 0; y < n; y++) {
+    for (x = 0; x < n; x++) {
+      uint8 cr = (uint8)gCoeffBuf[((srcY + y) >> vShift) * 8 + ((srcX + x) >> hShift)];
+      uint8 ofs = dstOfs + y * 8 + x;
+      int16 crR, crG;
+
+      crR = (cr + ((cr * 103U) >> 8U)) - 179;
+      gMCUBufR[ofs] = addAndClamp(gMCUBufR[ofs], crR);
+
+      crG = ((cr * 183U) >> 8U) - 91;
+      gMCUBufG[ofs] = subAndClamp(gMCUBufG[ofs], crG);
+    }
+  }
+}
+//------------------------------------------------------------------------------
+static void transformBlockReduced(uint8 mcuBlock) {
+  const uint8 n = gReducedBlockSize;
+
+  idctReduced();
+
+  switch (gScanType) {
+    case PJPG_GRAYSCALE: {
+      copyYReduced(0);
+      break;
+    }
+    case PJPG_YH1V1: {
+      switch (mcuBlock) {
+        case 0: {
+          copyYReduced(0);
+          break;
+        }
+        case 1: {
+          convertCbReduced(0, 0, 0, 0, 0);
+          break;
+        }
+        case 2: {
+          convertCrReduced(0, 0, 0, 0, 0);
+          break;
+        }
+      }
+      break;
+    }
+    case PJPG_YH1V2: {
+      switch (mcuBlock) {
+        case 0: {
+          copyYReduced(0);
+          break;
+        }
+        case 1: {
+          copyYReduced(128);
+          break;
+        }
+        case 2: {
+          convertCbReduced(0, 0, 0, 0, 1);
+          convertCbReduced(128, 0, n, 0, 1);
+          break;
+        }
+        case 3: {
+          convertCrReduced(0, 0, 0, 0, 1);
+          convertCrReduced(128, 0, n, 0, 1);
+          break;
+        }
+      }
+      break;
+    }
+    case PJPG_YH2V1: {
+      switch (mcuBlock) {
+        case 0: {
+          copyYReduced(0);
+          break;
+        }
+        case 1: {
+          copyYReduced(64);
+          break;
+        }
+        case 2: {
+          convertCbReduced(0, 0, 0, 1, 0);
+          convertCbReduced(64, n, 0, 1, 0);
+          break;
+        }
+        case 3: {
+          convertCrReduced(0, 0, 0, 1, 0);
+          convertCrReduced(64, n, 0, 1, 0);
+          break;
+        }
+      }
+      break;
+    }
+    case PJPG_YH2V2: {
+      switch (mcuBlock) {
+        case 0: {
+          copyYReduced(0);
+          break;
+        }
+        case 1: {
+          copyYReduced(64);
+          break;
+        }
+        case 2: {
+          copyYReduced(128);
+          break;
+        }
+        case 3: {
+          copyYReduced(192);
+          break;
+        }
+        case 4: {
+          convertCbReduced(0, 0, 0, 1, 1);
+          convertCbReduced(64, n, 0, 1, 1);
+          convertCbReduced(128, 0, n, 1, 1);
+          convertCbReduced(192, n, n, 1, 1);
+          break;
+        }
+        case 5: {
+          convertCrReduced(0, 0, 0, 1, 1);
+          convertCrReduced(64, n, 0, 1, 1);
+          convertCrReduced(128, 0, n, 1, 1);
+          convertCrReduced(192, n, n, 1, 1);
+          break;
+        }
+      }
+      break;
+    }
+  }
+}
+//------------------------------------------------------------------------------
 static uint8 decodeNextMCU(void) {
   uint8 status;
   uint8 mcuBlock;
@@ -1941,7 +2145,7 @@ static uint8 decodeNextMCU(void) {
 
     compACTab = gCompACTab[componentID];
 
-    if (gReduce) {
+    if (gReduce == PJPG_REDUCE_EIGHTH) {
       // Decode, but throw out the AC coefficients in reduce mode.
       for (k = 1; k < 64; k++) {
         s = huffDecode(compACTab ? &gHuffTab3 : &gHuffTab2, compACTab ? gHuffVal3 : gHuffVal2);
@@ -1969,6 +2173,48 @@ static uint8 decodeNextMCU(void) {
       }
 
       transformBlockReduce(mcuBlock);
+    } else if (gReduce) {
+      // Decode and dequantize the AC coefficients the reduced IDCT uses, throw out the others
+      const uint8 n = gReducedBlockSize;
+
+      for (k = 1; k < 64; k++) {
+        if ((k & 7) < n && (k >> 3) < n) gCoeffBuf[k] = 0;
+      }
+
+      for (k = 1; k < 64; k++) {
+        uint16 extraBits;
+
+        s = huffDecode(compACTab ? &gHuffTab3 : &gHuffTab2, compACTab ? gHuffVal3 : gHuffVal2);
+
+        extraBits = 0;
+        numExtraBits = s & 0xF;
+        if (numExtraBits) extraBits = getBits2(numExtraBits);
+
+        r = s >> 4;
+        s &= 15;
+
+        if (s) {
+          uint8 zag;
+
+          if (r) {
+            if ((k + r) > 63) return PJPG_DECODE_ERROR;
+
+            k = (uint8)(k + r);
+          }
+
+          zag = (uint8)ZAG[k];
+          if ((zag & 7) < n && (zag >> 3) < n) gCoeffBuf[zag] = huffExtend(extraBits, s) * pQ[k];
+        } else {
+          if (r == 15) {
+            if ((k + 16) > 64) return PJPG_DECODE_ERROR;
+
+            k += (16 - 1);  // - 1 because the loop counter is k
+          } else
+            break;
+        }
+      }
+
+      transformBlockReduced(mcuBlock);
     } else {
       // Decode and dequantize AC coefficients
       for (k = 1; k < 64; k++) {
@@ -2057,7 +2303,7 @@ unsigned char pjpeg_decode_init(pjpeg_image_info_t* pInfo, pjpeg_need_bytes_call
   g_pNeedBytesCallback = pNeed_bytes_callback;
   g_pCallback_data = pCallback_data;
   gCallbackStatus = 0;
-  gReduce = reduce;
+  pjpeg_set_reduce(reduce);
 
   status = init();
   if ((status) || (gCallbackStatus)) return gCallbackStatus ? gCallbackStatus : status;
@@ -2085,3 +2331,8 @@ unsigned char pjpeg_decode_init(pjpeg_image_info_t* pInfo, pjpeg_need_bytes_call
 
   return 0;
 }
+//------------------------------------------------------------------------------
+void pjpeg_set_reduce(unsigned char reduce) {
+  gReduce = reduce;
+  gReducedBlockSize = (reduce == PJPG_REDUCE_QUARTER) ? 2 : 4;
+}
@@ -105,13 +105,23 @@ typedef struct {
 typedef unsigned char (*pjpeg_need_bytes_callback_t)(unsigned char* pBuf, unsigned char buf_size,
                                                      unsigned char* pBytes_actually_read, void* pCallback_data);
 
+// Values of reduce: decode at full size, or at 1/8, 1/4 or 1/2 of it
+enum { PJPG_REDUCE_NONE = 0, PJPG_REDUCE_EIGHTH = 1, PJPG_REDUCE_QUARTER = 2, PJPG_REDUCE_HALF = 3 };
+
 // Initializes the decompressor. Returns 0 on success, or one of the above error codes on failure.
 // pNeed_bytes_callback will be called to fill the decompressor's internal input buffer.
-// If reduce is 1, only the first pixel of each block will be decoded. This mode is much faster because it skips the AC
-// dequantization, IDCT and chroma upsampling of every image pixel. Not thread safe.
+// If reduce is PJPG_REDUCE_EIGHTH, only the first pixel of each block will be decoded. This mode is much faster because
+// it skips the AC dequantization, IDCT and chroma upsampling of every image pixel. PJPG_REDUCE_QUARTER and
+// PJPG_REDUCE_HALF turn each block into 2x2 or 4x4 pixels with a reduced size IDCT of its low frequency coefficients.
+// The MCU buffers keep their layout in every mode, the pixels of a block fill the top left corner of its 8x8 slot.
+// Not thread safe.
 unsigned char pjpeg_decode_init(pjpeg_image_info_t* pInfo, pjpeg_need_bytes_callback_t pNeed_bytes_callback,
                                 void* pCallback_data, unsigned char reduce);
 
+// Changes the reduce mode after pjpeg_decode_init(), before the first pjpeg_decode_mcu(). Lets the caller pick it from
+// the image size.
+void pjpeg_set_reduce(unsigned char reduce);
+
 // Decompresses the file's next MCU. Returns 0 on success, PJPG_NO_MORE_BLOCKS if no more blocks are available, or an
 // error code. Must be called a total of m_MCUSPerRow*m_MCUSPerCol times to completely decompress the image. Not thread
 // safe.
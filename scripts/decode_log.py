@@ -0,0 +1,44 @@
+#!/usr/bin/env python3
+"""Print the binary log the firmware writes to /.crosspoint/log (see lib/Logging/Logging.h)."""
+
+import argparse
+import struct
+import sys
+
+MAGIC = b'CPLG'
+HEADER = struct.Struct('<IB3sB')
+LEVELS = {1: 'E', 2: 'W', 3: 'I', 4: 'D'}
+
+
+def decode(data: bytes):
+    if not data.startswith(MAGIC):
+        raise ValueError('not a CrossPoint log file')
+    version = data[len(MAGIC)]
+    if version != 1:
+        raise ValueError(f'unsupported log version {version}')
+
+    pos = len(MAGIC) + 1
+    while pos + HEADER.size <= len(data):
+        ms, level, module, length = HEADER.unpack_from(data, pos)
+        pos += HEADER.size
+        message = data[pos:pos + length].decode('utf-8', errors='replace')
+        pos += length
+        yield ms, LEVELS.get(level, '?'), module.decode('ascii', errors='replace'), message
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('log', help='log file copied from the SD card')
+    args = parser.parse_args()
+
+    with open(args.log, 'rb') as f:
+        data = f.read()
+    try:
+        for ms, level, module, message in decode(data):
+            print(f'[{ms}] [{module}] {level} {message}')
+    except ValueError as e:
+        sys.exit(f'{args.log}: {e}')
+
+
+if __name__ == '__main__':
+    main()
@@ -11,9 +11,9 @@
 // Initialize the static instance
 CrossPointSettings CrossPointSettings::instance;
 
-void readAndValidate(FsFile& file, uint8_t& member, const uint8_t maxValue) {
+void readAndValidate(BufferedFsReader& reader, uint8_t& member, const uint8_t maxValue) {
   uint8_t tempValue;
-  serialization::readPod(file, tempValue);
+  serialization::readPod(reader, tempValue);
   if (tempValue < maxValue) {
     member = tempValue;
   }
@@ -22,7 +22,7 @@ void readAndValidate(FsFile& file, uint8_t& member, const uint8_t maxValue) {
 namespace {
 constexpr uint8_t SETTINGS_FILE_VERSION = 1;
 // Increment this when adding new persisted settings fields
-constexpr uint8_t SETTINGS_COUNT = 23;
+constexpr uint8_t SETTINGS_COUNT = 24;
 constexpr char SETTINGS_FILE[] = "/.crosspoint/settings.bin";
 }  // namespace
 
@@ -34,34 +34,41 @@ bool CrossPointSettings::saveToFile() const {
   if (!SdMan.openFileForWrite("CPS", SETTINGS_FILE, outputFile)) {
     return false;
   }
+  BufferedFsWriter writer(outputFile);
 
-  serialization::writePod(outputFile, SETTINGS_FILE_VERSION);
-  serialization::writePod(outputFile, SETTINGS_COUNT);
-  serialization::writePod(outputFile, sleepScreen);
-  serialization::writePod(outputFile, extraParagraphSpacing);
-  serialization::writePod(outputFile, shortPwrBtn);
-  serialization::writePod(outputFile, statusBar);
-  serialization::writePod(outputFile, orientation);
-  serialization::writePod(outputFile, frontButtonLayout);
-  serialization::writePod(outputFile, sideButtonLayout);
-  serialization::writePod(outputFile, fontFamily);
-  serialization::writePod(outputFile, fontSize);
-  serialization::writePod(outputFile, lineSpacing);
-  serialization::writePod(outputFile, paragraphAlignment);
-  serialization::writePod(outputFile, sleepTimeout);
-  serialization::writePod(outputFile, refreshFrequency);
-  serialization::writePod(outputFile, screenMargin);
-  serialization::writePod(outputFile, sleepScreenCoverMode);
-  serialization::writeString(outputFile, std::string(opdsServerUrl));
-  serialization::writePod(outputFile, textAntiAliasing);
-  serialization::writePod(outputFile, hideBatteryPercentage);
-  serialization::writePod(outputFile, longPressChapterSkip);
-  serialization::writePod(outputFile, hyphenationEnabled);
-  serialization::writeString(outputFile, std::string(opdsUsername));
-  serialization::writeString(outputFile, std::string(opdsPassword));
-  serialization::writePod(outputFile, sleepScreenCoverFilter);
+  serialization::writePod(writer, SETTINGS_FILE_VERSION);
+  serialization::writePod(writer, SETTINGS_COUNT);
+  serialization::writePod(writer, sleepScreen);
+  serialization::writePod(writer, extraParagraphSpacing);
+  serialization::writePod(writer, shortPwrBtn);
+  serialization::writePod(writer, statusBar);
+  serialization::writePod(writer, orientation);
+  serialization::writePod(writer, frontButtonLayout);
+  serialization::writePod(writer, sideButtonLayout);
+  serialization::writePod(writer, fontFamily);
+  serialization::writePod(writer, fontSize);
+  serialization::writePod(writer, lineSpacing);
+  serialization::writePod(writer, paragraphAlignment);
+  serialization::writePod(writer, sleepTimeout);
+  serialization::writePod(writer, refreshFrequency);
+  serialization::writePod(writer, screenMargin);
+  serialization::writePod(writer, sleepScreenCoverMode);
+  serialization::writeString(writer, std::string(opdsServerUrl));
+  serialization::writePod(writer, textAntiAliasing);
+  serialization::writePod(writer, hideBatteryPercentage);
+  serialization::writePod(writer, longPressChapterSkip);
+  serialization::writePod(writer, hyphenationEnabled);
+  serialization::writeString(writer, std::string(opdsUsername));
+  serialization::writeString(writer, std::string(opdsPassword));
+  serialization::writePod(writer, sleepScreenCoverFilter);
+  serialization::writePod(writer, bakeBooks);
   // New fields added at end for backward compatibility
+  const bool written = writer.flush();
   outputFile.close();
+  if (!written) {
+    Serial.printf("[%lu] [CPS] Failed to write settings file\n", millis());
+    return false;
+  }
 
   Serial.printf("[%lu] [CPS] Settings saved to file\n", millis());
   return true;
@@ -72,9 +79,10 @@ bool CrossPointSettings::loadFromFile() {
   if (!SdMan.openFileForRead("CPS", SETTINGS_FILE, inputFile)) {
     return false;
   }
+  BufferedFsReader reader(inputFile);
 
   uint8_t version;
-  serialization::readPod(inputFile, version);
+  serialization::readPod(reader, version);
   if (version != SETTINGS_FILE_VERSION) {
     Serial.printf("[%lu] [CPS] Deserialization failed: Unknown version %u\n", millis(), version);
     inputFile.close();
@@ -82,71 +90,73 @@ bool CrossPointSettings::loadFromFile() {
   }
 
   uint8_t fileSettingsCount = 0;
-  serialization::readPod(inputFile, fileSettingsCount);
+  serialization::readPod(reader, fileSettingsCount);
 
   // load settings that exist (support older files with fewer fields)
   uint8_t settingsRead = 0;
   do {
-    readAndValidate(inputFile, sleepScreen, SLEEP_SCREEN_MODE_COUNT);
+    readAndValidate(reader, sleepScreen, SLEEP_SCREEN_MODE_COUNT);
     if (++settingsRead >= fileSettingsCount) break;
-    serialization::readPod(inputFile, extraParagraphSpacing);
+    serialization::readPod(reader, extraParagraphSpacing);
     if (++settingsRead >= fileSettingsCount) break;
-    readAndValidate(inputFile, shortPwrBtn, SHORT_PWRBTN_COUNT);
+    readAndValidate(reader, shortPwrBtn, SHORT_PWRBTN_COUNT);
     if (++settingsRead >= fileSettingsCount) break;
-    readAndValidate(inputFile, statusBar, STATUS_BAR_MODE_COUNT);
+    readAndValidate(reader, statusBar, STATUS_BAR_MODE_COUNT);
     if (++settingsRead >= fileSettingsCount) break;
-    readAndValidate(inputFile, orientation, ORIENTATION_COUNT);
+    readAndValidate(reader, orientation, ORIENTATION_COUNT);
     if (++settingsRead >= fileSettingsCount) break;
-    readAndValidate(inputFile, frontButtonLayout, FRONT_BUTTON_LAYOUT_COUNT);
+    readAndValidate(reader, frontButtonLayout, FRONT_BUTTON_LAYOUT_COUNT);
     if (++settingsRead >= fileSettingsCount) break;
-    readAndValidate(inputFile, sideButtonLayout, SIDE_BUTTON_LAYOUT_COUNT);
+    readAndValidate(reader, sideButtonLayout, SIDE_BUTTON_LAYOUT_COUNT);
     if (++settingsRead >= fileSettingsCount) break;
-    readAndValidate(inputFile, fontFamily, FONT_FAMILY_COUNT);
+    readAndValidate(reader, fontFamily, FONT_FAMILY_COUNT);
     if (++settingsRead >= fileSettingsCount) break;
-    readAndValidate(inputFile, fontSize, FONT_SIZE_COUNT);
+    readAndValidate(reader, fontSize, FONT_SIZE_COUNT);
     if (++settingsRead >= fileSettingsCount) break;
-    readAndValidate(inputFile, lineSpacing, LINE_COMPRESSION_COUNT);
+    readAndValidate(reader, lineSpacing, LINE_COMPRESSION_COUNT);
     if (++settingsRead >= fileSettingsCount) break;
-    readAndValidate(inputFile, paragraphAlignment, PARAGRAPH_ALIGNMENT_COUNT);
+    readAndValidate(reader, paragraphAlignment, PARAGRAPH_ALIGNMENT_COUNT);
     if (++settingsRead >= fileSettingsCount) break;
-    readAndValidate(inputFile, sleepTimeout, SLEEP_TIMEOUT_COUNT);
+    readAndValidate(reader, sleepTimeout, SLEEP_TIMEOUT_COUNT);
     if (++settingsRead >= fileSettingsCount) break;
-    readAndValidate(inputFile, refreshFrequency, REFRESH_FREQUENCY_COUNT);
+    readAndValidate(reader, refreshFrequency, REFRESH_FREQUENCY_COUNT);
     if (++settingsRead >= fileSettingsCount) break;
-    serialization::readPod(inputFile, screenMargin);
+    serialization::readPod(reader, screenMargin);
     if (++settingsRead >= fileSettingsCount) break;
-    readAndValidate(inputFile, sleepScreenCoverMode, SLEEP_SCREEN_COVER_MODE_COUNT);
+    readAndValidate(reader, sleepScreenCoverMode, SLEEP_SCREEN_COVER_MODE_COUNT);
     if (++settingsRead >= fileSettingsCount) break;
     {
       std::string urlStr;
-      serialization::readString(inputFile, urlStr);
+      serialization::readString(reader, urlStr);
       strncpy(opdsServerUrl, urlStr.c_str(), sizeof(opdsServerUrl) - 1);
       opdsServerUrl[sizeof(opdsServerUrl) - 1] = '\0';
     }
     if (++settingsRead >= fileSettingsCount) break;
-    serialization::readPod(inputFile, textAntiAliasing);
+    serialization::readPod(reader, textAntiAliasing);
     if (++settingsRead >= fileSettingsCount) break;
-    readAndValidate(inputFile, hideBatteryPercentage, HIDE_BATTERY_PERCENTAGE_COUNT);
+    readAndValidate(reader, hideBatteryPercentage, HIDE_BATTERY_PERCENTAGE_COUNT);
     if (++settingsRead >= fileSettingsCount) break;
-    serialization::readPod(inputFile, longPressChapterSkip);
+    serialization::readPod(reader, longPressChapterSkip);
     if (++settingsRead >= fileSettingsCount) break;
-    serialization::readPod(inputFile, hyphenationEnabled);
+    serialization::readPod(reader, hyphenationEnabled);
     if (++settingsRead >= fileSettingsCount) break;
     {
       std::string usernameStr;
-      serialization::readString(inputFile, usernameStr);
+      serialization::readString(reader, usernameStr);
       strncpy(opdsUsername, usernameStr.c_str(), sizeof(opdsUsername) - 1);
       opdsUsername[sizeof(opdsUsername) - 1] = '\0';
     }
     if (++settingsRead >= fileSettingsCount) break;
     {
       std::string passwordStr;
-      serialization::readString(inputFile, passwordStr);
+      serialization::readString(reader, passwordStr);
       strncpy(opdsPassword, passwordStr.c_str(), sizeof(opdsPassword) - 1);
       opdsPassword[sizeof(opdsPassword) - 1] = '\0';
     }
     if (++settingsRead >= fileSettingsCount) break;
-    readAndValidate(inputFile, sleepScreenCoverFilter, SLEEP_SCREEN_COVER_FILTER_COUNT);
+    readAndValidate(reader, sleepScreenCoverFilter, SLEEP_SCREEN_COVER_FILTER_COUNT);
+    if (++settingsRead >= fileSettingsCount) break;
+    serialization::readPod(reader, bakeBooks);
     if (++settingsRead >= fileSettingsCount) break;
     // New fields added at end for backward compatibility
   } while (false);
@@ -137,6 +137,8 @@ class CrossPointSettings {
   uint8_t hideBatteryPercentage = HIDE_NEVER;
   // Long-press chapter skip on side buttons
   uint8_t longPressChapterSkip = 1;
+  // Pre-render EPUB pages into an XTCH file while the reader sits idle
+  uint8_t bakeBooks = 0;
 
   ~CrossPointSettings() = default;
 
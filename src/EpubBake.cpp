@@ -0,0 +1,344 @@
+#include "EpubBake.h"
+
+#include <Epub/Page.h>
+#include <GfxRenderer.h>
+#include <Logging.h>
+#include <SDCardManager.h>
+#include <Serialization.h>
+
+#include "CrossPointSettings.h"
+#include "ScreenComponents.h"
+
+namespace {
+constexpr uint8_t BAKE_FILE_VERSION = 1;
+constexpr char BAKED_BOOK_FILE[] = "/baked.xtch";
+constexpr char BAKE_STATE_FILE[] = "/bake.bin";
+constexpr size_t PAGE_CHUNK_SIZE = 4096;
+constexpr int statusBarMargin = 19;
+constexpr int progressBarMarginTop = 1;
+
+// bake.bin
+struct BakeState {
+  EpubPageLayout layout;
+  uint8_t done = 0;
+  uint16_t nextSpine = 0;
+  uint16_t nextPage = 0;
+  xtc::XtcWriter::Progress progress = {};
+  std::vector<uint16_t> spineStart;
+};
+
+void writeLayout(BufferedFsWriter& writer, const EpubPageLayout& layout) {
+  serialization::writePod(writer, layout.fontId);
+  serialization::writePod(writer, layout.lineCompression);
+  serialization::writePod(writer, layout.extraParagraphSpacing);
+  serialization::writePod(writer, layout.paragraphAlignment);
+  serialization::writePod(writer, layout.hyphenationEnabled);
+  serialization::writePod(writer, layout.textAntiAliasing);
+  serialization::writePod(writer, layout.orientation);
+  serialization::writePod(writer, layout.marginTop);
+  serialization::writePod(writer, layout.marginRight);
+  serialization::writePod(writer, layout.marginBottom);
+  serialization::writePod(writer, layout.marginLeft);
+  serialization::writePod(writer, layout.viewportWidth);
+  serialization::writePod(writer, layout.viewportHeight);
+}
+
+void readLayout(BufferedFsReader& reader, EpubPageLayout& layout) {
+  serialization::readPod(reader, layout.fontId);
+  serialization::readPod(reader, layout.lineCompression);
+  serialization::readPod(reader, layout.extraParagraphSpacing);
+  serialization::readPod(reader, layout.paragraphAlignment);
+  serialization::readPod(reader, layout.hyphenationEnabled);
+  serialization::readPod(reader, layout.textAntiAliasing);
+  serialization::readPod(reader, layout.orientation);
+  serialization::readPod(reader, layout.marginTop);
+  serialization::readPod(reader, layout.marginRight);
+  serialization::readPod(reader, layout.marginBottom);
+  serialization::readPod(reader, layout.marginLeft);
+  serialization::readPod(reader, layout.viewportWidth);
+  serialization::readPod(reader, layout.viewportHeight);
+}
+
+bool readState(const Epub& epub, BakeState& state) {
+  FsFile file;
+  if (!SdMan.openFileForRead("BAK", epub.getCachePath() + BAKE_STATE_FILE, file)) {
+    return false;
+  }
+  BufferedFsReader reader(file);
+
+  uint8_t version = 0;
+  serialization::readPod(reader, version);
+  if (version != BAKE_FILE_VERSION) {
+    file.close();
+    return false;
+  }
+  readLayout(reader, state.layout);
+  serialization::readPod(reader, state.done);
+  serialization::readPod(reader, state.nextSpine);
+  serialization::readPod(reader, state.nextPage);
+  serialization::readPod(reader, state.progress.dataEnd);
+  serialization::readPod(reader, state.progress.pageCount);
+  uint16_t spineStartCount = 0;
+  serialization::readPod(reader, spineStartCount);
+  // One entry per spine item started, the last holding the page count once done
+  const size_t expected = state.done ? epub.getSpineItemsCount() + 1 : state.nextSpine + 1;
+  if (spineStartCount != expected || state.nextSpine > epub.getSpineItemsCount()) {
+    file.close();
+    return false;
+  }
+  state.spineStart.resize(spineStartCount);
+  const bool read = serialization::readPodArray(reader, state.spineStart.data(), spineStartCount);
+  file.close();
+  return read;
+}
+}  // namespace
+
+EpubPageLayout EpubPageLayout::current(const GfxRenderer& renderer) {
+  // Apply screen viewable areas and additional padding
+  int marginTop, marginRight, marginBottom, marginLeft;
+  renderer.getOrientedViewableTRBL(&marginTop, &marginRight, &marginBottom, &marginLeft);
+  marginTop += SETTINGS.screenMargin;
+  marginLeft += SETTINGS.screenMargin;
+  marginRight += SETTINGS.screenMargin;
+  marginBottom += SETTINGS.screenMargin;
+
+  // Add status bar margin
+  if (SETTINGS.statusBar != CrossPointSettings::STATUS_BAR_MODE::NONE) {
+    // Add additional margin for status bar if progress bar is shown
+    const bool showProgressBar = SETTINGS.statusBar == CrossPointSettings::STATUS_BAR_MODE::FULL_WITH_PROGRESS_BAR ||
+                                 SETTINGS.statusBar == CrossPointSettings::STATUS_BAR_MODE::ONLY_PROGRESS_BAR;
+    marginBottom += statusBarMargin - SETTINGS.screenMargin +
+                    (showProgressBar ? (ScreenComponents::BOOK_PROGRESS_BAR_HEIGHT + progressBarMarginTop) : 0);
+  }
+
+  EpubPageLayout layout;
+  layout.fontId = SETTINGS.getReaderFontId();
+  layout.lineCompression = SETTINGS.getReaderLineCompression();
+  layout.extraParagraphSpacing = SETTINGS.extraParagraphSpacing;
+  layout.paragraphAlignment = SETTINGS.paragraphAlignment;
+  layout.hyphenationEnabled = SETTINGS.hyphenationEnabled;
+  layout.textAntiAliasing = SETTINGS.textAntiAliasing;
+  layout.orientation = static_cast<uint8_t>(renderer.getOrientation());
+  layout.marginTop = marginTop;
+  layout.marginRight = marginRight;
+  layout.marginBottom = marginBottom;
+  layout.marginLeft = marginLeft;
+  layout.viewportWidth = renderer.getScreenWidth() - marginLeft - marginRight;
+  layout.viewportHeight = renderer.getScreenHeight() - marginTop - marginBottom;
+  return layout;
+}
+
+std::unique_ptr<BakedEpub> BakedEpub::open(const Epub& epub, const EpubPageLayout& layout) {
+  BakeState state;
+  if (!readState(epub, state) || !state.done || !(state.layout == layout) || state.spineStart.back() == 0) {
+    return nullptr;
+  }
+
+  std::unique_ptr<BakedEpub> baked(new BakedEpub());
+  const std::string path = epub.getCachePath() + BAKED_BOOK_FILE;
+  if (baked->book.open(path.c_str()) != xtc::XtcError::OK || baked->book.getBitDepth() != 2 ||
+      baked->book.getPageCount() != state.spineStart.back() ||
+      !xtc::PageBlitter::canBlit(baked->book.getWidth(), baked->book.getHeight(), 2)) {
+    LOG_W(BAK, "Baked book %s doesn't match its state", path.c_str());
+    return nullptr;
+  }
+  baked->spineStart = std::move(state.spineStart);
+  LOG_I(BAK, "Opened baked book, %u pages", baked->book.getPageCount());
+  return baked;
+}
+
+bool BakedEpub::hasPage(const int spineIndex, const int page, const int sectionPageCount) const {
+  if (spineIndex < 0 || spineIndex + 1 >= static_cast<int>(spineStart.size())) {
+    return false;
+  }
+  const int pageCount = spineStart[spineIndex + 1] - spineStart[spineIndex];
+  return pageCount == sectionPageCount && page >= 0 && page < pageCount;
+}
+
+bool BakedEpub::drawPage(const int spineIndex, const int page, uint8_t* frameBuffer,
+                         const xtc::PageBlitter::Target target, bool* grays) {
+  xtc::PageBlitter blitter(frameBuffer, book.getWidth(), book.getHeight(), 2, target);
+  const xtc::XtcError error = book.loadPageStreaming(
+      spineStart[spineIndex] + page,
+      [&blitter](const uint8_t* data, const size_t size, const size_t offset) { blitter.addChunk(data, size, offset); },
+      PAGE_CHUNK_SIZE);
+  if (error != xtc::XtcError::OK) {
+    LOG_E(BAK, "Failed to load baked page %d of spine %d: %s", page, spineIndex, xtc::errorToString(error));
+    return false;
+  }
+  blitter.finish();
+  if (grays) {
+    *grays = blitter.hasGrays();
+  }
+  return true;
+}
+
+bool EpubBakeJob::begin() {
+  const std::string path = epub->getCachePath() + BAKED_BOOK_FILE;
+  BakeState state;
+  const bool stateRead = readState(*epub, state);
+  if (stateRead && state.layout == layout && state.done && state.spineStart.back() == 0) {
+    LOG_I(BAK, "%s has no pages to bake", epub->getPath().c_str());
+    return false;
+  }
+  if (stateRead && state.layout == layout && !state.done &&
+      state.progress.pageCount == state.spineStart.back() + state.nextPage && writer.open(path, 2, &state.progress)) {
+    nextSpine = state.nextSpine;
+    nextPage = state.nextPage;
+    spineStart = std::move(state.spineStart);
+    LOG_I(BAK, "Continuing bake at spine %u page %u", nextSpine, nextPage);
+    return true;
+  }
+
+  // Nothing to continue, made with another layout, or finished but no longer readable
+  LOG_I(BAK, "Starting bake of %s", epub->getPath().c_str());
+  if (!writer.open(path, 2)) {
+    LOG_E(BAK, "Failed to create %s", path.c_str());
+    return false;
+  }
+  nextSpine = 0;
+  nextPage = 0;
+  spineStart.assign(1, 0);
+  return saveState(false);
+}
+
+EpubBakeJob::Status EpubBakeJob::step(const std::function<bool()>& shouldYield) {
+  if (nextSpine >= epub->getSpineItemsCount()) {
+    return finish();
+  }
+
+  // Stays true once asked, so a stopped layout isn't taken for a failed one
+  bool yielded = false;
+  const auto yield = [&shouldYield, &yielded] { return yielded = yielded || (shouldYield && shouldYield()); };
+
+  if (!section) {
+    section.reset(new Section(epub, nextSpine, renderer));
+    if (!section->loadSectionFile(layout.fontId, layout.lineCompression, layout.extraParagraphSpacing,
+                                  layout.paragraphAlignment, layout.viewportWidth, layout.viewportHeight,
+                                  layout.hyphenationEnabled)) {
+      // Indexing is a step on its own, it takes as long as opening the chapter does
+      const bool created = section->createSectionFile(
+          layout.fontId, layout.lineCompression, layout.extraParagraphSpacing, layout.paragraphAlignment,
+          layout.viewportWidth, layout.viewportHeight, layout.hyphenationEnabled, nullptr, nullptr, yield);
+      if (!created) {
+        section.reset();
+        if (yielded) {
+          return Status::Running;
+        }
+        LOG_E(BAK, "Failed to lay out spine %u", nextSpine);
+        return Status::Failed;
+      }
+      return Status::Running;
+    }
+  }
+
+  if (nextPage >= section->pageCount) {
+    section.reset();
+    if (spineStart.back() + nextPage > UINT16_MAX) {
+      LOG_E(BAK, "Book has more pages than XTC holds");
+      return Status::Failed;
+    }
+    spineStart.push_back(spineStart.back() + nextPage);
+    nextSpine++;
+    nextPage = 0;
+    return saveState(false) ? Status::Running : Status::Failed;
+  }
+
+  if (yield()) {
+    return Status::Running;
+  }
+  section->currentPage = nextPage;
+  const auto page = section->loadPageFromSectionFile();
+  if (!page) {
+    LOG_E(BAK, "Failed to load page %u of spine %u", nextPage, nextSpine);
+    return Status::Failed;
+  }
+
+  // The reader's passes: the page in BW, then text (with anti-aliasing) or images alone for the two gray buffers
+  const auto draw = [this, &page](const xtc::PageBlitter::Target target) {
+    if (target == xtc::PageBlitter::Target::Bw) {
+      renderer.clearScreen();
+      page->render(renderer, layout.fontId, layout.marginLeft, layout.marginTop);
+      return;
+    }
+    renderer.clearScreen(0x00);
+    renderer.setRenderMode(target == xtc::PageBlitter::Target::GrayscaleLsb ? GfxRenderer::GRAYSCALE_LSB
+                                                                            : GfxRenderer::GRAYSCALE_MSB);
+    if (layout.textAntiAliasing) {
+      page->render(renderer, layout.fontId, layout.marginLeft, layout.marginTop);
+    } else {
+      page->renderImages(renderer, layout.marginLeft, layout.marginTop);
+    }
+    renderer.setRenderMode(GfxRenderer::BW);
+  };
+  if (!writer.addPage(renderer.getFrameBuffer(), draw)) {
+    return Status::Failed;
+  }
+  nextPage++;
+  return saveState(false) ? Status::Running : Status::Failed;
+}
+
+EpubBakeJob::Status EpubBakeJob::finish() {
+  // No spine item has a page, there is no book to write. Recorded as done so begin() doesn't start over on every open.
+  if (spineStart.back() == 0) {
+    const std::string path = epub->getCachePath() + BAKED_BOOK_FILE;
+    writer.close();
+    SdMan.remove(path.c_str());
+    SdMan.remove((path + ".pages").c_str());
+    if (!saveState(true)) {
+      return Status::Failed;
+    }
+    LOG_I(BAK, "Nothing to bake, the book has no pages");
+    return Status::Done;
+  }
+
+  // A chapter per TOC entry starting a spine item after the previous one's, running up to the next. Those left
+  // without pages (empty spine items) are dropped.
+  std::vector<xtc::ChapterInfo> chapters;
+  int lastSpine = -1;
+  for (int i = 0; i < epub->getTocItemsCount(); i++) {
+    const int spineIndex = epub->getSpineIndexForTocIndex(i);
+    if (spineIndex <= lastSpine || spineIndex >= epub->getSpineItemsCount()) {
+      continue;
+    }
+    lastSpine = spineIndex;
+    if (!chapters.empty() && chapters.back().startPage == spineStart[spineIndex]) {
+      chapters.pop_back();
+    }
+    chapters.push_back({epub->getTocItem(i).title, spineStart[spineIndex], 0});
+  }
+  if (!chapters.empty() && chapters.back().startPage == spineStart.back()) {
+    chapters.pop_back();
+  }
+  for (size_t i = 0; i < chapters.size(); i++) {
+    chapters[i].endPage = (i + 1 < chapters.size() ? chapters[i + 1].startPage : spineStart.back()) - 1;
+  }
+
+  if (!writer.finish(epub->getTitle(), epub->getAuthor(), chapters) || !saveState(true)) {
+    LOG_E(BAK, "Failed to finish the baked book");
+    return Status::Failed;
+  }
+  LOG_I(BAK, "Baked %u pages", spineStart.back());
+  return Status::Done;
+}
+
+bool EpubBakeJob::saveState(const bool done) const {
+  FsFile file;
+  if (!SdMan.openFileForWrite("BAK", epub->getCachePath() + BAKE_STATE_FILE, file)) {
+    return false;
+  }
+  BufferedFsWriter writer(file);
+  serialization::writePod(writer, BAKE_FILE_VERSION);
+  writeLayout(writer, layout);
+  serialization::writePod(writer, static_cast<uint8_t>(done));
+  serialization::writePod(writer, nextSpine);
+  serialization::writePod(writer, nextPage);
+  const xtc::XtcWriter::Progress progress = this->writer.getProgress();
+  serialization::writePod(writer, progress.dataEnd);
+  serialization::writePod(writer, progress.pageCount);
+  serialization::writePod(writer, static_cast<uint16_t>(spineStart.size()));
+  serialization::writePodArray(writer, spineStart.data(), spineStart.size());
+  const bool written = writer.flush();
+  file.close();
+  return written;
+}
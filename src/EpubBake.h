@@ -0,0 +1,107 @@
+#pragma once
+#include <Epub.h>
+#include <Epub/Section.h>
+#include <Xtc/XtcPageBlitter.h>
+#include <Xtc/XtcParser.h>
+#include <Xtc/XtcWriter.h>
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+class GfxRenderer;
+
+/**
+ * EpubBake.h
+ *
+ * Pre-rendered EPUB pages. The bake job runs the reader's pagination and page rendering one page at a time and writes
+ * the frame buffers it gets into an XTCH book in the EPUB's cache directory, the three passes of every page as the
+ * two XTH planes. Opening a page of it later is a blit of the stored planes instead of reading the page's layout from
+ * the section file and drawing every glyph and image again.
+ *
+ * Pages hold the content area only, the status bar is drawn on top of them live. They are stored in panel orientation
+ * exactly as the frame buffer held them, so a baked book belongs to the layout it was made with (fonts, spacing,
+ * margins, orientation, anti-aliasing) and is only used while the reader's layout still matches.
+ *
+ * bake.bin next to the book records the layout and how far the job got, so it carries on after the reader was left or
+ * the device slept and starts over when the layout changed. A book without pages is recorded as done with no
+ * baked.xtch, so it isn't baked again on every open.
+ */
+
+// Everything a page's pixels depend on besides the book itself
+struct EpubPageLayout {
+  int32_t fontId = 0;
+  float lineCompression = 1.0f;
+  uint8_t extraParagraphSpacing = 0;
+  uint8_t paragraphAlignment = 0;
+  uint8_t hyphenationEnabled = 0;
+  uint8_t textAntiAliasing = 0;
+  uint8_t orientation = 0;
+  int16_t marginTop = 0;
+  int16_t marginRight = 0;
+  int16_t marginBottom = 0;
+  int16_t marginLeft = 0;
+  uint16_t viewportWidth = 0;
+  uint16_t viewportHeight = 0;
+
+  // The reader's layout from the settings, for the orientation the renderer is set to
+  static EpubPageLayout current(const GfxRenderer& renderer);
+
+  bool operator==(const EpubPageLayout& other) const = default;
+};
+
+/**
+ * A finished bake, opened only when it was made with the given layout. Its pages are addressed like the sections' and
+ * only stand in for a section whose page count still matches.
+ */
+class BakedEpub {
+  xtc::XtcParser book;
+  // First page of every spine item, one more entry at the end holding the page count
+  std::vector<uint16_t> spineStart;
+
+  BakedEpub() = default;
+
+ public:
+  static std::unique_ptr<BakedEpub> open(const Epub& epub, const EpubPageLayout& layout);
+
+  bool hasPage(int spineIndex, int page, int sectionPageCount) const;
+  // Blits one target of the page over the whole frame buffer. grays, when given, is set to whether the page has any
+  // grey pixel (after the Bw target), nothing for the gray passes to draw otherwise.
+  bool drawPage(int spineIndex, int page, uint8_t* frameBuffer, xtc::PageBlitter::Target target,
+                bool* grays = nullptr);
+};
+
+/**
+ * Bakes one page per step(), meant for the reader's idle time. A spine item without a section file is indexed in a
+ * step of its own, its pages are baked by the steps after it. shouldYield is asked before the page is baked and
+ * between buffers of the chapter while indexing: once it returns true the step stops and leaves the rest for a later
+ * one. Indexing that stopped starts over from the beginning of the chapter.
+ */
+class EpubBakeJob {
+ public:
+  enum class Status { Running, Done, Failed };
+
+  EpubBakeJob(const std::shared_ptr<Epub>& epub, GfxRenderer& renderer, const EpubPageLayout& layout)
+      : epub(epub), renderer(renderer), layout(layout) {}
+  EpubBakeJob(const EpubBakeJob&) = delete;
+  EpubBakeJob& operator=(const EpubBakeJob&) = delete;
+
+  // Continues an unfinished bake of this layout or starts a new one. False when the files can't be written, or when a
+  // finished bake of this layout found no pages to bake.
+  bool begin();
+  // Indexes the next spine item or bakes the next page. Draws into the frame buffer, whatever was in it is lost.
+  Status step(const std::function<bool()>& shouldYield = nullptr);
+
+ private:
+  Status finish();
+  bool saveState(bool done) const;
+
+  std::shared_ptr<Epub> epub;
+  GfxRenderer& renderer;
+  const EpubPageLayout layout;
+  xtc::XtcWriter writer;
+  std::unique_ptr<Section> section;
+  uint16_t nextSpine = 0;
+  uint16_t nextPage = 0;
+  std::vector<uint16_t> spineStart;  // Up to and including nextSpine
+};
@@ -0,0 +1,960 @@
+#include "LibraryIndex.h"
+
+#include <Arduino.h>
+#include <BufferedFs.h>
+#include <Epub.h>
+#include <SDCardManager.h>
+#include <Serialization.h>
+#include <Xtc.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include "util/StringUtils.h"
+
+namespace {
+constexpr char INDEX_FILE[] = "/.crosspoint/library.idx";
+constexpr char NEW_INDEX_FILE[] = "/.crosspoint/library.idx.new";
+constexpr char INDEX_MAGIC[4] = {'C', 'P', 'L', 'I'};
+constexpr uint8_t INDEX_VERSION = 2;
+constexpr char CACHE_DIR[] = "/.crosspoint";
+
+// Record flags
+constexpr uint8_t FLAG_METADATA = 0x01;  // Title and author came from the book, not the file name
+constexpr uint8_t FLAG_STALE = 0x02;     // Read the metadata again on the next refresh
+constexpr uint8_t FLAG_COVERS = 0x04;    // Cover images generated
+constexpr uint8_t FLAG_NO_COVER = 0x08;  // The book has no cover the cover job can use
+
+// Bytes of the sort key kept in RAM while sorting, longer keys that tie on them are compared in full
+constexpr size_t SORT_KEY_LENGTH = 12;
+// Key separating the title and author parts, below any character a key can hold
+constexpr char KEY_SEPARATOR = '\x01';
+// Books without an author go after everyone else in the author view
+constexpr char NO_AUTHOR_KEY[] = "\xff";
+
+struct SortKey {
+  char key[SORT_KEY_LENGTH];
+  uint16_t record;
+};
+
+struct __attribute__((packed)) TrieChild {
+  uint8_t byte;
+  uint32_t offset;
+};
+
+uint32_t fnvHash32(const char* data, const size_t length, uint32_t hash = 2166136261u) {
+  for (size_t i = 0; i < length; i++) {
+    hash ^= static_cast<uint8_t>(data[i]);
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+uint32_t pathHash(const std::string& path) { return fnvHash32(path.data(), path.size()); }
+
+uint32_t stampOf(const uint32_t size, const uint32_t mtime) {
+  const uint32_t values[2] = {size, mtime};
+  return fnvHash32(reinterpret_cast<const char*>(values), sizeof(values));
+}
+
+std::string normalize(const std::string& text) {
+  std::string key;
+  key.reserve(text.size());
+  for (const char c : text) {
+    auto byte = static_cast<uint8_t>(c);
+    if (key.empty() && byte < 0x80 && !isalnum(byte)) {
+      continue;
+    }
+    if (byte < 0x20) {
+      byte = ' ';
+    }
+    key += static_cast<char>(byte < 0x80 ? tolower(byte) : byte);
+  }
+  return key;
+}
+
+std::string titleFromFileName(const std::string& path) {
+  std::string title = path.substr(path.find_last_of('/') + 1);
+  const size_t dot = title.find_last_of('.');
+  if (dot != std::string::npos && dot > 0) {
+    title.resize(dot);
+  }
+  return title;
+}
+
+bool bookFormat(const std::string& name, LibraryIndex::Format& format) {
+  if (StringUtils::checkFileExtension(name, ".epub")) {
+    format = LibraryIndex::Format::Epub;
+  } else if (StringUtils::checkFileExtension(name, ".xtch")) {
+    format = LibraryIndex::Format::Xtch;
+  } else if (StringUtils::checkFileExtension(name, ".xtc")) {
+    format = LibraryIndex::Format::Xtc;
+  } else if (StringUtils::checkFileExtension(name, ".txt")) {
+    format = LibraryIndex::Format::Txt;
+  } else if (StringUtils::checkFileExtension(name, ".md")) {
+    format = LibraryIndex::Format::Markdown;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+void writeShortString(BufferedFsWriter& writer, const std::string& s) {
+  serialization::writeVarint(writer, s.size());
+  writer.write(reinterpret_cast<const uint8_t*>(s.data()), s.size());
+}
+
+bool readShortString(BufferedFsReader& reader, std::string& s) {
+  uint32_t length;
+  if (!serialization::readVarint(reader, length) || length > 1024) {
+    return false;
+  }
+  s.resize(length);
+  return reader.read(reinterpret_cast<uint8_t*>(&s[0]), length) == length;
+}
+
+// Record header fields as laid out by LibraryIndex::RecordHeader
+bool readEntry(BufferedFsReader& reader, LibraryIndex::Entry& entry) {
+  uint8_t recordHeader[11];
+  if (reader.read(recordHeader, sizeof(recordHeader)) != sizeof(recordHeader)) {
+    return false;
+  }
+  memcpy(&entry.size, recordHeader, sizeof(entry.size));
+  memcpy(&entry.mtime, recordHeader + 4, sizeof(entry.mtime));
+  entry.format = static_cast<LibraryIndex::Format>(recordHeader[8]);
+  entry.progress = recordHeader[10];
+  if (!readShortString(reader, entry.path) || !readShortString(reader, entry.title) ||
+      !readShortString(reader, entry.author) || !readShortString(reader, entry.language) ||
+      !readShortString(reader, entry.thumbPath) || !readShortString(reader, entry.gridPath)) {
+    return false;
+  }
+  // The paths are written with the record, the images may come later
+  if (!(recordHeader[9] & FLAG_COVERS)) {
+    entry.thumbPath.clear();
+    entry.gridPath.clear();
+  }
+  return true;
+}
+
+bool hasCoverImages(const LibraryIndex::Format format) {
+  return format == LibraryIndex::Format::Epub || format == LibraryIndex::Format::Xtc ||
+         format == LibraryIndex::Format::Xtch;
+}
+
+// Writes the trie node for keys[lo, hi), which share their first depth bytes, after the nodes of its children
+uint32_t writeTrieNode(BufferedFsWriter& writer, const std::vector<SortKey>& keys, const uint16_t lo,
+                       const uint16_t hi, const uint8_t depth) {
+  std::vector<TrieChild> children;
+  if (depth < LibraryIndex::MAX_TRIE_DEPTH) {
+    uint16_t i = lo;
+    // Keys that end here sort first and have no child
+    while (i < hi && keys[i].key[depth] == 0) {
+      i++;
+    }
+    while (i < hi) {
+      const char byte = keys[i].key[depth];
+      uint16_t j = i + 1;
+      while (j < hi && keys[j].key[depth] == byte) {
+        j++;
+      }
+      children.push_back({static_cast<uint8_t>(byte), writeTrieNode(writer, keys, i, j, depth + 1)});
+      i = j;
+    }
+  }
+
+  const uint32_t offset = writer.position();
+  const LibraryIndex::Range range = {lo, static_cast<uint16_t>(hi - lo)};
+  serialization::writePod(writer, range);
+  serialization::writePod(writer, static_cast<uint8_t>(children.size()));
+  serialization::writePodArray(writer, children.data(), children.size());
+  return offset;
+}
+
+bool readOffset(FsFile& file, const uint32_t offsetsStart, const uint16_t record, uint32_t& offset) {
+  file.seek(offsetsStart + record * sizeof(uint32_t));
+  return file.read(&offset, sizeof(offset)) == sizeof(offset);
+}
+}  // namespace
+
+// State of a refresh in progress. The new index is written next to the old one and replaces it at the end, it is
+// only started once the walk finds a book that changed.
+struct LibraryIndex::Refresh {
+  FsFile oldFile;
+  uint32_t oldOffsetsStart = 0;
+  std::vector<uint32_t> oldOffsets;
+  std::vector<LookupEntry> oldLookup;  // Sorted by path hash
+  uint16_t reused = 0;
+  std::vector<uint16_t> unchanged;  // Old records of the books walked before the new index was started
+
+  FsFile newFile;
+  std::unique_ptr<BufferedFsWriter> writer;
+  std::vector<uint32_t> offsets;
+  std::vector<LookupEntry> lookup;
+  bool failed = false;
+
+  std::vector<std::string> pendingDirs;
+  FsFile dir;
+  std::string dirPath;
+  bool walkDone = false;
+  unsigned long startMs = 0;
+};
+
+// State of the cover job, the book being worked on and where to look for the next one
+struct LibraryIndex::Covers {
+  uint16_t next = 0;
+  uint16_t record = 0;
+  uint16_t generated = 0;
+  std::unique_ptr<Epub> epub;
+  std::unique_ptr<Epub::CoverImagesJob> job;
+  unsigned long startMs = 0;
+};
+
+LibraryIndex LibraryIndex::instance;
+
+LibraryIndex::~LibraryIndex() = default;
+
+bool LibraryIndex::open() {
+  loaded = false;
+  FsFile file;
+  if (!SdMan.exists(INDEX_FILE) || !SdMan.openFileForRead("LIB", INDEX_FILE, file)) {
+    return false;
+  }
+  const bool ok = file.read(&header, sizeof(header)) == sizeof(header) &&
+                  memcmp(header.magic, INDEX_MAGIC, sizeof(header.magic)) == 0 && header.version == INDEX_VERSION;
+  file.close();
+  if (!ok) {
+    Serial.printf("[%lu] [LIB] Ignoring unreadable index\n", millis());
+    return false;
+  }
+  loaded = true;
+  return true;
+}
+
+bool LibraryIndex::readRecord(FsFile& file, const uint16_t record, Entry& entry) const {
+  uint32_t offset;
+  if (record >= header.count || !readOffset(file, header.offsetsStart, record, offset)) {
+    return false;
+  }
+  file.seek(offset);
+  BufferedFsReader reader(file);
+  return readEntry(reader, entry);
+}
+
+bool LibraryIndex::readEntries(const View view, const uint16_t first, const uint16_t count,
+                               std::vector<Entry>& entries) const {
+  entries.clear();
+  if (!loaded || first >= header.count) {
+    return loaded;
+  }
+  FsFile file;
+  if (!SdMan.openFileForRead("LIB", INDEX_FILE, file)) {
+    return false;
+  }
+
+  const uint16_t end = std::min<uint32_t>(header.count, first + count);
+  std::vector<uint16_t> records(end - first);
+  file.seek(header.viewStart[static_cast<uint8_t>(view)] + first * sizeof(uint16_t));
+  bool ok = file.read(records.data(), records.size() * sizeof(uint16_t)) ==
+            static_cast<int>(records.size() * sizeof(uint16_t));
+
+  entries.reserve(records.size());
+  for (size_t i = 0; ok && i < records.size(); i++) {
+    entries.emplace_back();
+    ok = readRecord(file, records[i], entries.back());
+  }
+  file.close();
+  if (!ok) {
+    entries.clear();
+  }
+  return ok;
+}
+
+bool LibraryIndex::findRecord(FsFile& file, const std::string& path, uint16_t& record) const {
+  // Binary search the lookup table on the card, then check the paths of the entries sharing the hash
+  const uint32_t hash = pathHash(path);
+  uint16_t lo = 0, hi = header.count;
+  while (lo < hi) {
+    const uint16_t mid = lo + (hi - lo) / 2;
+    LookupEntry lookup;
+    file.seek(header.lookupStart + mid * sizeof(LookupEntry));
+    if (file.read(&lookup, sizeof(lookup)) != sizeof(lookup)) {
+      return false;
+    }
+    if (lookup.pathHash < hash) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+
+  Entry entry;
+  for (uint16_t i = lo; i < header.count; i++) {
+    LookupEntry lookup;
+    file.seek(header.lookupStart + i * sizeof(LookupEntry));
+    if (file.read(&lookup, sizeof(lookup)) != sizeof(lookup) || lookup.pathHash != hash) {
+      return false;
+    }
+    if (readRecord(file, lookup.record, entry) && entry.path == path) {
+      record = lookup.record;
+      return true;
+    }
+  }
+  return false;
+}
+
+std::string LibraryIndex::sortKey(const View view, const Entry& entry) {
+  if (view == View::Author) {
+    return (entry.author.empty() ? std::string(NO_AUTHOR_KEY) : normalize(entry.author)) + KEY_SEPARATOR +
+           normalize(entry.title);
+  }
+  return normalize(entry.title) + KEY_SEPARATOR + normalize(entry.author);
+}
+
+bool LibraryIndex::sortKeyAt(FsFile& file, const View view, const uint16_t position, std::string& key) const {
+  uint16_t record;
+  file.seek(header.viewStart[static_cast<uint8_t>(view)] + position * sizeof(uint16_t));
+  Entry entry;
+  if (file.read(&record, sizeof(record)) != sizeof(record) || !readRecord(file, record, entry)) {
+    return false;
+  }
+  key = sortKey(view, entry);
+  return true;
+}
+
+LibraryIndex::Range LibraryIndex::findPrefix(const View view, const std::string& prefix) const {
+  Range range = {0, 0};
+  if (!loaded || view == View::Newest) {
+    return range;
+  }
+  FsFile file;
+  if (!SdMan.openFileForRead("LIB", INDEX_FILE, file)) {
+    return range;
+  }
+
+  // Walk the trie as deep as it goes, the node's range holds every key starting with that much of the prefix
+  const std::string key = normalize(prefix);
+  uint32_t node = header.trieRoot[static_cast<uint8_t>(view)];
+  size_t depth = 0;
+  bool found = true;
+  while (true) {
+    uint8_t childCount;
+    file.seek(node);
+    if (file.read(&range, sizeof(range)) != sizeof(range) || file.read(&childCount, 1) != 1) {
+      found = false;
+      break;
+    }
+    if (depth == key.size() || depth == MAX_TRIE_DEPTH) {
+      break;
+    }
+    bool descended = false;
+    for (uint8_t i = 0; i < childCount; i++) {
+      TrieChild child;
+      if (file.read(&child, sizeof(child)) != sizeof(child)) {
+        break;
+      }
+      if (child.byte == static_cast<uint8_t>(key[depth])) {
+        node = child.offset;
+        descended = true;
+        break;
+      }
+    }
+    if (!descended) {
+      found = false;
+      break;
+    }
+    depth++;
+  }
+
+  if (!found) {
+    file.close();
+    return {0, 0};
+  }
+
+  // Past the trie depth the matches are still contiguous within the range, trim it from both ends
+  if (depth < key.size()) {
+    std::string candidate;
+    Range narrowed = {0, 0};
+    for (uint16_t position = range.first; position < range.first + range.count; position++) {
+      if (!sortKeyAt(file, view, position, candidate)) {
+        break;
+      }
+      if (candidate.compare(0, key.size(), key) == 0) {
+        if (narrowed.count == 0) {
+          narrowed.first = position;
+        }
+        narrowed.count++;
+      } else if (narrowed.count > 0) {
+        break;
+      }
+    }
+    range = narrowed;
+  }
+  file.close();
+  return range;
+}
+
+void LibraryIndex::beginRefresh() {
+  cancelRefresh();
+  // Record numbers change when the index is rewritten
+  cancelCovers();
+  refresh.reset(new Refresh());
+  Refresh& r = *refresh;
+  r.startMs = millis();
+
+  // The old index's offsets and lookup table say which books are unchanged, their records are kept as they are
+  if (open() && SdMan.openFileForRead("LIB", INDEX_FILE, r.oldFile)) {
+    r.oldOffsetsStart = header.offsetsStart;
+    r.oldOffsets.resize(header.count);
+    r.oldLookup.resize(header.count);
+    const int offsetBytes = static_cast<int>(r.oldOffsets.size() * sizeof(uint32_t));
+    const int lookupBytes = static_cast<int>(r.oldLookup.size() * sizeof(LookupEntry));
+    r.oldFile.seek(header.offsetsStart);
+    bool ok = r.oldFile.read(r.oldOffsets.data(), offsetBytes) == offsetBytes;
+    r.oldFile.seek(header.lookupStart);
+    ok = ok && r.oldFile.read(r.oldLookup.data(), lookupBytes) == lookupBytes;
+    if (!ok) {
+      r.oldOffsets.clear();
+      r.oldLookup.clear();
+    }
+  }
+  r.lookup.reserve(r.oldLookup.size() + 16);
+
+  r.pendingDirs.emplace_back("/");
+}
+
+bool LibraryIndex::startWriting() {
+  Refresh& r = *refresh;
+  SdMan.mkdir(CACHE_DIR);
+  if (!SdMan.openFileForWrite("LIB", NEW_INDEX_FILE, r.newFile)) {
+    return false;
+  }
+  r.writer.reset(new BufferedFsWriter(r.newFile));
+  // Filled in once the sections are written
+  const Header placeholder = {};
+  serialization::writePod(*r.writer, placeholder);
+
+  r.offsets.reserve(r.lookup.capacity());
+  std::vector<uint8_t> bytes;
+  for (const uint16_t record : r.unchanged) {
+    if (!readOldRecord(record, bytes)) {
+      return false;
+    }
+    r.offsets.push_back(r.writer->position());
+    r.writer->write(bytes.data(), bytes.size());
+  }
+  r.unchanged.clear();
+  r.unchanged.shrink_to_fit();
+  return !r.writer->hasFailed();
+}
+
+bool LibraryIndex::readOldRecord(const uint16_t record, std::vector<uint8_t>& bytes) {
+  Refresh& r = *refresh;
+  // A record ends where the next one starts, the last one where the offsets start
+  const uint32_t offset = r.oldOffsets[record];
+  const uint32_t end = record + 1u < r.oldOffsets.size() ? r.oldOffsets[record + 1] : r.oldOffsetsStart;
+  if (end <= offset || end - offset < sizeof(RecordHeader)) {
+    return false;
+  }
+  bytes.resize(end - offset);
+  r.oldFile.seek(offset);
+  return r.oldFile.read(bytes.data(), bytes.size()) == static_cast<int>(bytes.size());
+}
+
+void LibraryIndex::cancelRefresh() {
+  if (!refresh) {
+    return;
+  }
+  refresh->writer.reset();
+  refresh->newFile.close();
+  refresh->oldFile.close();
+  refresh->dir.close();
+  refresh.reset();
+  SdMan.remove(NEW_INDEX_FILE);
+}
+
+bool LibraryIndex::refreshStep(const unsigned long budgetMs) {
+  if (!refresh) {
+    return true;
+  }
+  const unsigned long start = millis();
+  while (!refresh->walkDone && !refresh->failed && millis() - start < budgetMs) {
+    walkStep();
+  }
+  if (!refresh->walkDone && !refresh->failed) {
+    return false;
+  }
+
+  const bool rewritten = !refresh->failed && finishRefresh();
+  const bool failed = refresh->failed;
+  const unsigned long elapsedMs = millis() - refresh->startMs;
+  const uint16_t reused = refresh->reused;
+  cancelRefresh();
+  open();
+  if (failed) {
+    Serial.printf("[%lu] [LIB] Refresh failed, keeping the old index\n", millis());
+  } else {
+    Serial.printf("[%lu] [LIB] Refresh done in %lu ms: %u books, %u reused, %s\n", millis(), elapsedMs, size(),
+                  static_cast<unsigned>(reused), rewritten ? "index rewritten" : "no changes");
+  }
+  return true;
+}
+
+void LibraryIndex::walkStep() {
+  Refresh& r = *refresh;
+  if (!r.dir) {
+    if (r.pendingDirs.empty()) {
+      r.walkDone = true;
+      return;
+    }
+    r.dirPath = std::move(r.pendingDirs.back());
+    r.pendingDirs.pop_back();
+    r.dir = SdMan.open(r.dirPath.c_str());
+    if (r.dir && !r.dir.isDirectory()) {
+      r.dir.close();
+    }
+    return;
+  }
+
+  FsFile file = r.dir.openNextFile();
+  if (!file) {
+    r.dir.close();
+    return;
+  }
+
+  char name[256];
+  file.getName(name, sizeof(name));
+  if (name[0] == '.' || strcmp(name, "System Volume Information") == 0) {
+    file.close();
+    return;
+  }
+
+  std::string path = r.dirPath;
+  if (path.back() != '/') {
+    path += '/';
+  }
+  path += name;
+
+  if (file.isDirectory()) {
+    r.pendingDirs.push_back(std::move(path));
+  } else {
+    addBook(path, file);
+  }
+  file.close();
+}
+
+void LibraryIndex::addBook(const std::string& path, FsFile& file) {
+  Refresh& r = *refresh;
+  Format format;
+  if (!bookFormat(path, format)) {
+    return;
+  }
+  if (r.lookup.size() >= MAX_BOOKS) {
+    return;
+  }
+
+  uint16_t date = 0, time = 0;
+  file.getModifyDateTime(&date, &time);
+  const auto size = static_cast<uint32_t>(file.fileSize());
+  const uint32_t mtime = static_cast<uint32_t>(date) << 16 | time;
+  const LookupEntry lookup = {pathHash(path), stampOf(size, mtime), static_cast<uint16_t>(r.lookup.size())};
+  r.lookup.push_back(lookup);
+
+  // Unchanged since the last refresh: keep the old record
+  const auto match = std::lower_bound(r.oldLookup.begin(), r.oldLookup.end(), lookup.pathHash,
+                                      [](const LookupEntry& e, const uint32_t hash) { return e.pathHash < hash; });
+  std::vector<uint8_t> bytes;
+  for (auto it = match; it != r.oldLookup.end() && it->pathHash == lookup.pathHash; ++it) {
+    if (it->stamp != lookup.stamp || it->record >= r.oldOffsets.size() || !readOldRecord(it->record, bytes)) {
+      continue;
+    }
+    RecordHeader recordHeader;
+    memcpy(&recordHeader, bytes.data(), sizeof(recordHeader));
+    // Hashes can collide, the path right after the header has to match too
+    uint32_t pathLength = 0;
+    size_t pos = sizeof(recordHeader);
+    for (uint8_t shift = 0; pos < bytes.size() && shift < 35; shift += 7) {
+      pathLength |= static_cast<uint32_t>(bytes[pos] & 0x7F) << shift;
+      if (!(bytes[pos++] & 0x80)) {
+        break;
+      }
+    }
+    if ((recordHeader.flags & FLAG_STALE) || pos + pathLength > bytes.size() ||
+        path.compare(0, std::string::npos, reinterpret_cast<const char*>(&bytes[pos]), pathLength) != 0) {
+      continue;
+    }
+    if (r.writer) {
+      r.offsets.push_back(r.writer->position());
+      r.writer->write(bytes.data(), bytes.size());
+    } else {
+      r.unchanged.push_back(it->record);
+    }
+    r.reused++;
+    return;
+  }
+
+  // New or changed, the metadata comes from whatever is cheap to read
+  if (!r.writer && !startWriting()) {
+    r.failed = true;
+    return;
+  }
+  Entry entry;
+  entry.path = path;
+  entry.size = size;
+  entry.mtime = mtime;
+  entry.format = format;
+  entry.progress = NO_PROGRESS;
+  uint8_t flags = 0;
+  if (format == Format::Epub) {
+    // Only books opened before have a metadata cache, parsing the OPF of every book would take minutes
+    Epub epub(path, CACHE_DIR);
+    if (epub.load(false)) {
+      entry.title = epub.getTitle();
+      entry.author = epub.getAuthor();
+      entry.language = epub.getLanguage();
+      flags |= FLAG_METADATA;
+    }
+    entry.thumbPath = epub.getThumbBmpPath();
+    entry.gridPath = epub.getGridThumbBmpPath();
+  } else if (format == Format::Xtc || format == Format::Xtch) {
+    Xtc xtc(path, CACHE_DIR);
+    if (xtc.load()) {
+      entry.title = xtc.getTitle();
+      entry.author = xtc.getAuthor();
+      flags |= FLAG_METADATA;
+    }
+    entry.thumbPath = xtc.getThumbBmpPath();
+    entry.gridPath = xtc.getGridThumbBmpPath();
+  } else {
+    flags |= FLAG_METADATA;
+  }
+  if (entry.title.empty()) {
+    entry.title = titleFromFileName(path);
+  }
+  // Left to the cover job when any image is missing, e.g. the thumbnail of a book opened before
+  if (!entry.gridPath.empty() && SdMan.exists(entry.thumbPath.c_str()) && SdMan.exists(entry.gridPath.c_str())) {
+    flags |= FLAG_COVERS;
+  }
+
+  const RecordHeader recordHeader = {size, mtime, static_cast<uint8_t>(format), flags, NO_PROGRESS};
+  r.offsets.push_back(r.writer->position());
+  serialization::writePod(*r.writer, recordHeader);
+  writeShortString(*r.writer, entry.path);
+  writeShortString(*r.writer, entry.title);
+  writeShortString(*r.writer, entry.author);
+  writeShortString(*r.writer, entry.language);
+  writeShortString(*r.writer, entry.thumbPath);
+  writeShortString(*r.writer, entry.gridPath);
+}
+
+bool LibraryIndex::finishRefresh() {
+  Refresh& r = *refresh;
+  r.dir.close();
+  r.oldLookup.clear();
+  r.oldLookup.shrink_to_fit();
+
+  // Every book on the card matched a record of the old index one to one
+  if (!r.writer && loaded && r.reused == header.count) {
+    return false;
+  }
+  // Only books were removed, the records of the others still have to be copied
+  if (!r.writer && !startWriting()) {
+    r.failed = true;
+    return false;
+  }
+  r.oldFile.close();
+  r.oldOffsets.clear();
+  r.oldOffsets.shrink_to_fit();
+
+  Header newHeader = {};
+  memcpy(newHeader.magic, INDEX_MAGIC, sizeof(newHeader.magic));
+  newHeader.version = INDEX_VERSION;
+  newHeader.count = static_cast<uint16_t>(r.offsets.size());
+
+  newHeader.offsetsStart = r.writer->position();
+  serialization::writePodArray(*r.writer, r.offsets.data(), r.offsets.size());
+  r.offsets.clear();
+  r.offsets.shrink_to_fit();
+
+  std::sort(r.lookup.begin(), r.lookup.end(),
+            [](const LookupEntry& a, const LookupEntry& b) { return a.pathHash < b.pathHash; });
+  newHeader.lookupStart = r.writer->position();
+  serialization::writePodArray(*r.writer, r.lookup.data(), r.lookup.size());
+  r.lookup.clear();
+  r.lookup.shrink_to_fit();
+
+  // Views are sorted from the records just written, so the header has to describe the new file while they are read
+  header = newHeader;
+  loaded = false;
+  for (uint8_t view = 0; view < VIEW_COUNT; view++) {
+    uint32_t viewStart = 0, trieRoot = 0;
+    if (!writeView(r.newFile, static_cast<View>(view), viewStart, trieRoot)) {
+      r.failed = true;
+      return false;
+    }
+    newHeader.viewStart[view] = viewStart;
+    if (view < TRIE_COUNT) {
+      newHeader.trieRoot[view] = trieRoot;
+    }
+  }
+
+  r.writer->seek(0);
+  serialization::writePod(*r.writer, newHeader);
+  if (!r.writer->flush()) {
+    r.failed = true;
+    return false;
+  }
+  r.writer.reset();
+  r.newFile.close();
+
+  SdMan.remove(INDEX_FILE);
+  FsFile renamed = SdMan.open(NEW_INDEX_FILE, O_RDWR);
+  if (!renamed || !renamed.rename(INDEX_FILE)) {
+    r.failed = true;
+    return false;
+  }
+  renamed.close();
+  return true;
+}
+
+bool LibraryIndex::writeView(FsFile& file, const View view, uint32_t& viewStart, uint32_t& trieRoot) {
+  BufferedFsWriter& writer = *refresh->writer;
+  const uint32_t end = writer.position();
+  if (!writer.flush()) {
+    return false;
+  }
+
+  // Records are read back in order, only what sorting needs stays in RAM
+  const uint16_t count = header.count;
+  std::vector<SortKey> keys;
+  std::vector<std::pair<uint32_t, uint16_t>> mtimes;
+  if (view == View::Newest) {
+    mtimes.reserve(count);
+  } else {
+    keys.resize(count);
+  }
+  file.seek(sizeof(Header));
+  {
+    BufferedFsReader reader(file);
+    Entry entry;
+    for (uint16_t record = 0; record < count; record++) {
+      if (!readEntry(reader, entry)) {
+        return false;
+      }
+      if (view == View::Newest) {
+        mtimes.emplace_back(entry.mtime, record);
+      } else {
+        const std::string key = sortKey(view, entry);
+        strncpy(keys[record].key, key.c_str(), SORT_KEY_LENGTH);
+        keys[record].record = record;
+      }
+    }
+  }
+
+  std::vector<uint16_t> order(count);
+  if (view == View::Newest) {
+    std::sort(mtimes.begin(), mtimes.end(), [](const std::pair<uint32_t, uint16_t>& a,
+                                               const std::pair<uint32_t, uint16_t>& b) {
+      return a.first != b.first ? a.first > b.first : a.second < b.second;
+    });
+    for (uint16_t i = 0; i < count; i++) {
+      order[i] = mtimes[i].second;
+    }
+  } else {
+    std::sort(keys.begin(), keys.end(), [](const SortKey& a, const SortKey& b) {
+      const int cmp = memcmp(a.key, b.key, SORT_KEY_LENGTH);
+      return cmp != 0 ? cmp < 0 : a.record < b.record;
+    });
+
+    // Keys that filled the whole prefix and tie on it are put in order by their full key
+    for (uint16_t i = 0; i < count;) {
+      uint16_t j = i + 1;
+      while (j < count && memcmp(keys[i].key, keys[j].key, SORT_KEY_LENGTH) == 0) {
+        j++;
+      }
+      if (j - i > 1 && keys[i].key[SORT_KEY_LENGTH - 1] != 0) {
+        std::vector<std::pair<std::string, uint16_t>> run;
+        run.reserve(j - i);
+        Entry entry;
+        for (uint16_t k = i; k < j; k++) {
+          if (!readRecord(file, keys[k].record, entry)) {
+            return false;
+          }
+          run.emplace_back(sortKey(view, entry), keys[k].record);
+        }
+        std::sort(run.begin(), run.end());
+        for (uint16_t k = i; k < j; k++) {
+          keys[k].record = run[k - i].second;
+        }
+      }
+      i = j;
+    }
+    for (uint16_t i = 0; i < count; i++) {
+      order[i] = keys[i].record;
+    }
+  }
+
+  writer.seek(end);
+  viewStart = end;
+  serialization::writePodArray(writer, order.data(), order.size());
+  if (view != View::Newest) {
+    trieRoot = writeTrieNode(writer, keys, 0, count, 0);
+  }
+  return !writer.hasFailed();
+}
+
+void LibraryIndex::updateProgress(const std::string& path, const uint8_t progress) {
+  if (!loaded && !open()) {
+    return;
+  }
+  FsFile file = SdMan.open(INDEX_FILE, O_RDWR);
+  if (!file) {
+    return;
+  }
+
+  uint16_t record;
+  uint32_t offset;
+  RecordHeader recordHeader;
+  if (findRecord(file, path, record) && readOffset(file, header.offsetsStart, record, offset) &&
+      file.seek(offset) && file.read(&recordHeader, sizeof(recordHeader)) == sizeof(recordHeader)) {
+    recordHeader.progress = progress;
+    // Opening the book wrote its metadata cache, the next refresh can pick up the real title and author
+    if (!(recordHeader.flags & FLAG_METADATA)) {
+      recordHeader.flags |= FLAG_STALE;
+    }
+    file.seek(offset);
+    file.write(reinterpret_cast<const uint8_t*>(&recordHeader), sizeof(recordHeader));
+  }
+  file.close();
+}
+
+void LibraryIndex::beginCovers() {
+  cancelCovers();
+  covers.reset(new Covers());
+  covers->startMs = millis();
+}
+
+void LibraryIndex::cancelCovers() {
+  // The job closes and removes its half written images
+  covers.reset();
+}
+
+bool LibraryIndex::coverStep(const unsigned long budgetMs) {
+  if (!covers) {
+    return true;
+  }
+  Covers& c = *covers;
+  const unsigned long start = millis();
+  while (millis() - start < budgetMs) {
+    if (!c.job && c.epub) {
+      c.job.reset(new Epub::CoverImagesJob(*c.epub));
+      const auto status = c.job->begin();
+      if (status != JpegToBmpConverter::Job::Status::Running) {
+        setRecordFlags(c.record, status == JpegToBmpConverter::Job::Status::Done ? FLAG_COVERS : FLAG_NO_COVER);
+        c.job.reset();
+        c.epub.reset();
+        c.generated++;
+      }
+      continue;
+    }
+    if (!c.job) {
+      if (!nextCoverBook(start + budgetMs)) {
+        if (c.next < size()) {
+          // Out of time while looking
+          return false;
+        }
+        Serial.printf("[%lu] [LIB] Cover images done in %lu ms: %u books\n", millis(), millis() - c.startMs,
+                      static_cast<unsigned>(c.generated));
+        covers.reset();
+        return true;
+      }
+      continue;
+    }
+
+    const auto status = c.job->step();
+    if (status != JpegToBmpConverter::Job::Status::Running) {
+      setRecordFlags(c.record, status == JpegToBmpConverter::Job::Status::Done ? FLAG_COVERS : FLAG_NO_COVER);
+      c.job.reset();
+      c.epub.reset();
+      c.generated++;
+    }
+  }
+  return false;
+}
+
+bool LibraryIndex::nextCoverBook(const unsigned long deadlineMs) {
+  Covers& c = *covers;
+  FsFile file;
+  if (!loaded || !SdMan.openFileForRead("LIB", INDEX_FILE, file)) {
+    c.next = size();
+    return false;
+  }
+
+  for (; c.next < header.count; c.next++) {
+    if (static_cast<long>(millis() - deadlineMs) >= 0) {
+      file.close();
+      return false;
+    }
+    uint32_t offset;
+    RecordHeader recordHeader;
+    if (!readOffset(file, header.offsetsStart, c.next, offset) || !file.seek(offset) ||
+        file.read(&recordHeader, sizeof(recordHeader)) != sizeof(recordHeader)) {
+      c.next = header.count;
+      break;
+    }
+    const auto format = static_cast<Format>(recordHeader.format);
+    if (!hasCoverImages(format) || (recordHeader.flags & (FLAG_COVERS | FLAG_NO_COVER))) {
+      continue;
+    }
+
+    Entry entry;
+    if (!readRecord(file, c.next, entry)) {
+      continue;
+    }
+    // Books never opened have no cache, building one here would stall the library for seconds per book. They are
+    // left until they were opened once.
+    if (format == Format::Epub) {
+      std::unique_ptr<Epub> epub(new Epub(entry.path, CACHE_DIR));
+      if (!epub->load(false)) {
+        continue;
+      }
+      c.record = c.next++;
+      file.close();
+      // The cover is extracted in a slice of its own, see coverStep()
+      c.epub = std::move(epub);
+      return true;
+    }
+
+    Xtc xtc(entry.path, CACHE_DIR);
+    if (!SdMan.exists(xtc.getCachePath().c_str())) {
+      continue;
+    }
+    c.record = c.next++;
+    file.close();
+    uint8_t flags = FLAG_NO_COVER;
+    // Pages are stored as bitmaps, each size is a pass over the first page without any decoding
+    if (xtc.load() && xtc.generateCoverBmp() && xtc.generateThumbBmp() && xtc.generateGridThumbBmp()) {
+      flags = FLAG_COVERS;
+    }
+    setRecordFlags(c.record, flags);
+    c.generated++;
+    return true;
+  }
+  file.close();
+  return false;
+}
+
+void LibraryIndex::setRecordFlags(const uint16_t record, const uint8_t flags) const {
+  FsFile file = SdMan.open(INDEX_FILE, O_RDWR);
+  if (!file) {
+    return;
+  }
+  uint32_t offset;
+  RecordHeader recordHeader;
+  if (readOffset(file, header.offsetsStart, record, offset) && file.seek(offset) &&
+      file.read(&recordHeader, sizeof(recordHeader)) == sizeof(recordHeader)) {
+    recordHeader.flags |= flags;
+    file.seek(offset);
+    file.write(reinterpret_cast<const uint8_t*>(&recordHeader), sizeof(recordHeader));
+  }
+  file.close();
+}
@@ -0,0 +1,163 @@
+#pragma once
+#include <Epub.h>
+#include <SdFat.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * LibraryIndex.h
+ *
+ * Metadata for every book on the SD card, kept in /.crosspoint/library.idx so the library can list, sort and search
+ * books without opening them. open() only reads the header and entries are read a page at a time, so a library of
+ * thousands of books opens as quickly as an empty one.
+ *
+ * A refresh walks the card and compares each book's size and modification time with the index. Unchanged books keep
+ * their record, new and changed ones get their metadata from the EPUB metadata cache (books opened before), the XTC
+ * header or the file name. When nothing changed nothing is written. The walk runs a slice at a time from the library's
+ * loop(), the old index stays readable until the new one replaces it.
+ *
+ * Once the index is up to date the cover job goes through the EPUB and XTC books whose cover images are missing and
+ * writes the sleep covers, the home thumbnail and the grid thumbnail of each, an EPUB's from one decode of its cover.
+ * Books never opened have no cache yet and are left until they were, building one would take seconds per book.
+ * Whether a book's images exist is kept in its record flags, so a grid can show covers with nothing but BMP blits.
+ *
+ * File layout, integers little endian:
+ *   Header
+ *   Records  per book: RecordHeader, then path, title, author, language, thumbnail and grid thumbnail path as
+ *            varint length + bytes
+ *   Offsets  u32 file offset per record
+ *   Lookup   LookupEntry per record, sorted by path hash, to find a book by path
+ *   Views    u16 record numbers in title, author and newest first order
+ *   Tries    for the title and author views: prefix trie over the first MAX_TRIE_DEPTH bytes of the sort keys
+ *
+ * Trie node: u16 first and u16 count (the range of the view starting with the node's prefix), u8 child count, then
+ * (u8 byte, u32 file offset) per child in byte order. The root sits at the view's trie offset and covers the view.
+ *
+ * All calls come from the loop task.
+ */
+class LibraryIndex {
+ public:
+  enum class View : uint8_t { Title = 0, Author = 1, Newest = 2 };
+  enum class Format : uint8_t { Epub = 0, Xtc = 1, Xtch = 2, Txt = 3, Markdown = 4 };
+
+  static constexpr uint8_t VIEW_COUNT = 3;
+  // Views with a search trie
+  static constexpr uint8_t TRIE_COUNT = 2;
+  static constexpr uint8_t MAX_TRIE_DEPTH = 8;
+  // Record numbers are u16, the walk stops adding books past this
+  static constexpr uint16_t MAX_BOOKS = 10000;
+  static constexpr uint8_t NO_PROGRESS = 0xFF;
+
+  struct Entry {
+    std::string path;
+    std::string title;
+    std::string author;
+    std::string language;
+    std::string thumbPath;  // Empty until the book's cover images are generated
+    std::string gridPath;
+    uint32_t size;
+    uint32_t mtime;  // FAT date << 16 | FAT time
+    Format format;
+    uint8_t progress;  // Percent read, NO_PROGRESS when never opened
+  };
+
+  // Range of a view, e.g. the books whose title starts with a prefix
+  struct Range {
+    uint16_t first;
+    uint16_t count;
+  };
+
+ private:
+  struct __attribute__((packed)) Header {
+    char magic[4];
+    uint8_t version;
+    uint16_t count;
+    uint32_t offsetsStart;
+    uint32_t lookupStart;
+    uint32_t viewStart[VIEW_COUNT];
+    uint32_t trieRoot[TRIE_COUNT];
+  };
+
+  struct __attribute__((packed)) RecordHeader {
+    uint32_t size;
+    uint32_t mtime;
+    uint8_t format;
+    uint8_t flags;
+    uint8_t progress;
+  };
+  static_assert(sizeof(RecordHeader) == 11, "RecordHeader size is part of the file format");
+
+  struct __attribute__((packed)) LookupEntry {
+    uint32_t pathHash;
+    uint32_t stamp;  // Hash of size and mtime
+    uint16_t record;
+  };
+
+  struct Refresh;
+  struct Covers;
+
+  static LibraryIndex instance;
+
+  Header header = {};
+  bool loaded = false;
+  std::unique_ptr<Refresh> refresh;
+  std::unique_ptr<Covers> covers;
+
+  bool readRecord(FsFile& file, uint16_t record, Entry& entry) const;
+  bool findRecord(FsFile& file, const std::string& path, uint16_t& record) const;
+  bool sortKeyAt(FsFile& file, View view, uint16_t position, std::string& key) const;
+
+  void walkStep();
+  void addBook(const std::string& path, FsFile& file);
+  // Opens the new index and copies the records kept so far, called once the walk finds a change
+  bool startWriting();
+  bool readOldRecord(uint16_t record, std::vector<uint8_t>& bytes);
+  bool finishRefresh();
+  // Sorts the records of the index being written, then appends the view and its trie
+  bool writeView(FsFile& file, View view, uint32_t& viewStart, uint32_t& trieRoot);
+
+  // Finds the next opened book without cover images and starts on them, false once every record was looked at. An
+  // EPUB is only loaded, coverStep() extracts its cover in the next slice.
+  bool nextCoverBook(unsigned long deadlineMs);
+  void setRecordFlags(uint16_t record, uint8_t flags) const;
+
+ public:
+  ~LibraryIndex();
+
+  static LibraryIndex& getInstance() { return instance; }
+
+  // Reads the header, false when there is no usable index yet
+  bool open();
+  uint16_t size() const { return loaded ? header.count : 0; }
+
+  // Reads count entries of the view starting at first, fewer at the end of the view
+  bool readEntries(View view, uint16_t first, uint16_t count, std::vector<Entry>& entries) const;
+  // Books of the view whose sort key starts with prefix, case insensitive. Only Title and Author can be searched.
+  Range findPrefix(View view, const std::string& prefix) const;
+
+  // Starts walking the card, call refreshStep() until it returns true
+  void beginRefresh();
+  // Walks for about budgetMs, true when the refresh is done and the index is up to date
+  bool refreshStep(unsigned long budgetMs);
+  bool isRefreshing() const { return refresh != nullptr; }
+  void cancelRefresh();
+
+  // Starts generating missing cover images, call coverStep() until it returns true. A refresh cancels it.
+  void beginCovers();
+  // Works on covers for about budgetMs, true when every book has its images
+  bool coverStep(unsigned long budgetMs);
+  bool isGeneratingCovers() const { return covers != nullptr; }
+  void cancelCovers();
+
+  // Called by the readers when a book is closed, updates the progress in place. A book indexed before its metadata
+  // cache existed is marked to be read again on the next refresh.
+  void updateProgress(const std::string& path, uint8_t progress);
+
+  // Lower cased sort key, leading spaces and punctuation dropped, books without an author sort last
+  static std::string sortKey(View view, const Entry& entry);
+};
+
+#define LIBRARY_INDEX LibraryIndex::getInstance()
@@ -1,4 +1,5 @@
 #pragma once
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -15,12 +16,17 @@ class RecentBooksStore {
   static RecentBooksStore instance;
 
   std::vector<RecentBook> recentBooks;
+  // The loop and the render task both reach getInstance(), only one of them reads the file
+  std::once_flag loadOnce;
 
  public:
   ~RecentBooksStore() = default;
 
-  // Get singleton instance
-  static RecentBooksStore& getInstance() { return instance; }
+  // Get singleton instance, the list is read from the SD card on first use since the first screen rarely needs it
+  static RecentBooksStore& getInstance() {
+    std::call_once(instance.loadOnce, [] { instance.loadFromFile(); });
+    return instance;
+  }
 
   // Add a book to the recent list (moves to front if already exists)
   void addBook(const std::string& path, const std::string& title, const std::string& author);
@@ -0,0 +1,144 @@
+#include "RenderService.h"
+
+#include <Arduino.h>
+#include <BootTimeline.h>
+#include <Logging.h>
+#include <Perf.h>
+
+#include "activities/Activity.h"
+
+RenderService RenderService::instance;
+
+bool RenderService::begin() {
+  if (taskHandle) {
+    return true;
+  }
+
+  renderMutex = xSemaphoreCreateRecursiveMutex();
+  queueMutex = xSemaphoreCreateMutex();
+  wakeup = xSemaphoreCreateBinary();
+  if (!renderMutex || !queueMutex || !wakeup) {
+    LOG_E(RND, "Failed to create render task semaphores");
+    return false;
+  }
+
+  if (xTaskCreate(&RenderService::taskTrampoline, "RenderTask",
+                  STACK_SIZE,  // Stack size
+                  this,        // Parameters
+                  1,           // Priority
+                  &taskHandle  // Task handle
+                  ) != pdPASS) {
+    LOG_E(RND, "Failed to create render task");
+    taskHandle = nullptr;
+    return false;
+  }
+  return true;
+}
+
+void RenderService::request(Activity* activity, const Priority priority) {
+  xSemaphoreTake(queueMutex, portMAX_DELAY);
+  stats.requests++;
+
+  bool queued = false;
+  for (uint8_t i = 0; i < pendingCount; i++) {
+    if (pending[i].activity == activity) {
+      if (priority > pending[i].priority) {
+        pending[i].priority = priority;
+      }
+      stats.coalesced++;
+      queued = true;
+      break;
+    }
+  }
+  if (!queued) {
+    if (pendingCount < MAX_PENDING) {
+      pending[pendingCount++] = {activity, priority, micros()};
+    } else {
+      stats.dropped++;
+      LOG_W(RND, "Frame queue full, dropping request");
+    }
+  }
+
+  xSemaphoreGive(queueMutex);
+  xSemaphoreGive(wakeup);
+}
+
+void RenderService::cancel(Activity* activity) {
+  // Holding the render lock means no frame is being drawn, and none can start until the queue is clean
+  lock();
+  xSemaphoreTake(queueMutex, portMAX_DELAY);
+  uint8_t kept = 0;
+  for (uint8_t i = 0; i < pendingCount; i++) {
+    if (pending[i].activity != activity) {
+      pending[kept++] = pending[i];
+    }
+  }
+  pendingCount = kept;
+  xSemaphoreGive(queueMutex);
+  unlock();
+}
+
+void RenderService::lock() { xSemaphoreTakeRecursive(renderMutex, portMAX_DELAY); }
+
+void RenderService::unlock() { xSemaphoreGiveRecursive(renderMutex); }
+
+bool RenderService::takeNext(Request& next, TickType_t& wait) {
+  xSemaphoreTake(queueMutex, portMAX_DELAY);
+  if (pendingCount == 0) {
+    xSemaphoreGive(queueMutex);
+    wait = portMAX_DELAY;
+    return false;
+  }
+
+  // Oldest input frame first, background frames only once nothing else is waiting
+  uint8_t index = 0;
+  for (uint8_t i = 0; i < pendingCount; i++) {
+    if (pending[i].priority == Priority::Input) {
+      index = i;
+      break;
+    }
+  }
+
+  if (pending[index].priority == Priority::Background) {
+    const unsigned long sinceLastFrame = millis() - lastFrameMs;
+    if (sinceLastFrame < BACKGROUND_FRAME_INTERVAL_MS) {
+      xSemaphoreGive(queueMutex);
+      wait = pdMS_TO_TICKS(BACKGROUND_FRAME_INTERVAL_MS - sinceLastFrame);
+      return false;
+    }
+  }
+
+  next = pending[index];
+  for (uint8_t i = index + 1; i < pendingCount; i++) {
+    pending[i - 1] = pending[i];
+  }
+  pendingCount--;
+  xSemaphoreGive(queueMutex);
+  return true;
+}
+
+void RenderService::taskTrampoline(void* param) {
+  auto* self = static_cast<RenderService*>(param);
+  self->taskLoop();
+}
+
+void RenderService::taskLoop() {
+  TickType_t wait = portMAX_DELAY;
+  while (true) {
+    xSemaphoreTake(wakeup, wait);
+
+    // Taken before the queue is read, so cancel() can't slip in between picking a frame and drawing it
+    lock();
+    Request next;
+    if (takeNext(next, wait)) {
+      next.activity->render();
+      boottimeline::mark(boottimeline::FIRST_FRAME);
+      lastFrameMs = millis();
+      stats.frames++;
+      PERF_RECORD(FRAME, micros() - next.requestedUs);
+      // More requests may have come in while drawing
+      wait = 0;
+    }
+    unlock();
+  }
+}
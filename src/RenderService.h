@@ -0,0 +1,83 @@
+#pragma once
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+
+#include <cstdint>
+
+class Activity;
+
+/**
+ * RenderService.h
+ *
+ * The one task that draws frames for every activity. Activities call requestUpdate() when their state changed and
+ * implement render(), which this task calls with the render lock held. A request for an activity that already has a
+ * frame pending is folded into it, the frame draws whatever the state is by the time it runs.
+ *
+ * Input frames (button presses) are drawn as soon as the task is free. Background frames (progress, network status)
+ * wait until BACKGROUND_FRAME_INTERVAL_MS after the previous frame so a burst of them costs one refresh. An input
+ * request for an activity with a background frame pending promotes it.
+ *
+ * The render lock is recursive. Activities hold it while changing state that render() reads, e.g. when replacing a
+ * section or switching sub-activities, and Activity::onExit() cancels the activity's pending frames under it so no
+ * frame runs on a deleted activity.
+ */
+class RenderService {
+ public:
+  enum class Priority : uint8_t { Background = 0, Input = 1 };
+
+  // Deepest of the former per-activity display tasks, EPUB pages lay out chapters from render()
+  static constexpr uint32_t STACK_SIZE = 8192;
+  static constexpr unsigned long BACKGROUND_FRAME_INTERVAL_MS = 250;
+  // An activity and its sub-activities, they never have more than one frame pending each
+  static constexpr uint8_t MAX_PENDING = 4;
+
+  struct Stats {
+    uint32_t requests;
+    uint32_t coalesced;  // Requests folded into a frame that was already pending
+    uint32_t frames;
+    uint32_t dropped;  // Requests lost to a full queue, should stay 0
+  };
+
+ private:
+  struct Request {
+    Activity* activity;
+    Priority priority;
+    unsigned long requestedUs;  // First request the frame covers, frame latency is measured from here
+  };
+
+  static RenderService instance;
+
+  TaskHandle_t taskHandle = nullptr;
+  SemaphoreHandle_t renderMutex = nullptr;  // Recursive, held for the whole frame
+  SemaphoreHandle_t queueMutex = nullptr;
+  SemaphoreHandle_t wakeup = nullptr;  // Given on every request
+  Request pending[MAX_PENDING] = {};
+  uint8_t pendingCount = 0;
+  unsigned long lastFrameMs = 0;
+  Stats stats = {};
+
+  static void taskTrampoline(void* param);
+  [[noreturn]] void taskLoop();
+  // Pops the next frame that is due, otherwise sets wait to how long until one is
+  bool takeNext(Request& next, TickType_t& wait);
+
+ public:
+  static RenderService& getInstance() { return instance; }
+
+  // Starts the render task, call once in setup() before the first activity is entered
+  bool begin();
+
+  // Safe from any task, including the render task itself
+  void request(Activity* activity, Priority priority);
+  // Drops the activity's pending frames and waits for one in flight to finish
+  void cancel(Activity* activity);
+
+  void lock();
+  void unlock();
+
+  TaskHandle_t getTaskHandle() const { return taskHandle; }
+  Stats getStats() const { return stats; }
+};
+
+#define RENDER_SERVICE RenderService::getInstance()
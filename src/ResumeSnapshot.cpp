@@ -0,0 +1,101 @@
+#include "ResumeSnapshot.h"
+
+#include <HalDisplay.h>
+#include <Logging.h>
+#include <PackBits.h>
+#include <SDCardManager.h>
+#include <Serialization.h>
+
+#include <cstring>
+
+namespace {
+constexpr char SNAPSHOT_FILE[] = "/.crosspoint/resume.bin";
+constexpr char SNAPSHOT_FILE_MAGIC[4] = {'C', 'P', 'R', 'S'};
+constexpr uint8_t SNAPSHOT_FILE_VERSION = 1;
+}  // namespace
+
+ResumeSnapshot ResumeSnapshot::instance;
+
+bool ResumeSnapshot::save(const uint8_t* frameBuffer, const std::string& bookPath, const uint16_t spineIndex,
+                          const uint16_t page) const {
+  FsFile file;
+  if (!SdMan.openFileForWrite("RSM", SNAPSHOT_FILE, file)) {
+    return false;
+  }
+
+  const unsigned long start = millis();
+  bool ok;
+  {
+    BufferedFsWriter writer(file);
+    writer.write(reinterpret_cast<const uint8_t*>(SNAPSHOT_FILE_MAGIC), sizeof(SNAPSHOT_FILE_MAGIC));
+    serialization::writePod(writer, SNAPSHOT_FILE_VERSION);
+    serialization::writeString(writer, bookPath);
+    serialization::writePod(writer, spineIndex);
+    serialization::writePod(writer, page);
+    serialization::writePod(writer, HalDisplay::BUFFER_SIZE);
+    packbits::pack(writer, frameBuffer, HalDisplay::BUFFER_SIZE);
+    ok = writer.flush();
+  }
+  const size_t fileSize = file.size();
+  file.close();
+
+  if (!ok) {
+    LOG_E(RSM, "Failed to write snapshot");
+    SdMan.remove(SNAPSHOT_FILE);
+    return false;
+  }
+  LOG_I(RSM, "Saved snapshot of %s at %u/%u, %u bytes in %lums", bookPath.c_str(), spineIndex, page,
+        static_cast<unsigned>(fileSize), millis() - start);
+  return true;
+}
+
+bool ResumeSnapshot::restore(uint8_t* frameBuffer) {
+  if (!SdMan.exists(SNAPSHOT_FILE)) {
+    return false;
+  }
+
+  FsFile file;
+  if (!SdMan.openFileForRead("RSM", SNAPSHOT_FILE, file)) {
+    return false;
+  }
+
+  bool ok;
+  {
+    BufferedFsReader reader(file);
+    char magic[sizeof(SNAPSHOT_FILE_MAGIC)];
+    uint8_t version = 0;
+    uint32_t bufferSize = 0;
+    ok = reader.read(reinterpret_cast<uint8_t*>(magic), sizeof(magic)) == sizeof(magic) &&
+         memcmp(magic, SNAPSHOT_FILE_MAGIC, sizeof(magic)) == 0;
+    if (ok) {
+      serialization::readPod(reader, version);
+      serialization::readString(reader, shownBookPath);
+      serialization::readPod(reader, shownSpineIndex);
+      serialization::readPod(reader, shownPage);
+      serialization::readPod(reader, bufferSize);
+      ok = version == SNAPSHOT_FILE_VERSION && bufferSize == HalDisplay::BUFFER_SIZE &&
+           packbits::unpack(reader, frameBuffer, HalDisplay::BUFFER_SIZE);
+    }
+  }
+  file.close();
+
+  // Shown at most once, a stale page must not come back after a later wake
+  SdMan.remove(SNAPSHOT_FILE);
+
+  if (!ok) {
+    LOG_W(RSM, "Discarding unreadable snapshot");
+    shownBookPath.clear();
+    return false;
+  }
+  LOG_I(RSM, "Restored snapshot of %s at %u/%u", shownBookPath.c_str(), shownSpineIndex, shownPage);
+  return true;
+}
+
+bool ResumeSnapshot::consumeShownPage(const std::string& bookPath, const int spineIndex, const int page) {
+  if (shownBookPath.empty()) {
+    return false;
+  }
+  const bool matches = shownBookPath == bookPath && shownSpineIndex == spineIndex && shownPage == page;
+  shownBookPath.clear();
+  return matches;
+}
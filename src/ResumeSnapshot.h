@@ -0,0 +1,42 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+/**
+ * ResumeSnapshot.h
+ *
+ * The page on screen when the device went to sleep from a book, so waking up can put it straight back on the panel
+ * instead of showing the boot screen until the book, its section and the page have been loaded again.
+ *
+ * save() writes the frame buffer PackBits compressed (a page of text is mostly runs of white) together with the book
+ * and position it shows. restore() decodes it into the frame buffer on wake and deletes the file, a snapshot is only
+ * ever shown once. The reader asks consumeShownPage() on its first frame, when the page it is about to draw is the one
+ * already on the panel it skips drawing and the first page turn is the first frame after waking.
+ */
+class ResumeSnapshot {
+  // Static instance
+  static ResumeSnapshot instance;
+
+  // What restore() put on the panel, empty path once consumed
+  std::string shownBookPath;
+  uint16_t shownSpineIndex = 0;
+  uint16_t shownPage = 0;
+
+ public:
+  ~ResumeSnapshot() = default;
+
+  // Get singleton instance
+  static ResumeSnapshot& getInstance() { return instance; }
+
+  // frameBuffer must hold the page in panel format, HalDisplay::BUFFER_SIZE bytes
+  bool save(const uint8_t* frameBuffer, const std::string& bookPath, uint16_t spineIndex, uint16_t page) const;
+
+  // Loads the snapshot into frameBuffer, false when there is none or it is unreadable
+  bool restore(uint8_t* frameBuffer);
+
+  // True once if the restored snapshot shows this page
+  bool consumeShownPage(const std::string& bookPath, int spineIndex, int page);
+};
+
+// Helper macro to access the resume snapshot
+#define RESUME_SNAPSHOT ResumeSnapshot::getInstance()
@@ -1,10 +1,13 @@
 #pragma once
 
 #include <HardwareSerial.h>
+#include <MemStats.h>
 
 #include <string>
 #include <utility>
 
+#include "RenderService.h"
+
 class MappedInputManager;
 class GfxRenderer;
 
@@ -14,12 +17,31 @@ class Activity {
   GfxRenderer& renderer;
   MappedInputManager& mappedInput;
 
+  // Queues a frame for this activity on the render task, see RenderService
+  void requestUpdate(const RenderService::Priority priority = RenderService::Priority::Input) {
+    RENDER_SERVICE.request(this, priority);
+  }
+
  public:
   explicit Activity(std::string name, GfxRenderer& renderer, MappedInputManager& mappedInput)
       : name(std::move(name)), renderer(renderer), mappedInput(mappedInput) {}
   virtual ~Activity() = default;
-  virtual void onEnter() { Serial.printf("[%lu] [ACT] Entering activity: %s\n", millis(), name.c_str()); }
-  virtual void onExit() { Serial.printf("[%lu] [ACT] Exiting activity: %s\n", millis(), name.c_str()); }
+  virtual void onEnter() {
+    Serial.printf("[%lu] [ACT] Entering activity: %s\n", millis(), name.c_str());
+    memstats::record(memstats::ACTIVITY_ENTER, name.c_str(), RENDER_SERVICE.getTaskHandle());
+  }
+  // Subclasses call this before tearing down anything render() reads, it waits out a frame in flight
+  virtual void onExit() {
+    Serial.printf("[%lu] [ACT] Exiting activity: %s\n", millis(), name.c_str());
+    RENDER_SERVICE.cancel(this);
+    memstats::record(memstats::ACTIVITY_EXIT, name.c_str(), RENDER_SERVICE.getTaskHandle());
+  }
+  // Called from the main loop every memstats::SAMPLE_INTERVAL_MS
+  virtual void sampleMemory() { memstats::record(memstats::PERIODIC, name.c_str(), RENDER_SERVICE.getTaskHandle()); }
+  // Draws the current state, called on the render task with the render lock held
+  virtual void render() {}
+  // Called before the device sleeps, while the activity's last frame is still in the frame buffer
+  virtual void onSleep() {}
   virtual void loop() {}
   virtual bool skipLoopDelay() { return false; }
   virtual bool preventAutoSleep() { return false; }
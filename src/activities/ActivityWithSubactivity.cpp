@@ -4,6 +4,8 @@ void ActivityWithSubactivity::exitActivity() {
   if (subActivity) {
     subActivity->onExit();
     subActivity.reset();
+    // Whatever the sub-activity covered has to be drawn again
+    requestUpdate();
   }
 }
 
@@ -20,5 +22,22 @@ void ActivityWithSubactivity::loop() {
 
 void ActivityWithSubactivity::onExit() {
   Activity::onExit();
-  exitActivity();
+  // Not exitActivity(), nothing has to be drawn again on the way out and a frame queued now would outlive this
+  if (subActivity) {
+    subActivity->onExit();
+    subActivity.reset();
+  }
+}
+
+void ActivityWithSubactivity::sampleMemory() {
+  Activity::sampleMemory();
+  if (subActivity) {
+    subActivity->sampleMemory();
+  }
+}
+
+void ActivityWithSubactivity::onSleep() {
+  if (subActivity) {
+    subActivity->onSleep();
+  }
 }
@@ -2,16 +2,68 @@
 
 #include <Epub.h>
 #include <GfxRenderer.h>
+#include <PanelImage.h>
 #include <SDCardManager.h>
 #include <Txt.h>
 #include <Xtc.h>
 
+#include <algorithm>
+#include <vector>
+
 #include "CrossPointSettings.h"
 #include "CrossPointState.h"
 #include "fontIds.h"
 #include "images/CrossLarge.h"
 #include "util/StringUtils.h"
 
+namespace {
+// Panel images of the user's own sleep BMPs are kept out of /sleep, named after the source path
+constexpr char CUSTOM_PANEL_IMAGE_DIR[] = "/.crosspoint/sleep";
+
+std::string customPanelImageName(const std::string& bmpPath) {
+  return std::to_string(std::hash<std::string>{}(bmpPath)) + ".fb";
+}
+
+std::string customPanelImagePath(const std::string& bmpPath) {
+  SdMan.mkdir(CUSTOM_PANEL_IMAGE_DIR);
+  return std::string(CUSTOM_PANEL_IMAGE_DIR) + "/" + customPanelImageName(bmpPath);
+}
+
+// Removes the panel images whose sleep BMP is gone, they would otherwise pile up as images are swapped out
+void removeOrphanedPanelImages(const std::vector<std::string>& bmpPaths) {
+  auto dir = SdMan.open(CUSTOM_PANEL_IMAGE_DIR);
+  if (!dir || !dir.isDirectory()) {
+    if (dir) dir.close();
+    return;
+  }
+
+  std::vector<std::string> keep;
+  keep.reserve(bmpPaths.size());
+  for (const auto& bmpPath : bmpPaths) {
+    keep.push_back(customPanelImageName(bmpPath));
+  }
+
+  std::vector<std::string> orphans;
+  char name[64];
+  for (auto file = dir.openNextFile(); file; file = dir.openNextFile()) {
+    if (!file.isDirectory()) {
+      file.getName(name, sizeof(name));
+      if (std::find(keep.begin(), keep.end(), name) == keep.end()) {
+        orphans.emplace_back(name);
+      }
+    }
+    file.close();
+  }
+  dir.close();
+
+  for (const auto& orphan : orphans) {
+    const std::string path = std::string(CUSTOM_PANEL_IMAGE_DIR) + "/" + orphan;
+    Serial.printf("[%lu] [SLP] Removing orphaned panel image %s\n", millis(), path.c_str());
+    SdMan.remove(path.c_str());
+  }
+}
+}  // namespace
+
 void SleepActivity::onEnter() {
   Activity::onEnter();
   renderPopup("Entering Sleep...");
@@ -47,9 +99,9 @@ void SleepActivity::renderPopup(const char* message) const {
 
 void SleepActivity::renderCustomSleepScreen() const {
   // Check if we have a /sleep directory
+  std::vector<std::string> files;
   auto dir = SdMan.open("/sleep");
   if (dir && dir.isDirectory()) {
-    std::vector<std::string> files;
     char name[500];
     // collect all valid BMP files
     for (auto file = dir.openNextFile(); file; file = dir.openNextFile()) {
@@ -78,31 +130,39 @@ void SleepActivity::renderCustomSleepScreen() const {
       files.emplace_back(filename);
       file.close();
     }
-    const auto numFiles = files.size();
-    if (numFiles > 0) {
-      // Generate a random number between 1 and numFiles
-      auto randomFileIndex = random(numFiles);
-      // If we picked the same image as last time, reroll
-      while (numFiles > 1 && randomFileIndex == APP_STATE.lastSleepImage) {
-        randomFileIndex = random(numFiles);
-      }
-      APP_STATE.lastSleepImage = randomFileIndex;
-      APP_STATE.saveToFile();
-      const auto filename = "/sleep/" + files[randomFileIndex];
-      FsFile file;
-      if (SdMan.openFileForRead("SLP", filename, file)) {
-        Serial.printf("[%lu] [SLP] Randomly loading: /sleep/%s\n", millis(), files[randomFileIndex].c_str());
-        delay(100);
-        Bitmap bitmap(file, true);
-        if (bitmap.parseHeaders() == BmpReaderError::Ok) {
-          renderBitmapSleepScreen(bitmap);
-          dir.close();
-          return;
-        }
+  }
+  if (dir) dir.close();
+
+  std::vector<std::string> bmpPaths;
+  bmpPaths.reserve(files.size() + 1);
+  for (const auto& filename : files) {
+    bmpPaths.push_back("/sleep/" + filename);
+  }
+  bmpPaths.emplace_back("/sleep.bmp");
+  removeOrphanedPanelImages(bmpPaths);
+
+  const auto numFiles = files.size();
+  if (numFiles > 0) {
+    // Generate a random number between 1 and numFiles
+    auto randomFileIndex = random(numFiles);
+    // If we picked the same image as last time, reroll
+    while (numFiles > 1 && randomFileIndex == APP_STATE.lastSleepImage) {
+      randomFileIndex = random(numFiles);
+    }
+    APP_STATE.lastSleepImage = randomFileIndex;
+    APP_STATE.saveToFile();
+    const auto& filename = bmpPaths[randomFileIndex];
+    FsFile file;
+    if (SdMan.openFileForRead("SLP", filename, file)) {
+      Serial.printf("[%lu] [SLP] Randomly loading: %s\n", millis(), filename.c_str());
+      delay(100);
+      Bitmap bitmap(file, true);
+      if (bitmap.parseHeaders() == BmpReaderError::Ok) {
+        renderBitmapSleepScreen(file, bitmap, customPanelImagePath(filename));
+        return;
       }
     }
   }
-  if (dir) dir.close();
 
   // Look for sleep.bmp on the root of the sd card to determine if we should
   // render a custom sleep screen instead of the default.
@@ -111,7 +171,7 @@ void SleepActivity::renderCustomSleepScreen() const {
     Bitmap bitmap(file, true);
     if (bitmap.parseHeaders() == BmpReaderError::Ok) {
       Serial.printf("[%lu] [SLP] Loading: /sleep.bmp\n", millis());
-      renderBitmapSleepScreen(bitmap);
+      renderBitmapSleepScreen(file, bitmap, customPanelImagePath("/sleep.bmp"));
       return;
     }
   }
@@ -136,7 +196,8 @@ void SleepActivity::renderDefaultSleepScreen() const {
   renderer.displayBuffer(HalDisplay::HALF_REFRESH);
 }
 
-void SleepActivity::renderBitmapSleepScreen(const Bitmap& bitmap) const {
+void SleepActivity::renderBitmapSleepScreen(FsFile& file, const Bitmap& bitmap,
+                                            const std::string& panelImagePath) const {
   int x, y;
   const auto pageWidth = renderer.getScreenWidth();
   const auto pageHeight = renderer.getScreenHeight();
@@ -177,15 +238,54 @@ void SleepActivity::renderBitmapSleepScreen(const Bitmap& bitmap) const {
     y = (pageHeight - bitmap.getHeight()) / 2;
   }
 
+  const bool hasGreyscale = bitmap.hasGreyscale() &&
+                            SETTINGS.sleepScreenCoverFilter == CrossPointSettings::SLEEP_SCREEN_COVER_FILTER::NO_FILTER;
+  const bool inverted =
+      SETTINGS.sleepScreenCoverFilter == CrossPointSettings::SLEEP_SCREEN_COVER_FILTER::INVERTED_BLACK_AND_WHITE;
+  const int planeCount = hasGreyscale ? 3 : 1;
+  const auto cropXKey = static_cast<int32_t>(std::lround(cropX * 10000));
+  const auto cropYKey = static_cast<int32_t>(std::lround(cropY * 10000));
+  const uint32_t key = PanelImage::makeKey(file, {x, y, cropXKey, cropYKey, renderer.getOrientation(), planeCount});
+
+  // Converted on an earlier sleep: copy the planes straight into the frame buffer
+  PanelImage panelImage;
+  if (panelImage.open(panelImagePath, key) && panelImage.getPlaneCount() == planeCount) {
+    Serial.printf("[%lu] [SLP] Drawing panel image %s\n", millis(), panelImagePath.c_str());
+    renderer.clearScreen();
+    if (panelImage.drawPlane(renderer, 0)) {
+      if (inverted) {
+        renderer.invertScreen();
+      }
+      renderer.displayBuffer(HalDisplay::HALF_REFRESH);
+
+      if (hasGreyscale) {
+        renderer.clearScreen(0x00);
+        const bool lsbDrawn = panelImage.drawPlane(renderer, 1);
+        renderer.copyGrayscaleLsbBuffers();
+        renderer.clearScreen(0x00);
+        const bool msbDrawn = panelImage.drawPlane(renderer, 2);
+        renderer.copyGrayscaleMsbBuffers();
+        if (lsbDrawn && msbDrawn) {
+          renderer.displayGrayBuffer();
+        }
+      }
+      return;
+    }
+  }
+  panelImage.close();
+
   Serial.printf("[%lu] [SLP] drawing to %d x %d\n", millis(), x, y);
   renderer.clearScreen();
 
-  const bool hasGreyscale = bitmap.hasGreyscale() &&
-                            SETTINGS.sleepScreenCoverFilter == CrossPointSettings::SLEEP_SCREEN_COVER_FILTER::NO_FILTER;
+  // The planes cover the whole screen, a fit image leaves white (or black for the gray planes) bars which compress
+  // to almost nothing
+  bool saving = !panelImagePath.empty() &&
+                panelImage.begin(panelImagePath, key, renderer, 0, 0, pageWidth, pageHeight);
 
   renderer.drawBitmap(bitmap, x, y, pageWidth, pageHeight, cropX, cropY);
+  saving = saving && panelImage.addPlane(renderer);
 
-  if (SETTINGS.sleepScreenCoverFilter == CrossPointSettings::SLEEP_SCREEN_COVER_FILTER::INVERTED_BLACK_AND_WHITE) {
+  if (inverted) {
     renderer.invertScreen();
   }
 
@@ -196,17 +296,23 @@ void SleepActivity::renderBitmapSleepScreen(const Bitmap& bitmap) const {
     renderer.clearScreen(0x00);
     renderer.setRenderMode(GfxRenderer::GRAYSCALE_LSB);
     renderer.drawBitmap(bitmap, x, y, pageWidth, pageHeight, cropX, cropY);
+    saving = saving && panelImage.addPlane(renderer);
     renderer.copyGrayscaleLsbBuffers();
 
     bitmap.rewindToData();
     renderer.clearScreen(0x00);
     renderer.setRenderMode(GfxRenderer::GRAYSCALE_MSB);
     renderer.drawBitmap(bitmap, x, y, pageWidth, pageHeight, cropX, cropY);
+    saving = saving && panelImage.addPlane(renderer);
     renderer.copyGrayscaleMsbBuffers();
 
     renderer.displayGrayBuffer();
     renderer.setRenderMode(GfxRenderer::BW);
   }
+
+  if (saving) {
+    panelImage.finish();
+  }
 }
 
 void SleepActivity::renderCoverSleepScreen() const {
@@ -269,8 +375,8 @@ void SleepActivity::renderCoverSleepScreen() const {
   if (SdMan.openFileForRead("SLP", coverBmpPath, file)) {
     Bitmap bitmap(file);
     if (bitmap.parseHeaders() == BmpReaderError::Ok) {
-      Serial.printf("[SLP] Rendering sleep cover: %s\n", coverBmpPath);
-      renderBitmapSleepScreen(bitmap);
+      Serial.printf("[SLP] Rendering sleep cover: %s\n", coverBmpPath.c_str());
+      renderBitmapSleepScreen(file, bitmap, PanelImage::pathFor(coverBmpPath));
       return;
     }
   }
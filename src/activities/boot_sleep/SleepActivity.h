@@ -1,7 +1,10 @@
 #pragma once
+#include <string>
+
 #include "../Activity.h"
 
 class Bitmap;
+class FsFile;
 
 class SleepActivity final : public Activity {
  public:
@@ -14,6 +17,7 @@ class SleepActivity final : public Activity {
   void renderDefaultSleepScreen() const;
   void renderCustomSleepScreen() const;
   void renderCoverSleepScreen() const;
-  void renderBitmapSleepScreen(const Bitmap& bitmap) const;
+  // Shows the panel image at panelImagePath when it matches, otherwise draws the bitmap and saves one there
+  void renderBitmapSleepScreen(FsFile& file, const Bitmap& bitmap, const std::string& panelImagePath) const;
   void renderBlankSleepScreen() const;
 };
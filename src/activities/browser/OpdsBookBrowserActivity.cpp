@@ -20,15 +20,9 @@ constexpr int PAGE_ITEMS = 23;
 constexpr int SKIP_PAGE_MS = 700;
 }  // namespace
 
-void OpdsBookBrowserActivity::taskTrampoline(void* param) {
-  auto* self = static_cast<OpdsBookBrowserActivity*>(param);
-  self->displayTaskLoop();
-}
-
 void OpdsBookBrowserActivity::onEnter() {
   ActivityWithSubactivity::onEnter();
 
-  renderingMutex = xSemaphoreCreateMutex();
   state = BrowserState::CHECK_WIFI;
   entries.clear();
   navigationHistory.clear();
@@ -36,14 +30,7 @@ void OpdsBookBrowserActivity::onEnter() {
   selectorIndex = 0;
   errorMessage.clear();
   statusMessage = "Checking WiFi...";
-  updateRequired = true;
-
-  xTaskCreate(&OpdsBookBrowserActivity::taskTrampoline, "OpdsBookBrowserTask",
-              4096,               // Stack size (larger for HTTP operations)
-              this,               // Parameters
-              1,                  // Priority
-              &displayTaskHandle  // Task handle
-  );
+  requestUpdate();
 
   // Check WiFi and connect if needed, then fetch feed
   checkAndConnectWifi();
@@ -55,13 +42,6 @@ void OpdsBookBrowserActivity::onExit() {
   // Turn off WiFi when exiting
   WiFi.mode(WIFI_OFF);
 
-  xSemaphoreTake(renderingMutex, portMAX_DELAY);
-  if (displayTaskHandle) {
-    vTaskDelete(displayTaskHandle);
-    displayTaskHandle = nullptr;
-  }
-  vSemaphoreDelete(renderingMutex);
-  renderingMutex = nullptr;
   entries.clear();
   navigationHistory.clear();
 }
@@ -82,7 +62,7 @@ void OpdsBookBrowserActivity::loop() {
         Serial.printf("[%lu] [OPDS] Retry: WiFi connected, retrying fetch\n", millis());
         state = BrowserState::LOADING;
         statusMessage = "Loading...";
-        updateRequired = true;
+        requestUpdate();
         fetchFeed(currentPath);
       } else {
         // WiFi not connected - launch WiFi selection
@@ -141,31 +121,24 @@ void OpdsBookBrowserActivity::loop() {
       } else {
         selectorIndex = (selectorIndex + entries.size() - 1) % entries.size();
       }
-      updateRequired = true;
+      requestUpdate();
     } else if (nextReleased && !entries.empty()) {
       if (skipPage) {
         selectorIndex = ((selectorIndex / PAGE_ITEMS + 1) * PAGE_ITEMS) % entries.size();
       } else {
         selectorIndex = (selectorIndex + 1) % entries.size();
       }
-      updateRequired = true;
+      requestUpdate();
     }
   }
 }
 
-void OpdsBookBrowserActivity::displayTaskLoop() {
-  while (true) {
-    if (updateRequired) {
-      updateRequired = false;
-      xSemaphoreTake(renderingMutex, portMAX_DELAY);
-      render();
-      xSemaphoreGive(renderingMutex);
-    }
-    vTaskDelay(10 / portTICK_PERIOD_MS);
+void OpdsBookBrowserActivity::render() {
+  // The WiFi selection sub-activity draws the screen while it is open
+  if (subActivity) {
+    return;
   }
-}
 
-void OpdsBookBrowserActivity::render() const {
   renderer.clearScreen();
 
   const auto pageWidth = renderer.getScreenWidth();
@@ -258,7 +231,7 @@ void OpdsBookBrowserActivity::fetchFeed(const std::string& path) {
   if (strlen(serverUrl) == 0) {
     state = BrowserState::ERROR;
     errorMessage = "No server URL configured";
-    updateRequired = true;
+    requestUpdate();
     return;
   }
 
@@ -272,7 +245,7 @@ void OpdsBookBrowserActivity::fetchFeed(const std::string& path) {
     if (!HttpDownloader::fetchUrl(url, stream)) {
       state = BrowserState::ERROR;
       errorMessage = "Failed to fetch feed";
-      updateRequired = true;
+      requestUpdate();
       return;
     }
   }
@@ -280,7 +253,7 @@ void OpdsBookBrowserActivity::fetchFeed(const std::string& path) {
   if (!parser) {
     state = BrowserState::ERROR;
     errorMessage = "Failed to parse feed";
-    updateRequired = true;
+    requestUpdate();
     return;
   }
 
@@ -291,12 +264,12 @@ void OpdsBookBrowserActivity::fetchFeed(const std::string& path) {
   if (entries.empty()) {
     state = BrowserState::ERROR;
     errorMessage = "No entries found";
-    updateRequired = true;
+    requestUpdate();
     return;
   }
 
   state = BrowserState::BROWSING;
-  updateRequired = true;
+  requestUpdate();
 }
 
 void OpdsBookBrowserActivity::navigateToEntry(const OpdsEntry& entry) {
@@ -308,7 +281,7 @@ void OpdsBookBrowserActivity::navigateToEntry(const OpdsEntry& entry) {
   statusMessage = "Loading...";
   entries.clear();
   selectorIndex = 0;
-  updateRequired = true;
+  requestUpdate();
 
   fetchFeed(currentPath);
 }
@@ -326,7 +299,7 @@ void OpdsBookBrowserActivity::navigateBack() {
     statusMessage = "Loading...";
     entries.clear();
     selectorIndex = 0;
-    updateRequired = true;
+    requestUpdate();
 
     fetchFeed(currentPath);
   }
@@ -337,7 +310,7 @@ void OpdsBookBrowserActivity::downloadBook(const OpdsEntry& book) {
   statusMessage = book.title;
   downloadProgress = 0;
   downloadTotal = 0;
-  updateRequired = true;
+  requestUpdate();
 
   // Build full download URL
   std::string downloadUrl = UrlUtils::buildUrl(SETTINGS.opdsServerUrl, book.href);
@@ -355,7 +328,7 @@ void OpdsBookBrowserActivity::downloadBook(const OpdsEntry& book) {
       HttpDownloader::downloadToFile(downloadUrl, filename, [this](const size_t downloaded, const size_t total) {
         downloadProgress = downloaded;
         downloadTotal = total;
-        updateRequired = true;
+        requestUpdate(RenderService::Priority::Background);
       });
 
   if (result == HttpDownloader::OK) {
@@ -367,11 +340,11 @@ void OpdsBookBrowserActivity::downloadBook(const OpdsEntry& book) {
     Serial.printf("[%lu] [OPDS] Cleared cache for: %s\n", millis(), filename.c_str());
 
     state = BrowserState::BROWSING;
-    updateRequired = true;
+    requestUpdate();
   } else {
     state = BrowserState::ERROR;
     errorMessage = "Download failed";
-    updateRequired = true;
+    requestUpdate();
   }
 }
 
@@ -380,7 +353,7 @@ void OpdsBookBrowserActivity::checkAndConnectWifi() {
   if (WiFi.status() == WL_CONNECTED && WiFi.localIP() != IPAddress(0, 0, 0, 0)) {
     state = BrowserState::LOADING;
     statusMessage = "Loading...";
-    updateRequired = true;
+    requestUpdate();
     fetchFeed(currentPath);
     return;
   }
@@ -391,7 +364,7 @@ void OpdsBookBrowserActivity::checkAndConnectWifi() {
 
 void OpdsBookBrowserActivity::launchWifiSelection() {
   state = BrowserState::WIFI_SELECTION;
-  updateRequired = true;
+  requestUpdate();
 
   enterNewActivity(new WifiSelectionActivity(renderer, mappedInput,
                                              [this](const bool connected) { onWifiSelectionComplete(connected); }));
@@ -404,7 +377,7 @@ void OpdsBookBrowserActivity::onWifiSelectionComplete(const bool connected) {
     Serial.printf("[%lu] [OPDS] WiFi connected via selection, fetching feed\n", millis());
     state = BrowserState::LOADING;
     statusMessage = "Loading...";
-    updateRequired = true;
+    requestUpdate();
     fetchFeed(currentPath);
   } else {
     Serial.printf("[%lu] [OPDS] WiFi selection cancelled/failed\n", millis());
@@ -414,6 +387,6 @@ void OpdsBookBrowserActivity::onWifiSelectionComplete(const bool connected) {
     WiFi.mode(WIFI_OFF);
     state = BrowserState::ERROR;
     errorMessage = "WiFi connection failed";
-    updateRequired = true;
+    requestUpdate();
   }
 }
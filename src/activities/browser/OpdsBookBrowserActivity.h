@@ -1,8 +1,5 @@
 #pragma once
 #include <OpdsParser.h>
-#include <freertos/FreeRTOS.h>
-#include <freertos/semphr.h>
-#include <freertos/task.h>
 
 #include <functional>
 #include <string>
@@ -35,10 +32,6 @@ class OpdsBookBrowserActivity final : public ActivityWithSubactivity {
   void loop() override;
 
  private:
-  TaskHandle_t displayTaskHandle = nullptr;
-  SemaphoreHandle_t renderingMutex = nullptr;
-  bool updateRequired = false;
-
   BrowserState state = BrowserState::LOADING;
   std::vector<OpdsEntry> entries;
   std::vector<std::string> navigationHistory;  // Stack of previous feed paths for back navigation
@@ -51,9 +44,7 @@ class OpdsBookBrowserActivity final : public ActivityWithSubactivity {
 
   const std::function<void()> onGoHome;
 
-  static void taskTrampoline(void* param);
-  [[noreturn]] void displayTaskLoop();
-  void render() const;
+  void render() override;
 
   void checkAndConnectWifi();
   void launchWifiSelection();
@@ -2,6 +2,7 @@
 
 #include <GfxRenderer.h>
 
+#include "../../MappedInputManager.h"
 #include "../../ScreenComponents.h"
 #include "../../fontIds.h"
 
@@ -3,6 +3,7 @@
 #include <Arduino.h>
 #include <GfxRenderer.h>
 
+#include "../../MappedInputManager.h"
 #include "../../ScreenComponents.h"
 #include "../../fontIds.h"
 
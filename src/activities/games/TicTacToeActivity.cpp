@@ -4,6 +4,7 @@
 
 #include <algorithm>
 
+#include "../../MappedInputManager.h"
 #include "../../ScreenComponents.h"
 #include "../../fontIds.h"
 
@@ -3,6 +3,7 @@
 #include <Bitmap.h>
 #include <Epub.h>
 #include <GfxRenderer.h>
+#include <PanelImage.h>
 #include <SDCardManager.h>
 #include <Xtc.h>
 
@@ -17,11 +18,6 @@
 #include "fontIds.h"
 #include "util/StringUtils.h"
 
-void HomeActivity::taskTrampoline(void* param) {
-  auto* self = static_cast<HomeActivity*>(param);
-  self->displayTaskLoop();
-}
-
 int HomeActivity::getMenuItemCount() const {
   int count = 4;  // My Library, File transfer, Games, Settings
   if (hasContinueReading) count++;
@@ -32,8 +28,6 @@ int HomeActivity::getMenuItemCount() const {
 void HomeActivity::onEnter() {
   Activity::onEnter();
 
-  renderingMutex = xSemaphoreCreateMutex();
-
   // Check if we have a book to continue reading
   hasContinueReading = !APP_STATE.openEpubPath.empty() && SdMan.exists(APP_STATE.openEpubPath.c_str());
 
@@ -92,28 +86,12 @@ void HomeActivity::onEnter() {
   selectorIndex = 0;
 
   // Trigger first update
-  updateRequired = true;
-
-  xTaskCreate(&HomeActivity::taskTrampoline, "HomeActivityTask",
-              4096,               // Stack size (increased for cover image rendering)
-              this,               // Parameters
-              1,                  // Priority
-              &displayTaskHandle  // Task handle
-  );
+  requestUpdate();
 }
 
 void HomeActivity::onExit() {
   Activity::onExit();
 
-  // Wait until not rendering to delete task to avoid killing mid-instruction to EPD
-  xSemaphoreTake(renderingMutex, portMAX_DELAY);
-  if (displayTaskHandle) {
-    vTaskDelete(displayTaskHandle);
-    displayTaskHandle = nullptr;
-  }
-  vSemaphoreDelete(renderingMutex);
-  renderingMutex = nullptr;
-
   // Free the stored cover buffer if any
   freeCoverBuffer();
 }
@@ -128,6 +106,7 @@ bool HomeActivity::storeCoverBuffer() {
   freeCoverBuffer();
 
   const size_t bufferSize = GfxRenderer::getBufferSize();
+  // Held as long as the home screen is shown, so it stays out of the buffer pool
   coverBuffer = static_cast<uint8_t*>(malloc(bufferSize));
   if (!coverBuffer) {
     return false;
@@ -193,22 +172,10 @@ void HomeActivity::loop() {
     }
   } else if (prevPressed) {
     selectorIndex = (selectorIndex + menuCount - 1) % menuCount;
-    updateRequired = true;
+    requestUpdate();
   } else if (nextPressed) {
     selectorIndex = (selectorIndex + 1) % menuCount;
-    updateRequired = true;
-  }
-}
-
-void HomeActivity::displayTaskLoop() {
-  while (true) {
-    if (updateRequired) {
-      updateRequired = false;
-      xSemaphoreTake(renderingMutex, portMAX_DELAY);
-      render();
-      xSemaphoreGive(renderingMutex);
-    }
-    vTaskDelay(10 / portTICK_PERIOD_MS);
+    requestUpdate();
   }
 }
 
@@ -267,8 +234,21 @@ void HomeActivity::render() {
             coverY = bookY + (bookHeight - bitmap.getHeight()) / 2;
           }
 
-          // Draw the cover image centered within the book card
-          renderer.drawBitmap(bitmap, coverX, coverY, bookWidth, bookHeight);
+          // Draw the cover image centered within the book card, from its panel image once there is one
+          const uint32_t key =
+              PanelImage::makeKey(file, {bookX, bookY, bookWidth, bookHeight, renderer.getOrientation()});
+          const std::string panelImagePath = PanelImage::pathFor(coverBmpPath);
+          PanelImage panelImage;
+          if (!panelImage.open(panelImagePath, key) || !panelImage.drawPlane(renderer, 0)) {
+            panelImage.close();
+            // A plane that broke off halfway leaves the card half drawn, the screen was blank before
+            renderer.clearScreen();
+            renderer.drawBitmap(bitmap, coverX, coverY, bookWidth, bookHeight);
+            if (panelImage.begin(panelImagePath, key, renderer, bookX, bookY, bookWidth, bookHeight) &&
+                panelImage.addPlane(renderer)) {
+              panelImage.finish();
+            }
+          }
 
           // Draw border around the card
           renderer.drawRect(bookX, bookY, bookWidth, bookHeight);
@@ -1,17 +1,11 @@
 #pragma once
-#include <freertos/FreeRTOS.h>
-#include <freertos/semphr.h>
-#include <freertos/task.h>
 
 #include <functional>
 
 #include "../Activity.h"
 
 class HomeActivity final : public Activity {
-  TaskHandle_t displayTaskHandle = nullptr;
-  SemaphoreHandle_t renderingMutex = nullptr;
   int selectorIndex = 0;
-  bool updateRequired = false;
   bool hasContinueReading = false;
   bool hasOpdsUrl = false;
   bool hasCoverImage = false;
@@ -28,9 +22,7 @@ class HomeActivity final : public Activity {
   const std::function<void()> onOpdsBrowserOpen;
   const std::function<void()> onGamesOpen;
 
-  static void taskTrampoline(void* param);
-  [[noreturn]] void displayTaskLoop();
-  void render();
+  void render() override;
   int getMenuItemCount() const;
   bool storeCoverBuffer();    // Store frame buffer for cover image
   bool restoreCoverBuffer();  // Restore frame buffer from stored cover
@@ -8,6 +8,7 @@
 #include "MappedInputManager.h"
 #include "RecentBooksStore.h"
 #include "ScreenComponents.h"
+#include "activities/util/KeyboardEntryActivity.h"
 #include "fontIds.h"
 #include "util/StringUtils.h"
 
@@ -23,6 +24,10 @@ constexpr int RIGHT_MARGIN = 40;  // Extra space for scroll indicator
 // Timing thresholds
 constexpr int SKIP_PAGE_MS = 700;
 constexpr unsigned long GO_HOME_MS = 1000;
+constexpr unsigned long SEARCH_MS = 1000;
+// Time the index refresh and the cover job get per loop, input is still handled in between
+constexpr unsigned long REFRESH_SLICE_MS = 20;
+constexpr size_t MAX_SEARCH_LENGTH = 32;
 
 void sortFileList(std::vector<std::string>& strs) {
   std::sort(begin(strs), end(strs), [](const std::string& str1, const std::string& str2) {
@@ -39,7 +44,7 @@ int MyLibraryActivity::getPageItems() const {
   const int screenHeight = renderer.getScreenHeight();
   const int bottomBarHeight = 60;  // Space for button hints
   const int availableHeight = screenHeight - CONTENT_START_Y - bottomBarHeight;
-  int items = availableHeight / LINE_HEIGHT;
+  int items = availableHeight / (isIndexTab(currentTab) ? RECENTS_LINE_HEIGHT : LINE_HEIGHT);
   if (items < 1) {
     items = 1;
   }
@@ -50,6 +55,9 @@ int MyLibraryActivity::getCurrentItemCount() const {
   if (currentTab == Tab::Recent) {
     return static_cast<int>(recentBooks.size());
   }
+  if (isIndexTab(currentTab)) {
+    return indexRange.count;
+  }
   return static_cast<int>(files.size());
 }
 
@@ -121,48 +129,121 @@ size_t MyLibraryActivity::findEntry(const std::string& name) const {
   return 0;
 }
 
-void MyLibraryActivity::taskTrampoline(void* param) {
-  auto* self = static_cast<MyLibraryActivity*>(param);
-  self->displayTaskLoop();
+LibraryIndex::View MyLibraryActivity::indexView() const {
+  switch (currentTab) {
+    case Tab::Authors:
+      return LibraryIndex::View::Author;
+    case Tab::Newest:
+      return LibraryIndex::View::Newest;
+    default:
+      return LibraryIndex::View::Title;
+  }
+}
+
+void MyLibraryActivity::resetIndexRange() {
+  // Looked up before taking the lock, the search reads the index from the card
+  const LibraryIndex::Range range =
+      searchPrefix.empty() ? LibraryIndex::Range{0, LIBRARY_INDEX.size()}
+                           : LIBRARY_INDEX.findPrefix(indexView(), searchPrefix);
+  RENDER_SERVICE.lock();
+  indexRange = range;
+  if (selectorIndex >= indexRange.count) {
+    selectorIndex = indexRange.count > 0 ? indexRange.count - 1 : 0;
+  }
+  indexEntriesStart = -1;
+  RENDER_SERVICE.unlock();
+}
+
+void MyLibraryActivity::loadIndexPage() {
+  const int pageItems = getPageItems();
+  const int start = selectorIndex / pageItems * pageItems;
+  if (start == indexEntriesStart) {
+    return;
+  }
+
+  std::vector<LibraryIndex::Entry> entries;
+  LIBRARY_INDEX.readEntries(indexView(), indexRange.first + start, std::min(pageItems, indexRange.count - start),
+                            entries);
+  RENDER_SERVICE.lock();
+  indexEntries = std::move(entries);
+  indexEntriesStart = start;
+  RENDER_SERVICE.unlock();
+}
+
+void MyLibraryActivity::selectionChanged() {
+  if (isIndexTab(currentTab)) {
+    loadIndexPage();
+  }
+  requestUpdate();
+}
+
+void MyLibraryActivity::startSearch() {
+  enterNewActivity(new KeyboardEntryActivity(
+      renderer, mappedInput, currentTab == Tab::Authors ? "Search authors" : "Search titles", searchPrefix, 10,
+      MAX_SEARCH_LENGTH, false,
+      [this](const std::string& text) {
+        searchPrefix = text;
+        selectorIndex = 0;
+        resetIndexRange();
+        loadIndexPage();
+        waitForRelease = true;
+        exitActivity();
+      },
+      [this] {
+        waitForRelease = true;
+        exitActivity();
+      }));
 }
 
 void MyLibraryActivity::onEnter() {
   Activity::onEnter();
 
-  renderingMutex = xSemaphoreCreateMutex();
-
   // Load data for both tabs
   loadRecentBooks();
   loadFiles();
 
+  // The index from last time is shown right away, the refresh picks up books added since
+  LIBRARY_INDEX.open();
+  LIBRARY_INDEX.beginRefresh();
+
   selectorIndex = 0;
-  updateRequired = true;
-
-  xTaskCreate(&MyLibraryActivity::taskTrampoline, "MyLibraryActivityTask",
-              4096,               // Stack size (increased for epub metadata loading)
-              this,               // Parameters
-              1,                  // Priority
-              &displayTaskHandle  // Task handle
-  );
+  resetIndexRange();
+  selectionChanged();
 }
 
 void MyLibraryActivity::onExit() {
-  Activity::onExit();
-
-  // Wait until not rendering to delete task to avoid killing mid-instruction to
-  // EPD
-  xSemaphoreTake(renderingMutex, portMAX_DELAY);
-  if (displayTaskHandle) {
-    vTaskDelete(displayTaskHandle);
-    displayTaskHandle = nullptr;
-  }
-  vSemaphoreDelete(renderingMutex);
-  renderingMutex = nullptr;
+  ActivityWithSubactivity::onExit();
 
+  LIBRARY_INDEX.cancelRefresh();
+  LIBRARY_INDEX.cancelCovers();
   files.clear();
+  indexEntries.clear();
 }
 
 void MyLibraryActivity::loop() {
+  if (subActivity) {
+    subActivity->loop();
+    return;
+  }
+
+  // The keyboard acts on presses, the release of the key that closed it is not ours
+  if (waitForRelease) {
+    waitForRelease = mappedInput.isPressed(MappedInputManager::Button::Confirm) ||
+                     mappedInput.isPressed(MappedInputManager::Button::Back);
+    return;
+  }
+
+  if (LIBRARY_INDEX.isRefreshing() && LIBRARY_INDEX.refreshStep(REFRESH_SLICE_MS)) {
+    resetIndexRange();
+    if (isIndexTab(currentTab)) {
+      loadIndexPage();
+      requestUpdate(RenderService::Priority::Background);
+    }
+    LIBRARY_INDEX.beginCovers();
+  } else if (LIBRARY_INDEX.isGeneratingCovers()) {
+    LIBRARY_INDEX.coverStep(REFRESH_SLICE_MS);
+  }
+
   const int itemCount = getCurrentItemCount();
   const int pageItems = getPageItems();
 
@@ -173,7 +254,7 @@ void MyLibraryActivity::loop() {
       basepath = "/";
       loadFiles();
       selectorIndex = 0;
-      updateRequired = true;
+      requestUpdate();
     }
     return;
   }
@@ -187,7 +268,15 @@ void MyLibraryActivity::loop() {
 
   // Confirm button - open selected item
   if (mappedInput.wasReleased(MappedInputManager::Button::Confirm)) {
-    if (currentTab == Tab::Recent) {
+    if (isIndexTab(currentTab)) {
+      if (currentTab != Tab::Newest && mappedInput.getHeldTime() >= SEARCH_MS) {
+        startSearch();
+      } else if (indexEntriesStart >= 0 && selectorIndex - indexEntriesStart < static_cast<int>(indexEntries.size())) {
+        // Copied, opening the book tears this activity down
+        const std::string path = indexEntries[selectorIndex - indexEntriesStart].path;
+        onSelectBook(path, currentTab);
+      }
+    } else if (currentTab == Tab::Recent) {
       if (!recentBooks.empty() && selectorIndex < static_cast<int>(recentBooks.size())) {
         onSelectBook(recentBooks[selectorIndex].path, currentTab);
       }
@@ -200,7 +289,7 @@ void MyLibraryActivity::loop() {
           basepath += files[selectorIndex].substr(0, files[selectorIndex].length() - 1);
           loadFiles();
           selectorIndex = 0;
-          updateRequired = true;
+          selectionChanged();
         } else {
           // Open file
           onSelectBook(basepath + files[selectorIndex], currentTab);
@@ -225,7 +314,13 @@ void MyLibraryActivity::loop() {
         const std::string dirName = oldPath.substr(pos + 1) + "/";
         selectorIndex = static_cast<int>(findEntry(dirName));
 
-        updateRequired = true;
+        selectionChanged();
+      } else if (isIndexTab(currentTab) && !searchPrefix.empty()) {
+        // Back clears the search first
+        searchPrefix.clear();
+        selectorIndex = 0;
+        resetIndexRange();
+        selectionChanged();
       } else {
         // Go home
         onGoHome();
@@ -235,16 +330,12 @@ void MyLibraryActivity::loop() {
   }
 
   // Tab switching: Left/Right always control tabs
-  if (leftReleased && currentTab == Tab::Files) {
-    currentTab = Tab::Recent;
-    selectorIndex = 0;
-    updateRequired = true;
-    return;
-  }
-  if (rightReleased && currentTab == Tab::Recent) {
-    currentTab = Tab::Files;
+  if ((leftReleased && currentTab != Tab::Recent) || (rightReleased && currentTab != Tab::Newest)) {
+    currentTab = static_cast<Tab>(static_cast<int>(currentTab) + (leftReleased ? -1 : 1));
     selectorIndex = 0;
-    updateRequired = true;
+    searchPrefix.clear();
+    resetIndexRange();
+    selectionChanged();
     return;
   }
 
@@ -258,39 +349,37 @@ void MyLibraryActivity::loop() {
     } else {
       selectorIndex = (selectorIndex + itemCount - 1) % itemCount;
     }
-    updateRequired = true;
+    selectionChanged();
   } else if (nextReleased && itemCount > 0) {
     if (skipPage) {
       selectorIndex = ((selectorIndex / pageItems + 1) * pageItems) % itemCount;
     } else {
       selectorIndex = (selectorIndex + 1) % itemCount;
     }
-    updateRequired = true;
-  }
-}
-
-void MyLibraryActivity::displayTaskLoop() {
-  while (true) {
-    if (updateRequired) {
-      updateRequired = false;
-      xSemaphoreTake(renderingMutex, portMAX_DELAY);
-      render();
-      xSemaphoreGive(renderingMutex);
-    }
-    vTaskDelay(10 / portTICK_PERIOD_MS);
+    selectionChanged();
   }
 }
 
-void MyLibraryActivity::render() const {
+void MyLibraryActivity::render() {
   renderer.clearScreen();
 
-  // Draw tab bar
-  std::vector<TabInfo> tabs = {{"Recent", currentTab == Tab::Recent}, {"Files", currentTab == Tab::Files}};
+  // Draw tab bar, a search shows in place of the searched tab's name
+  const std::string searchLabel = "\"" + searchPrefix + "\"";
+  const auto indexLabel = [&](const Tab tab, const char* label) {
+    return currentTab == tab && !searchPrefix.empty() ? searchLabel.c_str() : label;
+  };
+  std::vector<TabInfo> tabs = {{"Recent", currentTab == Tab::Recent},
+                               {"Files", currentTab == Tab::Files},
+                               {indexLabel(Tab::Titles, "Titles"), currentTab == Tab::Titles},
+                               {indexLabel(Tab::Authors, "Authors"), currentTab == Tab::Authors},
+                               {"Newest", currentTab == Tab::Newest}};
   ScreenComponents::drawTabBar(renderer, TAB_BAR_Y, tabs);
 
   // Draw content based on current tab
   if (currentTab == Tab::Recent) {
     renderRecentTab();
+  } else if (isIndexTab(currentTab)) {
+    renderIndexTab();
   } else {
     renderFilesTab();
   }
@@ -305,7 +394,8 @@ void MyLibraryActivity::render() const {
   renderer.drawSideButtonHints(UI_10_FONT_ID, ">", "<");
 
   // Draw bottom button hints
-  const auto labels = mappedInput.mapLabels("« Back", "Open", "<", ">");
+  const bool searchable = currentTab == Tab::Titles || currentTab == Tab::Authors;
+  const auto labels = mappedInput.mapLabels("« Back", searchable ? "Open/Find" : "Open", "<", ">");
   renderer.drawButtonHints(UI_10_FONT_ID, labels.btn1, labels.btn2, labels.btn3, labels.btn4);
 
   renderer.displayBuffer();
@@ -381,3 +471,48 @@ void MyLibraryActivity::renderFilesTab() const {
                       i != selectorIndex);
   }
 }
+
+void MyLibraryActivity::renderIndexTab() const {
+  const auto pageWidth = renderer.getScreenWidth();
+  const int pageItems = getPageItems();
+
+  if (indexRange.count == 0) {
+    const char* message = !searchPrefix.empty()            ? "No matching books"
+                          : LIBRARY_INDEX.isRefreshing() ? "Indexing books..."
+                                                         : "No books found";
+    renderer.drawText(UI_10_FONT_ID, LEFT_MARGIN, CONTENT_START_Y, message);
+    return;
+  }
+  if (indexEntriesStart < 0) {
+    return;
+  }
+
+  // Draw selection highlight
+  renderer.fillRect(0, CONTENT_START_Y + (selectorIndex % pageItems) * RECENTS_LINE_HEIGHT - 2,
+                    pageWidth - RIGHT_MARGIN, RECENTS_LINE_HEIGHT);
+
+  // Draw items
+  for (int i = 0; i < static_cast<int>(indexEntries.size()); i++) {
+    const auto& book = indexEntries[i];
+    const int index = indexEntriesStart + i;
+    const int y = CONTENT_START_Y + (index % pageItems) * RECENTS_LINE_HEIGHT;
+
+    // Line 1: Title
+    auto truncatedTitle =
+        renderer.truncatedText(UI_12_FONT_ID, book.title.c_str(), pageWidth - LEFT_MARGIN - RIGHT_MARGIN);
+    renderer.drawText(UI_12_FONT_ID, LEFT_MARGIN, y + 2, truncatedTitle.c_str(), index != selectorIndex);
+
+    // Line 2: Author and how far the book was read
+    std::string details = book.author;
+    if (book.progress != LibraryIndex::NO_PROGRESS) {
+      char progress[16];
+      snprintf(progress, sizeof(progress), "%s%u%%", details.empty() ? "" : "  ", book.progress);
+      details += progress;
+    }
+    if (!details.empty()) {
+      auto truncatedDetails =
+          renderer.truncatedText(UI_10_FONT_ID, details.c_str(), pageWidth - LEFT_MARGIN - RIGHT_MARGIN);
+      renderer.drawText(UI_10_FONT_ID, LEFT_MARGIN, y + 32, truncatedDetails.c_str(), index != selectorIndex);
+    }
+  }
+}
@@ -1,26 +1,21 @@
 #pragma once
-#include <freertos/FreeRTOS.h>
-#include <freertos/semphr.h>
-#include <freertos/task.h>
 
 #include <functional>
 #include <string>
 #include <vector>
 
-#include "../Activity.h"
+#include "../ActivityWithSubactivity.h"
+#include "LibraryIndex.h"
 #include "RecentBooksStore.h"
 
-class MyLibraryActivity final : public Activity {
+class MyLibraryActivity final : public ActivityWithSubactivity {
  public:
-  enum class Tab { Recent, Files };
+  // Titles, Authors and Newest list every book on the card from the library index
+  enum class Tab { Recent, Files, Titles, Authors, Newest };
 
  private:
-  TaskHandle_t displayTaskHandle = nullptr;
-  SemaphoreHandle_t renderingMutex = nullptr;
-
   Tab currentTab = Tab::Recent;
   int selectorIndex = 0;
-  bool updateRequired = false;
 
   // Recent tab state
   std::vector<RecentBook> recentBooks;
@@ -29,6 +24,13 @@ class MyLibraryActivity final : public Activity {
   std::string basepath = "/";
   std::vector<std::string> files;
 
+  // Index tabs state: the part of the view shown, narrowed by a search, and the entries of the page on screen
+  LibraryIndex::Range indexRange = {0, 0};
+  std::string searchPrefix;
+  std::vector<LibraryIndex::Entry> indexEntries;
+  int indexEntriesStart = -1;
+  bool waitForRelease = false;
+
   // Callbacks
   const std::function<void()> onGoHome;
   const std::function<void(const std::string& path, Tab fromTab)> onSelectBook;
@@ -43,20 +45,26 @@ class MyLibraryActivity final : public Activity {
   void loadRecentBooks();
   void loadFiles();
   size_t findEntry(const std::string& name) const;
+  static bool isIndexTab(Tab tab) { return tab == Tab::Titles || tab == Tab::Authors || tab == Tab::Newest; }
+  LibraryIndex::View indexView() const;
+  void resetIndexRange();
+  void loadIndexPage();
+  // Reads the page of the selection when it moved to another one, then queues a frame
+  void selectionChanged();
+  void startSearch();
 
   // Rendering
-  static void taskTrampoline(void* param);
-  [[noreturn]] void displayTaskLoop();
-  void render() const;
+  void render() override;
   void renderRecentTab() const;
   void renderFilesTab() const;
+  void renderIndexTab() const;
 
  public:
   explicit MyLibraryActivity(GfxRenderer& renderer, MappedInputManager& mappedInput,
                              const std::function<void()>& onGoHome,
                              const std::function<void(const std::string& path, Tab fromTab)>& onSelectBook,
                              Tab initialTab = Tab::Recent, std::string initialPath = "/")
-      : Activity("MyLibrary", renderer, mappedInput),
+      : ActivityWithSubactivity("MyLibrary", renderer, mappedInput),
         currentTab(initialTab),
         basepath(initialPath.empty() ? "/" : std::move(initialPath)),
         onGoHome(onGoHome),
@@ -64,4 +72,6 @@ class MyLibraryActivity final : public Activity {
   void onEnter() override;
   void onExit() override;
   void loop() override;
+  // Keeps the loop running without its delay while the index is refreshed
+  bool skipLoopDelay() override { return LIBRARY_INDEX.isRefreshing() || LIBRARY_INDEX.isGeneratingCovers(); }
 };
@@ -3,13 +3,17 @@
 #include <Epub/Page.h>
 #include <FsHelpers.h>
 #include <GfxRenderer.h>
+#include <Logging.h>
+#include <Perf.h>
 #include <SDCardManager.h>
 
 #include "CrossPointSettings.h"
 #include "CrossPointState.h"
 #include "EpubReaderChapterSelectionActivity.h"
+#include "LibraryIndex.h"
 #include "MappedInputManager.h"
 #include "RecentBooksStore.h"
+#include "ResumeSnapshot.h"
 #include "ScreenComponents.h"
 #include "fontIds.h"
 
@@ -17,16 +21,18 @@ namespace {
 // pagesPerRefresh now comes from SETTINGS.getRefreshFrequency()
 constexpr unsigned long skipChapterMs = 700;
 constexpr unsigned long goHomeMs = 1000;
-constexpr int statusBarMargin = 19;
-constexpr int progressBarMarginTop = 1;
+// A page turn this soon after the previous one is drawn as a skim frame
+constexpr unsigned long skimTriggerMs = 400;
+// Holding a page button this long starts repeating page turns, when long press doesn't skip chapters
+constexpr unsigned long skimHoldMs = 500;
+constexpr unsigned long skimRepeatMs = 150;
+// Idle time after skimming before the page is drawn again at full quality
+constexpr unsigned long skimSettleMs = 700;
+// Idle time after the last page turn before the bake job gets the render task
+constexpr unsigned long bakeIdleMs = 5000;
 
 }  // namespace
 
-void EpubReaderActivity::taskTrampoline(void* param) {
-  auto* self = static_cast<EpubReaderActivity*>(param);
-  self->displayTaskLoop();
-}
-
 void EpubReaderActivity::onEnter() {
   ActivityWithSubactivity::onEnter();
 
@@ -52,10 +58,18 @@ void EpubReaderActivity::onEnter() {
       break;
   }
 
-  renderingMutex = xSemaphoreCreateMutex();
-
   epub->setupCacheDir();
 
+  const EpubPageLayout layout = EpubPageLayout::current(renderer);
+  baked = BakedEpub::open(*epub, layout);
+  if (!baked && SETTINGS.bakeBooks) {
+    bakeJob.reset(new EpubBakeJob(epub, renderer, layout));
+    if (!bakeJob->begin()) {
+      bakeJob.reset();
+    }
+    baking = bakeJob != nullptr;
+  }
+
   FsFile f;
   if (SdMan.openFileForRead("ERS", epub->getCachePath() + "/progress.bin", f)) {
     uint8_t data[6];
@@ -64,7 +78,7 @@ void EpubReaderActivity::onEnter() {
       currentSpineIndex = data[0] + (data[1] << 8);
       nextPageNumber = data[2] + (data[3] << 8);
       cachedSpineIndex = currentSpineIndex;
-      Serial.printf("[%lu] [ERS] Loaded cache: %d, %d\n", millis(), currentSpineIndex, nextPageNumber);
+      LOG_I(ERS, "Loaded cache: %d, %d", currentSpineIndex, nextPageNumber);
     }
     if (dataSize == 6) {
       cachedChapterTotalPageCount = data[4] + (data[5] << 8);
@@ -77,8 +91,7 @@ void EpubReaderActivity::onEnter() {
     int textSpineIndex = epub->getSpineIndexForTextReference();
     if (textSpineIndex != 0) {
       currentSpineIndex = textSpineIndex;
-      Serial.printf("[%lu] [ERS] Opened for first time, navigating to text reference at index %d\n", millis(),
-                    textSpineIndex);
+      LOG_I(ERS, "Opened for first time, navigating to text reference at index %d", textSpineIndex);
     }
   }
 
@@ -88,35 +101,65 @@ void EpubReaderActivity::onEnter() {
   RECENT_BOOKS.addBook(epub->getPath(), epub->getTitle(), epub->getAuthor());
 
   // Trigger first update
-  updateRequired = true;
-
-  xTaskCreate(&EpubReaderActivity::taskTrampoline, "EpubReaderActivityTask",
-              8192,               // Stack size
-              this,               // Parameters
-              1,                  // Priority
-              &displayTaskHandle  // Task handle
-  );
+  requestUpdate();
 }
 
 void EpubReaderActivity::onExit() {
   ActivityWithSubactivity::onExit();
 
+  if (epub && section && section->pageCount > 0) {
+    const float chapterProgress = static_cast<float>(section->currentPage) / section->pageCount;
+    const float bookProgress = epub->calculateProgress(currentSpineIndex, chapterProgress) * 100;
+    LIBRARY_INDEX.updateProgress(epub->getPath(), static_cast<uint8_t>(bookProgress));
+  }
+
   // Reset orientation back to portrait for the rest of the UI
   renderer.setOrientation(GfxRenderer::Orientation::Portrait);
-
-  // Wait until not rendering to delete task to avoid killing mid-instruction to EPD
-  xSemaphoreTake(renderingMutex, portMAX_DELAY);
-  if (displayTaskHandle) {
-    vTaskDelete(displayTaskHandle);
-    displayTaskHandle = nullptr;
-  }
-  vSemaphoreDelete(renderingMutex);
-  renderingMutex = nullptr;
+  baking = false;
+  bakeJob.reset();
+  baked.reset();
   section.reset();
   epub.reset();
 }
 
+void EpubReaderActivity::onSleep() {
+  // The chapter list covers the page, nothing worth restoring
+  if (subActivity) {
+    return;
+  }
+
+  RENDER_SERVICE.lock();
+  // Only a page that was drawn completely, not a chapter being indexed or the end of the book screen
+  if (epub && section && pendingPageTurns == 0 && section->currentPage >= 0 &&
+      section->currentPage < section->pageCount) {
+    bool saved = true;
+    if (frameBufferStale || skimFrameShown) {
+      // A bake step drew over it, or it holds a skim frame that is shown again right after waking up: the full
+      // quality BW frame of the page on screen is drawn instead
+      const EpubPageLayout layout = EpubPageLayout::current(renderer);
+      const bool fromBaked = baked && baked->hasPage(currentSpineIndex, section->currentPage, section->pageCount);
+      const auto page = fromBaked ? nullptr : section->loadPageFromSectionFile();
+      bool grays;
+      renderer.clearScreen();
+      saved = (fromBaked || page) && drawPagePass(page.get(), GfxRenderer::BW, layout, grays);
+      if (saved) {
+        renderStatusBar(layout.marginRight, layout.marginBottom, layout.marginLeft);
+        frameBufferStale = false;
+      }
+    }
+    if (saved) {
+      RESUME_SNAPSHOT.save(renderer.getFrameBuffer(), epub->getPath(), currentSpineIndex, section->currentPage);
+    }
+  }
+  RENDER_SERVICE.unlock();
+}
+
 void EpubReaderActivity::loop() {
+  // A bake step running on the render task stops at its next check
+  if (mappedInput.wasAnyPressed()) {
+    buttonPresses++;
+  }
+
   // Pass input responsibility to sub activity if exists
   if (subActivity) {
     subActivity->loop();
@@ -126,16 +169,14 @@ void EpubReaderActivity::loop() {
   // Enter chapter selection activity
   if (mappedInput.wasReleased(MappedInputManager::Button::Confirm)) {
     // Don't start activity transition while rendering
-    xSemaphoreTake(renderingMutex, portMAX_DELAY);
+    RENDER_SERVICE.lock();
+    pageOnScreen = false;
     const int currentPage = section ? section->currentPage : 0;
     const int totalPages = section ? section->pageCount : 0;
     exitActivity();
     enterNewActivity(new EpubReaderChapterSelectionActivity(
         this->renderer, this->mappedInput, epub, epub->getPath(), currentSpineIndex, currentPage, totalPages,
-        [this] {
-          exitActivity();
-          updateRequired = true;
-        },
+        [this] { exitActivity(); },
         [this](const int newSpineIndex) {
           if (currentSpineIndex != newSpineIndex) {
             currentSpineIndex = newSpineIndex;
@@ -143,7 +184,6 @@ void EpubReaderActivity::loop() {
             section.reset();
           }
           exitActivity();
-          updateRequired = true;
         },
         [this](const int newSpineIndex, const int newPage) {
           // Handle sync position
@@ -153,9 +193,8 @@ void EpubReaderActivity::loop() {
             section.reset();
           }
           exitActivity();
-          updateRequired = true;
         }));
-    xSemaphoreGive(renderingMutex);
+    RENDER_SERVICE.unlock();
   }
 
   // Long press BACK (1s+) goes directly to home
@@ -185,81 +224,121 @@ void EpubReaderActivity::loop() {
                                     mappedInput.wasReleased(MappedInputManager::Button::Right));
 
   if (!prevTriggered && !nextTriggered) {
-    return;
-  }
+    const bool forwardHeld = mappedInput.isPressed(MappedInputManager::Button::PageForward) ||
+                             mappedInput.isPressed(MappedInputManager::Button::Right);
+    const bool backHeld = mappedInput.isPressed(MappedInputManager::Button::PageBack) ||
+                          mappedInput.isPressed(MappedInputManager::Button::Left);
+    if (usePressForPageTurn && (forwardHeld || backHeld) && mappedInput.getHeldTime() >= skimHoldMs) {
+      if (millis() - lastPageTurnMs >= skimRepeatMs) {
+        queuePageTurn(forwardHeld ? 1 : -1, true);
+      }
+      return;
+    }
 
-  // any botton press when at end of the book goes back to the last page
-  if (currentSpineIndex > 0 && currentSpineIndex >= epub->getSpineItemsCount()) {
-    currentSpineIndex = epub->getSpineItemsCount() - 1;
-    nextPageNumber = UINT16_MAX;
-    updateRequired = true;
+    if (skimFrameShown && !forwardHeld && !backHeld && millis() - lastPageTurnMs >= skimSettleMs) {
+      skimFrameShown = false;
+      requestUpdate(RenderService::Priority::Background);
+    }
+
+    if (baking && pageOnScreen && !bakeStepRequested && millis() - lastPageTurnMs >= bakeIdleMs) {
+      bakeStepPresses = buttonPresses.load();
+      bakeStepRequested = true;
+      requestUpdate(RenderService::Priority::Background);
+    }
     return;
   }
 
   const bool skipChapter = SETTINGS.longPressChapterSkip && mappedInput.getHeldTime() > skipChapterMs;
 
   if (skipChapter) {
+#if CROSSPOINT_PERF
+    pageTurnStartUs = micros();
+#endif
     // We don't want to delete the section mid-render, so grab the semaphore
-    xSemaphoreTake(renderingMutex, portMAX_DELAY);
+    RENDER_SERVICE.lock();
+    pageOnScreen = false;
+    pendingPageTurns = 0;
     nextPageNumber = 0;
     currentSpineIndex = nextTriggered ? currentSpineIndex + 1 : currentSpineIndex - 1;
     section.reset();
-    xSemaphoreGive(renderingMutex);
-    updateRequired = true;
+    RENDER_SERVICE.unlock();
+    requestUpdate();
     return;
   }
 
-  // No current section, attempt to rerender the book
-  if (!section) {
-    updateRequired = true;
+  queuePageTurn(nextTriggered ? 1 : -1, false);
+}
+
+void EpubReaderActivity::queuePageTurn(const int direction, bool skim) {
+  const unsigned long now = millis();
+  skim = skim || now - lastPageTurnMs < skimTriggerMs;
+  lastPageTurnMs = now;
+  pageOnScreen = false;
+
+#if CROSSPOINT_PERF
+  // Measured from the first of the turns the frame covers
+  unsigned long noTurnPending = 0;
+  pageTurnStartUs.compare_exchange_strong(noTurnPending, micros());
+#endif
+  pendingPageTurns += direction;
+  if (skim) {
+    skimRequested = true;
+  }
+  requestUpdate();
+}
+
+void EpubReaderActivity::applyPageTurns(const int turns) {
+  // any botton press when at end of the book goes back to the last page
+  if (currentSpineIndex > 0 && currentSpineIndex >= epub->getSpineItemsCount()) {
+    currentSpineIndex = epub->getSpineItemsCount() - 1;
+    nextPageNumber = UINT16_MAX;
+    section.reset();
     return;
   }
 
-  if (prevTriggered) {
-    if (section->currentPage > 0) {
-      section->currentPage--;
-    } else {
-      // We don't want to delete the section mid-render, so grab the semaphore
-      xSemaphoreTake(renderingMutex, portMAX_DELAY);
-      nextPageNumber = UINT16_MAX;
-      currentSpineIndex--;
-      section.reset();
-      xSemaphoreGive(renderingMutex);
-    }
-    updateRequired = true;
-  } else {
-    if (section->currentPage < section->pageCount - 1) {
-      section->currentPage++;
-    } else {
-      // We don't want to delete the section mid-render, so grab the semaphore
-      xSemaphoreTake(renderingMutex, portMAX_DELAY);
-      nextPageNumber = 0;
-      currentSpineIndex++;
-      section.reset();
-      xSemaphoreGive(renderingMutex);
-    }
-    updateRequired = true;
+  // No current section, it is loaded at the page it was opened on
+  if (!section) {
+    return;
   }
-}
 
-void EpubReaderActivity::displayTaskLoop() {
-  while (true) {
-    if (updateRequired) {
-      updateRequired = false;
-      xSemaphoreTake(renderingMutex, portMAX_DELAY);
-      renderScreen();
-      xSemaphoreGive(renderingMutex);
-    }
-    vTaskDelay(10 / portTICK_PERIOD_MS);
+  // Turns past either end of the chapter stop at the first or last page of the neighbouring one
+  const int targetPage = section->currentPage + turns;
+  if (targetPage < 0) {
+    nextPageNumber = UINT16_MAX;
+    currentSpineIndex--;
+    section.reset();
+  } else if (targetPage >= section->pageCount) {
+    nextPageNumber = 0;
+    currentSpineIndex++;
+    section.reset();
+  } else {
+    section->currentPage = targetPage;
   }
 }
 
 // TODO: Failure handling
-void EpubReaderActivity::renderScreen() {
+void EpubReaderActivity::render() {
   if (!epub) {
     return;
   }
 
+  if (bakeStepRequested.exchange(false)) {
+    // Asked for before the chapter list opened, it covers the page
+    if (subActivity) {
+      return;
+    }
+    if (pageOnScreen && bakeJob) {
+      runBakeStep();
+      return;
+    }
+  }
+
+  const int turns = pendingPageTurns.exchange(0);
+  if (turns != 0) {
+    applyPageTurns(turns);
+  }
+  const bool skim = skimRequested.exchange(false);
+
   // edge case handling for sub-zero spine index
   if (currentSpineIndex < 0) {
     currentSpineIndex = 0;
@@ -277,36 +356,17 @@ void EpubReaderActivity::renderScreen() {
     return;
   }
 
-  // Apply screen viewable areas and additional padding
-  int orientedMarginTop, orientedMarginRight, orientedMarginBottom, orientedMarginLeft;
-  renderer.getOrientedViewableTRBL(&orientedMarginTop, &orientedMarginRight, &orientedMarginBottom,
-                                   &orientedMarginLeft);
-  orientedMarginTop += SETTINGS.screenMargin;
-  orientedMarginLeft += SETTINGS.screenMargin;
-  orientedMarginRight += SETTINGS.screenMargin;
-  orientedMarginBottom += SETTINGS.screenMargin;
-
-  // Add status bar margin
-  if (SETTINGS.statusBar != CrossPointSettings::STATUS_BAR_MODE::NONE) {
-    // Add additional margin for status bar if progress bar is shown
-    const bool showProgressBar = SETTINGS.statusBar == CrossPointSettings::STATUS_BAR_MODE::FULL_WITH_PROGRESS_BAR ||
-                                 SETTINGS.statusBar == CrossPointSettings::STATUS_BAR_MODE::ONLY_PROGRESS_BAR;
-    orientedMarginBottom += statusBarMargin - SETTINGS.screenMargin +
-                            (showProgressBar ? (ScreenComponents::BOOK_PROGRESS_BAR_HEIGHT + progressBarMarginTop) : 0);
-  }
+  const EpubPageLayout layout = EpubPageLayout::current(renderer);
 
   if (!section) {
     const auto filepath = epub->getSpineItem(currentSpineIndex).href;
-    Serial.printf("[%lu] [ERS] Loading file: %s, index: %d\n", millis(), filepath.c_str(), currentSpineIndex);
+    LOG_I(ERS, "Loading file: %s, index: %d", filepath.c_str(), currentSpineIndex);
     section = std::unique_ptr<Section>(new Section(epub, currentSpineIndex, renderer));
 
-    const uint16_t viewportWidth = renderer.getScreenWidth() - orientedMarginLeft - orientedMarginRight;
-    const uint16_t viewportHeight = renderer.getScreenHeight() - orientedMarginTop - orientedMarginBottom;
-
-    if (!section->loadSectionFile(SETTINGS.getReaderFontId(), SETTINGS.getReaderLineCompression(),
-                                  SETTINGS.extraParagraphSpacing, SETTINGS.paragraphAlignment, viewportWidth,
-                                  viewportHeight, SETTINGS.hyphenationEnabled)) {
-      Serial.printf("[%lu] [ERS] Cache not found, building...\n", millis());
+    if (!section->loadSectionFile(layout.fontId, layout.lineCompression, layout.extraParagraphSpacing,
+                                  layout.paragraphAlignment, layout.viewportWidth, layout.viewportHeight,
+                                  layout.hyphenationEnabled)) {
+      LOG_I(ERS, "Cache not found, building...");
 
       // Progress bar dimensions
       constexpr int barWidth = 200;
@@ -348,15 +408,15 @@ void EpubReaderActivity::renderScreen() {
         renderer.displayBuffer(HalDisplay::FAST_REFRESH);
       };
 
-      if (!section->createSectionFile(SETTINGS.getReaderFontId(), SETTINGS.getReaderLineCompression(),
-                                      SETTINGS.extraParagraphSpacing, SETTINGS.paragraphAlignment, viewportWidth,
-                                      viewportHeight, SETTINGS.hyphenationEnabled, progressSetup, progressCallback)) {
-        Serial.printf("[%lu] [ERS] Failed to persist page data to SD\n", millis());
+      if (!section->createSectionFile(layout.fontId, layout.lineCompression, layout.extraParagraphSpacing,
+                                      layout.paragraphAlignment, layout.viewportWidth, layout.viewportHeight,
+                                      layout.hyphenationEnabled, progressSetup, progressCallback)) {
+        LOG_E(ERS, "Failed to persist page data to SD");
         section.reset();
         return;
       }
     } else {
-      Serial.printf("[%lu] [ERS] Cache found, skipping build...\n", millis());
+      LOG_I(ERS, "Cache found, skipping build...");
     }
 
     if (nextPageNumber == UINT16_MAX) {
@@ -377,35 +437,52 @@ void EpubReaderActivity::renderScreen() {
     }
   }
 
+  // Right after waking up the page is already on the panel, restored from the sleep snapshot
+  if (RESUME_SNAPSHOT.consumeShownPage(epub->getPath(), currentSpineIndex, section->currentPage)) {
+    LOG_I(ERS, "Page restored from snapshot, skipping first frame");
+    pagesUntilFullRefresh = SETTINGS.getRefreshFrequency();
+    pageOnScreen = true;
+    return;
+  }
+
   renderer.clearScreen();
 
   if (section->pageCount == 0) {
-    Serial.printf("[%lu] [ERS] No pages to render\n", millis());
+    LOG_W(ERS, "No pages to render");
     renderer.drawCenteredText(UI_12_FONT_ID, 300, "Empty chapter", true, EpdFontFamily::BOLD);
-    renderStatusBar(orientedMarginRight, orientedMarginBottom, orientedMarginLeft);
+    renderStatusBar(layout.marginRight, layout.marginBottom, layout.marginLeft);
     renderer.displayBuffer();
     return;
   }
 
   if (section->currentPage < 0 || section->currentPage >= section->pageCount) {
-    Serial.printf("[%lu] [ERS] Page out of bounds: %d (max %d)\n", millis(), section->currentPage, section->pageCount);
+    LOG_W(ERS, "Page out of bounds: %d (max %d)", section->currentPage, section->pageCount);
     renderer.drawCenteredText(UI_12_FONT_ID, 300, "Out of bounds", true, EpdFontFamily::BOLD);
-    renderStatusBar(orientedMarginRight, orientedMarginBottom, orientedMarginLeft);
+    renderStatusBar(layout.marginRight, layout.marginBottom, layout.marginLeft);
     renderer.displayBuffer();
     return;
   }
 
   {
-    auto p = section->loadPageFromSectionFile();
-    if (!p) {
-      Serial.printf("[%lu] [ERS] Failed to load page from SD - clearing section cache\n", millis());
-      section->clearCache();
-      section.reset();
-      return renderScreen();
+    // A baked page is blitted, the section file is only read for the others
+    std::unique_ptr<Page> p;
+    if (!baked || !baked->hasPage(currentSpineIndex, section->currentPage, section->pageCount)) {
+      p = section->loadPageFromSectionFile();
+      if (!p) {
+        LOG_E(ERS, "Failed to load page from SD - clearing section cache");
+        section->clearCache();
+        section.reset();
+        return render();
+      }
     }
     const auto start = millis();
-    renderContents(std::move(p), orientedMarginTop, orientedMarginRight, orientedMarginBottom, orientedMarginLeft);
-    Serial.printf("[%lu] [ERS] Rendered page in %dms\n", millis(), millis() - start);
+    renderContents(std::move(p), layout, skim);
+    LOG_D(ERS, "Rendered page in %lums", millis() - start);
+  }
+
+  // Skim frames are passed over quickly, the full quality pass after them saves the position
+  if (skim) {
+    return;
   }
 
   FsFile f;
@@ -422,11 +499,34 @@ void EpubReaderActivity::renderScreen() {
   }
 }
 
-void EpubReaderActivity::renderContents(std::unique_ptr<Page> page, const int orientedMarginTop,
-                                        const int orientedMarginRight, const int orientedMarginBottom,
-                                        const int orientedMarginLeft) {
-  page->render(renderer, SETTINGS.getReaderFontId(), orientedMarginLeft, orientedMarginTop);
-  renderStatusBar(orientedMarginRight, orientedMarginBottom, orientedMarginLeft);
+void EpubReaderActivity::renderContents(std::unique_ptr<Page> page, const EpubPageLayout& layout, const bool skim) {
+  bool grays;
+  if (!drawPagePass(page.get(), GfxRenderer::BW, layout, grays)) {
+    // Drawn live from here on
+    baked.reset();
+    page = section->loadPageFromSectionFile();
+    if (!page) {
+      return;
+    }
+    renderer.clearScreen();
+    drawPagePass(page.get(), GfxRenderer::BW, layout, grays);
+  }
+
+  if (skim) {
+    renderSkimStatusBar(layout.marginRight, layout.marginBottom);
+    renderer.displayBuffer(HalDisplay::FAST_REFRESH);
+    // Clears the ghosting fast refreshes leave behind when the page is drawn at full quality
+    pagesUntilFullRefresh = 0;
+    skimFrameShown = true;
+#if CROSSPOINT_PERF
+    if (const unsigned long startUs = pageTurnStartUs.exchange(0)) {
+      PERF_RECORD(PAGE_TURN, micros() - startUs);
+    }
+#endif
+    return;
+  }
+
+  renderStatusBar(layout.marginRight, layout.marginBottom, layout.marginLeft);
   if (pagesUntilFullRefresh <= 1) {
     renderer.displayBuffer(HalDisplay::HALF_REFRESH);
     pagesUntilFullRefresh = SETTINGS.getRefreshFrequency();
@@ -434,31 +534,82 @@ void EpubReaderActivity::renderContents(std::unique_ptr<Page> page, const int or
     renderer.displayBuffer();
     pagesUntilFullRefresh--;
   }
+#if CROSSPOINT_PERF
+  if (const unsigned long startUs = pageTurnStartUs.exchange(0)) {
+    PERF_RECORD(PAGE_TURN, micros() - startUs);
+  }
+#endif
 
   // Save bw buffer to reset buffer state after grayscale data sync
   renderer.storeBwBuffer();
 
   // grayscale rendering
   // TODO: Only do this if font supports it
-  if (SETTINGS.textAntiAliasing) {
-    renderer.clearScreen(0x00);
-    renderer.setRenderMode(GfxRenderer::GRAYSCALE_LSB);
-    page->render(renderer, SETTINGS.getReaderFontId(), orientedMarginLeft, orientedMarginTop);
+  if (grays) {
+    drawPagePass(page.get(), GfxRenderer::GRAYSCALE_LSB, layout, grays);
     renderer.copyGrayscaleLsbBuffers();
 
     // Render and copy to MSB buffer
-    renderer.clearScreen(0x00);
-    renderer.setRenderMode(GfxRenderer::GRAYSCALE_MSB);
-    page->render(renderer, SETTINGS.getReaderFontId(), orientedMarginLeft, orientedMarginTop);
+    drawPagePass(page.get(), GfxRenderer::GRAYSCALE_MSB, layout, grays);
     renderer.copyGrayscaleMsbBuffers();
 
     // display grayscale part
     renderer.displayGrayBuffer();
-    renderer.setRenderMode(GfxRenderer::BW);
   }
 
   // restore the bw data
   renderer.restoreBwBuffer();
+  frameBufferStale = false;
+  pageOnScreen = pendingPageTurns == 0;
+}
+
+bool EpubReaderActivity::drawPagePass(const Page* page, const GfxRenderer::RenderMode mode,
+                                      const EpubPageLayout& layout, bool& grays) {
+  if (!page) {
+    const auto target = mode == GfxRenderer::BW              ? xtc::PageBlitter::Target::Bw
+                        : mode == GfxRenderer::GRAYSCALE_LSB ? xtc::PageBlitter::Target::GrayscaleLsb
+                                                             : xtc::PageBlitter::Target::GrayscaleMsb;
+    return baked->drawPage(currentSpineIndex, section->currentPage, renderer.getFrameBuffer(), target,
+                           mode == GfxRenderer::BW ? &grays : nullptr);
+  }
+
+  if (mode == GfxRenderer::BW) {
+    page->render(renderer, layout.fontId, layout.marginLeft, layout.marginTop);
+    // Images always get their grays, text only with anti-aliasing
+    grays = layout.textAntiAliasing || page->hasImages();
+    return true;
+  }
+
+  renderer.clearScreen(0x00);
+  renderer.setRenderMode(mode);
+  if (layout.textAntiAliasing) {
+    page->render(renderer, layout.fontId, layout.marginLeft, layout.marginTop);
+  } else {
+    page->renderImages(renderer, layout.marginLeft, layout.marginTop);
+  }
+  renderer.setRenderMode(GfxRenderer::BW);
+  return true;
+}
+
+void EpubReaderActivity::runBakeStep() {
+  const auto start = millis();
+  // Taken now, loop() may already be requesting the next step
+  const uint32_t presses = bakeStepPresses;
+  const EpubBakeJob::Status status =
+      bakeJob->step([this, presses] { return pendingPageTurns != 0 || buttonPresses != presses; });
+  // The step drew its page into the frame buffer, the panel still shows ours
+  frameBufferStale = true;
+  LOG_D(ERS, "Bake step in %lums", millis() - start);
+
+  if (status == EpubBakeJob::Status::Done) {
+    baking = false;
+    bakeJob.reset();
+    baked = BakedEpub::open(*epub, EpubPageLayout::current(renderer));
+  } else if (status == EpubBakeJob::Status::Failed) {
+    LOG_E(ERS, "Bake failed, reading on without it");
+    baking = false;
+    bakeJob.reset();
+  }
 }
 
 void EpubReaderActivity::renderStatusBar(const int orientedMarginRight, const int orientedMarginBottom,
@@ -553,3 +704,16 @@ void EpubReaderActivity::renderStatusBar(const int orientedMarginRight, const in
                       title.c_str());
   }
 }
+
+void EpubReaderActivity::renderSkimStatusBar(const int orientedMarginRight, const int orientedMarginBottom) const {
+  if (SETTINGS.statusBar == CrossPointSettings::STATUS_BAR_MODE::NONE) {
+    return;
+  }
+
+  // Only the page counter, the book progress, battery and chapter title wait for the full quality pass
+  char progressStr[16];
+  snprintf(progressStr, sizeof(progressStr), "%d/%d", section->currentPage + 1, section->pageCount);
+  const int progressTextWidth = renderer.getTextWidth(SMALL_FONT_ID, progressStr);
+  renderer.drawText(SMALL_FONT_ID, renderer.getScreenWidth() - orientedMarginRight - progressTextWidth,
+                    renderer.getScreenHeight() - orientedMarginBottom - 4, progressStr);
+}
@@ -1,32 +1,75 @@
 #pragma once
 #include <Epub.h>
 #include <Epub/Section.h>
-#include <freertos/FreeRTOS.h>
-#include <freertos/semphr.h>
-#include <freertos/task.h>
 
+#include <GfxRenderer.h>
+
+#include <atomic>
+
+#include "EpubBake.h"
 #include "activities/ActivityWithSubactivity.h"
 
+/**
+ * Page turns are not applied in loop(). Each press adds to pendingPageTurns and render() applies the net count when
+ * the frame is drawn, so presses that arrive while a page is still being drawn collapse into one jump to the final
+ * page instead of a refresh for every page in between.
+ *
+ * Page turns in quick succession, or a page button held down, switch to skimming: pages are drawn with a fast
+ * refresh, no grayscale pass and only the page counter in the status bar. Once input has been idle for
+ * skimSettleMs the page is drawn again at full quality, and onSleep() does the same for the resume snapshot.
+ *
+ * Pages of a book baked with the current layout (see EpubBake.h) are blitted from the baked book instead of being
+ * drawn from the section file. With Pre-render Books on, the bake job runs a page at a time while the reader is idle,
+ * as Background frames that draw nothing. Indexing a chapter is a step of its own, and a step stops early to give
+ * the render task back as soon as a page turn or any other button press comes in. Steps leave their page in the frame
+ * buffer, onSleep() draws the page on screen again before it is saved as the resume snapshot.
+ */
 class EpubReaderActivity final : public ActivityWithSubactivity {
   std::shared_ptr<Epub> epub;
   std::unique_ptr<Section> section = nullptr;
-  TaskHandle_t displayTaskHandle = nullptr;
-  SemaphoreHandle_t renderingMutex = nullptr;
   int currentSpineIndex = 0;
   int nextPageNumber = 0;
   int pagesUntilFullRefresh = 0;
   int cachedSpineIndex = 0;
   int cachedChapterTotalPageCount = 0;
-  bool updateRequired = false;
+  // Net page turns since the last frame, written by loop() and consumed by render()
+  std::atomic<int> pendingPageTurns{0};
+  // Draw the next frame as a skim frame
+  std::atomic<bool> skimRequested{false};
+  // The page on screen was drawn as a skim frame and still needs its full quality pass
+  std::atomic<bool> skimFrameShown{false};
+  unsigned long lastPageTurnMs = 0;
+  std::unique_ptr<BakedEpub> baked;
+  std::unique_ptr<EpubBakeJob> bakeJob;
+  // bakeJob is set, for loop()
+  std::atomic<bool> baking{false};
+  // The next frame runs a step of the bake job instead of drawing, if the page is still on screen by then
+  std::atomic<bool> bakeStepRequested{false};
+  // Button presses seen by loop(), and their count when the bake step was requested. The step yields once it changes.
+  std::atomic<uint32_t> buttonPresses{0};
+  std::atomic<uint32_t> bakeStepPresses{0};
+  // The page is on screen at full quality and nothing is waiting to be drawn
+  std::atomic<bool> pageOnScreen{false};
+  // A bake step drew over the frame buffer since the page on screen was drawn, render task only
+  bool frameBufferStale = false;
+#if CROSSPOINT_PERF
+  // When the page turn currently being rendered was requested, 0 when none is pending. Set by loop(), taken by render()
+  std::atomic<unsigned long> pageTurnStartUs{0};
+#endif
   const std::function<void()> onGoBack;
   const std::function<void()> onGoHome;
 
-  static void taskTrampoline(void* param);
-  [[noreturn]] void displayTaskLoop();
-  void renderScreen();
-  void renderContents(std::unique_ptr<Page> page, int orientedMarginTop, int orientedMarginRight,
-                      int orientedMarginBottom, int orientedMarginLeft);
+  void queuePageTurn(int direction, bool skim);
+  void applyPageTurns(int turns);
+  void render() override;
+  void runBakeStep();
+  // page is null to draw from the baked book
+  void renderContents(std::unique_ptr<Page> page, const EpubPageLayout& layout, bool skim);
+  // One pass of the page into the frame buffer, for BW whether the gray passes have anything to draw. False from the
+  // baked book when it can't be read.
+  bool drawPagePass(const Page* page, GfxRenderer::RenderMode mode, const EpubPageLayout& layout, bool& grays);
   void renderStatusBar(int orientedMarginRight, int orientedMarginBottom, int orientedMarginLeft) const;
+  void renderSkimStatusBar(int orientedMarginRight, int orientedMarginBottom) const;
 
  public:
   explicit EpubReaderActivity(GfxRenderer& renderer, MappedInputManager& mappedInput, std::unique_ptr<Epub> epub,
@@ -38,4 +81,5 @@ class EpubReaderActivity final : public ActivityWithSubactivity {
   void onEnter() override;
   void onExit() override;
   void loop() override;
+  void onSleep() override;
 };
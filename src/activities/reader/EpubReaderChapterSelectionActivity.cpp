@@ -33,7 +33,7 @@ int EpubReaderChapterSelectionActivity::tocIndexFromItemIndex(int itemIndex) con
 }
 
 int EpubReaderChapterSelectionActivity::getPageItems() const {
-  // Layout constants used in renderScreen
+  // Layout constants used in render
   constexpr int startY = 60;
   constexpr int lineHeight = 30;
 
@@ -50,11 +50,6 @@ int EpubReaderChapterSelectionActivity::getPageItems() const {
   return items;
 }
 
-void EpubReaderChapterSelectionActivity::taskTrampoline(void* param) {
-  auto* self = static_cast<EpubReaderChapterSelectionActivity*>(param);
-  self->displayTaskLoop();
-}
-
 void EpubReaderChapterSelectionActivity::onEnter() {
   ActivityWithSubactivity::onEnter();
 
@@ -62,8 +57,6 @@ void EpubReaderChapterSelectionActivity::onEnter() {
     return;
   }
 
-  renderingMutex = xSemaphoreCreateMutex();
-
   // Account for sync option offset when finding current TOC index
   const int syncOffset = hasSyncOption() ? 1 : 0;
   selectorIndex = epub->getTocIndexForSpineIndex(currentSpineIndex);
@@ -73,44 +66,24 @@ void EpubReaderChapterSelectionActivity::onEnter() {
   selectorIndex += syncOffset;  // Offset for top sync option
 
   // Trigger first update
-  updateRequired = true;
-  xTaskCreate(&EpubReaderChapterSelectionActivity::taskTrampoline, "EpubReaderChapterSelectionActivityTask",
-              4096,               // Stack size
-              this,               // Parameters
-              1,                  // Priority
-              &displayTaskHandle  // Task handle
-  );
-}
-
-void EpubReaderChapterSelectionActivity::onExit() {
-  ActivityWithSubactivity::onExit();
-
-  // Wait until not rendering to delete task to avoid killing mid-instruction to EPD
-  xSemaphoreTake(renderingMutex, portMAX_DELAY);
-  if (displayTaskHandle) {
-    vTaskDelete(displayTaskHandle);
-    displayTaskHandle = nullptr;
-  }
-  vSemaphoreDelete(renderingMutex);
-  renderingMutex = nullptr;
+  requestUpdate();
 }
 
 void EpubReaderChapterSelectionActivity::launchSyncActivity() {
-  xSemaphoreTake(renderingMutex, portMAX_DELAY);
+  RENDER_SERVICE.lock();
   exitActivity();
   enterNewActivity(new KOReaderSyncActivity(
       renderer, mappedInput, epub, epubPath, currentSpineIndex, currentPage, totalPagesInSpine,
       [this]() {
         // On cancel
         exitActivity();
-        updateRequired = true;
       },
       [this](int newSpineIndex, int newPage) {
         // On sync complete
         exitActivity();
         onSyncPosition(newSpineIndex, newPage);
       }));
-  xSemaphoreGive(renderingMutex);
+  RENDER_SERVICE.unlock();
 }
 
 void EpubReaderChapterSelectionActivity::loop() {
@@ -151,30 +124,23 @@ void EpubReaderChapterSelectionActivity::loop() {
     } else {
       selectorIndex = (selectorIndex + totalItems - 1) % totalItems;
     }
-    updateRequired = true;
+    requestUpdate();
   } else if (nextReleased) {
     if (skipPage) {
       selectorIndex = ((selectorIndex / pageItems + 1) * pageItems) % totalItems;
     } else {
       selectorIndex = (selectorIndex + 1) % totalItems;
     }
-    updateRequired = true;
+    requestUpdate();
   }
 }
 
-void EpubReaderChapterSelectionActivity::displayTaskLoop() {
-  while (true) {
-    if (updateRequired && !subActivity) {
-      updateRequired = false;
-      xSemaphoreTake(renderingMutex, portMAX_DELAY);
-      renderScreen();
-      xSemaphoreGive(renderingMutex);
-    }
-    vTaskDelay(10 / portTICK_PERIOD_MS);
+void EpubReaderChapterSelectionActivity::render() {
+  // The sub-activity draws the screen while it is open
+  if (subActivity) {
+    return;
   }
-}
 
-void EpubReaderChapterSelectionActivity::renderScreen() {
   renderer.clearScreen();
 
   const auto pageWidth = renderer.getScreenWidth();
@@ -1,8 +1,5 @@
 #pragma once
 #include <Epub.h>
-#include <freertos/FreeRTOS.h>
-#include <freertos/semphr.h>
-#include <freertos/task.h>
 
 #include <memory>
 
@@ -11,13 +8,10 @@
 class EpubReaderChapterSelectionActivity final : public ActivityWithSubactivity {
   std::shared_ptr<Epub> epub;
   std::string epubPath;
-  TaskHandle_t displayTaskHandle = nullptr;
-  SemaphoreHandle_t renderingMutex = nullptr;
   int currentSpineIndex = 0;
   int currentPage = 0;
   int totalPagesInSpine = 0;
   int selectorIndex = 0;
-  bool updateRequired = false;
   const std::function<void()> onGoBack;
   const std::function<void(int newSpineIndex)> onSelectSpineIndex;
   const std::function<void(int newSpineIndex, int newPage)> onSyncPosition;
@@ -38,9 +32,7 @@ class EpubReaderChapterSelectionActivity final : public ActivityWithSubactivity
   // Convert item index to TOC index (accounting for top sync option offset)
   int tocIndexFromItemIndex(int itemIndex) const;
 
-  static void taskTrampoline(void* param);
-  [[noreturn]] void displayTaskLoop();
-  void renderScreen();
+  void render() override;
   void launchSyncActivity();
 
  public:
@@ -60,6 +52,5 @@ class EpubReaderChapterSelectionActivity final : public ActivityWithSubactivity
         onSelectSpineIndex(onSelectSpineIndex),
         onSyncPosition(onSyncPosition) {}
   void onEnter() override;
-  void onExit() override;
   void loop() override;
 };
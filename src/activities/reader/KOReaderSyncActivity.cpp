@@ -38,11 +38,6 @@ void syncTimeWithNTP() {
 }
 }  // namespace
 
-void KOReaderSyncActivity::taskTrampoline(void* param) {
-  auto* self = static_cast<KOReaderSyncActivity*>(param);
-  self->displayTaskLoop();
-}
-
 void KOReaderSyncActivity::onWifiSelectionComplete(const bool success) {
   exitActivity();
 
@@ -54,19 +49,19 @@ void KOReaderSyncActivity::onWifiSelectionComplete(const bool success) {
 
   Serial.printf("[%lu] [KOSync] WiFi connected, starting sync\n", millis());
 
-  xSemaphoreTake(renderingMutex, portMAX_DELAY);
+  RENDER_SERVICE.lock();
   state = SYNCING;
   statusMessage = "Syncing time...";
-  xSemaphoreGive(renderingMutex);
-  updateRequired = true;
+  RENDER_SERVICE.unlock();
+  requestUpdate();
 
   // Sync time with NTP before making API requests
   syncTimeWithNTP();
 
-  xSemaphoreTake(renderingMutex, portMAX_DELAY);
+  RENDER_SERVICE.lock();
   statusMessage = "Calculating document hash...";
-  xSemaphoreGive(renderingMutex);
-  updateRequired = true;
+  RENDER_SERVICE.unlock();
+  requestUpdate();
 
   performSync();
 }
@@ -79,20 +74,20 @@ void KOReaderSyncActivity::performSync() {
     documentHash = KOReaderDocumentId::calculate(epubPath);
   }
   if (documentHash.empty()) {
-    xSemaphoreTake(renderingMutex, portMAX_DELAY);
+    RENDER_SERVICE.lock();
     state = SYNC_FAILED;
     statusMessage = "Failed to calculate document hash";
-    xSemaphoreGive(renderingMutex);
-    updateRequired = true;
+    RENDER_SERVICE.unlock();
+    requestUpdate();
     return;
   }
 
   Serial.printf("[%lu] [KOSync] Document hash: %s\n", millis(), documentHash.c_str());
 
-  xSemaphoreTake(renderingMutex, portMAX_DELAY);
+  RENDER_SERVICE.lock();
   statusMessage = "Fetching remote progress...";
-  xSemaphoreGive(renderingMutex);
-  updateRequired = true;
+  RENDER_SERVICE.unlock();
+  requestUpdate();
   vTaskDelay(10 / portTICK_PERIOD_MS);
 
   // Fetch remote progress
@@ -100,20 +95,20 @@ void KOReaderSyncActivity::performSync() {
 
   if (result == KOReaderSyncClient::NOT_FOUND) {
     // No remote progress - offer to upload
-    xSemaphoreTake(renderingMutex, portMAX_DELAY);
+    RENDER_SERVICE.lock();
     state = NO_REMOTE_PROGRESS;
     hasRemoteProgress = false;
-    xSemaphoreGive(renderingMutex);
-    updateRequired = true;
+    RENDER_SERVICE.unlock();
+    requestUpdate();
     return;
   }
 
   if (result != KOReaderSyncClient::OK) {
-    xSemaphoreTake(renderingMutex, portMAX_DELAY);
+    RENDER_SERVICE.lock();
     state = SYNC_FAILED;
     statusMessage = KOReaderSyncClient::errorString(result);
-    xSemaphoreGive(renderingMutex);
-    updateRequired = true;
+    RENDER_SERVICE.unlock();
+    requestUpdate();
     return;
   }
 
@@ -126,19 +121,19 @@ void KOReaderSyncActivity::performSync() {
   CrossPointPosition localPos = {currentSpineIndex, currentPage, totalPagesInSpine};
   localProgress = ProgressMapper::toKOReader(epub, localPos);
 
-  xSemaphoreTake(renderingMutex, portMAX_DELAY);
+  RENDER_SERVICE.lock();
   state = SHOWING_RESULT;
   selectedOption = 0;  // Default to "Apply"
-  xSemaphoreGive(renderingMutex);
-  updateRequired = true;
+  RENDER_SERVICE.unlock();
+  requestUpdate();
 }
 
 void KOReaderSyncActivity::performUpload() {
-  xSemaphoreTake(renderingMutex, portMAX_DELAY);
+  RENDER_SERVICE.lock();
   state = UPLOADING;
   statusMessage = "Uploading progress...";
-  xSemaphoreGive(renderingMutex);
-  updateRequired = true;
+  RENDER_SERVICE.unlock();
+  requestUpdate();
   vTaskDelay(10 / portTICK_PERIOD_MS);
 
   // Convert current position to KOReader format
@@ -153,36 +148,27 @@ void KOReaderSyncActivity::performUpload() {
   const auto result = KOReaderSyncClient::updateProgress(progress);
 
   if (result != KOReaderSyncClient::OK) {
-    xSemaphoreTake(renderingMutex, portMAX_DELAY);
+    RENDER_SERVICE.lock();
     state = SYNC_FAILED;
     statusMessage = KOReaderSyncClient::errorString(result);
-    xSemaphoreGive(renderingMutex);
-    updateRequired = true;
+    RENDER_SERVICE.unlock();
+    requestUpdate();
     return;
   }
 
-  xSemaphoreTake(renderingMutex, portMAX_DELAY);
+  RENDER_SERVICE.lock();
   state = UPLOAD_COMPLETE;
-  xSemaphoreGive(renderingMutex);
-  updateRequired = true;
+  RENDER_SERVICE.unlock();
+  requestUpdate();
 }
 
 void KOReaderSyncActivity::onEnter() {
   ActivityWithSubactivity::onEnter();
 
-  renderingMutex = xSemaphoreCreateMutex();
-
-  xTaskCreate(&KOReaderSyncActivity::taskTrampoline, "KOSyncTask",
-              4096,               // Stack size (larger for network operations)
-              this,               // Parameters
-              1,                  // Priority
-              &displayTaskHandle  // Task handle
-  );
-
   // Check for credentials first
   if (!KOREADER_STORE.hasCredentials()) {
     state = NO_CREDENTIALS;
-    updateRequired = true;
+    requestUpdate();
     return;
   }
 
@@ -195,7 +181,7 @@ void KOReaderSyncActivity::onEnter() {
     Serial.printf("[%lu] [KOSync] Already connected to WiFi\n", millis());
     state = SYNCING;
     statusMessage = "Syncing time...";
-    updateRequired = true;
+    requestUpdate();
 
     // Perform sync directly (will be handled in loop)
     xTaskCreate(
@@ -203,10 +189,10 @@ void KOReaderSyncActivity::onEnter() {
           auto* self = static_cast<KOReaderSyncActivity*>(param);
           // Sync time first
           syncTimeWithNTP();
-          xSemaphoreTake(self->renderingMutex, portMAX_DELAY);
+          RENDER_SERVICE.lock();
           self->statusMessage = "Calculating document hash...";
-          xSemaphoreGive(self->renderingMutex);
-          self->updateRequired = true;
+          RENDER_SERVICE.unlock();
+          self->requestUpdate(RenderService::Priority::Background);
           self->performSync();
           vTaskDelete(nullptr);
         },
@@ -228,27 +214,6 @@ void KOReaderSyncActivity::onExit() {
   delay(100);
   WiFi.mode(WIFI_OFF);
   delay(100);
-
-  // Wait until not rendering to delete task
-  xSemaphoreTake(renderingMutex, portMAX_DELAY);
-  if (displayTaskHandle) {
-    vTaskDelete(displayTaskHandle);
-    displayTaskHandle = nullptr;
-  }
-  vSemaphoreDelete(renderingMutex);
-  renderingMutex = nullptr;
-}
-
-void KOReaderSyncActivity::displayTaskLoop() {
-  while (true) {
-    if (updateRequired) {
-      updateRequired = false;
-      xSemaphoreTake(renderingMutex, portMAX_DELAY);
-      render();
-      xSemaphoreGive(renderingMutex);
-    }
-    vTaskDelay(10 / portTICK_PERIOD_MS);
-  }
 }
 
 void KOReaderSyncActivity::render() {
@@ -392,11 +357,11 @@ void KOReaderSyncActivity::loop() {
     if (mappedInput.wasPressed(MappedInputManager::Button::Up) ||
         mappedInput.wasPressed(MappedInputManager::Button::Left)) {
       selectedOption = (selectedOption + 2) % 3;  // Wrap around
-      updateRequired = true;
+      requestUpdate();
     } else if (mappedInput.wasPressed(MappedInputManager::Button::Down) ||
                mappedInput.wasPressed(MappedInputManager::Button::Right)) {
       selectedOption = (selectedOption + 1) % 3;
-      updateRequired = true;
+      requestUpdate();
     }
 
     if (mappedInput.wasPressed(MappedInputManager::Button::Confirm)) {
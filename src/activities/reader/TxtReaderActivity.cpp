@@ -7,6 +7,7 @@
 
 #include "CrossPointSettings.h"
 #include "CrossPointState.h"
+#include "LibraryIndex.h"
 #include "MappedInputManager.h"
 #include "RecentBooksStore.h"
 #include "ScreenComponents.h"
@@ -20,14 +21,9 @@ constexpr size_t CHUNK_SIZE = 8 * 1024;  // 8KB chunk for reading
 
 // Cache file magic and version
 constexpr uint32_t CACHE_MAGIC = 0x54585449;  // "TXTI"
-constexpr uint8_t CACHE_VERSION = 2;          // Increment when cache format changes
+constexpr uint8_t CACHE_VERSION = 3;          // Increment when cache format or page breaks change
 }  // namespace
 
-void TxtReaderActivity::taskTrampoline(void* param) {
-  auto* self = static_cast<TxtReaderActivity*>(param);
-  self->displayTaskLoop();
-}
-
 void TxtReaderActivity::onEnter() {
   ActivityWithSubactivity::onEnter();
 
@@ -53,8 +49,6 @@ void TxtReaderActivity::onEnter() {
       break;
   }
 
-  renderingMutex = xSemaphoreCreateMutex();
-
   txt->setupCacheDir();
 
   // Save current txt as last opened file and add to recent books
@@ -63,30 +57,19 @@ void TxtReaderActivity::onEnter() {
   RECENT_BOOKS.addBook(txt->getPath(), "", "");
 
   // Trigger first update
-  updateRequired = true;
-
-  xTaskCreate(&TxtReaderActivity::taskTrampoline, "TxtReaderActivityTask",
-              6144,               // Stack size
-              this,               // Parameters
-              1,                  // Priority
-              &displayTaskHandle  // Task handle
-  );
+  requestUpdate();
 }
 
 void TxtReaderActivity::onExit() {
   ActivityWithSubactivity::onExit();
 
+  if (txt && totalPages > 0) {
+    LIBRARY_INDEX.updateProgress(txt->getPath(), static_cast<uint8_t>((currentPage + 1) * 100 / totalPages));
+  }
+
   // Reset orientation back to portrait for the rest of the UI
   renderer.setOrientation(GfxRenderer::Orientation::Portrait);
 
-  // Wait until not rendering to delete task
-  xSemaphoreTake(renderingMutex, portMAX_DELAY);
-  if (displayTaskHandle) {
-    vTaskDelete(displayTaskHandle);
-    displayTaskHandle = nullptr;
-  }
-  vSemaphoreDelete(renderingMutex);
-  renderingMutex = nullptr;
   pageOffsets.clear();
   currentPageLines.clear();
   txt.reset();
@@ -130,22 +113,10 @@ void TxtReaderActivity::loop() {
 
   if (prevTriggered && currentPage > 0) {
     currentPage--;
-    updateRequired = true;
+    requestUpdate();
   } else if (nextTriggered && currentPage < totalPages - 1) {
     currentPage++;
-    updateRequired = true;
-  }
-}
-
-void TxtReaderActivity::displayTaskLoop() {
-  while (true) {
-    if (updateRequired) {
-      updateRequired = false;
-      xSemaphoreTake(renderingMutex, portMAX_DELAY);
-      renderScreen();
-      xSemaphoreGive(renderingMutex);
-    }
-    vTaskDelay(10 / portTICK_PERIOD_MS);
+    requestUpdate();
   }
 }
 
@@ -230,11 +201,19 @@ void TxtReaderActivity::buildPageIndex() {
   renderer.drawRect(barX, barY, barWidth, barHeight);
   renderer.displayBuffer();
 
+  auto* buffer = static_cast<uint8_t*>(malloc(CHUNK_SIZE + 1));
+  if (!buffer) {
+    Serial.printf("[%lu] [TRS] Failed to allocate %zu bytes\n", millis(), CHUNK_SIZE + 1);
+    totalPages = pageOffsets.size();
+    return;
+  }
+  std::vector<TxtLine> tempLines;
+  tempLines.reserve(linesPerPage);
+
   while (offset < fileSize) {
-    std::vector<std::string> tempLines;
     size_t nextOffset = offset;
 
-    if (!loadPageAtOffset(offset, tempLines, nextOffset)) {
+    if (!loadPageAtOffset(offset, buffer, tempLines, nextOffset)) {
       break;
     }
 
@@ -264,12 +243,14 @@ void TxtReaderActivity::buildPageIndex() {
       vTaskDelay(1);
     }
   }
+  free(buffer);
 
   totalPages = pageOffsets.size();
   Serial.printf("[%lu] [TRS] Built page index: %d pages\n", millis(), totalPages);
 }
 
-bool TxtReaderActivity::loadPageAtOffset(size_t offset, std::vector<std::string>& outLines, size_t& nextOffset) {
+bool TxtReaderActivity::loadPageAtOffset(const size_t offset, uint8_t* buffer, std::vector<TxtLine>& outLines,
+                                         size_t& nextOffset) {
   outLines.clear();
   const size_t fileSize = txt->getFileSize();
 
@@ -278,124 +259,20 @@ bool TxtReaderActivity::loadPageAtOffset(size_t offset, std::vector<std::string>
   }
 
   // Read a chunk from file
-  size_t chunkSize = std::min(CHUNK_SIZE, fileSize - offset);
-  auto* buffer = static_cast<uint8_t*>(malloc(chunkSize + 1));
-  if (!buffer) {
-    Serial.printf("[%lu] [TRS] Failed to allocate %zu bytes\n", millis(), chunkSize);
-    return false;
-  }
-
+  const size_t chunkSize = std::min(CHUNK_SIZE, fileSize - offset);
   if (!txt->readContent(buffer, offset, chunkSize)) {
-    free(buffer);
     return false;
   }
   buffer[chunkSize] = '\0';
 
-  // Parse lines from buffer
-  size_t pos = 0;
-
-  while (pos < chunkSize && static_cast<int>(outLines.size()) < linesPerPage) {
-    // Find end of line
-    size_t lineEnd = pos;
-    while (lineEnd < chunkSize && buffer[lineEnd] != '\n') {
-      lineEnd++;
-    }
-
-    // Check if we have a complete line
-    bool lineComplete = (lineEnd < chunkSize) || (offset + lineEnd >= fileSize);
-
-    if (!lineComplete && static_cast<int>(outLines.size()) > 0) {
-      // Incomplete line and we already have some lines, stop here
-      break;
-    }
-
-    // Calculate the actual length of line content in the buffer (excluding newline)
-    size_t lineContentLen = lineEnd - pos;
-
-    // Check for carriage return
-    bool hasCR = (lineContentLen > 0 && buffer[pos + lineContentLen - 1] == '\r');
-    size_t displayLen = hasCR ? lineContentLen - 1 : lineContentLen;
-
-    // Extract line content for display (without CR/LF)
-    std::string line(reinterpret_cast<char*>(buffer + pos), displayLen);
-
-    // Track position within this source line (in bytes from pos)
-    size_t lineBytePos = 0;
-
-    // Word wrap if needed
-    while (!line.empty() && static_cast<int>(outLines.size()) < linesPerPage) {
-      int lineWidth = renderer.getTextWidth(cachedFontId, line.c_str());
-
-      if (lineWidth <= viewportWidth) {
-        outLines.push_back(line);
-        lineBytePos = displayLen;  // Consumed entire display content
-        line.clear();
-        break;
-      }
-
-      // Find break point
-      size_t breakPos = line.length();
-      while (breakPos > 0 && renderer.getTextWidth(cachedFontId, line.substr(0, breakPos).c_str()) > viewportWidth) {
-        // Try to break at space
-        size_t spacePos = line.rfind(' ', breakPos - 1);
-        if (spacePos != std::string::npos && spacePos > 0) {
-          breakPos = spacePos;
-        } else {
-          // Break at character boundary for UTF-8
-          breakPos--;
-          // Make sure we don't break in the middle of a UTF-8 sequence
-          while (breakPos > 0 && (line[breakPos] & 0xC0) == 0x80) {
-            breakPos--;
-          }
-        }
-      }
-
-      if (breakPos == 0) {
-        breakPos = 1;
-      }
-
-      outLines.push_back(line.substr(0, breakPos));
-
-      // Skip space at break point
-      size_t skipChars = breakPos;
-      if (breakPos < line.length() && line[breakPos] == ' ') {
-        skipChars++;
-      }
-      lineBytePos += skipChars;
-      line = line.substr(skipChars);
-    }
-
-    // Determine how much of the source buffer we consumed
-    if (line.empty()) {
-      // Fully consumed this source line, move past the newline
-      pos = lineEnd + 1;
-    } else {
-      // Partially consumed - page is full mid-line
-      // Move pos to where we stopped in the line (NOT past the line)
-      pos = pos + lineBytePos;
-      break;
-    }
-  }
-
-  // Ensure we make progress even if calculations go wrong
-  if (pos == 0 && !outLines.empty()) {
-    // Fallback: at minimum, consume something to avoid infinite loop
-    pos = 1;
-  }
-
-  nextOffset = offset + pos;
-
-  // Make sure we don't go past the file
-  if (nextOffset > fileSize) {
-    nextOffset = fileSize;
-  }
-
-  free(buffer);
+  const TxtWrapper wrapper(renderer.getFont(cachedFontId), viewportWidth, linesPerPage);
+  const size_t pageSize = wrapper.layoutPage(buffer, chunkSize, offset + chunkSize >= fileSize, outLines);
+  nextOffset = std::min(offset + pageSize, fileSize);
 
   return !outLines.empty();
 }
 
-void TxtReaderActivity::renderScreen() {
+void TxtReaderActivity::render() {
   if (!txt) {
     return;
   }
@@ -419,20 +296,24 @@ void TxtReaderActivity::renderScreen() {
   if (currentPage < 0) currentPage = 0;
   if (currentPage >= totalPages) currentPage = totalPages - 1;
 
-  // Load current page content
-  size_t offset = pageOffsets[currentPage];
+  // Load current page content, its lines point into the chunk until it has been drawn
+  auto* buffer = static_cast<uint8_t*>(malloc(CHUNK_SIZE + 1));
+  if (!buffer) {
+    Serial.printf("[%lu] [TRS] Failed to allocate %zu bytes\n", millis(), CHUNK_SIZE + 1);
+    return;
+  }
   size_t nextOffset;
-  currentPageLines.clear();
-  loadPageAtOffset(offset, currentPageLines, nextOffset);
+  loadPageAtOffset(pageOffsets[currentPage], buffer, currentPageLines, nextOffset);
 
   renderer.clearScreen();
-  renderPage();
+  renderPage(buffer);
+  free(buffer);
 
   // Save progress
   saveProgress();
 }
 
-void TxtReaderActivity::renderPage() {
+void TxtReaderActivity::renderPage(uint8_t* text) {
   int orientedMarginTop, orientedMarginRight, orientedMarginBottom, orientedMarginLeft;
   renderer.getOrientedViewableTRBL(&orientedMarginTop, &orientedMarginRight, &orientedMarginBottom,
                                    &orientedMarginLeft);
@@ -447,8 +328,12 @@ void TxtReaderActivity::renderPage() {
   // Render text lines with alignment
   auto renderLines = [&]() {
     int y = orientedMarginTop;
-    for (const auto& line : currentPageLines) {
-      if (!line.empty()) {
+    for (const auto& span : currentPageLines) {
+      if (span.length > 0) {
+        // Terminated in place while it is drawn, the byte after a line can be the first one of the next
+        char* line = reinterpret_cast<char*>(text + span.offset);
+        const char end = line[span.length];
+        line[span.length] = '\0';
         int x = orientedMarginLeft;
 
         // Apply text alignment
@@ -458,12 +343,12 @@ void TxtReaderActivity::renderPage() {
             // x already set to left margin
             break;
           case CrossPointSettings::CENTER_ALIGN: {
-            int textWidth = renderer.getTextWidth(cachedFontId, line.c_str());
+            int textWidth = renderer.getTextWidth(cachedFontId, line);
             x = orientedMarginLeft + (contentWidth - textWidth) / 2;
             break;
           }
           case CrossPointSettings::RIGHT_ALIGN: {
-            int textWidth = renderer.getTextWidth(cachedFontId, line.c_str());
+            int textWidth = renderer.getTextWidth(cachedFontId, line);
             x = orientedMarginLeft + contentWidth - textWidth;
             break;
           }
@@ -473,7 +358,8 @@ void TxtReaderActivity::renderPage() {
             break;
         }
 
-        renderer.drawText(cachedFontId, x, y, line.c_str());
+        renderer.drawText(cachedFontId, x, y, line);
+        line[span.length] = end;
       }
       y += lineHeight;
     }
@@ -624,10 +510,11 @@ bool TxtReaderActivity::loadPageIndexCache() {
     Serial.printf("[%lu] [TRS] No page index cache found\n", millis());
     return false;
   }
+  BufferedFsReader reader(f);
 
   // Read and validate header using serialization module
   uint32_t magic;
-  serialization::readPod(f, magic);
+  serialization::readPod(reader, magic);
   if (magic != CACHE_MAGIC) {
     Serial.printf("[%lu] [TRS] Cache magic mismatch, rebuilding\n", millis());
     f.close();
@@ -635,7 +522,7 @@ bool TxtReaderActivity::loadPageIndexCache() {
   }
 
   uint8_t version;
-  serialization::readPod(f, version);
+  serialization::readPod(reader, version);
   if (version != CACHE_VERSION) {
     Serial.printf("[%lu] [TRS] Cache version mismatch (%d != %d), rebuilding\n", millis(), version, CACHE_VERSION);
     f.close();
@@ -643,7 +530,7 @@ bool TxtReaderActivity::loadPageIndexCache() {
   }
 
   uint32_t fileSize;
-  serialization::readPod(f, fileSize);
+  serialization::readPod(reader, fileSize);
   if (fileSize != txt->getFileSize()) {
     Serial.printf("[%lu] [TRS] Cache file size mismatch, rebuilding\n", millis());
     f.close();
@@ -651,7 +538,7 @@ bool TxtReaderActivity::loadPageIndexCache() {
   }
 
   int32_t cachedWidth;
-  serialization::readPod(f, cachedWidth);
+  serialization::readPod(reader, cachedWidth);
   if (cachedWidth != viewportWidth) {
     Serial.printf("[%lu] [TRS] Cache viewport width mismatch, rebuilding\n", millis());
     f.close();
@@ -659,7 +546,7 @@ bool TxtReaderActivity::loadPageIndexCache() {
   }
 
   int32_t cachedLines;
-  serialization::readPod(f, cachedLines);
+  serialization::readPod(reader, cachedLines);
   if (cachedLines != linesPerPage) {
     Serial.printf("[%lu] [TRS] Cache lines per page mismatch, rebuilding\n", millis());
     f.close();
@@ -667,7 +554,7 @@ bool TxtReaderActivity::loadPageIndexCache() {
   }
 
   int32_t fontId;
-  serialization::readPod(f, fontId);
+  serialization::readPod(reader, fontId);
   if (fontId != cachedFontId) {
     Serial.printf("[%lu] [TRS] Cache font ID mismatch (%d != %d), rebuilding\n", millis(), fontId, cachedFontId);
     f.close();
@@ -675,7 +562,7 @@ bool TxtReaderActivity::loadPageIndexCache() {
   }
 
   int32_t margin;
-  serialization::readPod(f, margin);
+  serialization::readPod(reader, margin);
   if (margin != cachedScreenMargin) {
     Serial.printf("[%lu] [TRS] Cache screen margin mismatch, rebuilding\n", millis());
     f.close();
@@ -683,7 +570,7 @@ bool TxtReaderActivity::loadPageIndexCache() {
   }
 
   uint8_t alignment;
-  serialization::readPod(f, alignment);
+  serialization::readPod(reader, alignment);
   if (alignment != cachedParagraphAlignment) {
     Serial.printf("[%lu] [TRS] Cache paragraph alignment mismatch, rebuilding\n", millis());
     f.close();
@@ -691,7 +578,7 @@ bool TxtReaderActivity::loadPageIndexCache() {
   }
 
   uint32_t numPages;
-  serialization::readPod(f, numPages);
+  serialization::readPod(reader, numPages);
 
   // Read page offsets
   pageOffsets.clear();
@@ -699,7 +586,7 @@ bool TxtReaderActivity::loadPageIndexCache() {
 
   for (uint32_t i = 0; i < numPages; i++) {
     uint32_t offset;
-    serialization::readPod(f, offset);
+    serialization::readPod(reader, offset);
     pageOffsets.push_back(offset);
   }
 
@@ -716,23 +603,25 @@ void TxtReaderActivity::savePageIndexCache() const {
     Serial.printf("[%lu] [TRS] Failed to save page index cache\n", millis());
     return;
   }
+  BufferedFsWriter writer(f);
 
   // Write header using serialization module
-  serialization::writePod(f, CACHE_MAGIC);
-  serialization::writePod(f, CACHE_VERSION);
-  serialization::writePod(f, static_cast<uint32_t>(txt->getFileSize()));
-  serialization::writePod(f, static_cast<int32_t>(viewportWidth));
-  serialization::writePod(f, static_cast<int32_t>(linesPerPage));
-  serialization::writePod(f, static_cast<int32_t>(cachedFontId));
-  serialization::writePod(f, static_cast<int32_t>(cachedScreenMargin));
-  serialization::writePod(f, cachedParagraphAlignment);
-  serialization::writePod(f, static_cast<uint32_t>(pageOffsets.size()));
+  serialization::writePod(writer, CACHE_MAGIC);
+  serialization::writePod(writer, CACHE_VERSION);
+  serialization::writePod(writer, static_cast<uint32_t>(txt->getFileSize()));
+  serialization::writePod(writer, static_cast<int32_t>(viewportWidth));
+  serialization::writePod(writer, static_cast<int32_t>(linesPerPage));
+  serialization::writePod(writer, static_cast<int32_t>(cachedFontId));
+  serialization::writePod(writer, static_cast<int32_t>(cachedScreenMargin));
+  serialization::writePod(writer, cachedParagraphAlignment);
+  serialization::writePod(writer, static_cast<uint32_t>(pageOffsets.size()));
 
   // Write page offsets
   for (size_t offset : pageOffsets) {
-    serialization::writePod(f, static_cast<uint32_t>(offset));
+    serialization::writePod(writer, static_cast<uint32_t>(offset));
   }
 
+  writer.flush();
   f.close();
   Serial.printf("[%lu] [TRS] Saved page index cache: %d pages\n", millis(), totalPages);
 }
@@ -1,9 +1,7 @@
 #pragma once
 
 #include <Txt.h>
-#include <freertos/FreeRTOS.h>
-#include <freertos/semphr.h>
-#include <freertos/task.h>
+#include <TxtWrapper.h>
 
 #include <vector>
 
@@ -12,18 +10,15 @@
 
 class TxtReaderActivity final : public ActivityWithSubactivity {
   std::unique_ptr<Txt> txt;
-  TaskHandle_t displayTaskHandle = nullptr;
-  SemaphoreHandle_t renderingMutex = nullptr;
   int currentPage = 0;
   int totalPages = 1;
   int pagesUntilFullRefresh = 0;
-  bool updateRequired = false;
   const std::function<void()> onGoBack;
   const std::function<void()> onGoHome;
 
   // Streaming text reader - stores file offsets for each page
   std::vector<size_t> pageOffsets;  // File offset for start of each page
-  std::vector<std::string> currentPageLines;
+  std::vector<TxtLine> currentPageLines;  // Into the chunk the current page was loaded from
   int linesPerPage = 0;
   int viewportWidth = 0;
   bool initialized = false;
@@ -33,14 +28,13 @@ class TxtReaderActivity final : public ActivityWithSubactivity {
   int cachedScreenMargin = 0;
   uint8_t cachedParagraphAlignment = CrossPointSettings::LEFT_ALIGN;
 
-  static void taskTrampoline(void* param);
-  [[noreturn]] void displayTaskLoop();
-  void renderScreen();
-  void renderPage();
+  void render() override;
+  void renderPage(uint8_t* text);
   void renderStatusBar(int orientedMarginRight, int orientedMarginBottom, int orientedMarginLeft) const;
 
   void initializeReader();
-  bool loadPageAtOffset(size_t offset, std::vector<std::string>& outLines, size_t& nextOffset);
+  // Reads the chunk at offset into buffer (a chunk and its terminator) and wraps the page starting there
+  bool loadPageAtOffset(size_t offset, uint8_t* buffer, std::vector<TxtLine>& outLines, size_t& nextOffset);
   void buildPageIndex();
   bool loadPageIndexCache();
   void savePageIndexCache() const;
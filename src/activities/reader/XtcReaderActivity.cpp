@@ -11,8 +11,11 @@
 #include <GfxRenderer.h>
 #include <SDCardManager.h>
 
+#include <algorithm>
+
 #include "CrossPointSettings.h"
 #include "CrossPointState.h"
+#include "LibraryIndex.h"
 #include "MappedInputManager.h"
 #include "RecentBooksStore.h"
 #include "XtcReaderChapterSelectionActivity.h"
@@ -21,13 +24,10 @@
 namespace {
 constexpr unsigned long skipPageMs = 700;
 constexpr unsigned long goHomeMs = 1000;
+// Read size while streaming a page into the frame buffer
+constexpr size_t PAGE_CHUNK_SIZE = 4096;
 }  // namespace
 
-void XtcReaderActivity::taskTrampoline(void* param) {
-  auto* self = static_cast<XtcReaderActivity*>(param);
-  self->displayTaskLoop();
-}
-
 void XtcReaderActivity::onEnter() {
   ActivityWithSubactivity::onEnter();
 
@@ -35,10 +35,13 @@ void XtcReaderActivity::onEnter() {
     return;
   }
 
-  renderingMutex = xSemaphoreCreateMutex();
-
   xtc->setupCacheDir();
 
+  // Compressed pages are kept in memory: every pass of a page reads the card once, and the next page is read ahead
+  if (!xtc->enablePageCache()) {
+    Serial.printf("[%lu] [XTR] No page cache, pages are read from the card every time\n", millis());
+  }
+
   // Load saved progress
   loadProgress();
 
@@ -48,27 +51,17 @@ void XtcReaderActivity::onEnter() {
   RECENT_BOOKS.addBook(xtc->getPath(), xtc->getTitle(), xtc->getAuthor());
 
   // Trigger first update
-  updateRequired = true;
-
-  xTaskCreate(&XtcReaderActivity::taskTrampoline, "XtcReaderActivityTask",
-              4096,               // Stack size (smaller than EPUB since no parsing needed)
-              this,               // Parameters
-              1,                  // Priority
-              &displayTaskHandle  // Task handle
-  );
+  requestUpdate();
 }
 
 void XtcReaderActivity::onExit() {
   ActivityWithSubactivity::onExit();
 
-  // Wait until not rendering to delete task
-  xSemaphoreTake(renderingMutex, portMAX_DELAY);
-  if (displayTaskHandle) {
-    vTaskDelete(displayTaskHandle);
-    displayTaskHandle = nullptr;
+  if (xtc && xtc->getPageCount() > 0) {
+    const uint32_t page = std::min<uint32_t>(currentPage + 1, xtc->getPageCount());
+    LIBRARY_INDEX.updateProgress(xtc->getPath(), static_cast<uint8_t>(page * 100 / xtc->getPageCount()));
   }
-  vSemaphoreDelete(renderingMutex);
-  renderingMutex = nullptr;
+
   xtc.reset();
 }
 
@@ -80,23 +73,21 @@ void XtcReaderActivity::loop() {
   }
 
   // Enter chapter selection activity
-  if (mappedInput.wasReleased(MappedInputManager::Button::Confirm)) {
-    if (xtc && xtc->hasChapters() && !xtc->getChapters().empty()) {
-      xSemaphoreTake(renderingMutex, portMAX_DELAY);
+  if (mappedInput.wasReleased(MappedInputManager::Button::Confirm) && xtc) {
+    // The chapters are counted from the file on first use, which the render task may be reading
+    RENDER_SERVICE.lock();
+    if (xtc->hasChapters()) {
       exitActivity();
       enterNewActivity(new XtcReaderChapterSelectionActivity(
           this->renderer, this->mappedInput, xtc, currentPage,
-          [this] {
-            exitActivity();
-            updateRequired = true;
-          },
+          [this] { exitActivity(); },
           [this](const uint32_t newPage) {
             currentPage = newPage;
+            pageToPrefetch = NO_PAGE;
             exitActivity();
-            updateRequired = true;
           }));
-      xSemaphoreGive(renderingMutex);
     }
+    RENDER_SERVICE.unlock();
   }
 
   // Long press BACK (1s+) goes directly to home
@@ -126,48 +117,41 @@ void XtcReaderActivity::loop() {
                                     mappedInput.wasReleased(MappedInputManager::Button::Right));
 
   if (!prevTriggered && !nextTriggered) {
+    prefetchWhenIdle();
     return;
   }
 
+  // The page read ahead was picked for the page being left
+  pageToPrefetch = NO_PAGE;
+
   // Handle end of book
   if (currentPage >= xtc->getPageCount()) {
     currentPage = xtc->getPageCount() - 1;
-    updateRequired = true;
+    requestUpdate();
     return;
   }
 
   const bool skipPages = SETTINGS.longPressChapterSkip && mappedInput.getHeldTime() > skipPageMs;
   const int skipAmount = skipPages ? 10 : 1;
 
+  readingForward = !prevTriggered;
   if (prevTriggered) {
     if (currentPage >= static_cast<uint32_t>(skipAmount)) {
       currentPage -= skipAmount;
     } else {
       currentPage = 0;
     }
-    updateRequired = true;
+    requestUpdate();
   } else if (nextTriggered) {
     currentPage += skipAmount;
     if (currentPage >= xtc->getPageCount()) {
       currentPage = xtc->getPageCount();  // Allow showing "End of book"
     }
-    updateRequired = true;
-  }
-}
-
-void XtcReaderActivity::displayTaskLoop() {
-  while (true) {
-    if (updateRequired) {
-      updateRequired = false;
-      xSemaphoreTake(renderingMutex, portMAX_DELAY);
-      renderScreen();
-      xSemaphoreGive(renderingMutex);
-    }
-    vTaskDelay(10 / portTICK_PERIOD_MS);
+    requestUpdate();
   }
 }
 
-void XtcReaderActivity::renderScreen() {
+void XtcReaderActivity::render() {
   if (!xtc) {
     return;
   }
@@ -183,6 +167,31 @@ void XtcReaderActivity::renderScreen() {
 
   renderPage();
   saveProgress();
+
+  // The page that most likely comes next, loop() reads it while the reader looks at this one
+  const uint32_t nextPage = readingForward ? currentPage + 1 : currentPage - 1;
+  pageToPrefetch = nextPage < xtc->getPageCount() ? nextPage : NO_PAGE;
+}
+
+void XtcReaderActivity::prefetchWhenIdle() {
+  if (pageToPrefetch == NO_PAGE || mappedInput.wasAnyPressed() || mappedInput.wasAnyReleased()) {
+    return;
+  }
+  for (const auto button : {MappedInputManager::Button::PageBack, MappedInputManager::Button::PageForward,
+                            MappedInputManager::Button::Left, MappedInputManager::Button::Right,
+                            MappedInputManager::Button::Back, MappedInputManager::Button::Power}) {
+    if (mappedInput.isPressed(button)) {
+      return;
+    }
+  }
+
+  // The render task reads the same file, a frame requested meanwhile waits for this one page read
+  RENDER_SERVICE.lock();
+  const uint32_t page = pageToPrefetch.exchange(NO_PAGE);
+  if (page != NO_PAGE) {
+    xtc->prefetchPage(page);
+  }
+  RENDER_SERVICE.unlock();
 }
 
 void XtcReaderActivity::renderPage() {
@@ -190,181 +199,88 @@ void XtcReaderActivity::renderPage() {
   const uint16_t pageHeight = xtc->getPageHeight();
   const uint8_t bitDepth = xtc->getBitDepth();
 
-  // Calculate buffer size for one page
-  // XTG (1-bit): Row-major, ((width+7)/8) * height bytes
-  // XTH (2-bit): Two bit planes, column-major, ((width * height + 7) / 8) * 2 bytes
-  size_t pageBufferSize;
-  if (bitDepth == 2) {
-    pageBufferSize = ((static_cast<size_t>(pageWidth) * pageHeight + 7) / 8) * 2;
-  } else {
-    pageBufferSize = ((pageWidth + 7) / 8) * pageHeight;
+  if (!xtc::PageBlitter::canBlit(pageWidth, pageHeight, bitDepth)) {
+    Serial.printf("[%lu] [XTR] Unsupported page layout %ux%u (%u-bit)\n", millis(), pageWidth, pageHeight, bitDepth);
+    renderPageError("Unsupported page size");
+    return;
   }
 
-  // Allocate page buffer
-  uint8_t* pageBuffer = static_cast<uint8_t*>(malloc(pageBufferSize));
-  if (!pageBuffer) {
-    Serial.printf("[%lu] [XTR] Failed to allocate page buffer (%lu bytes)\n", millis(), pageBufferSize);
-    renderer.clearScreen();
-    renderer.drawCenteredText(UI_12_FONT_ID, 300, "Memory error", true, EpdFontFamily::BOLD);
-    renderer.displayBuffer();
+  // XTC/XTCH pages are pre-rendered with status bar included. Every pass streams the page from the card straight
+  // into the frame buffer, nothing the size of a page is allocated.
+  renderer.clearScreen();
+  if (!blitPage(xtc::PageBlitter::Target::Bw)) {
+    renderPageError("Page load error");
     return;
   }
 
-  // Load page data
-  size_t bytesRead = xtc->loadPage(currentPage, pageBuffer, pageBufferSize);
-  if (bytesRead == 0) {
-    Serial.printf("[%lu] [XTR] Failed to load page %lu\n", millis(), currentPage);
-    free(pageBuffer);
-    renderer.clearScreen();
-    renderer.drawCenteredText(UI_12_FONT_ID, 300, "Page load error", true, EpdFontFamily::BOLD);
+  // XTC pages already have status bar pre-rendered, no need to add our own
+
+  // Display with appropriate refresh
+  if (pagesUntilFullRefresh <= 1) {
+    renderer.displayBuffer(HalDisplay::HALF_REFRESH);
+    pagesUntilFullRefresh = SETTINGS.getRefreshFrequency();
+  } else {
     renderer.displayBuffer();
-    return;
+    pagesUntilFullRefresh--;
   }
 
-  // Clear screen first
-  renderer.clearScreen();
-
-  // Copy page bitmap using GfxRenderer's drawPixel
-  // XTC/XTCH pages are pre-rendered with status bar included, so render full page
-  const uint16_t maxSrcY = pageHeight;
-
-  if (bitDepth == 2) {
-    // XTH 2-bit mode: Two bit planes, column-major order
-    // - Columns scanned right to left (x = width-1 down to 0)
-    // - 8 vertical pixels per byte (MSB = topmost pixel in group)
-    // - First plane: Bit1, Second plane: Bit2
-    // - Pixel value = (bit1 << 1) | bit2
-    // - Grayscale: 0=White, 1=Dark Grey, 2=Light Grey, 3=Black
-
-    const size_t planeSize = (static_cast<size_t>(pageWidth) * pageHeight + 7) / 8;
-    const uint8_t* plane1 = pageBuffer;              // Bit1 plane
-    const uint8_t* plane2 = pageBuffer + planeSize;  // Bit2 plane
-    const size_t colBytes = (pageHeight + 7) / 8;    // Bytes per column (100 for 800 height)
-
-    // Lambda to get pixel value at (x, y)
-    auto getPixelValue = [&](uint16_t x, uint16_t y) -> uint8_t {
-      const size_t colIndex = pageWidth - 1 - x;
-      const size_t byteInCol = y / 8;
-      const size_t bitInByte = 7 - (y % 8);
-      const size_t byteOffset = colIndex * colBytes + byteInCol;
-      const uint8_t bit1 = (plane1[byteOffset] >> bitInByte) & 1;
-      const uint8_t bit2 = (plane2[byteOffset] >> bitInByte) & 1;
-      return (bit1 << 1) | bit2;
-    };
-
-    // Optimized grayscale rendering without storeBwBuffer (saves 48KB peak memory)
-    // Flow: BW display → LSB/MSB passes → grayscale display → re-render BW for next frame
-
-    // Count pixel distribution for debugging
-    uint32_t pixelCounts[4] = {0, 0, 0, 0};
-    for (uint16_t y = 0; y < pageHeight; y++) {
-      for (uint16_t x = 0; x < pageWidth; x++) {
-        pixelCounts[getPixelValue(x, y)]++;
-      }
-    }
-    Serial.printf("[%lu] [XTR] Pixel distribution: White=%lu, DarkGrey=%lu, LightGrey=%lu, Black=%lu\n", millis(),
-                  pixelCounts[0], pixelCounts[1], pixelCounts[2], pixelCounts[3]);
-
-    // Pass 1: BW buffer - draw all non-white pixels as black
-    for (uint16_t y = 0; y < pageHeight; y++) {
-      for (uint16_t x = 0; x < pageWidth; x++) {
-        if (getPixelValue(x, y) >= 1) {
-          renderer.drawPixel(x, y, true);
-        }
-      }
-    }
+  if (bitDepth != 2) {
+    Serial.printf("[%lu] [XTR] Rendered page %lu/%lu (%u-bit)\n", millis(), currentPage + 1, xtc->getPageCount(),
+                  bitDepth);
+    return;
+  }
 
-    // Display BW with conditional refresh based on pagesUntilFullRefresh
-    if (pagesUntilFullRefresh <= 1) {
-      renderer.displayBuffer(HalDisplay::HALF_REFRESH);
-      pagesUntilFullRefresh = SETTINGS.getRefreshFrequency();
-    } else {
-      renderer.displayBuffer();
-      pagesUntilFullRefresh--;
-    }
+  // XTH grayscale without storeBwBuffer (saves 48KB peak memory)
+  // Flow: BW display → LSB/MSB passes → grayscale display → re-render BW for next frame
+  // In LUT: 0 bit = apply gray effect, 1 bit = untouched
 
-    // Pass 2: LSB buffer - mark DARK gray only (XTH value 1)
-    // In LUT: 0 bit = apply gray effect, 1 bit = untouched
-    renderer.clearScreen(0x00);
-    for (uint16_t y = 0; y < pageHeight; y++) {
-      for (uint16_t x = 0; x < pageWidth; x++) {
-        if (getPixelValue(x, y) == 1) {  // Dark grey only
-          renderer.drawPixel(x, y, false);
-        }
-      }
-    }
-    renderer.copyGrayscaleLsbBuffers();
+  // LSB buffer - mark DARK gray only (XTH value 1)
+  renderer.clearScreen(0x00);
+  bool grayLoaded = blitPage(xtc::PageBlitter::Target::GrayscaleLsb);
+  renderer.copyGrayscaleLsbBuffers();
 
-    // Pass 3: MSB buffer - mark LIGHT AND DARK gray (XTH value 1 or 2)
-    // In LUT: 0 bit = apply gray effect, 1 bit = untouched
+  // MSB buffer - mark LIGHT AND DARK gray (XTH value 1 or 2)
+  if (grayLoaded) {
     renderer.clearScreen(0x00);
-    for (uint16_t y = 0; y < pageHeight; y++) {
-      for (uint16_t x = 0; x < pageWidth; x++) {
-        const uint8_t pv = getPixelValue(x, y);
-        if (pv == 1 || pv == 2) {  // Dark grey or Light grey
-          renderer.drawPixel(x, y, false);
-        }
-      }
-    }
+    grayLoaded = blitPage(xtc::PageBlitter::Target::GrayscaleMsb);
     renderer.copyGrayscaleMsbBuffers();
+  }
 
-    // Display grayscale overlay
+  // Display grayscale overlay, a page that could not be read again keeps its BW rendering
+  if (grayLoaded) {
     renderer.displayGrayBuffer();
-
-    // Pass 4: Re-render BW to framebuffer (restore for next frame, instead of restoreBwBuffer)
-    renderer.clearScreen();
-    for (uint16_t y = 0; y < pageHeight; y++) {
-      for (uint16_t x = 0; x < pageWidth; x++) {
-        if (getPixelValue(x, y) >= 1) {
-          renderer.drawPixel(x, y, true);
-        }
-      }
-    }
-
-    // Cleanup grayscale buffers with current frame buffer
-    renderer.cleanupGrayscaleWithFrameBuffer();
-
-    free(pageBuffer);
-
-    Serial.printf("[%lu] [XTR] Rendered page %lu/%lu (2-bit grayscale)\n", millis(), currentPage + 1,
-                  xtc->getPageCount());
-    return;
-  } else {
-    // 1-bit mode: 8 pixels per byte, MSB first
-    const size_t srcRowBytes = (pageWidth + 7) / 8;  // 60 bytes for 480 width
-
-    for (uint16_t srcY = 0; srcY < maxSrcY; srcY++) {
-      const size_t srcRowStart = srcY * srcRowBytes;
-
-      for (uint16_t srcX = 0; srcX < pageWidth; srcX++) {
-        // Read source pixel (MSB first, bit 7 = leftmost pixel)
-        const size_t srcByte = srcRowStart + srcX / 8;
-        const size_t srcBit = 7 - (srcX % 8);
-        const bool isBlack = !((pageBuffer[srcByte] >> srcBit) & 1);  // XTC: 0 = black, 1 = white
-
-        if (isBlack) {
-          renderer.drawPixel(srcX, srcY, true);
-        }
-      }
-    }
   }
-  // White pixels are already cleared by clearScreen()
 
-  free(pageBuffer);
+  // Re-render BW to framebuffer (restore for next frame, instead of restoreBwBuffer)
+  renderer.clearScreen();
+  blitPage(xtc::PageBlitter::Target::Bw);
 
-  // XTC pages already have status bar pre-rendered, no need to add our own
+  // Cleanup grayscale buffers with current frame buffer
+  renderer.cleanupGrayscaleWithFrameBuffer();
 
-  // Display with appropriate refresh
-  if (pagesUntilFullRefresh <= 1) {
-    renderer.displayBuffer(HalDisplay::HALF_REFRESH);
-    pagesUntilFullRefresh = SETTINGS.getRefreshFrequency();
-  } else {
-    renderer.displayBuffer();
-    pagesUntilFullRefresh--;
+  Serial.printf("[%lu] [XTR] Rendered page %lu/%lu (2-bit grayscale)\n", millis(), currentPage + 1,
+                xtc->getPageCount());
+}
+
+bool XtcReaderActivity::blitPage(const xtc::PageBlitter::Target target) {
+  xtc::PageBlitter blitter(renderer.getFrameBuffer(), xtc->getPageWidth(), xtc->getPageHeight(), xtc->getBitDepth(),
+                           target);
+  const xtc::XtcError error = xtc->loadPageStreaming(
+      currentPage,
+      [&blitter](const uint8_t* data, const size_t size, const size_t offset) { blitter.addChunk(data, size, offset); },
+      PAGE_CHUNK_SIZE);
+  if (error != xtc::XtcError::OK) {
+    Serial.printf("[%lu] [XTR] Failed to load page %lu: %s\n", millis(), currentPage, xtc::errorToString(error));
+    return false;
   }
+  blitter.finish();
+  return true;
+}
 
-  Serial.printf("[%lu] [XTR] Rendered page %lu/%lu (%u-bit)\n", millis(), currentPage + 1, xtc->getPageCount(),
-                bitDepth);
+void XtcReaderActivity::renderPageError(const char* message) {
+  renderer.clearScreen();
+  renderer.drawCenteredText(UI_12_FONT_ID, 300, message, true, EpdFontFamily::BOLD);
+  renderer.displayBuffer();
 }
 
 void XtcReaderActivity::saveProgress() const {
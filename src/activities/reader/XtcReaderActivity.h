@@ -8,28 +8,32 @@
 #pragma once
 
 #include <Xtc.h>
-#include <freertos/FreeRTOS.h>
-#include <freertos/semphr.h>
-#include <freertos/task.h>
+#include <Xtc/XtcPageBlitter.h>
+
+#include <atomic>
 
 #include "activities/ActivityWithSubactivity.h"
 
 class XtcReaderActivity final : public ActivityWithSubactivity {
   std::shared_ptr<Xtc> xtc;
-  TaskHandle_t displayTaskHandle = nullptr;
-  SemaphoreHandle_t renderingMutex = nullptr;
   uint32_t currentPage = 0;
   int pagesUntilFullRefresh = 0;
-  bool updateRequired = false;
+  bool readingForward = true;  // Direction of the last page turn, the page read ahead follows it
+  // Set by render() once a page is shown, read ahead by loop() while no button is pressed
+  static constexpr uint32_t NO_PAGE = UINT32_MAX;
+  std::atomic<uint32_t> pageToPrefetch{NO_PAGE};
   const std::function<void()> onGoBack;
   const std::function<void()> onGoHome;
 
-  static void taskTrampoline(void* param);
-  [[noreturn]] void displayTaskLoop();
-  void renderScreen();
+  void render() override;
   void renderPage();
+  // Streams the current page into the frame buffer, false if it could not be read
+  bool blitPage(xtc::PageBlitter::Target target);
+  void renderPageError(const char* message);
   void saveProgress() const;
   void loadProgress();
+  // Reads pageToPrefetch into the page cache unless input is waiting
+  void prefetchWhenIdle();
 
  public:
   explicit XtcReaderActivity(GfxRenderer& renderer, MappedInputManager& mappedInput, std::unique_ptr<Xtc> xtc,
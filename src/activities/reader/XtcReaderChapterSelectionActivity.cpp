@@ -29,20 +29,16 @@ int XtcReaderChapterSelectionActivity::findChapterIndexForPage(uint32_t page) co
     return 0;
   }
 
-  const auto& chapters = xtc->getChapters();
-  for (size_t i = 0; i < chapters.size(); i++) {
-    if (page >= chapters[i].startPage && page <= chapters[i].endPage) {
-      return static_cast<int>(i);
+  const uint16_t count = xtc->getChapterCount();
+  xtc::ChapterInfo chapter;
+  for (uint16_t i = 0; i < count && xtc->getChapter(i, chapter); i++) {
+    if (page >= chapter.startPage && page <= chapter.endPage) {
+      return i;
     }
   }
   return 0;
 }
 
-void XtcReaderChapterSelectionActivity::taskTrampoline(void* param) {
-  auto* self = static_cast<XtcReaderChapterSelectionActivity*>(param);
-  self->displayTaskLoop();
-}
-
 void XtcReaderChapterSelectionActivity::onEnter() {
   Activity::onEnter();
 
@@ -50,28 +46,9 @@ void XtcReaderChapterSelectionActivity::onEnter() {
     return;
   }
 
-  renderingMutex = xSemaphoreCreateMutex();
   selectorIndex = findChapterIndexForPage(currentPage);
 
-  updateRequired = true;
-  xTaskCreate(&XtcReaderChapterSelectionActivity::taskTrampoline, "XtcReaderChapterSelectionActivityTask",
-              4096,               // Stack size
-              this,               // Parameters
-              1,                  // Priority
-              &displayTaskHandle  // Task handle
-  );
-}
-
-void XtcReaderChapterSelectionActivity::onExit() {
-  Activity::onExit();
-
-  xSemaphoreTake(renderingMutex, portMAX_DELAY);
-  if (displayTaskHandle) {
-    vTaskDelete(displayTaskHandle);
-    displayTaskHandle = nullptr;
-  }
-  vSemaphoreDelete(renderingMutex);
-  renderingMutex = nullptr;
+  requestUpdate();
 }
 
 void XtcReaderChapterSelectionActivity::loop() {
@@ -84,14 +61,18 @@ void XtcReaderChapterSelectionActivity::loop() {
   const int pageItems = getPageItems();
 
   if (mappedInput.wasReleased(MappedInputManager::Button::Confirm)) {
-    const auto& chapters = xtc->getChapters();
-    if (!chapters.empty() && selectorIndex >= 0 && selectorIndex < static_cast<int>(chapters.size())) {
-      onSelectPage(chapters[selectorIndex].startPage);
+    // Chapters are read from the file, which the render task may be reading
+    xtc::ChapterInfo chapter;
+    RENDER_SERVICE.lock();
+    const bool found = selectorIndex >= 0 && xtc->getChapter(selectorIndex, chapter);
+    RENDER_SERVICE.unlock();
+    if (found) {
+      onSelectPage(chapter.startPage);
     }
   } else if (mappedInput.wasReleased(MappedInputManager::Button::Back)) {
     onGoBack();
   } else if (prevReleased) {
-    const int total = static_cast<int>(xtc->getChapters().size());
+    const int total = xtc->getChapterCount();
     if (total == 0) {
       return;
     }
@@ -100,9 +81,9 @@ void XtcReaderChapterSelectionActivity::loop() {
     } else {
       selectorIndex = (selectorIndex + total - 1) % total;
     }
-    updateRequired = true;
+    requestUpdate();
   } else if (nextReleased) {
-    const int total = static_cast<int>(xtc->getChapters().size());
+    const int total = xtc->getChapterCount();
     if (total == 0) {
       return;
     }
@@ -111,31 +92,19 @@ void XtcReaderChapterSelectionActivity::loop() {
     } else {
       selectorIndex = (selectorIndex + 1) % total;
     }
-    updateRequired = true;
-  }
-}
-
-void XtcReaderChapterSelectionActivity::displayTaskLoop() {
-  while (true) {
-    if (updateRequired) {
-      updateRequired = false;
-      xSemaphoreTake(renderingMutex, portMAX_DELAY);
-      renderScreen();
-      xSemaphoreGive(renderingMutex);
-    }
-    vTaskDelay(10 / portTICK_PERIOD_MS);
+    requestUpdate();
   }
 }
 
-void XtcReaderChapterSelectionActivity::renderScreen() {
+void XtcReaderChapterSelectionActivity::render() {
   renderer.clearScreen();
 
   const auto pageWidth = renderer.getScreenWidth();
   const int pageItems = getPageItems();
   renderer.drawCenteredText(UI_12_FONT_ID, 15, "Select Chapter", true, EpdFontFamily::BOLD);
 
-  const auto& chapters = xtc->getChapters();
-  if (chapters.empty()) {
+  const int total = xtc->getChapterCount();
+  if (total == 0) {
     renderer.drawCenteredText(UI_10_FONT_ID, 120, "No chapters");
     renderer.displayBuffer();
     return;
@@ -143,8 +112,8 @@ void XtcReaderChapterSelectionActivity::renderScreen() {
 
   const auto pageStartIndex = selectorIndex / pageItems * pageItems;
   renderer.fillRect(0, 60 + (selectorIndex % pageItems) * 30 - 2, pageWidth - 1, 30);
-  for (int i = pageStartIndex; i < static_cast<int>(chapters.size()) && i < pageStartIndex + pageItems; i++) {
-    const auto& chapter = chapters[i];
+  xtc::ChapterInfo chapter;
+  for (int i = pageStartIndex; i < total && i < pageStartIndex + pageItems && xtc->getChapter(i, chapter); i++) {
     const char* title = chapter.name.empty() ? "Unnamed" : chapter.name.c_str();
     renderer.drawText(UI_10_FONT_ID, 20, 60 + (i % pageItems) * 30, title, i != selectorIndex);
   }
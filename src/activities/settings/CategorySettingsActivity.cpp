@@ -13,33 +13,10 @@
 #include "OtaUpdateActivity.h"
 #include "fontIds.h"
 
-void CategorySettingsActivity::taskTrampoline(void* param) {
-  auto* self = static_cast<CategorySettingsActivity*>(param);
-  self->displayTaskLoop();
-}
-
 void CategorySettingsActivity::onEnter() {
   Activity::onEnter();
-  renderingMutex = xSemaphoreCreateMutex();
-
   selectedSettingIndex = 0;
-  updateRequired = true;
-
-  xTaskCreate(&CategorySettingsActivity::taskTrampoline, "CategorySettingsActivityTask", 4096, this, 1,
-              &displayTaskHandle);
-}
-
-void CategorySettingsActivity::onExit() {
-  ActivityWithSubactivity::onExit();
-
-  // Wait until not rendering to delete task to avoid killing mid-instruction to EPD
-  xSemaphoreTake(renderingMutex, portMAX_DELAY);
-  if (displayTaskHandle) {
-    vTaskDelete(displayTaskHandle);
-    displayTaskHandle = nullptr;
-  }
-  vSemaphoreDelete(renderingMutex);
-  renderingMutex = nullptr;
+  requestUpdate();
 }
 
 void CategorySettingsActivity::loop() {
@@ -51,7 +28,7 @@ void CategorySettingsActivity::loop() {
   // Handle actions with early return
   if (mappedInput.wasPressed(MappedInputManager::Button::Confirm)) {
     toggleCurrentSetting();
-    updateRequired = true;
+    requestUpdate();
     return;
   }
 
@@ -65,11 +42,11 @@ void CategorySettingsActivity::loop() {
   if (mappedInput.wasPressed(MappedInputManager::Button::Up) ||
       mappedInput.wasPressed(MappedInputManager::Button::Left)) {
     selectedSettingIndex = (selectedSettingIndex > 0) ? (selectedSettingIndex - 1) : (settingsCount - 1);
-    updateRequired = true;
+    requestUpdate();
   } else if (mappedInput.wasPressed(MappedInputManager::Button::Down) ||
              mappedInput.wasPressed(MappedInputManager::Button::Right)) {
     selectedSettingIndex = (selectedSettingIndex < settingsCount - 1) ? (selectedSettingIndex + 1) : 0;
-    updateRequired = true;
+    requestUpdate();
   }
 }
 
@@ -96,37 +73,25 @@ void CategorySettingsActivity::toggleCurrentSetting() {
     }
   } else if (setting.type == SettingType::ACTION) {
     if (strcmp(setting.name, "KOReader Sync") == 0) {
-      xSemaphoreTake(renderingMutex, portMAX_DELAY);
+      RENDER_SERVICE.lock();
       exitActivity();
-      enterNewActivity(new KOReaderSettingsActivity(renderer, mappedInput, [this] {
-        exitActivity();
-        updateRequired = true;
-      }));
-      xSemaphoreGive(renderingMutex);
+      enterNewActivity(new KOReaderSettingsActivity(renderer, mappedInput, [this] { exitActivity(); }));
+      RENDER_SERVICE.unlock();
     } else if (strcmp(setting.name, "OPDS Browser") == 0) {
-      xSemaphoreTake(renderingMutex, portMAX_DELAY);
+      RENDER_SERVICE.lock();
       exitActivity();
-      enterNewActivity(new CalibreSettingsActivity(renderer, mappedInput, [this] {
-        exitActivity();
-        updateRequired = true;
-      }));
-      xSemaphoreGive(renderingMutex);
+      enterNewActivity(new CalibreSettingsActivity(renderer, mappedInput, [this] { exitActivity(); }));
+      RENDER_SERVICE.unlock();
     } else if (strcmp(setting.name, "Clear Cache") == 0) {
-      xSemaphoreTake(renderingMutex, portMAX_DELAY);
+      RENDER_SERVICE.lock();
       exitActivity();
-      enterNewActivity(new ClearCacheActivity(renderer, mappedInput, [this] {
-        exitActivity();
-        updateRequired = true;
-      }));
-      xSemaphoreGive(renderingMutex);
+      enterNewActivity(new ClearCacheActivity(renderer, mappedInput, [this] { exitActivity(); }));
+      RENDER_SERVICE.unlock();
     } else if (strcmp(setting.name, "Check for updates") == 0) {
-      xSemaphoreTake(renderingMutex, portMAX_DELAY);
+      RENDER_SERVICE.lock();
       exitActivity();
-      enterNewActivity(new OtaUpdateActivity(renderer, mappedInput, [this] {
-        exitActivity();
-        updateRequired = true;
-      }));
-      xSemaphoreGive(renderingMutex);
+      enterNewActivity(new OtaUpdateActivity(renderer, mappedInput, [this] { exitActivity(); }));
+      RENDER_SERVICE.unlock();
     }
   } else {
     return;
@@ -135,19 +100,12 @@ void CategorySettingsActivity::toggleCurrentSetting() {
   SETTINGS.saveToFile();
 }
 
-void CategorySettingsActivity::displayTaskLoop() {
-  while (true) {
-    if (updateRequired && !subActivity) {
-      updateRequired = false;
-      xSemaphoreTake(renderingMutex, portMAX_DELAY);
-      render();
-      xSemaphoreGive(renderingMutex);
-    }
-    vTaskDelay(10 / portTICK_PERIOD_MS);
+void CategorySettingsActivity::render() {
+  // The sub-activity draws the screen while it is open
+  if (subActivity) {
+    return;
   }
-}
 
-void CategorySettingsActivity::render() const {
   renderer.clearScreen();
 
   const auto pageWidth = renderer.getScreenWidth();
@@ -1,7 +1,4 @@
 #pragma once
-#include <freertos/FreeRTOS.h>
-#include <freertos/semphr.h>
-#include <freertos/task.h>
 
 #include <functional>
 #include <string>
@@ -42,18 +39,13 @@ struct SettingInfo {
 };
 
 class CategorySettingsActivity final : public ActivityWithSubactivity {
-  TaskHandle_t displayTaskHandle = nullptr;
-  SemaphoreHandle_t renderingMutex = nullptr;
-  bool updateRequired = false;
   int selectedSettingIndex = 0;
   const char* categoryName;
   const SettingInfo* settingsList;
   int settingsCount;
   const std::function<void()> onGoBack;
 
-  static void taskTrampoline(void* param);
-  [[noreturn]] void displayTaskLoop();
-  void render() const;
+  void render() override;
   void toggleCurrentSetting();
 
  public:
@@ -65,6 +57,5 @@ class CategorySettingsActivity final : public ActivityWithSubactivity {
         settingsCount(settingsCount),
         onGoBack(onGoBack) {}
   void onEnter() override;
-  void onExit() override;
   void loop() override;
 };
@@ -1,9 +1,5 @@
 #pragma once
 
-#include <freertos/FreeRTOS.h>
-#include <freertos/semphr.h>
-#include <freertos/task.h>
-
 #include <functional>
 
 #include "activities/ActivityWithSubactivity.h"
@@ -15,23 +11,17 @@ class ClearCacheActivity final : public ActivityWithSubactivity {
       : ActivityWithSubactivity("ClearCache", renderer, mappedInput), goBack(goBack) {}
 
   void onEnter() override;
-  void onExit() override;
   void loop() override;
 
  private:
   enum State { WARNING, CLEARING, SUCCESS, FAILED };
 
   State state = WARNING;
-  TaskHandle_t displayTaskHandle = nullptr;
-  SemaphoreHandle_t renderingMutex = nullptr;
-  bool updateRequired = false;
   const std::function<void()> goBack;
 
   int clearedCount = 0;
   int failedCount = 0;
 
-  static void taskTrampoline(void* param);
-  [[noreturn]] void displayTaskLoop();
-  void render();
+  void render() override;
   void clearCache();
 };
@@ -9,28 +9,23 @@
 #include "activities/network/WifiSelectionActivity.h"
 #include "fontIds.h"
 
-void KOReaderAuthActivity::taskTrampoline(void* param) {
-  auto* self = static_cast<KOReaderAuthActivity*>(param);
-  self->displayTaskLoop();
-}
-
 void KOReaderAuthActivity::onWifiSelectionComplete(const bool success) {
   exitActivity();
 
   if (!success) {
-    xSemaphoreTake(renderingMutex, portMAX_DELAY);
+    RENDER_SERVICE.lock();
     state = FAILED;
     errorMessage = "WiFi connection failed";
-    xSemaphoreGive(renderingMutex);
-    updateRequired = true;
+    RENDER_SERVICE.unlock();
+    requestUpdate();
     return;
   }
 
-  xSemaphoreTake(renderingMutex, portMAX_DELAY);
+  RENDER_SERVICE.lock();
   state = AUTHENTICATING;
   statusMessage = "Authenticating...";
-  xSemaphoreGive(renderingMutex);
-  updateRequired = true;
+  RENDER_SERVICE.unlock();
+  requestUpdate();
 
   performAuthentication();
 }
@@ -38,7 +33,7 @@ void KOReaderAuthActivity::onWifiSelectionComplete(const bool success) {
 void KOReaderAuthActivity::performAuthentication() {
   const auto result = KOReaderSyncClient::authenticate();
 
-  xSemaphoreTake(renderingMutex, portMAX_DELAY);
+  RENDER_SERVICE.lock();
   if (result == KOReaderSyncClient::OK) {
     state = SUCCESS;
     statusMessage = "Successfully authenticated!";
@@ -46,22 +41,13 @@ void KOReaderAuthActivity::performAuthentication() {
     state = FAILED;
     errorMessage = KOReaderSyncClient::errorString(result);
   }
-  xSemaphoreGive(renderingMutex);
-  updateRequired = true;
+  RENDER_SERVICE.unlock();
+  requestUpdate();
 }
 
 void KOReaderAuthActivity::onEnter() {
   ActivityWithSubactivity::onEnter();
 
-  renderingMutex = xSemaphoreCreateMutex();
-
-  xTaskCreate(&KOReaderAuthActivity::taskTrampoline, "KOAuthTask",
-              4096,               // Stack size
-              this,               // Parameters
-              1,                  // Priority
-              &displayTaskHandle  // Task handle
-  );
-
   // Turn on WiFi
   WiFi.mode(WIFI_STA);
 
@@ -69,7 +55,7 @@ void KOReaderAuthActivity::onEnter() {
   if (WiFi.status() == WL_CONNECTED) {
     state = AUTHENTICATING;
     statusMessage = "Authenticating...";
-    updateRequired = true;
+    requestUpdate();
 
     // Perform authentication in a separate task
     xTaskCreate(
@@ -95,26 +81,6 @@ void KOReaderAuthActivity::onExit() {
   delay(100);
   WiFi.mode(WIFI_OFF);
   delay(100);
-
-  xSemaphoreTake(renderingMutex, portMAX_DELAY);
-  if (displayTaskHandle) {
-    vTaskDelete(displayTaskHandle);
-    displayTaskHandle = nullptr;
-  }
-  vSemaphoreDelete(renderingMutex);
-  renderingMutex = nullptr;
-}
-
-void KOReaderAuthActivity::displayTaskLoop() {
-  while (true) {
-    if (updateRequired && !subActivity) {
-      updateRequired = false;
-      xSemaphoreTake(renderingMutex, portMAX_DELAY);
-      render();
-      xSemaphoreGive(renderingMutex);
-    }
-    vTaskDelay(10 / portTICK_PERIOD_MS);
-  }
 }
 
 void KOReaderAuthActivity::render() {
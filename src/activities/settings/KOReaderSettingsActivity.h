@@ -1,7 +1,4 @@
 #pragma once
-#include <freertos/FreeRTOS.h>
-#include <freertos/semphr.h>
-#include <freertos/task.h>
 
 #include <functional>
 
@@ -18,19 +15,13 @@ class KOReaderSettingsActivity final : public ActivityWithSubactivity {
       : ActivityWithSubactivity("KOReaderSettings", renderer, mappedInput), onBack(onBack) {}
 
   void onEnter() override;
-  void onExit() override;
   void loop() override;
 
  private:
-  TaskHandle_t displayTaskHandle = nullptr;
-  SemaphoreHandle_t renderingMutex = nullptr;
-  bool updateRequired = false;
 
   int selectedIndex = 0;
   const std::function<void()> onBack;
 
-  static void taskTrampoline(void* param);
-  [[noreturn]] void displayTaskLoop();
-  void render();
+  void render() override;
   void handleSelection();
 };
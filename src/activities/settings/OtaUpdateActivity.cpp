@@ -8,11 +8,6 @@
 #include "fontIds.h"
 #include "network/OtaUpdater.h"
 
-void OtaUpdateActivity::taskTrampoline(void* param) {
-  auto* self = static_cast<OtaUpdateActivity*>(param);
-  self->displayTaskLoop();
-}
-
 void OtaUpdateActivity::onWifiSelectionComplete(const bool success) {
   exitActivity();
 
@@ -24,48 +19,39 @@ void OtaUpdateActivity::onWifiSelectionComplete(const bool success) {
 
   Serial.printf("[%lu] [OTA] WiFi connected, checking for update\n", millis());
 
-  xSemaphoreTake(renderingMutex, portMAX_DELAY);
+  RENDER_SERVICE.lock();
   state = CHECKING_FOR_UPDATE;
-  xSemaphoreGive(renderingMutex);
-  updateRequired = true;
+  RENDER_SERVICE.unlock();
+  requestUpdate();
   vTaskDelay(10 / portTICK_PERIOD_MS);
   const auto res = updater.checkForUpdate();
   if (res != OtaUpdater::OK) {
     Serial.printf("[%lu] [OTA] Update check failed: %d\n", millis(), res);
-    xSemaphoreTake(renderingMutex, portMAX_DELAY);
+    RENDER_SERVICE.lock();
     state = FAILED;
-    xSemaphoreGive(renderingMutex);
-    updateRequired = true;
+    RENDER_SERVICE.unlock();
+    requestUpdate();
     return;
   }
 
   if (!updater.isUpdateNewer()) {
     Serial.printf("[%lu] [OTA] No new update available\n", millis());
-    xSemaphoreTake(renderingMutex, portMAX_DELAY);
+    RENDER_SERVICE.lock();
     state = NO_UPDATE;
-    xSemaphoreGive(renderingMutex);
-    updateRequired = true;
+    RENDER_SERVICE.unlock();
+    requestUpdate();
     return;
   }
 
-  xSemaphoreTake(renderingMutex, portMAX_DELAY);
+  RENDER_SERVICE.lock();
   state = WAITING_CONFIRMATION;
-  xSemaphoreGive(renderingMutex);
-  updateRequired = true;
+  RENDER_SERVICE.unlock();
+  requestUpdate();
 }
 
 void OtaUpdateActivity::onEnter() {
   ActivityWithSubactivity::onEnter();
 
-  renderingMutex = xSemaphoreCreateMutex();
-
-  xTaskCreate(&OtaUpdateActivity::taskTrampoline, "OtaUpdateActivityTask",
-              2048,               // Stack size
-              this,               // Parameters
-              1,                  // Priority
-              &displayTaskHandle  // Task handle
-  );
-
   // Turn on WiFi immediately
   Serial.printf("[%lu] [OTA] Turning on WiFi...\n", millis());
   WiFi.mode(WIFI_STA);
@@ -84,27 +70,6 @@ void OtaUpdateActivity::onExit() {
   delay(100);              // Allow disconnect frame to be sent
   WiFi.mode(WIFI_OFF);
   delay(100);  // Allow WiFi hardware to fully power down
-
-  // Wait until not rendering to delete task to avoid killing mid-instruction to EPD
-  xSemaphoreTake(renderingMutex, portMAX_DELAY);
-  if (displayTaskHandle) {
-    vTaskDelete(displayTaskHandle);
-    displayTaskHandle = nullptr;
-  }
-  vSemaphoreDelete(renderingMutex);
-  renderingMutex = nullptr;
-}
-
-void OtaUpdateActivity::displayTaskLoop() {
-  while (true) {
-    if (updateRequired || updater.getRender()) {
-      updateRequired = false;
-      xSemaphoreTake(renderingMutex, portMAX_DELAY);
-      render();
-      xSemaphoreGive(renderingMutex);
-    }
-    vTaskDelay(10 / portTICK_PERIOD_MS);
-  }
 }
 
 void OtaUpdateActivity::render() {
@@ -190,26 +155,26 @@ void OtaUpdateActivity::loop() {
   if (state == WAITING_CONFIRMATION) {
     if (mappedInput.wasPressed(MappedInputManager::Button::Confirm)) {
       Serial.printf("[%lu] [OTA] New update available, starting download...\n", millis());
-      xSemaphoreTake(renderingMutex, portMAX_DELAY);
+      RENDER_SERVICE.lock();
       state = UPDATE_IN_PROGRESS;
-      xSemaphoreGive(renderingMutex);
-      updateRequired = true;
+      RENDER_SERVICE.unlock();
+      requestUpdate();
       vTaskDelay(10 / portTICK_PERIOD_MS);
-      const auto res = updater.installUpdate();
+      const auto res = updater.installUpdate([this] { requestUpdate(RenderService::Priority::Background); });
 
       if (res != OtaUpdater::OK) {
         Serial.printf("[%lu] [OTA] Update failed: %d\n", millis(), res);
-        xSemaphoreTake(renderingMutex, portMAX_DELAY);
+        RENDER_SERVICE.lock();
         state = FAILED;
-        xSemaphoreGive(renderingMutex);
-        updateRequired = true;
+        RENDER_SERVICE.unlock();
+        requestUpdate();
         return;
       }
 
-      xSemaphoreTake(renderingMutex, portMAX_DELAY);
+      RENDER_SERVICE.lock();
       state = FINISHED;
-      xSemaphoreGive(renderingMutex);
-      updateRequired = true;
+      RENDER_SERVICE.unlock();
+      requestUpdate();
     }
 
     if (mappedInput.wasPressed(MappedInputManager::Button::Back)) {
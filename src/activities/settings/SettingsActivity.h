@@ -1,7 +1,4 @@
 #pragma once
-#include <freertos/FreeRTOS.h>
-#include <freertos/semphr.h>
-#include <freertos/task.h>
 
 #include <functional>
 #include <string>
@@ -13,18 +10,13 @@ class CrossPointSettings;
 struct SettingInfo;
 
 class SettingsActivity final : public ActivityWithSubactivity {
-  TaskHandle_t displayTaskHandle = nullptr;
-  SemaphoreHandle_t renderingMutex = nullptr;
-  bool updateRequired = false;
   int selectedCategoryIndex = 0;  // Currently selected category
   const std::function<void()> onGoHome;
 
   static constexpr int categoryCount = 4;
   static const char* categoryNames[categoryCount];
 
-  static void taskTrampoline(void* param);
-  [[noreturn]] void displayTaskLoop();
-  void render() const;
+  void render() override;
   void enterCategory(int categoryIndex);
 
  public:
@@ -32,6 +24,5 @@ class SettingsActivity final : public ActivityWithSubactivity {
                             const std::function<void()>& onGoHome)
       : ActivityWithSubactivity("Settings", renderer, mappedInput), onGoHome(onGoHome) {}
   void onEnter() override;
-  void onExit() override;
   void loop() override;
 };
@@ -13,50 +13,11 @@ const char* const KeyboardEntryActivity::keyboard[NUM_ROWS] = {
 const char* const KeyboardEntryActivity::keyboardShift[NUM_ROWS] = {"~!@#$%^&*()_+", "QWERTYUIOP{}|", "ASDFGHJKL:\"",
                                                                     "ZXCVBNM<>?", "SPECIAL ROW"};
 
-void KeyboardEntryActivity::taskTrampoline(void* param) {
-  auto* self = static_cast<KeyboardEntryActivity*>(param);
-  self->displayTaskLoop();
-}
-
-void KeyboardEntryActivity::displayTaskLoop() {
-  while (true) {
-    if (updateRequired) {
-      updateRequired = false;
-      xSemaphoreTake(renderingMutex, portMAX_DELAY);
-      render();
-      xSemaphoreGive(renderingMutex);
-    }
-    vTaskDelay(10 / portTICK_PERIOD_MS);
-  }
-}
-
 void KeyboardEntryActivity::onEnter() {
   Activity::onEnter();
 
-  renderingMutex = xSemaphoreCreateMutex();
-
   // Trigger first update
-  updateRequired = true;
-
-  xTaskCreate(&KeyboardEntryActivity::taskTrampoline, "KeyboardEntryActivity",
-              2048,               // Stack size
-              this,               // Parameters
-              1,                  // Priority
-              &displayTaskHandle  // Task handle
-  );
-}
-
-void KeyboardEntryActivity::onExit() {
-  Activity::onExit();
-
-  // Wait until not rendering to delete task to avoid killing mid-instruction to EPD
-  xSemaphoreTake(renderingMutex, portMAX_DELAY);
-  if (displayTaskHandle) {
-    vTaskDelete(displayTaskHandle);
-    displayTaskHandle = nullptr;
-  }
-  vSemaphoreDelete(renderingMutex);
-  renderingMutex = nullptr;
+  requestUpdate();
 }
 
 int KeyboardEntryActivity::getRowLength(const int row) const {
@@ -88,13 +49,13 @@ char KeyboardEntryActivity::getSelectedChar() const {
   return layout[selectedRow][selectedCol];
 }
 
-void KeyboardEntryActivity::handleKeyPress() {
+bool KeyboardEntryActivity::handleKeyPress() {
   // Handle special row (bottom row with shift, space, backspace, done)
   if (selectedRow == SPECIAL_ROW) {
     if (selectedCol >= SHIFT_COL && selectedCol < SPACE_COL) {
       // Shift toggle
       shiftActive = !shiftActive;
-      return;
+      return true;
     }
 
     if (selectedCol >= SPACE_COL && selectedCol < BACKSPACE_COL) {
@@ -102,7 +63,7 @@ void KeyboardEntryActivity::handleKeyPress() {
       if (maxLength == 0 || text.length() < maxLength) {
         text += ' ';
       }
-      return;
+      return true;
     }
 
     if (selectedCol >= BACKSPACE_COL && selectedCol < DONE_COL) {
@@ -110,7 +71,7 @@ void KeyboardEntryActivity::handleKeyPress() {
       if (!text.empty()) {
         text.pop_back();
       }
-      return;
+      return true;
     }
 
     if (selectedCol >= DONE_COL) {
@@ -118,14 +79,14 @@ void KeyboardEntryActivity::handleKeyPress() {
       if (onComplete) {
         onComplete(text);
       }
-      return;
+      return false;
     }
   }
 
   // Regular character
   const char c = getSelectedChar();
   if (c == '\0') {
-    return;
+    return true;
   }
 
   if (maxLength == 0 || text.length() < maxLength) {
@@ -135,6 +96,7 @@ void KeyboardEntryActivity::handleKeyPress() {
       shiftActive = false;
     }
   }
+  return true;
 }
 
 void KeyboardEntryActivity::loop() {
@@ -151,7 +113,7 @@ void KeyboardEntryActivity::loop() {
       const int maxCol = getRowLength(selectedRow) - 1;
       if (selectedCol > maxCol) selectedCol = maxCol;
     }
-    updateRequired = true;
+    requestUpdate();
   }
 
   if (mappedInput.wasPressed(MappedInputManager::Button::Down)) {
@@ -165,7 +127,7 @@ void KeyboardEntryActivity::loop() {
       const int maxCol = getRowLength(selectedRow) - 1;
       if (selectedCol > maxCol) selectedCol = maxCol;
     }
-    updateRequired = true;
+    requestUpdate();
   }
 
   if (mappedInput.wasPressed(MappedInputManager::Button::Left)) {
@@ -187,7 +149,7 @@ void KeyboardEntryActivity::loop() {
         // At done button, move to backspace
         selectedCol = BACKSPACE_COL;
       }
-      updateRequired = true;
+      requestUpdate();
       return;
     }
 
@@ -197,7 +159,7 @@ void KeyboardEntryActivity::loop() {
       // Wrap to end of current row
       selectedCol = maxCol;
     }
-    updateRequired = true;
+    requestUpdate();
   }
 
   if (mappedInput.wasPressed(MappedInputManager::Button::Right)) {
@@ -219,7 +181,7 @@ void KeyboardEntryActivity::loop() {
         // At done button, wrap to beginning of row
         selectedCol = SHIFT_COL;
       }
-      updateRequired = true;
+      requestUpdate();
       return;
     }
 
@@ -229,25 +191,29 @@ void KeyboardEntryActivity::loop() {
       // Wrap to beginning of current row
       selectedCol = 0;
     }
-    updateRequired = true;
+    requestUpdate();
   }
 
   // Selection
   if (mappedInput.wasPressed(MappedInputManager::Button::Confirm)) {
-    handleKeyPress();
-    updateRequired = true;
+    if (!handleKeyPress()) {
+      return;
+    }
+    requestUpdate();
   }
 
   // Cancel
   if (mappedInput.wasPressed(MappedInputManager::Button::Back)) {
     if (onCancel) {
+      // Owners close this activity from the callback, it must not be touched afterwards
       onCancel();
+      return;
     }
-    updateRequired = true;
+    requestUpdate();
   }
 }
 
-void KeyboardEntryActivity::render() const {
+void KeyboardEntryActivity::render() {
   const auto pageWidth = renderer.getScreenWidth();
 
   renderer.clearScreen();
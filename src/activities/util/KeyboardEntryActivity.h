@@ -1,8 +1,5 @@
 #pragma once
 #include <GfxRenderer.h>
-#include <freertos/FreeRTOS.h>
-#include <freertos/semphr.h>
-#include <freertos/task.h>
 
 #include <functional>
 #include <string>
@@ -54,7 +51,6 @@ class KeyboardEntryActivity : public Activity {
 
   // Activity overrides
   void onEnter() override;
-  void onExit() override;
   void loop() override;
 
  private:
@@ -63,9 +59,6 @@ class KeyboardEntryActivity : public Activity {
   std::string text;
   size_t maxLength;
   bool isPassword;
-  TaskHandle_t displayTaskHandle = nullptr;
-  SemaphoreHandle_t renderingMutex = nullptr;
-  bool updateRequired = false;
 
   // Keyboard state
   int selectedRow = 0;
@@ -89,11 +82,10 @@ class KeyboardEntryActivity : public Activity {
   static constexpr int BACKSPACE_COL = 7;
   static constexpr int DONE_COL = 9;
 
-  static void taskTrampoline(void* param);
-  [[noreturn]] void displayTaskLoop();
   char getSelectedChar() const;
-  void handleKeyPress();
+  // False once Done handed the text to onComplete, which may have closed this activity
+  bool handleKeyPress();
   int getRowLength(int row) const;
-  void render() const;
+  void render() override;
   void renderItemWithSelector(int x, int y, const char* item, bool isSelected) const;
 };
@@ -1,8 +1,12 @@
 #include <Arduino.h>
+#include <BootTimeline.h>
+#include <BufferPool.h>
 #include <Epub.h>
 #include <GfxRenderer.h>
 #include <HalDisplay.h>
 #include <HalGPIO.h>
+#include <Logging.h>
+#include <MemStats.h>
 #include <SDCardManager.h>
 #include <SPI.h>
 #include <builtinFonts/all.h>
@@ -15,14 +19,18 @@
 #include "KOReaderCredentialStore.h"
 #include "MappedInputManager.h"
 #include "RecentBooksStore.h"
+#include "RenderService.h"
+#include "ResumeSnapshot.h"
 #include "activities/boot_sleep/BootActivity.h"
 #include "activities/boot_sleep/SleepActivity.h"
-#include "activities/browser/OpdsBookBrowserActivity.h"
 #include "activities/home/HomeActivity.h"
 #include "activities/home/MyLibraryActivity.h"
-#include "activities/network/CrossPointWebServerActivity.h"
 #include "activities/reader/ReaderActivity.h"
+#if CROSSPOINT_EMULATED == 0
+#include "activities/browser/OpdsBookBrowserActivity.h"
+#include "activities/network/CrossPointWebServerActivity.h"
 #include "activities/settings/SettingsActivity.h"
+#endif
 #include "activities/util/FullScreenMessageActivity.h"
 #include "activities/games/GamesMenuActivity.h"
 #include "activities/games/TicTacToeActivity.h"
@@ -38,94 +46,49 @@ MappedInputManager mappedInputManager(gpio);
 GfxRenderer renderer(display);
 Activity* currentActivity;
 
-// Fonts
-EpdFont bookerly14RegularFont(&bookerly_14_regular);
-EpdFont bookerly14BoldFont(&bookerly_14_bold);
-EpdFont bookerly14ItalicFont(&bookerly_14_italic);
-EpdFont bookerly14BoldItalicFont(&bookerly_14_bolditalic);
-EpdFontFamily bookerly14FontFamily(&bookerly14RegularFont, &bookerly14BoldFont, &bookerly14ItalicFont,
-                                   &bookerly14BoldItalicFont);
+// Fonts, each family is only built the first time the renderer looks its font id up
+#define FONT_FAMILY(name, data)                                                                                 \
+  const EpdFontFamily& name() {                                                                                \
+    static const EpdFont regular(&data##_regular), bold(&data##_bold), italic(&data##_italic),                 \
+        boldItalic(&data##_bolditalic);                                                                        \
+    static const EpdFontFamily family(&regular, &bold, &italic, &boldItalic);                                  \
+    return family;                                                                                             \
+  }
+
+FONT_FAMILY(bookerly14FontFamily, bookerly_14)
 #ifndef OMIT_FONTS
-EpdFont bookerly12RegularFont(&bookerly_12_regular);
-EpdFont bookerly12BoldFont(&bookerly_12_bold);
-EpdFont bookerly12ItalicFont(&bookerly_12_italic);
-EpdFont bookerly12BoldItalicFont(&bookerly_12_bolditalic);
-EpdFontFamily bookerly12FontFamily(&bookerly12RegularFont, &bookerly12BoldFont, &bookerly12ItalicFont,
-                                   &bookerly12BoldItalicFont);
-EpdFont bookerly16RegularFont(&bookerly_16_regular);
-EpdFont bookerly16BoldFont(&bookerly_16_bold);
-EpdFont bookerly16ItalicFont(&bookerly_16_italic);
-EpdFont bookerly16BoldItalicFont(&bookerly_16_bolditalic);
-EpdFontFamily bookerly16FontFamily(&bookerly16RegularFont, &bookerly16BoldFont, &bookerly16ItalicFont,
-                                   &bookerly16BoldItalicFont);
-EpdFont bookerly18RegularFont(&bookerly_18_regular);
-EpdFont bookerly18BoldFont(&bookerly_18_bold);
-EpdFont bookerly18ItalicFont(&bookerly_18_italic);
-EpdFont bookerly18BoldItalicFont(&bookerly_18_bolditalic);
-EpdFontFamily bookerly18FontFamily(&bookerly18RegularFont, &bookerly18BoldFont, &bookerly18ItalicFont,
-                                   &bookerly18BoldItalicFont);
-
-EpdFont notosans12RegularFont(&notosans_12_regular);
-EpdFont notosans12BoldFont(&notosans_12_bold);
-EpdFont notosans12ItalicFont(&notosans_12_italic);
-EpdFont notosans12BoldItalicFont(&notosans_12_bolditalic);
-EpdFontFamily notosans12FontFamily(&notosans12RegularFont, &notosans12BoldFont, &notosans12ItalicFont,
-                                   &notosans12BoldItalicFont);
-EpdFont notosans14RegularFont(&notosans_14_regular);
-EpdFont notosans14BoldFont(&notosans_14_bold);
-EpdFont notosans14ItalicFont(&notosans_14_italic);
-EpdFont notosans14BoldItalicFont(&notosans_14_bolditalic);
-EpdFontFamily notosans14FontFamily(&notosans14RegularFont, &notosans14BoldFont, &notosans14ItalicFont,
-                                   &notosans14BoldItalicFont);
-EpdFont notosans16RegularFont(&notosans_16_regular);
-EpdFont notosans16BoldFont(&notosans_16_bold);
-EpdFont notosans16ItalicFont(&notosans_16_italic);
-EpdFont notosans16BoldItalicFont(&notosans_16_bolditalic);
-EpdFontFamily notosans16FontFamily(&notosans16RegularFont, &notosans16BoldFont, &notosans16ItalicFont,
-                                   &notosans16BoldItalicFont);
-EpdFont notosans18RegularFont(&notosans_18_regular);
-EpdFont notosans18BoldFont(&notosans_18_bold);
-EpdFont notosans18ItalicFont(&notosans_18_italic);
-EpdFont notosans18BoldItalicFont(&notosans_18_bolditalic);
-EpdFontFamily notosans18FontFamily(&notosans18RegularFont, &notosans18BoldFont, &notosans18ItalicFont,
-                                   &notosans18BoldItalicFont);
-
-EpdFont opendyslexic8RegularFont(&opendyslexic_8_regular);
-EpdFont opendyslexic8BoldFont(&opendyslexic_8_bold);
-EpdFont opendyslexic8ItalicFont(&opendyslexic_8_italic);
-EpdFont opendyslexic8BoldItalicFont(&opendyslexic_8_bolditalic);
-EpdFontFamily opendyslexic8FontFamily(&opendyslexic8RegularFont, &opendyslexic8BoldFont, &opendyslexic8ItalicFont,
-                                      &opendyslexic8BoldItalicFont);
-EpdFont opendyslexic10RegularFont(&opendyslexic_10_regular);
-EpdFont opendyslexic10BoldFont(&opendyslexic_10_bold);
-EpdFont opendyslexic10ItalicFont(&opendyslexic_10_italic);
-EpdFont opendyslexic10BoldItalicFont(&opendyslexic_10_bolditalic);
-EpdFontFamily opendyslexic10FontFamily(&opendyslexic10RegularFont, &opendyslexic10BoldFont, &opendyslexic10ItalicFont,
-                                       &opendyslexic10BoldItalicFont);
-EpdFont opendyslexic12RegularFont(&opendyslexic_12_regular);
-EpdFont opendyslexic12BoldFont(&opendyslexic_12_bold);
-EpdFont opendyslexic12ItalicFont(&opendyslexic_12_italic);
-EpdFont opendyslexic12BoldItalicFont(&opendyslexic_12_bolditalic);
-EpdFontFamily opendyslexic12FontFamily(&opendyslexic12RegularFont, &opendyslexic12BoldFont, &opendyslexic12ItalicFont,
-                                       &opendyslexic12BoldItalicFont);
-EpdFont opendyslexic14RegularFont(&opendyslexic_14_regular);
-EpdFont opendyslexic14BoldFont(&opendyslexic_14_bold);
-EpdFont opendyslexic14ItalicFont(&opendyslexic_14_italic);
-EpdFont opendyslexic14BoldItalicFont(&opendyslexic_14_bolditalic);
-EpdFontFamily opendyslexic14FontFamily(&opendyslexic14RegularFont, &opendyslexic14BoldFont, &opendyslexic14ItalicFont,
-                                       &opendyslexic14BoldItalicFont);
+FONT_FAMILY(bookerly12FontFamily, bookerly_12)
+FONT_FAMILY(bookerly16FontFamily, bookerly_16)
+FONT_FAMILY(bookerly18FontFamily, bookerly_18)
+
+FONT_FAMILY(notosans12FontFamily, notosans_12)
+FONT_FAMILY(notosans14FontFamily, notosans_14)
+FONT_FAMILY(notosans16FontFamily, notosans_16)
+FONT_FAMILY(notosans18FontFamily, notosans_18)
+
+FONT_FAMILY(opendyslexic8FontFamily, opendyslexic_8)
+FONT_FAMILY(opendyslexic10FontFamily, opendyslexic_10)
+FONT_FAMILY(opendyslexic12FontFamily, opendyslexic_12)
+FONT_FAMILY(opendyslexic14FontFamily, opendyslexic_14)
 #endif  // OMIT_FONTS
 
-EpdFont smallFont(&notosans_8_regular);
-EpdFontFamily smallFontFamily(&smallFont);
+const EpdFontFamily& smallFontFamily() {
+  static const EpdFont regular(&notosans_8_regular);
+  static const EpdFontFamily family(&regular);
+  return family;
+}
 
-EpdFont ui10RegularFont(&ubuntu_10_regular);
-EpdFont ui10BoldFont(&ubuntu_10_bold);
-EpdFontFamily ui10FontFamily(&ui10RegularFont, &ui10BoldFont);
+const EpdFontFamily& ui10FontFamily() {
+  static const EpdFont regular(&ubuntu_10_regular), bold(&ubuntu_10_bold);
+  static const EpdFontFamily family(&regular, &bold);
+  return family;
+}
 
-EpdFont ui12RegularFont(&ubuntu_12_regular);
-EpdFont ui12BoldFont(&ubuntu_12_bold);
-EpdFontFamily ui12FontFamily(&ui12RegularFont, &ui12BoldFont);
+const EpdFontFamily& ui12FontFamily() {
+  static const EpdFont regular(&ubuntu_12_regular), bold(&ubuntu_12_bold);
+  static const EpdFontFamily family(&regular, &bold);
+  return family;
+}
 
 // measurement of power button press duration calibration value
 unsigned long t1 = 0;
@@ -137,6 +100,9 @@ void exitActivity() {
     delete currentActivity;
     currentActivity = nullptr;
   }
+  // The old activity's last frame is done and the new one hasn't asked for any, so the SD card is free for the log
+  logging::flush();
+  memstats::flush();
 }
 
 void enterNewActivity(Activity* activity) {
@@ -198,12 +164,17 @@ void waitForPowerRelease() {
 
 // Enter deep sleep mode
 void enterDeepSleep() {
+  if (currentActivity) {
+    currentActivity->onSleep();
+  }
   exitActivity();
   enterNewActivity(new SleepActivity(renderer, mappedInputManager));
 
   display.deepSleep();
   Serial.printf("[%lu] [   ] Power button press calibration value: %lu ms\n", millis(), t2 - t1);
   Serial.printf("[%lu] [   ] Entering deep sleep.\n", millis());
+  logging::flush();
+  memstats::flush();
 
   gpio.startDeepSleep();
 }
@@ -218,13 +189,21 @@ void onGoToReader(const std::string& initialEpubPath, MyLibraryActivity::Tab fro
 void onContinueReading() { onGoToReader(APP_STATE.openEpubPath, MyLibraryActivity::Tab::Recent); }
 
 void onGoToFileTransfer() {
+#if CROSSPOINT_EMULATED == 0
   exitActivity();
   enterNewActivity(new CrossPointWebServerActivity(renderer, mappedInputManager, onGoHome));
+#else
+  Serial.printf("[%lu] [   ] File transfer is not available in the emulator\n", millis());
+#endif
 }
 
 void onGoToSettings() {
+#if CROSSPOINT_EMULATED == 0
   exitActivity();
   enterNewActivity(new SettingsActivity(renderer, mappedInputManager, onGoHome));
+#else
+  Serial.printf("[%lu] [   ] Settings are not available in the emulator, edit settings.bin instead\n", millis());
+#endif
 }
 
 void onGoToMyLibrary() {
@@ -238,8 +217,12 @@ void onGoToMyLibraryWithTab(const std::string& path, MyLibraryActivity::Tab tab)
 }
 
 void onGoToBrowser() {
+#if CROSSPOINT_EMULATED == 0
   exitActivity();
   enterNewActivity(new OpdsBookBrowserActivity(renderer, mappedInputManager, onGoHome));
+#else
+  Serial.printf("[%lu] [   ] OPDS browser is not available in the emulator\n", millis());
+#endif
 }
 
 // Forward declarations for games
@@ -297,34 +280,41 @@ void onGoHome() {
                                     onGoToFileTransfer, onGoToBrowser, onGoToGames));
 }
 
-void setupDisplayAndFonts() {
-  display.begin();
-  Serial.printf("[%lu] [   ] Display initialized\n", millis());
-  renderer.insertFont(BOOKERLY_14_FONT_ID, bookerly14FontFamily);
+void setupFonts() {
+  renderer.registerFont(BOOKERLY_14_FONT_ID, bookerly14FontFamily);
 #ifndef OMIT_FONTS
-  renderer.insertFont(BOOKERLY_12_FONT_ID, bookerly12FontFamily);
-  renderer.insertFont(BOOKERLY_16_FONT_ID, bookerly16FontFamily);
-  renderer.insertFont(BOOKERLY_18_FONT_ID, bookerly18FontFamily);
-
-  renderer.insertFont(NOTOSANS_12_FONT_ID, notosans12FontFamily);
-  renderer.insertFont(NOTOSANS_14_FONT_ID, notosans14FontFamily);
-  renderer.insertFont(NOTOSANS_16_FONT_ID, notosans16FontFamily);
-  renderer.insertFont(NOTOSANS_18_FONT_ID, notosans18FontFamily);
-  renderer.insertFont(OPENDYSLEXIC_8_FONT_ID, opendyslexic8FontFamily);
-  renderer.insertFont(OPENDYSLEXIC_10_FONT_ID, opendyslexic10FontFamily);
-  renderer.insertFont(OPENDYSLEXIC_12_FONT_ID, opendyslexic12FontFamily);
-  renderer.insertFont(OPENDYSLEXIC_14_FONT_ID, opendyslexic14FontFamily);
+  renderer.registerFont(BOOKERLY_12_FONT_ID, bookerly12FontFamily);
+  renderer.registerFont(BOOKERLY_16_FONT_ID, bookerly16FontFamily);
+  renderer.registerFont(BOOKERLY_18_FONT_ID, bookerly18FontFamily);
+
+  renderer.registerFont(NOTOSANS_12_FONT_ID, notosans12FontFamily);
+  renderer.registerFont(NOTOSANS_14_FONT_ID, notosans14FontFamily);
+  renderer.registerFont(NOTOSANS_16_FONT_ID, notosans16FontFamily);
+  renderer.registerFont(NOTOSANS_18_FONT_ID, notosans18FontFamily);
+  renderer.registerFont(OPENDYSLEXIC_8_FONT_ID, opendyslexic8FontFamily);
+  renderer.registerFont(OPENDYSLEXIC_10_FONT_ID, opendyslexic10FontFamily);
+  renderer.registerFont(OPENDYSLEXIC_12_FONT_ID, opendyslexic12FontFamily);
+  renderer.registerFont(OPENDYSLEXIC_14_FONT_ID, opendyslexic14FontFamily);
 #endif  // OMIT_FONTS
-  renderer.insertFont(UI_10_FONT_ID, ui10FontFamily);
-  renderer.insertFont(UI_12_FONT_ID, ui12FontFamily);
-  renderer.insertFont(SMALL_FONT_ID, smallFontFamily);
+  renderer.registerFont(UI_10_FONT_ID, ui10FontFamily);
+  renderer.registerFont(UI_12_FONT_ID, ui12FontFamily);
+  renderer.registerFont(SMALL_FONT_ID, smallFontFamily);
   Serial.printf("[%lu] [   ] Fonts setup\n", millis());
 }
 
+void setupDisplayAndFonts() {
+  display.begin();
+  Serial.printf("[%lu] [   ] Display initialized\n", millis());
+  setupFonts();
+}
+
 void setup() {
   t1 = millis();
+  const unsigned long setupUs = micros();
+  logging::begin();
 
   gpio.begin();
+  boottimeline::begin(setupUs, gpio.isWakeupByPowerButton());
 
   // Only start serial if USB connected
   if (gpio.isUsbConnected()) {
@@ -334,8 +324,16 @@ void setup() {
     while (!Serial && (millis() - start) < 3000) {
       delay(10);
     }
+    boottimeline::mark(boottimeline::SERIAL_PORT);
   }
 
+  // Before anything else allocates, so the region is carved out of an unfragmented heap
+  BUFFER_POOL.begin();
+  boottimeline::mark(boottimeline::BUFFERS);
+  // Every activity draws its frames on this task, it has to exist before the first one is entered
+  RENDER_SERVICE.begin();
+  boottimeline::mark(boottimeline::RENDER_TASK);
+
   // SD Card Initialization
   // We need 6 open files concurrently when parsing a new chapter
   if (!SdMan.begin()) {
@@ -345,26 +343,45 @@ void setup() {
     enterNewActivity(new FullScreenMessageActivity(renderer, mappedInputManager, "SD card error", EpdFontFamily::BOLD));
     return;
   }
+  boottimeline::mark(boottimeline::SD_CARD);
 
   SETTINGS.loadFromFile();
-  KOREADER_STORE.loadFromFile();
+  boottimeline::mark(boottimeline::SETTINGS_FILE);
 
   if (gpio.isWakeupByPowerButton()) {
     // For normal wakeups, verify power button press duration
     Serial.printf("[%lu] [   ] Verifying power button press duration\n", millis());
     verifyPowerButtonDuration();
+    boottimeline::mark(boottimeline::POWER_BUTTON);
   }
 
   // First serial output only here to avoid timing inconsistencies for power button press duration verification
   Serial.printf("[%lu] [   ] Starting CrossPoint version " CROSSPOINT_VERSION "\n", millis());
 
-  setupDisplayAndFonts();
+  display.begin();
+  Serial.printf("[%lu] [   ] Display initialized\n", millis());
+  boottimeline::mark(boottimeline::DISPLAY);
+
+  // Woken up from a book: the page goes back on the panel before anything else is loaded, and the reader skips
+  // drawing it again once it gets there
+  const bool resumed = RESUME_SNAPSHOT.restore(display.getFrameBuffer());
+  if (resumed) {
+    display.displayBuffer(HalDisplay::HALF_REFRESH);
+    Serial.printf("[%lu] [   ] Resume snapshot displayed\n", millis());
+    boottimeline::mark(boottimeline::RESUME);
+  }
+
+  setupFonts();
+  boottimeline::mark(boottimeline::FONTS);
 
   exitActivity();
-  enterNewActivity(new BootActivity(renderer, mappedInputManager));
+  if (!resumed) {
+    enterNewActivity(new BootActivity(renderer, mappedInputManager));
+    boottimeline::mark(boottimeline::BOOT_SCREEN);
+  }
 
   APP_STATE.loadFromFile();
-  RECENT_BOOKS.loadFromFile();
+  boottimeline::mark(boottimeline::STATE_FILE);
 
   if (APP_STATE.openEpubPath.empty()) {
     onGoHome();
@@ -376,6 +393,7 @@ void setup() {
     APP_STATE.saveToFile();
     onGoToReader(path, MyLibraryActivity::Tab::Recent);
   }
+  boottimeline::mark(boottimeline::FIRST_ACTIVITY);
 
   // Ensure we're not still holding the power button before leaving setup
   waitForPowerRelease();
@@ -394,6 +412,12 @@ void loop() {
     lastMemPrint = millis();
   }
 
+  static unsigned long lastMemSample = millis();
+  if (currentActivity && millis() - lastMemSample >= memstats::SAMPLE_INTERVAL_MS) {
+    currentActivity->sampleMemory();
+    lastMemSample = millis();
+  }
+
   // Check for any user activity (button press or release) or active background work
   static unsigned long lastActivityTime = millis();
   if (gpio.wasAnyPressed() || gpio.wasAnyReleased() || (currentActivity && currentActivity->preventAutoSleep())) {
@@ -1,14 +1,19 @@
 #include "CrossPointWebServer.h"
 
 #include <ArduinoJson.h>
+#include <BootTimeline.h>
+#include <BufferPool.h>
 #include <Epub.h>
 #include <FsHelpers.h>
+#include <MemStats.h>
+#include <Perf.h>
 #include <SDCardManager.h>
 #include <WiFi.h>
 #include <esp_task_wdt.h>
 
 #include <algorithm>
 
+#include "RenderService.h"
 #include "html/FilesPageHtml.generated.h"
 #include "html/HomePageHtml.generated.h"
 #include "util/StringUtils.h"
@@ -101,6 +106,10 @@ void CrossPointWebServer::begin() {
 
   server->on("/api/status", HTTP_GET, [this] { handleStatus(); });
   server->on("/api/files", HTTP_GET, [this] { handleFileListData(); });
+  server->on("/api/memory", HTTP_GET, [this] { handleMemory(); });
+#if CROSSPOINT_PERF
+  server->on("/api/perf", HTTP_GET, [this] { handlePerf(); });
+#endif
   server->on("/download", HTTP_GET, [this] { handleDownload(); });
 
   // Upload endpoint with special handling for multipart form data
@@ -279,6 +288,118 @@ void CrossPointWebServer::handleStatus() const {
   server->send(200, "application/json", json);
 }
 
+void CrossPointWebServer::handleMemory() const {
+  JsonDocument doc;
+  doc["uptime"] = millis() / 1000;
+
+  const JsonObject heap = doc["heap"].to<JsonObject>();
+  heap["free"] = ESP.getFreeHeap();
+  heap["largestFreeBlock"] = ESP.getMaxAllocHeap();
+  heap["minFree"] = ESP.getMinFreeHeap();
+  heap["total"] = ESP.getHeapSize();
+
+  const JsonArray tasks = doc["tasks"].to<JsonArray>();
+  for (size_t i = 0; i < memstats::taskCount(); i++) {
+    const auto& task = memstats::task(i);
+    const JsonObject entry = tasks.add<JsonObject>();
+    entry["name"] = static_cast<const char*>(task.name);
+    entry["minStackFree"] = task.minStackFree;
+    entry["samples"] = task.samples;
+  }
+
+  // Includes earlier boots, the ring file is only cleared when it is deleted
+  const JsonArray samples = doc["samples"].to<JsonArray>();
+  memstats::forEachStoredSample([&samples](const memstats::Sample& sample) {
+    const JsonObject entry = samples.add<JsonObject>();
+    entry["ms"] = sample.ms;
+    entry["event"] = memstats::eventName(sample.event);
+    // Through a pointer so ArduinoJson copies it, char arrays are taken for literals and stored by reference
+    entry["activity"] = static_cast<const char*>(sample.activity);
+    entry["freeHeap"] = sample.freeHeap;
+    entry["largestFreeBlock"] = sample.largestFreeBlock;
+    entry["minFreeHeap"] = sample.minFreeHeap;
+    if (sample.stackFree != memstats::NO_STACK) {
+      entry["stackFree"] = sample.stackFree;
+    }
+  });
+
+  String json;
+  serializeJson(doc, json);
+  server->send(200, "application/json", json);
+}
+
+#if CROSSPOINT_PERF
+void CrossPointWebServer::handlePerf() const {
+  JsonDocument doc;
+  doc["uptime"] = millis() / 1000;
+
+  const JsonObject metrics = doc["metrics"].to<JsonObject>();
+  for (uint8_t i = 0; i < perf::METRIC_COUNT; i++) {
+    const auto metric = static_cast<perf::Metric>(i);
+    const auto& h = perf::histogram(metric);
+    const JsonObject entry = metrics[perf::metricName(metric)].to<JsonObject>();
+    entry["count"] = h.count;
+    entry["totalUs"] = h.totalUs;
+    entry["meanUs"] = h.count > 0 ? static_cast<uint32_t>(h.totalUs / h.count) : 0;
+    entry["p50Us"] = perf::percentileUs(metric, 50);
+    entry["p90Us"] = perf::percentileUs(metric, 90);
+    entry["p99Us"] = perf::percentileUs(metric, 99);
+    entry["maxUs"] = h.maxUs;
+  }
+
+  const JsonObject counters = doc["counters"].to<JsonObject>();
+  for (uint8_t i = 0; i < perf::COUNTER_COUNT; i++) {
+    const auto counter = static_cast<perf::Counter>(i);
+    counters[perf::counterName(counter)] = perf::counterValue(counter);
+  }
+
+  const auto pool = BUFFER_POOL.getStats();
+  const JsonObject bufferPool = doc["bufferPool"].to<JsonObject>();
+  bufferPool["slabsInUse"] = pool.slabsInUse;
+  bufferPool["peakSlabs"] = pool.peakSlabsInUse;
+  bufferPool["leases"] = pool.leases;
+  bufferPool["heapFallbacks"] = pool.heapFallbacks;
+
+  const auto frames = RENDER_SERVICE.getStats();
+  const JsonObject render = doc["render"].to<JsonObject>();
+  render["requests"] = frames.requests;
+  render["coalesced"] = frames.coalesced;
+  render["frames"] = frames.frames;
+  render["dropped"] = frames.dropped;
+
+  // Phase durations of this boot and the one before, phases that didn't run are left out
+  const JsonObject boot = doc["boot"].to<JsonObject>();
+  const auto addTimeline = [&boot](const char* key, const boottimeline::Timeline& timeline) {
+    if (timeline.boot == 0) {
+      return;
+    }
+    const JsonObject entry = boot[key].to<JsonObject>();
+    entry["boot"] = timeline.boot;
+    entry["fromSleep"] = timeline.fromSleep;
+    entry["firstFrameUs"] = timeline.phaseEndUs[boottimeline::FIRST_FRAME] != 0
+                                ? timeline.phaseEndUs[boottimeline::FIRST_FRAME] - timeline.setupUs
+                                : 0;
+    const JsonObject phases = entry["phasesUs"].to<JsonObject>();
+    for (uint8_t i = 0; i < boottimeline::PHASE_COUNT; i++) {
+      const auto phase = static_cast<boottimeline::Phase>(i);
+      if (timeline.phaseEndUs[phase] != 0) {
+        phases[boottimeline::phaseName(phase)] = boottimeline::phaseUs(timeline, phase);
+      }
+    }
+  };
+  addTimeline("current", boottimeline::current());
+  addTimeline("previous", boottimeline::previous());
+
+  String json;
+  serializeJson(doc, json);
+  server->send(200, "application/json", json);
+
+  if (server->hasArg("reset")) {
+    perf::reset();
+  }
+}
+#endif
+
 void CrossPointWebServer::scanFiles(const char* path, const std::function<void(FileInfo)>& callback) const {
   FsFile root = SdMan.open(path);
   if (!root) {
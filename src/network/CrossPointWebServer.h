@@ -71,6 +71,10 @@ class CrossPointWebServer {
   void handleRoot() const;
   void handleNotFound() const;
   void handleStatus() const;
+  void handleMemory() const;
+#if CROSSPOINT_PERF
+  void handlePerf() const;
+#endif
   void handleFileList() const;
   void handleFileListData() const;
   void handleDownload() const;
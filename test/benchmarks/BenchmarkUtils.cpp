@@ -0,0 +1,120 @@
+#include "BenchmarkUtils.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace bench {
+
+double msSince(const Clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+std::string jsonEscape(const std::string& s) {
+  std::string out;
+  for (const char c : s) {
+    if (c == '"' || c == '\\') {
+      out += '\\';
+    }
+    out += c;
+  }
+  return out;
+}
+
+FILE* logOutput(const bool verbose) { return verbose ? stderr : fopen("/dev/null", "w"); }
+
+CommandLine& CommandLine::directory(const char* name, std::string* value, const char* help, const bool required) {
+  directoryName = std::string("<") + name + ">";
+  directoryHelp = help;
+  directoryValue = value;
+  directoryRequired = required;
+  return *this;
+}
+
+CommandLine& CommandLine::option(const char* name, const char* valueName, int* value, const char* help,
+                                 const bool showDefault) {
+  return addOption(name, valueName, showDefault ? help + (", default " + std::to_string(*value)) : help,
+                   [value](const char* arg) { *value = atoi(arg); });
+}
+
+CommandLine& CommandLine::option(const char* name, const char* valueName, size_t* value, const char* help,
+                                 const bool showDefault) {
+  return addOption(name, valueName, showDefault ? help + (", default " + std::to_string(*value)) : help,
+                   [value](const char* arg) { *value = strtoul(arg, nullptr, 10); });
+}
+
+CommandLine& CommandLine::option(const char* name, const char* valueName, double* value, const char* help,
+                                 const bool showDefault) {
+  char defaultValue[32];
+  snprintf(defaultValue, sizeof(defaultValue), ", default %g", *value);
+  return addOption(name, valueName, showDefault ? help + std::string(defaultValue) : help,
+                   [value](const char* arg) { *value = strtod(arg, nullptr); });
+}
+
+CommandLine& CommandLine::option(const char* name, const char* valueName, std::string* value, const char* help) {
+  return addOption(name, valueName, help, [value](const char* arg) { *value = arg; });
+}
+
+CommandLine& CommandLine::flag(const char* name, bool* value, const char* help) {
+  return addOption(name, "", help, [value](const char*) { *value = true; });
+}
+
+CommandLine& CommandLine::addOption(const char* name, const char* valueName, std::string help,
+                                    std::function<void(const char*)> set) {
+  options.push_back({name, valueName, std::move(help), std::move(set)});
+  return *this;
+}
+
+int CommandLine::parse(const int argc, char** argv) const {
+  for (int i = 1; i < argc; i++) {
+    const std::string arg = argv[i];
+    const auto option = std::find_if(options.begin(), options.end(), [&arg](const Argument& o) {
+      return o.name == arg;
+    });
+    if (option != options.end() && (option->valueName.empty() || i + 1 < argc)) {
+      option->set(option->valueName.empty() ? nullptr : argv[++i]);
+    } else if (directoryValue && arg[0] != '-' && directoryValue->empty()) {
+      *directoryValue = arg;
+    } else {
+      printUsage(argv[0]);
+      return arg == "--help" || arg == "-h" ? 0 : 2;
+    }
+  }
+  if (directoryValue && directoryRequired && directoryValue->empty()) {
+    printUsage(argv[0]);
+    return 2;
+  }
+  return -1;
+}
+
+void CommandLine::printUsage(const char* argv0) const {
+  std::string synopsis = std::string("Usage: ") + argv0;
+  size_t width = directoryValue ? directoryName.size() : 0;
+  if (directoryValue) {
+    synopsis += directoryRequired ? " " + directoryName : " [" + directoryName + "]";
+  }
+  for (const Argument& o : options) {
+    synopsis += " [" + o.name + (o.valueName.empty() ? "" : " <" + o.valueName + ">") + "]";
+    width = std::max(width, o.name.size());
+  }
+  fprintf(stderr, "%s\n", synopsis.c_str());
+
+  const auto printHelp = [width](const std::string& label, const std::string& help) {
+    // Continuation lines start under the first one
+    std::string text;
+    for (const char c : help) {
+      text += c;
+      if (c == '\n') {
+        text.append(width + 4, ' ');
+      }
+    }
+    fprintf(stderr, "  %-*s  %s\n", static_cast<int>(width), label.c_str(), text.c_str());
+  };
+  if (directoryValue) {
+    printHelp(directoryName, directoryHelp);
+  }
+  for (const Argument& o : options) {
+    printHelp(o.name, o.help);
+  }
+}
+
+}  // namespace bench
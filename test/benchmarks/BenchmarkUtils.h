@@ -0,0 +1,72 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * BenchmarkUtils.h
+ *
+ * What the host benchmarks share around their measurements: the clock, the command line with its usage text, where
+ * the firmware log goes and the string escaping of the JSON reports.
+ */
+namespace bench {
+
+using Clock = std::chrono::steady_clock;
+
+double msSince(Clock::time_point start);
+
+// Escapes quotes and backslashes for a JSON string
+std::string jsonEscape(const std::string& s);
+
+// Where the firmware log goes: stderr with --verbose, nowhere otherwise
+FILE* logOutput(bool verbose);
+
+/**
+ * The arguments a benchmark takes, in the order they are listed in the usage text: at most one directory and any
+ * number of --options. Help texts may span lines with '\n', the usage indents the continuation.
+ */
+class CommandLine {
+ public:
+  // A directory given without a leading '-'. An optional one is shown in brackets and may be left out.
+  CommandLine& directory(const char* name, std::string* value, const char* help, bool required = true);
+
+  // An --option followed by a value. With showDefault the value the target holds now is appended to the help.
+  CommandLine& option(const char* name, const char* valueName, int* value, const char* help, bool showDefault = true);
+  CommandLine& option(const char* name, const char* valueName, size_t* value, const char* help,
+                      bool showDefault = true);
+  CommandLine& option(const char* name, const char* valueName, double* value, const char* help,
+                      bool showDefault = true);
+  CommandLine& option(const char* name, const char* valueName, std::string* value, const char* help);
+
+  // An --option without a value that sets the target to true
+  CommandLine& flag(const char* name, bool* value, const char* help);
+
+  // Fills in the targets. Returns -1 to go on with the benchmark, otherwise the exit status after printing the usage:
+  // 0 for --help or -h, 2 for an unknown argument or a missing directory.
+  int parse(int argc, char** argv) const;
+
+  void printUsage(const char* argv0) const;
+
+ private:
+  struct Argument {
+    std::string name;
+    std::string valueName;  // Empty for flags and the directory
+    std::string help;
+    std::function<void(const char*)> set;
+  };
+
+  CommandLine& addOption(const char* name, const char* valueName, std::string help,
+                         std::function<void(const char*)> set);
+
+  std::string directoryName;
+  std::string directoryHelp;
+  std::string* directoryValue = nullptr;
+  bool directoryRequired = false;
+  std::vector<Argument> options;
+};
+
+}  // namespace bench
@@ -0,0 +1,301 @@
+/**
+ * BitmapBlitBenchmark.cpp
+ *
+ * Writes 1-bit and 2-bit BMPs the size of the screen (and a 2x, a cropped and an off screen one) to a scratch
+ * directory, then draws each of them with GfxRenderer::drawBitmap in every orientation and render mode:
+ *   - once with the renderer, which maps the columns once per image and writes rows straight into the frame buffer
+ *   - once with a copy of the pixel by pixel loop it replaced, drawPixel for every pixel
+ *
+ * The frame buffers are filled with a pattern before each draw and must come out identical, any difference makes the
+ * process exit with status 1. Reading the rows is timed on its own so the drawing part of each can be told apart.
+ */
+#include <Arduino.h>
+#include <GfxRenderer.h>
+#include <HalDisplay.h>
+#include <SDCardManager.h>
+
+#include <cmath>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "BenchmarkUtils.h"
+
+namespace {
+constexpr int DEFAULT_ITERATIONS = 10;
+
+struct Case {
+  const char* name;
+  int bpp;
+  int width;
+  int height;
+  int x;
+  int y;
+  float cropX;
+  float cropY;
+};
+
+// Drawn into the whole screen (maxWidth and maxHeight are the screen size), so in portrait the first ones are unscaled,
+// the 2x one is an integer downscale and the landscape orientations scale everything by a fraction
+const Case CASES[] = {
+    {"screen_2bit.bmp", 2, 480, 800, 0, 0, 0, 0},     {"screen_1bit.bmp", 1, 480, 800, 0, 0, 0, 0},
+    {"double_2bit.bmp", 2, 960, 1600, 0, 0, 0, 0},    {"double_1bit.bmp", 1, 960, 1600, 0, 0, 0, 0},
+    {"crop_2bit.bmp", 2, 600, 800, 0, 0, 0.2f, 0},    {"offscreen_2bit.bmp", 2, 300, 400, -50, -30, 0, 0},
+    {"offscreen_1bit.bmp", 1, 300, 400, 260, 500, 0, 0},
+};
+
+const GfxRenderer::Orientation ORIENTATIONS[] = {GfxRenderer::Portrait, GfxRenderer::LandscapeClockwise,
+                                                 GfxRenderer::PortraitInverted,
+                                                 GfxRenderer::LandscapeCounterClockwise};
+const char* const ORIENTATION_NAMES[] = {"portrait", "landscapeCw", "portraitInverted", "landscapeCcw"};
+const GfxRenderer::RenderMode MODES[] = {GfxRenderer::BW, GfxRenderer::GRAYSCALE_LSB, GfxRenderer::GRAYSCALE_MSB};
+
+using bench::Clock;
+using bench::msSince;
+
+// Flat areas of every gray with noise and stripes between them, so runs and single pixels both show up
+uint8_t sample(const int x, const int y, const int levels) {
+  uint32_t h = static_cast<uint32_t>(x * 73856093) ^ static_cast<uint32_t>(y * 19349663);
+  h ^= h >> 13;
+  const int band = (x / 40 + y / 60) % 4;
+  if (band == 0) return static_cast<uint8_t>(h % levels);
+  if (band == 1) return static_cast<uint8_t>((x / 3 + y) % levels);
+  return static_cast<uint8_t>((x * levels / 97 + y / 50) % levels);
+}
+
+void putLE16(std::vector<uint8_t>& out, const uint16_t value) {
+  out.push_back(value & 0xFF);
+  out.push_back(value >> 8);
+}
+
+void putLE32(std::vector<uint8_t>& out, const uint32_t value) {
+  putLE16(out, value & 0xFFFF);
+  putLE16(out, value >> 16);
+}
+
+bool writeBmp(const std::string& dir, const Case& c) {
+  const int colors = 1 << c.bpp;
+  const int rowBytes = (c.width * c.bpp + 31) / 32 * 4;
+  const uint32_t dataOffset = 14 + 40 + colors * 4;
+
+  std::vector<uint8_t> out;
+  putLE16(out, 0x4D42);
+  putLE32(out, dataOffset + rowBytes * c.height);
+  putLE32(out, 0);
+  putLE32(out, dataOffset);
+  putLE32(out, 40);
+  putLE32(out, c.width);
+  putLE32(out, c.height);  // Bottom-up like the converter's output
+  putLE16(out, 1);
+  putLE16(out, c.bpp);
+  putLE32(out, 0);
+  putLE32(out, rowBytes * c.height);
+  putLE32(out, 2835);
+  putLE32(out, 2835);
+  putLE32(out, colors);
+  putLE32(out, colors);
+  for (int i = 0; i < colors; i++) {
+    const auto gray = static_cast<uint8_t>(i * 255 / (colors - 1));
+    out.insert(out.end(), {gray, gray, gray, 0});
+  }
+
+  std::vector<uint8_t> row(rowBytes);
+  for (int y = c.height - 1; y >= 0; y--) {
+    std::fill(row.begin(), row.end(), 0);
+    for (int x = 0; x < c.width; x++) {
+      const int bit = x * c.bpp;
+      row[bit / 8] |= sample(x, y, colors) << (8 - c.bpp - bit % 8);
+    }
+    out.insert(out.end(), row.begin(), row.end());
+  }
+
+  FILE* file = fopen((dir + "/" + c.name).c_str(), "wb");
+  if (!file) {
+    return false;
+  }
+  const bool written = fwrite(out.data(), 1, out.size(), file) == out.size();
+  return fclose(file) == 0 && written;
+}
+
+// The loops GfxRenderer::drawBitmap and drawBitmap1Bit ran before they got the column map
+void referenceDrawBitmap(const GfxRenderer& renderer, const Bitmap& bitmap, const int x, const int y,
+                         const int maxWidth, const int maxHeight, const float cropX, const float cropY,
+                         const GfxRenderer::RenderMode renderMode) {
+  const bool oneBit = bitmap.is1Bit() && cropX == 0.0f && cropY == 0.0f;
+  float scale = 1.0f;
+  bool isScaled = false;
+  const int cropPixX = std::floor(bitmap.getWidth() * cropX / 2.0f);
+  const int cropPixY = std::floor(bitmap.getHeight() * cropY / 2.0f);
+  if (maxWidth > 0 && (1.0f - cropX) * bitmap.getWidth() > maxWidth) {
+    scale = static_cast<float>(maxWidth) / static_cast<float>((1.0f - cropX) * bitmap.getWidth());
+    isScaled = true;
+  }
+  if (maxHeight > 0 && (1.0f - cropY) * bitmap.getHeight() > maxHeight) {
+    scale = std::min(scale, static_cast<float>(maxHeight) / static_cast<float>((1.0f - cropY) * bitmap.getHeight()));
+    isScaled = true;
+  }
+
+  std::vector<uint8_t> outputRow((bitmap.getWidth() + 3) / 4);
+  std::vector<uint8_t> rowBytes(bitmap.getRowBytes());
+  for (int bmpY = 0; bmpY < bitmap.getHeight() - (oneBit ? 0 : cropPixY); bmpY++) {
+    int screenY = -cropPixY + (bitmap.isTopDown() ? bmpY : bitmap.getHeight() - 1 - bmpY);
+    if (isScaled) {
+      screenY = std::floor(screenY * scale);
+    }
+    screenY += y;
+    if (!oneBit && screenY >= renderer.getScreenHeight()) {
+      break;
+    }
+    if (bitmap.readNextRow(outputRow.data(), rowBytes.data()) != BmpReaderError::Ok) {
+      return;
+    }
+    if (screenY < 0 || screenY >= renderer.getScreenHeight() || bmpY < cropPixY) {
+      continue;
+    }
+
+    for (int bmpX = cropPixX; bmpX < bitmap.getWidth() - cropPixX; bmpX++) {
+      int screenX = bmpX - cropPixX;
+      if (isScaled) {
+        screenX = std::floor(screenX * scale);
+      }
+      screenX += x;
+      if (screenX >= renderer.getScreenWidth()) {
+        break;
+      }
+      if (screenX < 0) {
+        continue;
+      }
+
+      const uint8_t val = outputRow[bmpX / 4] >> (6 - ((bmpX * 2) % 8)) & 0x3;
+      if ((oneBit || renderMode == GfxRenderer::BW) && val < 3) {
+        renderer.drawPixel(screenX, screenY);
+      } else if (oneBit) {
+        continue;
+      } else if (renderMode == GfxRenderer::GRAYSCALE_MSB && (val == 1 || val == 2)) {
+        renderer.drawPixel(screenX, screenY, false);
+      } else if (renderMode == GfxRenderer::GRAYSCALE_LSB && val == 1) {
+        renderer.drawPixel(screenX, screenY, false);
+      }
+    }
+  }
+}
+
+void fillPattern(uint8_t* frameBuffer) {
+  for (size_t i = 0; i < HalDisplay::BUFFER_SIZE; i++) {
+    frameBuffer[i] = static_cast<uint8_t>(i * 37 + (i >> 7));
+  }
+}
+
+struct Timing {
+  double referenceMs = 0;
+  double fastMs = 0;
+  double readMs = 0;
+  bool identical = true;
+};
+
+// Per draw, summed over the render modes
+Timing run(GfxRenderer& renderer, FsFile& file, const Case& c, const int iterations) {
+  Timing timing;
+  uint8_t* frameBuffer = renderer.getFrameBuffer();
+  std::vector<uint8_t> expected(HalDisplay::BUFFER_SIZE);
+  const int maxWidth = renderer.getScreenWidth();
+  const int maxHeight = renderer.getScreenHeight();
+
+  for (const GfxRenderer::RenderMode mode : MODES) {
+    for (int i = 0; i < iterations; i++) {
+      Bitmap bitmap(file);
+      bitmap.parseHeaders();
+      fillPattern(frameBuffer);
+      auto start = Clock::now();
+      referenceDrawBitmap(renderer, bitmap, c.x, c.y, maxWidth, maxHeight, c.cropX, c.cropY, mode);
+      timing.referenceMs += msSince(start);
+      memcpy(expected.data(), frameBuffer, HalDisplay::BUFFER_SIZE);
+
+      bitmap.rewindToData();
+      fillPattern(frameBuffer);
+      renderer.setRenderMode(mode);
+      start = Clock::now();
+      renderer.drawBitmap(bitmap, c.x, c.y, maxWidth, maxHeight, c.cropX, c.cropY);
+      timing.fastMs += msSince(start);
+      renderer.setRenderMode(GfxRenderer::BW);
+      timing.identical &= memcmp(expected.data(), frameBuffer, HalDisplay::BUFFER_SIZE) == 0;
+
+      // Just the rows, the part both have to do
+      bitmap.rewindToData();
+      std::vector<uint8_t> outputRow((bitmap.getWidth() + 3) / 4);
+      std::vector<uint8_t> rowBytes(bitmap.getRowBytes());
+      start = Clock::now();
+      for (int row = 0; row < bitmap.getHeight(); row++) {
+        bitmap.readNextRow(outputRow.data(), rowBytes.data());
+      }
+      timing.readMs += msSince(start);
+    }
+  }
+  timing.referenceMs /= iterations;
+  timing.fastMs /= iterations;
+  timing.readMs /= iterations;
+  return timing;
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+  std::string scratchDir;
+  int iterations = DEFAULT_ITERATIONS;
+  bool verbose = false;
+
+  bench::CommandLine commandLine;
+  commandLine.directory("scratch dir", &scratchDir, "where the test images are written, used as the SD card root")
+      .option("--iterations", "n", &iterations, "draws per image, orientation and render mode")
+      .flag("--verbose", &verbose, "print the firmware log to stderr");
+  if (const int status = commandLine.parse(argc, argv); status >= 0) {
+    return status;
+  }
+  iterations = std::max(1, iterations);
+
+  FILE* log = bench::logOutput(verbose);
+  Serial.setOutput(log);
+  SdMan.setRootPath(scratchDir);
+  SdMan.begin();
+  HalDisplay display;
+  display.begin();
+  GfxRenderer renderer(display);
+
+  bool failed = false;
+  printf("{\n  \"iterations\": %d,\n  \"images\": [\n", iterations);
+  constexpr size_t caseCount = sizeof(CASES) / sizeof(CASES[0]);
+  for (size_t i = 0; i < caseCount; i++) {
+    const Case& c = CASES[i];
+    fprintf(stderr, "%s\n", c.name);
+    FsFile file;
+    if (!writeBmp(scratchDir, c) || !SdMan.openFileForRead("BLT", std::string("/") + c.name, file)) {
+      fprintf(stderr, "Failed to write %s\n", c.name);
+      return 2;
+    }
+
+    printf("    {\"name\": \"%s\", \"size\": \"%dx%d\", \"orientations\": [\n", c.name, c.width, c.height);
+    for (size_t o = 0; o < sizeof(ORIENTATIONS) / sizeof(ORIENTATIONS[0]); o++) {
+      renderer.setOrientation(ORIENTATIONS[o]);
+      const Timing t = run(renderer, file, c, iterations);
+      failed |= !t.identical;
+      // Images mostly off screen leave too little drawing to compare
+      const double referenceDraw = t.referenceMs - t.readMs;
+      const double fastDraw = t.fastMs - t.readMs;
+      char speedup[16] = "null";
+      if (referenceDraw > 0.1 && fastDraw > 0.01) {
+        snprintf(speedup, sizeof(speedup), "%.1f", referenceDraw / fastDraw);
+      }
+      printf(
+          "      {\"orientation\": \"%s\", \"identical\": %s, \"referenceMs\": %.2f, \"fastMs\": %.2f, "
+          "\"readMs\": %.2f, \"drawSpeedup\": %s}%s\n",
+          ORIENTATION_NAMES[o], t.identical ? "true" : "false", t.referenceMs, t.fastMs, t.readMs, speedup,
+          o + 1 == sizeof(ORIENTATIONS) / sizeof(ORIENTATIONS[0]) ? "" : ",");
+      if (!t.identical) {
+        fprintf(stderr, "%s: frame buffer differs in %s\n", c.name, ORIENTATION_NAMES[o]);
+      }
+    }
+    printf("    ]}%s\n", i + 1 == caseCount ? "" : ",");
+    file.close();
+  }
+  printf("  ]\n}\n");
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,343 @@
+/**
+ * DitherBenchmark.cpp
+ *
+ * Dithers generated grayscale images (gradients, noise, a photo-like mix and flat areas at the quantization
+ * thresholds) of several sizes, including widths that are not a multiple of four, with both Atkinson ditherers in
+ * BitmapHelpers.h:
+ *   - once with the current classes, which look up each step in a table and pass the error to the next row four pixels
+ *     per 32-bit word
+ *   - once with a copy of the pixel by pixel classes they replaced
+ *
+ * Every output level must come out identical, any difference makes the process exit with status 1. Each image is
+ * dithered twice with a reset() in between, like Bitmap::rewindToData() does. The ordered (Bayer) modes have no
+ * reference and are only timed.
+ */
+#include <BitmapHelpers.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "BenchmarkUtils.h"
+
+namespace {
+constexpr int DEFAULT_ITERATIONS = 20;
+
+struct Size {
+  int width;
+  int height;
+};
+
+// Cover, home thumbnail, grid thumbnail and a few odd widths for the ends of the 32-bit words
+const Size SIZES[] = {{480, 800}, {240, 400}, {120, 180}, {121, 97}, {7, 9}, {1, 5}};
+
+const char* const PATTERNS[] = {"gradient", "noise", "photo", "thresholds", "black", "white"};
+
+uint8_t sample(const char* pattern, const int x, const int y, const Size& size) {
+  uint32_t h = static_cast<uint32_t>(x * 73856093) ^ static_cast<uint32_t>(y * 19349663);
+  h ^= h >> 13;
+  h *= 1274126177u;
+  if (strcmp(pattern, "gradient") == 0) {
+    return static_cast<uint8_t>((x * 255 / std::max(1, size.width - 1) + y * 255 / std::max(1, size.height - 1)) / 2);
+  }
+  if (strcmp(pattern, "noise") == 0) {
+    return static_cast<uint8_t>(h >> 24);
+  }
+  if (strcmp(pattern, "photo") == 0) {
+    const double value = 128 + 70 * std::sin(x * 0.05) * std::cos(y * 0.031) + 40 * std::sin((x + y) * 0.013) +
+                         static_cast<int>(h >> 28) - 8;
+    return static_cast<uint8_t>(std::clamp(static_cast<int>(value), 0, 255));
+  }
+  if (strcmp(pattern, "thresholds") == 0) {
+    // Blocks just below, at and above each threshold, where the error flips the level most often
+    static const uint8_t grays[] = {0,   14,  15,  16,  29,  30,  31,  49,  50,  51,  79, 80,
+                                    81,  127, 128, 129, 139, 140, 141, 209, 210, 211, 255};
+    return grays[(x / 6 + y / 4 * 5) % sizeof(grays)];
+  }
+  return strcmp(pattern, "black") == 0 ? 0 : 255;
+}
+
+// The ditherers as they were before the step tables and the packed error rows
+namespace reference {
+int minAdjusted = 0;
+int maxAdjusted = 0;
+
+inline void track(const int adjusted) {
+  minAdjusted = std::min(minAdjusted, adjusted);
+  maxAdjusted = std::max(maxAdjusted, adjusted);
+}
+
+class Atkinson1BitDitherer {
+ public:
+  explicit Atkinson1BitDitherer(int width) : width(width) {
+    errorRow0 = new int16_t[width + 4]();
+    errorRow1 = new int16_t[width + 4]();
+    errorRow2 = new int16_t[width + 4]();
+  }
+  ~Atkinson1BitDitherer() {
+    delete[] errorRow0;
+    delete[] errorRow1;
+    delete[] errorRow2;
+  }
+  Atkinson1BitDitherer(const Atkinson1BitDitherer& other) = delete;
+  Atkinson1BitDitherer& operator=(const Atkinson1BitDitherer& other) = delete;
+
+  uint8_t processPixel(int gray, int x) {
+    gray = adjustPixel(gray);
+    int adjusted = gray + errorRow0[x + 2];
+    track(adjusted);
+    if (adjusted < 0) adjusted = 0;
+    if (adjusted > 255) adjusted = 255;
+    uint8_t quantized;
+    int quantizedValue;
+    if (adjusted < 128) {
+      quantized = 0;
+      quantizedValue = 0;
+    } else {
+      quantized = 1;
+      quantizedValue = 255;
+    }
+    int error = (adjusted - quantizedValue) >> 3;
+    errorRow0[x + 3] += error;
+    errorRow0[x + 4] += error;
+    errorRow1[x + 1] += error;
+    errorRow1[x + 2] += error;
+    errorRow1[x + 3] += error;
+    errorRow2[x + 2] += error;
+    return quantized;
+  }
+
+  void nextRow() {
+    int16_t* temp = errorRow0;
+    errorRow0 = errorRow1;
+    errorRow1 = errorRow2;
+    errorRow2 = temp;
+    memset(errorRow2, 0, (width + 4) * sizeof(int16_t));
+  }
+
+  void reset() {
+    memset(errorRow0, 0, (width + 4) * sizeof(int16_t));
+    memset(errorRow1, 0, (width + 4) * sizeof(int16_t));
+    memset(errorRow2, 0, (width + 4) * sizeof(int16_t));
+  }
+
+ private:
+  int width;
+  int16_t* errorRow0;
+  int16_t* errorRow1;
+  int16_t* errorRow2;
+};
+
+class AtkinsonDitherer {
+ public:
+  explicit AtkinsonDitherer(int width) : width(width) {
+    errorRow0 = new int16_t[width + 4]();
+    errorRow1 = new int16_t[width + 4]();
+    errorRow2 = new int16_t[width + 4]();
+  }
+  ~AtkinsonDitherer() {
+    delete[] errorRow0;
+    delete[] errorRow1;
+    delete[] errorRow2;
+  }
+  AtkinsonDitherer(const AtkinsonDitherer& other) = delete;
+  AtkinsonDitherer& operator=(const AtkinsonDitherer& other) = delete;
+
+  uint8_t processPixel(int gray, int x) {
+    int adjusted = gray + errorRow0[x + 2];
+    track(adjusted);
+    if (adjusted < 0) adjusted = 0;
+    if (adjusted > 255) adjusted = 255;
+    uint8_t quantized;
+    int quantizedValue;
+    if (adjusted < 30) {
+      quantized = 0;
+      quantizedValue = 15;
+    } else if (adjusted < 50) {
+      quantized = 1;
+      quantizedValue = 30;
+    } else if (adjusted < 140) {
+      quantized = 2;
+      quantizedValue = 80;
+    } else {
+      quantized = 3;
+      quantizedValue = 210;
+    }
+    int error = (adjusted - quantizedValue) >> 3;
+    errorRow0[x + 3] += error;
+    errorRow0[x + 4] += error;
+    errorRow1[x + 1] += error;
+    errorRow1[x + 2] += error;
+    errorRow1[x + 3] += error;
+    errorRow2[x + 2] += error;
+    return quantized;
+  }
+
+  void nextRow() {
+    int16_t* temp = errorRow0;
+    errorRow0 = errorRow1;
+    errorRow1 = errorRow2;
+    errorRow2 = temp;
+    memset(errorRow2, 0, (width + 4) * sizeof(int16_t));
+  }
+
+  void reset() {
+    memset(errorRow0, 0, (width + 4) * sizeof(int16_t));
+    memset(errorRow1, 0, (width + 4) * sizeof(int16_t));
+    memset(errorRow2, 0, (width + 4) * sizeof(int16_t));
+  }
+
+ private:
+  int width;
+  int16_t* errorRow0;
+  int16_t* errorRow1;
+  int16_t* errorRow2;
+};
+}  // namespace reference
+
+using bench::Clock;
+using bench::msSince;
+
+// Dithers the image twice with a reset() in between, the levels of both passes go to out
+template <typename Ditherer>
+void dither(Ditherer& ditherer, const std::vector<uint8_t>& gray, const Size& size, std::vector<uint8_t>& out) {
+  out.resize(gray.size() * 2);
+  for (int pass = 0; pass < 2; pass++) {
+    ditherer.reset();
+    uint8_t* levels = out.data() + pass * gray.size();
+    for (int y = 0; y < size.height; y++) {
+      const uint8_t* row = gray.data() + y * size.width;
+      for (int x = 0; x < size.width; x++) {
+        levels[y * size.width + x] = ditherer.processPixel(row[x], x);
+      }
+      ditherer.nextRow();
+    }
+  }
+}
+
+template <typename Quantize>
+void quantizeAll(const Quantize& quantizeGray, const std::vector<uint8_t>& gray, const Size& size,
+                 std::vector<uint8_t>& out) {
+  out.resize(gray.size() * 2);
+  for (int pass = 0; pass < 2; pass++) {
+    uint8_t* levels = out.data() + pass * gray.size();
+    for (int y = 0; y < size.height; y++) {
+      for (int x = 0; x < size.width; x++) {
+        levels[y * size.width + x] = quantizeGray(gray[y * size.width + x], x, y);
+      }
+    }
+  }
+}
+
+struct Timing {
+  double referenceMs = 0;
+  double fastMs = 0;
+  bool identical = true;
+};
+
+template <typename Reference, typename Fast>
+Timing compare(const std::vector<uint8_t>& gray, const Size& size, const int iterations) {
+  Timing timing;
+  Reference reference(size.width);
+  Fast fast(size.width);
+  std::vector<uint8_t> expected;
+  std::vector<uint8_t> actual;
+  for (int i = 0; i < iterations; i++) {
+    auto start = Clock::now();
+    dither(reference, gray, size, expected);
+    timing.referenceMs += msSince(start);
+
+    start = Clock::now();
+    dither(fast, gray, size, actual);
+    timing.fastMs += msSince(start);
+    timing.identical &= expected == actual;
+  }
+  timing.referenceMs /= iterations;
+  timing.fastMs /= iterations;
+  return timing;
+}
+
+template <typename Quantize>
+double timeOrdered(const Quantize& quantizeGray, const std::vector<uint8_t>& gray, const Size& size,
+                   const int iterations) {
+  std::vector<uint8_t> out;
+  const auto start = Clock::now();
+  for (int i = 0; i < iterations; i++) {
+    quantizeAll(quantizeGray, gray, size, out);
+  }
+  return msSince(start) / iterations;
+}
+
+void printSpeedup(const Timing& t) {
+  if (t.fastMs > 0.001) {
+    printf("%.1f", t.referenceMs / t.fastMs);
+  } else {
+    printf("null");
+  }
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+  int iterations = DEFAULT_ITERATIONS;
+  bench::CommandLine commandLine;
+  commandLine.option("--iterations", "n", &iterations, "dithering passes per image and ditherer");
+  if (const int status = commandLine.parse(argc, argv); status >= 0) {
+    return status;
+  }
+  iterations = std::max(1, iterations);
+
+  bool failed = false;
+  printf("{\n  \"iterations\": %d,\n  \"images\": [\n", iterations);
+  constexpr size_t sizeCount = sizeof(SIZES) / sizeof(SIZES[0]);
+  constexpr size_t patternCount = sizeof(PATTERNS) / sizeof(PATTERNS[0]);
+  for (size_t s = 0; s < sizeCount; s++) {
+    const Size& size = SIZES[s];
+    for (size_t p = 0; p < patternCount; p++) {
+      std::vector<uint8_t> gray(size.width * size.height);
+      for (int y = 0; y < size.height; y++) {
+        for (int x = 0; x < size.width; x++) {
+          gray[y * size.width + x] = sample(PATTERNS[p], x, y, size);
+        }
+      }
+
+      const Timing atkinson = compare<reference::AtkinsonDitherer, AtkinsonDitherer>(gray, size, iterations);
+      const Timing atkinson1Bit =
+          compare<reference::Atkinson1BitDitherer, Atkinson1BitDitherer>(gray, size, iterations);
+      const double orderedMs = timeOrdered(
+          [](const int g, const int x, const int y) { return quantizeOrdered(g, x, y); }, gray, size, iterations);
+      const double ordered1BitMs = timeOrdered(
+          [](const int g, const int x, const int y) { return quantize1bitOrdered(g, x, y); }, gray, size, iterations);
+
+      const Timing* const timings[] = {&atkinson, &atkinson1Bit};
+      const char* const names[] = {"atkinson", "atkinson1Bit"};
+      printf("    {\"pattern\": \"%s\", \"size\": \"%dx%d\"", PATTERNS[p], size.width, size.height);
+      for (size_t i = 0; i < 2; i++) {
+        const Timing& t = *timings[i];
+        failed |= !t.identical;
+        printf(", \"%s\": {\"identical\": %s, \"referenceMs\": %.3f, \"fastMs\": %.3f, \"speedup\": ", names[i],
+               t.identical ? "true" : "false", t.referenceMs, t.fastMs);
+        printSpeedup(t);
+        printf("}");
+        if (!t.identical) {
+          fprintf(stderr, "%s %dx%d: %s output differs\n", PATTERNS[p], size.width, size.height, names[i]);
+        }
+      }
+      printf(", \"orderedMs\": %.3f, \"ordered1BitMs\": %.3f}%s\n", orderedMs, ordered1BitMs,
+             s + 1 == sizeCount && p + 1 == patternCount ? "" : ",");
+    }
+  }
+  printf("  ],\n  \"atkinsonInputRange\": [%d, %d]\n}\n", reference::minAdjusted, reference::maxAdjusted);
+
+  // The step tables only cover grays within DITHER_STEP_OFFSET of 0..255
+  if (reference::minAdjusted < -DITHER_STEP_OFFSET ||
+      reference::maxAdjusted >= DITHER_STEP_COUNT - DITHER_STEP_OFFSET) {
+    fprintf(stderr, "Atkinson input range [%d, %d] is outside the step tables\n", reference::minAdjusted,
+            reference::maxAdjusted);
+    failed = true;
+  }
+  return failed ? 1 : 0;
+}
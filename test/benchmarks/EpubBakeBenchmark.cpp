@@ -0,0 +1,396 @@
+/**
+ * EpubBakeBenchmark.cpp
+ *
+ * Bakes every EPUB in a directory with EpubBakeJob (see src/EpubBake.h), once with text anti-aliasing and once
+ * without. Each bake is interrupted half way, left with the unfinished tail of a page at the end of the book as a
+ * power cut would leave it, and continued by a new job. Until then every other step is told to yield, as a button
+ * press makes it in the reader, and the first chapter is left for the job to index. Then every page is drawn both ways
+ * the reader can:
+ *   - live, the page loaded from the section file and rendered for the BW pass and both gray passes
+ *   - baked, each pass blitted from the baked book, the gray passes only when it reports grey pixels
+ *
+ * Before the books, random frames go through xtc::XtcWriter into an XTC and an XTCH book and are read back.
+ *
+ * Every frame buffer must come out identical (and a baked page without grays must have nothing in the live gray
+ * passes), any difference makes the process exit with status 1.
+ */
+#include <Arduino.h>
+#include <BufferPool.h>
+#include <CrossPointSettings.h>
+#include <Epub.h>
+#include <Epub/Page.h>
+#include <Epub/Section.h>
+#include <EpubBake.h>
+#include <GfxRenderer.h>
+#include <HalDisplay.h>
+#include <SDCardManager.h>
+#include <Xtc/XtcParser.h>
+#include <Xtc/XtcWriter.h>
+#include <builtinFonts/all.h>
+
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "BenchmarkUtils.h"
+#include "fontIds.h"
+
+namespace {
+constexpr int ROUND_TRIP_PAGES = 4;
+constexpr size_t FRAME_SIZE = HalDisplay::BUFFER_SIZE;
+
+using Target = xtc::PageBlitter::Target;
+const Target TARGETS[] = {Target::Bw, Target::GrayscaleLsb, Target::GrayscaleMsb};
+
+using bench::Clock;
+using bench::msSince;
+
+EpdFont bookerly14RegularFont(&bookerly_14_regular);
+EpdFont bookerly14BoldFont(&bookerly_14_bold);
+EpdFont bookerly14ItalicFont(&bookerly_14_italic);
+EpdFont bookerly14BoldItalicFont(&bookerly_14_bolditalic);
+EpdFontFamily bookerly14FontFamily(&bookerly14RegularFont, &bookerly14BoldFont, &bookerly14ItalicFont,
+                                   &bookerly14BoldItalicFont);
+
+struct BakeResult {
+  std::string name;
+  bool antiAliasing = false;
+  std::string error;
+  int pages = 0;
+  int grayPages = 0;
+  int mismatches = 0;
+  uint32_t bakedBytes = 0;
+  int chapters = 0;
+  double bakeMs = 0;
+  double liveMs = 0;
+  double bakedMs = 0;
+};
+
+// The frames the reader builds for a page: BW, then GRAYSCALE_LSB and GRAYSCALE_MSB from a cleared buffer
+void renderLivePass(GfxRenderer& renderer, const Page& page, const EpubPageLayout& layout, const Target target) {
+  if (target == Target::Bw) {
+    renderer.clearScreen();
+    page.render(renderer, layout.fontId, layout.marginLeft, layout.marginTop);
+    return;
+  }
+  renderer.clearScreen(0x00);
+  renderer.setRenderMode(target == Target::GrayscaleLsb ? GfxRenderer::GRAYSCALE_LSB : GfxRenderer::GRAYSCALE_MSB);
+  if (layout.textAntiAliasing) {
+    page.render(renderer, layout.fontId, layout.marginLeft, layout.marginTop);
+  } else {
+    page.renderImages(renderer, layout.marginLeft, layout.marginTop);
+  }
+  renderer.setRenderMode(GfxRenderer::BW);
+}
+
+// Runs a job until it is done or failed, at most maxSteps steps (0 for no limit). Returns the steps taken. With
+// interrupted, every other step from the first is told to yield at its first check, as a button press would make it.
+int runJob(EpubBakeJob& job, const int maxSteps, EpubBakeJob::Status& status, const bool interrupted = false) {
+  int steps = 0;
+  status = EpubBakeJob::Status::Running;
+  while (status == EpubBakeJob::Status::Running && (maxSteps == 0 || steps < maxSteps)) {
+    const bool yield = interrupted && steps % 2 == 0;
+    status = job.step([yield] { return yield; });
+    steps++;
+  }
+  return steps;
+}
+
+void bakeBook(const std::string& path, GfxRenderer& renderer, const bool antiAliasing, BakeResult& result) {
+  SETTINGS.textAntiAliasing = antiAliasing;
+  const EpubPageLayout layout = EpubPageLayout::current(renderer);
+  auto epub = std::make_shared<Epub>(path, "/.crosspoint");
+  if (!epub->load(true)) {
+    result.error = "load failed";
+    return;
+  }
+  epub->setupCacheDir();
+
+  // Section files are laid out up front, the bake is timed on its own
+  int stepsNeeded = 1;
+  for (int i = 0; i < epub->getSpineItemsCount(); i++) {
+    Section section(epub, i, renderer);
+    if (!section.loadSectionFile(layout.fontId, layout.lineCompression, layout.extraParagraphSpacing,
+                                 layout.paragraphAlignment, layout.viewportWidth, layout.viewportHeight,
+                                 layout.hyphenationEnabled) &&
+        !section.createSectionFile(layout.fontId, layout.lineCompression, layout.extraParagraphSpacing,
+                                   layout.paragraphAlignment, layout.viewportWidth, layout.viewportHeight,
+                                   layout.hyphenationEnabled)) {
+      result.error = "layout failed for spine item " + std::to_string(i);
+      return;
+    }
+    stepsNeeded += section.pageCount + 1;
+  }
+  // Except the first, the job indexes that one itself: once stopped by a yield, then in full
+  if (!Section(epub, 0, renderer).clearCache()) {
+    result.error = "section file not removed";
+    return;
+  }
+  stepsNeeded++;
+
+  const auto bakeStart = Clock::now();
+  EpubBakeJob::Status status;
+  {
+    EpubBakeJob job(epub, renderer, layout);
+    if (!job.begin()) {
+      result.error = "bake didn't start";
+      return;
+    }
+    // About half the pages, the steps in between yield without baking anything
+    runJob(job, stepsNeeded, status, true);
+  }
+  if (status == EpubBakeJob::Status::Running) {
+    // Half a page nobody recorded, the continued job has to drop it
+    auto book = SdMan.open((epub->getCachePath() + "/baked.xtch").c_str(), O_RDWR);
+    book.seekEnd();
+    const uint8_t tail[700] = {0x58, 0x54, 0x48};
+    book.write(tail, sizeof(tail));
+    book.close();
+
+    EpubBakeJob job(epub, renderer, layout);
+    if (!job.begin()) {
+      result.error = "bake didn't continue";
+      return;
+    }
+    runJob(job, 0, status);
+  }
+  result.bakeMs = msSince(bakeStart);
+  if (status != EpubBakeJob::Status::Done) {
+    result.error = "bake failed";
+    return;
+  }
+
+  auto baked = BakedEpub::open(*epub, layout);
+  if (!baked) {
+    result.error = "baked book doesn't open";
+    return;
+  }
+  {
+    auto file = SdMan.open((epub->getCachePath() + "/baked.xtch").c_str());
+    result.bakedBytes = file.size();
+    file.close();
+    xtc::XtcParser parser;
+    if (parser.open((epub->getCachePath() + "/baked.xtch").c_str()) == xtc::XtcError::OK) {
+      result.chapters = parser.getChapterCount();
+    }
+  }
+
+  uint8_t* frameBuffer = renderer.getFrameBuffer();
+  std::vector<uint8_t> live[3];
+  for (int i = 0; i < epub->getSpineItemsCount(); i++) {
+    Section section(epub, i, renderer);
+    if (!section.loadSectionFile(layout.fontId, layout.lineCompression, layout.extraParagraphSpacing,
+                                 layout.paragraphAlignment, layout.viewportWidth, layout.viewportHeight,
+                                 layout.hyphenationEnabled)) {
+      result.error = "section file gone for spine item " + std::to_string(i);
+      return;
+    }
+    for (int p = 0; p < section.pageCount; p++) {
+      if (!baked->hasPage(i, p, section.pageCount)) {
+        result.error = "page " + std::to_string(p) + " of spine item " + std::to_string(i) + " not baked";
+        return;
+      }
+
+      section.currentPage = p;
+      auto start = Clock::now();
+      const auto page = section.loadPageFromSectionFile();
+      if (!page) {
+        result.error = "failed to load page " + std::to_string(p) + " of spine item " + std::to_string(i);
+        return;
+      }
+      const bool liveGrays = layout.textAntiAliasing || page->hasImages();
+      for (int t = 0; t < 3; t++) {
+        renderLivePass(renderer, *page, layout, TARGETS[t]);
+        live[t].assign(frameBuffer, frameBuffer + FRAME_SIZE);
+        if (!liveGrays) {
+          break;
+        }
+      }
+      result.liveMs += msSince(start);
+
+      start = Clock::now();
+      bool grays = false;
+      bool same = baked->drawPage(i, p, frameBuffer, Target::Bw, &grays) &&
+                  memcmp(frameBuffer, live[0].data(), FRAME_SIZE) == 0;
+      for (int t = 1; t < 3 && grays; t++) {
+        same &= baked->drawPage(i, p, frameBuffer, TARGETS[t]) &&
+                (!liveGrays || memcmp(frameBuffer, live[t].data(), FRAME_SIZE) == 0);
+      }
+      result.bakedMs += msSince(start);
+
+      // A page the baked book has no grays for must not have any in the live passes either
+      for (int t = 1; t < 3 && liveGrays && !grays; t++) {
+        same &= std::all_of(live[t].begin(), live[t].end(), [](const uint8_t b) { return b == 0; });
+      }
+      // And one with grays must give the live passes' frames, checked above, also when the live page skips them
+      if (grays && !liveGrays) {
+        same = false;
+      }
+
+      result.pages++;
+      result.grayPages += grays ? 1 : 0;
+      result.mismatches += same ? 0 : 1;
+    }
+  }
+}
+
+// Random frames of consistent passes: every pixel white, dark grey, light grey or black
+void randomFrames(std::mt19937& rng, uint8_t* bw, uint8_t* lsb, uint8_t* msb) {
+  for (size_t i = 0; i < FRAME_SIZE; i++) {
+    uint8_t white = 0, dark = 0, light = 0;
+    for (int bit = 0; bit < 8; bit++) {
+      // Mostly white, as a page is
+      const uint32_t r = rng() % 16;
+      const uint8_t mask = 0x80 >> bit;
+      if (r < 10) {
+        white |= mask;
+      } else if (r < 12) {
+        dark |= mask;
+      } else if (r < 14) {
+        light |= mask;
+      }
+    }
+    bw[i] = white;
+    lsb[i] = dark;
+    msb[i] = dark | light;
+  }
+}
+
+// Writes random frames through XtcWriter and reads every target back, false on any difference
+bool roundTrip(uint8_t* frameBuffer, const uint8_t bitDepth, uint32_t& bytes) {
+  const std::string path = bitDepth == 2 ? "/roundtrip.xtch" : "/roundtrip.xtc";
+  std::mt19937 rng(bitDepth);
+  std::vector<uint8_t> frames[ROUND_TRIP_PAGES][3];
+
+  xtc::XtcWriter writer;
+  if (!writer.open(path, bitDepth)) {
+    return false;
+  }
+  for (int p = 0; p < ROUND_TRIP_PAGES; p++) {
+    for (auto& frame : frames[p]) {
+      frame.resize(FRAME_SIZE);
+    }
+    randomFrames(rng, frames[p][0].data(), frames[p][1].data(), frames[p][2].data());
+    if (bitDepth == 1) {
+      // Black and white only
+      for (size_t i = 0; i < FRAME_SIZE; i++) {
+        frames[p][0][i] |= frames[p][2][i];
+      }
+    }
+    const auto draw = [&](const Target target) {
+      memcpy(frameBuffer, frames[p][static_cast<int>(target)].data(), FRAME_SIZE);
+    };
+    if (!writer.addPage(frameBuffer, draw)) {
+      return false;
+    }
+  }
+  if (!writer.finish("Round trip", "", {{"All", 0, ROUND_TRIP_PAGES - 1}})) {
+    return false;
+  }
+
+  xtc::XtcParser parser;
+  if (parser.open(path.c_str()) != xtc::XtcError::OK || parser.getPageCount() != ROUND_TRIP_PAGES ||
+      parser.getBitDepth() != bitDepth || parser.getChapterCount() != 1 || parser.getTitle() != "Round trip") {
+    return false;
+  }
+  bytes = SdMan.open(path.c_str()).size();
+  for (int p = 0; p < ROUND_TRIP_PAGES; p++) {
+    for (int t = 0; t < (bitDepth == 2 ? 3 : 1); t++) {
+      memset(frameBuffer, 0x55, FRAME_SIZE);
+      xtc::PageBlitter blitter(frameBuffer, parser.getWidth(), parser.getHeight(), bitDepth, TARGETS[t]);
+      const auto error = parser.loadPageStreaming(
+          p, [&blitter](const uint8_t* data, const size_t size, const size_t offset) {
+            blitter.addChunk(data, size, offset);
+          });
+      blitter.finish();
+      if (error != xtc::XtcError::OK || memcmp(frameBuffer, frames[p][t].data(), FRAME_SIZE) != 0) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+  std::string bookDir;
+  bool verbose = false;
+
+  bench::CommandLine commandLine;
+  commandLine
+      .directory("epub dir", &bookDir,
+                 "directory holding the books, used as the SD card root (caches go to .crosspoint)")
+      .flag("--verbose", &verbose, "print the firmware log to stderr");
+  if (const int status = commandLine.parse(argc, argv); status >= 0) {
+    return status;
+  }
+
+  FILE* log = bench::logOutput(verbose);
+  Serial.setOutput(log);
+
+  SdMan.setRootPath(bookDir);
+  SdMan.begin();
+  SdMan.mkdir("/.crosspoint");
+
+  HalDisplay display;
+  display.begin();
+  GfxRenderer renderer(display);
+  renderer.insertFont(BOOKERLY_14_FONT_ID, bookerly14FontFamily);
+  BUFFER_POOL.begin();
+
+  bool failed = false;
+  uint32_t xtcBytes = 0, xtchBytes = 0;
+  const bool xtcIdentical = roundTrip(renderer.getFrameBuffer(), 1, xtcBytes);
+  const bool xtchIdentical = roundTrip(renderer.getFrameBuffer(), 2, xtchBytes);
+  SdMan.remove("/roundtrip.xtc");
+  SdMan.remove("/roundtrip.xtch");
+  failed |= !xtcIdentical || !xtchIdentical;
+
+  std::vector<std::string> books;
+  auto root = SdMan.open("/");
+  for (auto file = root.openNextFile(); file; file = root.openNextFile()) {
+    char name[256];
+    file.getName(name, sizeof(name));
+    std::string filename = name;
+    if (!file.isDirectory() && filename.size() > 5 && filename.substr(filename.size() - 5) == ".epub") {
+      books.push_back(filename);
+    }
+  }
+  root.close();
+  std::sort(books.begin(), books.end());
+
+  std::vector<BakeResult> results;
+  for (const auto& name : books) {
+    for (const bool antiAliasing : {true, false}) {
+      BakeResult result;
+      result.name = name;
+      result.antiAliasing = antiAliasing;
+      fprintf(stderr, "%s%s\n", name.c_str(), antiAliasing ? "" : " (no anti-aliasing)");
+      bakeBook("/" + name, renderer, antiAliasing, result);
+      failed |= !result.error.empty() || result.mismatches > 0;
+      results.push_back(result);
+    }
+  }
+
+  printf("{\n  \"roundTrip\": {\"xtcIdentical\": %s, \"xtcBytes\": %u, \"xtchIdentical\": %s, \"xtchBytes\": %u},\n",
+         xtcIdentical ? "true" : "false", xtcBytes, xtchIdentical ? "true" : "false", xtchBytes);
+  printf("  \"books\": [\n");
+  for (size_t i = 0; i < results.size(); i++) {
+    const auto& r = results[i];
+    const int pages = std::max(r.pages, 1);
+    printf("    {\"book\": \"%s\", \"antiAliasing\": %s, \"ok\": %s", bench::jsonEscape(r.name).c_str(),
+           r.antiAliasing ? "true" : "false", r.error.empty() && r.mismatches == 0 ? "true" : "false");
+    if (!r.error.empty()) {
+      printf(", \"error\": \"%s\"", bench::jsonEscape(r.error).c_str());
+    }
+    printf(
+        ", \"pages\": %d, \"grayPages\": %d, \"mismatches\": %d, \"chapters\": %d, \"bytesPerPage\": %u, "
+        "\"bakeMsPerPage\": %.2f, \"liveMsPerPage\": %.2f, \"bakedMsPerPage\": %.2f}%s\n",
+        r.pages, r.grayPages, r.mismatches, r.chapters, r.bakedBytes / pages, r.bakeMs / pages, r.liveMs / pages,
+        r.bakedMs / pages, i + 1 == results.size() ? "" : ",");
+  }
+  printf("  ]\n}\n");
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,132 @@
+#include "HeapTracker.h"
+
+#include <malloc.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+extern "C" {
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t count, size_t size);
+void* __real_realloc(void* ptr, size_t size);
+void __real_free(void* ptr);
+}
+
+namespace {
+std::atomic<uint64_t> allocCount{0};
+std::atomic<uint64_t> failedAllocCount{0};
+std::atomic<int64_t> liveBytes{0};
+std::atomic<int64_t> peakBytes{0};
+// Absolute live size allocations may not exceed, 0 when unlimited
+std::atomic<int64_t> liveLimit{0};
+size_t budget = 0;
+
+// Sizes are taken from the allocator so frees need no bookkeeping of their own
+bool reserve(const size_t size) {
+  const int64_t limit = liveLimit.load(std::memory_order_relaxed);
+  if (limit != 0 && liveBytes.load(std::memory_order_relaxed) + static_cast<int64_t>(size) > limit) {
+    failedAllocCount.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  return true;
+}
+
+void recordAlloc(void* ptr) {
+  if (!ptr) {
+    return;
+  }
+  allocCount.fetch_add(1, std::memory_order_relaxed);
+  const auto size = static_cast<int64_t>(malloc_usable_size(ptr));
+  const int64_t live = liveBytes.fetch_add(size, std::memory_order_relaxed) + size;
+  int64_t peak = peakBytes.load(std::memory_order_relaxed);
+  while (live > peak && !peakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+  }
+}
+
+void recordFree(void* ptr) {
+  if (ptr) {
+    liveBytes.fetch_sub(static_cast<int64_t>(malloc_usable_size(ptr)), std::memory_order_relaxed);
+  }
+}
+}  // namespace
+
+extern "C" {
+void* __wrap_malloc(const size_t size) {
+  if (!reserve(size)) {
+    return nullptr;
+  }
+  void* ptr = __real_malloc(size);
+  recordAlloc(ptr);
+  return ptr;
+}
+
+void* __wrap_calloc(const size_t count, const size_t size) {
+  if (!reserve(count * size)) {
+    return nullptr;
+  }
+  void* ptr = __real_calloc(count, size);
+  recordAlloc(ptr);
+  return ptr;
+}
+
+void* __wrap_realloc(void* ptr, const size_t size) {
+  const size_t oldSize = ptr ? malloc_usable_size(ptr) : 0;
+  if (size > oldSize && !reserve(size - oldSize)) {
+    return nullptr;
+  }
+  recordFree(ptr);
+  void* result = __real_realloc(ptr, size);
+  if (!result && ptr) {
+    // Failed realloc leaves the original block in place
+    recordAlloc(ptr);
+    allocCount.fetch_sub(1, std::memory_order_relaxed);
+    return nullptr;
+  }
+  recordAlloc(result);
+  return result;
+}
+
+void __wrap_free(void* ptr) {
+  recordFree(ptr);
+  __real_free(ptr);
+}
+}
+
+void* operator new(const size_t size) {
+  void* ptr = __wrap_malloc(size == 0 ? 1 : size);
+  if (!ptr) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+void* operator new[](const size_t size) { return operator new(size); }
+
+void* operator new(const size_t size, const std::nothrow_t&) noexcept { return __wrap_malloc(size == 0 ? 1 : size); }
+
+void* operator new[](const size_t size, const std::nothrow_t&) noexcept {
+  return __wrap_malloc(size == 0 ? 1 : size);
+}
+
+void operator delete(void* ptr) noexcept { __wrap_free(ptr); }
+void operator delete[](void* ptr) noexcept { __wrap_free(ptr); }
+void operator delete(void* ptr, size_t) noexcept { __wrap_free(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { __wrap_free(ptr); }
+
+namespace heap_tracker {
+
+Stats snapshot() {
+  return {allocCount.load(), failedAllocCount.load(), liveBytes.load(), peakBytes.load()};
+}
+
+void resetPeak() { peakBytes.store(liveBytes.load()); }
+
+void setBudget(const size_t bytes) {
+  budget = bytes;
+  liveLimit.store(bytes == 0 ? 0 : liveBytes.load() + static_cast<int64_t>(bytes));
+}
+
+size_t getBudget() { return budget; }
+
+}  // namespace heap_tracker
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * HeapTracker.h
+ *
+ * Counts every malloc/calloc/realloc/free and operator new/delete made by the firmware code linked into a host
+ * benchmark. The C allocator is intercepted with the linker's --wrap (see HEAP_TRACKER_LDFLAGS in
+ * test/host_build.sh), C++ allocations go through replacement operator new/delete.
+ *
+ * A budget can be set to simulate the ESP32-C3 heap: once live allocations would grow past it malloc returns nullptr
+ * and operator new throws std::bad_alloc, just like running out of memory on the device.
+ */
+namespace heap_tracker {
+
+struct Stats {
+  uint64_t allocCount;
+  uint64_t failedAllocCount;
+  int64_t liveBytes;
+  int64_t peakBytes;
+};
+
+Stats snapshot();
+
+// Restarts peak tracking from the current live size
+void resetPeak();
+
+// Limits live allocations to `bytes` on top of what is live right now, 0 removes the limit
+void setBudget(size_t bytes);
+size_t getBudget();
+
+}  // namespace heap_tracker
@@ -0,0 +1,668 @@
+/**
+ * JpegScaleBenchmark.cpp
+ *
+ * Checks the DCT scaled JPEG decode of JpegToBmpConverter::Job against the full size decode. Encodes test JPEGs of
+ * every scan type picojpeg supports (grayscale, 4:4:4, 4:2:2, 4:4:0 and 4:2:0, sizes that are not a multiple of the
+ * MCU) in a scratch directory, then converts each one, and any other .jpg/.jpeg already in the directory, to the
+ * cover, cropped cover, home thumbnail and grid thumbnail targets:
+ *   - once with the scale the job picks and once with disableScaledDecode(), timing both and tracking the heap
+ *   - the outputs must have the same size, and after averaging 16x16 blocks of output pixels (which evens out the
+ *     dithering) they must not differ by more than --max-mean-diff gray levels on average
+ *
+ * The decodes section compares picojpeg's 1/2, 1/4 and 1/8 output with the average of the full size pixels each
+ * scaled pixel covers. It is for information: hard edges and stripes finer than the scaled pixels differ by design,
+ * the scaled decode drops the frequencies the smaller image can't show instead of aliasing them.
+ *
+ * A size mismatch, a failed scaled conversion or decode or too large a difference makes the process exit with
+ * status 1.
+ */
+#include <Arduino.h>
+#include <JpegToBmpConverter.h>
+#include <SDCardManager.h>
+#include <picojpeg.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <string>
+#include <vector>
+
+#include "BenchmarkUtils.h"
+#include "HeapTracker.h"
+
+namespace {
+constexpr double DEFAULT_MAX_MEAN_DIFF = 4.0;
+constexpr int DIFF_BLOCK = 16;
+
+struct Case {
+  const char* name;
+  int width;
+  int height;
+  int components;
+  int lumaH;  // Luma sampling factors, chroma is always 1x1
+  int lumaV;
+};
+
+const Case CASES[] = {
+    {"gen_gray.jpg", 600, 900, 1, 1, 1},      {"gen_444.jpg", 721, 1003, 3, 1, 1},
+    {"gen_422.jpg", 1000, 1500, 3, 2, 1},     {"gen_440.jpg", 801, 1203, 3, 1, 2},
+    {"gen_420.jpg", 1600, 2560, 3, 2, 2},     {"gen_420_large.jpg", 2000, 3000, 3, 2, 2},
+    {"gen_420_small.jpg", 300, 420, 3, 2, 2},
+};
+
+struct Targets {
+  const char* name;
+  JpegToBmpConverter::Target targets[4];
+  size_t count;
+};
+
+// The conversions the firmware runs: the sleep covers and thumbnails, alone and as the single job of
+// Epub::CoverImagesJob
+const Targets TARGETS[] = {
+    {"cover", {{nullptr, 480, 800, JpegToBmpConverter::Output::Bmp2Bit, false}}, 1},
+    {"crop", {{nullptr, 480, 800, JpegToBmpConverter::Output::Bmp2Bit, true}}, 1},
+    {"thumb", {{nullptr, 240, 400, JpegToBmpConverter::Output::Bmp1Bit, true}}, 1},
+    {"grid", {{nullptr, 120, 180, JpegToBmpConverter::Output::Bmp1Bit, true}}, 1},
+    {"all",
+     {{nullptr, 480, 800, JpegToBmpConverter::Output::Bmp2Bit, false},
+      {nullptr, 480, 800, JpegToBmpConverter::Output::Bmp2Bit, true},
+      {nullptr, 240, 400, JpegToBmpConverter::Output::Bmp1Bit, true},
+      {nullptr, 120, 180, JpegToBmpConverter::Output::Bmp1Bit, true}},
+     4},
+};
+
+// --- Test image -----------------------------------------------------------------------------------------------------
+
+// Smooth gradients, hard edges, fine stripes and thin lines, so both the low and the high frequencies matter
+void pixelAt(const Case& c, const int x, const int y, int rgb[3]) {
+  const double fx = static_cast<double>(x) / c.width;
+  const double fy = static_cast<double>(y) / c.height;
+  rgb[0] = static_cast<int>(128 + 100 * std::sin(x / 37.0) * std::cos(y / 53.0));
+  rgb[1] = static_cast<int>(255 * fx);
+  rgb[2] = ((x / 40 + y / 40) & 1) ? 230 : 30;
+  if (fy > 0.6 && fy < 0.8) {
+    // Stripes two pixels wide
+    const int stripe = ((x + y) / 2) & 1 ? 255 : 0;
+    rgb[0] = rgb[1] = rgb[2] = stripe;
+  }
+  if (x % 97 == 0 || y % 89 == 0) {
+    rgb[0] = rgb[1] = rgb[2] = 0;
+  }
+}
+
+// --- Baseline JPEG encoder ------------------------------------------------------------------------------------------
+
+class JpegEncoder {
+  std::vector<uint8_t>& out;
+  uint32_t bitBuffer = 0;
+  int bitCount = 0;
+  uint8_t zigzag[64];  // Natural index of each zigzag position
+  uint8_t quant[64];   // Natural order
+  double cosTable[8][8];
+
+  void put16(const int value) {
+    out.push_back(static_cast<uint8_t>(value >> 8));
+    out.push_back(static_cast<uint8_t>(value));
+  }
+
+  void putBits(const uint32_t code, const int length) {
+    bitBuffer = bitBuffer << length | (code & ((1u << length) - 1));
+    bitCount += length;
+    while (bitCount >= 8) {
+      const uint8_t byte = static_cast<uint8_t>(bitBuffer >> (bitCount - 8));
+      out.push_back(byte);
+      if (byte == 0xFF) {
+        out.push_back(0);
+      }
+      bitCount -= 8;
+    }
+  }
+
+  // Flat Huffman tables that cover every symbol: the 12 DC categories get 4 bit codes, the 162 AC run/size symbols
+  // 8 bit ones, the code of a symbol is its index
+  static int acSymbolIndex(const int symbol) {
+    if (symbol == 0x00) return 0;
+    if (symbol == 0xF0) return 1;
+    return 2 + (symbol >> 4) * 10 + (symbol & 0xF) - 1;
+  }
+
+  static int category(int value) {
+    value = std::abs(value);
+    int bits = 0;
+    while (value) {
+      bits++;
+      value >>= 1;
+    }
+    return bits;
+  }
+
+  void putValue(const int value, const int bits) { putBits(value < 0 ? value + (1 << bits) - 1 : value, bits); }
+
+  void encodeBlock(const double* pixels, int& previousDc) {
+    int coefficients[64];
+    for (int v = 0; v < 8; v++) {
+      for (int u = 0; u < 8; u++) {
+        double sum = 0;
+        for (int y = 0; y < 8; y++) {
+          for (int x = 0; x < 8; x++) {
+            sum += (pixels[y * 8 + x] - 128) * cosTable[u][x] * cosTable[v][y];
+          }
+        }
+        const double cu = u == 0 ? M_SQRT1_2 : 1;
+        const double cv = v == 0 ? M_SQRT1_2 : 1;
+        coefficients[v * 8 + u] = static_cast<int>(std::lround(sum * cu * cv / 4 / quant[v * 8 + u]));
+      }
+    }
+
+    const int dc = coefficients[0] - previousDc;
+    previousDc = coefficients[0];
+    const int dcBits = category(dc);
+    putBits(dcBits, 4);
+    putValue(dc, dcBits);
+
+    int run = 0;
+    for (int k = 1; k < 64; k++) {
+      const int ac = coefficients[zigzag[k]];
+      if (ac == 0) {
+        run++;
+        continue;
+      }
+      while (run > 15) {
+        putBits(acSymbolIndex(0xF0), 8);
+        run -= 16;
+      }
+      const int bits = category(ac);
+      putBits(acSymbolIndex(run << 4 | bits), 8);
+      putValue(ac, bits);
+      run = 0;
+    }
+    if (run > 0) {
+      putBits(acSymbolIndex(0x00), 8);
+    }
+  }
+
+ public:
+  explicit JpegEncoder(std::vector<uint8_t>& out) : out(out) {
+    int k = 0;
+    for (int diagonal = 0; diagonal < 15; diagonal++) {
+      for (int i = 0; i <= diagonal; i++) {
+        const int row = diagonal & 1 ? i : diagonal - i;
+        const int col = diagonal - row;
+        if (row < 8 && col < 8) {
+          zigzag[k++] = static_cast<uint8_t>(row * 8 + col);
+        }
+      }
+    }
+    for (int v = 0; v < 8; v++) {
+      for (int u = 0; u < 8; u++) {
+        quant[v * 8 + u] = static_cast<uint8_t>(4 + 2 * (u + v));
+      }
+    }
+    for (int u = 0; u < 8; u++) {
+      for (int x = 0; x < 8; x++) {
+        cosTable[u][x] = std::cos((2 * x + 1) * u * M_PI / 16);
+      }
+    }
+  }
+
+  void encode(const Case& c) {
+    const int components = c.components;
+    const int mcuWidth = 8 * c.lumaH;
+    const int mcuHeight = 8 * c.lumaV;
+
+    put16(0xFFD8);
+    put16(0xFFDB);
+    put16(67);
+    out.push_back(0);
+    for (const uint8_t index : zigzag) {
+      out.push_back(quant[index]);
+    }
+    put16(0xFFC0);
+    put16(8 + 3 * components);
+    out.push_back(8);
+    put16(c.height);
+    put16(c.width);
+    out.push_back(components);
+    for (int i = 0; i < components; i++) {
+      out.push_back(i + 1);
+      out.push_back(i == 0 ? c.lumaH << 4 | c.lumaV : 0x11);
+      out.push_back(0);
+    }
+    put16(0xFFC4);
+    put16(2 + 17 + 12);
+    out.push_back(0x00);
+    for (int length = 1; length <= 16; length++) {
+      out.push_back(length == 4 ? 12 : 0);
+    }
+    for (int i = 0; i < 12; i++) {
+      out.push_back(i);
+    }
+    put16(0xFFC4);
+    put16(2 + 17 + 162);
+    out.push_back(0x10);
+    for (int length = 1; length <= 16; length++) {
+      out.push_back(length == 8 ? 162 : 0);
+    }
+    out.push_back(0x00);
+    out.push_back(0xF0);
+    for (int run = 0; run < 16; run++) {
+      for (int size = 1; size <= 10; size++) {
+        out.push_back(run << 4 | size);
+      }
+    }
+    put16(0xFFDA);
+    put16(6 + 2 * components);
+    out.push_back(components);
+    for (int i = 0; i < components; i++) {
+      out.push_back(i + 1);
+      out.push_back(0x00);
+    }
+    out.push_back(0);
+    out.push_back(63);
+    out.push_back(0);
+
+    // YCbCr planes of one MCU, chroma averaged over the luma sampling factors
+    std::vector<double> planes[3];
+    for (auto& plane : planes) {
+      plane.resize(mcuWidth * mcuHeight);
+    }
+    int previousDc[3] = {0, 0, 0};
+    double block[64];
+    for (int mcuY = 0; mcuY < c.height; mcuY += mcuHeight) {
+      for (int mcuX = 0; mcuX < c.width; mcuX += mcuWidth) {
+        for (int y = 0; y < mcuHeight; y++) {
+          for (int x = 0; x < mcuWidth; x++) {
+            int rgb[3];
+            // Edge MCUs repeat the last row and column
+            pixelAt(c, std::min(mcuX + x, c.width - 1), std::min(mcuY + y, c.height - 1), rgb);
+            const int i = y * mcuWidth + x;
+            if (components == 1) {
+              planes[0][i] = (rgb[0] * 25 + rgb[1] * 50 + rgb[2] * 25) / 100;
+              continue;
+            }
+            planes[0][i] = 0.299 * rgb[0] + 0.587 * rgb[1] + 0.114 * rgb[2];
+            planes[1][i] = 128 - 0.168736 * rgb[0] - 0.331264 * rgb[1] + 0.5 * rgb[2];
+            planes[2][i] = 128 + 0.5 * rgb[0] - 0.418688 * rgb[1] - 0.081312 * rgb[2];
+          }
+        }
+
+        for (int blockY = 0; blockY < c.lumaV; blockY++) {
+          for (int blockX = 0; blockX < c.lumaH; blockX++) {
+            for (int y = 0; y < 8; y++) {
+              for (int x = 0; x < 8; x++) {
+                block[y * 8 + x] = planes[0][(blockY * 8 + y) * mcuWidth + blockX * 8 + x];
+              }
+            }
+            encodeBlock(block, previousDc[0]);
+          }
+        }
+        for (int i = 1; i < components; i++) {
+          for (int y = 0; y < 8; y++) {
+            for (int x = 0; x < 8; x++) {
+              double sum = 0;
+              for (int sy = 0; sy < c.lumaV; sy++) {
+                for (int sx = 0; sx < c.lumaH; sx++) {
+                  sum += planes[i][(y * c.lumaV + sy) * mcuWidth + x * c.lumaH + sx];
+                }
+              }
+              block[y * 8 + x] = sum / (c.lumaH * c.lumaV);
+            }
+          }
+          encodeBlock(block, previousDc[i]);
+        }
+      }
+    }
+
+    // Pad the last byte with ones
+    putBits(0x7F, 7);
+    put16(0xFFD9);
+  }
+};
+
+bool writeJpeg(const Case& c) {
+  std::vector<uint8_t> jpeg;
+  JpegEncoder(jpeg).encode(c);
+  FsFile file;
+  if (!SdMan.openFileForWrite("JPG", std::string("/") + c.name, file)) {
+    return false;
+  }
+  const bool written = file.write(jpeg.data(), jpeg.size()) == jpeg.size();
+  file.close();
+  return written;
+}
+
+// --- picojpeg output ------------------------------------------------------------------------------------------------
+
+struct Image {
+  int width = 0;
+  int height = 0;
+  std::vector<uint8_t> gray;
+};
+
+struct MemorySource {
+  const std::vector<uint8_t>& bytes;
+  size_t position;
+};
+
+unsigned char readMemory(unsigned char* buffer, const unsigned char size, unsigned char* read, void* data) {
+  auto* source = static_cast<MemorySource*>(data);
+  const size_t count = std::min<size_t>(size, source->bytes.size() - source->position);
+  memcpy(buffer, source->bytes.data() + source->position, count);
+  source->position += count;
+  *read = static_cast<unsigned char>(count);
+  return 0;
+}
+
+// Decodes the whole image with picojpeg at 1/scale of its size
+bool decodeGray(const std::vector<uint8_t>& jpeg, const int scale, Image& image) {
+  static const unsigned char REDUCE[] = {PJPG_REDUCE_NONE, PJPG_REDUCE_NONE, PJPG_REDUCE_HALF, 0,
+                                         PJPG_REDUCE_QUARTER, 0, 0, 0, PJPG_REDUCE_EIGHTH};
+  MemorySource source = {jpeg, 0};
+  pjpeg_image_info_t info;
+  if (pjpeg_decode_init(&info, readMemory, &source, REDUCE[scale]) != 0) {
+    return false;
+  }
+  const int blockSize = 8 / scale;
+  const int mcuWidth = info.m_MCUWidth / scale;
+  const int mcuHeight = info.m_MCUHeight / scale;
+  image.width = (info.m_width + scale - 1) / scale;
+  image.height = (info.m_height + scale - 1) / scale;
+  image.gray.assign(static_cast<size_t>(image.width) * image.height, 0);
+  for (int mcuY = 0; mcuY < info.m_MCUSPerCol; mcuY++) {
+    for (int mcuX = 0; mcuX < info.m_MCUSPerRow; mcuX++) {
+      if (pjpeg_decode_mcu() != 0) {
+        return false;
+      }
+      for (int y = 0; y < mcuHeight; y++) {
+        for (int x = 0; x < mcuWidth; x++) {
+          const int pixelX = mcuX * mcuWidth + x;
+          const int pixelY = mcuY * mcuHeight + y;
+          if (pixelX >= image.width || pixelY >= image.height) continue;
+          const int offset = y / blockSize * 128 + x / blockSize * 64 + y % blockSize * 8 + x % blockSize;
+          image.gray[static_cast<size_t>(pixelY) * image.width + pixelX] =
+              info.m_comps == 1 ? info.m_pMCUBufR[offset]
+                                : (info.m_pMCUBufR[offset] * 25 + info.m_pMCUBufG[offset] * 50 +
+                                   info.m_pMCUBufB[offset] * 25) /
+                                      100;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+// Mean and largest difference of each scaled pixel from the average of the full size pixels it covers
+bool compareScaled(const std::vector<uint8_t>& jpeg, const Image& full, const int scale, double& meanDiff,
+                   int& maxDiff) {
+  Image scaled;
+  if (!decodeGray(jpeg, scale, scaled)) {
+    return false;
+  }
+  double total = 0;
+  maxDiff = 0;
+  for (int y = 0; y < scaled.height; y++) {
+    for (int x = 0; x < scaled.width; x++) {
+      int sum = 0;
+      int count = 0;
+      for (int fy = y * scale; fy < (y + 1) * scale && fy < full.height; fy++) {
+        for (int fx = x * scale; fx < (x + 1) * scale && fx < full.width; fx++) {
+          sum += full.gray[static_cast<size_t>(fy) * full.width + fx];
+          count++;
+        }
+      }
+      const int diff = std::abs((sum + count / 2) / count - scaled.gray[static_cast<size_t>(y) * scaled.width + x]);
+      total += diff;
+      maxDiff = std::max(maxDiff, diff);
+    }
+  }
+  meanDiff = total / (static_cast<double>(scaled.width) * scaled.height);
+  return true;
+}
+
+// --- Conversion -----------------------------------------------------------------------------------------------------
+
+class MemoryPrint final : public Print {
+ public:
+  std::vector<uint8_t> bytes;
+  size_t write(const uint8_t c) override {
+    bytes.push_back(c);
+    return 1;
+  }
+  size_t write(const uint8_t* buffer, const size_t size) override {
+    bytes.insert(bytes.end(), buffer, buffer + size);
+    return size;
+  }
+};
+
+uint32_t readLE32(const uint8_t* bytes) {
+  return bytes[0] | bytes[1] << 8 | bytes[2] << 16 | static_cast<uint32_t>(bytes[3]) << 24;
+}
+
+// Gray pixels of a 1 or 2 bit BMP as written by BmpRowWriter
+bool readBmp(const std::vector<uint8_t>& bmp, Image& image) {
+  if (bmp.size() < 54 || bmp[0] != 'B' || bmp[1] != 'M') {
+    return false;
+  }
+  const uint32_t dataOffset = readLE32(&bmp[10]);
+  const int width = static_cast<int32_t>(readLE32(&bmp[18]));
+  const int height = static_cast<int32_t>(readLE32(&bmp[22]));
+  const int bitsPerPixel = bmp[28] | bmp[29] << 8;
+  if (bitsPerPixel != 1 && bitsPerPixel != 2) {
+    return false;
+  }
+  image.width = width;
+  image.height = std::abs(height);
+  image.gray.resize(static_cast<size_t>(image.width) * image.height);
+  const size_t rowBytes = (static_cast<size_t>(width) * bitsPerPixel + 31) / 32 * 4;
+  if (dataOffset + rowBytes * image.height > bmp.size()) {
+    return false;
+  }
+  const uint8_t* palette = &bmp[54];
+  const int pixelsPerByte = 8 / bitsPerPixel;
+  for (int y = 0; y < image.height; y++) {
+    // Positive heights are stored bottom up
+    const uint8_t* row = &bmp[dataOffset + rowBytes * (height > 0 ? image.height - 1 - y : y)];
+    for (int x = 0; x < width; x++) {
+      const int shift = 8 - bitsPerPixel * (x % pixelsPerByte + 1);
+      const int index = row[x / pixelsPerByte] >> shift & ((1 << bitsPerPixel) - 1);
+      image.gray[static_cast<size_t>(y) * width + x] = palette[index * 4];
+    }
+  }
+  return true;
+}
+
+struct Result {
+  bool ok = false;
+  double ms = 0;
+  int64_t peakHeap = 0;
+  std::vector<Image> images;
+};
+
+Result convert(const std::string& name, const Targets& targets, const bool scaled) {
+  Result result;
+  FsFile jpeg;
+  if (!SdMan.openFileForRead("JPG", "/" + name, jpeg)) {
+    return result;
+  }
+  std::vector<MemoryPrint> outputs(targets.count);
+  JpegToBmpConverter::Target jobTargets[4];
+  for (size_t i = 0; i < targets.count; i++) {
+    jobTargets[i] = targets.targets[i];
+    jobTargets[i].out = &outputs[i];
+    // Room for a 2-bit BMP of the largest image, so the outputs don't grow while the heap is tracked
+    outputs[i].bytes.reserve(JpegToBmpConverter::MAX_IMAGE_WIDTH * JpegToBmpConverter::MAX_IMAGE_HEIGHT / 4 + 1024);
+  }
+
+  heap_tracker::resetPeak();
+  const auto heapStart = heap_tracker::snapshot();
+  const auto start = bench::Clock::now();
+  {
+    JpegToBmpConverter::Job job(jpeg, jobTargets, targets.count);
+    if (!scaled) {
+      job.disableScaledDecode();
+    }
+    if (job.begin()) {
+      JpegToBmpConverter::Job::Status status;
+      do {
+        status = job.step();
+      } while (status == JpegToBmpConverter::Job::Status::Running);
+      result.ok = status == JpegToBmpConverter::Job::Status::Done;
+    }
+  }
+  result.ms = bench::msSince(start);
+  result.peakHeap = heap_tracker::snapshot().peakBytes - heapStart.liveBytes;
+  jpeg.close();
+
+  result.images.resize(targets.count);
+  for (size_t i = 0; i < targets.count && result.ok; i++) {
+    result.ok = readBmp(outputs[i].bytes, result.images[i]);
+  }
+  return result;
+}
+
+// Mean and largest difference of the DIFF_BLOCK x DIFF_BLOCK block averages
+void compare(const Image& a, const Image& b, double& meanDiff, double& maxDiff) {
+  double total = 0;
+  int blocks = 0;
+  maxDiff = 0;
+  for (int by = 0; by < a.height; by += DIFF_BLOCK) {
+    for (int bx = 0; bx < a.width; bx += DIFF_BLOCK) {
+      int sumA = 0;
+      int sumB = 0;
+      int count = 0;
+      for (int y = by; y < by + DIFF_BLOCK && y < a.height; y++) {
+        for (int x = bx; x < bx + DIFF_BLOCK && x < a.width; x++) {
+          sumA += a.gray[static_cast<size_t>(y) * a.width + x];
+          sumB += b.gray[static_cast<size_t>(y) * b.width + x];
+          count++;
+        }
+      }
+      const double diff = std::abs(sumA - sumB) / static_cast<double>(count);
+      total += diff;
+      maxDiff = std::max(maxDiff, diff);
+      blocks++;
+    }
+  }
+  meanDiff = blocks ? total / blocks : 0;
+}
+
+bool isJpeg(const std::string& name) {
+  const size_t dot = name.rfind('.');
+  if (dot == std::string::npos) return false;
+  std::string extension = name.substr(dot);
+  std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+  return extension == ".jpg" || extension == ".jpeg";
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+  std::string scratchDir;
+  double maxMeanDiff = DEFAULT_MAX_MEAN_DIFF;
+  bool verbose = false;
+
+  bench::CommandLine commandLine;
+  commandLine
+      .directory("scratch dir", &scratchDir,
+                 "where the test images are written, used as the SD card root. JPEGs already in it are\n"
+                 "compared too.")
+      .option("--max-mean-diff", "levels", &maxMeanDiff,
+              "largest mean difference of the 16x16 block averages, in gray levels")
+      .flag("--verbose", &verbose, "print the firmware log to stderr");
+  if (const int status = commandLine.parse(argc, argv); status >= 0) {
+    return status;
+  }
+
+  FILE* log = bench::logOutput(verbose);
+  Serial.setOutput(log);
+  SdMan.setRootPath(scratchDir);
+  SdMan.begin();
+
+  for (const Case& c : CASES) {
+    if (!writeJpeg(c)) {
+      fprintf(stderr, "Failed to write %s\n", c.name);
+      return 2;
+    }
+  }
+  std::vector<std::string> names;
+  if (DIR* dir = opendir(scratchDir.c_str())) {
+    while (const dirent* entry = readdir(dir)) {
+      if (isJpeg(entry->d_name)) {
+        names.emplace_back(entry->d_name);
+      }
+    }
+    closedir(dir);
+  }
+  std::sort(names.begin(), names.end());
+
+  bool failed = false;
+  bool first = true;
+  printf("{\n  \"maxMeanDiff\": %.1f,\n  \"decodes\": [\n", maxMeanDiff);
+  for (const std::string& name : names) {
+    std::vector<uint8_t> jpeg;
+    FsFile file;
+    if (SdMan.openFileForRead("JPG", "/" + name, file)) {
+      jpeg.resize(file.size());
+      jpeg.resize(std::max(file.read(jpeg.data(), jpeg.size()), 0));
+      file.close();
+    }
+    Image full;
+    const bool decoded = decodeGray(jpeg, 1, full);
+    for (const int scale : {2, 4, 8}) {
+      double meanDiff = 0;
+      int maxDiff = 0;
+      const bool ok = decoded && compareScaled(jpeg, full, scale, meanDiff, maxDiff);
+      failed |= !ok;
+      printf("%s    {\"image\": \"%s\", \"scale\": %d, \"ok\": %s, \"meanDiff\": %.2f, \"maxDiff\": %d}",
+             first ? "" : ",\n", name.c_str(), scale, ok ? "true" : "false", meanDiff, maxDiff);
+      if (!ok) {
+        fprintf(stderr, "%s: decode at 1/%d failed\n", name.c_str(), scale);
+      }
+      first = false;
+    }
+  }
+
+  first = true;
+  printf("\n  ],\n  \"conversions\": [\n");
+  for (const std::string& name : names) {
+    fprintf(stderr, "%s\n", name.c_str());
+    for (const Targets& targets : TARGETS) {
+      const Result full = convert(name, targets, false);
+      const Result scaled = convert(name, targets, true);
+      // Images the full decode can't convert either (e.g. ones the crop would scale up) have nothing to compare to
+      const bool compared = full.ok;
+      bool sizesMatch = full.ok && scaled.ok;
+      double meanDiff = 0;
+      double maxDiff = 0;
+      for (size_t i = 0; i < targets.count && sizesMatch; i++) {
+        const Image& a = full.images[i];
+        const Image& b = scaled.images[i];
+        sizesMatch = a.width == b.width && a.height == b.height;
+        if (sizesMatch) {
+          double targetMean;
+          double targetMax;
+          compare(a, b, targetMean, targetMax);
+          meanDiff = std::max(meanDiff, targetMean);
+          maxDiff = std::max(maxDiff, targetMax);
+        }
+      }
+      const bool ok = !compared || (sizesMatch && meanDiff <= maxMeanDiff);
+      failed |= !ok;
+      printf(
+          "%s    {\"image\": \"%s\", \"targets\": \"%s\", \"compared\": %s, \"ok\": %s, \"fullMs\": %.1f, "
+          "\"scaledMs\": %.1f, \"fullPeakHeap\": %lld, \"scaledPeakHeap\": %lld, \"meanDiff\": %.2f, "
+          "\"maxDiff\": %.1f}",
+          first ? "" : ",\n", name.c_str(), targets.name, compared ? "true" : "false", ok ? "true" : "false", full.ms,
+          scaled.ms, static_cast<long long>(full.peakHeap), static_cast<long long>(scaled.peakHeap), meanDiff,
+          maxDiff);
+      first = false;
+      if (!ok) {
+        fprintf(stderr, "%s %s: %s\n", name.c_str(), targets.name,
+                !scaled.ok ? "conversion failed" : !sizesMatch ? "output sizes differ" : "too different");
+      }
+    }
+  }
+  printf("\n  ]\n}\n");
+  return failed ? 1 : 0;
+}
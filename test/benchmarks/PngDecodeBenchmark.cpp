@@ -0,0 +1,343 @@
+/**
+ * PngDecodeBenchmark.cpp
+ *
+ * Generates PNGs of every supported color type (up to 2000x3000 RGBA) in a scratch directory, then for each:
+ *   - decodes it with PngDecoder and compares every gray row with the one computed from the source pixels, the rows
+ *     cycle through all five filter types and the image data is split over several IDAT chunks
+ *   - converts it to the 480x800 cover BMP with JpegToBmpConverter::Job, timing it and tracking the heap
+ *
+ * The conversion runs under a heap budget (--heap-budget-kb, default 80) that covers everything the decoder
+ * allocates: the inflate state and window, the two scanlines and the row writer. A large image has to fit the same
+ * budget as a small one, any failed allocation or wrong pixel makes the process exit with status 1.
+ */
+#include <Arduino.h>
+#include <JpegToBmpConverter.h>
+#include <PngDecoder.h>
+#include <SDCardManager.h>
+#include <miniz.h>
+
+#include <cstring>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "BenchmarkUtils.h"
+#include "HeapTracker.h"
+
+namespace {
+constexpr size_t DEFAULT_HEAP_BUDGET_KB = 80;
+constexpr size_t IDAT_CHUNK_SIZE = 8192;
+
+enum ColorType : uint8_t { GRAY = 0, RGB = 2, PALETTE = 3, GRAY_ALPHA = 4, RGBA = 6 };
+
+struct Case {
+  const char* name;
+  ColorType colorType;
+  int width;
+  int height;
+  bool transparency;  // tRNS for gray, RGB and palette images
+};
+
+const Case CASES[] = {
+    {"gray.png", GRAY, 640, 960, false},
+    {"gray_trns.png", GRAY, 300, 200, true},
+    {"palette.png", PALETTE, 600, 800, true},
+    {"gray_alpha.png", GRAY_ALPHA, 500, 700, false},
+    {"rgb.png", RGB, 1200, 1600, false},
+    {"rgb_trns.png", RGB, 320, 240, true},
+    {"rgb_large.png", RGB, 2000, 3000, false},
+    {"rgba_large.png", RGBA, 2000, 3000, false},
+};
+
+int channels(const ColorType colorType) {
+  switch (colorType) {
+    case GRAY_ALPHA:
+      return 2;
+    case RGB:
+      return 3;
+    case RGBA:
+      return 4;
+    default:
+      return 1;
+  }
+}
+
+// Deterministic pixels with enough detail that the filters and the inflate window get a workout
+uint8_t sample(const int x, const int y, const int channel) {
+  uint32_t h = static_cast<uint32_t>((x >> 3) * 73856093) ^ static_cast<uint32_t>((y >> 3) * 19349663);
+  h ^= h >> 13;
+  return static_cast<uint8_t>((x * (channel + 1) + y * 2 + (h & 0x3F)) & 0xFF);
+}
+
+uint8_t alphaAt(const int x, const int y) { return static_cast<uint8_t>((x ^ y) & 0xFF); }
+
+uint8_t paletteRgb(const int index, const int channel) { return static_cast<uint8_t>(index * (3 + channel * 2)); }
+
+uint8_t paletteAlpha(const int index) { return index < 16 ? static_cast<uint8_t>(index * 16) : 255; }
+
+// The conversions documented in PngDecoder.h: RGB weighted like the JPEG decoder, transparency composited on white
+uint8_t toGray(const int r, const int g, const int b) { return (r * 25 + g * 50 + b * 25) / 100; }
+uint8_t blend(const int gray, const int alpha) { return (gray * alpha + 255 * (255 - alpha)) / 255; }
+
+void rawRow(const Case& c, const int y, uint8_t* out) {
+  const int n = channels(c.colorType);
+  for (int x = 0; x < c.width; x++) {
+    for (int i = 0; i < n; i++) {
+      out[x * n + i] = sample(x, y, i);
+    }
+    if (c.colorType == GRAY_ALPHA || c.colorType == RGBA) {
+      out[x * n + n - 1] = alphaAt(x, y);
+    }
+  }
+}
+
+uint8_t expectedGray(const Case& c, const uint8_t* raw, const int x) {
+  // The tRNS color is the value of sample() at the origin
+  switch (c.colorType) {
+    case GRAY:
+      return c.transparency && raw[x] == sample(0, 0, 0) ? 255 : raw[x];
+    case PALETTE:
+      return blend(toGray(paletteRgb(raw[x], 0), paletteRgb(raw[x], 1), paletteRgb(raw[x], 2)), paletteAlpha(raw[x]));
+    case GRAY_ALPHA:
+      return blend(raw[x * 2], raw[x * 2 + 1]);
+    case RGB: {
+      const uint8_t* p = raw + x * 3;
+      if (c.transparency && p[0] == sample(0, 0, 0) && p[1] == sample(0, 0, 1) && p[2] == sample(0, 0, 2)) {
+        return 255;
+      }
+      return toGray(p[0], p[1], p[2]);
+    }
+    case RGBA: {
+      const uint8_t* p = raw + x * 4;
+      return blend(toGray(p[0], p[1], p[2]), p[3]);
+    }
+  }
+  return 0;
+}
+
+uint8_t paeth(const int a, const int b, const int c) {
+  const int p = a + b - c;
+  const int pa = abs(p - a), pb = abs(p - b), pc = abs(p - c);
+  return pa <= pb && pa <= pc ? a : pb <= pc ? b : c;
+}
+
+void put32(std::vector<uint8_t>& out, const uint32_t value) {
+  for (int shift = 24; shift >= 0; shift -= 8) {
+    out.push_back(static_cast<uint8_t>(value >> shift));
+  }
+}
+
+void putChunk(std::vector<uint8_t>& out, const char* type, const uint8_t* data, const size_t length) {
+  put32(out, length);
+  const size_t start = out.size();
+  out.insert(out.end(), type, type + 4);
+  out.insert(out.end(), data, data + length);
+  put32(out, mz_crc32(MZ_CRC32_INIT, out.data() + start, length + 4));
+}
+
+bool writePng(const Case& c) {
+  const int bpp = channels(c.colorType);
+  const size_t stride = static_cast<size_t>(c.width) * bpp;
+  std::vector<uint8_t> filtered;
+  filtered.reserve((stride + 1) * c.height);
+  std::vector<uint8_t> previous(stride, 0), current(stride);
+  for (int y = 0; y < c.height; y++) {
+    rawRow(c, y, current.data());
+    const uint8_t filter = y % 5;
+    filtered.push_back(filter);
+    for (size_t i = 0; i < stride; i++) {
+      const int left = i >= static_cast<size_t>(bpp) ? current[i - bpp] : 0;
+      const int up = previous[i];
+      const int upLeft = i >= static_cast<size_t>(bpp) ? previous[i - bpp] : 0;
+      int predicted = 0;
+      switch (filter) {
+        case 1:
+          predicted = left;
+          break;
+        case 2:
+          predicted = up;
+          break;
+        case 3:
+          predicted = (left + up) >> 1;
+          break;
+        case 4:
+          predicted = paeth(left, up, upLeft);
+          break;
+      }
+      filtered.push_back(static_cast<uint8_t>(current[i] - predicted));
+    }
+    previous.swap(current);
+  }
+
+  mz_ulong compressedSize = mz_compressBound(filtered.size());
+  std::vector<uint8_t> compressed(compressedSize);
+  if (mz_compress2(compressed.data(), &compressedSize, filtered.data(), filtered.size(), 6) != MZ_OK) {
+    return false;
+  }
+
+  std::vector<uint8_t> png = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+  std::vector<uint8_t> ihdr;
+  put32(ihdr, c.width);
+  put32(ihdr, c.height);
+  ihdr.insert(ihdr.end(), {8, c.colorType, 0, 0, 0});
+  putChunk(png, "IHDR", ihdr.data(), ihdr.size());
+  if (c.colorType == PALETTE) {
+    uint8_t plte[256 * 3];
+    uint8_t trns[16];
+    for (int i = 0; i < 256; i++) {
+      for (int ch = 0; ch < 3; ch++) {
+        plte[i * 3 + ch] = paletteRgb(i, ch);
+      }
+    }
+    for (int i = 0; i < 16; i++) {
+      trns[i] = paletteAlpha(i);
+    }
+    putChunk(png, "PLTE", plte, sizeof(plte));
+    putChunk(png, "tRNS", trns, sizeof(trns));
+  } else if (c.transparency) {
+    uint8_t trns[6];
+    for (int ch = 0; ch < channels(c.colorType); ch++) {
+      trns[ch * 2] = 0;
+      trns[ch * 2 + 1] = sample(0, 0, ch);
+    }
+    putChunk(png, "tRNS", trns, channels(c.colorType) * 2);
+  }
+  // An ancillary chunk the decoder has to skip
+  putChunk(png, "tEXt", reinterpret_cast<const uint8_t*>("Comment\0test"), 12);
+  for (size_t offset = 0; offset < compressedSize; offset += IDAT_CHUNK_SIZE) {
+    const size_t length = compressedSize - offset < IDAT_CHUNK_SIZE ? compressedSize - offset : IDAT_CHUNK_SIZE;
+    putChunk(png, "IDAT", compressed.data() + offset, length);
+  }
+  putChunk(png, "IEND", nullptr, 0);
+
+  FsFile file;
+  if (!SdMan.openFileForWrite("PNG", std::string("/") + c.name, file)) {
+    return false;
+  }
+  const bool written = file.write(png.data(), png.size()) == png.size();
+  file.close();
+  return written;
+}
+
+// Returns the first mismatching row, -1 when every row matches
+int verifyRows(const Case& c) {
+  FsFile file;
+  if (!SdMan.openFileForRead("PNG", std::string("/") + c.name, file)) {
+    return 0;
+  }
+  PngDecoder decoder(file);
+  if (!decoder.begin(JpegToBmpConverter::MAX_IMAGE_WIDTH, JpegToBmpConverter::MAX_IMAGE_HEIGHT) ||
+      decoder.getWidth() != c.width || decoder.getHeight() != c.height) {
+    return 0;
+  }
+  std::vector<uint8_t> raw(static_cast<size_t>(c.width) * channels(c.colorType));
+  for (int y = 0; y < c.height; y++) {
+    const uint8_t* row = decoder.nextRow();
+    if (!row) {
+      return y;
+    }
+    rawRow(c, y, raw.data());
+    for (int x = 0; x < c.width; x++) {
+      if (row[x] != expectedGray(c, raw.data(), x)) {
+        return y;
+      }
+    }
+  }
+  return decoder.nextRow() ? c.height : -1;
+}
+
+struct Result {
+  bool ok = false;
+  double ms = 0;
+  int64_t peakHeap = 0;
+  uint64_t allocs = 0;
+  int outWidth = 0;
+  int outHeight = 0;
+};
+
+Result convert(const Case& c, const size_t heapBudget) {
+  Result result;
+  FsFile png;
+  FsFile bmp;
+  if (!SdMan.openFileForRead("PNG", std::string("/") + c.name, png) ||
+      !SdMan.openFileForWrite("PNG", std::string("/") + c.name + ".bmp", bmp)) {
+    return result;
+  }
+
+  heap_tracker::resetPeak();
+  const auto heapStart = heap_tracker::snapshot();
+  heap_tracker::setBudget(heapBudget);
+  const auto start = bench::Clock::now();
+  try {
+    const JpegToBmpConverter::Target target = {&bmp, JpegToBmpConverter::COVER_MAX_WIDTH,
+                                               JpegToBmpConverter::COVER_MAX_HEIGHT,
+                                               JpegToBmpConverter::Output::Bmp2Bit, false};
+    JpegToBmpConverter::Job job(png, &target, 1);
+    if (job.begin()) {
+      job.getOutputSize(0, result.outWidth, result.outHeight);
+      JpegToBmpConverter::Job::Status status;
+      do {
+        status = job.step();
+      } while (status == JpegToBmpConverter::Job::Status::Running);
+      result.ok = status == JpegToBmpConverter::Job::Status::Done;
+    }
+  } catch (const std::bad_alloc&) {
+    result.ok = false;
+  }
+  result.ms = bench::msSince(start);
+  heap_tracker::setBudget(0);
+  const auto heapEnd = heap_tracker::snapshot();
+  result.peakHeap = heapEnd.peakBytes - heapStart.liveBytes;
+  result.allocs = heapEnd.allocCount - heapStart.allocCount;
+  // The firmware handles most failed mallocs gracefully, but on the device they would still be a failure
+  result.ok &= heapEnd.failedAllocCount == heapStart.failedAllocCount;
+
+  png.close();
+  bmp.close();
+  return result;
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+  std::string scratchDir;
+  size_t heapBudgetKb = DEFAULT_HEAP_BUDGET_KB;
+  bool verbose = false;
+
+  bench::CommandLine commandLine;
+  commandLine.directory("scratch dir", &scratchDir, "where the test images are written, used as the SD card root")
+      .option("--heap-budget-kb", "kb", &heapBudgetKb, "heap the conversion of each image may use")
+      .flag("--verbose", &verbose, "print the firmware log to stderr");
+  if (const int status = commandLine.parse(argc, argv); status >= 0) {
+    return status;
+  }
+
+  FILE* log = bench::logOutput(verbose);
+  Serial.setOutput(log);
+  SdMan.setRootPath(scratchDir);
+  SdMan.begin();
+
+  bool failed = false;
+  printf("{\n  \"heapBudgetKb\": %zu,\n  \"images\": [\n", heapBudgetKb);
+  for (size_t i = 0; i < sizeof(CASES) / sizeof(CASES[0]); i++) {
+    const Case& c = CASES[i];
+    fprintf(stderr, "%s\n", c.name);
+    if (!writePng(c)) {
+      fprintf(stderr, "Failed to write %s\n", c.name);
+      return 2;
+    }
+    const int badRow = verifyRows(c);
+    const Result result = convert(c, heapBudgetKb * 1024);
+    failed |= badRow >= 0 || !result.ok;
+    printf(
+        "    {\"name\": \"%s\", \"size\": \"%dx%d\", \"pixelsMatch\": %s, \"ok\": %s, \"ms\": %.1f, "
+        "\"peakHeap\": %lld, \"allocs\": %llu, \"output\": \"%dx%d\"}%s\n",
+        c.name, c.width, c.height, badRow < 0 ? "true" : "false", result.ok ? "true" : "false", result.ms,
+        static_cast<long long>(result.peakHeap), static_cast<unsigned long long>(result.allocs), result.outWidth,
+        result.outHeight, i + 1 == sizeof(CASES) / sizeof(CASES[0]) ? "" : ",");
+    if (badRow >= 0) {
+      fprintf(stderr, "%s: row %d differs from the source pixels\n", c.name, badRow);
+    }
+  }
+  printf("  ]\n}\n");
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,283 @@
+/**
+ * ReadingPipelineBenchmark.cpp
+ *
+ * Runs every EPUB in a directory through the same steps the reader takes between opening a book and showing a page:
+ * Epub::load (cold, cache cleared first), Section::createSectionFile for each spine item, then
+ * Section::loadPageFromSectionFile and Page::render for every page. Each stage reports wall time, SD traffic,
+ * allocation count and peak heap as JSON so runs can be diffed between commits.
+ *
+ * With --heap-budget-kb the allocator refuses to grow past the budget, any failed allocation marks the book as
+ * failed and the process exits with status 1.
+ */
+#include <Arduino.h>
+#include <BufferPool.h>
+#include <CrossPointSettings.h>
+#include <Epub.h>
+#include <Epub/Page.h>
+#include <Epub/Section.h>
+#include <GfxRenderer.h>
+#include <HalDisplay.h>
+#include <SDCardManager.h>
+#include <builtinFonts/all.h>
+
+#include <algorithm>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "BenchmarkUtils.h"
+#include "HeapTracker.h"
+#include "fontIds.h"
+
+namespace {
+// Matches the reader's status bar allowance in EpubReaderActivity for the default status bar mode
+constexpr int statusBarMargin = 19;
+// Usable heap on the ESP32-C3 while reading, see EMULATED_HEAP_SIZE in the Arduino shim
+constexpr size_t DEVICE_HEAP_BUDGET_KB = 380;
+
+struct StageStats {
+  uint32_t calls = 0;
+  double ms = 0;
+  uint64_t bytesRead = 0;
+  uint64_t bytesWritten = 0;
+  uint64_t readCalls = 0;
+  uint64_t writeCalls = 0;
+  uint64_t allocs = 0;
+  int64_t peakHeap = 0;
+};
+
+// Adds the cost of everything that happens during its lifetime to a stage
+class StageScope {
+  StageStats& stage;
+  const bench::Clock::time_point start;
+  const FsIoStats ioStart;
+  const heap_tracker::Stats heapStart;
+
+ public:
+  explicit StageScope(StageStats& stage)
+      : stage(stage),
+        start(bench::Clock::now()),
+        ioStart(fsIoStats()),
+        heapStart((heap_tracker::resetPeak(), heap_tracker::snapshot())) {}
+
+  ~StageScope() {
+    const auto heapEnd = heap_tracker::snapshot();
+    stage.calls++;
+    stage.ms += bench::msSince(start);
+    stage.bytesRead += fsIoStats().bytesRead - ioStart.bytesRead;
+    stage.bytesWritten += fsIoStats().bytesWritten - ioStart.bytesWritten;
+    stage.readCalls += fsIoStats().readCalls - ioStart.readCalls;
+    stage.writeCalls += fsIoStats().writeCalls - ioStart.writeCalls;
+    stage.allocs += heapEnd.allocCount - heapStart.allocCount;
+    stage.peakHeap = std::max(stage.peakHeap, heapEnd.peakBytes - heapStart.liveBytes);
+  }
+};
+
+struct BookResult {
+  std::string name;
+  std::string error;
+  int sections = 0;
+  int pages = 0;
+  uint64_t failedAllocs = 0;
+  StageStats load;
+  StageStats layout;
+  StageStats loadPage;
+  StageStats render;
+};
+
+struct Viewport {
+  int marginTop;
+  int marginLeft;
+  uint16_t width;
+  uint16_t height;
+};
+
+EpdFont bookerly14RegularFont(&bookerly_14_regular);
+EpdFont bookerly14BoldFont(&bookerly_14_bold);
+EpdFont bookerly14ItalicFont(&bookerly_14_italic);
+EpdFont bookerly14BoldItalicFont(&bookerly_14_bolditalic);
+EpdFontFamily bookerly14FontFamily(&bookerly14RegularFont, &bookerly14BoldFont, &bookerly14ItalicFont,
+                                   &bookerly14BoldItalicFont);
+
+Viewport readerViewport(const GfxRenderer& renderer) {
+  int top, right, bottom, left;
+  renderer.getOrientedViewableTRBL(&top, &right, &bottom, &left);
+  top += SETTINGS.screenMargin;
+  left += SETTINGS.screenMargin;
+  right += SETTINGS.screenMargin;
+  bottom += statusBarMargin;
+  return {top, left, static_cast<uint16_t>(renderer.getScreenWidth() - left - right),
+          static_cast<uint16_t>(renderer.getScreenHeight() - top - bottom)};
+}
+
+void runBook(const std::string& path, GfxRenderer& renderer, const Viewport& viewport, const int maxSections,
+             BookResult& result) {
+  std::shared_ptr<Epub> epub;
+  {
+    StageScope scope(result.load);
+    epub = std::make_shared<Epub>(path, "/.crosspoint");
+    epub->clearCache();
+    if (!epub->load(true)) {
+      result.error = "load failed";
+      return;
+    }
+  }
+
+  const int spineCount = epub->getSpineItemsCount();
+  result.sections = maxSections > 0 ? std::min(spineCount, maxSections) : spineCount;
+  for (int i = 0; i < result.sections; i++) {
+    Section section(epub, i, renderer);
+    bool created;
+    {
+      StageScope scope(result.layout);
+      created = section.createSectionFile(BOOKERLY_14_FONT_ID, SETTINGS.getReaderLineCompression(),
+                                          SETTINGS.extraParagraphSpacing, SETTINGS.paragraphAlignment,
+                                          viewport.width, viewport.height, SETTINGS.hyphenationEnabled);
+    }
+    if (!created) {
+      result.error = "layout failed for spine item " + std::to_string(i);
+      return;
+    }
+
+    for (int p = 0; p < section.pageCount; p++) {
+      section.currentPage = p;
+      std::unique_ptr<Page> page;
+      {
+        StageScope scope(result.loadPage);
+        page = section.loadPageFromSectionFile();
+      }
+      if (!page) {
+        result.error = "failed to load page " + std::to_string(p) + " of spine item " + std::to_string(i);
+        return;
+      }
+      {
+        StageScope scope(result.render);
+        renderer.clearScreen();
+        page->render(renderer, BOOKERLY_14_FONT_ID, viewport.marginLeft, viewport.marginTop);
+      }
+      result.pages++;
+    }
+  }
+}
+
+void printStage(FILE* out, const char* name, const StageStats& stage, const bool last) {
+  fprintf(out,
+          "        \"%s\": {\"calls\": %u, \"ms\": %.3f, \"bytesRead\": %llu, \"bytesWritten\": %llu, "
+          "\"readCalls\": %llu, \"writeCalls\": %llu, \"allocs\": %llu, \"peakHeap\": %lld}%s\n",
+          name, stage.calls, stage.ms, static_cast<unsigned long long>(stage.bytesRead),
+          static_cast<unsigned long long>(stage.bytesWritten), static_cast<unsigned long long>(stage.readCalls),
+          static_cast<unsigned long long>(stage.writeCalls), static_cast<unsigned long long>(stage.allocs),
+          static_cast<long long>(stage.peakHeap), last ? "" : ",");
+}
+
+void printReport(FILE* out, const Viewport& viewport, const std::vector<BookResult>& results) {
+  fprintf(out, "{\n  \"heapBudget\": %zu,\n  \"viewport\": {\"width\": %u, \"height\": %u},\n  \"books\": [\n",
+          heap_tracker::getBudget(), viewport.width, viewport.height);
+  for (size_t i = 0; i < results.size(); i++) {
+    const auto& r = results[i];
+    fprintf(out, "    {\n      \"book\": \"%s\",\n      \"ok\": %s,\n", bench::jsonEscape(r.name).c_str(),
+            r.error.empty() ? "true" : "false");
+    if (!r.error.empty()) {
+      fprintf(out, "      \"error\": \"%s\",\n", bench::jsonEscape(r.error).c_str());
+    }
+    fprintf(out, "      \"sections\": %d,\n      \"pages\": %d,\n      \"failedAllocs\": %llu,\n      \"stages\": {\n",
+            r.sections, r.pages, static_cast<unsigned long long>(r.failedAllocs));
+    printStage(out, "load", r.load, false);
+    printStage(out, "layout", r.layout, false);
+    printStage(out, "loadPage", r.loadPage, false);
+    printStage(out, "render", r.render, true);
+    fprintf(out, "      }\n    }%s\n", i + 1 == results.size() ? "" : ",");
+  }
+  const auto pool = BUFFER_POOL.getStats();
+  fprintf(out, "  ],\n  \"bufferPool\": {\"peakSlabs\": %u, \"leases\": %zu, \"heapFallbacks\": %zu}\n}\n",
+          pool.peakSlabsInUse, pool.leases, pool.heapFallbacks);
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+  std::string bookDir;
+  std::string outputPath;
+  size_t heapBudgetKb = 0;
+  int maxSections = 0;
+  bool verbose = false;
+
+  const std::string heapBudgetHelp =
+      "fail books that need more heap than this, " + std::to_string(DEVICE_HEAP_BUDGET_KB) + " simulates the ESP32-C3";
+  bench::CommandLine commandLine;
+  commandLine
+      .directory("epub dir", &bookDir,
+                 "directory holding the books, used as the SD card root (caches go to .crosspoint)")
+      .option("--heap-budget-kb", "kb", &heapBudgetKb, heapBudgetHelp.c_str(), false)
+      .option("--max-sections", "n", &maxSections, "only lay out the first n spine items of each book", false)
+      .option("--output", "file", &outputPath, "write the JSON report to a file instead of stdout")
+      .flag("--verbose", &verbose, "print the firmware log to stderr");
+  if (const int status = commandLine.parse(argc, argv); status >= 0) {
+    return status;
+  }
+
+  FILE* log = bench::logOutput(verbose);
+  Serial.setOutput(log);
+
+  SdMan.setRootPath(bookDir);
+  SdMan.begin();
+  SdMan.mkdir("/.crosspoint");
+
+  HalDisplay display;
+  display.begin();
+  GfxRenderer renderer(display);
+  renderer.insertFont(BOOKERLY_14_FONT_ID, bookerly14FontFamily);
+  const Viewport viewport = readerViewport(renderer);
+
+  std::vector<std::string> books;
+  auto root = SdMan.open("/");
+  for (auto file = root.openNextFile(); file; file = root.openNextFile()) {
+    char name[256];
+    file.getName(name, sizeof(name));
+    std::string filename = name;
+    if (!file.isDirectory() && filename.size() > 5 && filename.substr(filename.size() - 5) == ".epub") {
+      books.push_back(filename);
+    }
+  }
+  root.close();
+  std::sort(books.begin(), books.end());
+
+  // Display buffers, fonts and the buffer pool are set up before the budget starts, as they are on the device. The
+  // pool region comes out of the same heap there, so it is taken off the budget.
+  BUFFER_POOL.begin();
+  const size_t budget = heapBudgetKb * 1024;
+  heap_tracker::setBudget(budget > BufferPool::REGION_SIZE ? budget - BufferPool::REGION_SIZE : budget);
+
+  std::vector<BookResult> results;
+  bool failed = false;
+  for (const auto& name : books) {
+    BookResult result;
+    result.name = name;
+    fprintf(stderr, "%s\n", name.c_str());
+    const auto failedAllocsStart = heap_tracker::snapshot().failedAllocCount;
+    try {
+      runBook("/" + name, renderer, viewport, maxSections, result);
+    } catch (const std::bad_alloc&) {
+      result.error = "out of memory";
+    }
+    // The firmware handles most failed mallocs gracefully, but on the device they would still be a regression
+    result.failedAllocs = heap_tracker::snapshot().failedAllocCount - failedAllocsStart;
+    if (result.failedAllocs > 0 && result.error.empty()) {
+      result.error = "allocation failed";
+    }
+    failed |= !result.error.empty();
+    results.push_back(result);
+  }
+  heap_tracker::setBudget(0);
+
+  FILE* out = outputPath.empty() ? stdout : fopen(outputPath.c_str(), "w");
+  if (!out) {
+    fprintf(stderr, "Failed to open %s\n", outputPath.c_str());
+    return 2;
+  }
+  printReport(out, viewport, results);
+  if (out != stdout) {
+    fclose(out);
+  }
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,308 @@
+/**
+ * TxtWrapBenchmark.cpp
+ *
+ * Paginates plain text the way TxtReaderActivity::buildPageIndex does, 8 KB chunk by chunk, twice: with TxtWrapper
+ * (lib/Txt/TxtWrapper.h) and with the wrap the reader used before it, kept below as the reference. That one measured
+ * the whole line with getTextWidth() and then every shorter candidate prefix again, copying each into a string.
+ *
+ * Runs every .txt file in a directory plus generated text aimed at the corner cases (CRLF, blank lines, runs of
+ * spaces, multi-byte UTF-8, words wider than the line, NUL bytes, a line longer than a chunk) through four reader
+ * fonts, each in portrait, landscape and a narrow column. The generated text is read in 1 KB chunks, the reference
+ * takes seconds per page on a line longer than 8 KB. Every page must start at the same offset and hold the same
+ * lines both ways, any difference makes the process exit with status 1.
+ */
+#include <TxtWrapper.h>
+#include <builtinFonts/all.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "BenchmarkUtils.h"
+
+namespace {
+constexpr size_t CHUNK_SIZE = 8 * 1024;  // As in TxtReaderActivity
+constexpr size_t GENERATED_CHUNK_SIZE = 1024;
+
+using bench::Clock;
+using bench::msSince;
+
+EpdFont bookerly14Font(&bookerly_14_regular);
+EpdFont bookerly18Font(&bookerly_18_regular);
+EpdFont notosans14Font(&notosans_14_regular);
+EpdFont opendyslexic10Font(&opendyslexic_10_regular);
+EpdFontFamily bookerly14Family(&bookerly14Font);
+EpdFontFamily bookerly18Family(&bookerly18Font);
+EpdFontFamily notosans14Family(&notosans14Font);
+EpdFontFamily opendyslexic10Family(&opendyslexic10Font);
+
+struct FontCase {
+  const char* name;
+  const EpdFontFamily* family;
+};
+const FontCase FONTS[] = {{"bookerly14", &bookerly14Family},
+                          {"bookerly18", &bookerly18Family},
+                          {"notosans14", &notosans14Family},
+                          {"opendyslexic10", &opendyslexic10Family}};
+
+// Viewports of the reader with the default 5 px screen margin and status bar, and a column narrow enough to cut words
+struct ViewportCase {
+  const char* name;
+  int width;
+  int height;
+};
+const ViewportCase VIEWPORTS[] = {{"portrait", 464, 758}, {"landscape", 784, 438}, {"narrow", 60, 300}};
+
+struct Page {
+  size_t offset;
+  std::vector<std::string> lines;
+};
+
+int textWidth(const EpdFontFamily& font, const char* text) {
+  int w = 0, h = 0;
+  font.getTextDimensions(text, &w, &h);
+  return w;
+}
+
+// TxtReaderActivity::loadPageAtOffset before TxtWrapper, unchanged apart from taking the chunk as an argument
+size_t referencePage(const EpdFontFamily& font, const int viewportWidth, const int linesPerPage,
+                     const uint8_t* buffer, const size_t chunkSize, const size_t offset, const size_t fileSize,
+                     std::vector<std::string>& outLines) {
+  outLines.clear();
+  size_t pos = 0;
+
+  while (pos < chunkSize && static_cast<int>(outLines.size()) < linesPerPage) {
+    size_t lineEnd = pos;
+    while (lineEnd < chunkSize && buffer[lineEnd] != '\n') {
+      lineEnd++;
+    }
+
+    bool lineComplete = (lineEnd < chunkSize) || (offset + lineEnd >= fileSize);
+    if (!lineComplete && static_cast<int>(outLines.size()) > 0) {
+      break;
+    }
+
+    size_t lineContentLen = lineEnd - pos;
+    bool hasCR = (lineContentLen > 0 && buffer[pos + lineContentLen - 1] == '\r');
+    size_t displayLen = hasCR ? lineContentLen - 1 : lineContentLen;
+    std::string line(reinterpret_cast<const char*>(buffer + pos), displayLen);
+    size_t lineBytePos = 0;
+
+    while (!line.empty() && static_cast<int>(outLines.size()) < linesPerPage) {
+      int lineWidth = textWidth(font, line.c_str());
+      if (lineWidth <= viewportWidth) {
+        outLines.push_back(line);
+        lineBytePos = displayLen;
+        line.clear();
+        break;
+      }
+
+      size_t breakPos = line.length();
+      while (breakPos > 0 && textWidth(font, line.substr(0, breakPos).c_str()) > viewportWidth) {
+        size_t spacePos = line.rfind(' ', breakPos - 1);
+        if (spacePos != std::string::npos && spacePos > 0) {
+          breakPos = spacePos;
+        } else {
+          breakPos--;
+          while (breakPos > 0 && (line[breakPos] & 0xC0) == 0x80) {
+            breakPos--;
+          }
+        }
+      }
+      if (breakPos == 0) {
+        breakPos = 1;
+      }
+
+      outLines.push_back(line.substr(0, breakPos));
+      size_t skipChars = breakPos;
+      if (breakPos < line.length() && line[breakPos] == ' ') {
+        skipChars++;
+      }
+      lineBytePos += skipChars;
+      line = line.substr(skipChars);
+    }
+
+    if (line.empty()) {
+      pos = lineEnd + 1;
+    } else {
+      pos = pos + lineBytePos;
+      break;
+    }
+  }
+
+  if (pos == 0 && !outLines.empty()) {
+    pos = 1;
+  }
+  return std::min(offset + pos, fileSize);
+}
+
+// Both paginations of text, stopping like buildPageIndex on a page without lines or without progress
+template <typename LoadPage>
+std::vector<Page> paginate(const std::string& text, const size_t maxChunkSize, LoadPage loadPage) {
+  std::vector<Page> pages;
+  std::vector<uint8_t> buffer(maxChunkSize + 1);
+  size_t offset = 0;
+  while (offset < text.size()) {
+    const size_t chunkSize = std::min(maxChunkSize, text.size() - offset);
+    memcpy(buffer.data(), text.data() + offset, chunkSize);
+    buffer[chunkSize] = '\0';
+    Page page{offset, {}};
+    const size_t nextOffset = loadPage(buffer.data(), chunkSize, offset, page.lines);
+    if (page.lines.empty() || nextOffset <= offset) {
+      break;
+    }
+    pages.push_back(std::move(page));
+    offset = nextOffset;
+  }
+  return pages;
+}
+
+std::string generatedText() {
+  const char* words[] = {"the", "a", "river", "extraordinary", "naïve", "café", "über", "Straße", "—", "«quote»",
+                         "日本語の文章", "😀", "ça", "Ωmega", "x", "incomprehensibilities", "—dash—", "tab\there"};
+  std::mt19937 rng(42);
+  std::string text;
+  for (int paragraph = 0; paragraph < 80; paragraph++) {
+    const int kind = rng() % 10;
+    if (kind == 0) {
+      text += "\n";  // Blank line
+      continue;
+    }
+    if (kind == 1) {
+      // One word wider than any line
+      for (int i = 0; i < 12; i++) text += "supercalifragilistic日本";
+    } else {
+      const int count = 1 + rng() % 60;
+      for (int i = 0; i < count; i++) {
+        if (i > 0) text += std::string(1 + (rng() % 8 == 0 ? rng() % 4 : 0), ' ');
+        text += words[rng() % (sizeof(words) / sizeof(words[0]))];
+      }
+    }
+    if (kind == 2) text += "   ";  // Trailing spaces
+    if (kind == 3) text += std::string("mid") + '\0' + "nul text after it";
+    text += rng() % 3 == 0 ? "\r\n" : "\n";
+  }
+  // Longer than a chunk without a newline, plain ASCII so no chunk end cuts a character in two
+  for (int i = 0; i < 400; i++) text += i % 7 == 0 ? "lengthy " : "word ";
+  text += "\nlast line without a newline";
+  return text;
+}
+
+struct FileText {
+  std::string name;
+  std::string text;
+  size_t chunkSize;
+};
+
+struct CaseResult {
+  std::string file;
+  const char* font;
+  const char* viewport;
+  size_t pages = 0;
+  size_t referencePages = 0;
+  int mismatches = 0;
+  double wrapperMs = 0;
+  double referenceMs = 0;
+};
+}  // namespace
+
+int main(int argc, char** argv) {
+  std::string txtDir;
+  bench::CommandLine commandLine;
+  commandLine.directory("txt dir", &txtDir, "directory whose .txt files are paginated next to the generated text",
+                        false);
+  if (const int status = commandLine.parse(argc, argv); status >= 0) {
+    return status;
+  }
+
+  std::vector<FileText> files;
+  files.push_back({"(generated)", generatedText(), GENERATED_CHUNK_SIZE});
+  if (!txtDir.empty()) {
+    std::vector<std::string> paths;
+    for (const auto& entry : std::filesystem::directory_iterator(txtDir)) {
+      if (entry.is_regular_file() && entry.path().extension() == ".txt") {
+        paths.push_back(entry.path().string());
+      }
+    }
+    std::sort(paths.begin(), paths.end());
+    for (const auto& path : paths) {
+      FILE* file = fopen(path.c_str(), "rb");
+      if (!file) {
+        fprintf(stderr, "Can't open %s\n", path.c_str());
+        return 2;
+      }
+      std::string text;
+      char block[4096];
+      size_t read;
+      while ((read = fread(block, 1, sizeof(block), file)) > 0) {
+        text.append(block, read);
+      }
+      fclose(file);
+      files.push_back({std::filesystem::path(path).filename().string(), text, CHUNK_SIZE});
+    }
+  }
+
+  bool failed = false;
+  std::vector<CaseResult> results;
+  for (const auto& file : files) {
+    for (const auto& font : FONTS) {
+      for (const auto& viewport : VIEWPORTS) {
+        CaseResult result;
+        result.file = file.name;
+        result.font = font.name;
+        result.viewport = viewport.name;
+        const int linesPerPage = std::max(1, viewport.height / font.family->getData()->advanceY);
+        const TxtWrapper wrapper(font.family, viewport.width, linesPerPage);
+        std::vector<TxtLine> spans;
+        const size_t fileSize = file.text.size();
+
+        const auto wrapperPage = [&](const uint8_t* chunk, const size_t size, const size_t offset,
+                                     std::vector<std::string>& lines) {
+          const size_t pageSize = wrapper.layoutPage(chunk, size, offset + size >= fileSize, spans);
+          for (const auto& span : spans) {
+            lines.emplace_back(reinterpret_cast<const char*>(chunk + span.offset), span.length);
+          }
+          return std::min(offset + pageSize, fileSize);
+        };
+        auto start = Clock::now();
+        const auto pages = paginate(file.text, file.chunkSize, wrapperPage);
+        result.wrapperMs = msSince(start);
+
+        const auto oldPage = [&](const uint8_t* chunk, const size_t size, const size_t offset,
+                                 std::vector<std::string>& lines) {
+          return referencePage(*font.family, viewport.width, linesPerPage, chunk, size, offset, fileSize, lines);
+        };
+        start = Clock::now();
+        const auto referencePages = paginate(file.text, file.chunkSize, oldPage);
+        result.referenceMs = msSince(start);
+
+        result.pages = pages.size();
+        result.referencePages = referencePages.size();
+        for (size_t i = 0; i < std::max(pages.size(), referencePages.size()); i++) {
+          if (i >= pages.size() || i >= referencePages.size() || pages[i].offset != referencePages[i].offset ||
+              pages[i].lines != referencePages[i].lines) {
+            result.mismatches++;
+          }
+        }
+        failed |= result.mismatches > 0;
+        results.push_back(result);
+      }
+    }
+  }
+
+  printf("{\n  \"cases\": [\n");
+  for (size_t i = 0; i < results.size(); i++) {
+    const auto& r = results[i];
+    printf(
+        "    {\"file\": \"%s\", \"font\": \"%s\", \"viewport\": \"%s\", \"ok\": %s, \"pages\": %zu, "
+        "\"referencePages\": %zu, \"mismatches\": %d, \"wrapperMs\": %.2f, \"referenceMs\": %.2f}%s\n",
+        r.file.c_str(), r.font, r.viewport, r.mismatches == 0 ? "true" : "false", r.pages, r.referencePages,
+        r.mismatches, r.wrapperMs, r.referenceMs, i + 1 == results.size() ? "" : ",");
+  }
+  printf("  ]\n}\n");
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,412 @@
+/**
+ * XtcBlitBenchmark.cpp
+ *
+ * Writes XTC and XTCH books of a few pages (full screen and smaller pages, stored raw and PackBits compressed) to a
+ * scratch directory, then renders each page into every frame buffer XtcReaderActivity builds from it (BW, and for
+ * XTCH the grayscale LSB and MSB inputs):
+ *   - once with xtc::PageBlitter, streaming the page from the card straight into the frame buffer
+ *   - once more the same way with the page cache on and the page read ahead, as the reader turns pages
+ *   - once with a copy of the loop it replaced, the whole raw page read into a buffer and drawPixel for every pixel
+ *
+ * The frame buffers must come out identical, any difference makes the process exit with status 1. All timings
+ * include reading the page, the uncached streamed one reads it once per frame buffer.
+ *
+ * Before that, the PackBits coder's worst cases (alternating pairs, pairs stay in the literals) are packed and expanded
+ * again: they must fit packbits::bound() and come back unchanged, or the process exits with status 1 too.
+ */
+#include <Arduino.h>
+#include <BufferPool.h>
+#include <GfxRenderer.h>
+#include <HalDisplay.h>
+#include <PackBits.h>
+#include <SDCardManager.h>
+#include <Xtc.h>
+#include <Xtc/XtcPageBlitter.h>
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "BenchmarkUtils.h"
+
+namespace {
+constexpr int DEFAULT_ITERATIONS = 10;
+constexpr int PAGE_COUNT = 3;
+constexpr size_t CHUNK_SIZE = 4096;
+
+enum class Content : uint8_t { Pattern, Text };
+
+struct Case {
+  const char* name;
+  uint8_t bitDepth;
+  uint16_t width;
+  uint16_t height;
+  Content content;
+  bool packed;
+};
+
+const Case CASES[] = {
+    {"screen.xtc", 1, 480, 800, Content::Pattern, false},
+    {"screen.xtch", 2, 480, 800, Content::Pattern, false},
+    {"odd.xtc", 1, 453, 797, Content::Pattern, false},
+    {"small.xtch", 2, 400, 640, Content::Pattern, false},
+    {"screen_packed.xtc", 1, 480, 800, Content::Pattern, true},
+    {"screen_packed.xtch", 2, 480, 800, Content::Pattern, true},
+    {"text.xtc", 1, 480, 800, Content::Text, false},
+    {"text_packed.xtc", 1, 480, 800, Content::Text, true},
+    {"text.xtch", 2, 480, 800, Content::Text, false},
+    {"text_packed.xtch", 2, 480, 800, Content::Text, true},
+};
+
+using Target = xtc::PageBlitter::Target;
+const Target TARGETS[] = {Target::Bw, Target::GrayscaleLsb, Target::GrayscaleMsb};
+
+using bench::Clock;
+using bench::msSince;
+
+// 0 white to levels - 1 black. Pattern: flat areas of every value with noise and stripes between them. Text: a white
+// page with lines of word shaped blocks of stems, grey at their edges. Different on every page.
+uint8_t sample(const Case& c, const int x, const int y, const int page, const int levels) {
+  uint32_t h = static_cast<uint32_t>(x * 73856093) ^ static_cast<uint32_t>(y * 19349663) ^ (page * 83492791u);
+  h ^= h >> 13;
+  if (c.content == Content::Pattern) {
+    const int band = (x / 40 + y / 60 + page) % 4;
+    if (band == 0) return static_cast<uint8_t>(h % levels);
+    if (band == 1) return static_cast<uint8_t>((x / 3 + y) % levels);
+    return static_cast<uint8_t>((x * levels / 97 + y / 50) % levels);
+  }
+
+  const int line = (y - 40) / 36;
+  const int lineY = (y - 40) % 36;
+  // Every sixth line ends its paragraph half way
+  const int lineEnd = line % 6 == 5 ? c.width / 2 : c.width - 30;
+  if (x < 30 || x >= lineEnd || y < 40 || y >= c.height - 60 || lineY >= 22) {
+    return 0;
+  }
+  // Words of 20 to 83 pixels with 12 pixel gaps, starting over on every line
+  uint32_t word = static_cast<uint32_t>(line * 2654435761u) ^ (page * 40503u);
+  int wordStart = 30;
+  while (true) {
+    const int wordEnd = wordStart + 20 + (word >> 26);
+    if (x < wordEnd) break;
+    wordStart = wordEnd + 12;
+    word = word * 1664525u + 1013904223u;
+    if (x < wordStart) return 0;
+  }
+  // Stems of 3 pixels every 6 between the x-height rows, a few reaching up to the ascender or down to the descender
+  const int stem = (x - wordStart) % 6;
+  const uint32_t stemHash = (word >> 8) + (x - wordStart) / 6 * 2654435761u;
+  if (stem >= 3 || (lineY < 6 && stemHash >> 29 != 0) || (lineY >= 16 && stemHash >> 29 != 7)) {
+    return 0;
+  }
+  return static_cast<uint8_t>(stem == 1 ? levels - 1 : (levels > 2 ? 1 + (stem & 1) : 0));
+}
+
+size_t pageDataSize(const Case& c) {
+  if (c.bitDepth == 2) {
+    return ((static_cast<size_t>(c.width) * c.height + 7) / 8) * 2;
+  }
+  return static_cast<size_t>((c.width + 7) / 8) * c.height;
+}
+
+std::vector<uint8_t> encodePage(const Case& c, const int page) {
+  std::vector<uint8_t> data(pageDataSize(c), 0);
+  if (c.bitDepth == 1) {
+    // Row-major, MSB first, 0 black
+    const int rowBytes = (c.width + 7) / 8;
+    for (int y = 0; y < c.height; y++) {
+      for (int x = 0; x < c.width; x++) {
+        if (sample(c, x, y, page, 2) == 0) {
+          data[y * rowBytes + x / 8] |= 0x80 >> (x % 8);
+        }
+      }
+    }
+    return data;
+  }
+
+  // Two planes, columns right to left, 8 vertical pixels per byte
+  const size_t planeSize = data.size() / 2;
+  const int colBytes = (c.height + 7) / 8;
+  for (int y = 0; y < c.height; y++) {
+    for (int x = 0; x < c.width; x++) {
+      const uint8_t value = sample(c, x, y, page, 4);
+      const size_t offset = static_cast<size_t>(c.width - 1 - x) * colBytes + y / 8;
+      const uint8_t bit = 0x80 >> (y % 8);
+      if (value & 2) data[offset] |= bit;
+      if (value & 1) data[planeSize + offset] |= bit;
+    }
+  }
+  return data;
+}
+
+bool writeXtc(const std::string& path, const Case& c, const bool packed, size_t* storedBytes) {
+  xtc::XtcHeader header = {};
+  header.magic = c.bitDepth == 2 ? xtc::XTCH_MAGIC : xtc::XTC_MAGIC;
+  header.versionMajor = 1;
+  header.pageCount = PAGE_COUNT;
+  header.pageTableOffset = sizeof(header);
+  header.dataOffset = sizeof(header) + PAGE_COUNT * sizeof(xtc::PageTableEntry);
+
+  std::vector<uint8_t> pages;
+  std::vector<xtc::PageTableEntry> entries(PAGE_COUNT);
+  *storedBytes = 0;
+  for (int page = 0; page < PAGE_COUNT; page++) {
+    std::vector<uint8_t> data = encodePage(c, page);
+    xtc::XtgPageHeader pageHeader = {};
+    pageHeader.magic = c.bitDepth == 2 ? xtc::XTH_MAGIC : xtc::XTG_MAGIC;
+    pageHeader.width = c.width;
+    pageHeader.height = c.height;
+    if (packed) {
+      std::vector<uint8_t> packedData(packbits::bound(data.size()));
+      packedData.resize(packbits::pack(data.data(), data.size(), packedData.data()));
+      data = std::move(packedData);
+      pageHeader.compression = xtc::XTG_COMPRESSION_PACKBITS;
+    }
+    pageHeader.dataSize = data.size();
+    *storedBytes += data.size();
+
+    entries[page].dataOffset = header.dataOffset + pages.size();
+    entries[page].dataSize = sizeof(pageHeader) + data.size();
+    entries[page].width = c.width;
+    entries[page].height = c.height;
+    pages.insert(pages.end(), reinterpret_cast<const uint8_t*>(&pageHeader),
+                 reinterpret_cast<const uint8_t*>(&pageHeader) + sizeof(pageHeader));
+    pages.insert(pages.end(), data.begin(), data.end());
+  }
+  *storedBytes /= PAGE_COUNT;
+
+  std::vector<uint8_t> out(reinterpret_cast<const uint8_t*>(&header),
+                           reinterpret_cast<const uint8_t*>(&header) + sizeof(header));
+  out.insert(out.end(), reinterpret_cast<const uint8_t*>(entries.data()),
+             reinterpret_cast<const uint8_t*>(entries.data() + entries.size()));
+  out.insert(out.end(), pages.begin(), pages.end());
+
+  FILE* file = fopen(path.c_str(), "wb");
+  if (!file) {
+    return false;
+  }
+  const bool written = fwrite(out.data(), 1, out.size(), file) == out.size();
+  return fclose(file) == 0 && written;
+}
+
+// The loops XtcReaderActivity::renderPage ran before it streamed pages, for one of its frame buffers. Only handles raw
+// pages, like the code it copies.
+void referenceRender(const GfxRenderer& renderer, const Xtc& book, const uint32_t page, const Target target) {
+  const uint16_t pageWidth = book.getPageWidth();
+  const uint16_t pageHeight = book.getPageHeight();
+  std::vector<uint8_t> pageBuffer(pageDataSize({"", book.getBitDepth(), pageWidth, pageHeight, {}, false}));
+  if (book.loadPage(page, pageBuffer.data(), pageBuffer.size()) == 0) {
+    return;
+  }
+
+  if (book.getBitDepth() == 1) {
+    const size_t srcRowBytes = (pageWidth + 7) / 8;
+    for (uint16_t srcY = 0; srcY < pageHeight; srcY++) {
+      for (uint16_t srcX = 0; srcX < pageWidth; srcX++) {
+        const bool isBlack = !((pageBuffer[srcY * srcRowBytes + srcX / 8] >> (7 - srcX % 8)) & 1);
+        if (isBlack) {
+          renderer.drawPixel(srcX, srcY, true);
+        }
+      }
+    }
+    return;
+  }
+
+  const size_t planeSize = (static_cast<size_t>(pageWidth) * pageHeight + 7) / 8;
+  const uint8_t* plane1 = pageBuffer.data();
+  const uint8_t* plane2 = pageBuffer.data() + planeSize;
+  const size_t colBytes = (pageHeight + 7) / 8;
+  auto getPixelValue = [&](uint16_t x, uint16_t y) -> uint8_t {
+    const size_t byteOffset = (pageWidth - 1 - x) * colBytes + y / 8;
+    const size_t bitInByte = 7 - (y % 8);
+    return ((plane1[byteOffset] >> bitInByte) & 1) << 1 | ((plane2[byteOffset] >> bitInByte) & 1);
+  };
+  for (uint16_t y = 0; y < pageHeight; y++) {
+    for (uint16_t x = 0; x < pageWidth; x++) {
+      const uint8_t pv = getPixelValue(x, y);
+      if (target == Target::Bw && pv >= 1) {
+        renderer.drawPixel(x, y, true);
+      } else if (target == Target::GrayscaleLsb && pv == 1) {
+        renderer.drawPixel(x, y, false);
+      } else if (target == Target::GrayscaleMsb && (pv == 1 || pv == 2)) {
+        renderer.drawPixel(x, y, false);
+      }
+    }
+  }
+}
+
+void streamedRender(const GfxRenderer& renderer, const Xtc& book, const uint32_t page, const Target target) {
+  xtc::PageBlitter blitter(renderer.getFrameBuffer(), book.getPageWidth(), book.getPageHeight(), book.getBitDepth(),
+                           target);
+  book.loadPageStreaming(
+      page,
+      [&blitter](const uint8_t* data, const size_t size, const size_t offset) { blitter.addChunk(data, size, offset); },
+      CHUNK_SIZE);
+  blitter.finish();
+}
+
+struct Timing {
+  double referenceMs = 0;
+  double streamedMs = 0;
+  double cachedMs = 0;
+  bool cached = true;
+  bool identical = true;
+};
+
+// Per page, summed over the frame buffers the reader builds from it. The reference renders the raw copy of the book.
+Timing run(GfxRenderer& renderer, const Xtc& reference, const Xtc& book, const Xtc& cachedBook, const int iterations) {
+  Timing timing;
+  uint8_t* frameBuffer = renderer.getFrameBuffer();
+  std::vector<uint8_t> expected(HalDisplay::BUFFER_SIZE);
+  const int targetCount = book.getBitDepth() == 2 ? 3 : 1;
+
+  for (int i = 0; i < iterations; i++) {
+    for (uint32_t page = 0; page < book.getPageCount(); page++) {
+      // The reader reads the next page ahead after showing one, outside the time it takes to turn to it
+      timing.cached &= cachedBook.prefetchPage(page);
+
+      for (int t = 0; t < targetCount; t++) {
+        // BW starts from white, the grayscale buffers from black
+        const uint8_t clearColor = TARGETS[t] == Target::Bw ? 0xFF : 0x00;
+        renderer.clearScreen(clearColor);
+        auto start = Clock::now();
+        referenceRender(renderer, reference, page, TARGETS[t]);
+        timing.referenceMs += msSince(start);
+        memcpy(expected.data(), frameBuffer, HalDisplay::BUFFER_SIZE);
+
+        renderer.clearScreen(clearColor);
+        start = Clock::now();
+        streamedRender(renderer, book, page, TARGETS[t]);
+        timing.streamedMs += msSince(start);
+        timing.identical &= memcmp(expected.data(), frameBuffer, HalDisplay::BUFFER_SIZE) == 0;
+
+        renderer.clearScreen(clearColor);
+        start = Clock::now();
+        streamedRender(renderer, cachedBook, page, TARGETS[t]);
+        timing.cachedMs += msSince(start);
+        timing.identical &= memcmp(expected.data(), frameBuffer, HalDisplay::BUFFER_SIZE) == 0;
+      }
+    }
+  }
+  timing.referenceMs /= iterations * book.getPageCount();
+  timing.streamedMs /= iterations * book.getPageCount();
+  timing.cachedMs /= iterations * book.getPageCount();
+  return timing;
+}
+
+// True when data packs into packbits::bound() bytes and expands back unchanged, fed to the decoder in small pieces
+bool packBitsRoundTrips(const std::vector<uint8_t>& data) {
+  const size_t size = data.size();
+  // Guard bytes past the bound catch a write beyond it
+  std::vector<uint8_t> packed(packbits::bound(size) + 16, 0xEE);
+  const size_t packedSize = packbits::pack(data.data(), size, packed.data());
+  const bool guardIntact =
+      std::all_of(packed.begin() + packbits::bound(size), packed.end(), [](const uint8_t b) { return b == 0xEE; });
+  if (packedSize > packbits::bound(size) || !guardIntact) {
+    fprintf(stderr, "PackBits: %zu bytes packed to %zu, bound %zu\n", size, packedSize, packbits::bound(size));
+    return false;
+  }
+
+  std::vector<uint8_t> unpacked(size);
+  packbits::Decoder decoder;
+  const uint8_t* in = packed.data();
+  const uint8_t* const end = packed.data() + packedSize;
+  size_t written = 0;
+  while (in < end && written < size) {
+    // 7 byte pieces split packets at every offset
+    written += decoder.decode(in, std::min(in + 7, end), unpacked.data() + written, size - written);
+  }
+  if (written != size || in != end || unpacked != data) {
+    fprintf(stderr, "PackBits: %zu bytes don't round trip\n", size);
+    return false;
+  }
+  return true;
+}
+
+// The coder's worst cases at every length up to a few packets and at a full page: alternating pairs, and a single
+// byte between pairs, which a coder turning pairs into runs grows by a third
+bool packBitsBoundHolds() {
+  std::vector<size_t> sizes;
+  for (size_t size = 1; size <= 4 * packbits::MAX_PACKET + 3; size++) {
+    sizes.push_back(size);
+  }
+  sizes.push_back(HalDisplay::BUFFER_SIZE);
+
+  for (const size_t size : sizes) {
+    std::vector<uint8_t> pairs(size);
+    std::vector<uint8_t> singleAndPair(size);
+    for (size_t i = 0; i < size; i++) {
+      pairs[i] = (i / 2) % 2 ? 0xAA : 0x55;
+      singleAndPair[i] = i % 3 == 0 ? 0x0F : ((i / 3) % 2 ? 0xAA : 0x55);
+    }
+    if (!packBitsRoundTrips(pairs) || !packBitsRoundTrips(singleAndPair)) {
+      return false;
+    }
+  }
+  return true;
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+  std::string scratchDir;
+  int iterations = DEFAULT_ITERATIONS;
+  bool verbose = false;
+
+  bench::CommandLine commandLine;
+  commandLine.directory("scratch dir", &scratchDir, "where the test books are written, used as the SD card root")
+      .option("--iterations", "n", &iterations, "renders of every page")
+      .flag("--verbose", &verbose, "print the firmware log to stderr");
+  if (const int status = commandLine.parse(argc, argv); status >= 0) {
+    return status;
+  }
+  iterations = std::max(1, iterations);
+
+  FILE* log = bench::logOutput(verbose);
+  Serial.setOutput(log);
+  SdMan.setRootPath(scratchDir);
+  SdMan.begin();
+  HalDisplay display;
+  display.begin();
+  GfxRenderer renderer(display);
+  renderer.setOrientation(GfxRenderer::Portrait);
+  // The page cache only takes slabs from the reserved region, as on the device
+  BUFFER_POOL.begin();
+
+  const bool boundHolds = packBitsBoundHolds();
+  bool failed = !boundHolds;
+  printf("{\n  \"iterations\": %d,\n  \"chunkBytes\": %zu,\n  \"packBitsBoundHolds\": %s,\n  \"books\": [\n",
+         iterations, CHUNK_SIZE, boundHolds ? "true" : "false");
+  constexpr size_t caseCount = sizeof(CASES) / sizeof(CASES[0]);
+  for (size_t i = 0; i < caseCount; i++) {
+    const Case& c = CASES[i];
+    fprintf(stderr, "%s\n", c.name);
+    const std::string path = std::string("/") + c.name;
+    size_t storedBytes = 0;
+    size_t rawBytes = 0;
+    Xtc reference(path + ".raw", "/.crosspoint");
+    Xtc book(path, "/.crosspoint");
+    Xtc cachedBook(path, "/.crosspoint");
+    if (!writeXtc(scratchDir + path + ".raw", c, false, &rawBytes) ||
+        !writeXtc(scratchDir + path, c, c.packed, &storedBytes) || !reference.load() || !book.load() ||
+        !cachedBook.load() || !cachedBook.enablePageCache()) {
+      fprintf(stderr, "Failed to write %s\n", c.name);
+      return 2;
+    }
+
+    const Timing t = run(renderer, reference, book, cachedBook, iterations);
+    failed |= !t.identical;
+    printf(
+        "    {\"name\": \"%s\", \"size\": \"%ux%u\", \"bitDepth\": %u, \"identical\": %s, \"pageBufferBytes\": %zu, "
+        "\"storedBytes\": %zu, \"cached\": %s, \"referenceMs\": %.2f, \"streamedMs\": %.2f, \"cachedMs\": %.2f, "
+        "\"speedup\": %.1f}%s\n",
+        c.name, c.width, c.height, c.bitDepth, t.identical ? "true" : "false", rawBytes, storedBytes,
+        t.cached ? "true" : "false", t.referenceMs, t.streamedMs, t.cachedMs, t.referenceMs / t.streamedMs,
+        i + 1 == caseCount ? "" : ",");
+    if (!t.identical) {
+      fprintf(stderr, "%s: frame buffer differs\n", c.name);
+    }
+  }
+  printf("  ]\n}\n");
+  return failed ? 1 : 0;
+}
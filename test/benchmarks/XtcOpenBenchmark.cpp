@@ -0,0 +1,293 @@
+/**
+ * XtcOpenBenchmark.cpp
+ *
+ * Writes XTC books with up to 60,000 pages and a chapter every 20 pages to a scratch directory, then opens each:
+ *   - with xtc::XtcParser, which reads the header and the first window of the page table, counts the chapters on
+ *     first use and reads page table entries and chapters through small windows after that
+ *   - with a copy of the loops it replaced, every page table entry and chapter read into vectors at open
+ *
+ * Every page's entry and every chapter must come out the same both ways, read in order and in a random order, any
+ * difference makes the process exit with status 1. Open time and the heap each way holds afterwards are reported.
+ */
+#include <Arduino.h>
+#include <SDCardManager.h>
+#include <Xtc/XtcParser.h>
+
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "BenchmarkUtils.h"
+#include "HeapTracker.h"
+
+namespace {
+constexpr int DEFAULT_ITERATIONS = 5;
+constexpr int PAGES_PER_CHAPTER = 20;
+constexpr size_t CHAPTER_RECORD_SIZE = 96;
+
+struct Case {
+  const char* name;
+  uint16_t pageCount;
+  bool skippedChapter;  // One record points past the last page and is left out of the list
+};
+
+const Case CASES[] = {
+    {"small.xtc", 300, false},
+    {"large.xtc", 10000, false},
+    {"skipped.xtc", 10000, true},
+    {"huge.xtc", 60000, false},
+};
+
+using bench::Clock;
+using bench::msSince;
+
+// Chapter records come before the page table, all pages share one tiny XTG bitmap
+bool writeBook(const std::string& dir, const Case& c) {
+  const int recordCount = (c.pageCount + PAGES_PER_CHAPTER - 1) / PAGES_PER_CHAPTER;
+  xtc::XtcHeader header = {};
+  header.magic = xtc::XTC_MAGIC;
+  header.versionMajor = 1;
+  header.pageCount = c.pageCount;
+  header.hasChapters = 1;
+  header.chapterOffset = sizeof(header);
+  header.pageTableOffset = sizeof(header) + recordCount * CHAPTER_RECORD_SIZE;
+  header.dataOffset = header.pageTableOffset + c.pageCount * sizeof(xtc::PageTableEntry);
+
+  std::vector<uint8_t> out(reinterpret_cast<const uint8_t*>(&header),
+                           reinterpret_cast<const uint8_t*>(&header) + sizeof(header));
+  for (int i = 0; i < recordCount; i++) {
+    uint8_t record[CHAPTER_RECORD_SIZE] = {};
+    snprintf(reinterpret_cast<char*>(record), 80, "Chapter %d", i + 1);
+    uint16_t startPage = i * PAGES_PER_CHAPTER + 1;
+    const uint16_t endPage = std::min<int>(startPage + PAGES_PER_CHAPTER - 1, c.pageCount);
+    if (c.skippedChapter && i == recordCount / 2) {
+      startPage = c.pageCount + 1;
+    }
+    memcpy(record + 0x50, &startPage, sizeof(startPage));
+    memcpy(record + 0x52, &endPage, sizeof(endPage));
+    out.insert(out.end(), record, record + sizeof(record));
+  }
+
+  constexpr uint16_t pageSide = 8;
+  const uint32_t pageSize = sizeof(xtc::XtgPageHeader) + pageSide;
+  for (uint32_t i = 0; i < c.pageCount; i++) {
+    xtc::PageTableEntry entry = {};
+    entry.dataOffset = header.dataOffset;
+    entry.dataSize = pageSize + i;  // Tells the entries apart, the size is not checked
+    entry.width = pageSide;
+    entry.height = pageSide;
+    out.insert(out.end(), reinterpret_cast<const uint8_t*>(&entry),
+               reinterpret_cast<const uint8_t*>(&entry) + sizeof(entry));
+  }
+  xtc::XtgPageHeader pageHeader = {};
+  pageHeader.magic = xtc::XTG_MAGIC;
+  pageHeader.width = pageSide;
+  pageHeader.height = pageSide;
+  pageHeader.dataSize = pageSide;
+  out.insert(out.end(), reinterpret_cast<const uint8_t*>(&pageHeader),
+             reinterpret_cast<const uint8_t*>(&pageHeader) + sizeof(pageHeader));
+  out.insert(out.end(), pageSide, 0xFF);
+
+  FILE* file = fopen((dir + "/" + c.name).c_str(), "wb");
+  if (!file) {
+    return false;
+  }
+  const bool written = fwrite(out.data(), 1, out.size(), file) == out.size();
+  return fclose(file) == 0 && written;
+}
+
+// What XtcParser::open kept in memory before the windows: readPageTable and readChapters as they were
+struct ReferenceBook {
+  std::vector<xtc::PageInfo> pageTable;
+  std::vector<xtc::ChapterInfo> chapters;
+};
+
+bool referenceOpen(const std::string& path, ReferenceBook& book) {
+  FsFile file;
+  if (!SdMan.openFileForRead("XTC", path, file)) {
+    return false;
+  }
+  xtc::XtcHeader header;
+  if (file.read(reinterpret_cast<uint8_t*>(&header), sizeof(header)) != sizeof(header) ||
+      !file.seek(header.pageTableOffset)) {
+    return false;
+  }
+
+  book.pageTable.resize(header.pageCount);
+  for (uint16_t i = 0; i < header.pageCount; i++) {
+    xtc::PageTableEntry entry;
+    if (file.read(reinterpret_cast<uint8_t*>(&entry), sizeof(entry)) != sizeof(entry)) {
+      return false;
+    }
+    book.pageTable[i].offset = static_cast<uint32_t>(entry.dataOffset);
+    book.pageTable[i].size = entry.dataSize;
+    book.pageTable[i].width = entry.width;
+    book.pageTable[i].height = entry.height;
+    book.pageTable[i].bitDepth = 1;
+    book.pageTable[i].padding = 0;
+  }
+
+  const uint64_t chapterOffset = header.chapterOffset | static_cast<uint64_t>(header.padding) << 32;
+  const size_t chapterCount = (header.pageTableOffset - chapterOffset) / CHAPTER_RECORD_SIZE;
+  if (!file.seek(chapterOffset)) {
+    return false;
+  }
+  std::vector<uint8_t> chapterBuf(CHAPTER_RECORD_SIZE);
+  for (size_t i = 0; i < chapterCount; i++) {
+    if (file.read(chapterBuf.data(), CHAPTER_RECORD_SIZE) != CHAPTER_RECORD_SIZE) {
+      return false;
+    }
+    char nameBuf[81];
+    memcpy(nameBuf, chapterBuf.data(), 80);
+    nameBuf[80] = '\0';
+    std::string name(nameBuf, strnlen(nameBuf, 80));
+    uint16_t startPage = 0;
+    uint16_t endPage = 0;
+    memcpy(&startPage, chapterBuf.data() + 0x50, sizeof(startPage));
+    memcpy(&endPage, chapterBuf.data() + 0x52, sizeof(endPage));
+    if (name.empty() && startPage == 0 && endPage == 0) {
+      break;
+    }
+    if (startPage > 0) startPage--;
+    if (endPage > 0) endPage--;
+    if (startPage >= header.pageCount) continue;
+    if (endPage >= header.pageCount) endPage = header.pageCount - 1;
+    if (startPage > endPage) continue;
+    book.chapters.push_back({std::move(name), startPage, endPage});
+  }
+  file.close();
+  return true;
+}
+
+bool samePage(const xtc::PageInfo& a, const xtc::PageInfo& b) {
+  return a.offset == b.offset && a.size == b.size && a.width == b.width && a.height == b.height &&
+         a.bitDepth == b.bitDepth;
+}
+
+// Every entry and chapter in order, then all of them again in a random order
+bool compare(xtc::XtcParser& parser, const ReferenceBook& reference) {
+  if (parser.getPageCount() != reference.pageTable.size() || parser.getChapterCount() != reference.chapters.size()) {
+    return false;
+  }
+
+  std::vector<uint32_t> order(reference.pageTable.size());
+  for (uint32_t i = 0; i < order.size(); i++) {
+    order[i] = i;
+  }
+  std::mt19937 random(1234);
+  for (int pass = 0; pass < 2; pass++) {
+    for (const uint32_t page : order) {
+      xtc::PageInfo info;
+      if (!parser.getPageInfo(page, info) || !samePage(info, reference.pageTable[page])) {
+        fprintf(stderr, "Page %u differs\n", page);
+        return false;
+      }
+    }
+    std::shuffle(order.begin(), order.end(), random);
+  }
+
+  order.resize(reference.chapters.size());
+  for (uint32_t i = 0; i < order.size(); i++) {
+    order[i] = i;
+  }
+  for (int pass = 0; pass < 2; pass++) {
+    for (const uint32_t index : order) {
+      xtc::ChapterInfo chapter;
+      const xtc::ChapterInfo& expected = reference.chapters[index];
+      if (!parser.getChapter(index, chapter) || chapter.name != expected.name ||
+          chapter.startPage != expected.startPage || chapter.endPage != expected.endPage) {
+        fprintf(stderr, "Chapter %u differs\n", index);
+        return false;
+      }
+    }
+    std::shuffle(order.begin(), order.end(), random);
+  }
+  return true;
+}
+
+struct Result {
+  double openMs = 0;
+  double referenceOpenMs = 0;
+  double countChaptersMs = 0;
+  int64_t openHeap = 0;
+  int64_t referenceHeap = 0;
+  bool identical = true;
+};
+
+Result run(const std::string& path, const int iterations) {
+  Result result;
+  for (int i = 0; i < iterations; i++) {
+    const auto heapStart = heap_tracker::snapshot();
+    auto start = Clock::now();
+    auto* parser = new xtc::XtcParser();
+    const bool opened = parser->open(path.c_str()) == xtc::XtcError::OK;
+    result.openMs += msSince(start);
+    result.openHeap = heap_tracker::snapshot().liveBytes - heapStart.liveBytes;
+
+    start = Clock::now();
+    parser->getChapterCount();
+    result.countChaptersMs += msSince(start);
+
+    const auto referenceHeapStart = heap_tracker::snapshot();
+    start = Clock::now();
+    auto* reference = new ReferenceBook();
+    const bool referenceOpened = referenceOpen(path, *reference);
+    result.referenceOpenMs += msSince(start);
+    result.referenceHeap = heap_tracker::snapshot().liveBytes - referenceHeapStart.liveBytes;
+
+    result.identical &= opened && referenceOpened && (i > 0 || compare(*parser, *reference));
+    delete reference;
+    delete parser;
+  }
+  result.openMs /= iterations;
+  result.referenceOpenMs /= iterations;
+  result.countChaptersMs /= iterations;
+  return result;
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+  std::string scratchDir;
+  int iterations = DEFAULT_ITERATIONS;
+  bool verbose = false;
+
+  bench::CommandLine commandLine;
+  commandLine.directory("scratch dir", &scratchDir, "where the test books are written, used as the SD card root")
+      .option("--iterations", "n", &iterations, "opens of every book")
+      .flag("--verbose", &verbose, "print the firmware log to stderr");
+  if (const int status = commandLine.parse(argc, argv); status >= 0) {
+    return status;
+  }
+  iterations = std::max(1, iterations);
+
+  FILE* log = bench::logOutput(verbose);
+  Serial.setOutput(log);
+  SdMan.setRootPath(scratchDir);
+  SdMan.begin();
+
+  bool failed = false;
+  printf("{\n  \"iterations\": %d,\n  \"parserBytes\": %zu,\n  \"books\": [\n", iterations, sizeof(xtc::XtcParser));
+  constexpr size_t caseCount = sizeof(CASES) / sizeof(CASES[0]);
+  for (size_t i = 0; i < caseCount; i++) {
+    const Case& c = CASES[i];
+    fprintf(stderr, "%s\n", c.name);
+    if (!writeBook(scratchDir, c)) {
+      fprintf(stderr, "Failed to write %s\n", c.name);
+      return 2;
+    }
+
+    const Result r = run(std::string("/") + c.name, iterations);
+    failed |= !r.identical;
+    printf(
+        "    {\"name\": \"%s\", \"pages\": %u, \"identical\": %s, \"openMs\": %.3f, \"countChaptersMs\": %.3f, "
+        "\"referenceOpenMs\": %.3f, \"openHeapBytes\": %lld, \"referenceHeapBytes\": %lld}%s\n",
+        c.name, c.pageCount, r.identical ? "true" : "false", r.openMs, r.countChaptersMs, r.referenceOpenMs,
+        static_cast<long long>(r.openHeap), static_cast<long long>(r.referenceHeap), i + 1 == caseCount ? "" : ",");
+    if (!r.identical) {
+      fprintf(stderr, "%s: pages or chapters differ\n", c.name);
+    }
+  }
+  printf("  ]\n}\n");
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,90 @@
+/**
+ * EmulatorMain.cpp
+ *
+ * Host entry point for the firmware: configures the emulated SD card, panel and input script, then runs the
+ * regular setup()/loop() from src/main.cpp until the input script has been replayed.
+ */
+#include <Arduino.h>
+#include <BufferPool.h>
+#include <HalGPIO.h>
+#include <Perf.h>
+#include <SDCardManager.h>
+
+#include <string>
+
+#include "RenderService.h"
+
+void setup();
+void loop();
+void exitActivity();
+
+extern HalGPIO gpio;
+
+namespace {
+void printUsage(const char* argv0) {
+  fprintf(stderr,
+          "Usage: %s --sd <dir> [--input <script>] [--frames <dir>] [--format png|pgm] [--idle-ms <ms>]\n"
+          "  --sd       directory used as the SD card root\n"
+          "  --input    scripted button presses (see docs/emulator.md)\n"
+          "  --frames   directory receiving one image per display refresh plus refresh.log\n"
+          "  --format   frame image format, png (default) or pgm\n"
+          "  --idle-ms  time to keep running after the script ends (default 2000)\n",
+          argv0);
+}
+
+// Same numbers the device serves at /api/perf
+void printPerfSummary() {
+  Serial.printf("[%lu] [PRF] %-10s %8s %10s %10s %10s %10s\n", millis(), "metric", "count", "p50 us", "p90 us",
+                "p99 us", "max us");
+  for (uint8_t i = 0; i < perf::METRIC_COUNT; i++) {
+    const auto metric = static_cast<perf::Metric>(i);
+    const auto& h = perf::histogram(metric);
+    Serial.printf("[%lu] [PRF] %-10s %8u %10u %10u %10u %10u\n", millis(), perf::metricName(metric), h.count,
+                  perf::percentileUs(metric, 50), perf::percentileUs(metric, 90), perf::percentileUs(metric, 99),
+                  h.maxUs);
+  }
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+  unsigned long idleMs = 2000;
+  // Keep the log in order with the frame dumps even when stdout is piped
+  setvbuf(stdout, nullptr, _IOLBF, 0);
+
+  for (int i = 1; i < argc; i++) {
+    const std::string arg = argv[i];
+    const bool hasValue = i + 1 < argc;
+    if (arg == "--sd" && hasValue) {
+      SdMan.setRootPath(argv[++i]);
+    } else if (arg == "--input" && hasValue) {
+      setenv("CROSSPOINT_INPUT_SCRIPT", argv[++i], 1);
+    } else if (arg == "--frames" && hasValue) {
+      setenv("CROSSPOINT_FRAMES_DIR", argv[++i], 1);
+    } else if (arg == "--format" && hasValue) {
+      setenv("CROSSPOINT_FRAME_FORMAT", argv[++i], 1);
+    } else if (arg == "--idle-ms" && hasValue) {
+      idleMs = strtoul(argv[++i], nullptr, 10);
+    } else {
+      printUsage(argv[0]);
+      return arg == "--help" || arg == "-h" ? 0 : 2;
+    }
+  }
+
+  setup();
+  while (!gpio.isInputScriptFinished()) {
+    loop();
+  }
+
+  const unsigned long idleStart = millis();
+  while (millis() - idleStart < idleMs) {
+    loop();
+  }
+
+  // Stops the render task before the process tears down the globals it waits on
+  exitActivity();
+  vTaskDelete(RENDER_SERVICE.getTaskHandle());
+  printPerfSummary();
+  BUFFER_POOL.dump();
+  Serial.flush();
+  return 0;
+}
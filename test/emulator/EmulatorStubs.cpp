@@ -0,0 +1,18 @@
+/**
+ * EmulatorStubs.cpp
+ *
+ * Stand-ins for activities that need WiFi and therefore cannot run in the host emulator. They keep the offline
+ * activities that reference them linkable and back out as soon as they are entered.
+ */
+#include "activities/reader/KOReaderSyncActivity.h"
+
+void KOReaderSyncActivity::onEnter() {
+  ActivityWithSubactivity::onEnter();
+  Serial.printf("[%lu] [KOSync] KOReader sync is not available in the emulator\n", millis());
+}
+
+void KOReaderSyncActivity::onExit() { ActivityWithSubactivity::onExit(); }
+
+void KOReaderSyncActivity::loop() { onCancel(); }
+
+void KOReaderSyncActivity::render() {}
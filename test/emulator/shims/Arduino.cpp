@@ -0,0 +1,81 @@
+#include <Arduino.h>
+#include <SPI.h>
+#include <freertos/task.h>
+#include <malloc.h>
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <thread>
+
+HardwareSerial Serial;
+SPIClass SPI;
+EspClass ESP;
+
+namespace {
+const auto bootTime = std::chrono::steady_clock::now();
+
+// Fixed seed keeps emulator runs reproducible (sleep screen selection, games)
+std::mt19937 rng(0x43505431);
+
+// Usable heap on an ESP32-C3 once the Arduino core, WiFi buffers and the frame buffer are accounted for
+constexpr uint32_t EMULATED_HEAP_SIZE = 380 * 1024;
+uint32_t minFreeHeap = EMULATED_HEAP_SIZE;
+}  // namespace
+
+unsigned long millis() {
+  return static_cast<unsigned long>(
+      std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - bootTime).count());
+}
+
+unsigned long micros() {
+  return static_cast<unsigned long>(
+      std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - bootTime).count());
+}
+
+// Arduino's delay() is vTaskDelay() on the ESP32, so keep it a cancellation point for emulated tasks
+void delay(const uint32_t ms) { vTaskDelay(ms / portTICK_PERIOD_MS); }
+
+void yield() { std::this_thread::yield(); }
+
+long random(const long howbig) {
+  if (howbig <= 0) return 0;
+  return static_cast<long>(rng() % static_cast<unsigned long>(howbig));
+}
+
+long random(const long howsmall, const long howbig) {
+  if (howsmall >= howbig) return howsmall;
+  return howsmall + random(howbig - howsmall);
+}
+
+void randomSeed(const unsigned long seed) { rng.seed(seed); }
+
+void pinMode(uint8_t, uint8_t) {}
+
+int digitalRead(uint8_t) { return LOW; }
+
+void HardwareSerial::begin(unsigned long) {}
+
+size_t HardwareSerial::write(const uint8_t c) { return fputc(c, output) == EOF ? 0 : 1; }
+
+size_t HardwareSerial::write(const uint8_t* buffer, const size_t size) { return fwrite(buffer, 1, size, output); }
+
+void HardwareSerial::flush() { fflush(output); }
+
+uint32_t EspClass::getHeapSize() { return EMULATED_HEAP_SIZE; }
+
+uint32_t EspClass::getFreeHeap() {
+  const auto used = static_cast<uint32_t>(std::min<size_t>(mallinfo2().uordblks, EMULATED_HEAP_SIZE));
+  const uint32_t freeHeap = EMULATED_HEAP_SIZE - used;
+  minFreeHeap = std::min(minFreeHeap, freeHeap);
+  return freeHeap;
+}
+
+uint32_t EspClass::getMinFreeHeap() {
+  getFreeHeap();
+  return minFreeHeap;
+}
+
+uint32_t EspClass::getMaxAllocHeap() { return getFreeHeap(); }
+
+void EspClass::restart() { exit(0); }
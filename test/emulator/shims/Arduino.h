@@ -0,0 +1,55 @@
+#pragma once
+
+/**
+ * Arduino.h (host emulator shim)
+ *
+ * Minimal subset of the ESP32 Arduino core used by the firmware, implemented on top of the C++ standard library so
+ * the real activities can run on Linux.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "HardwareSerial.h"
+#include "Print.h"
+#include "WString.h"
+
+#define HIGH 0x1
+#define LOW 0x0
+
+#define INPUT 0x01
+#define OUTPUT 0x03
+
+using std::max;
+using std::min;
+
+#define PROGMEM
+#define RTC_DATA_ATTR
+#define pgm_read_byte(addr) (*(const uint8_t*)(addr))
+
+unsigned long millis();
+unsigned long micros();
+void delay(uint32_t ms);
+void yield();
+
+long random(long howbig);
+long random(long howsmall, long howbig);
+void randomSeed(unsigned long seed);
+
+void pinMode(uint8_t pin, uint8_t mode);
+int digitalRead(uint8_t pin);
+
+class EspClass {
+ public:
+  uint32_t getHeapSize();
+  uint32_t getFreeHeap();
+  uint32_t getMinFreeHeap();
+  uint32_t getMaxAllocHeap();
+  void restart();
+};
+
+extern EspClass ESP;
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdlib>
+
+/**
+ * BatteryMonitor.h (host emulator shim)
+ *
+ * Reports a constant charge level, $CROSSPOINT_BATTERY overrides the default of 100%.
+ */
+class BatteryMonitor {
+ public:
+  explicit BatteryMonitor(uint8_t) {}
+
+  uint16_t readPercentage() const {
+    const char* level = getenv("CROSSPOINT_BATTERY");
+    return level ? static_cast<uint16_t>(atoi(level)) : 100;
+  }
+};
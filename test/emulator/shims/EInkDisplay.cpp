@@ -0,0 +1,184 @@
+#include <Arduino.h>
+#include <EInkDisplay.h>
+#include <miniz.h>
+#include <sys/stat.h>
+
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+constexpr uint8_t WHITE = 255;
+constexpr uint8_t BLACK = 0;
+// Gray levels the grayscale LUT produces for (msb, lsb) = (1, 0) and (1, 1)
+constexpr uint8_t LIGHT_GRAY = 170;
+constexpr uint8_t DARK_GRAY = 85;
+
+bool bitSet(const uint8_t* buffer, const uint32_t index) { return buffer[index >> 3] & (0x80 >> (index & 7)); }
+
+const char* refreshModeName(const EInkDisplay::RefreshMode mode) {
+  switch (mode) {
+    case EInkDisplay::FULL_REFRESH:
+      return "FULL";
+    case EInkDisplay::HALF_REFRESH:
+      return "HALF";
+    case EInkDisplay::FAST_REFRESH:
+    default:
+      return "FAST";
+  }
+}
+}  // namespace
+
+EInkDisplay::EInkDisplay(int8_t, int8_t, int8_t, int8_t, int8_t, int8_t)
+    : frameBuffer(new uint8_t[BUFFER_SIZE]),
+      previousBuffer(new uint8_t[BUFFER_SIZE]),
+      lsbPlane(new uint8_t[BUFFER_SIZE]),
+      msbPlane(new uint8_t[BUFFER_SIZE]),
+      panel(new uint8_t[DISPLAY_WIDTH * DISPLAY_HEIGHT]) {
+  memset(frameBuffer, 0xFF, BUFFER_SIZE);
+  memset(previousBuffer, 0xFF, BUFFER_SIZE);
+  memset(lsbPlane, 0x00, BUFFER_SIZE);
+  memset(msbPlane, 0x00, BUFFER_SIZE);
+  memset(panel, WHITE, DISPLAY_WIDTH * DISPLAY_HEIGHT);
+}
+
+EInkDisplay::~EInkDisplay() {
+  if (refreshLog) {
+    fclose(refreshLog);
+  }
+  delete[] frameBuffer;
+  delete[] previousBuffer;
+  delete[] lsbPlane;
+  delete[] msbPlane;
+  delete[] panel;
+}
+
+void EInkDisplay::begin() {
+  const char* dir = getenv("CROSSPOINT_FRAMES_DIR");
+  const char* format = getenv("CROSSPOINT_FRAME_FORMAT");
+  writePng = !format || strcmp(format, "pgm") != 0;
+  if (!dir || dir[0] == '\0') {
+    return;
+  }
+
+  outputDir = dir;
+  mkdir(outputDir.c_str(), 0755);
+  refreshLog = fopen((outputDir + "/refresh.log").c_str(), "w");
+  if (refreshLog) {
+    fprintf(refreshLog, "# frame millis mode changed_bytes\n");
+  }
+}
+
+void EInkDisplay::clearScreen(const uint8_t color) const { memset(frameBuffer, color, BUFFER_SIZE); }
+
+void EInkDisplay::drawImage(const uint8_t* imageData, const uint16_t x, const uint16_t y, const uint16_t w,
+                            const uint16_t h, bool) const {
+  // Same contract as the panel driver: x and w are byte aligned, rows are packed MSB first
+  const uint16_t rowBytes = w / 8;
+  const uint16_t xByte = x / 8;
+  for (uint16_t row = 0; row < h && y + row < DISPLAY_HEIGHT; row++) {
+    const uint16_t copyBytes = xByte + rowBytes > DISPLAY_WIDTH_BYTES ? DISPLAY_WIDTH_BYTES - xByte : rowBytes;
+    memcpy(frameBuffer + (y + row) * DISPLAY_WIDTH_BYTES + xByte, imageData + row * rowBytes, copyBytes);
+  }
+}
+
+void EInkDisplay::displayBuffer(const RefreshMode mode) {
+  uint32_t changed = 0;
+  for (uint32_t i = 0; i < BUFFER_SIZE; i++) {
+    changed += frameBuffer[i] != previousBuffer[i];
+  }
+  memcpy(previousBuffer, frameBuffer, BUFFER_SIZE);
+
+  for (uint32_t i = 0; i < static_cast<uint32_t>(DISPLAY_WIDTH) * DISPLAY_HEIGHT; i++) {
+    panel[i] = bitSet(frameBuffer, i) ? WHITE : BLACK;
+  }
+
+  logRefresh(refreshModeName(mode), changed);
+  dumpFrame();
+}
+
+void EInkDisplay::refreshDisplay(const RefreshMode mode, bool) {
+  logRefresh(refreshModeName(mode), 0);
+  dumpFrame();
+}
+
+void EInkDisplay::deepSleep() {
+  if (refreshLog) {
+    fprintf(refreshLog, "- %lu SLEEP 0\n", millis());
+    fflush(refreshLog);
+  }
+}
+
+void EInkDisplay::copyGrayscaleBuffers(const uint8_t* lsbBuffer, const uint8_t* msbBuffer) {
+  copyGrayscaleLsbBuffers(lsbBuffer);
+  copyGrayscaleMsbBuffers(msbBuffer);
+}
+
+void EInkDisplay::copyGrayscaleLsbBuffers(const uint8_t* lsbBuffer) { memcpy(lsbPlane, lsbBuffer, BUFFER_SIZE); }
+
+void EInkDisplay::copyGrayscaleMsbBuffers(const uint8_t* msbBuffer) { memcpy(msbPlane, msbBuffer, BUFFER_SIZE); }
+
+void EInkDisplay::cleanupGrayscaleBuffers(const uint8_t* bwBuffer) {
+  // Resyncs the controller RAM for the next differential refresh, nothing visible changes
+  memcpy(previousBuffer, bwBuffer, BUFFER_SIZE);
+}
+
+void EInkDisplay::displayGrayBuffer() {
+  uint32_t changed = 0;
+  for (uint32_t i = 0; i < static_cast<uint32_t>(DISPLAY_WIDTH) * DISPLAY_HEIGHT; i++) {
+    if (!bitSet(msbPlane, i)) {
+      continue;
+    }
+    panel[i] = bitSet(lsbPlane, i) ? DARK_GRAY : LIGHT_GRAY;
+    changed++;
+  }
+
+  logRefresh("GRAY", (changed + 7) / 8);
+  dumpFrame();
+}
+
+void EInkDisplay::logRefresh(const char* mode, const uint32_t changedBytes) {
+  frameCount++;
+  if (refreshLog) {
+    fprintf(refreshLog, "%u %lu %s %u\n", frameCount, millis(), mode, changedBytes);
+    fflush(refreshLog);
+  }
+}
+
+void EInkDisplay::dumpFrame() const {
+  if (outputDir.empty()) {
+    return;
+  }
+
+  // Rotate into portrait, the way the device is held, matching GfxRenderer::Portrait
+  constexpr int outWidth = DISPLAY_HEIGHT;
+  constexpr int outHeight = DISPLAY_WIDTH;
+  auto* image = new uint8_t[outWidth * outHeight];
+  for (int py = 0; py < outHeight; py++) {
+    for (int px = 0; px < outWidth; px++) {
+      image[py * outWidth + px] = panel[(DISPLAY_HEIGHT - 1 - px) * DISPLAY_WIDTH + py];
+    }
+  }
+
+  char path[512];
+  snprintf(path, sizeof(path), "%s/frame_%04u.%s", outputDir.c_str(), frameCount, writePng ? "png" : "pgm");
+  FILE* out = fopen(path, "wb");
+  if (!out) {
+    Serial.printf("[%lu] [EMU] Failed to write frame: %s\n", millis(), path);
+    delete[] image;
+    return;
+  }
+
+  if (writePng) {
+    size_t pngSize = 0;
+    void* png = tdefl_write_image_to_png_file_in_memory(image, outWidth, outHeight, 1, &pngSize);
+    if (png) {
+      fwrite(png, 1, pngSize, out);
+      mz_free(png);
+    }
+  } else {
+    fprintf(out, "P5\n%d %d\n255\n", outWidth, outHeight);
+    fwrite(image, 1, outWidth * outHeight, out);
+  }
+  fclose(out);
+  delete[] image;
+}
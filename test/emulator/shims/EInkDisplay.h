@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+/**
+ * EInkDisplay.h (host emulator shim)
+ *
+ * In-memory stand-in for the SSD1677 panel driver. It keeps the frame buffer and both grayscale planes, composes what
+ * the panel would show after every refresh and dumps it as a portrait PGM or PNG frame, together with one line per
+ * refresh in refresh.log (frame number, timestamp, refresh mode and how many bytes changed).
+ *
+ * Output goes to $CROSSPOINT_FRAMES_DIR (no dumps when unset), $CROSSPOINT_FRAME_FORMAT selects "png" (default) or
+ * "pgm".
+ */
+class EInkDisplay {
+ public:
+  static constexpr uint16_t DISPLAY_WIDTH = 800;
+  static constexpr uint16_t DISPLAY_HEIGHT = 480;
+  static constexpr uint16_t DISPLAY_WIDTH_BYTES = DISPLAY_WIDTH / 8;
+  static constexpr uint32_t BUFFER_SIZE = DISPLAY_WIDTH_BYTES * DISPLAY_HEIGHT;
+
+  enum RefreshMode { FULL_REFRESH, HALF_REFRESH, FAST_REFRESH };
+
+  EInkDisplay(int8_t sclk, int8_t mosi, int8_t cs, int8_t dc, int8_t rst, int8_t busy);
+  ~EInkDisplay();
+
+  void begin();
+  void clearScreen(uint8_t color = 0xFF) const;
+  void drawImage(const uint8_t* imageData, uint16_t x, uint16_t y, uint16_t w, uint16_t h,
+                 bool fromProgmem = false) const;
+  void displayBuffer(RefreshMode mode = FAST_REFRESH);
+  void refreshDisplay(RefreshMode mode = FAST_REFRESH, bool turnOffScreen = false);
+  void deepSleep();
+  uint8_t* getFrameBuffer() const { return frameBuffer; }
+
+  void copyGrayscaleBuffers(const uint8_t* lsbBuffer, const uint8_t* msbBuffer);
+  void copyGrayscaleLsbBuffers(const uint8_t* lsbBuffer);
+  void copyGrayscaleMsbBuffers(const uint8_t* msbBuffer);
+  void cleanupGrayscaleBuffers(const uint8_t* bwBuffer);
+  void displayGrayBuffer();
+
+  // Emulator only: number of refreshes issued so far
+  uint32_t getFrameCount() const { return frameCount; }
+
+ private:
+  uint8_t* frameBuffer;
+  uint8_t* previousBuffer;
+  uint8_t* lsbPlane;
+  uint8_t* msbPlane;
+  // 8-bit luminance of what the panel currently shows, in native (landscape) orientation
+  uint8_t* panel;
+  uint32_t frameCount = 0;
+  std::string outputDir;
+  bool writePng = true;
+  FILE* refreshLog = nullptr;
+
+  void logRefresh(const char* mode, uint32_t changedBytes);
+  void dumpFrame() const;
+};
@@ -0,0 +1,202 @@
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+
+struct EmulatedTask {
+  std::thread thread;
+  std::string name;
+  uint32_t stackDepth = 0;
+  std::atomic<bool> deleted{false};
+};
+
+struct EmulatedSemaphore {
+  bool available = false;
+  // Recursive mutexes only
+  std::thread::id owner;
+  uint32_t depth = 0;
+};
+
+namespace {
+// All blocking primitives share one lock and condition variable, deletion only needs a single broadcast to reach
+// whichever primitive the target task is parked on.
+std::mutex schedulerMutex;
+std::condition_variable schedulerCondition;
+thread_local EmulatedTask* currentTask = nullptr;
+
+struct TaskDeletedUnwind {};
+
+bool currentTaskDeleted() { return currentTask && currentTask->deleted.load(); }
+}  // namespace
+
+BaseType_t xTaskCreate(const TaskFunction_t taskCode, const char* name, const uint32_t stackDepth, void* parameters,
+                       UBaseType_t, TaskHandle_t* createdTask) {
+  auto* task = new EmulatedTask();
+  task->name = name ? name : "";
+  task->stackDepth = stackDepth;
+  task->thread = std::thread([task, taskCode, parameters] {
+    currentTask = task;
+    try {
+      taskCode(parameters);
+    } catch (const TaskDeletedUnwind&) {
+      // Task was deleted while blocked, unwinding here mirrors the scheduler never resuming it
+    }
+  });
+  if (createdTask) {
+    *createdTask = task;
+  }
+  return pdPASS;
+}
+
+void vTaskDelete(TaskHandle_t task) {
+  if (!task) {
+    task = currentTask;
+  }
+  if (!task) {
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(schedulerMutex);
+    task->deleted = true;
+  }
+  schedulerCondition.notify_all();
+
+  if (task == currentTask) {
+    task->thread.detach();
+    throw TaskDeletedUnwind();
+  }
+
+  if (task->thread.joinable()) {
+    task->thread.join();
+  }
+  delete task;
+}
+
+void vTaskDelay(const TickType_t ticks) {
+  if (!currentTask) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(ticks * portTICK_PERIOD_MS));
+    return;
+  }
+
+  std::unique_lock<std::mutex> lock(schedulerMutex);
+  schedulerCondition.wait_for(lock, std::chrono::milliseconds(ticks * portTICK_PERIOD_MS), currentTaskDeleted);
+  if (currentTaskDeleted()) {
+    throw TaskDeletedUnwind();
+  }
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle() { return currentTask; }
+
+char* pcTaskGetName(TaskHandle_t task) {
+  if (!task) {
+    task = currentTask;
+  }
+  static char loopTaskName[] = "loopTask";
+  return task ? &task->name[0] : loopTaskName;
+}
+
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task) {
+  if (!task) {
+    task = currentTask;
+  }
+  // The loop task has no EmulatedTask, report the Arduino core's default loop stack
+  return task ? task->stackDepth : 8192;
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex() {
+  auto* semaphore = new EmulatedSemaphore();
+  semaphore->available = true;
+  return semaphore;
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary() { return new EmulatedSemaphore(); }
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, const TickType_t ticks) {
+  if (!semaphore) {
+    return pdFALSE;
+  }
+
+  std::unique_lock<std::mutex> lock(schedulerMutex);
+  const auto ready = [semaphore] { return semaphore->available || currentTaskDeleted(); };
+  if (ticks == portMAX_DELAY) {
+    schedulerCondition.wait(lock, ready);
+  } else {
+    schedulerCondition.wait_for(lock, std::chrono::milliseconds(ticks * portTICK_PERIOD_MS), ready);
+  }
+
+  if (currentTaskDeleted()) {
+    throw TaskDeletedUnwind();
+  }
+  if (!semaphore->available) {
+    return pdFALSE;
+  }
+  semaphore->available = false;
+  return pdTRUE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore) {
+  if (!semaphore) {
+    return pdFALSE;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(schedulerMutex);
+    semaphore->available = true;
+  }
+  schedulerCondition.notify_all();
+  return pdTRUE;
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t semaphore) { delete semaphore; }
+
+SemaphoreHandle_t xSemaphoreCreateRecursiveMutex() { return new EmulatedSemaphore(); }
+
+BaseType_t xSemaphoreTakeRecursive(SemaphoreHandle_t semaphore, const TickType_t ticks) {
+  if (!semaphore) {
+    return pdFALSE;
+  }
+
+  const auto self = std::this_thread::get_id();
+  std::unique_lock<std::mutex> lock(schedulerMutex);
+  const auto ready = [semaphore, self] {
+    return semaphore->depth == 0 || semaphore->owner == self || currentTaskDeleted();
+  };
+  if (ticks == portMAX_DELAY) {
+    schedulerCondition.wait(lock, ready);
+  } else {
+    schedulerCondition.wait_for(lock, std::chrono::milliseconds(ticks * portTICK_PERIOD_MS), ready);
+  }
+
+  if (currentTaskDeleted()) {
+    throw TaskDeletedUnwind();
+  }
+  if (semaphore->depth > 0 && semaphore->owner != self) {
+    return pdFALSE;
+  }
+  semaphore->owner = self;
+  semaphore->depth++;
+  return pdTRUE;
+}
+
+BaseType_t xSemaphoreGiveRecursive(SemaphoreHandle_t semaphore) {
+  if (!semaphore) {
+    return pdFALSE;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(schedulerMutex);
+    if (semaphore->depth == 0 || semaphore->owner != std::this_thread::get_id()) {
+      return pdFALSE;
+    }
+    semaphore->depth--;
+  }
+  schedulerCondition.notify_all();
+  return pdTRUE;
+}
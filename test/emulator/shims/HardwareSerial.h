@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstdio>
+#include <functional>
+
+#include "Print.h"
+
+/**
+ * HardwareSerial.h (host emulator shim)
+ *
+ * Serial output goes to stdout so the emulator log matches what the device prints over USB.
+ */
+class HardwareSerial : public Print {
+  FILE* output = stdout;
+
+ public:
+  void begin(unsigned long baud);
+  void end() {}
+  size_t write(uint8_t c) override;
+  size_t write(const uint8_t* buffer, size_t size) override;
+  using Print::write;
+  void flush() override;
+  explicit operator bool() const { return true; }
+
+  // Emulator only: host benchmarks keep stdout for their report and send the firmware log elsewhere
+  void setOutput(FILE* stream) { output = stream; }
+};
+
+extern HardwareSerial Serial;
+
+unsigned long millis();
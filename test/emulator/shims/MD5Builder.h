@@ -0,0 +1,30 @@
+#pragma once
+
+#include <WString.h>
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * MD5Builder.h (host emulator shim)
+ *
+ * Plain RFC 1321 MD5 with the ESP32 core's MD5Builder interface.
+ */
+class MD5Builder {
+  uint32_t state[4] = {};
+  uint64_t length = 0;
+  uint8_t block[64] = {};
+  uint8_t digest[16] = {};
+
+  void transform(const uint8_t* data);
+
+ public:
+  void begin();
+  void add(const uint8_t* data, size_t len);
+  void add(const char* data);
+  void add(const String& data) { add(data.c_str()); }
+  void calculate();
+  void getBytes(uint8_t* output) const;
+  void getChars(char* output) const;
+  String toString() const;
+};
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstdarg>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+/**
+ * Print.h (host emulator shim)
+ *
+ * Byte sink base class matching the Arduino core interface. Subclasses only need to implement the single byte write,
+ * bulk writes fall back to it unless overridden.
+ */
+class Print {
+ public:
+  virtual ~Print() = default;
+
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t* buffer, size_t size) {
+    size_t n = 0;
+    while (size--) {
+      if (write(*buffer++) == 0) break;
+      n++;
+    }
+    return n;
+  }
+  size_t write(const char* str) { return str ? write(reinterpret_cast<const uint8_t*>(str), strlen(str)) : 0; }
+  virtual void flush() {}
+
+  size_t print(const char* str) { return write(str); }
+  size_t print(char c) { return write(static_cast<uint8_t>(c)); }
+  size_t print(int value) { return printf("%d", value); }
+  size_t print(unsigned int value) { return printf("%u", value); }
+  size_t print(long value) { return printf("%ld", value); }
+  size_t print(unsigned long value) { return printf("%lu", value); }
+  size_t print(double value, int digits = 2) { return printf("%.*f", digits, value); }
+
+  size_t println() { return write("\r\n"); }
+  template <typename T>
+  size_t println(T value) {
+    const size_t n = print(value);
+    return n + println();
+  }
+
+  size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3))) {
+    char stackBuffer[256];
+    va_list args;
+    va_start(args, format);
+    const int len = vsnprintf(stackBuffer, sizeof(stackBuffer), format, args);
+    va_end(args);
+    if (len < 0) {
+      return 0;
+    }
+    if (static_cast<size_t>(len) < sizeof(stackBuffer)) {
+      return write(reinterpret_cast<const uint8_t*>(stackBuffer), len);
+    }
+
+    auto* heapBuffer = new char[len + 1];
+    va_start(args, format);
+    vsnprintf(heapBuffer, len + 1, format, args);
+    va_end(args);
+    const size_t written = write(reinterpret_cast<const uint8_t*>(heapBuffer), len);
+    delete[] heapBuffer;
+    return written;
+  }
+};
+
+/**
+ * Stream.h equivalent: a Print that can also be read from.
+ */
+class Stream : public Print {
+ public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+
+  size_t readBytes(uint8_t* buffer, size_t length) {
+    size_t count = 0;
+    while (count < length) {
+      const int c = read();
+      if (c < 0) break;
+      buffer[count++] = static_cast<uint8_t>(c);
+    }
+    return count;
+  }
+};
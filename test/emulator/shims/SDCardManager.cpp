@@ -0,0 +1,114 @@
+#include <Arduino.h>
+#include <SDCardManager.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+
+SDCardManager SDCardManager::instance;
+
+std::string SDCardManager::hostPath(const char* path) const {
+  if (!path || path[0] == '\0') {
+    return rootPath;
+  }
+  return rootPath + (path[0] == '/' ? "" : "/") + path;
+}
+
+bool SDCardManager::begin() {
+  if (rootPath.empty()) {
+    const char* envRoot = getenv("CROSSPOINT_SD_ROOT");
+    rootPath = envRoot ? envRoot : "sdcard";
+  }
+  while (rootPath.size() > 1 && rootPath.back() == '/') {
+    rootPath.pop_back();
+  }
+
+  struct stat st {};
+  initialized = stat(rootPath.c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+  if (!initialized) {
+    Serial.printf("[%lu] [SD] Emulated card directory not found: %s\n", millis(), rootPath.c_str());
+  }
+  return initialized;
+}
+
+FsFile SDCardManager::open(const char* path, const oflag_t oflag) {
+  FsFile file;
+  file.open(hostPath(path).c_str(), oflag);
+  return file;
+}
+
+bool SDCardManager::exists(const char* path) const {
+  struct stat st {};
+  return stat(hostPath(path).c_str(), &st) == 0;
+}
+
+bool SDCardManager::mkdir(const char* path, const bool pFlag) {
+  const std::string full = hostPath(path);
+  if (pFlag) {
+    for (size_t i = rootPath.size() + 1; i < full.size(); i++) {
+      if (full[i] == '/') {
+        ::mkdir(full.substr(0, i).c_str(), 0755);
+      }
+    }
+  }
+  return ::mkdir(full.c_str(), 0755) == 0 || errno == EEXIST;
+}
+
+bool SDCardManager::remove(const char* path) { return ::unlink(hostPath(path).c_str()) == 0; }
+
+bool SDCardManager::rmdir(const char* path) { return ::rmdir(hostPath(path).c_str()) == 0; }
+
+bool SDCardManager::removeDir(const char* path) {
+  auto dir = open(path);
+  if (!dir || !dir.isDirectory()) {
+    return false;
+  }
+
+  const std::string base = path;
+  char name[256];
+  for (auto entry = dir.openNextFile(); entry; entry = dir.openNextFile()) {
+    entry.getName(name, sizeof(name));
+    const std::string child = base + "/" + name;
+    const bool isDirectory = entry.isDirectory();
+    entry.close();
+    if (isDirectory ? !removeDir(child.c_str()) : !remove(child.c_str())) {
+      return false;
+    }
+  }
+  dir.close();
+  return rmdir(path);
+}
+
+bool SDCardManager::openFileForRead(const char* moduleName, const char* path, FsFile& file) {
+  if (!exists(path)) {
+    Serial.printf("[%lu] [%s] File does not exist: %s\n", millis(), moduleName, path);
+    return false;
+  }
+
+  if (!file.open(hostPath(path).c_str(), O_RDONLY)) {
+    Serial.printf("[%lu] [%s] Failed to open file for reading: %s\n", millis(), moduleName, path);
+    return false;
+  }
+  return true;
+}
+
+bool SDCardManager::openFileForWrite(const char* moduleName, const char* path, FsFile& file) {
+  if (!file.open(hostPath(path).c_str(), O_RDWR | O_CREAT | O_TRUNC)) {
+    Serial.printf("[%lu] [%s] Failed to open file for writing: %s\n", millis(), moduleName, path);
+    return false;
+  }
+  return true;
+}
+
+bool FsFile::rename(const char* newPath) {
+  const std::string& root = SdMan.getRootPath();
+  const std::string target = root + (newPath[0] == '/' ? "" : "/") + newPath;
+  if (hostPath.empty() || ::rename(hostPath.c_str(), target.c_str()) != 0) {
+    return false;
+  }
+  hostPath = target;
+  fileName = target.substr(target.find_last_of('/') + 1);
+  return true;
+}
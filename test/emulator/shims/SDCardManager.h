@@ -0,0 +1,54 @@
+#pragma once
+
+#include <SdFat.h>
+#include <WString.h>
+
+#include <string>
+
+/**
+ * SDCardManager.h (host emulator shim)
+ *
+ * Same interface as the SDK's SDCardManager, rooted at a host directory instead of the SD card. The root defaults
+ * to $CROSSPOINT_SD_ROOT and can be overridden with setRootPath() before begin().
+ */
+class SDCardManager {
+  static SDCardManager instance;
+
+  std::string rootPath;
+  bool initialized = false;
+
+  std::string hostPath(const char* path) const;
+
+ public:
+  static SDCardManager& getInstance() { return instance; }
+
+  void setRootPath(const std::string& path) { rootPath = path; }
+  const std::string& getRootPath() const { return rootPath; }
+
+  bool begin();
+  bool ready() const { return initialized; }
+
+  FsFile open(const char* path, oflag_t oflag = O_RDONLY);
+  bool exists(const char* path) const;
+  bool mkdir(const char* path, bool pFlag = true);
+  bool remove(const char* path);
+  bool rmdir(const char* path);
+  bool removeDir(const char* path);
+
+  bool openFileForRead(const char* moduleName, const char* path, FsFile& file);
+  bool openFileForRead(const char* moduleName, const std::string& path, FsFile& file) {
+    return openFileForRead(moduleName, path.c_str(), file);
+  }
+  bool openFileForRead(const char* moduleName, const String& path, FsFile& file) {
+    return openFileForRead(moduleName, path.c_str(), file);
+  }
+  bool openFileForWrite(const char* moduleName, const char* path, FsFile& file);
+  bool openFileForWrite(const char* moduleName, const std::string& path, FsFile& file) {
+    return openFileForWrite(moduleName, path.c_str(), file);
+  }
+  bool openFileForWrite(const char* moduleName, const String& path, FsFile& file) {
+    return openFileForWrite(moduleName, path.c_str(), file);
+  }
+};
+
+#define SdMan SDCardManager::getInstance()
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * SPI.h (host emulator shim)
+ */
+class SPIClass {
+ public:
+  void begin(int8_t, int8_t, int8_t, int8_t) {}
+};
+
+extern SPIClass SPI;
@@ -0,0 +1,233 @@
+#include <SdFat.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <ctime>
+#include <utility>
+
+namespace {
+std::string baseName(const std::string& path) {
+  const auto slash = path.find_last_of('/');
+  return slash == std::string::npos ? path : path.substr(slash + 1);
+}
+
+const char* stdioMode(const oflag_t oflag) {
+  const int access = oflag & O_ACCMODE;
+  if (access == O_RDONLY) {
+    return "rb";
+  }
+  if (oflag & O_APPEND) {
+    return access == O_RDWR ? "a+b" : "ab";
+  }
+  if (oflag & O_TRUNC) {
+    return access == O_RDWR ? "w+b" : "wb";
+  }
+  return "r+b";
+}
+}  // namespace
+
+FsIoStats& fsIoStats() {
+  static FsIoStats stats;
+  return stats;
+}
+
+FsFile::FsFile(FsFile&& other) noexcept
+    : fp(std::exchange(other.fp, nullptr)),
+      dir(std::exchange(other.dir, nullptr)),
+      hostPath(std::move(other.hostPath)),
+      fileName(std::move(other.fileName)),
+      lastOp(other.lastOp) {}
+
+FsFile& FsFile::operator=(FsFile&& other) noexcept {
+  if (this != &other) {
+    close();
+    fp = std::exchange(other.fp, nullptr);
+    dir = std::exchange(other.dir, nullptr);
+    hostPath = std::move(other.hostPath);
+    fileName = std::move(other.fileName);
+    lastOp = other.lastOp;
+  }
+  return *this;
+}
+
+bool FsFile::open(const char* path, const oflag_t oflag) {
+  close();
+
+  struct stat st {};
+  const bool exists = stat(path, &st) == 0;
+  if (exists && S_ISDIR(st.st_mode)) {
+    dir = opendir(path);
+  } else if (exists || (oflag & O_CREAT)) {
+    // "r+b" refuses to create, so fall back to "w+b" for a new file opened without O_TRUNC
+    const char* mode = stdioMode(oflag);
+    if (!exists && strcmp(mode, "r+b") == 0) {
+      mode = "w+b";
+    }
+    fp = fopen(path, mode);
+  }
+
+  if (!isOpen()) {
+    return false;
+  }
+  hostPath = path;
+  fileName = baseName(hostPath);
+  lastOp = LastOp::None;
+  return true;
+}
+
+bool FsFile::close() {
+  const bool wasOpen = isOpen();
+  if (fp) {
+    fclose(fp);
+    fp = nullptr;
+  }
+  if (dir) {
+    closedir(dir);
+    dir = nullptr;
+  }
+  return wasOpen;
+}
+
+void FsFile::prepare(const LastOp op) {
+  if (lastOp != LastOp::None && lastOp != op) {
+    fseek(fp, 0, SEEK_CUR);
+  }
+  lastOp = op;
+}
+
+int FsFile::read() {
+  uint8_t c;
+  return read(&c, 1) == 1 ? c : -1;
+}
+
+int FsFile::read(void* buf, const size_t count) {
+  if (!fp) return -1;
+  prepare(LastOp::Read);
+  const size_t n = fread(buf, 1, count, fp);
+  fsIoStats().readCalls++;
+  fsIoStats().bytesRead += n;
+  return static_cast<int>(n);
+}
+
+int FsFile::peek() {
+  if (!fp) return -1;
+  prepare(LastOp::Read);
+  const int c = fgetc(fp);
+  if (c != EOF) {
+    ungetc(c, fp);
+  }
+  return c == EOF ? -1 : c;
+}
+
+int FsFile::available() {
+  if (!fp) return 0;
+  const uint64_t remaining = size() - position();
+  return remaining > INT32_MAX ? INT32_MAX : static_cast<int>(remaining);
+}
+
+size_t FsFile::write(const uint8_t c) { return write(&c, 1); }
+
+size_t FsFile::write(const uint8_t* buffer, const size_t size) {
+  if (!fp) return 0;
+  prepare(LastOp::Write);
+  const size_t n = fwrite(buffer, 1, size, fp);
+  fsIoStats().writeCalls++;
+  fsIoStats().bytesWritten += n;
+  return n;
+}
+
+void FsFile::flush() {
+  if (fp) {
+    fflush(fp);
+  }
+}
+
+bool FsFile::seekSet(const uint64_t pos) {
+  if (!fp) return false;
+  lastOp = LastOp::None;
+  return fseeko(fp, static_cast<off_t>(pos), SEEK_SET) == 0;
+}
+
+bool FsFile::seekCur(const int64_t offset) {
+  if (!fp) return false;
+  lastOp = LastOp::None;
+  return fseeko(fp, static_cast<off_t>(offset), SEEK_CUR) == 0;
+}
+
+bool FsFile::seekEnd(const int64_t offset) {
+  if (!fp) return false;
+  lastOp = LastOp::None;
+  return fseeko(fp, static_cast<off_t>(offset), SEEK_END) == 0;
+}
+
+uint64_t FsFile::position() const {
+  if (!fp) return 0;
+  const off_t pos = ftello(fp);
+  return pos < 0 ? 0 : static_cast<uint64_t>(pos);
+}
+
+uint64_t FsFile::size() const {
+  if (fp) {
+    fflush(fp);
+    struct stat st {};
+    return fstat(fileno(fp), &st) == 0 ? static_cast<uint64_t>(st.st_size) : 0;
+  }
+  return 0;
+}
+
+bool FsFile::truncate(const uint64_t length) {
+  if (!fp) return false;
+  fflush(fp);
+  return ftruncate(fileno(fp), static_cast<off_t>(length)) == 0;
+}
+
+FsFile FsFile::openNextFile(const oflag_t oflag) {
+  FsFile next;
+  if (!dir) {
+    return next;
+  }
+
+  while (const dirent* entry = readdir(dir)) {
+    if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) {
+      continue;
+    }
+    const std::string childPath = hostPath + "/" + entry->d_name;
+    if (next.open(childPath.c_str(), oflag)) {
+      return next;
+    }
+  }
+  return next;
+}
+
+void FsFile::rewindDirectory() {
+  if (dir) {
+    rewinddir(dir);
+  }
+}
+
+size_t FsFile::getName(char* name, const size_t len) const {
+  if (!name || len == 0) return 0;
+  const size_t n = fileName.size() < len - 1 ? fileName.size() : len - 1;
+  memcpy(name, fileName.c_str(), n);
+  name[n] = '\0';
+  return n;
+}
+
+bool FsFile::getModifyDateTime(uint16_t* pdate, uint16_t* ptime) const {
+  struct stat st {};
+  if (hostPath.empty() || stat(hostPath.c_str(), &st) != 0) {
+    return false;
+  }
+
+  // FAT packs timestamps as (year-1980)<<9 | month<<5 | day and hour<<11 | minute<<5 | second/2
+  tm local {};
+  localtime_r(&st.st_mtime, &local);
+  if (pdate) {
+    *pdate = static_cast<uint16_t>(((local.tm_year - 80) << 9) | ((local.tm_mon + 1) << 5) | local.tm_mday);
+  }
+  if (ptime) {
+    *ptime = static_cast<uint16_t>((local.tm_hour << 11) | (local.tm_min << 5) | (local.tm_sec / 2));
+  }
+  return true;
+}
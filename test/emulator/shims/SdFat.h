@@ -0,0 +1,99 @@
+#pragma once
+
+#include <dirent.h>
+#include <fcntl.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+#include "Arduino.h"
+
+/**
+ * SdFat.h (host emulator shim)
+ *
+ * FsFile backed by a host file or directory. Paths handed to FsFile are already host paths, SDCardManager is
+ * responsible for mapping SD card paths onto the emulated card directory.
+ */
+
+typedef int oflag_t;
+
+#ifndef O_READ
+#define O_READ O_RDONLY
+#endif
+#ifndef O_WRITE
+#define O_WRITE O_WRONLY
+#endif
+
+// Emulator only: traffic through every FsFile since startup, read by the host benchmarks
+struct FsIoStats {
+  uint64_t readCalls = 0;
+  uint64_t bytesRead = 0;
+  uint64_t writeCalls = 0;
+  uint64_t bytesWritten = 0;
+};
+
+FsIoStats& fsIoStats();
+
+class FsFile : public Stream {
+  FILE* fp = nullptr;
+  DIR* dir = nullptr;
+  std::string hostPath;
+  std::string fileName;
+  // stdio requires a positioning call when switching between reading and writing on the same stream
+  enum class LastOp : uint8_t { None, Read, Write } lastOp = LastOp::None;
+
+  void prepare(LastOp op);
+
+ public:
+  FsFile() = default;
+  ~FsFile() override { close(); }
+  FsFile(const FsFile&) = delete;
+  FsFile& operator=(const FsFile&) = delete;
+  FsFile(FsFile&& other) noexcept;
+  FsFile& operator=(FsFile&& other) noexcept;
+
+  bool open(const char* path, oflag_t oflag = O_RDONLY);
+  bool close();
+  bool isOpen() const { return fp != nullptr || dir != nullptr; }
+  explicit operator bool() const { return isOpen(); }
+
+  bool isDirectory() const { return dir != nullptr; }
+  bool isDir() const { return isDirectory(); }
+  bool isFile() const { return fp != nullptr; }
+  bool isHidden() const { return !fileName.empty() && fileName[0] == '.'; }
+
+  int read() override;
+  int read(void* buf, size_t count);
+  int peek() override;
+  int available() override;
+
+  size_t write(uint8_t c) override;
+  size_t write(const uint8_t* buffer, size_t size) override;
+  size_t write(const void* buffer, size_t size) { return write(static_cast<const uint8_t*>(buffer), size); }
+  using Print::write;
+  void flush() override;
+  bool sync() {
+    flush();
+    return true;
+  }
+
+  bool seek(uint64_t pos) { return seekSet(pos); }
+  bool seekSet(uint64_t pos);
+  bool seekCur(int64_t offset);
+  bool seekEnd(int64_t offset = 0);
+  uint64_t position() const;
+  uint64_t curPosition() const { return position(); }
+  uint64_t size() const;
+  uint64_t fileSize() const { return size(); }
+  bool truncate(uint64_t length);
+
+  FsFile openNextFile(oflag_t oflag = O_RDONLY);
+  void rewindDirectory();
+  size_t getName(char* name, size_t len) const;
+  bool getModifyDateTime(uint16_t* pdate, uint16_t* ptime) const;
+  // newPath is a card path, defined next to SDCardManager which knows the card's root
+  bool rename(const char* newPath);
+};
+
+using File = FsFile;
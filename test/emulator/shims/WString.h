@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cctype>
+#include <cstring>
+#include <string>
+
+/**
+ * WString.h (host emulator shim)
+ *
+ * Arduino String backed by std::string, covering the members the firmware uses.
+ */
+class String {
+  std::string value;
+
+ public:
+  String() = default;
+  String(const char* str) : value(str ? str : "") {}
+  String(const std::string& str) : value(str) {}
+  String(char c) : value(1, c) {}
+  explicit String(int number) : value(std::to_string(number)) {}
+  explicit String(unsigned int number) : value(std::to_string(number)) {}
+  explicit String(long number) : value(std::to_string(number)) {}
+  explicit String(unsigned long number) : value(std::to_string(number)) {}
+
+  const char* c_str() const { return value.c_str(); }
+  unsigned int length() const { return static_cast<unsigned int>(value.length()); }
+  bool isEmpty() const { return value.empty(); }
+  char charAt(unsigned int index) const { return index < value.size() ? value[index] : 0; }
+  char operator[](unsigned int index) const { return charAt(index); }
+
+  void toLowerCase() {
+    for (auto& c : value) c = static_cast<char>(tolower(static_cast<unsigned char>(c)));
+  }
+  void toUpperCase() {
+    for (auto& c : value) c = static_cast<char>(toupper(static_cast<unsigned char>(c)));
+  }
+  bool startsWith(const String& prefix) const { return value.rfind(prefix.value, 0) == 0; }
+  bool endsWith(const String& suffix) const {
+    return value.size() >= suffix.value.size() &&
+           value.compare(value.size() - suffix.value.size(), suffix.value.size(), suffix.value) == 0;
+  }
+  int indexOf(char c, unsigned int from = 0) const {
+    const auto pos = value.find(c, from);
+    return pos == std::string::npos ? -1 : static_cast<int>(pos);
+  }
+  int lastIndexOf(char c) const {
+    const auto pos = value.rfind(c);
+    return pos == std::string::npos ? -1 : static_cast<int>(pos);
+  }
+  String substring(unsigned int from) const { return from < value.size() ? String(value.substr(from)) : String(); }
+  String substring(unsigned int from, unsigned int to) const {
+    return from < value.size() && to > from ? String(value.substr(from, to - from)) : String();
+  }
+  int toInt() const { return atoi(value.c_str()); }
+
+  String& operator+=(const String& rhs) {
+    value += rhs.value;
+    return *this;
+  }
+  String& operator+=(const char* rhs) {
+    value += rhs;
+    return *this;
+  }
+  String& operator+=(char rhs) {
+    value += rhs;
+    return *this;
+  }
+  friend String operator+(String lhs, const String& rhs) { return lhs += rhs; }
+  friend String operator+(String lhs, const char* rhs) { return lhs += rhs; }
+  friend String operator+(const char* lhs, const String& rhs) { return String(lhs) += rhs; }
+
+  bool operator==(const String& rhs) const { return value == rhs.value; }
+  bool operator==(const char* rhs) const { return value == rhs; }
+  bool operator!=(const String& rhs) const { return value != rhs.value; }
+  bool operator<(const String& rhs) const { return value < rhs.value; }
+};
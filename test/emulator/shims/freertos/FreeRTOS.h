@@ -0,0 +1,31 @@
+#pragma once
+
+/**
+ * FreeRTOS.h (host emulator shim)
+ *
+ * Tasks map onto std::thread and semaphores onto a shared condition variable. A task deleted with vTaskDelete() is
+ * unwound the next time it blocks in vTaskDelay() or a semaphore take, which is where the firmware's worker tasks
+ * spend their time when they are torn down.
+ */
+
+#include <cstdint>
+
+typedef uint32_t TickType_t;
+typedef int32_t BaseType_t;
+typedef uint32_t UBaseType_t;
+
+#define pdTRUE ((BaseType_t)1)
+#define pdFALSE ((BaseType_t)0)
+#define pdPASS pdTRUE
+#define pdFAIL pdFALSE
+
+#define portMAX_DELAY ((TickType_t)0xffffffffUL)
+#define portTICK_PERIOD_MS ((TickType_t)1)
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+
+struct EmulatedTask;
+struct EmulatedSemaphore;
+
+typedef EmulatedTask* TaskHandle_t;
+typedef EmulatedSemaphore* SemaphoreHandle_t;
+typedef void (*TaskFunction_t)(void*);
@@ -0,0 +1,12 @@
+#pragma once
+
+#include "FreeRTOS.h"
+
+BaseType_t xTaskCreate(TaskFunction_t taskCode, const char* name, uint32_t stackDepth, void* parameters,
+                       UBaseType_t priority, TaskHandle_t* createdTask);
+void vTaskDelete(TaskHandle_t task);
+void vTaskDelay(TickType_t ticks);
+TaskHandle_t xTaskGetCurrentTaskHandle();
+char* pcTaskGetName(TaskHandle_t task);
+// Host threads don't track stack use, this is always the full stack the task was created with
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task);
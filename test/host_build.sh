@@ -0,0 +1,92 @@
+# Shared pieces of the host builds that link firmware code against test/emulator/shims.
+# Sourced by test/run_*.sh after ROOT_DIR is set. Call host_build <binary> <sources...>, objects are cached per binary
+# in <binary dir>/obj and only rebuilt when the source or one of its headers changed.
+
+HOST_SHIM_SOURCES=("$ROOT_DIR"/test/emulator/shims/*.cpp)
+
+HOST_DEFINES=(
+  -DCROSSPOINT_EMULATED=1
+  -DCROSSPOINT_PERF=1
+  -DCROSSPOINT_VERSION=\"emulator\"
+  -DMINIZ_NO_ZLIB_COMPATIBLE_NAMES=1
+  -DEINK_DISPLAY_SINGLE_BUFFER_MODE=1
+  -DXML_GE=0
+  -DXML_CONTEXT_BYTES=1024
+  -DLOG_RING_SIZE=4096
+)
+
+HOST_INCLUDES=(
+  -I"$ROOT_DIR/test/emulator/shims"
+  -I"$ROOT_DIR/src"
+)
+for lib in "$ROOT_DIR"/lib/*/; do
+  HOST_INCLUDES+=(-I"${lib%/}")
+done
+
+HOST_OPT="${HOST_OPT:--O1}"
+HOST_CFLAGS=("$HOST_OPT" -g -MMD "${HOST_DEFINES[@]}" "${HOST_INCLUDES[@]}")
+HOST_CXXFLAGS=(-std=c++20 -Wall -Wno-unused-function -Wno-bidi-chars -Wno-format "${HOST_CFLAGS[@]}")
+HOST_LDFLAGS=(-pthread)
+
+# Appends every .cpp below the given lib/ directories to SOURCES
+host_lib_sources() {
+  local lib source
+  for lib in "$@"; do
+    while IFS= read -r -d '' source; do
+      SOURCES+=("$source")
+    done < <(find "$ROOT_DIR/lib/$lib" -name '*.cpp' -print0)
+  done
+}
+
+host_compile() {
+  local source="$1"
+  local object="$2"
+  local depfile="${object%.o}.d"
+  if [[ -f "$object" && -f "$depfile" ]]; then
+    local stale=0
+    for dep in $(sed -e 's/^[^:]*://' -e 's/\\$//' "$depfile"); do
+      if [[ "$dep" -nt "$object" ]]; then
+        stale=1
+        break
+      fi
+    done
+    if [[ "$stale" == 0 ]]; then
+      return
+    fi
+  fi
+
+  if [[ "$source" == *.c ]]; then
+    cc "${HOST_CFLAGS[@]}" -c "$source" -o "$object"
+  else
+    c++ "${HOST_CXXFLAGS[@]}" -c "$source" -o "$object"
+  fi
+}
+
+host_build() {
+  local binary="$1"
+  shift
+  local obj_dir
+  obj_dir="$(dirname "$binary")/obj"
+  mkdir -p "$obj_dir"
+
+  local objects=() pids=() source object pid
+  local jobs="${JOBS:-$(nproc 2>/dev/null || echo 4)}"
+  for source in "$@"; do
+    object="$obj_dir/$(echo "${source#"$ROOT_DIR"/}" | tr '/' '_').o"
+    objects+=("$object")
+    host_compile "$source" "$object" &
+    pids+=($!)
+    if (( ${#pids[@]} >= jobs )); then
+      wait "${pids[0]}"
+      pids=("${pids[@]:1}")
+    fi
+  done
+  for pid in "${pids[@]}"; do
+    wait "$pid"
+  done
+
+  c++ "${objects[@]}" "${HOST_LDFLAGS[@]}" -o "$binary"
+}
+
+# Link flags routing the C allocator through test/benchmarks/HeapTracker.cpp
+HEAP_TRACKER_LDFLAGS=(-Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc,--wrap=free)
@@ -0,0 +1,36 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+# Builds and runs the bitmap drawing benchmark (test/benchmarks/BitmapBlitBenchmark.cpp) against the emulator shims.
+# Without arguments the test images go to a temporary directory. Set BUILD_ONLY=1 to skip running.
+
+ROOT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")/.." && pwd)"
+BINARY="$ROOT_DIR/build/blit_benchmark/BitmapBlitBenchmark"
+
+# Timings are only meaningful with optimizations on
+HOST_OPT=-O2
+source "$ROOT_DIR/test/host_build.sh"
+
+SOURCES=(
+  "$ROOT_DIR/test/benchmarks/BitmapBlitBenchmark.cpp"
+  "$ROOT_DIR/test/benchmarks/BenchmarkUtils.cpp"
+  "$ROOT_DIR/lib/hal/HalDisplay.cpp"
+  "$ROOT_DIR/lib/miniz/miniz.c"
+  "${HOST_SHIM_SOURCES[@]}"
+)
+host_lib_sources BufferPool EpdFont GfxRenderer Logging PackBits Perf Serialization Utf8
+
+host_build "$BINARY" "${SOURCES[@]}"
+
+if [[ "${BUILD_ONLY:-0}" == 1 ]]; then
+  echo "$BINARY"
+  exit 0
+fi
+
+if [[ $# -eq 0 || "$1" == -* ]]; then
+  SCRATCH_DIR="$(mktemp -d)"
+  trap 'rm -rf "$SCRATCH_DIR"' EXIT
+  set -- "$SCRATCH_DIR" "$@"
+fi
+
+"$BINARY" "$@"
@@ -0,0 +1,27 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+# Builds and runs the dithering benchmark (test/benchmarks/DitherBenchmark.cpp). The images are generated in memory,
+# so it needs no scratch directory. Set BUILD_ONLY=1 to skip running.
+
+ROOT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")/.." && pwd)"
+BINARY="$ROOT_DIR/build/dither_benchmark/DitherBenchmark"
+
+# Timings are only meaningful with optimizations on
+HOST_OPT=-O2
+source "$ROOT_DIR/test/host_build.sh"
+
+SOURCES=(
+  "$ROOT_DIR/test/benchmarks/DitherBenchmark.cpp"
+  "$ROOT_DIR/test/benchmarks/BenchmarkUtils.cpp"
+  "$ROOT_DIR/lib/GfxRenderer/BitmapHelpers.cpp"
+)
+
+host_build "$BINARY" "${SOURCES[@]}"
+
+if [[ "${BUILD_ONLY:-0}" == 1 ]]; then
+  echo "$BINARY"
+  exit 0
+fi
+
+"$BINARY" "$@"
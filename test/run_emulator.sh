@@ -0,0 +1,57 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+# Builds the firmware for Linux against the shims in test/emulator/shims and runs it.
+# All arguments are passed to the emulator, see docs/emulator.md. Set BUILD_ONLY=1 to skip running.
+
+ROOT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")/.." && pwd)"
+BINARY="$ROOT_DIR/build/emulator/crosspoint-emulator"
+
+source "$ROOT_DIR/test/host_build.sh"
+
+# Firmware sources that run offline. Network activities (file transfer, OPDS, settings with OTA/KOReader login)
+# are compiled out with CROSSPOINT_EMULATED, KOReader sync is stubbed in EmulatorStubs.cpp.
+SOURCES=(
+  "$ROOT_DIR/src/main.cpp"
+  "$ROOT_DIR/src/CrossPointSettings.cpp"
+  "$ROOT_DIR/src/CrossPointState.cpp"
+  "$ROOT_DIR/src/EpubBake.cpp"
+  "$ROOT_DIR/src/LibraryIndex.cpp"
+  "$ROOT_DIR/src/MappedInputManager.cpp"
+  "$ROOT_DIR/src/RecentBooksStore.cpp"
+  "$ROOT_DIR/src/RenderService.cpp"
+  "$ROOT_DIR/src/ResumeSnapshot.cpp"
+  "$ROOT_DIR/src/ScreenComponents.cpp"
+  "$ROOT_DIR/src/util/StringUtils.cpp"
+  "$ROOT_DIR/src/util/UrlUtils.cpp"
+  "$ROOT_DIR/src/activities/ActivityWithSubactivity.cpp"
+  "$ROOT_DIR/src/activities/reader/EpubReaderActivity.cpp"
+  "$ROOT_DIR/src/activities/reader/EpubReaderChapterSelectionActivity.cpp"
+  "$ROOT_DIR/src/activities/reader/ReaderActivity.cpp"
+  "$ROOT_DIR/src/activities/reader/TxtReaderActivity.cpp"
+  "$ROOT_DIR/src/activities/reader/XtcReaderActivity.cpp"
+  "$ROOT_DIR/src/activities/reader/XtcReaderChapterSelectionActivity.cpp"
+  "$ROOT_DIR/lib/KOReaderSync/KOReaderCredentialStore.cpp"
+  "$ROOT_DIR/lib/hal/HalDisplay.cpp"
+  "$ROOT_DIR/lib/hal/HalGPIO.cpp"
+  "$ROOT_DIR/lib/expat/xmlparse.c"
+  "$ROOT_DIR/lib/expat/xmlrole.c"
+  "$ROOT_DIR/lib/expat/xmltok.c"
+  "$ROOT_DIR/lib/miniz/miniz.c"
+  "$ROOT_DIR/lib/picojpeg/picojpeg.c"
+)
+for dir in boot_sleep games home util; do
+  SOURCES+=("$ROOT_DIR"/src/activities/"$dir"/*.cpp)
+done
+host_lib_sources BufferPool EpdFont Epub FsHelpers GfxRenderer \
+  JpegToBmpConverter Logging MemStats PackBits Perf Serialization Txt Utf8 Xtc ZipFile
+SOURCES+=("$ROOT_DIR"/test/emulator/*.cpp "${HOST_SHIM_SOURCES[@]}")
+
+host_build "$BINARY" "${SOURCES[@]}"
+
+if [[ "${BUILD_ONLY:-0}" == 1 ]]; then
+  echo "$BINARY"
+  exit 0
+fi
+
+"$BINARY" "$@"
@@ -0,0 +1,37 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+# Builds and runs the EPUB pre-rendering benchmark (test/benchmarks/EpubBakeBenchmark.cpp) against the emulator
+# shims. All arguments are passed to the benchmark, see docs/benchmarks.md. Set BUILD_ONLY=1 to skip running.
+
+ROOT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")/.." && pwd)"
+BINARY="$ROOT_DIR/build/epub_bake_benchmark/EpubBakeBenchmark"
+
+# Timings are only meaningful with optimizations on
+HOST_OPT=-O2
+source "$ROOT_DIR/test/host_build.sh"
+
+SOURCES=(
+  "$ROOT_DIR/test/benchmarks/EpubBakeBenchmark.cpp"
+  "$ROOT_DIR/test/benchmarks/BenchmarkUtils.cpp"
+  "$ROOT_DIR/src/CrossPointSettings.cpp"
+  "$ROOT_DIR/src/EpubBake.cpp"
+  "$ROOT_DIR/lib/hal/HalDisplay.cpp"
+  "$ROOT_DIR/lib/expat/xmlparse.c"
+  "$ROOT_DIR/lib/expat/xmlrole.c"
+  "$ROOT_DIR/lib/expat/xmltok.c"
+  "$ROOT_DIR/lib/miniz/miniz.c"
+  "$ROOT_DIR/lib/picojpeg/picojpeg.c"
+  "${HOST_SHIM_SOURCES[@]}"
+)
+host_lib_sources BufferPool EpdFont Epub FsHelpers GfxRenderer \
+  JpegToBmpConverter Logging PackBits Perf Serialization Utf8 Xtc ZipFile
+
+host_build "$BINARY" "${SOURCES[@]}"
+
+if [[ "${BUILD_ONLY:-0}" == 1 ]]; then
+  echo "$BINARY"
+  exit 0
+fi
+
+"$BINARY" "$@"
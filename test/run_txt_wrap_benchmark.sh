@@ -0,0 +1,29 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+# Builds and runs the TXT word wrap benchmark (test/benchmarks/TxtWrapBenchmark.cpp) on the host, it only needs the
+# fonts and the UTF-8 decoder. All arguments are passed to the benchmark, see docs/benchmarks.md. Set BUILD_ONLY=1 to
+# skip running.
+
+ROOT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")/.." && pwd)"
+BINARY="$ROOT_DIR/build/txt_wrap_benchmark/TxtWrapBenchmark"
+
+# Timings are only meaningful with optimizations on
+HOST_OPT=-O2
+source "$ROOT_DIR/test/host_build.sh"
+
+SOURCES=(
+  "$ROOT_DIR/test/benchmarks/TxtWrapBenchmark.cpp"
+  "$ROOT_DIR/test/benchmarks/BenchmarkUtils.cpp"
+  "$ROOT_DIR/lib/Txt/TxtWrapper.cpp"
+)
+host_lib_sources EpdFont Utf8
+
+host_build "$BINARY" "${SOURCES[@]}"
+
+if [[ "${BUILD_ONLY:-0}" == 1 ]]; then
+  echo "$BINARY"
+  exit 0
+fi
+
+"$BINARY" "$@"